@@ -0,0 +1,977 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "mbar.h"
+
+#include "SireMaths/maths.h"
+#include "SireMaths/nmatrix.h"
+#include "SireMaths/nvector.h"
+#include "SireMaths/rangenerator.h"
+
+#include "SireError/errors.h"
+
+#include "SireUnits/units.h"
+#include "SireUnits/temperature.h"
+
+#include "SireStream/shareddatastream.h"
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+#include <QVarLengthArray>
+
+#include <cmath>
+#include <limits>
+
+using namespace SireAnalysis;
+using namespace SireMaths;
+using namespace SireBase;
+using namespace SireUnits;
+using namespace SireUnits::Dimension;
+using namespace SireStream;
+
+static const RegisterMetaType<MBAR> r_mbar;
+
+QDataStream SIREANALYSIS_EXPORT &operator<<(QDataStream &ds, const MBAR &mbar)
+{
+    writeHeader(ds, r_mbar, 1);
+    
+    SharedDataStream sds(ds);
+    
+    sds << mbar.lamvals << mbar.temp << mbar.u_nk << mbar.sample_states
+        << mbar.nsamps << mbar.f_k << mbar.errs << mbar.tol << mbar.maxiter
+        << mbar.niters << mbar.nboots << mbar.solved << mbar.converged;
+    
+    return ds;
+}
+
+QDataStream SIREANALYSIS_EXPORT &operator>>(QDataStream &ds, MBAR &mbar)
+{
+    VersionID v = readHeader(ds, r_mbar);
+    
+    if (v == 1)
+    {
+        SharedDataStream sds(ds);
+        
+        sds >> mbar.lamvals >> mbar.temp >> mbar.u_nk >> mbar.sample_states
+            >> mbar.nsamps >> mbar.f_k >> mbar.errs >> mbar.tol >> mbar.maxiter
+            >> mbar.niters >> mbar.nboots >> mbar.solved >> mbar.converged;
+    }
+    else
+        throw version_error(v, "1", r_mbar, CODELOC);
+    
+    return ds;
+}
+
+namespace SireAnalysis
+{
+    namespace detail
+    {
+        /** The number of samples processed by each parallel task */
+        static const int MBAR_CHUNK_SIZE = 1024;
+
+        /** This holds the sums over samples needed by the MBAR solver */
+        class MBARSums
+        {
+        public:
+            MBARSums() : gnorm(0)
+            {}
+
+            /** The sum over samples of the weight of each sample
+                in each state (sum_n W_nk) */
+            QVector<double> sumw;
+
+            /** The sum over samples of the products of weights
+                (sum_n W_ni W_nj), i.e. minus the off-diagonal Hessian */
+            QVector<double> sumww;
+
+            /** log( sum_n exp(-u_kn) / sum_i N_i exp(f_i - u_in) ),
+                which is minus the estimated free energy of each state */
+            QVector<double> logsum;
+
+            /** The maximum relative gradient of the sampled states */
+            double gnorm;
+        };
+
+        /** Functor used to calculate the MBAR sums over a set of chunks
+            of samples in parallel. Each chunk writes into its own part
+            of the output arrays, so that the chunks can be summed in
+            a fixed order afterwards, which makes the result reproducible */
+        class MBARChunks
+        {
+        public:
+            MBARChunks(const double *u_nk, int nstates, int nsamples,
+                       const double *log_n, const double *f,
+                       bool calc_hessian,
+                       double *sumw, double *sumww, double *lse_max, double *lse_sum)
+                : u(u_nk), K(nstates), N(nsamples), logn(log_n), fk(f),
+                  hessian(calc_hessian),
+                  w(sumw), ww(sumww), lmax(lse_max), lsum(lse_sum)
+            {}
+
+            ~MBARChunks()
+            {}
+
+            void operator()(const tbb::blocked_range<int> &range) const
+            {
+                QVarLengthArray<double,64> wn(K);
+
+                for (int c = range.begin(); c != range.end(); ++c)
+                {
+                    double *cw = w + c*K;
+                    double *cww = ww + c*K*K;
+                    double *cmax = lmax + c*K;
+                    double *csum = lsum + c*K;
+
+                    for (int k=0; k<K; ++k)
+                    {
+                        cw[k] = 0;
+                        cmax[k] = -std::numeric_limits<double>::infinity();
+                        csum[k] = 0;
+                    }
+
+                    if (hessian)
+                    {
+                        for (int k=0; k<K*K; ++k)
+                        {
+                            cww[k] = 0;
+                        }
+                    }
+
+                    const int start = c * MBAR_CHUNK_SIZE;
+                    const int end = qMin(start + MBAR_CHUNK_SIZE, N);
+
+                    for (int n=start; n<end; ++n)
+                    {
+                        const double *un = u + n*K;
+
+                        //log( sum_k N_k exp(f_k - u_kn) ) using log-sum-exp
+                        double maxval = -std::numeric_limits<double>::infinity();
+
+                        for (int k=0; k<K; ++k)
+                        {
+                            if (logn[k] > -std::numeric_limits<double>::infinity())
+                                maxval = qMax(maxval, logn[k] + fk[k] - un[k]);
+                        }
+
+                        double sum = 0;
+
+                        for (int k=0; k<K; ++k)
+                        {
+                            if (logn[k] > -std::numeric_limits<double>::infinity())
+                                sum += std::exp(logn[k] + fk[k] - un[k] - maxval);
+                        }
+
+                        const double logden = maxval + std::log(sum);
+
+                        for (int k=0; k<K; ++k)
+                        {
+                            const double val = -un[k] - logden;
+
+                            //running log-sum-exp of the unnormalised weights
+                            if (val > cmax[k])
+                            {
+                                csum[k] = csum[k] * std::exp(cmax[k] - val) + 1.0;
+                                cmax[k] = val;
+                            }
+                            else
+                            {
+                                csum[k] += std::exp(val - cmax[k]);
+                            }
+
+                            //the weight of this sample in state k, which
+                            //is always between 0 and 1
+                            if (logn[k] > -std::numeric_limits<double>::infinity())
+                                wn[k] = std::exp(logn[k] + fk[k] + val);
+                            else
+                                wn[k] = 0;
+
+                            cw[k] += wn[k];
+                        }
+
+                        if (hessian)
+                        {
+                            for (int i=0; i<K; ++i)
+                            {
+                                if (wn[i] == 0)
+                                    continue;
+
+                                double *row = cww + i*K;
+
+                                for (int j=0; j<K; ++j)
+                                {
+                                    row[j] += wn[i] * wn[j];
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+        private:
+            const double *u;
+            int K, N;
+            const double *logn;
+            const double *fk;
+            bool hessian;
+            double *w, *ww, *lmax, *lsum;
+        };
+
+        /** Calculate the MBAR sums for the reduced energies 'u_nk' of 'nsamples'
+            samples evaluated at 'nstates' states, for the free energies 'f' */
+        static MBARSums calculateMBARSums(const double *u_nk, int nstates, int nsamples,
+                                          const QVector<double> &log_n,
+                                          const QVector<double> &f, bool calc_hessian)
+        {
+            const int K = nstates;
+            const int nchunks = (nsamples + MBAR_CHUNK_SIZE - 1) / MBAR_CHUNK_SIZE;
+
+            QVector<double> w(nchunks*K), lmax(nchunks*K), lsum(nchunks*K);
+            QVector<double> ww;
+
+            if (calc_hessian)
+                ww = QVector<double>(nchunks*K*K);
+
+            tbb::parallel_for( tbb::blocked_range<int>(0,nchunks),
+                               MBARChunks(u_nk, K, nsamples, log_n.constData(),
+                                          f.constData(), calc_hessian,
+                                          w.data(), ww.data(), lmax.data(), lsum.data()) );
+
+            //now sum together the chunks in order
+            MBARSums sums;
+            sums.sumw = QVector<double>(K, 0.0);
+            sums.logsum = QVector<double>(K, 0.0);
+
+            if (calc_hessian)
+                sums.sumww = QVector<double>(K*K, 0.0);
+
+            for (int k=0; k<K; ++k)
+            {
+                double maxval = -std::numeric_limits<double>::infinity();
+
+                for (int c=0; c<nchunks; ++c)
+                {
+                    sums.sumw[k] += w[c*K + k];
+                    maxval = qMax(maxval, lmax[c*K + k]);
+                }
+
+                double sum = 0;
+
+                for (int c=0; c<nchunks; ++c)
+                {
+                    if (lsum[c*K + k] > 0)
+                        sum += lsum[c*K + k] * std::exp(lmax[c*K + k] - maxval);
+                }
+
+                sums.logsum[k] = maxval + std::log(sum);
+
+                if (log_n[k] > -std::numeric_limits<double>::infinity())
+                {
+                    const double nk = std::exp(log_n[k]);
+                    sums.gnorm = qMax( sums.gnorm, std::abs(sums.sumw[k] - nk) / nk );
+                }
+            }
+
+            if (calc_hessian)
+            {
+                for (int c=0; c<nchunks; ++c)
+                {
+                    for (int k=0; k<K*K; ++k)
+                    {
+                        sums.sumww[k] += ww[c*K*K + k];
+                    }
+                }
+            }
+
+            return sums;
+        }
+
+        /** Solve the MBAR equations for the reduced energies 'u_nk' of
+            'nsamples' samples at 'nstates' states, where 'nsamps' is the number
+            of samples drawn from each state. 'f' contains the initial guess,
+            and is returned containing the reduced free energies of all states
+            relative to the first state. This returns whether or not the
+            solver converged, with the number of iterations in 'niters' */
+        static bool solveMBAR(const double *u_nk, int nstates, int nsamples,
+                              const QVector<qint64> &nsamps,
+                              double tolerance, int maxiter,
+                              QVector<double> &f, qint32 &niters)
+        {
+            const int K = nstates;
+
+            QVector<double> log_n(K);
+            QList<int> sampled;
+
+            for (int k=0; k<K; ++k)
+            {
+                if (nsamps[k] > 0)
+                {
+                    log_n[k] = std::log( double(nsamps[k]) );
+                    sampled.append(k);
+                }
+                else
+                    log_n[k] = -std::numeric_limits<double>::infinity();
+            }
+
+            if (f.count() != K)
+                f = QVector<double>(K, 0.0);
+
+            niters = 0;
+
+            if (sampled.isEmpty())
+                return false;
+
+            //the free energy of the first sampled state is fixed, so the
+            //Newton steps are over the remaining sampled states
+            const int nfree = sampled.count() - 1;
+
+            MBARSums sums = calculateMBARSums(u_nk, K, nsamples, log_n, f, nfree > 0);
+
+            bool converged = (sums.gnorm < tolerance);
+
+            while ((not converged) and niters < maxiter)
+            {
+                ++niters;
+
+                QVector<double> trial = f;
+                bool accepted = false;
+
+                //try a Newton-Raphson step
+                try
+                {
+                    NMatrix hessian(nfree, nfree);
+                    NVector gradient(nfree);
+
+                    for (int i=0; i<nfree; ++i)
+                    {
+                        const int ki = sampled[i+1];
+
+                        gradient[i] = sums.sumw[ki] - nsamps[ki];
+
+                        for (int j=0; j<nfree; ++j)
+                        {
+                            const int kj = sampled[j+1];
+
+                            hessian(i,j) = -sums.sumww[ki*K + kj];
+                        }
+
+                        hessian(i,i) += sums.sumw[ki];
+                    }
+
+                    NVector step = hessian.inverse() * gradient;
+
+                    for (int i=0; i<nfree; ++i)
+                    {
+                        trial[sampled[i+1]] -= step[i];
+                    }
+
+                    MBARSums trial_sums = calculateMBARSums(u_nk, K, nsamples,
+                                                            log_n, trial, true);
+
+                    //(this comparison is also false if the gradient is NaN)
+                    if (trial_sums.gnorm < sums.gnorm)
+                    {
+                        f = trial;
+                        sums = trial_sums;
+                        accepted = true;
+                    }
+                }
+                catch(const SireError::exception&)
+                {
+                    //singular Hessian - fall back to self-consistent iteration
+                }
+
+                if (not accepted)
+                {
+                    //use a self-consistent iteration, which always moves
+                    //towards the solution (although can be slow)
+                    trial = f;
+
+                    const double f0 = -sums.logsum[sampled[0]];
+
+                    foreach (int k, sampled)
+                    {
+                        trial[k] = -sums.logsum[k] - f0;
+                    }
+
+                    f = trial;
+                    sums = calculateMBARSums(u_nk, K, nsamples, log_n, f, nfree > 0);
+                }
+
+                converged = (sums.gnorm < tolerance);
+            }
+
+            //the free energies of all states (including unsampled states)
+            //are calculated from the converged weights, relative to the first state
+            const double f0 = -sums.logsum[0];
+
+            for (int k=0; k<K; ++k)
+            {
+                f[k] = -sums.logsum[k] - f0;
+            }
+
+            return converged;
+        }
+
+        /** Functor used to solve the bootstrap replicas in parallel */
+        class MBARBootstrap
+        {
+        public:
+            MBARBootstrap(const MBAR *mbar_ptr, const double *u_nk,
+                          const QVector< QVector<int> > *state_samples,
+                          const QVector<quint32> *replica_seeds,
+                          QVector<double> *replica_f)
+                : mbar(mbar_ptr), u(u_nk), samples(state_samples),
+                  seeds(replica_seeds), results(replica_f)
+            {}
+
+            ~MBARBootstrap()
+            {}
+
+            void operator()(const tbb::blocked_range<int> &range) const
+            {
+                const int K = mbar->nStates();
+                const int N = mbar->nSamples();
+
+                QVector<qint64> nsamps(K);
+
+                for (int k=0; k<K; ++k)
+                {
+                    nsamps[k] = samples->at(k).count();
+                }
+
+                for (int b = range.begin(); b != range.end(); ++b)
+                {
+                    RanGenerator rand( seeds->at(b) );
+
+                    //resample (with replacement) the samples from each state
+                    QVector<double> u_b(N*K);
+                    double *ub = u_b.data();
+
+                    for (int k=0; k<K; ++k)
+                    {
+                        const QVector<int> &idxs = samples->at(k);
+
+                        for (int i=0; i<idxs.count(); ++i)
+                        {
+                            const int n = idxs[ rand.randInt(idxs.count()-1) ];
+
+                            for (int j=0; j<K; ++j)
+                            {
+                                ub[j] = u[n*K + j];
+                            }
+
+                            ub += K;
+                        }
+                    }
+
+                    QVector<double> &f = (*results)[b];
+                    f = mbar->reducedFreeEnergies();
+
+                    qint32 niters;
+                    solveMBAR(u_b.constData(), K, N, nsamps, mbar->tolerance(),
+                              mbar->maxIterations(), f, niters);
+                }
+            }
+
+        private:
+            const MBAR *mbar;
+            const double *u;
+            const QVector< QVector<int> > *samples;
+            const QVector<quint32> *seeds;
+            QVector<double> *results;
+        };
+    }
+}
+
+using namespace SireAnalysis::detail;
+
+/** Construct an empty MBAR estimator */
+MBAR::MBAR()
+     : ConcreteProperty<MBAR,Property>(),
+       temp(0), tol(1e-8), maxiter(1000), niters(0), nboots(0),
+       solved(false), converged(false)
+{}
+
+/** Construct an MBAR estimator for the states with the passed lambda values,
+    for samples collected at the passed temperature. Add samples
+    using the "add" function */
+MBAR::MBAR(const QList<double> &lambda_values, const Temperature &temperature)
+     : ConcreteProperty<MBAR,Property>(),
+       lamvals(lambda_values), temp(temperature.to(kelvin)),
+       nsamps( lambda_values.count(), 0 ),
+       tol(1e-8), maxiter(1000), niters(0), nboots(0),
+       solved(false), converged(false)
+{}
+
+/** Construct an MBAR estimator for the states with the passed lambda values,
+    collected at the passed temperature, using the passed matrix of energies.
+    energies[k][n] is the energy (in kcal mol-1) of sample 'n' evaluated
+    at state 'k'. The samples are ordered by the state from which they
+    were drawn, with nsamples[k] samples drawn from state 'k'
+
+    \throw SireError::invalid_arg
+*/
+MBAR::MBAR(const QList<double> &lambda_values,
+           const QVector< QVector<double> > &energies,
+           const QVector<qint64> &nsamples,
+           const Temperature &temperature)
+     : ConcreteProperty<MBAR,Property>(),
+       lamvals(lambda_values), temp(temperature.to(kelvin)),
+       nsamps( lambda_values.count(), 0 ),
+       tol(1e-8), maxiter(1000), niters(0), nboots(0),
+       solved(false), converged(false)
+{
+    this->add(energies, nsamples);
+}
+
+/** Copy constructor */
+MBAR::MBAR(const MBAR &other)
+     : ConcreteProperty<MBAR,Property>(other),
+       lamvals(other.lamvals), temp(other.temp), u_nk(other.u_nk),
+       sample_states(other.sample_states), nsamps(other.nsamps),
+       f_k(other.f_k), errs(other.errs), tol(other.tol), maxiter(other.maxiter),
+       niters(other.niters), nboots(other.nboots), solved(other.solved),
+       converged(other.converged)
+{}
+
+/** Destructor */
+MBAR::~MBAR()
+{}
+
+/** Copy assignment operator */
+MBAR& MBAR::operator=(const MBAR &other)
+{
+    if (this != &other)
+    {
+        lamvals = other.lamvals;
+        temp = other.temp;
+        u_nk = other.u_nk;
+        sample_states = other.sample_states;
+        nsamps = other.nsamps;
+        f_k = other.f_k;
+        errs = other.errs;
+        tol = other.tol;
+        maxiter = other.maxiter;
+        niters = other.niters;
+        nboots = other.nboots;
+        solved = other.solved;
+        converged = other.converged;
+    }
+    
+    return *this;
+}
+
+/** Comparison operator */
+bool MBAR::operator==(const MBAR &other) const
+{
+    return this == &other or
+           (lamvals == other.lamvals and temp == other.temp and
+            u_nk == other.u_nk and sample_states == other.sample_states and
+            f_k == other.f_k and errs == other.errs and tol == other.tol and
+            maxiter == other.maxiter and solved == other.solved);
+}
+
+/** Comparison operator */
+bool MBAR::operator!=(const MBAR &other) const
+{
+    return not operator==(other);
+}
+
+const char* MBAR::what() const
+{
+    return MBAR::typeName();
+}
+
+const char* MBAR::typeName()
+{
+    return QMetaType::typeName( qMetaTypeId<MBAR>() );
+}
+
+QString MBAR::toString() const
+{
+    return QObject::tr("MBAR( nStates() == %1, nSamples() == %2, isSolved() == %3 )")
+                .arg(nStates()).arg(nSamples()).arg(isSolved());
+}
+
+/** Return whether or not this estimator is empty (contains no samples) */
+bool MBAR::isEmpty() const
+{
+    return sample_states.isEmpty();
+}
+
+void MBAR::checkState(int state) const
+{
+    if (state < 0 or state >= lamvals.count())
+        throw SireError::invalid_index( QObject::tr(
+                "Invalid state index %1. The number of states is %2.")
+                    .arg(state).arg(lamvals.count()), CODELOC );
+}
+
+/** Add a single sample that was drawn from state 'state', where 'energies'
+    contains the energy (in kcal mol-1) of the sample evaluated at each state
+
+    \throw SireError::invalid_index
+    \throw SireError::incompatible_error
+*/
+void MBAR::add(int state, const QVector<double> &energies)
+{
+    checkState(state);
+
+    if (energies.count() != lamvals.count())
+        throw SireError::incompatible_error( QObject::tr(
+                "The number of energies for the sample (%1) must equal the number "
+                "of states (%2).").arg(energies.count()).arg(lamvals.count()), CODELOC );
+
+    const double beta = 1.0 / (k_boltz * temp);
+
+    for (int k=0; k<energies.count(); ++k)
+    {
+        u_nk.append( beta * energies.at(k) );
+    }
+
+    sample_states.append(state);
+    nsamps[state] += 1;
+
+    solved = false;
+    errs.clear();
+    nboots = 0;
+}
+
+/** Add the passed matrix of energies, where energies[k][n] is the energy
+    (in kcal mol-1) of sample 'n' evaluated at state 'k'. The samples are
+    ordered by the state from which they were drawn, with nsamples[k]
+    samples drawn from state 'k'
+
+    \throw SireError::incompatible_error
+*/
+void MBAR::add(const QVector< QVector<double> > &energies, const QVector<qint64> &nsamples)
+{
+    const int K = lamvals.count();
+
+    if (energies.count() != K or nsamples.count() != K)
+        throw SireError::incompatible_error( QObject::tr(
+                "The number of rows of energies (%1) and number of sample counts (%2) "
+                "must both equal the number of states (%3).")
+                    .arg(energies.count()).arg(nsamples.count()).arg(K), CODELOC );
+
+    qint64 N = 0;
+
+    for (int k=0; k<K; ++k)
+    {
+        N += nsamples[k];
+    }
+
+    for (int k=0; k<K; ++k)
+    {
+        if (energies[k].count() != N)
+            throw SireError::incompatible_error( QObject::tr(
+                    "The number of energies at state %1 (%2) is not equal to the "
+                    "total number of samples (%3).")
+                        .arg(k).arg(energies[k].count()).arg(N), CODELOC );
+    }
+
+    const double beta = 1.0 / (k_boltz * temp);
+
+    u_nk.reserve( u_nk.count() + N*K );
+    sample_states.reserve( sample_states.count() + N );
+
+    int n = 0;
+
+    for (int state=0; state<K; ++state)
+    {
+        for (qint64 i=0; i<nsamples[state]; ++i)
+        {
+            for (int k=0; k<K; ++k)
+            {
+                u_nk.append( beta * energies.at(k).at(n) );
+            }
+
+            sample_states.append(state);
+            ++n;
+        }
+
+        nsamps[state] += nsamples[state];
+    }
+
+    solved = false;
+    errs.clear();
+    nboots = 0;
+}
+
+/** Return the temperature at which the samples were collected */
+Temperature MBAR::temperature() const
+{
+    return Temperature(temp * kelvin);
+}
+
+/** Return the lambda values of each of the states */
+QList<double> MBAR::lambdaValues() const
+{
+    return lamvals;
+}
+
+/** Return the number of states */
+int MBAR::nStates() const
+{
+    return lamvals.count();
+}
+
+/** Return the total number of samples */
+qint64 MBAR::nSamples() const
+{
+    return sample_states.count();
+}
+
+/** Return the number of samples drawn from state 'state' */
+qint64 MBAR::nSamples(int state) const
+{
+    checkState(state);
+    return nsamps[state];
+}
+
+/** Set the tolerance used to decide that the solver has converged. This is
+    the maximum allowed value of |sum_n W_nk - N_k| / N_k for any state */
+void MBAR::setTolerance(double tolerance)
+{
+    if (tolerance != tol)
+    {
+        tol = qMax(tolerance, 1e-15);
+        solved = false;
+    }
+}
+
+/** Return the tolerance used to decide that the solver has converged */
+double MBAR::tolerance() const
+{
+    return tol;
+}
+
+/** Set the maximum number of iterations of the solver */
+void MBAR::setMaxIterations(int m)
+{
+    if (m != maxiter)
+    {
+        maxiter = qMax(m, 1);
+        solved = false;
+    }
+}
+
+/** Return the maximum number of iterations of the solver */
+int MBAR::maxIterations() const
+{
+    return maxiter;
+}
+
+/** Solve the MBAR equations for the current set of samples. This starts
+    from the free energies of the last solve, so is fast if only
+    a few samples have been added since */
+void MBAR::solve()
+{
+    if (solved)
+        return;
+
+    qint32 n;
+    converged = solveMBAR(u_nk.constData(), lamvals.count(), sample_states.count(),
+                          nsamps, tol, maxiter, f_k, n);
+
+    niters = n;
+    solved = true;
+}
+
+/** Estimate the errors on the free energies using 'nbootstrap' bootstrap
+    replicas, each of which is solved in parallel */
+void MBAR::bootstrap(int nbootstrap)
+{
+    this->bootstrap(nbootstrap, RanGenerator().randInt());
+}
+
+/** Estimate the errors on the free energies using 'nbootstrap' bootstrap
+    replicas, generated using the passed random number seed (so that
+    the errors are reproducible). The replicas are solved in parallel */
+void MBAR::bootstrap(int nbootstrap, quint32 seed)
+{
+    this->solve();
+
+    const int K = lamvals.count();
+
+    if (nbootstrap <= 1 or K == 0)
+    {
+        errs = QVector<double>(K, 0.0);
+        nboots = 0;
+        return;
+    }
+
+    //find the indicies of the samples drawn from each state
+    QVector< QVector<int> > state_samples(K);
+
+    for (int n=0; n<sample_states.count(); ++n)
+    {
+        state_samples[ sample_states[n] ].append(n);
+    }
+
+    //generate the seeds for each replica up-front so that the result
+    //does not depend on the order in which the replicas are solved
+    RanGenerator rand(seed);
+    QVector<quint32> seeds(nbootstrap);
+
+    for (int b=0; b<nbootstrap; ++b)
+    {
+        seeds[b] = rand.randInt();
+    }
+
+    QVector< QVector<double> > replica_f(nbootstrap);
+
+    tbb::parallel_for( tbb::blocked_range<int>(0,nbootstrap),
+                       MBARBootstrap(this, u_nk.constData(), &state_samples,
+                                     &seeds, &replica_f) );
+
+    //the error is the standard deviation of the bootstrap free energies
+    const double kT = k_boltz * temp;
+
+    errs = QVector<double>(K, 0.0);
+
+    for (int k=0; k<K; ++k)
+    {
+        double sum = 0;
+        double sum2 = 0;
+
+        for (int b=0; b<nbootstrap; ++b)
+        {
+            const double f = replica_f[b][k];
+            sum += f;
+            sum2 += f*f;
+        }
+
+        const double mean = sum / nbootstrap;
+        const double var = (sum2 / nbootstrap) - mean*mean;
+
+        errs[k] = kT * std::sqrt( qMax(var, 0.0) * nbootstrap / (nbootstrap - 1) );
+    }
+
+    nboots = nbootstrap;
+}
+
+/** Return whether or not the free energies are up to date with the samples */
+bool MBAR::isSolved() const
+{
+    return solved;
+}
+
+/** Return whether or not the last solve converged */
+bool MBAR::isConverged() const
+{
+    return solved and converged;
+}
+
+/** Return the number of iterations used in the last solve */
+int MBAR::nIterations() const
+{
+    return niters;
+}
+
+/** Return the number of bootstrap replicas used to calculate the errors */
+int MBAR::nBootstraps() const
+{
+    return nboots;
+}
+
+/** Return the reduced (dimensionless) free energies of each state, relative to
+    the first state. Note that these are from the last call to "solve", so
+    will be out of date if samples have been added since */
+QVector<double> MBAR::reducedFreeEnergies() const
+{
+    if (f_k.count() != lamvals.count())
+        return QVector<double>(lamvals.count(), 0.0);
+    else
+        return f_k;
+}
+
+/** Return the free energies (in kcal mol-1) of each state, relative to
+    the first state. This solves the MBAR equations if needed */
+QVector<double> MBAR::freeEnergies() const
+{
+    if (not solved)
+    {
+        MBAR copy(*this);
+        copy.solve();
+        return copy.freeEnergies();
+    }
+
+    QVector<double> nrgs = this->reducedFreeEnergies();
+
+    const double kT = k_boltz * temp;
+
+    for (int k=0; k<nrgs.count(); ++k)
+    {
+        nrgs[k] *= kT;
+    }
+
+    return nrgs;
+}
+
+/** Return the bootstrap errors (in kcal mol-1) on the free energies. These
+    are zero unless "bootstrap" has been called */
+QVector<double> MBAR::errors() const
+{
+    if (errs.count() != lamvals.count())
+        return QVector<double>(lamvals.count(), 0.0);
+    else
+        return errs;
+}
+
+/** Return the PMF of the free energy as a function of lambda */
+PMF MBAR::pmf() const
+{
+    const QVector<double> nrgs = this->freeEnergies();
+    const QVector<double> e = this->errors();
+
+    QVector<DataPoint> points;
+    points.reserve(lamvals.count());
+
+    for (int k=0; k<lamvals.count(); ++k)
+    {
+        points.append( DataPoint(lamvals[k], nrgs[k], 0, e[k]) );
+    }
+
+    return PMF(points);
+}
+
+/** Clear all of the samples (keeping the lambda values and temperature) */
+void MBAR::clear()
+{
+    u_nk.clear();
+    sample_states.clear();
+    nsamps = QVector<qint64>(lamvals.count(), 0);
+    f_k.clear();
+    errs.clear();
+    niters = 0;
+    nboots = 0;
+    solved = false;
+    converged = false;
+}
@@ -0,0 +1,192 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#ifndef SIREANALYSIS_MBAR_H
+#define SIREANALYSIS_MBAR_H
+
+#include "fep.h"
+
+SIRE_BEGIN_HEADER
+
+namespace SireAnalysis
+{
+class MBAR;
+}
+
+QDataStream& operator<<(QDataStream&, const SireAnalysis::MBAR&);
+QDataStream& operator>>(QDataStream&, SireAnalysis::MBAR&);
+
+namespace SireAnalysis
+{
+
+/** This class implements the Multistate Bennett Acceptance Ratio (MBAR)
+    estimator of the free energies of a set of K states (lambda values).
+
+    Each sample is added together with the index of the state from which
+    it was drawn, and the energy of that sample evaluated at every one
+    of the K states (i.e. one column of the u_kn matrix). The free
+    energies are found by solving the MBAR self-consistent equations using
+    a Newton-Raphson solver (with all sums evaluated using log-sum-exp,
+    and falling back to a self-consistent iteration if a Newton step does
+    not reduce the gradient). The sums over samples are parallelised.
+
+    Samples can be added at any time, and re-solving starts from the
+    previous free energies, so this can be used to check the convergence
+    of a simulation on-the-fly. Errors are estimated by bootstrapping
+    the samples (with the bootstrap replicas solved in parallel).
+
+    @author Christopher Woods
+*/
+class SIREANALYSIS_EXPORT MBAR : public SireBase::ConcreteProperty<MBAR,SireBase::Property>
+{
+
+friend QDataStream& ::operator<<(QDataStream&, const MBAR&);
+friend QDataStream& ::operator>>(QDataStream&, MBAR&);
+
+public:
+    MBAR();
+
+    MBAR(const QList<double> &lambda_values,
+         const SireUnits::Dimension::Temperature &temperature);
+
+    MBAR(const QList<double> &lambda_values,
+         const QVector< QVector<double> > &energies,
+         const QVector<qint64> &nsamples,
+         const SireUnits::Dimension::Temperature &temperature);
+
+    MBAR(const MBAR &other);
+
+    ~MBAR();
+
+    MBAR& operator=(const MBAR &other);
+
+    bool operator==(const MBAR &other) const;
+    bool operator!=(const MBAR &other) const;
+
+    const char* what() const;
+    static const char* typeName();
+
+    QString toString() const;
+
+    bool isEmpty() const;
+
+    void add(int state, const QVector<double> &energies);
+
+    void add(const QVector< QVector<double> > &energies,
+             const QVector<qint64> &nsamples);
+
+    SireUnits::Dimension::Temperature temperature() const;
+
+    QList<double> lambdaValues() const;
+
+    int nStates() const;
+
+    qint64 nSamples() const;
+    qint64 nSamples(int state) const;
+
+    void setTolerance(double tolerance);
+    double tolerance() const;
+
+    void setMaxIterations(int maxiter);
+    int maxIterations() const;
+
+    void solve();
+
+    void bootstrap(int nbootstrap);
+    void bootstrap(int nbootstrap, quint32 seed);
+
+    bool isSolved() const;
+    bool isConverged() const;
+    int nIterations() const;
+
+    int nBootstraps() const;
+
+    QVector<double> reducedFreeEnergies() const;
+    QVector<double> freeEnergies() const;
+    QVector<double> errors() const;
+
+    PMF pmf() const;
+
+    void clear();
+
+private:
+    void checkState(int state) const;
+
+    /** The lambda values of each of the K states */
+    QList<double> lamvals;
+
+    /** The temperature (in kelvin) at which the samples were collected.
+        This is used to convert energies into reduced energies */
+    double temp;
+
+    /** The reduced energy of each sample at each state, stored sample-major,
+        i.e. u(k,n) is at index n*K + k */
+    QVector<double> u_nk;
+
+    /** The index of the state from which each sample was drawn */
+    QVector<qint32> sample_states;
+
+    /** The number of samples drawn from each state */
+    QVector<qint64> nsamps;
+
+    /** The reduced free energies of each state, relative to the first.
+        These are kept after samples are added so that the next
+        solve starts from a good guess */
+    QVector<double> f_k;
+
+    /** The bootstrap error on each free energy (in kcal mol-1) */
+    QVector<double> errs;
+
+    /** The convergence tolerance on the gradient */
+    double tol;
+
+    /** The maximum number of iterations of the solver */
+    qint32 maxiter;
+
+    /** The number of iterations used in the last solve */
+    qint32 niters;
+
+    /** The number of bootstrap replicas used to calculate the errors */
+    qint32 nboots;
+
+    /** Whether the free energies are up to date with the samples */
+    bool solved;
+
+    /** Whether or not the last solve converged */
+    bool converged;
+};
+
+}
+
+Q_DECLARE_METATYPE( SireAnalysis::MBAR )
+
+SIRE_EXPOSE_CLASS( SireAnalysis::MBAR )
+
+SIRE_END_HEADER
+
+#endif
@@ -0,0 +1,197 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "SireAnalysis/mbar.h"
+
+#include "SireMaths/rangenerator.h"
+
+#include "SireUnits/units.h"
+
+#include "SireBase/unittest.h"
+
+#include <QDebug>
+
+#include <cmath>
+
+using namespace SireAnalysis;
+using namespace SireMaths;
+using namespace SireUnits;
+using namespace SireBase;
+
+/** The temperature at which the samples are drawn */
+static const double temperature = 298.15;
+
+/** Return the energy (in kcal mol-1) of 'x' in the harmonic well
+    with force constant 'k', centered at 'x0' */
+static double harmonic(double x, double k, double x0)
+{
+    return 0.5 * k * (x-x0) * (x-x0);
+}
+
+/** Solve the two-state BAR equation for the reduced free energy difference
+    f1 - f0, using the reduced work 'w_f' (u1 - u0) of the samples from
+    state 0 and 'w_r' (u0 - u1) of the samples from state 1. This uses
+    bisection, so that it is independent of the MBAR solver */
+static double solveBAR(const QVector<double> &w_f, const QVector<double> &w_r)
+{
+    const double m = std::log( double(w_f.count()) / w_r.count() );
+
+    //the difference between the forward and reverse sums, which
+    //increases monotonically with df
+    auto imbalance = [&](double df)
+    {
+        double fwd = 0;
+
+        for (const double w : w_f)
+        {
+            fwd += 1.0 / (1.0 + std::exp(m + w - df));
+        }
+
+        double rev = 0;
+
+        for (const double w : w_r)
+        {
+            rev += 1.0 / (1.0 + std::exp(-m + w + df));
+        }
+
+        return fwd - rev;
+    };
+
+    double lo = -100;
+    double hi = 100;
+
+    for (int i=0; i<200; ++i)
+    {
+        const double mid = 0.5 * (lo + hi);
+
+        if (imbalance(mid) > 0)
+            hi = mid;
+        else
+            lo = mid;
+    }
+
+    return 0.5 * (lo + hi);
+}
+
+void test_mbar(bool verbose)
+{
+    RanGenerator rand(42);
+
+    const double kT = k_boltz * temperature;
+
+    //two harmonic wells with different widths and centers, which overlap
+    const double k0 = 2.0;
+    const double k1 = 3.0;
+    const double x0 = 0.0;
+    const double x1 = 0.5;
+
+    const int n0 = 500;
+    const int n1 = 700;
+
+    QVector< QVector<double> > energies(2);
+    QVector<double> w_f, w_r;
+
+    MBAR single( QList<double>() << 0.0 << 1.0, temperature*kelvin );
+
+    for (int i=0; i<n0+n1; ++i)
+    {
+        const int state = (i < n0) ? 0 : 1;
+
+        //the Boltzmann distribution of each well is a normal distribution
+        //with standard deviation sqrt(kT/k) (which is what randNorm takes)
+        const double x = (state == 0) ? rand.randNorm(x0, std::sqrt(kT/k0))
+                                      : rand.randNorm(x1, std::sqrt(kT/k1));
+
+        const double e0 = harmonic(x, k0, x0);
+        const double e1 = harmonic(x, k1, x1);
+
+        energies[0].append(e0);
+        energies[1].append(e1);
+
+        if (state == 0)
+            w_f.append( (e1 - e0) / kT );
+        else
+            w_r.append( (e0 - e1) / kT );
+
+        single.add( state, QVector<double>() << e0 << e1 );
+    }
+
+    QVector<qint64> nsamples;
+    nsamples << n0 << n1;
+
+    MBAR mbar( QList<double>() << 0.0 << 1.0, energies, nsamples, temperature*kelvin );
+
+    assert_equal( mbar.nStates(), 2, CODELOC );
+    assert_equal( mbar.nSamples(), qint64(n0+n1), CODELOC );
+    assert_equal( mbar.nSamples(1), qint64(n1), CODELOC );
+
+    mbar.solve();
+    single.solve();
+
+    assert_true( mbar.isConverged(), CODELOC );
+    assert_true( single.isConverged(), CODELOC );
+
+    const double bar = solveBAR(w_f, w_r);
+    const double analytic = 0.5 * std::log(k1 / k0);
+
+    const QVector<double> f = mbar.reducedFreeEnergies();
+
+    if (verbose)
+        qDebug() << "MBAR" << f[1] << "BAR" << bar << "analytic" << analytic
+                 << "iterations" << mbar.nIterations();
+
+    //with two states, MBAR reduces exactly to BAR
+    assert_nearly_equal( f[0], 0.0, 1e-10, CODELOC );
+    assert_nearly_equal( f[1], bar, 1e-6, CODELOC );
+
+    //adding the samples one at a time gives the same answer
+    assert_nearly_equal( single.reducedFreeEnergies()[1], f[1], 1e-8, CODELOC );
+
+    //the free energies in kcal mol-1 are the reduced free energies times kT
+    assert_nearly_equal( mbar.freeEnergies()[1], kT * f[1], 1e-8, CODELOC );
+
+    //and BAR should agree with the exact answer within the sampling error
+    assert_nearly_equal( f[1], analytic, 0.1, CODELOC );
+
+    //re-solving after adding more samples starts from the previous answer,
+    //and should still agree with BAR on all of the samples
+    const double x = rand.randNorm(x1, std::sqrt(kT/k1));
+    const double e0 = harmonic(x, k0, x0);
+    const double e1 = harmonic(x, k1, x1);
+
+    single.add( 1, QVector<double>() << e0 << e1 );
+    w_r.append( (e0 - e1) / kT );
+
+    assert_false( single.isSolved(), CODELOC );
+
+    single.solve();
+
+    assert_nearly_equal( single.reducedFreeEnergies()[1], solveBAR(w_f, w_r), 1e-6, CODELOC );
+}
+
+SIRE_UNITTEST( test_mbar )
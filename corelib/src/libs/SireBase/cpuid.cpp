@@ -138,6 +138,42 @@ QDataStream SIREBASE_EXPORT &operator>>(QDataStream &ds, CPUID &cpuid)
 
         return data;
     }
+#else
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+    static QString trueFalse(bool val)
+    {
+        if (val)
+            return "true";
+        else
+            return "false";
+    }
+
+    /** Without libcpuid we can still use the compiler builtins to find
+        the vector instruction sets that are supported, which is all that
+        is needed to choose between the runtime-dispatched kernels */
+    static QHash<QString,QString> getCPUInfo()
+    {
+        __builtin_cpu_init();
+
+        QHash<QString,QString> data;
+
+        data.insert("sse2", trueFalse(__builtin_cpu_supports("sse2")));
+        data.insert("sse4_1", trueFalse(__builtin_cpu_supports("sse4.1")));
+        data.insert("avx", trueFalse(__builtin_cpu_supports("avx")));
+        data.insert("avx2", trueFalse(__builtin_cpu_supports("avx2")));
+        data.insert("fma3", trueFalse(__builtin_cpu_supports("fma")));
+        data.insert("avx512f", trueFalse(__builtin_cpu_supports("avx512f")));
+
+        return data;
+    }
+
+    /** Return the list of all searchable supportable features */
+    QStringList CPUID::supportableFeatures() const
+    {
+        QStringList features;
+        features << "avx" << "avx2" << "avx512f" << "fma3" << "sse2" << "sse4_1";
+        return features;
+    }
 #else
     static QHash<QString,QString> getCPUInfo()
     {
@@ -150,6 +186,7 @@ QDataStream SIREBASE_EXPORT &operator>>(QDataStream &ds, CPUID &cpuid)
         return QStringList();
     }
 #endif
+#endif
 
 QHash<QString,QString>* CPUID::global_props = 0;
 
@@ -281,3 +318,22 @@ bool CPUID::supportsAVX() const
 {
     return supports("avx");
 }
+
+/** Return whether or not this processor supports AVX2 vector instructions */
+bool CPUID::supportsAVX2() const
+{
+    return supports("avx2");
+}
+
+/** Return whether or not this processor supports fused multiply-add (FMA3)
+    instructions */
+bool CPUID::supportsFMA3() const
+{
+    return supports("fma3");
+}
+
+/** Return whether or not this processor supports AVX-512F vector instructions */
+bool CPUID::supportsAVX512F() const
+{
+    return supports("avx512f");
+}
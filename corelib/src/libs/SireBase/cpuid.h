@@ -89,6 +89,9 @@ public:
     
     bool supportsSSE2() const;
     bool supportsAVX() const;
+    bool supportsAVX2() const;
+    bool supportsFMA3() const;
+    bool supportsAVX512F() const;
     
 private:
     QHash<QString,QString>* getCPUID();
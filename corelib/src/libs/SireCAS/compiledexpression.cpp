@@ -0,0 +1,1084 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "compiledexpression.h"
+#include "values.h"
+#include "sum.h"
+#include "product.h"
+#include "power.h"
+#include "powerconstant.h"
+#include "exp.h"
+#include "trigfuncs.h"
+#include "hyperbolicfuncs.h"
+#include "invtrigfuncs.h"
+#include "abs.h"
+#include "minmax.h"
+#include "function.h"
+
+#include "SireMaths/maths.h"
+#include "SireMaths/constants.h"
+
+#include "SireError/errors.h"
+
+#include "SireStream/datastream.h"
+#include "SireStream/shareddatastream.h"
+
+#include <QVarLengthArray>
+#include <QStringList>
+
+#include <cmath>
+
+using namespace SireCAS;
+
+namespace SireCAS
+{
+    namespace detail
+    {
+        /** The bytecode instructions. All instructions are four integers
+            (opcode, result, a, b), where 'a' and 'b' are registers, except
+            for POWI (b is the integer power) and EVAL (a is the index of
+            the fallback expression) */
+        enum OpCode { OP_ADD = 0, OP_SUB, OP_MUL, OP_DIV, OP_NEG,
+                      OP_POWI, OP_POW, OP_POWER,
+                      OP_EXP, OP_LN, OP_ABS,
+                      OP_COS, OP_SIN, OP_TAN, OP_SEC, OP_CSC, OP_COT,
+                      OP_ARCTAN, OP_COSH, OP_SINH, OP_TANH,
+                      OP_MIN, OP_MAX, OP_EVAL };
+
+        /** Return whether the instruction 'op' reads register 'b' */
+        static bool isBinary(qint32 op)
+        {
+            switch (op)
+            {
+                case OP_ADD:
+                case OP_SUB:
+                case OP_MUL:
+                case OP_DIV:
+                case OP_POW:
+                case OP_POWER:
+                case OP_MIN:
+                case OP_MAX:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        /** Registers holding temporary values are numbered from this
+            value while compiling, and are moved to after the inputs
+            and constants once the number of constants is known */
+        static const qint32 TEMP_REGISTER = 1 << 24;
+
+        /** Internal class used to compile an expression tree into bytecode */
+        class ExpressionCompiler
+        {
+        public:
+            ExpressionCompiler(const QList<Symbol> &symbols,
+                               QVector<double> &constants,
+                               QVector<qint32> &bytecode,
+                               QVector<Expression> &fallbacks)
+                 : syms(symbols), consts(constants), code(bytecode),
+                   funcs(fallbacks), ntemps(0)
+            {}
+
+            qint32 compile(const Expression &ex);
+
+            int nTemps() const
+            {
+                return ntemps;
+            }
+
+        private:
+            qint32 compileBase(const ExpressionBase &base);
+
+            qint32 input(const Symbol &symbol);
+            qint32 constant(double value);
+
+            qint32 add(qint32 op, qint32 a, qint32 b=0);
+
+            const QList<Symbol> &syms;
+            QVector<double> &consts;
+            QVector<qint32> &code;
+            QVector<Expression> &funcs;
+
+            int ntemps;
+        };
+
+        /** Add the instruction 'op' that acts on 'a' and 'b' and
+            return the register that holds the result */
+        qint32 ExpressionCompiler::add(qint32 op, qint32 a, qint32 b)
+        {
+            qint32 result = TEMP_REGISTER + ntemps;
+            ntemps += 1;
+
+            code.append(op);
+            code.append(result);
+            code.append(a);
+            code.append(b);
+
+            return result;
+        }
+
+        /** Return the register holding the value of the input 'symbol'.
+            Symbols that are not inputs have a value of zero, as they
+            would have if they were missing from a Values */
+        qint32 ExpressionCompiler::input(const Symbol &symbol)
+        {
+            for (int i=0; i<syms.count(); ++i)
+            {
+                if (syms.at(i).ID() == symbol.ID())
+                    return i;
+            }
+
+            return constant(0);
+        }
+
+        /** Return the register holding the constant 'value' */
+        qint32 ExpressionCompiler::constant(double value)
+        {
+            int idx = consts.indexOf(value);
+
+            if (idx == -1)
+            {
+                idx = consts.count();
+                consts.append(value);
+            }
+
+            return syms.count() + idx;
+        }
+
+        /** Compile the expression 'ex', returning the register that
+            will hold its value */
+        qint32 ExpressionCompiler::compile(const Expression &ex)
+        {
+            if (ex.isConstant())
+                return constant( ex.evaluate(Values()) );
+
+            qint32 reg = compileBase(ex.base());
+
+            if (ex.factor() == -1)
+                return add(OP_NEG, reg);
+            else if (ex.factor() != 1)
+                return add(OP_MUL, constant(ex.factor()), reg);
+            else
+                return reg;
+        }
+
+        /** Compile the expression base 'base', returning the register
+            that will hold its value */
+        qint32 ExpressionCompiler::compileBase(const ExpressionBase &base)
+        {
+            if (base.isA<Symbol>() and not base.isA<Function>())
+            {
+                return input( base.asA<Symbol>() );
+            }
+            else if (base.isA<Sum>())
+            {
+                const Sum &sum = base.asA<Sum>();
+
+                qint32 reg = -1;
+
+                if (sum.strtval != 0)
+                    reg = constant(sum.strtval);
+
+                for (QHash<ExpressionBase,Expression>::const_iterator
+                                                    it = sum.posparts.constBegin();
+                     it != sum.posparts.constEnd();
+                     ++it)
+                {
+                    qint32 part = compile(*it);
+                    reg = (reg == -1) ? part : add(OP_ADD, reg, part);
+                }
+
+                for (QHash<ExpressionBase,Expression>::const_iterator
+                                                    it = sum.negparts.constBegin();
+                     it != sum.negparts.constEnd();
+                     ++it)
+                {
+                    qint32 part = compile(*it);
+                    reg = (reg == -1) ? add(OP_NEG, part) : add(OP_SUB, reg, part);
+                }
+
+                if (reg == -1)
+                    reg = constant(0);
+
+                return reg;
+            }
+            else if (base.isA<Product>())
+            {
+                const Product &product = base.asA<Product>();
+
+                if (SireMaths::isZero(product.strtval))
+                    return constant(0);
+
+                qint32 reg = -1;
+
+                if (product.strtval != 1)
+                    reg = constant(product.strtval);
+
+                for (QHash<Expression,Expression>::const_iterator
+                                                    it = product.numparts.constBegin();
+                     it != product.numparts.constEnd();
+                     ++it)
+                {
+                    qint32 part = compile(*it);
+                    reg = (reg == -1) ? part : add(OP_MUL, reg, part);
+                }
+
+                if (not product.denomparts.isEmpty())
+                {
+                    qint32 denom = -1;
+
+                    for (QHash<Expression,Expression>::const_iterator
+                                                    it = product.denomparts.constBegin();
+                         it != product.denomparts.constEnd();
+                         ++it)
+                    {
+                        qint32 part = compile(*it);
+                        denom = (denom == -1) ? part : add(OP_MUL, denom, part);
+                    }
+
+                    if (reg == -1)
+                        reg = constant(1);
+
+                    reg = add(OP_DIV, reg, denom);
+                }
+
+                if (reg == -1)
+                    reg = constant(1);
+
+                return reg;
+            }
+            else if (base.isA<IntegerPower>())
+            {
+                const IntegerPower &power = base.asA<IntegerPower>();
+
+                const int n = int( power.power().evaluate(Values()) );
+                qint32 core = compile(power.core());
+
+                if (n == 2)
+                    return add(OP_MUL, core, core);
+                else
+                    return add(OP_POWI, core, n);
+            }
+            else if (base.isA<RationalPower>() or base.isA<RealPower>())
+            {
+                const PowerFunction &power = base.asA<PowerFunction>();
+
+                qint32 core = compile(power.core());
+
+                return add(OP_POW, core,
+                           constant(power.power().evaluate(Values())));
+            }
+            else if (base.isA<Exp>())
+            {
+                return add(OP_EXP, compile(base.asA<Exp>().power()));
+            }
+            else if (base.isA<PowerConstant>())
+            {
+                const PowerConstant &power = base.asA<PowerConstant>();
+
+                qint32 core = compile(power.core());
+                return add(OP_POW, core, compile(power.power()));
+            }
+            else if (base.isA<Power>())
+            {
+                const Power &power = base.asA<Power>();
+
+                qint32 core = compile(power.core());
+                return add(OP_POWER, core, compile(power.power()));
+            }
+            else if (base.isA<Min>() or base.isA<Max>())
+            {
+                const DoubleFunc &func = base.asA<DoubleFunc>();
+
+                qint32 x = compile(func.x());
+                qint32 y = compile(func.y());
+
+                return add( base.isA<Min>() ? OP_MIN : OP_MAX, x, y );
+            }
+            else if (base.isA<SingleFunc>())
+            {
+                qint32 op = -1;
+
+                if (base.isA<Cos>())
+                    op = OP_COS;
+                else if (base.isA<Sin>())
+                    op = OP_SIN;
+                else if (base.isA<Tan>())
+                    op = OP_TAN;
+                else if (base.isA<Sec>())
+                    op = OP_SEC;
+                else if (base.isA<Csc>())
+                    op = OP_CSC;
+                else if (base.isA<Cot>())
+                    op = OP_COT;
+                else if (base.isA<ArcTan>())
+                    op = OP_ARCTAN;
+                else if (base.isA<Cosh>())
+                    op = OP_COSH;
+                else if (base.isA<Sinh>())
+                    op = OP_SINH;
+                else if (base.isA<Tanh>())
+                    op = OP_TANH;
+                else if (base.isA<Ln>())
+                    op = OP_LN;
+                else if (base.isA<Abs>())
+                    op = OP_ABS;
+
+                if (op != -1)
+                    return add(op, compile(base.asA<SingleFunc>().argument()));
+            }
+
+            //this part of the expression can't be compiled, so will
+            //be evaluated using Expression::evaluate
+            funcs.append( Expression(base) );
+            return add(OP_EVAL, funcs.count() - 1);
+        }
+
+        /** Return whether or not 'ex' is linear in 'x', i.e. equal to
+            a x + b, returning 'a' and 'b' if it is */
+        static bool getLinear(const Expression &ex, const Symbol &x,
+                              double &a, double &b)
+        {
+            if (ex.isConstant())
+            {
+                a = 0;
+                b = ex.evaluate(Values());
+                return true;
+            }
+
+            const ExpressionBase &base = ex.base();
+
+            if (base.isA<Symbol>() and not base.isA<Function>())
+            {
+                if (base.asA<Symbol>().ID() != x.ID())
+                    return false;
+
+                a = ex.factor();
+                b = 0;
+                return true;
+            }
+            else if (base.isA<Sum>())
+            {
+                a = 0;
+                b = 0;
+
+                foreach (const Expression &child, base.children())
+                {
+                    double child_a, child_b;
+
+                    if (not getLinear(child, x, child_a, child_b))
+                        return false;
+
+                    a += child_a;
+                    b += child_b;
+                }
+
+                a *= ex.factor();
+                b *= ex.factor();
+                return true;
+            }
+
+            return false;
+        }
+
+        /** Return whether or not 'ex' has the form k (a x + b)^2, returning
+            the parameters (k, a, b) in 'params' if it does */
+        static bool getHarmonic(const Expression &ex, const Symbol &x,
+                                QVector<double> &params)
+        {
+            if (not ex.base().isA<IntegerPower>())
+                return false;
+
+            const IntegerPower &power = ex.base().asA<IntegerPower>();
+
+            if (power.power().evaluate(Values()) != 2)
+                return false;
+
+            double a, b;
+
+            if (not getLinear(power.core(), x, a, b))
+                return false;
+
+            params = QVector<double>(3);
+            params[0] = ex.factor();
+            params[1] = a;
+            params[2] = b;
+
+            return true;
+        }
+
+        /** Add the expression 'ex', scaled by 'scale', onto the Fourier
+            series c + sum_i k_i cos( n_i x + d_i ). This returns whether
+            or not 'ex' is part of such a series. The parameters are
+            added to 'params' as c, k_0, n_0, d_0, k_1, n_1, d_1 etc. */
+        static bool getFourier(const Expression &ex, const Symbol &x,
+                               double scale, QVector<double> &params)
+        {
+            if (ex.isConstant())
+            {
+                params[0] += scale * ex.evaluate(Values());
+                return true;
+            }
+
+            const ExpressionBase &base = ex.base();
+            scale *= ex.factor();
+
+            if (base.isA<Sum>())
+            {
+                foreach (const Expression &child, base.children())
+                {
+                    if (not getFourier(child, x, scale, params))
+                        return false;
+                }
+
+                return true;
+            }
+            else if (base.isA<Cos>() or base.isA<Sin>())
+            {
+                double a, b;
+
+                if (not getLinear(base.asA<SingleFunc>().argument(), x, a, b))
+                    return false;
+
+                //sin(y) == cos(y - pi/2)
+                if (base.isA<Sin>())
+                    b -= 0.5 * SireMaths::pi;
+
+                params.append(scale);
+                params.append(a);
+                params.append(b);
+
+                return true;
+            }
+
+            return false;
+        }
+
+        /** The number of points evaluated at once by the batched bytecode */
+        static const int BATCH_SIZE = 64;
+
+    } // end of namespace detail
+} // end of namespace SireCAS
+
+using namespace SireCAS::detail;
+using namespace SireStream;
+
+static const RegisterMetaType<CompiledExpression> r_compiled(NO_ROOT);
+
+/** Serialise to a binary datastream. Only the expression and inputs
+    are saved, as the expression is recompiled when it is loaded */
+QDataStream SIRECAS_EXPORT &operator<<(QDataStream &ds, const CompiledExpression &compiled)
+{
+    writeHeader(ds, r_compiled, 1);
+
+    SharedDataStream sds(ds);
+
+    sds << compiled.ex << compiled.syms;
+
+    return ds;
+}
+
+/** Extract from a binary datastream */
+QDataStream SIRECAS_EXPORT &operator>>(QDataStream &ds, CompiledExpression &compiled)
+{
+    VersionID v = readHeader(ds, r_compiled);
+
+    if (v == 1)
+    {
+        SharedDataStream sds(ds);
+
+        Expression ex;
+        QList<Symbol> syms;
+
+        sds >> ex >> syms;
+
+        compiled = CompiledExpression(ex, syms);
+    }
+    else
+        throw version_error(v, "1", r_compiled, CODELOC);
+
+    return ds;
+}
+
+/** Null constructor */
+CompiledExpression::CompiledExpression()
+                   : kern(CONSTANT), nregs(0), result_reg(0)
+{
+    params = QVector<double>(1, 0.0);
+}
+
+/** Compile the expression 'expression', which is a function of the
+    single input 'input' */
+CompiledExpression::CompiledExpression(const Expression &expression,
+                                       const Symbol &input)
+                   : ex(expression), kern(CONSTANT), nregs(0), result_reg(0)
+{
+    syms.append(input);
+    this->compile();
+}
+
+/** Compile the expression 'expression', which is a function of the
+    inputs 'inputs' (in the order in which their values will be passed) */
+CompiledExpression::CompiledExpression(const Expression &expression,
+                                       const QList<Symbol> &inputs)
+                   : ex(expression), syms(inputs),
+                     kern(CONSTANT), nregs(0), result_reg(0)
+{
+    this->compile();
+}
+
+/** Copy constructor */
+CompiledExpression::CompiledExpression(const CompiledExpression &other)
+                   : ex(other.ex), syms(other.syms), params(other.params),
+                     code(other.code), fallbacks(other.fallbacks),
+                     kern(other.kern), nregs(other.nregs),
+                     result_reg(other.result_reg)
+{}
+
+/** Destructor */
+CompiledExpression::~CompiledExpression()
+{}
+
+/** Copy assignment operator */
+CompiledExpression& CompiledExpression::operator=(const CompiledExpression &other)
+{
+    if (this != &other)
+    {
+        ex = other.ex;
+        syms = other.syms;
+        params = other.params;
+        code = other.code;
+        fallbacks = other.fallbacks;
+        kern = other.kern;
+        nregs = other.nregs;
+        result_reg = other.result_reg;
+    }
+
+    return *this;
+}
+
+/** Comparison operator */
+bool CompiledExpression::operator==(const CompiledExpression &other) const
+{
+    return this == &other or
+           (ex == other.ex and syms == other.syms);
+}
+
+/** Comparison operator */
+bool CompiledExpression::operator!=(const CompiledExpression &other) const
+{
+    return not operator==(other);
+}
+
+const char* CompiledExpression::typeName()
+{
+    return "SireCAS::CompiledExpression";
+}
+
+/** Return a string representation of the compiled expression */
+QString CompiledExpression::toString() const
+{
+    QString kernel_name;
+
+    switch (kern)
+    {
+        case CONSTANT:
+            kernel_name = "constant";
+            break;
+        case HARMONIC:
+            kernel_name = "harmonic";
+            break;
+        case FOURIER:
+            kernel_name = "fourier";
+            break;
+        default:
+            kernel_name = QObject::tr("bytecode, %1 instructions").arg(nInstructions());
+    }
+
+    return QObject::tr("CompiledExpression( %1 : %2 )")
+                .arg(ex.toString()).arg(kernel_name);
+}
+
+/** Return the expression that was compiled */
+const Expression& CompiledExpression::expression() const
+{
+    return ex;
+}
+
+/** Return the input symbols, in the order in which their values
+    must be passed to evaluate */
+const QList<Symbol>& CompiledExpression::inputs() const
+{
+    return syms;
+}
+
+/** Return the number of input symbols */
+int CompiledExpression::nInputs() const
+{
+    return syms.count();
+}
+
+/** Return the kernel used to evaluate this expression */
+CompiledExpression::Kernel CompiledExpression::kernel() const
+{
+    return Kernel(kern);
+}
+
+/** Return the parameters of the closed-form kernel. These are the
+    value for CONSTANT, (k, a, b) for HARMONIC and (c, k_0, n_0, d_0,
+    k_1, n_1, d_1...) for FOURIER. The constants used by the
+    bytecode are returned for BYTECODE */
+QVector<double> CompiledExpression::parameters() const
+{
+    return params;
+}
+
+/** Return the number of bytecode instructions (zero if
+    this is evaluated using a closed-form kernel) */
+int CompiledExpression::nInstructions() const
+{
+    return code.count() / 4;
+}
+
+/** Compile the expression */
+void CompiledExpression::compile()
+{
+    params.clear();
+    code.clear();
+    fallbacks.clear();
+    nregs = 0;
+    result_reg = 0;
+
+    if (ex.isConstant())
+    {
+        kern = CONSTANT;
+        params = QVector<double>(1, ex.evaluate(Values()));
+        return;
+    }
+
+    if (syms.count() == 1)
+    {
+        const Symbol &x = syms.at(0);
+
+        if (getHarmonic(ex, x, params))
+        {
+            kern = HARMONIC;
+            return;
+        }
+
+        params = QVector<double>(1, 0.0);
+
+        if (getFourier(ex, x, 1.0, params) and params.count() > 1)
+        {
+            kern = FOURIER;
+            return;
+        }
+
+        params.clear();
+    }
+
+    kern = BYTECODE;
+
+    ExpressionCompiler compiler(syms, params, code, fallbacks);
+    result_reg = compiler.compile(ex);
+
+    //move the temporary registers to after the inputs and constants
+    const qint32 ntemp_start = syms.count() + params.count();
+
+    for (int i=0; i<code.count(); i+=4)
+    {
+        const qint32 op = code[i];
+
+        code[i+1] += ntemp_start - TEMP_REGISTER;
+
+        if (op != OP_EVAL and code[i+2] >= TEMP_REGISTER)
+            code[i+2] += ntemp_start - TEMP_REGISTER;
+
+        if (isBinary(op) and code[i+3] >= TEMP_REGISTER)
+            code[i+3] += ntemp_start - TEMP_REGISTER;
+    }
+
+    if (result_reg >= TEMP_REGISTER)
+        result_reg += ntemp_start - TEMP_REGISTER;
+
+    nregs = ntemp_start + compiler.nTemps();
+}
+
+/** Evaluate the fallback expression at index 'i' for the inputs 'inputs' */
+double CompiledExpression::fallback(int i, const double *inputs) const
+{
+    Values values;
+
+    for (int j=0; j<syms.count(); ++j)
+    {
+        values.set(syms.at(j), inputs[j]);
+    }
+
+    return fallbacks.at(i).evaluate(values);
+}
+
+/** Evaluate the result of the single instruction 'op' */
+static inline double runOp(qint32 op, double a, double b, qint32 n)
+{
+    switch (op)
+    {
+        case OP_ADD:
+            return a + b;
+        case OP_SUB:
+            return a - b;
+        case OP_MUL:
+            return a * b;
+        case OP_DIV:
+            return a / b;
+        case OP_NEG:
+            return -a;
+        case OP_POWI:
+            return SireMaths::pow(a, int(n));
+        case OP_POW:
+            return SireMaths::pow(a, b);
+        case OP_POWER:
+            //same as Power::evaluate
+            if (SireMaths::isZero(b))
+                return 1.0;
+            else if (SireMaths::isZero(a))
+                return a;
+            else
+                return SireMaths::pow(a, b);
+        case OP_EXP:
+            return std::exp(a);
+        case OP_LN:
+            return std::log(a);
+        case OP_ABS:
+            return std::abs(a);
+        case OP_COS:
+            return std::cos(a);
+        case OP_SIN:
+            return std::sin(a);
+        case OP_TAN:
+            return std::tan(a);
+        case OP_SEC:
+            return double(1.0) / std::cos(a);
+        case OP_CSC:
+            return double(1.0) / std::sin(a);
+        case OP_COT:
+            return double(1.0) / std::tan(a);
+        case OP_ARCTAN:
+            return std::atan(a);
+        case OP_COSH:
+            return std::cosh(a);
+        case OP_SINH:
+            return std::sinh(a);
+        case OP_TANH:
+            return std::tanh(a);
+        case OP_MIN:
+            return qMin(a, b);
+        case OP_MAX:
+            return qMax(a, b);
+        default:
+            return 0;
+    }
+}
+
+/** Evaluate the Fourier series kernel for the value 'x' */
+double CompiledExpression::evaluateFourier(double x) const
+{
+    const double *p = params.constData();
+    const int nterms = (params.count() - 1) / 3;
+
+    double result = p[0];
+
+    for (int i=0; i<nterms; ++i)
+    {
+        const double *t = p + 1 + 3*i;
+        result += t[0] * std::cos( t[1]*x + t[2] );
+    }
+
+    return result;
+}
+
+/** Run the bytecode for the single set of inputs 'inputs' */
+double CompiledExpression::runBytecode(const double *inputs) const
+{
+    QVarLengthArray<double,64> registers(nregs);
+    double *r = registers.data();
+
+    const int ninputs = syms.count();
+
+    for (int i=0; i<ninputs; ++i)
+    {
+        r[i] = inputs[i];
+    }
+
+    const double *c = params.constData();
+
+    for (int i=0; i<params.count(); ++i)
+    {
+        r[ninputs+i] = c[i];
+    }
+
+    const qint32 *op = code.constData();
+    const qint32 *end = op + code.count();
+
+    for ( ; op != end; op += 4)
+    {
+        if (op[0] == OP_EVAL)
+            r[op[1]] = this->fallback(op[2], inputs);
+        else
+            r[op[1]] = runOp( op[0], r[op[2]],
+                              isBinary(op[0]) ? r[op[3]] : 0.0, op[3] );
+    }
+
+    return r[result_reg];
+}
+
+/** Run the bytecode for the 'n' sets of inputs in 'inputs' (one array
+    of 'n' values per input symbol), placing the results in 'results' */
+void CompiledExpression::runBytecode(const double * const *inputs, int n,
+                                     double *results) const
+{
+    //the registers are held as blocks of BATCH_SIZE values, so that
+    //each instruction is a simple (vectorisable) loop over the block
+    QVector<double> registers( nregs * BATCH_SIZE );
+    double *r = registers.data();
+
+    const int ninputs = syms.count();
+    const double *c = params.constData();
+
+    for (int i=0; i<params.count(); ++i)
+    {
+        double *reg = r + (ninputs+i)*BATCH_SIZE;
+
+        for (int k=0; k<BATCH_SIZE; ++k)
+        {
+            reg[k] = c[i];
+        }
+    }
+
+    QVarLengthArray<double,16> point(ninputs);
+
+    for (int start=0; start<n; start += BATCH_SIZE)
+    {
+        const int m = qMin(BATCH_SIZE, n - start);
+
+        for (int i=0; i<ninputs; ++i)
+        {
+            double *reg = r + i*BATCH_SIZE;
+            const double *in = inputs[i] + start;
+
+            for (int k=0; k<m; ++k)
+            {
+                reg[k] = in[k];
+            }
+        }
+
+        const qint32 *op = code.constData();
+        const qint32 *end = op + code.count();
+
+        for ( ; op != end; op += 4)
+        {
+            double *d = r + op[1]*BATCH_SIZE;
+
+            if (op[0] == OP_EVAL)
+            {
+                for (int k=0; k<m; ++k)
+                {
+                    for (int i=0; i<ninputs; ++i)
+                    {
+                        point[i] = inputs[i][start+k];
+                    }
+
+                    d[k] = this->fallback(op[2], point.constData());
+                }
+
+                continue;
+            }
+
+            const double *a = r + op[2]*BATCH_SIZE;
+            const double *b = isBinary(op[0]) ? r + op[3]*BATCH_SIZE : a;
+
+            switch (op[0])
+            {
+                case OP_ADD:
+                    for (int k=0; k<m; ++k){ d[k] = a[k] + b[k]; }
+                    break;
+                case OP_SUB:
+                    for (int k=0; k<m; ++k){ d[k] = a[k] - b[k]; }
+                    break;
+                case OP_MUL:
+                    for (int k=0; k<m; ++k){ d[k] = a[k] * b[k]; }
+                    break;
+                case OP_DIV:
+                    for (int k=0; k<m; ++k){ d[k] = a[k] / b[k]; }
+                    break;
+                case OP_NEG:
+                    for (int k=0; k<m; ++k){ d[k] = -a[k]; }
+                    break;
+                case OP_COS:
+                    for (int k=0; k<m; ++k){ d[k] = std::cos(a[k]); }
+                    break;
+                case OP_SIN:
+                    for (int k=0; k<m; ++k){ d[k] = std::sin(a[k]); }
+                    break;
+                case OP_EXP:
+                    for (int k=0; k<m; ++k){ d[k] = std::exp(a[k]); }
+                    break;
+                default:
+                    for (int k=0; k<m; ++k){ d[k] = runOp(op[0], a[k], b[k], op[3]); }
+            }
+        }
+
+        const double *result = r + result_reg*BATCH_SIZE;
+        double *out = results + start;
+
+        for (int k=0; k<m; ++k)
+        {
+            out[k] = result[k];
+        }
+    }
+}
+
+/** Evaluate the compiled expression using the values in 'values' */
+double CompiledExpression::evaluate(const Values &values) const
+{
+    QVarLengthArray<double,16> inputs(syms.count());
+
+    for (int i=0; i<syms.count(); ++i)
+    {
+        inputs[i] = values.value(syms.at(i));
+    }
+
+    return this->evaluate(inputs.constData());
+}
+
+/** Evaluate the compiled expression for a batch of 'n' points. 'inputs'
+    holds one array of 'n' values for each input symbol, and the 'n'
+    results are written into 'results' */
+void CompiledExpression::evaluate(const double * const *inputs, int n,
+                                  double *results) const
+{
+    if (n <= 0)
+        return;
+
+    switch (kern)
+    {
+        case CONSTANT:
+        {
+            const double val = params.constData()[0];
+
+            for (int i=0; i<n; ++i)
+            {
+                results[i] = val;
+            }
+
+            break;
+        }
+        case HARMONIC:
+        {
+            const double k = params.constData()[0];
+            const double a = params.constData()[1];
+            const double b = params.constData()[2];
+            const double *x = inputs[0];
+
+            for (int i=0; i<n; ++i)
+            {
+                const double t = a*x[i] + b;
+                results[i] = k * t * t;
+            }
+
+            break;
+        }
+        case FOURIER:
+        {
+            const double *p = params.constData();
+            const int nterms = (params.count() - 1) / 3;
+            const double *x = inputs[0];
+
+            for (int i=0; i<n; ++i)
+            {
+                results[i] = p[0];
+            }
+
+            for (int j=0; j<nterms; ++j)
+            {
+                const double *t = p + 1 + 3*j;
+
+                for (int i=0; i<n; ++i)
+                {
+                    results[i] += t[0] * std::cos( t[1]*x[i] + t[2] );
+                }
+            }
+
+            break;
+        }
+        default:
+            this->runBytecode(inputs, n, results);
+    }
+}
+
+/** Evaluate the compiled expression for a batch of points. 'inputs'
+    holds one array of values for each input symbol, and each array
+    must be the same size
+
+    \throw SireError::incompatible_error
+*/
+QVector<double> CompiledExpression::evaluate(
+                                const QVector< QVector<double> > &inputs) const
+{
+    if (inputs.count() != syms.count())
+        throw SireError::incompatible_error( QObject::tr(
+                "The compiled expression %1 needs values for %2 input symbols, "
+                "but values for %3 were passed.")
+                    .arg(this->toString()).arg(syms.count()).arg(inputs.count()),
+                        CODELOC );
+
+    if (inputs.isEmpty())
+        return QVector<double>(1, this->evaluate((const double*)0));
+
+    const int n = inputs.at(0).count();
+
+    QVarLengthArray<const double*,16> arrays(inputs.count());
+
+    for (int i=0; i<inputs.count(); ++i)
+    {
+        if (inputs.at(i).count() != n)
+            throw SireError::incompatible_error( QObject::tr(
+                    "The number of values for each input symbol must be the same. "
+                    "%1 values were passed for %2, but %3 for %4.")
+                        .arg(inputs.at(i).count()).arg(syms.at(i).toString())
+                        .arg(n).arg(syms.at(0).toString()), CODELOC );
+
+        arrays[i] = inputs.at(i).constData();
+    }
+
+    QVector<double> results(n);
+    this->evaluate(arrays.constData(), n, results.data());
+
+    return results;
+}
@@ -0,0 +1,203 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#ifndef SIRECAS_COMPILEDEXPRESSION_H
+#define SIRECAS_COMPILEDEXPRESSION_H
+
+#include <QVector>
+
+#include "expression.h"
+#include "symbol.h"
+
+SIRE_BEGIN_HEADER
+
+namespace SireCAS
+{
+class CompiledExpression;
+}
+
+QDataStream& operator<<(QDataStream&, const SireCAS::CompiledExpression&);
+QDataStream& operator>>(QDataStream&, SireCAS::CompiledExpression&);
+
+namespace SireCAS
+{
+
+class Values;
+
+/** This class holds an Expression that has been compiled into a
+    flat, register-based bytecode, so that it can be evaluated many
+    times (e.g. once for every bond in a large protein) without walking
+    the expression tree or looking up the values of symbols in a Values
+    hash.
+
+    The expression is compiled against an ordered list of input symbols.
+    The values of these symbols are passed as a plain array of doubles
+    for a single evaluation, or as one array per symbol when evaluating
+    the expression over a batch of points (structure-of-arrays).
+
+    Expressions that match a common closed form are compiled to a
+    specialised kernel rather than to bytecode. These are;
+
+    HARMONIC : k (a x + b)^2, e.g. k (r - r0)^2
+    FOURIER  : c + sum_i k_i cos( n_i x + d_i ), e.g. Amber torsions
+
+    Any part of an expression that cannot be compiled (e.g. a Function)
+    is evaluated via Expression::evaluate, so the compiled expression
+    always gives the same result as the original
+
+    @author Christopher Woods
+*/
+class SIRECAS_EXPORT CompiledExpression
+{
+
+friend QDataStream& ::operator<<(QDataStream&, const CompiledExpression&);
+friend QDataStream& ::operator>>(QDataStream&, CompiledExpression&);
+
+public:
+    enum Kernel { CONSTANT = 0,
+                  HARMONIC = 1,
+                  FOURIER = 2,
+                  BYTECODE = 3 };
+
+    CompiledExpression();
+    CompiledExpression(const Expression &expression, const Symbol &input);
+    CompiledExpression(const Expression &expression, const QList<Symbol> &inputs);
+
+    CompiledExpression(const CompiledExpression &other);
+
+    ~CompiledExpression();
+
+    CompiledExpression& operator=(const CompiledExpression &other);
+
+    bool operator==(const CompiledExpression &other) const;
+    bool operator!=(const CompiledExpression &other) const;
+
+    static const char* typeName();
+
+    const char* what() const
+    {
+        return CompiledExpression::typeName();
+    }
+
+    QString toString() const;
+
+    const Expression& expression() const;
+    const QList<Symbol>& inputs() const;
+
+    int nInputs() const;
+
+    Kernel kernel() const;
+
+    QVector<double> parameters() const;
+
+    int nInstructions() const;
+
+    double evaluate(double x) const;
+    double evaluate(const double *inputs) const;
+    double evaluate(const Values &values) const;
+
+    void evaluate(const double * const *inputs, int n, double *results) const;
+
+    QVector<double> evaluate(const QVector< QVector<double> > &inputs) const;
+
+private:
+    void compile();
+
+    double evaluateFourier(double x) const;
+
+    double runBytecode(const double *inputs) const;
+    void runBytecode(const double * const *inputs, int n, double *results) const;
+
+    double fallback(int i, const double *inputs) const;
+
+    /** The expression that has been compiled */
+    Expression ex;
+
+    /** The symbols whose values are passed as the inputs */
+    QList<Symbol> syms;
+
+    /** The parameters of the closed-form kernel, or the
+        constants used by the bytecode */
+    QVector<double> params;
+
+    /** The bytecode - each instruction is four integers,
+        (opcode, result register, operand register a, operand b) */
+    QVector<qint32> code;
+
+    /** The sub-expressions that could not be compiled and
+        that are evaluated using Expression::evaluate */
+    QVector<Expression> fallbacks;
+
+    /** The kernel used to evaluate the expression */
+    qint32 kern;
+
+    /** The number of registers needed by the bytecode, and the
+        register holding the result */
+    qint32 nregs, result_reg;
+};
+
+#ifndef SIRE_SKIP_INLINE_FUNCTIONS
+
+/** Evaluate the compiled expression for the input values 'inputs',
+    which must hold one value for each of the input symbols */
+inline double CompiledExpression::evaluate(const double *inputs) const
+{
+    switch (kern)
+    {
+        case HARMONIC:
+        {
+            const double *p = params.constData();
+            const double t = p[1]*inputs[0] + p[2];
+            return p[0] * t * t;
+        }
+        case FOURIER:
+            return this->evaluateFourier(inputs[0]);
+        case CONSTANT:
+            return params.constData()[0];
+        default:
+            return this->runBytecode(inputs);
+    }
+}
+
+/** Evaluate the compiled expression of a single input for the value 'x' */
+inline double CompiledExpression::evaluate(double x) const
+{
+    return this->evaluate(&x);
+}
+
+#endif // SIRE_SKIP_INLINE_FUNCTIONS
+
+}
+
+Q_DECLARE_METATYPE( SireCAS::CompiledExpression )
+
+SIRE_EXPOSE_CLASS( SireCAS::CompiledExpression )
+
+SIRE_END_HEADER
+
+#endif
@@ -47,6 +47,11 @@ QDataStream& operator>>(QDataStream&, SireCAS::Product&);
 namespace SireCAS
 {
 
+namespace detail
+{
+class ExpressionCompiler;
+}
+
 /**
 This class holds a collection of expressions that are to be multiplied (or divided)
 
@@ -58,6 +63,8 @@ class SIRECAS_EXPORT Product : public ExBase
 friend QDataStream& ::operator<<(QDataStream&, const Product&);
 friend QDataStream& ::operator>>(QDataStream&, Product&);
 
+friend class detail::ExpressionCompiler;
+
 public:
     Product();
     Product(const Expression &ex0, const Expression &ex1);
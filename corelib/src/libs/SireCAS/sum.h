@@ -49,6 +49,11 @@ namespace SireCAS
 
 class Product;
 
+namespace detail
+{
+class ExpressionCompiler;
+}
+
 /**
 This class holds a collection of expressions that are to be added (or subtracted) from one another
 
@@ -113,6 +118,7 @@ public:
 
 private:
     friend class Product;
+    friend class detail::ExpressionCompiler;
 
     void add(const Expression &ex);
 
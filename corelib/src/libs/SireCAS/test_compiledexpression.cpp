@@ -0,0 +1,322 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "SireCAS/compiledexpression.h"
+#include "SireCAS/expression.h"
+#include "SireCAS/symbol.h"
+#include "SireCAS/values.h"
+#include "SireCAS/trigfuncs.h"
+#include "SireCAS/invtrigfuncs.h"
+#include "SireCAS/hyperbolicfuncs.h"
+#include "SireCAS/exp.h"
+#include "SireCAS/minmax.h"
+#include "SireCAS/abs.h"
+
+#include "SireMaths/rangenerator.h"
+#include "SireMaths/constants.h"
+#include "SireMaths/rational.h"
+
+#include "SireBase/unittest.h"
+
+#include <QDataStream>
+#include <QByteArray>
+#include <QDebug>
+
+#include <cmath>
+
+using namespace SireCAS;
+using namespace SireMaths;
+using namespace SireBase;
+
+/** Return the value of 'ex' for the passed input values, calculated
+    by walking the expression tree */
+static double reference(const Expression &ex, const QList<Symbol> &inputs,
+                        const double *vals)
+{
+    Values values;
+
+    for (int i=0; i<inputs.count(); ++i)
+    {
+        values.set(inputs[i], vals[i]);
+    }
+
+    return ex.evaluate(values);
+}
+
+/** Check that the compiled form of 'ex' gives the same result as
+    Expression::evaluate for random input values in [minval,maxval],
+    using the single, Values and batched evaluate functions */
+static void check(const Expression &ex, const QList<Symbol> &inputs,
+                  CompiledExpression::Kernel kernel, double minval, double maxval,
+                  RanGenerator &rand, bool verbose)
+{
+    const CompiledExpression compiled(ex, inputs);
+
+    if (verbose)
+        qDebug() << compiled.toString();
+
+    assert_equal( int(compiled.kernel()), int(kernel), CODELOC );
+    assert_equal( compiled.nInputs(), inputs.count(), CODELOC );
+
+    if (kernel == CompiledExpression::BYTECODE)
+        assert_true( compiled.nInstructions() > 0, CODELOC );
+    else
+        assert_equal( compiled.nInstructions(), 0, CODELOC );
+
+    //use more points than a single batch of the bytecode, and
+    //a number that isn't a multiple of the batch size
+    const int npoints = 150;
+
+    QVector< QVector<double> > batch(inputs.count());
+
+    for (int i=0; i<inputs.count(); ++i)
+    {
+        batch[i] = QVector<double>(npoints);
+
+        for (int j=0; j<npoints; ++j)
+        {
+            batch[i][j] = rand.rand(minval, maxval);
+        }
+    }
+
+    const QVector<double> results = compiled.evaluate(batch);
+
+    assert_equal( results.count(), npoints, CODELOC );
+
+    for (int j=0; j<npoints; ++j)
+    {
+        QVector<double> vals(inputs.count());
+        Values values;
+
+        for (int i=0; i<inputs.count(); ++i)
+        {
+            vals[i] = batch[i][j];
+            values.set(inputs[i], vals[i]);
+        }
+
+        const double ref = reference(ex, inputs, vals.constData());
+        const double tol = 1e-10 * (std::abs(ref) + 1);
+
+        assert_nearly_equal( compiled.evaluate(vals.constData()), ref, tol, CODELOC );
+        assert_nearly_equal( compiled.evaluate(values), ref, tol, CODELOC );
+        assert_nearly_equal( results[j], ref, tol, CODELOC );
+
+        if (inputs.count() == 1)
+            assert_nearly_equal( compiled.evaluate(vals[0]), ref, tol, CODELOC );
+    }
+}
+
+/** Return whether the Fourier parameters 'params' contain the
+    term k cos( n x + d ) */
+static bool hasFourierTerm(const QVector<double> &params, double k, double n, double d)
+{
+    for (int i=1; i+2<params.count(); i+=3)
+    {
+        if (std::abs(params[i] - k) < 1e-12 and std::abs(params[i+1] - n) < 1e-12 and
+            std::abs(params[i+2] - d) < 1e-12)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void test_compiledexpression(bool verbose)
+{
+    RanGenerator rand(7);
+
+    const Symbol x("x");
+    const Symbol y("y");
+    const Symbol z("z");
+
+    const QList<Symbol> x_input = QList<Symbol>() << x;
+    const QList<Symbol> xy_input = QList<Symbol>() << x << y;
+
+    //constant expressions
+    check( Expression(3.5), x_input, CompiledExpression::CONSTANT, -2, 2, rand, verbose );
+
+    //the harmonic fast path
+    check( 3.5 * (x - 1.2).pow(2), x_input, CompiledExpression::HARMONIC,
+           0, 3, rand, verbose );
+    check( 2 * (3*x + 1).pow(2), x_input, CompiledExpression::HARMONIC,
+           -2, 2, rand, verbose );
+    check( -(0.5 - x).pow(2), x_input, CompiledExpression::HARMONIC,
+           -2, 2, rand, verbose );
+
+    {
+        const QVector<double> params = CompiledExpression(3.5 * (x - 1.2).pow(2), x)
+                                                                        .parameters();
+
+        assert_equal( params.count(), 3, CODELOC );
+        assert_nearly_equal( params[0] * params[1] * params[1], 3.5, 1e-12, CODELOC );
+        assert_nearly_equal( -params[2] / params[1], 1.2, 1e-12, CODELOC );
+    }
+
+    //harmonic in something other than a linear function of x is not harmonic
+    check( 4 * (Cos(x) - 0.3).pow(2), x_input, CompiledExpression::BYTECODE,
+           -3, 3, rand, verbose );
+
+    //the Fourier fast path, including a sine, which is rewritten
+    //as a phase-shifted cosine
+    const Expression fourier = 1.5 * (1 + Cos(x)) + 0.5 * (1 + Cos(3*x - 0.3))
+                                  + 0.25 * Sin(2*x) - 0.7 * Sin(x + 0.4);
+
+    check( fourier, x_input, CompiledExpression::FOURIER, -pi, pi, rand, verbose );
+    check( Sin(x), x_input, CompiledExpression::FOURIER, -pi, pi, rand, verbose );
+
+    {
+        const QVector<double> params = CompiledExpression(fourier, x).parameters();
+
+        assert_equal( params.count(), 1 + 4*3, CODELOC );
+        assert_nearly_equal( params[0], 2.0, 1e-12, CODELOC );
+        assert_true( hasFourierTerm(params, 1.5, 1, 0), CODELOC );
+        assert_true( hasFourierTerm(params, 0.5, 3, -0.3), CODELOC );
+        assert_true( hasFourierTerm(params, 0.25, 2, -0.5*pi), CODELOC );
+        assert_true( hasFourierTerm(params, -0.7, 1, 0.4 - 0.5*pi), CODELOC );
+    }
+
+    //a Fourier series in a non-linear function of x is not Fourier
+    check( 1 + Cos(x.pow(2)), x_input, CompiledExpression::BYTECODE,
+           -2, 2, rand, verbose );
+
+    //the general bytecode - integer powers (POWI), rational and real
+    //powers (POW), constants raised to a power, powers of expressions (POWER),
+    //min and max, division and negative factors
+    check( 2*x.pow(3) - 0.5*x.pow(-2) + x.pow(5), x_input, CompiledExpression::BYTECODE,
+           0.5, 3, rand, verbose );
+    check( x.pow(Rational(1,3)) + 2*x.pow(1.7), x_input, CompiledExpression::BYTECODE,
+           0.5, 3, rand, verbose );
+    check( Expression(2.0).pow(x) - Exp(-x), x_input, CompiledExpression::BYTECODE,
+           -2, 2, rand, verbose );
+    check( x.pow(y), xy_input, CompiledExpression::BYTECODE, 0.5, 2, rand, verbose );
+    check( (x + 1).pow(y - 0.5) * y, xy_input, CompiledExpression::BYTECODE,
+           0.5, 2, rand, verbose );
+    check( Min(x, y) + 2*Max(x, y*y), xy_input, CompiledExpression::BYTECODE,
+           -2, 2, rand, verbose );
+    check( (x + 1) / (y*y + 2) - 3 / x, xy_input, CompiledExpression::BYTECODE,
+           0.5, 2, rand, verbose );
+    check( -2.5*Cos(x*y) - x - Tan(y) * Ln(x) + 4*Abs(y - 1),
+           xy_input, CompiledExpression::BYTECODE, 0.5, 1.5, rand, verbose );
+    check( Cosh(x) * Sinh(y) + Tanh(x*y) + ArcTan(x - y) + Sec(x) + Csc(y) + Cot(y),
+           xy_input, CompiledExpression::BYTECODE, 0.5, 1.5, rand, verbose );
+
+    //parts that can't be compiled are evaluated via Expression::evaluate
+    check( ArcCos(x/4) + 2*Sech(y) - x*ArcSin(y/3), xy_input,
+           CompiledExpression::BYTECODE, -2, 2, rand, verbose );
+    check( 3*ArcCos(x/4), x_input, CompiledExpression::BYTECODE, -2, 2, rand, verbose );
+
+    //symbols that are not inputs have a value of zero, including
+    //those inside parts that are evaluated via Expression::evaluate
+    check( x + 2*z + Cos(z*x), x_input, CompiledExpression::BYTECODE,
+           -2, 2, rand, verbose );
+    check( 3*(x - z).pow(2), x_input, CompiledExpression::BYTECODE,
+           -2, 2, rand, verbose );
+    check( x*y + ArcCos(z + 0.5*x), x_input, CompiledExpression::BYTECODE,
+           -1, 1, rand, verbose );
+
+    {
+        const CompiledExpression compiled( x + 2*z + 1, x );
+
+        Values values;
+        values.set(x, 2.0);
+        values.set(z, 5.0);
+
+        //values for symbols that are not inputs are ignored
+        assert_nearly_equal( compiled.evaluate(values), 3.0, 1e-12, CODELOC );
+        assert_nearly_equal( compiled.evaluate(2.0), 3.0, 1e-12, CODELOC );
+    }
+
+    //a two-input improper, (theta, phi), evaluated in both input orders
+    const Symbol theta("theta");
+    const Symbol phi("phi");
+
+    const Expression improper = 2.1 * (1 - Cos(2*phi)) + 5 * (theta - 0.2).pow(2)
+                                    + 0.3 * Sin(phi) * theta;
+
+    const QList<Symbol> theta_phi = QList<Symbol>() << theta << phi;
+    const QList<Symbol> phi_theta = QList<Symbol>() << phi << theta;
+
+    check( improper, theta_phi, CompiledExpression::BYTECODE, -pi, pi, rand, verbose );
+    check( improper, phi_theta, CompiledExpression::BYTECODE, -pi, pi, rand, verbose );
+
+    {
+        const double vals[2] = { 0.4, 1.3 };
+        const double swapped[2] = { 1.3, 0.4 };
+
+        assert_nearly_equal( CompiledExpression(improper, theta_phi).evaluate(vals),
+                             CompiledExpression(improper, phi_theta).evaluate(swapped),
+                             1e-12, CODELOC );
+    }
+
+    //passing the wrong number of inputs is an error
+    assert_throws( [&](){ CompiledExpression(improper, theta_phi).evaluate(
+                                    QVector< QVector<double> >(1, QVector<double>(3))); },
+                   SireError::incompatible_error(), CODELOC );
+
+    //streaming recompiles the expression, giving the same kernel and results
+    const QList<Expression> streamed = QList<Expression>()
+                                            << 3.5 * (x - 1.2).pow(2)
+                                            << fourier
+                                            << improper
+                                            << ArcCos(x/4) + 2*Sech(y);
+
+    const QList< QList<Symbol> > streamed_inputs = QList< QList<Symbol> >()
+                                            << x_input << x_input << theta_phi << xy_input;
+
+    for (int i=0; i<streamed.count(); ++i)
+    {
+        const CompiledExpression compiled(streamed[i], streamed_inputs[i]);
+
+        QByteArray data;
+        QDataStream ds(&data, QIODevice::WriteOnly);
+        ds << compiled;
+
+        CompiledExpression loaded;
+        QDataStream ds2(data);
+        ds2 >> loaded;
+
+        assert_true( loaded == compiled, CODELOC );
+        assert_equal( int(loaded.kernel()), int(compiled.kernel()), CODELOC );
+        assert_equal( loaded.nInstructions(), compiled.nInstructions(), CODELOC );
+        assert_equal( loaded.parameters().count(), compiled.parameters().count(), CODELOC );
+
+        QVector<double> vals(compiled.nInputs());
+
+        for (int j=0; j<vals.count(); ++j)
+        {
+            vals[j] = rand.rand(-1, 1);
+        }
+
+        //the order of the terms may change when the expression is loaded
+        assert_nearly_equal( loaded.evaluate(vals.constData()),
+                             compiled.evaluate(vals.constData()), 1e-12, CODELOC );
+    }
+}
+
+SIRE_UNITTEST( test_compiledexpression )
@@ -0,0 +1,564 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "energyprofiler.h"
+#include "ff.h"
+
+#include "SireBase/countflops.h"
+
+#include "SireStream/datastream.h"
+
+#include <QMutex>
+#include <QThreadStorage>
+#include <QDebug>
+
+#include <algorithm>
+
+using namespace SireFF;
+using namespace SireFF::detail;
+using namespace SireStream;
+
+///////
+/////// Implementation of EnergyProfile
+///////
+
+static const RegisterMetaType<EnergyProfile> r_profile(NO_ROOT);
+
+namespace SireFF
+{
+namespace detail
+{
+    QDataStream& operator<<(QDataStream &ds, const FFProfileData &data)
+    {
+        ds << data.type << data.nevals << data.nfull << data.ndelta
+           << data.npairs << data.nflops << data.nsecs;
+
+        return ds;
+    }
+
+    QDataStream& operator>>(QDataStream &ds, FFProfileData &data)
+    {
+        ds >> data.type >> data.nevals >> data.nfull >> data.ndelta
+           >> data.npairs >> data.nflops >> data.nsecs;
+
+        return ds;
+    }
+
+} // end of namespace detail
+} // end of namespace SireFF
+
+QDataStream SIREFF_EXPORT &operator<<(QDataStream &ds, const EnergyProfile &profile)
+{
+    writeHeader(ds, r_profile, 1);
+    
+    ds << profile.data;
+    
+    return ds;
+}
+
+QDataStream SIREFF_EXPORT &operator>>(QDataStream &ds, EnergyProfile &profile)
+{
+    VersionID v = readHeader(ds, r_profile);
+    
+    if (v == 1)
+    {
+        ds >> profile.data;
+    }
+    else
+        throw version_error(v, "1", r_profile, CODELOC);
+    
+    return ds;
+}
+
+/** Constructor */
+EnergyProfile::EnergyProfile()
+{}
+
+/** Copy constructor */
+EnergyProfile::EnergyProfile(const EnergyProfile &other) : data(other.data)
+{}
+
+/** Destructor */
+EnergyProfile::~EnergyProfile()
+{}
+
+/** Copy assignment operator */
+EnergyProfile& EnergyProfile::operator=(const EnergyProfile &other)
+{
+    data = other.data;
+    return *this;
+}
+
+/** Comparison operator */
+bool EnergyProfile::operator==(const EnergyProfile &other) const
+{
+    if (data.count() != other.data.count())
+        return false;
+    
+    for (QHash<QString,FFProfileData>::const_iterator it = data.constBegin();
+         it != data.constEnd();
+         ++it)
+    {
+        if (not other.data.contains(it.key()))
+            return false;
+        
+        const FFProfileData &o = *(other.data.constFind(it.key()));
+        
+        if (it->type != o.type or it->nevals != o.nevals or it->nfull != o.nfull or
+            it->ndelta != o.ndelta or it->npairs != o.npairs or
+            it->nflops != o.nflops or it->nsecs != o.nsecs)
+        {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+/** Comparison operator */
+bool EnergyProfile::operator!=(const EnergyProfile &other) const
+{
+    return not operator==(other);
+}
+
+const char* EnergyProfile::typeName()
+{
+    return QMetaType::typeName( qMetaTypeId<EnergyProfile>() );
+}
+
+const char* EnergyProfile::what() const
+{
+    return EnergyProfile::typeName();
+}
+
+/** Return whether or not this profile is empty (nothing has been recorded) */
+bool EnergyProfile::isEmpty() const
+{
+    return data.isEmpty();
+}
+
+/** Return the names of all of the forcefields in this profile,
+    sorted so that the most expensive forcefield is first */
+QStringList EnergyProfile::forceFields() const
+{
+    QList< QPair<qint64,QString> > times;
+    
+    for (QHash<QString,FFProfileData>::const_iterator it = data.constBegin();
+         it != data.constEnd();
+         ++it)
+    {
+        times.append( QPair<qint64,QString>(-(it->nsecs), it.key()) );
+    }
+    
+    std::sort(times.begin(), times.end());
+    
+    QStringList names;
+    
+    for (int i=0; i<times.count(); ++i)
+    {
+        names.append( times.at(i).second );
+    }
+    
+    return names;
+}
+
+/** Return the profiling data for the forcefield called 'ffname'. This returns
+    empty data if this forcefield has not been profiled */
+const FFProfileData& EnergyProfile::getData(const QString &ffname) const
+{
+    QHash<QString,FFProfileData>::const_iterator it = data.constFind(ffname);
+    
+    if (it == data.constEnd())
+    {
+        static const FFProfileData empty_data;
+        return empty_data;
+    }
+    else
+        return *it;
+}
+
+/** Return the type of the forcefield called 'ffname' */
+QString EnergyProfile::forceFieldType(const QString &ffname) const
+{
+    return getData(ffname).type;
+}
+
+/** Return the total number of energy recalculations */
+qint64 EnergyProfile::nEvaluations() const
+{
+    qint64 n = 0;
+    
+    foreach (const FFProfileData &d, data)
+    {
+        n += d.nevals;
+    }
+    
+    return n;
+}
+
+/** Return the number of energy recalculations of the forcefield called 'ffname' */
+qint64 EnergyProfile::nEvaluations(const QString &ffname) const
+{
+    return getData(ffname).nevals;
+}
+
+/** Return the total number of recalculations that were performed from scratch */
+qint64 EnergyProfile::nFullCalculations() const
+{
+    qint64 n = 0;
+    
+    foreach (const FFProfileData &d, data)
+    {
+        n += d.nfull;
+    }
+    
+    return n;
+}
+
+/** Return the number of recalculations of the forcefield called 'ffname'
+    that were performed from scratch */
+qint64 EnergyProfile::nFullCalculations(const QString &ffname) const
+{
+    return getData(ffname).nfull;
+}
+
+/** Return the total number of recalculations that used only the
+    change in energy */
+qint64 EnergyProfile::nDeltaCalculations() const
+{
+    qint64 n = 0;
+    
+    foreach (const FFProfileData &d, data)
+    {
+        n += d.ndelta;
+    }
+    
+    return n;
+}
+
+/** Return the number of recalculations of the forcefield called 'ffname'
+    that used only the change in energy */
+qint64 EnergyProfile::nDeltaCalculations(const QString &ffname) const
+{
+    return getData(ffname).ndelta;
+}
+
+/** Return the total number of box (or cluster) pairs that were evaluated */
+qint64 EnergyProfile::nPairs() const
+{
+    qint64 n = 0;
+    
+    foreach (const FFProfileData &d, data)
+    {
+        n += d.npairs;
+    }
+    
+    return n;
+}
+
+/** Return the number of box (or cluster) pairs that were evaluated
+    by the forcefield called 'ffname' */
+qint64 EnergyProfile::nPairs(const QString &ffname) const
+{
+    return getData(ffname).npairs;
+}
+
+/** Return the total number of flops counted. This is only non-zero
+    if Sire was compiled with SIRE_TIME_ROUTINES */
+qint64 EnergyProfile::nFlops() const
+{
+    qint64 n = 0;
+    
+    foreach (const FFProfileData &d, data)
+    {
+        n += d.nflops;
+    }
+    
+    return n;
+}
+
+/** Return the number of flops counted during recalculations of the
+    forcefield called 'ffname' */
+qint64 EnergyProfile::nFlops(const QString &ffname) const
+{
+    return getData(ffname).nflops;
+}
+
+/** Return the total time (in milliseconds) spent recalculating energies */
+double EnergyProfile::totalTime() const
+{
+    qint64 n = 0;
+    
+    foreach (const FFProfileData &d, data)
+    {
+        n += d.nsecs;
+    }
+    
+    return 1e-6 * n;
+}
+
+/** Return the total time (in milliseconds) spent recalculating the
+    energy of the forcefield called 'ffname' */
+double EnergyProfile::totalTime(const QString &ffname) const
+{
+    return 1e-6 * getData(ffname).nsecs;
+}
+
+/** Return the average time (in milliseconds) per recalculation of
+    the energy of the forcefield called 'ffname' */
+double EnergyProfile::averageTime(const QString &ffname) const
+{
+    const FFProfileData &d = getData(ffname);
+    
+    if (d.nevals == 0)
+        return 0;
+    else
+        return (1e-6 * d.nsecs) / d.nevals;
+}
+
+/** Return a table summarising this profile, with the most expensive
+    forcefield listed first */
+QString EnergyProfile::toString() const
+{
+    if (data.isEmpty())
+        return QObject::tr("EnergyProfile::empty");
+    
+    QStringList lines;
+    
+    lines.append( QObject::tr("EnergyProfile( nEvaluations() == %1, totalTime() == %2 ms )")
+                    .arg(this->nEvaluations()).arg(this->totalTime()) );
+    
+    lines.append( QString("%1 %2 %3 %4 %5 %6 %7 %8")
+                    .arg(QObject::tr("forcefield"), -20)
+                    .arg(QObject::tr("type"), -24)
+                    .arg(QObject::tr("nevals"), 10)
+                    .arg(QObject::tr("nfull"), 10)
+                    .arg(QObject::tr("ndelta"), 10)
+                    .arg(QObject::tr("time / ms"), 12)
+                    .arg(QObject::tr("npairs"), 12)
+                    .arg(QObject::tr("nflops"), 12) );
+    
+    foreach (const QString &ffname, this->forceFields())
+    {
+        const FFProfileData &d = getData(ffname);
+        
+        lines.append( QString("%1 %2 %3 %4 %5 %6 %7 %8")
+                        .arg(ffname, -20)
+                        .arg(d.type, -24)
+                        .arg(d.nevals, 10)
+                        .arg(d.nfull, 10)
+                        .arg(d.ndelta, 10)
+                        .arg(1e-6 * d.nsecs, 12, 'f', 3)
+                        .arg(d.npairs, 12)
+                        .arg(d.nflops, 12) );
+    }
+    
+    return lines.join("\n");
+}
+
+///////
+/////// Implementation of EnergyProfiler::Timer
+///////
+
+typedef QList<EnergyProfiler::Timer*> TimerStack;
+
+Q_GLOBAL_STATIC( QThreadStorage<TimerStack*>, activeTimers );
+
+/** Return the timer for the recalculation that is currently running
+    on this thread (or 0 if there isn't one) */
+static EnergyProfiler::Timer* currentTimer()
+{
+    QThreadStorage<TimerStack*> *store = activeTimers();
+    
+    if (store->hasLocalData())
+    {
+        TimerStack *stack = store->localData();
+        
+        if (not stack->isEmpty())
+            return stack->last();
+    }
+    
+    return 0;
+}
+
+/** Start timing the recalculation of the energy of 'ff' */
+void EnergyProfiler::Timer::start(const FF &ff)
+{
+    QThreadStorage<TimerStack*> *store = activeTimers();
+    
+    if (not store->hasLocalData())
+        store->setLocalData( new TimerStack() );
+    
+    store->localData()->append(this);
+    
+    ffname = ff.name().value();
+    counters.type = ff.what();
+    counters.nevals = 1;
+
+    #ifdef SIRE_TIME_ROUTINES
+    counters.nflops = -qint64( SireBase::CountFlops::mark().nFlops() );
+    #endif
+    
+    active = true;
+    timer.start();
+}
+
+/** Stop timing and save the data collected during the recalculation */
+void EnergyProfiler::Timer::stop()
+{
+    counters.nsecs = timer.nsecsElapsed();
+    
+    #ifdef SIRE_TIME_ROUTINES
+    counters.nflops += SireBase::CountFlops::mark().nFlops();
+    #endif
+    
+    active = false;
+    
+    QThreadStorage<TimerStack*> *store = activeTimers();
+    
+    if (store->hasLocalData())
+        store->localData()->removeAll(this);
+    
+    EnergyProfiler::save(*this);
+}
+
+///////
+/////// Implementation of EnergyProfiler
+///////
+
+bool EnergyProfiler::profiling_enabled = false;
+
+Q_GLOBAL_STATIC( QMutex, profileMutex );
+Q_GLOBAL_STATIC( EnergyProfile, globalProfile );
+
+static int log_interval = 0;
+static qint64 nevals_since_log = 0;
+
+/** Switch on energy profiling */
+void EnergyProfiler::enable()
+{
+    profiling_enabled = true;
+}
+
+/** Switch off energy profiling. The data collected so far is retained
+    until reset() is called */
+void EnergyProfiler::disable()
+{
+    profiling_enabled = false;
+}
+
+/** Set the number of recalculations between writing the profile to
+    the log (via qDebug). Set this to zero (the default) to switch
+    off logging */
+void EnergyProfiler::setLogInterval(int n)
+{
+    QMutexLocker lkr( profileMutex() );
+    log_interval = qMax(0, n);
+    nevals_since_log = 0;
+}
+
+/** Return the number of recalculations between writing the profile
+    to the log. This is zero if logging is switched off */
+int EnergyProfiler::logInterval()
+{
+    QMutexLocker lkr( profileMutex() );
+    return log_interval;
+}
+
+/** Clear all of the profiling data collected so far */
+void EnergyProfiler::reset()
+{
+    QMutexLocker lkr( profileMutex() );
+    globalProfile()->data.clear();
+    nevals_since_log = 0;
+}
+
+/** Return a snapshot of the profiling data collected so far */
+EnergyProfile EnergyProfiler::report()
+{
+    QMutexLocker lkr( profileMutex() );
+    return *(globalProfile());
+}
+
+void EnergyProfiler::pvt_recordFullCalculation()
+{
+    Timer *timer = currentTimer();
+    
+    if (timer)
+        timer->counters.nfull += 1;
+}
+
+void EnergyProfiler::pvt_recordDeltaCalculation()
+{
+    Timer *timer = currentTimer();
+    
+    if (timer)
+        timer->counters.ndelta += 1;
+}
+
+void EnergyProfiler::pvt_addPairs(qint64 npairs)
+{
+    Timer *timer = currentTimer();
+    
+    if (timer)
+        timer->counters.npairs += npairs;
+}
+
+/** Save the data collected by the passed timer into the global profile */
+void EnergyProfiler::save(const Timer &timer)
+{
+    QString log;
+
+    {
+        QMutexLocker lkr( profileMutex() );
+        
+        FFProfileData &d = globalProfile()->data[timer.ffname];
+        
+        d.type = timer.counters.type;
+        d.nevals += timer.counters.nevals;
+        d.nfull += timer.counters.nfull;
+        d.ndelta += timer.counters.ndelta;
+        d.npairs += timer.counters.npairs;
+        d.nflops += timer.counters.nflops;
+        d.nsecs += timer.counters.nsecs;
+        
+        if (log_interval > 0)
+        {
+            nevals_since_log += 1;
+            
+            if (nevals_since_log >= log_interval)
+            {
+                nevals_since_log = 0;
+                log = globalProfile()->toString();
+            }
+        }
+    }
+    
+    if (not log.isEmpty())
+        qDebug() << qPrintable(log);
+}
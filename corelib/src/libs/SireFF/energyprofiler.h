@@ -0,0 +1,300 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#ifndef SIREFF_ENERGYPROFILER_H
+#define SIREFF_ENERGYPROFILER_H
+
+#include <QHash>
+#include <QStringList>
+#include <QElapsedTimer>
+
+#include "sireglobal.h"
+
+SIRE_BEGIN_HEADER
+
+namespace SireFF
+{
+class EnergyProfile;
+class EnergyProfiler;
+}
+
+QDataStream& operator<<(QDataStream&, const SireFF::EnergyProfile&);
+QDataStream& operator>>(QDataStream&, SireFF::EnergyProfile&);
+
+namespace SireFF
+{
+
+class FF;
+
+namespace detail
+{
+
+/** This holds the profiling counters collected for a single forcefield */
+class FFProfileData
+{
+public:
+    FFProfileData() : nevals(0), nfull(0), ndelta(0),
+                      npairs(0), nflops(0), nsecs(0)
+    {}
+
+    ~FFProfileData()
+    {}
+
+    /** The type of the forcefield */
+    QString type;
+
+    /** The number of times the energy was recalculated */
+    qint64 nevals;
+
+    /** The number of recalculations performed from scratch */
+    qint64 nfull;
+
+    /** The number of recalculations that used only the change in energy */
+    qint64 ndelta;
+
+    /** The number of box (or cluster) pairs that were evaluated */
+    qint64 npairs;
+
+    /** The number of floating point operations that were counted
+        (only available if Sire was compiled with SIRE_TIME_ROUTINES) */
+    qint64 nflops;
+
+    /** The total wall time spent recalculating the energy, in nanoseconds */
+    qint64 nsecs;
+};
+
+} // end of namespace detail
+
+/** This is a snapshot of the energy-evaluation profile collected
+    by the EnergyProfiler. It records, for each forcefield (identified
+    by name), the number of energy recalculations, how many of these
+    were performed from scratch or using only the change in energy,
+    the wall time spent recalculating, the number of box pairs
+    evaluated and the number of flops counted.
+
+    @author Christopher Woods
+*/
+class SIREFF_EXPORT EnergyProfile
+{
+
+friend class EnergyProfiler;
+
+friend QDataStream& ::operator<<(QDataStream&, const EnergyProfile&);
+friend QDataStream& ::operator>>(QDataStream&, EnergyProfile&);
+
+public:
+    EnergyProfile();
+
+    EnergyProfile(const EnergyProfile &other);
+
+    ~EnergyProfile();
+
+    EnergyProfile& operator=(const EnergyProfile &other);
+
+    bool operator==(const EnergyProfile &other) const;
+    bool operator!=(const EnergyProfile &other) const;
+
+    static const char* typeName();
+
+    const char* what() const;
+
+    QString toString() const;
+
+    bool isEmpty() const;
+
+    QStringList forceFields() const;
+
+    QString forceFieldType(const QString &ffname) const;
+
+    qint64 nEvaluations() const;
+    qint64 nEvaluations(const QString &ffname) const;
+
+    qint64 nFullCalculations() const;
+    qint64 nFullCalculations(const QString &ffname) const;
+
+    qint64 nDeltaCalculations() const;
+    qint64 nDeltaCalculations(const QString &ffname) const;
+
+    qint64 nPairs() const;
+    qint64 nPairs(const QString &ffname) const;
+
+    qint64 nFlops() const;
+    qint64 nFlops(const QString &ffname) const;
+
+    double totalTime() const;
+    double totalTime(const QString &ffname) const;
+
+    double averageTime(const QString &ffname) const;
+
+private:
+    const detail::FFProfileData& getData(const QString &ffname) const;
+
+    /** The profiling data for each forcefield, indexed by name */
+    QHash<QString,detail::FFProfileData> data;
+};
+
+/** This is the opt-in profiler for forcefield energy evaluations.
+    Profiling is switched off by default, in which case it costs only
+    a single flag check per energy recalculation. Once enabled, every
+    call to FF::recalculateEnergy (via FF::energy or FF::energies, and
+    so also via ForceFields and System) is timed and attributed to the
+    forcefield by name.
+
+    Forcefields can also report whether each recalculation was done
+    from scratch or using only the change in energy (recordFullCalculation
+    and recordDeltaCalculation), and the CLJ calculators report the number
+    of box pairs evaluated (addPairs). These are attributed to the
+    forcefield whose energy is currently being recalculated on the
+    calling thread. If Sire was compiled with SIRE_TIME_ROUTINES then
+    the flops counted by SireBase::CountFlops are also recorded.
+
+    The collected data is returned as an EnergyProfile via report(),
+    and can be written to the log (qDebug) every 'n' recalculations
+    using setLogInterval.
+
+    @author Christopher Woods
+*/
+class SIREFF_EXPORT EnergyProfiler
+{
+public:
+    /** This is a scoped timer that times a single energy recalculation
+        of a forcefield. This does nothing if profiling is not enabled */
+    class SIREFF_EXPORT Timer
+    {
+
+    friend class EnergyProfiler;
+
+    public:
+        Timer(const FF &ff);
+        ~Timer();
+
+    private:
+        void start(const FF &ff);
+        void stop();
+
+        /** The name of the forcefield being timed */
+        QString ffname;
+
+        /** The profiling data collected during this recalculation */
+        detail::FFProfileData counters;
+
+        /** The timer used to time the recalculation */
+        QElapsedTimer timer;
+
+        /** Whether or not this timer is active */
+        bool active;
+    };
+
+    static void enable();
+    static void disable();
+
+    static bool isEnabled();
+
+    static void setLogInterval(int n);
+    static int logInterval();
+
+    static void reset();
+
+    static EnergyProfile report();
+
+    static void recordFullCalculation();
+    static void recordDeltaCalculation();
+
+    static void addPairs(qint64 npairs);
+
+private:
+    static void pvt_recordFullCalculation();
+    static void pvt_recordDeltaCalculation();
+    static void pvt_addPairs(qint64 npairs);
+
+    static void save(const Timer &timer);
+
+    /** Whether or not profiling is enabled */
+    static bool profiling_enabled;
+};
+
+#ifndef SIRE_SKIP_INLINE_FUNCTIONS
+
+/** Return whether or not energy profiling is enabled */
+inline bool EnergyProfiler::isEnabled()
+{
+    return profiling_enabled;
+}
+
+/** Record that the forcefield whose energy is being recalculated
+    on this thread has recalculated its energy from scratch */
+inline void EnergyProfiler::recordFullCalculation()
+{
+    if (profiling_enabled)
+        EnergyProfiler::pvt_recordFullCalculation();
+}
+
+/** Record that the forcefield whose energy is being recalculated
+    on this thread has calculated its energy using only the change
+    in energy */
+inline void EnergyProfiler::recordDeltaCalculation()
+{
+    if (profiling_enabled)
+        EnergyProfiler::pvt_recordDeltaCalculation();
+}
+
+/** Record that 'npairs' box (or cluster) pairs were evaluated by
+    the forcefield whose energy is being recalculated on this thread */
+inline void EnergyProfiler::addPairs(qint64 npairs)
+{
+    if (profiling_enabled)
+        EnergyProfiler::pvt_addPairs(npairs);
+}
+
+/** Construct the timer for a recalculation of the energy of 'ff'.
+    This only starts timing if profiling is enabled */
+inline EnergyProfiler::Timer::Timer(const FF &ff) : active(false)
+{
+    if (EnergyProfiler::profiling_enabled)
+        this->start(ff);
+}
+
+/** Destructor - this records the time taken for the recalculation */
+inline EnergyProfiler::Timer::~Timer()
+{
+    if (active)
+        this->stop();
+}
+
+#endif // SIRE_SKIP_INLINE_FUNCTIONS
+
+}
+
+Q_DECLARE_METATYPE( SireFF::EnergyProfile )
+
+SIRE_EXPOSE_CLASS( SireFF::EnergyProfile )
+SIRE_EXPOSE_CLASS( SireFF::EnergyProfiler )
+
+SIRE_END_HEADER
+
+#endif
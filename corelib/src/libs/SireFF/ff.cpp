@@ -29,6 +29,7 @@
 #include "ff.h"
 #include "ffcomponent.h"
 #include "forcefield.h"
+#include "energyprofiler.h"
 
 #include "tostring.h"
 
@@ -260,6 +261,7 @@ SireUnits::Dimension::MolarEnergy FF::energy(const Symbol &component)
 {
     if (this->isDirty())
     {
+        EnergyProfiler::Timer timer(*this);
         this->recalculateEnergy();
     }
                   
@@ -283,7 +285,10 @@ SireUnits::Dimension::MolarEnergy FF::energy()
 Values FF::energies(const QSet<Symbol> &components)
 {
     if (this->isDirty())
+    {
+        EnergyProfiler::Timer timer(*this);
         this->recalculateEnergy();
+    }
         
     Values vals;
     
@@ -306,7 +311,10 @@ Values FF::energies(const QSet<Symbol> &components)
 Values FF::energies()
 {
     if (this->isDirty())
+    {
+        EnergyProfiler::Timer timer(*this);
         this->recalculateEnergy();
+    }
         
     return nrg_components;
 }
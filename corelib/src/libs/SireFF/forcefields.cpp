@@ -84,6 +84,32 @@ namespace SireFF
 namespace detail
 {
 
+/** This is a single term of a compiled energy expression, namely
+    the energy of the component 'symbol' of the forcefield at index
+    'ffidx', multiplied by the constant 'scale' */
+class FFTerm
+{
+public:
+    FFTerm() : ffidx(-1), scale(0)
+    {}
+    
+    FFTerm(int idx, const Symbol &sym, double scl)
+          : ffidx(idx), symbol(sym), scale(scl)
+    {}
+    
+    ~FFTerm()
+    {}
+    
+    /** The index of the forcefield */
+    int ffidx;
+    
+    /** The symbol of the forcefield energy component */
+    Symbol symbol;
+    
+    /** The constant that scales the energy of this component */
+    double scale;
+};
+
 /** This is a private hierarchy of classes that is used just by ForceFields
     to relate a symbol to an energy component, forcefield expression or
     constant */
@@ -113,6 +139,9 @@ public:
     
     virtual double value(const QHash<Symbol,FFSymbolPtr> &ffsymbols) const=0;
     
+    virtual QVector<FFTerm> compile(const QVector<FFPtr> &forcefields,
+                                    const QHash<Symbol,FFSymbolPtr> &ffsymbols) const;
+    
     virtual MolarEnergy energy(QVector<FFPtr> &forcefields,
                           const QHash<Symbol,FFSymbolPtr> &ffsymbols,
                           double scale_energy=1) const=0;
@@ -340,6 +369,9 @@ public:
     
     double value(const QHash<Symbol,FFSymbolPtr> &ffsymbols) const;
     
+    QVector<FFTerm> compile(const QVector<FFPtr> &forcefields,
+                            const QHash<Symbol,FFSymbolPtr> &ffsymbols) const;
+    
     MolarEnergy energy(QVector<FFPtr> &forcefields,
                        const QHash<Symbol,FFSymbolPtr> &ffsymbols,
                        double scale_energy=1) const;
@@ -414,6 +446,9 @@ public:
     
     double value(const QHash<Symbol,FFSymbolPtr> &ffsymbols) const;
     
+    QVector<FFTerm> compile(const QVector<FFPtr> &forcefields,
+                            const QHash<Symbol,FFSymbolPtr> &ffsymbols) const;
+    
     MolarEnergy energy(QVector<FFPtr> &forcefields,
                        const QHash<Symbol,FFSymbolPtr> &ffsymbols,
                        double scale_energy=1) const;
@@ -524,6 +559,9 @@ public:
 
     double value(const QHash<Symbol,FFSymbolPtr> &ffsymbols) const;
     
+    QVector<FFTerm> compile(const QVector<FFPtr> &forcefields,
+                            const QHash<Symbol,FFSymbolPtr> &ffsymbols) const;
+    
     MolarEnergy energy(QVector<FFPtr> &forcefields,
                        const QHash<Symbol,FFSymbolPtr> &ffsymbols,
                        double scale_energy=1) const;
@@ -560,6 +598,51 @@ public:
                    double scale_potential=1) const;
 };
 
+/** This class holds the compiled form of the energy components of
+    a ForceFields, i.e. each component as a list of forcefield energies
+    multiplied by constant scaling factors, so that the components can 
+    be evaluated without going through SireCAS. It also holds the 
+    energies of the components from the last time they were evaluated,
+    together with the versions of the forcefields that were used. This
+    allows ForceFields::energies to recalculate (in parallel) only those
+    forcefields that are dirty, and to re-evaluate only those components
+    that depend on forcefields that have changed */
+class FFEnergyCache
+{
+public:
+    FFEnergyCache();
+    FFEnergyCache(const QVector<FFPtr> &forcefields,
+                  const QHash<Symbol,FFSymbolPtr> &ffsymbols);
+    
+    FFEnergyCache(const FFEnergyCache &other);
+    
+    ~FFEnergyCache();
+    
+    bool contains(const Symbol &symbol) const;
+    
+    int nForceFields() const;
+    
+    QList<Symbol> symbols() const;
+    
+    Values energies(QVector<FFPtr> &forcefields, const QList<Symbol> &symbols);
+
+private:
+    /** The compiled terms of each energy component */
+    QHash< Symbol,QVector<FFTerm> > terms;
+    
+    /** The symbols of the energy components that depend on
+        each forcefield, indexed by FFIdx */
+    QVector< QList<Symbol> > dependents;
+    
+    /** The energies of the components that are up to date */
+    QHash<Symbol,double> nrgs;
+    
+    /** The UID and version of each forcefield when the
+        energies were last evaluated */
+    QVector<QUuid> ff_uids;
+    QVector<quint64> ff_versions;
+};
+
 } // end of namespace detail
 
 } // end of namespace SireFF
@@ -650,6 +733,16 @@ const Symbol& FFSymbol::symbol() const
     return s;
 }
 
+QVector<FFTerm> FFSymbol::compile(const QVector<FFPtr>&,
+                                  const QHash<Symbol,FFSymbolPtr>&) const
+{
+    throw SireError::program_bug( QObject::tr(
+        "The constant component %1 cannot be compiled into forcefield energies...")
+            .arg(this->symbol().toString()), CODELOC );
+            
+    return QVector<FFTerm>();
+}
+
 void FFSymbol::load(QDataStream &ds)
 {
     ds >> s;
@@ -988,6 +1081,12 @@ double FFSymbolFF::value(const QHash<Symbol,FFSymbolPtr>&) const
     return 0;
 }
 
+QVector<FFTerm> FFSymbolFF::compile(const QVector<FFPtr>&,
+                                    const QHash<Symbol,FFSymbolPtr>&) const
+{
+    return QVector<FFTerm>( 1, FFTerm(ffidx, this->symbol(), 1) );
+}
+
 MolarEnergy FFSymbolFF::energy(QVector<FFPtr> &forcefields,
                                const QHash<Symbol,FFSymbolPtr> &ffsymbols,
                                double scale_energy) const
@@ -1354,6 +1453,49 @@ double FFSymbolExpression::value(const QHash<Symbol,FFSymbolPtr>&) const
     return 0;
 }
 
+/** Compile this expression into a list of forcefield energy components
+    multiplied by their (constant) scaling factors */
+QVector<FFTerm> FFSymbolExpression::compile(const QVector<FFPtr>&,
+                                            const QHash<Symbol,FFSymbolPtr> &ffsymbols) const
+{
+    int ncomponents = components.count();
+    const Component *components_array = components.constData();
+    
+    //evaluate all of the constants used in the scaling factors
+    Values values;
+    
+    for (int i=0; i<ncomponents; ++i)
+    {
+        const Component &component = components_array[i];
+        
+        int ndeps = component.nDependents();
+        const Symbol *deps_array = component.dependents().constData();
+        
+        for (int j=0; j<ndeps; ++j)
+        {
+            const Symbol &symbol = deps_array[j];
+            
+            if (not values.contains(symbol))
+                values.set( symbol, ffsymbols[symbol]->value(ffsymbols) );
+        }
+    }
+    
+    QVector<FFTerm> terms;
+    terms.reserve(ncomponents);
+    
+    for (int i=0; i<ncomponents; ++i)
+    {
+        const Component &component = components_array[i];
+        
+        const double scl = component.scalingFactor(values);
+        
+        if (scl != 0)
+            terms.append( FFTerm(component.ffIdx(), component.symbol(), scl) );
+    }
+    
+    return terms;
+}
+
 MolarEnergy FFSymbolExpression::energy(QVector<FFPtr> &forcefields,
                                        const QHash<Symbol,FFSymbolPtr> &ffsymbols,
                                        double scale_energy) const
@@ -1695,6 +1837,20 @@ double FFTotalExpression::value(const QHash<Symbol,FFSymbolPtr>&) const
     return 0;
 }
 
+QVector<FFTerm> FFTotalExpression::compile(const QVector<FFPtr> &forcefields,
+                                           const QHash<Symbol,FFSymbolPtr>&) const
+{
+    QVector<FFTerm> terms;
+    terms.reserve(forcefields.count());
+    
+    for (int i=0; i<forcefields.count(); ++i)
+    {
+        terms.append( FFTerm(i, forcefields.at(i)->components().total(), 1) );
+    }
+    
+    return terms;
+}
+
 MolarEnergy FFTotalExpression::energy(QVector<FFPtr> &forcefields,
                                       const QHash<Symbol,FFSymbolPtr> &ffsymbols,
                                       double scale_energy) const
@@ -1830,6 +1986,159 @@ void FFTotalExpression::potential(PotentialTable &pottable,
     }
 }
 
+///////////
+/////////// Implementation of FFEnergyCache
+///////////
+
+FFEnergyCache::FFEnergyCache()
+{}
+
+/** Compile all of the energy components in 'ffsymbols' */
+FFEnergyCache::FFEnergyCache(const QVector<FFPtr> &forcefields,
+                             const QHash<Symbol,FFSymbolPtr> &ffsymbols)
+              : dependents(forcefields.count()),
+                ff_uids(forcefields.count()), ff_versions(forcefields.count(), 0)
+{
+    for (QHash<Symbol,FFSymbolPtr>::const_iterator it = ffsymbols.constBegin();
+         it != ffsymbols.constEnd();
+         ++it)
+    {
+        if (it.value()->isEnergy())
+        {
+            QVector<FFTerm> symterms = it.value()->compile(forcefields, ffsymbols);
+            
+            QSet<int> ffidxs;
+            
+            foreach (const FFTerm &term, symterms)
+            {
+                ffidxs.insert(term.ffidx);
+            }
+            
+            foreach (int ffidx, ffidxs)
+            {
+                dependents[ffidx].append(it.key());
+            }
+            
+            terms.insert(it.key(), symterms);
+        }
+    }
+}
+
+FFEnergyCache::FFEnergyCache(const FFEnergyCache &other)
+              : terms(other.terms), dependents(other.dependents), nrgs(other.nrgs),
+                ff_uids(other.ff_uids), ff_versions(other.ff_versions)
+{}
+
+FFEnergyCache::~FFEnergyCache()
+{}
+
+/** Return whether or not this contains the energy component 'symbol' */
+bool FFEnergyCache::contains(const Symbol &symbol) const
+{
+    return terms.contains(symbol);
+}
+
+/** Return the number of forcefields used to compile this cache */
+int FFEnergyCache::nForceFields() const
+{
+    return dependents.count();
+}
+
+/** Return the symbols of all of the energy components */
+QList<Symbol> FFEnergyCache::symbols() const
+{
+    return terms.keys();
+}
+
+/** Return the energies of the components in 'symbols', which must
+    all be in this cache. Only the dirty forcefields needed by these
+    components are recalculated (in parallel), and only the components 
+    that depend on forcefields that have changed are re-evaluated */
+Values FFEnergyCache::energies(QVector<FFPtr> &forcefields, const QList<Symbol> &symbols)
+{
+    const int nffields = forcefields.count();
+    
+    BOOST_ASSERT( nffields == dependents.count() );
+    
+    //find the forcefields that are needed to evaluate these components
+    QVector<bool> needed(nffields, false);
+    bool *needed_array = needed.data();
+    
+    foreach (const Symbol &symbol, symbols)
+    {
+        const QVector<FFTerm> &symterms = *(terms.constFind(symbol));
+        
+        for (int i=0; i<symterms.count(); ++i)
+        {
+            needed_array[ symterms.constData()[i].ffidx ] = true;
+        }
+    }
+
+    //recalculate the energies of the needed forcefields that are dirty.
+    //This is done in parallel, as each forcefield is independent
+    FFPtr *ffields_array = forcefields.data();
+    
+    tbb::parallel_for(0, nffields, 1, [=](int i)
+    {
+        if (needed_array[i] and ffields_array[i].read().isDirty())
+            ffields_array[i].edit().energy();
+    });
+    
+    //now throw away the cached energies of all of the components that
+    //depend on a forcefield that has changed
+    for (int i=0; i<nffields; ++i)
+    {
+        if (needed_array[i])
+        {
+            const FF &ffield = ffields_array[i].read();
+            
+            if (ffield.UID() != ff_uids[i] or ffield.version() != ff_versions[i])
+            {
+                foreach (const Symbol &symbol, dependents.at(i))
+                {
+                    nrgs.remove(symbol);
+                }
+                
+                ff_uids[i] = ffield.UID();
+                ff_versions[i] = ffield.version();
+            }
+        }
+    }
+    
+    //finally, evaluate the compiled form of the components that are out of date
+    Values vals;
+    vals.reserve(symbols.count());
+    
+    foreach (const Symbol &symbol, symbols)
+    {
+        QHash<Symbol,double>::const_iterator it = nrgs.constFind(symbol);
+        
+        if (it != nrgs.constEnd())
+        {
+            vals.set(symbol, it.value());
+        }
+        else
+        {
+            const QVector<FFTerm> &symterms = *(terms.constFind(symbol));
+            
+            double nrg = 0;
+            
+            for (int i=0; i<symterms.count(); ++i)
+            {
+                const FFTerm &term = symterms.constData()[i];
+            
+                nrg += term.scale * ffields_array[term.ffidx].read()
+                                        .currentEnergies().value(term.symbol);
+            }
+            
+            nrgs.insert(symbol, nrg);
+            vals.set(symbol, nrg);
+        }
+    }
+    
+    return vals;
+}
+
 ///////////
 /////////// Implementation of ForceFields
 ///////////
@@ -2125,6 +2434,26 @@ void ForceFields::rebuildIndex()
     }
     
     ffsymbols = new_symbols;
+    
+    //the compiled energy components are now out of date
+    nrg_cache.reset();
+}
+
+/** Return the cache of compiled energy components, compiling it if
+    necessary, and taking a private copy if it is shared with 
+    another ForceFields */
+FFEnergyCache& ForceFields::_pvt_energyCache()
+{
+    if (nrg_cache.get() == 0 or nrg_cache->nForceFields() != ffields_by_idx.count())
+    {
+        nrg_cache.reset( new FFEnergyCache(ffields_by_idx, ffsymbols) );
+    }
+    else if (not nrg_cache.unique())
+    {
+        nrg_cache.reset( new FFEnergyCache(*nrg_cache) );
+    }
+    
+    return *nrg_cache;
 }
 
 /** Construct a group that holds just a single forcefield */
@@ -2176,7 +2505,8 @@ ForceFields::ForceFields(const ForceFields &other)
               ffsymbols(other.ffsymbols),
               additional_properties(other.additional_properties),
               property_aliases(other.property_aliases),
-              combined_properties(other.combined_properties)
+              combined_properties(other.combined_properties),
+              nrg_cache(other.nrg_cache)
 {}
 
 /** Destructor */
@@ -2195,6 +2525,7 @@ ForceFields& ForceFields::operator=(const ForceFields &other)
         additional_properties = other.additional_properties;
         property_aliases = other.property_aliases;
         combined_properties = other.combined_properties;
+        nrg_cache = other.nrg_cache;
         
         MolGroupsBase::operator=(other);
     }
@@ -2624,20 +2955,15 @@ SireUnits::Dimension::MolarEnergy ForceFields::energy()
 }
 
 /** Return the energies of all of the energy components of all of the forcefields,
-    constants and expressions */
+    constants and expressions. The dirty forcefields are recalculated in parallel,
+    and only the components that depend on forcefields that have changed since
+    the last call are re-evaluated (using their compiled form), so sampling all
+    of the components regularly is cheap */
 Values ForceFields::energies()
 {
-    Values vals;
+    FFEnergyCache &cache = this->_pvt_energyCache();
     
-    for (QHash<Symbol,FFSymbolPtr>::const_iterator it = ffsymbols.constBegin();
-         it != ffsymbols.constEnd();
-         ++it)
-    {
-        if ( (*it)->isEnergy() )
-            vals.set(it.key(), this->energy(it.key()).value());
-    }
-
-    return vals;
+    return cache.energies(ffields_by_idx, cache.symbols());
 }
 
 /** Return the energies of all of the energy components whose symbols are 
@@ -2647,15 +2973,16 @@ Values ForceFields::energies()
 */
 Values ForceFields::energies(const QSet<Symbol> &components)
 {
-    Values vals;
-    vals.reserve(components.count());
-    
+    FFEnergyCache &cache = this->_pvt_energyCache();
+
     foreach (const Symbol &component, components)
     {
-        vals.set(component, this->energy(component).value());
+        if (not cache.contains(component))
+            //this will raise the correct exception
+            this->energy(component);
     }
     
-    return vals;
+    return cache.energies(ffields_by_idx, components.toList());
 }
 
 /** Return whether or not the forcefield component 'component'
@@ -2922,6 +3249,9 @@ void ForceFields::setConstantComponent(const Symbol &symbol, double value)
             else
             {
                 ffsymbols[symbol] = FFSymbolPtr( new FFConstantValue(symbol,value) );
+
+                //the constant is compiled into the cached energy components
+                nrg_cache.reset();
                 return;
             }
         }
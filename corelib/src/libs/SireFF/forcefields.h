@@ -68,6 +68,9 @@ namespace detail
 {
 class FFSymbol;
 typedef boost::shared_ptr<FFSymbol> FFSymbolPtr;
+
+class FFEnergyCache;
+typedef boost::shared_ptr<FFEnergyCache> FFEnergyCachePtr;
 }
 
 /** A ForceFields object contains a collection of forcefields,
@@ -379,6 +382,8 @@ private:
 
     void _pvt_remove(int i);
 
+    detail::FFEnergyCache& _pvt_energyCache();
+
     /** The global symbol used to refer to the total energy of a collection
         of forcefields */
     static Symbol total_component;
@@ -407,6 +412,11 @@ private:
     
     /** All of the combined properties, indexed by their name */
     QHash<QString, PropertyPtr> combined_properties;
+    
+    /** The compiled energy components, together with the energies
+        from the last time they were evaluated. This is shared between
+        copies, and is copied before it is changed */
+    detail::FFEnergyCachePtr nrg_cache;
 };
 
 }
@@ -4093,6 +4093,16 @@ QStringList AmberPrm::formatSuffix() const
     return suffixes;
 }
 
+/** Return the confidence that the file starting with 'prefix' is an
+    Amber topology file. These always contain %VERSION and %FLAG lines */
+double AmberPrm::sniff(const QByteArray &prefix) const
+{
+    if (prefix.startsWith("%VERSION") or prefix.contains("\n%FLAG"))
+        return 1.0;
+    else
+        return 0.0;
+}
+
 /** The AmberPrm parser is a lead parser - it is capable alone
     of creating the System. */
 bool AmberPrm::isLead() const
@@ -121,6 +121,8 @@ public:
     QString formatName() const;
     QStringList formatSuffix() const;
 
+    double sniff(const QByteArray &prefix) const;
+
     QString formatDescription() const;
 
     bool isLead() const;
@@ -126,6 +126,21 @@ QStringList AmberRst::formatSuffix() const
     return suffixes;
 }
 
+/** Return the confidence that the file starting with 'prefix' is an
+    Amber NetCDF file. This checks for the NetCDF3 (classic or 64bit offset)
+    or NetCDF4 (HDF5) magic numbers */
+double AmberRst::sniff(const QByteArray &prefix) const
+{
+    if (prefix.startsWith("CDF\x01") or prefix.startsWith("CDF\x02") or
+        prefix.startsWith("\x89HDF"))
+    {
+        //could be any NetCDF file, but these are normally Amber files
+        return 0.9;
+    }
+    else
+        return 0.0;
+}
+
 /** Internal function called to assert that this object is in a sane state */
 void AmberRst::assertSane() const
 {
@@ -105,6 +105,8 @@ public:
     QString formatDescription() const;
     QStringList formatSuffix() const;
 
+    double sniff(const QByteArray &prefix) const;
+
     static AmberRst parse(const QString &filename);
 
     QString title() const;
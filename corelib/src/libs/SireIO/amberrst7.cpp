@@ -174,6 +174,38 @@ QStringList AmberRst7::formatSuffix() const
     return suffixes;
 }
 
+/** Return the confidence that the file starting with 'prefix' is an
+    Amber text restart file. The second line of these files contains
+    the number of atoms, optionally followed by the time */
+double AmberRst7::sniff(const QByteArray &prefix) const
+{
+    const auto lines = MoleculeParser::prefixLines(prefix, 3);
+
+    if (lines.count() < 2)
+        return 0.0;
+
+    const auto words = lines[1].simplified().split(' ');
+
+    if (words.isEmpty() or words.count() > 2)
+        return 0.0;
+
+    bool ok;
+    const int natoms = words[0].toInt(&ok);
+
+    if (not ok or natoms <= 0)
+        return 0.0;
+
+    if (words.count() == 2)
+    {
+        words[1].toDouble(&ok);
+
+        if (not ok)
+            return 0.0;
+    }
+
+    return 0.8;
+}
+
 /** Return a description of the file format */
 QString AmberRst7::formatDescription() const
 {
@@ -100,6 +100,8 @@ public:
     QString formatDescription() const;
     QStringList formatSuffix() const;
 
+    double sniff(const QByteArray &prefix) const;
+
     static AmberRst7 parse(const QString &filename);
 
     QString title() const;
@@ -0,0 +1,712 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "SireIO/ambertrajectory.h"
+
+#include "SireBase/getinstalldir.h"
+
+#include "SireIO/errors.h"
+#include "SireError/errors.h"
+
+using namespace SireIO;
+using namespace SireMaths;
+
+//////////////
+////////////// Implementation of AmberTrajectoryReader
+//////////////
+
+/** Open the Amber NetCDF trajectory (or restart) file 'filename' for reading */
+AmberTrajectoryReader::AmberTrajectoryReader(const QString &filename)
+                      : fname(filename), natoms(0), nframes(0), is_restart(false)
+{
+    netcdf.reset( new NetCDFFile(filename) );
+    
+    //check that this is an Amber file
+    QString conventions;
+    
+    try
+    {
+        conventions = netcdf->getStringAttribute("Conventions");
+    }
+    catch(...)
+    {}
+    
+    if (conventions != "AMBER" and conventions != "AMBERRESTART")
+    {
+        throw SireIO::parse_error( QObject::tr(
+                "The file '%1' is not an Amber NetCDF trajectory or restart file, "
+                "as the 'Conventions' attribute is '%2', not 'AMBER' "
+                "or 'AMBERRESTART'.").arg(filename).arg(conventions), CODELOC );
+    }
+    
+    try
+    {
+        ttle = netcdf->getStringAttribute("title");
+    }
+    catch(...)
+    {}
+    
+    const auto dims = netcdf->getDimensions();
+    
+    natoms = dims.value("atom", 0);
+    is_restart = not dims.contains("frame");
+    nframes = is_restart ? 1 : dims.value("frame");
+    
+    vars = netcdf->getVariablesInfo();
+    
+    //work out the scale factors needed to convert each variable into
+    //the units used by Sire (velocities are in angstroms per 1/20.455 ps)
+    for (const auto name : { "time", "coordinates", "velocities", "forces",
+                             "cell_lengths", "cell_angles" })
+    {
+        if (not vars.contains(name))
+            continue;
+    
+        const auto atts = vars[name].attributes();
+        
+        double scale_factor = 1.0;
+        
+        if (atts.contains("scale_factor"))
+        {
+            bool ok;
+            scale_factor = atts["scale_factor"].toDouble(&ok);
+            
+            if (not ok)
+            {
+                throw SireIO::parse_error( QObject::tr(
+                        "Could not interpret the scale factor for '%1' in the "
+                        "Amber NetCDF file '%2' as a number: '%3'")
+                            .arg(name).arg(filename)
+                            .arg(atts["scale_factor"].toString()), CODELOC );
+            }
+        }
+        
+        if (QLatin1String(name) == QLatin1String("velocities"))
+        {
+            scale_factor /= 20.455;
+        }
+        
+        scale_factors.insert(name, scale_factor);
+    }
+}
+
+/** Destructor - this closes the file */
+AmberTrajectoryReader::~AmberTrajectoryReader()
+{}
+
+const char* AmberTrajectoryReader::typeName()
+{
+    return "SireIO::AmberTrajectoryReader";
+}
+
+const char* AmberTrajectoryReader::what() const
+{
+    return AmberTrajectoryReader::typeName();
+}
+
+QString AmberTrajectoryReader::toString() const
+{
+    return QObject::tr("AmberTrajectoryReader( filename = %1, nAtoms() = %2, "
+                       "nFrames() = %3 )")
+                .arg(fname).arg(natoms).arg(nframes);
+}
+
+/** Return the name of the file being read */
+QString AmberTrajectoryReader::filename() const
+{
+    return fname;
+}
+
+/** Return the title of the trajectory */
+QString AmberTrajectoryReader::title() const
+{
+    return ttle;
+}
+
+/** Return the number of atoms in each frame */
+int AmberTrajectoryReader::nAtoms() const
+{
+    return natoms;
+}
+
+/** Return the number of frames that can be read */
+int AmberTrajectoryReader::nFrames() const
+{
+    return nframes;
+}
+
+/** Refresh the reader so that it can see any frames that have been
+    appended to the file since it was opened (e.g. to follow a
+    trajectory that is being written by a running simulation).
+    This returns the new number of frames */
+int AmberTrajectoryReader::refresh()
+{
+    if (not is_restart)
+    {
+        netcdf->sync();
+        nframes = netcdf->getDimensions().value("frame", nframes);
+    }
+    
+    return nframes;
+}
+
+/** Return whether or not the trajectory contains the simulation time */
+bool AmberTrajectoryReader::hasTime() const
+{
+    return vars.contains("time");
+}
+
+/** Return whether or not the trajectory contains coordinates */
+bool AmberTrajectoryReader::hasCoordinates() const
+{
+    return vars.contains("coordinates");
+}
+
+/** Return whether or not the trajectory contains velocities */
+bool AmberTrajectoryReader::hasVelocities() const
+{
+    return vars.contains("velocities");
+}
+
+/** Return whether or not the trajectory contains forces */
+bool AmberTrajectoryReader::hasForces() const
+{
+    return vars.contains("forces");
+}
+
+/** Return whether or not the trajectory contains periodic box information */
+bool AmberTrajectoryReader::hasBox() const
+{
+    return vars.contains("cell_lengths") and vars.contains("cell_angles");
+}
+
+/** Assert that frames 'start' to 'start+count-1' are valid */
+void AmberTrajectoryReader::assertValidFrames(int start, int count) const
+{
+    if (start < 0 or count < 0 or start + count > nframes)
+    {
+        throw SireError::invalid_index( QObject::tr(
+                "Cannot read frames %1 to %2 from the Amber trajectory '%3' as "
+                "the number of frames is %4.")
+                    .arg(start).arg(start+count-1).arg(fname).arg(nframes), CODELOC );
+    }
+}
+
+/** Internal function used to read 'count' frames of the variable 'name',
+    starting from frame 'start', returning the values as a flat array
+    multiplied by 'scale' */
+QVector<double> AmberTrajectoryReader::readScalars(const QString &name, double scale,
+                                                   int start, int count) const
+{
+    assertValidFrames(start, count);
+    
+    if (not vars.contains(name))
+    {
+        throw SireError::unavailable_resource( QObject::tr(
+                "The Amber trajectory '%1' does not contain any '%2' data.")
+                    .arg(fname).arg(name), CODELOC );
+    }
+    
+    if (count == 0)
+        return QVector<double>();
+    
+    QVector<double> values;
+    
+    if (is_restart)
+    {
+        values = netcdf->read(vars[name]).toDoubleArray();
+    }
+    else
+    {
+        values = netcdf->read(vars[name], start, count).toDoubleArray();
+    }
+    
+    if (scale != 1.0)
+    {
+        for (auto &value : values)
+        {
+            value *= scale;
+        }
+    }
+    
+    return values;
+}
+
+/** Internal function used to read 'count' frames of the per-atom vector
+    variable 'name', starting from frame 'start' */
+QVector< QVector<Vector> > AmberTrajectoryReader::readVectors(const QString &name,
+                                                              double scale,
+                                                              int start, int count) const
+{
+    const auto values = readScalars(name, scale, start, count);
+    
+    if (values.count() != 3 * natoms * count)
+    {
+        throw SireIO::parse_error( QObject::tr(
+                "Wrong number of '%1' values read from the Amber trajectory '%2'. "
+                "Expected %3 but got %4.")
+                    .arg(name).arg(fname).arg(3*natoms*count)
+                    .arg(values.count()), CODELOC );
+    }
+    
+    QVector< QVector<Vector> > frames(count);
+    
+    const double *v = values.constData();
+    
+    for (int i=0; i<count; ++i)
+    {
+        QVector<Vector> frame(natoms);
+        Vector *f = frame.data();
+        
+        for (int j=0; j<natoms; ++j)
+        {
+            const int idx = 3*natoms*i + 3*j;
+            f[j] = Vector( v[idx], v[idx+1], v[idx+2] );
+        }
+        
+        frames[i] = frame;
+    }
+    
+    return frames;
+}
+
+/** Return the time (in picoseconds) of frame 'frame' */
+double AmberTrajectoryReader::time(int frame) const
+{
+    return readScalars("time", scale_factors.value("time",1.0), frame, 1).at(0);
+}
+
+/** Return the coordinates (in angstroms) of the atoms in frame 'frame' */
+QVector<Vector> AmberTrajectoryReader::coordinates(int frame) const
+{
+    return readVectors("coordinates", scale_factors.value("coordinates",1.0),
+                       frame, 1).at(0);
+}
+
+/** Return the velocities (in amber units) of the atoms in frame 'frame' */
+QVector<Vector> AmberTrajectoryReader::velocities(int frame) const
+{
+    return readVectors("velocities", scale_factors.value("velocities",1.0),
+                       frame, 1).at(0);
+}
+
+/** Return the forces on the atoms in frame 'frame' */
+QVector<Vector> AmberTrajectoryReader::forces(int frame) const
+{
+    return readVectors("forces", scale_factors.value("forces",1.0),
+                       frame, 1).at(0);
+}
+
+/** Return the dimensions of the periodic box (in angstroms) in frame 'frame' */
+Vector AmberTrajectoryReader::boxDimensions(int frame) const
+{
+    const auto vals = readScalars("cell_lengths", scale_factors.value("cell_lengths",1.0),
+                                  frame, 1);
+    
+    return Vector( vals.at(0), vals.at(1), vals.at(2) );
+}
+
+/** Return the angles of the periodic box (in degrees) in frame 'frame' */
+Vector AmberTrajectoryReader::boxAngles(int frame) const
+{
+    const auto vals = readScalars("cell_angles", scale_factors.value("cell_angles",1.0),
+                                  frame, 1);
+    
+    return Vector( vals.at(0), vals.at(1), vals.at(2) );
+}
+
+/** Return the times of the 'count' frames starting from frame 'start' */
+QVector<double> AmberTrajectoryReader::times(int start, int count) const
+{
+    return readScalars("time", scale_factors.value("time",1.0), start, count);
+}
+
+/** Return the coordinates of the 'count' frames starting from frame 'start'.
+    Only these frames are read from the file */
+QVector< QVector<Vector> > AmberTrajectoryReader::coordinates(int start, int count) const
+{
+    return readVectors("coordinates", scale_factors.value("coordinates",1.0),
+                       start, count);
+}
+
+/** Return the velocities of the 'count' frames starting from frame 'start' */
+QVector< QVector<Vector> > AmberTrajectoryReader::velocities(int start, int count) const
+{
+    return readVectors("velocities", scale_factors.value("velocities",1.0),
+                       start, count);
+}
+
+/** Return the forces of the 'count' frames starting from frame 'start' */
+QVector< QVector<Vector> > AmberTrajectoryReader::forces(int start, int count) const
+{
+    return readVectors("forces", scale_factors.value("forces",1.0),
+                       start, count);
+}
+
+//////////////
+////////////// Implementation of AmberTrajectoryWriter
+//////////////
+
+/** Open the existing Amber NetCDF trajectory 'filename' so that new frames
+    can be appended to it. The trajectory must have been created with
+    an unlimited frame dimension (as done by this class) */
+AmberTrajectoryWriter::AmberTrajectoryWriter(const QString &filename)
+                      : fname(filename), natoms(0), nframes(0),
+                        write_vels(false), write_frcs(false), write_box(false)
+{
+    netcdf.reset( new NetCDFFile(filename) );
+    
+    QString conventions;
+    
+    try
+    {
+        conventions = netcdf->getStringAttribute("Conventions");
+    }
+    catch(...)
+    {}
+    
+    const auto dims = netcdf->getDimensions();
+    
+    if (conventions != "AMBER" or not dims.contains("frame"))
+    {
+        throw SireIO::parse_error( QObject::tr(
+                "Cannot append to the file '%1' as it is not an Amber NetCDF "
+                "trajectory file.").arg(filename), CODELOC );
+    }
+    
+    natoms = dims.value("atom", 0);
+    nframes = dims.value("frame", 0);
+    
+    const auto vars = netcdf->getVariablesInfo();
+    
+    write_vels = vars.contains("velocities");
+    write_frcs = vars.contains("forces");
+    write_box = vars.contains("cell_lengths") and vars.contains("cell_angles");
+    
+    netcdf->openForAppending();
+}
+
+/** Create a new Amber NetCDF trajectory file called 'filename' that will
+    hold frames of 'natoms' atoms. Velocities, forces and the periodic
+    box will be written as well as the coordinates if 'write_velocities',
+    'write_forces' and 'write_box' are true. The trajectory will have
+    the passed title, and an existing file will only be overwritten
+    if 'overwrite_file' is true */
+AmberTrajectoryWriter::AmberTrajectoryWriter(const QString &filename, int num_atoms,
+                                             bool write_velocities, bool write_forces,
+                                             bool write_periodic_box,
+                                             const QString &title, bool overwrite_file)
+                      : fname(filename), natoms(num_atoms), nframes(0),
+                        write_vels(write_velocities), write_frcs(write_forces),
+                        write_box(write_periodic_box)
+{
+    if (natoms <= 0)
+    {
+        throw SireError::invalid_arg( QObject::tr(
+                "Cannot create an Amber trajectory with %1 atoms!")
+                    .arg(natoms), CODELOC );
+    }
+
+    QHash<QString,QString> globals;
+    
+    globals.insert( "Conventions", "AMBER" );
+    globals.insert( "ConventionVersion", "1.0" );
+    globals.insert( "application", "Sire" );
+    globals.insert( "program", "AmberTrajectoryWriter" );
+    globals.insert( "programVersion", SireBase::getReleaseVersion() );
+    
+    if (title.count() > 80)
+    {
+        globals.insert( "title", title.mid(0,80) );
+    }
+    else if (not title.isEmpty())
+    {
+        globals.insert( "title", title );
+    }
+    
+    //create the label variables, and empty (zero frame) versions
+    //of all of the per-frame variables
+    QHash<QString,NetCDFData> data;
+    
+    {
+        QStringList dimensions = { "spatial" };
+        QList<int> dimension_sizes = { 3 };
+        QVector<char> values = { 'x', 'y', 'z' };
+        data.insert( "spatial", NetCDFData("spatial", values, dimensions, dimension_sizes) );
+
+        QStringList dimensions2 = { "cell_spatial" };
+        values = { 'a', 'b', 'c' };
+        data.insert( "cell_spatial", NetCDFData("cell_spatial", values,
+                                                dimensions2, dimension_sizes) );
+        
+        QStringList dimensions3 = { "cell_angular", "label" };
+        dimension_sizes = { 3, 5 };
+        values = { 'a', 'l', 'p', 'h', 'a',
+                   'b', 'e', 't', 'a', ' ',
+                   'g', 'a', 'm', 'm', 'a' };
+        data.insert( "cell_angular", NetCDFData("cell_angular", values,
+                                                dimensions3, dimension_sizes) );
+    }
+    
+    {
+        QHash<QString,QVariant> attributes;
+        attributes.insert( "units", QString("picosecond") );
+        
+        data.insert( "time", NetCDFData("time", QVector<float>(), QStringList({"frame"}),
+                                        QList<int>({0}), attributes) );
+    }
+    
+    const QStringList dimensions = { "frame", "atom", "spatial" };
+    const QList<int> dimension_sizes = { 0, natoms, 3 };
+    
+    {
+        QHash<QString,QVariant> attributes;
+        attributes.insert( "units", QString("angstrom") );
+        
+        data.insert( "coordinates", NetCDFData("coordinates", QVector<float>(),
+                                               dimensions, dimension_sizes, attributes) );
+        
+        if (write_box)
+        {
+            data.insert( "cell_lengths", NetCDFData("cell_lengths", QVector<float>(),
+                                                    QStringList({"frame","cell_spatial"}),
+                                                    QList<int>({0,3}), attributes) );
+            
+            attributes.insert( "units", QString("degree") );
+            
+            data.insert( "cell_angles", NetCDFData("cell_angles", QVector<float>(),
+                                                   QStringList({"frame","cell_angular"}),
+                                                   QList<int>({0,3}), attributes) );
+        }
+    }
+    
+    if (write_vels)
+    {
+        QHash<QString,QVariant> attributes;
+        attributes.insert( "units", QString("angstrom/picosecond") );
+        attributes.insert( "scale_factor", float(20.455) );
+        
+        data.insert( "velocities", NetCDFData("velocities", QVector<float>(),
+                                              dimensions, dimension_sizes, attributes) );
+    }
+    
+    if (write_frcs)
+    {
+        QHash<QString,QVariant> attributes;
+        attributes.insert( "units", QString("amu*angstrom/picosecond^2") );
+        
+        data.insert( "forces", NetCDFData("forces", QVector<float>(),
+                                          dimensions, dimension_sizes, attributes) );
+    }
+    
+    netcdf.reset( new NetCDFFile(filename, globals, data, "frame", overwrite_file) );
+}
+
+/** Destructor - this closes the file, flushing all frames to disk */
+AmberTrajectoryWriter::~AmberTrajectoryWriter()
+{}
+
+const char* AmberTrajectoryWriter::typeName()
+{
+    return "SireIO::AmberTrajectoryWriter";
+}
+
+const char* AmberTrajectoryWriter::what() const
+{
+    return AmberTrajectoryWriter::typeName();
+}
+
+QString AmberTrajectoryWriter::toString() const
+{
+    return QObject::tr("AmberTrajectoryWriter( filename = %1, nAtoms() = %2, "
+                       "nFrames() = %3 )")
+                .arg(fname).arg(natoms).arg(nframes);
+}
+
+/** Return the name of the file being written */
+QString AmberTrajectoryWriter::filename() const
+{
+    return fname;
+}
+
+/** Return the number of atoms in each frame */
+int AmberTrajectoryWriter::nAtoms() const
+{
+    return natoms;
+}
+
+/** Return the number of frames written so far */
+int AmberTrajectoryWriter::nFrames() const
+{
+    return nframes;
+}
+
+/** Return whether or not the file is still open for writing */
+bool AmberTrajectoryWriter::isOpen() const
+{
+    return netcdf.get() != 0 and netcdf->isOpen();
+}
+
+/** Assert that the file is still open */
+void AmberTrajectoryWriter::assertOpen() const
+{
+    if (not isOpen())
+    {
+        throw SireError::io_error( QObject::tr(
+                "Cannot write to the Amber trajectory '%1' as it has been closed.")
+                    .arg(fname), CODELOC );
+    }
+}
+
+/** Internal function used to convert a frame of vectors into
+    NetCDFData that can be appended to the file */
+static NetCDFData toFrame(const QString &name, const QVector<Vector> &vectors, int natoms)
+{
+    if (vectors.count() != natoms)
+    {
+        throw SireError::incompatible_error( QObject::tr(
+                "Cannot write the '%1' of %2 atoms to an Amber trajectory that "
+                "has %3 atoms per frame.")
+                    .arg(name).arg(vectors.count()).arg(natoms), CODELOC );
+    }
+    
+    QVector<float> values(3*natoms);
+    float *v = values.data();
+    
+    for (int i=0; i<natoms; ++i)
+    {
+        const Vector &vec = vectors.constData()[i];
+        v[3*i + 0] = vec.x();
+        v[3*i + 1] = vec.y();
+        v[3*i + 2] = vec.z();
+    }
+    
+    return NetCDFData(name, values, QStringList({"frame","atom","spatial"}),
+                      QList<int>({1,natoms,3}));
+}
+
+/** Append a frame at time 'time' (in picoseconds) with the passed coordinates
+    (in angstroms) to the trajectory. This can only be used if the trajectory
+    doesn't also contain velocities, forces or a periodic box */
+void AmberTrajectoryWriter::append(double time, const QVector<Vector> &coordinates)
+{
+    if (write_vels or write_frcs or write_box)
+    {
+        throw SireError::incompatible_error( QObject::tr(
+                "Cannot append only coordinates to the Amber trajectory '%1' as "
+                "it also needs velocities, forces or box information.")
+                    .arg(fname), CODELOC );
+    }
+    
+    this->append(time, coordinates, QVector<Vector>(), QVector<Vector>(),
+                 Vector(0), Vector(0));
+}
+
+/** Append a frame at time 'time' with the passed coordinates and periodic box
+    dimensions (in angstroms) and angles (in degrees) to the trajectory */
+void AmberTrajectoryWriter::append(double time, const QVector<Vector> &coordinates,
+                                   const Vector &box_dimensions, const Vector &box_angles)
+{
+    if (write_vels or write_frcs)
+    {
+        throw SireError::incompatible_error( QObject::tr(
+                "Cannot append only coordinates and box information to the "
+                "Amber trajectory '%1' as it also needs velocities or forces.")
+                    .arg(fname), CODELOC );
+    }
+    
+    this->append(time, coordinates, QVector<Vector>(), QVector<Vector>(),
+                 box_dimensions, box_angles);
+}
+
+/** Append a frame at time 'time' with the passed coordinates, velocities
+    (in amber units), forces and periodic box to the trajectory. The velocities,
+    forces and box are ignored if they are not written to this trajectory.
+    The frame is written straight to the file, so it is not held in memory */
+void AmberTrajectoryWriter::append(double time, const QVector<Vector> &coordinates,
+                                   const QVector<Vector> &velocities,
+                                   const QVector<Vector> &forces,
+                                   const Vector &box_dimensions, const Vector &box_angles)
+{
+    assertOpen();
+
+    QHash<QString,NetCDFData> data;
+    
+    data.insert( "time", NetCDFData("time", QVector<float>({float(time)}),
+                                    QStringList({"frame"}), QList<int>({1})) );
+    
+    data.insert( "coordinates", toFrame("coordinates", coordinates, natoms) );
+    
+    if (write_vels)
+    {
+        data.insert( "velocities", toFrame("velocities", velocities, natoms) );
+    }
+    
+    if (write_frcs)
+    {
+        data.insert( "forces", toFrame("forces", forces, natoms) );
+    }
+    
+    if (write_box)
+    {
+        QVector<float> values = { float(box_dimensions.x()), float(box_dimensions.y()),
+                                  float(box_dimensions.z()) };
+        
+        data.insert( "cell_lengths", NetCDFData("cell_lengths", values,
+                                                QStringList({"frame","cell_spatial"}),
+                                                QList<int>({1,3})) );
+        
+        values = { float(box_angles.x()), float(box_angles.y()), float(box_angles.z()) };
+
+        data.insert( "cell_angles", NetCDFData("cell_angles", values,
+                                               QStringList({"frame","cell_angular"}),
+                                               QList<int>({1,3})) );
+    }
+    
+    netcdf->append(data);
+    nframes += 1;
+}
+
+/** Flush all of the frames written so far to disk, so that they can be
+    read by other programs while the trajectory is still being written */
+void AmberTrajectoryWriter::flush()
+{
+    if (isOpen())
+    {
+        netcdf->sync();
+    }
+}
+
+/** Close the trajectory. No more frames can be written after this */
+void AmberTrajectoryWriter::close()
+{
+    if (netcdf.get() != 0)
+    {
+        netcdf->close();
+    }
+}
@@ -0,0 +1,219 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#ifndef SIREIO_AMBERTRAJECTORY_H
+#define SIREIO_AMBERTRAJECTORY_H
+
+#include "netcdffile.h"
+
+#include "SireMaths/vector.h"
+
+#include <QVector>
+
+#include <boost/shared_ptr.hpp>
+
+SIRE_BEGIN_HEADER
+
+namespace SireIO
+{
+
+using SireMaths::Vector;
+
+/** This class provides a streaming reader for Amber-format binary
+    (NetCDF) trajectory files. Unlike AmberRst, which reads the whole
+    trajectory into memory, this reads the data one frame (or a batch
+    of frames) at a time, so that the memory used is independent of
+    the length of the trajectory. This can also be used to follow
+    a trajectory that is still being written (see refresh()).
+
+    Amber restart files (which have no frame dimension) are treated
+    as trajectories containing a single frame.
+
+    Coordinates are returned in angstroms, times in picoseconds,
+    forces in amu angstroms per picosecond squared, and velocities
+    in amber units (angstroms per 1/20.455 picoseconds), as for AmberRst.
+
+    The file format is described here;
+
+    http://ambermd.org/netcdf/nctraj.xhtml
+
+    @author Christopher Woods
+*/
+class SIREIO_EXPORT AmberTrajectoryReader : public boost::noncopyable
+{
+public:
+    AmberTrajectoryReader(const QString &filename);
+    
+    ~AmberTrajectoryReader();
+    
+    static const char* typeName();
+    const char* what() const;
+    
+    QString toString() const;
+    
+    QString filename() const;
+    QString title() const;
+    
+    int nAtoms() const;
+    int nFrames() const;
+    
+    int refresh();
+    
+    bool hasTime() const;
+    bool hasCoordinates() const;
+    bool hasVelocities() const;
+    bool hasForces() const;
+    bool hasBox() const;
+    
+    double time(int frame) const;
+    
+    QVector<Vector> coordinates(int frame) const;
+    QVector<Vector> velocities(int frame) const;
+    QVector<Vector> forces(int frame) const;
+    
+    Vector boxDimensions(int frame) const;
+    Vector boxAngles(int frame) const;
+    
+    QVector<double> times(int start, int count) const;
+
+    QVector< QVector<Vector> > coordinates(int start, int count) const;
+    QVector< QVector<Vector> > velocities(int start, int count) const;
+    QVector< QVector<Vector> > forces(int start, int count) const;
+
+private:
+    void assertValidFrames(int start, int count) const;
+
+    QVector<double> readScalars(const QString &name, double scale,
+                                int start, int count) const;
+
+    QVector< QVector<Vector> > readVectors(const QString &name, double scale,
+                                           int start, int count) const;
+
+    /** The open NetCDF file */
+    boost::shared_ptr<NetCDFFile> netcdf;
+    
+    /** The name of the file */
+    QString fname;
+    
+    /** The title of the trajectory */
+    QString ttle;
+    
+    /** Information about all of the variables in the file */
+    QHash<QString,NetCDFDataInfo> vars;
+    
+    /** The scale factors used to convert each variable into
+        the units returned by this reader, indexed by variable name */
+    QHash<QString,double> scale_factors;
+    
+    /** The number of atoms in each frame */
+    qint32 natoms;
+    
+    /** The number of frames available to read */
+    qint32 nframes;
+    
+    /** Whether or not this is a restart file (single frame,
+        no frame dimension) */
+    bool is_restart;
+};
+
+/** This class provides a streaming writer for Amber-format binary
+    (NetCDF) trajectory files. Frames are appended to the file one
+    at a time as they are generated, so the trajectory never needs
+    to be held in memory, and a partially-written trajectory is
+    always a valid file that can be read (e.g. by AmberTrajectoryReader
+    or by other Amber-compatible tools).
+
+    Units are the same as for AmberTrajectoryReader.
+
+    @author Christopher Woods
+*/
+class SIREIO_EXPORT AmberTrajectoryWriter : public boost::noncopyable
+{
+public:
+    AmberTrajectoryWriter(const QString &filename);
+
+    AmberTrajectoryWriter(const QString &filename, int natoms,
+                          bool write_velocities=false, bool write_forces=false,
+                          bool write_box=false,
+                          const QString &title = QString(),
+                          bool overwrite_file=true);
+    
+    ~AmberTrajectoryWriter();
+    
+    static const char* typeName();
+    const char* what() const;
+    
+    QString toString() const;
+    
+    QString filename() const;
+    
+    int nAtoms() const;
+    int nFrames() const;
+    
+    bool isOpen() const;
+    
+    void append(double time, const QVector<Vector> &coordinates);
+    
+    void append(double time, const QVector<Vector> &coordinates,
+                const Vector &box_dimensions, const Vector &box_angles);
+    
+    void append(double time, const QVector<Vector> &coordinates,
+                const QVector<Vector> &velocities,
+                const QVector<Vector> &forces,
+                const Vector &box_dimensions, const Vector &box_angles);
+
+    void flush();
+    void close();
+
+private:
+    void assertOpen() const;
+
+    /** The open NetCDF file */
+    boost::shared_ptr<NetCDFFile> netcdf;
+    
+    /** The name of the file */
+    QString fname;
+    
+    /** The number of atoms in each frame */
+    qint32 natoms;
+    
+    /** The number of frames written so far */
+    qint32 nframes;
+    
+    /** Whether or not velocities, forces and the box are written */
+    bool write_vels, write_frcs, write_box;
+};
+
+}
+
+SIRE_EXPOSE_CLASS( SireIO::AmberTrajectoryReader )
+SIRE_EXPOSE_CLASS( SireIO::AmberTrajectoryWriter )
+
+SIRE_END_HEADER
+
+#endif
@@ -1440,6 +1440,16 @@ QStringList CharmmPSF::formatSuffix() const
     return suffixes;
 }
 
+/** Return the confidence that the file starting with 'prefix' is a
+    PSF file. These start with the "PSF" keyword */
+double CharmmPSF::sniff(const QByteArray &prefix) const
+{
+    if (prefix.trimmed().startsWith("PSF"))
+        return 1.0;
+    else
+        return 0.0;
+}
+
 /** Return whether or not this is a lead parser. The lead parser is responsible
     for starting the process of turning the parsed file into the System. There
     must be one and one-only lead parser in a set of parsers creating a System */
@@ -272,6 +272,8 @@ public:
     QString formatDescription() const;
     QStringList formatSuffix() const;
 
+    double sniff(const QByteArray &prefix) const;
+
     bool isLead() const;
     bool canFollow() const;
 
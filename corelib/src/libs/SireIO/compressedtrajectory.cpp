@@ -0,0 +1,611 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "SireIO/compressedtrajectory.h"
+
+#include "SireIO/errors.h"
+#include "SireError/errors.h"
+
+#include <QDataStream>
+#include <QFileInfo>
+
+#include <cmath>
+
+using namespace SireIO;
+using namespace SireMaths;
+
+/** The magic string at the start of every compressed trajectory file */
+static const char compressed_trajectory_magic[] = "SIRETRJC";
+
+/** The version of the file format */
+static const quint32 compressed_trajectory_version = 1;
+
+/** The size of the file header (magic, version, natoms, precision) */
+static const qint64 compressed_trajectory_header_size = 8 + 4 + 4 + 8;
+
+/** Internal function used to pack the coordinates into a compressed
+    array. Each coordinate is rounded to a multiple of 'precision' and
+    stored as the zig-zag encoded, variable-length integer difference
+    from the same coordinate of the previous atom. As neighbouring atoms
+    are normally close in space, most differences fit into one or two
+    bytes, and the resulting stream compresses well */
+static QByteArray packCoordinates(const QVector<Vector> &coords, double precision)
+{
+    QByteArray packed;
+    packed.reserve( 6 * coords.count() );
+    
+    const double inv_precision = 1.0 / precision;
+    
+    qint64 last[3] = { 0, 0, 0 };
+    
+    for (const auto &c : coords)
+    {
+        for (int k=0; k<3; ++k)
+        {
+            const qint64 v = std::llround( c[k] * inv_precision );
+            const qint64 delta = v - last[k];
+            last[k] = v;
+            
+            quint64 z = (quint64(delta) << 1) ^ quint64(delta >> 63);
+            
+            while (z >= 0x80)
+            {
+                packed.append( char((z & 0x7f) | 0x80) );
+                z >>= 7;
+            }
+            
+            packed.append( char(z) );
+        }
+    }
+    
+    return qCompress(packed);
+}
+
+/** Internal function used to unpack the coordinates packed using
+    packCoordinates */
+static QVector<Vector> unpackCoordinates(const QByteArray &data, int natoms,
+                                         double precision)
+{
+    const QByteArray packed = qUncompress(data);
+    
+    QVector<Vector> coords(natoms);
+    
+    const unsigned char *p = reinterpret_cast<const unsigned char*>(packed.constData());
+    const unsigned char *end = p + packed.count();
+    
+    qint64 last[3] = { 0, 0, 0 };
+    
+    for (int i=0; i<natoms; ++i)
+    {
+        double c[3];
+    
+        for (int k=0; k<3; ++k)
+        {
+            quint64 z = 0;
+            int shift = 0;
+            
+            while (true)
+            {
+                if (p == end)
+                {
+                    throw SireIO::parse_error( QObject::tr(
+                            "The compressed trajectory frame is corrupted, as it "
+                            "ended after %1 of %2 atoms.").arg(i).arg(natoms), CODELOC );
+                }
+                
+                const unsigned char byte = *p++;
+                z |= quint64(byte & 0x7f) << shift;
+                
+                if ((byte & 0x80) == 0)
+                    break;
+                
+                shift += 7;
+            }
+            
+            const qint64 delta = qint64(z >> 1) ^ -qint64(z & 1);
+            last[k] += delta;
+            c[k] = last[k] * precision;
+        }
+        
+        coords[i] = Vector(c[0], c[1], c[2]);
+    }
+    
+    return coords;
+}
+
+/** Internal function used to read and validate the header of the file,
+    returning the number of atoms and the precision */
+static void readHeader(QFile &f, qint32 &natoms, double &precision)
+{
+    f.seek(0);
+    
+    QDataStream ds(&f);
+    
+    char magic[8];
+    quint32 version;
+    
+    if (ds.readRawData(magic, 8) != 8 or
+        QByteArray(magic,8) != QByteArray(compressed_trajectory_magic,8))
+    {
+        throw SireIO::parse_error( QObject::tr(
+                "The file '%1' is not a Sire compressed trajectory file.")
+                    .arg(f.fileName()), CODELOC );
+    }
+    
+    ds >> version;
+    
+    if (version != compressed_trajectory_version)
+    {
+        throw SireIO::parse_error( QObject::tr(
+                "Cannot read the compressed trajectory '%1' as it uses version %2 "
+                "of the file format, while only version %3 is supported.")
+                    .arg(f.fileName()).arg(version)
+                    .arg(compressed_trajectory_version), CODELOC );
+    }
+    
+    ds >> natoms >> precision;
+}
+
+/** Internal function used to find the start of each complete frame
+    after position 'pos' in the file. This returns the position
+    of the end of the last complete frame */
+static qint64 indexFrames(QFile &f, qint64 pos, QVector<qint64> &frame_starts)
+{
+    const qint64 file_size = f.size();
+    
+    QDataStream ds(&f);
+    
+    while (pos + 4 <= file_size)
+    {
+        f.seek(pos);
+        
+        quint32 record_size;
+        ds >> record_size;
+        
+        if (pos + 4 + record_size > file_size)
+            //this frame is still being written
+            break;
+        
+        frame_starts.append(pos);
+        pos += 4 + record_size;
+    }
+    
+    return pos;
+}
+
+//////////////
+////////////// Implementation of CompressedTrajectoryWriter
+//////////////
+
+/** Open the existing compressed trajectory 'filename' so that new frames
+    can be appended to it. Any incomplete frame at the end of the file
+    (e.g. from a run that was killed while writing) is removed */
+CompressedTrajectoryWriter::CompressedTrajectoryWriter(const QString &filename)
+                           : f(filename), natoms(0), nframes(0), prec(0)
+{
+    if (not f.open(QIODevice::ReadWrite))
+    {
+        throw SireError::file_error(f, CODELOC);
+    }
+    
+    ::readHeader(f, natoms, prec);
+    
+    QVector<qint64> frame_starts;
+    qint64 end = ::indexFrames(f, compressed_trajectory_header_size, frame_starts);
+    
+    if (end != f.size())
+    {
+        f.resize(end);
+    }
+    
+    nframes = frame_starts.count();
+    f.seek(end);
+}
+
+/** Create a new compressed trajectory called 'filename' that will hold
+    frames of 'natoms' atoms, with coordinates stored to the passed
+    precision (in angstroms). An existing file will only be overwritten
+    if 'overwrite_file' is true */
+CompressedTrajectoryWriter::CompressedTrajectoryWriter(const QString &filename, int num_atoms,
+                                                       double precision, bool overwrite_file)
+                           : f(filename), natoms(num_atoms), nframes(0), prec(precision)
+{
+    if (natoms <= 0)
+    {
+        throw SireError::invalid_arg( QObject::tr(
+                "Cannot create a compressed trajectory with %1 atoms!")
+                    .arg(natoms), CODELOC );
+    }
+    
+    if (prec <= 0)
+    {
+        throw SireError::invalid_arg( QObject::tr(
+                "Cannot create a compressed trajectory with a precision of %1. "
+                "The precision must be greater than zero.")
+                    .arg(prec), CODELOC );
+    }
+    
+    if (QFileInfo(filename).exists() and not overwrite_file)
+    {
+        throw SireError::io_error( QObject::tr(
+                "Cannot create the compressed trajectory '%1' as it already exists, "
+                "and the software is not allowed to overwrite an existing file!")
+                    .arg(filename), CODELOC );
+    }
+    
+    if (not f.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        throw SireError::file_error(f, CODELOC);
+    }
+    
+    QDataStream ds(&f);
+    
+    ds.writeRawData(compressed_trajectory_magic, 8);
+    ds << compressed_trajectory_version << natoms << prec;
+    
+    if (ds.status() != QDataStream::Ok)
+    {
+        throw SireError::file_error( QObject::tr(
+                "There was an error writing the header of the compressed "
+                "trajectory '%1'.").arg(filename), CODELOC );
+    }
+}
+
+/** Destructor - this closes the file */
+CompressedTrajectoryWriter::~CompressedTrajectoryWriter()
+{}
+
+const char* CompressedTrajectoryWriter::typeName()
+{
+    return "SireIO::CompressedTrajectoryWriter";
+}
+
+const char* CompressedTrajectoryWriter::what() const
+{
+    return CompressedTrajectoryWriter::typeName();
+}
+
+QString CompressedTrajectoryWriter::toString() const
+{
+    return QObject::tr("CompressedTrajectoryWriter( filename = %1, nAtoms() = %2, "
+                       "nFrames() = %3, precision() = %4 )")
+                .arg(f.fileName()).arg(natoms).arg(nframes).arg(prec);
+}
+
+/** Return the name of the file being written */
+QString CompressedTrajectoryWriter::filename() const
+{
+    return f.fileName();
+}
+
+/** Return the number of atoms in each frame */
+int CompressedTrajectoryWriter::nAtoms() const
+{
+    return natoms;
+}
+
+/** Return the number of frames in the trajectory */
+int CompressedTrajectoryWriter::nFrames() const
+{
+    return nframes;
+}
+
+/** Return the precision (in angstroms) to which coordinates are stored */
+double CompressedTrajectoryWriter::precision() const
+{
+    return prec;
+}
+
+/** Return whether or not the file is still open for writing */
+bool CompressedTrajectoryWriter::isOpen() const
+{
+    return f.isOpen();
+}
+
+/** Internal function used to write a frame to the file */
+void CompressedTrajectoryWriter::writeFrame(double time, const QVector<Vector> &coordinates,
+                                            bool has_box, const Vector &box_dimensions,
+                                            const Vector &box_angles)
+{
+    if (not f.isOpen())
+    {
+        throw SireError::io_error( QObject::tr(
+                "Cannot write to the compressed trajectory '%1' as it has been closed.")
+                    .arg(f.fileName()), CODELOC );
+    }
+
+    if (coordinates.count() != natoms)
+    {
+        throw SireError::incompatible_error( QObject::tr(
+                "Cannot write the coordinates of %1 atoms to the compressed "
+                "trajectory '%2' as it has %3 atoms per frame.")
+                    .arg(coordinates.count()).arg(f.fileName()).arg(natoms), CODELOC );
+    }
+    
+    QByteArray record;
+    
+    {
+        QDataStream ds(&record, QIODevice::WriteOnly);
+        
+        ds << time << quint8(has_box);
+        
+        if (has_box)
+        {
+            ds << box_dimensions.x() << box_dimensions.y() << box_dimensions.z()
+               << box_angles.x() << box_angles.y() << box_angles.z();
+        }
+        
+        ds << ::packCoordinates(coordinates, prec);
+    }
+    
+    QDataStream ds(&f);
+    ds << quint32(record.count());
+    
+    if (ds.writeRawData(record.constData(), record.count()) != record.count())
+    {
+        throw SireError::file_error( QObject::tr(
+                "There was an error writing frame %1 to the compressed trajectory "
+                "'%2'. Maybe the disk is full?")
+                    .arg(nframes).arg(f.fileName()), CODELOC );
+    }
+    
+    nframes += 1;
+}
+
+/** Append a frame at time 'time' (in picoseconds) with the passed
+    coordinates (in angstroms) to the trajectory */
+void CompressedTrajectoryWriter::append(double time, const QVector<Vector> &coordinates)
+{
+    this->writeFrame(time, coordinates, false, Vector(0), Vector(0));
+}
+
+/** Append a frame at time 'time' with the passed coordinates and periodic
+    box dimensions (in angstroms) and angles (in degrees) to the trajectory */
+void CompressedTrajectoryWriter::append(double time, const QVector<Vector> &coordinates,
+                                        const Vector &box_dimensions,
+                                        const Vector &box_angles)
+{
+    this->writeFrame(time, coordinates, true, box_dimensions, box_angles);
+}
+
+/** Flush all of the frames written so far to disk */
+void CompressedTrajectoryWriter::flush()
+{
+    if (f.isOpen())
+    {
+        f.flush();
+    }
+}
+
+/** Close the trajectory. No more frames can be written after this */
+void CompressedTrajectoryWriter::close()
+{
+    f.close();
+}
+
+//////////////
+////////////// Implementation of CompressedTrajectoryReader
+//////////////
+
+/** Open the compressed trajectory 'filename' for reading */
+CompressedTrajectoryReader::CompressedTrajectoryReader(const QString &filename)
+                           : f(filename), natoms(0), prec(0)
+{
+    if (not f.open(QIODevice::ReadOnly))
+    {
+        throw SireError::file_error(f, CODELOC);
+    }
+    
+    ::readHeader(f, natoms, prec);
+    ::indexFrames(f, compressed_trajectory_header_size, frame_starts);
+}
+
+/** Destructor */
+CompressedTrajectoryReader::~CompressedTrajectoryReader()
+{}
+
+const char* CompressedTrajectoryReader::typeName()
+{
+    return "SireIO::CompressedTrajectoryReader";
+}
+
+const char* CompressedTrajectoryReader::what() const
+{
+    return CompressedTrajectoryReader::typeName();
+}
+
+QString CompressedTrajectoryReader::toString() const
+{
+    return QObject::tr("CompressedTrajectoryReader( filename = %1, nAtoms() = %2, "
+                       "nFrames() = %3, precision() = %4 )")
+                .arg(f.fileName()).arg(natoms).arg(frame_starts.count()).arg(prec);
+}
+
+/** Return the name of the file being read */
+QString CompressedTrajectoryReader::filename() const
+{
+    return f.fileName();
+}
+
+/** Return the number of atoms in each frame */
+int CompressedTrajectoryReader::nAtoms() const
+{
+    return natoms;
+}
+
+/** Return the number of frames that can be read */
+int CompressedTrajectoryReader::nFrames() const
+{
+    return frame_starts.count();
+}
+
+/** Return the precision (in angstroms) to which the coordinates were stored */
+double CompressedTrajectoryReader::precision() const
+{
+    return prec;
+}
+
+/** Refresh the reader so that it can see any frames that have been
+    appended to the file since it was opened. This returns the new
+    number of frames */
+int CompressedTrajectoryReader::refresh()
+{
+    qint64 pos = compressed_trajectory_header_size;
+    
+    if (not frame_starts.isEmpty())
+    {
+        //start from the last indexed frame
+        pos = frame_starts.last();
+        frame_starts.removeLast();
+    }
+    
+    ::indexFrames(f, pos, frame_starts);
+    
+    return frame_starts.count();
+}
+
+/** Internal function used to read the record for frame 'frame' */
+QByteArray CompressedTrajectoryReader::readFrame(int frame) const
+{
+    if (frame < 0 or frame >= frame_starts.count())
+    {
+        throw SireError::invalid_index( QObject::tr(
+                "Cannot read frame %1 from the compressed trajectory '%2' as "
+                "the number of frames is %3.")
+                    .arg(frame).arg(f.fileName()).arg(frame_starts.count()), CODELOC );
+    }
+    
+    f.seek( frame_starts.at(frame) );
+    
+    QDataStream ds(&f);
+    
+    quint32 record_size;
+    ds >> record_size;
+    
+    QByteArray record(record_size, '\0');
+    
+    if (ds.readRawData(record.data(), record_size) != int(record_size))
+    {
+        throw SireIO::parse_error( QObject::tr(
+                "Could not read frame %1 from the compressed trajectory '%2'.")
+                    .arg(frame).arg(f.fileName()), CODELOC );
+    }
+    
+    return record;
+}
+
+/** Return the time (in picoseconds) of frame 'frame' */
+double CompressedTrajectoryReader::time(int frame) const
+{
+    const QByteArray record = readFrame(frame);
+    QDataStream ds(record);
+    
+    double t;
+    ds >> t;
+    
+    return t;
+}
+
+/** Return the coordinates (in angstroms) of the atoms in frame 'frame' */
+QVector<Vector> CompressedTrajectoryReader::coordinates(int frame) const
+{
+    const QByteArray record = readFrame(frame);
+    QDataStream ds(record);
+    
+    double t;
+    quint8 has_box;
+    ds >> t >> has_box;
+    
+    if (has_box)
+    {
+        double box[6];
+        
+        for (int i=0; i<6; ++i)
+        {
+            ds >> box[i];
+        }
+    }
+    
+    QByteArray packed;
+    ds >> packed;
+    
+    return ::unpackCoordinates(packed, natoms, prec);
+}
+
+/** Return whether or not frame 'frame' has a periodic box */
+bool CompressedTrajectoryReader::hasBox(int frame) const
+{
+    const QByteArray record = readFrame(frame);
+    QDataStream ds(record);
+    
+    double t;
+    quint8 has_box;
+    ds >> t >> has_box;
+    
+    return has_box;
+}
+
+/** Return the dimensions of the periodic box (in angstroms) of frame 'frame'.
+    This returns a zero vector if the frame has no periodic box */
+Vector CompressedTrajectoryReader::boxDimensions(int frame) const
+{
+    const QByteArray record = readFrame(frame);
+    QDataStream ds(record);
+    
+    double t;
+    quint8 has_box;
+    ds >> t >> has_box;
+    
+    if (not has_box)
+        return Vector(0);
+    
+    double x, y, z;
+    ds >> x >> y >> z;
+    
+    return Vector(x, y, z);
+}
+
+/** Return the angles of the periodic box (in degrees) of frame 'frame'.
+    This returns a zero vector if the frame has no periodic box */
+Vector CompressedTrajectoryReader::boxAngles(int frame) const
+{
+    const QByteArray record = readFrame(frame);
+    QDataStream ds(record);
+    
+    double t;
+    quint8 has_box;
+    ds >> t >> has_box;
+    
+    if (not has_box)
+        return Vector(0);
+    
+    double x, y, z;
+    ds >> x >> y >> z >> x >> y >> z;
+    
+    return Vector(x, y, z);
+}
@@ -0,0 +1,177 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#ifndef SIREIO_COMPRESSEDTRAJECTORY_H
+#define SIREIO_COMPRESSEDTRAJECTORY_H
+
+#include "sireglobal.h"
+
+#include "SireMaths/vector.h"
+
+#include <QFile>
+#include <QVector>
+
+#include <boost/noncopyable.hpp>
+
+SIRE_BEGIN_HEADER
+
+namespace SireIO
+{
+
+using SireMaths::Vector;
+
+/** This class writes trajectories using a lossy, fixed-precision
+    compressed binary format, in the same spirit as the GROMACS XTC format.
+    
+    Coordinates are rounded to a fixed precision (by default 0.01 angstroms),
+    converted to integers, and each atom is stored as the (small) difference
+    from the previous atom. These differences are packed into variable-length
+    integers and then compressed, so that a typical frame takes about a tenth
+    of the space of the equivalent uncompressed binary frame, and much less
+    than a text (e.g. PDB) frame.
+    
+    Each frame is stored as an independent, size-prefixed record, so frames
+    can be appended to an existing trajectory, and a partially-written
+    trajectory can still be read. Only coordinates, times and the periodic
+    box (dimensions and angles) are stored.
+    
+    Read the trajectory using CompressedTrajectoryReader.
+
+    @author Christopher Woods
+*/
+class SIREIO_EXPORT CompressedTrajectoryWriter : public boost::noncopyable
+{
+public:
+    CompressedTrajectoryWriter(const QString &filename);
+    
+    CompressedTrajectoryWriter(const QString &filename, int natoms,
+                               double precision=0.01, bool overwrite_file=true);
+    
+    ~CompressedTrajectoryWriter();
+    
+    static const char* typeName();
+    const char* what() const;
+    
+    QString toString() const;
+    
+    QString filename() const;
+    
+    int nAtoms() const;
+    int nFrames() const;
+    
+    double precision() const;
+    
+    bool isOpen() const;
+    
+    void append(double time, const QVector<Vector> &coordinates);
+    
+    void append(double time, const QVector<Vector> &coordinates,
+                const Vector &box_dimensions, const Vector &box_angles);
+    
+    void flush();
+    void close();
+
+private:
+    void writeFrame(double time, const QVector<Vector> &coordinates,
+                    bool has_box, const Vector &box_dimensions,
+                    const Vector &box_angles);
+
+    /** The file being written */
+    QFile f;
+    
+    /** The number of atoms in each frame */
+    qint32 natoms;
+    
+    /** The number of frames in the file */
+    qint32 nframes;
+    
+    /** The precision (in angstroms) to which coordinates are stored */
+    double prec;
+};
+
+/** This class reads trajectories written by CompressedTrajectoryWriter.
+    An index of the frames is built when the file is opened, so that
+    individual frames can be read in any order without reading the
+    rest of the file.
+
+    @author Christopher Woods
+*/
+class SIREIO_EXPORT CompressedTrajectoryReader : public boost::noncopyable
+{
+public:
+    CompressedTrajectoryReader(const QString &filename);
+    
+    ~CompressedTrajectoryReader();
+    
+    static const char* typeName();
+    const char* what() const;
+    
+    QString toString() const;
+    
+    QString filename() const;
+    
+    int nAtoms() const;
+    int nFrames() const;
+    
+    double precision() const;
+    
+    int refresh();
+    
+    double time(int frame) const;
+    
+    QVector<Vector> coordinates(int frame) const;
+    
+    bool hasBox(int frame) const;
+    
+    Vector boxDimensions(int frame) const;
+    Vector boxAngles(int frame) const;
+
+private:
+    QByteArray readFrame(int frame) const;
+
+    /** The file being read */
+    mutable QFile f;
+    
+    /** The position in the file of the start of each frame */
+    QVector<qint64> frame_starts;
+    
+    /** The number of atoms in each frame */
+    qint32 natoms;
+    
+    /** The precision (in angstroms) to which coordinates are stored */
+    double prec;
+};
+
+}
+
+SIRE_EXPOSE_CLASS( SireIO::CompressedTrajectoryWriter )
+SIRE_EXPOSE_CLASS( SireIO::CompressedTrajectoryReader )
+
+SIRE_END_HEADER
+
+#endif
@@ -689,6 +689,26 @@ QStringList Gro87::formatSuffix() const
     return suffixes;
 }
 
+/** Return the confidence that the file starting with 'prefix' is a
+    Gro87 file. The second line of these files contains only the
+    number of atoms */
+double Gro87::sniff(const QByteArray &prefix) const
+{
+    const auto lines = MoleculeParser::prefixLines(prefix, 3);
+
+    if (lines.count() < 2)
+        return 0.0;
+
+    bool ok;
+    const int natoms = lines[1].trimmed().toInt(&ok);
+
+    if (ok and natoms >= 0)
+        //Amber rst7 files can look the same
+        return 0.7;
+    else
+        return 0.0;
+}
+
 /** Function that is called to assert that this object is sane. This
     should raise an exception if the parser is in an invalid state */
 void Gro87::assertSane() const
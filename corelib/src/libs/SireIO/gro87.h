@@ -101,6 +101,8 @@ public:
     QString formatDescription() const;
     QStringList formatSuffix() const;
 
+    double sniff(const QByteArray &prefix) const;
+
     QString title() const;
 
     double time() const;
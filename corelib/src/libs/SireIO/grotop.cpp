@@ -2479,6 +2479,46 @@ QStringList GroTop::formatSuffix() const
     return suffixes;
 }
 
+/** Return the confidence that the file starting with 'prefix' is a
+    Gromacs topology file. These contain directives in square brackets
+    (e.g. "[ moleculetype ]"), and are often made only of comments and
+    #include statements */
+double GroTop::sniff(const QByteArray &prefix) const
+{
+    bool has_directive = false;
+    bool has_include = false;
+    
+    for (const auto &line : MoleculeParser::prefixLines(prefix))
+    {
+        //remove any comment (e.g. "[ atoms ] ; the atoms")
+        const int comment = line.indexOf(';');
+        
+        const auto l = (comment == -1) ? line.trimmed() : line.left(comment).trimmed();
+        
+        if (l.isEmpty())
+            continue;
+        
+        if (l.startsWith('['))
+        {
+            if (not l.endsWith(']'))
+                return 0.0;
+            
+            has_directive = true;
+        }
+        else if (l.startsWith("#include"))
+        {
+            has_include = true;
+        }
+    }
+    
+    if (has_directive)
+        return 0.9;
+    else if (has_include)
+        return 0.6;
+    else
+        return 0.0;
+}
+
 /** Function that is called to assert that this object is sane. This
     should raise an exception if the parser is in an invalid state */
 void GroTop::assertSane() const
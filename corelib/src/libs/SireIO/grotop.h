@@ -378,6 +378,8 @@ public:
     QString formatDescription() const;
     QStringList formatSuffix() const;
 
+    double sniff(const QByteArray &prefix) const;
+
     int nonBondedFunctionType() const;
     int combiningRules() const;
     double fudgeLJ() const;
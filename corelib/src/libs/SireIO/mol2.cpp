@@ -1925,6 +1925,16 @@ QStringList Mol2::formatSuffix() const
     return suffixes;
 }
 
+/** Return the confidence that the file starting with 'prefix' is a
+    Mol2 file. These contain "@<TRIPOS>" record types */
+double Mol2::sniff(const QByteArray &prefix) const
+{
+    if (prefix.contains("@<TRIPOS>"))
+        return 1.0;
+    else
+        return 0.0;
+}
+
 /** Return the number of molecules in the system. */
 int Mol2::nMolecules() const
 {
@@ -27,6 +27,7 @@
 \*********************************************/
 
 #include "moleculeparser.h"
+#include "textfileview.h"
 
 #include "SireError/errors.h"
 #include "SireIO/errors.h"
@@ -181,6 +182,33 @@ namespace detail
         return QString("Parser( %1 : %2 )").arg(formatName()).arg(formatDescription());
     }
 
+    /** Return the confidence (from 0 to 1) that the file that starts
+        with 'prefix' can be parsed by this parser */
+    double ParserFactoryHelper::sniff(const QByteArray &prefix) const
+    {
+        if (isValid())
+        {
+            return parser->sniff(prefix);
+        }
+        else
+        {
+            return 0;
+        }
+    }
+
+    /** Return whether or not this parser reads text files */
+    bool ParserFactoryHelper::isTextFile() const
+    {
+        if (isValid())
+        {
+            return parser->isTextFile();
+        }
+        else
+        {
+            return false;
+        }
+    }
+
     /** Return all of the suffixes recognised by this parser, in their order
         of preference */
     QStringList ParserFactoryHelper::suffixes() const
@@ -384,6 +412,10 @@ namespace detail
 
 Q_GLOBAL_STATIC( SireIO::detail::ParserFactory, getParserFactory );
 
+/** The number of bytes at the start of a file that are passed to
+    MoleculeParser::sniff */
+static const int prefix_size = 16384;
+
 /** This registers a ParserFactoryHelper with the ParserFactory for the
     specified parser */
 SireIO::detail::ParserFactoryHelper::ParserFactoryHelper(MoleculeParser *p)
@@ -480,7 +512,10 @@ Q_GLOBAL_STATIC( FileContentsCache, getFileCache );
 
 /** Internal function that can be used by the parsers to read the contents
     of a text file into memory. This uses a cache to ensure that every file
-    is read only once */
+    is read only once. The file is memory-mapped and indexed using a
+    TextFileView, and the lines are then converted to QStrings in parallel.
+    Note that every line is still converted, as the parsers hold their
+    lines as QStrings so that they can be written, streamed and compared */
 QVector<QString> MoleculeParser::readTextFile(QString filename)
 {
     filename = QFileInfo(filename).absoluteFilePath();
@@ -490,25 +525,7 @@ QVector<QString> MoleculeParser::readTextFile(QString filename)
     if (not lines.isEmpty())
         return lines;
 
-    QFile file(filename);
-
-    if (not file.open(QIODevice::ReadOnly | QIODevice::Unbuffered))
-    {
-        throw SireError::file_error(file, CODELOC);
-    }
-
-    QTextStream ts(&file);
-
-    QStringList l;
-
-    while (not ts.atEnd())
-    {
-        l.append( ts.readLine() );
-    }
-
-    file.close();
-
-    lines = l.toVector();
+    lines = TextFileView(filename).toLines();
 
     if (not lines.isEmpty())
         getFileCache()->save(filename, lines);
@@ -723,10 +740,116 @@ void MoleculeParser::writeToFile(const QString &filename) const
     f.close();
 }
 
+/** Internal function used to fully parse the file 'filename' using each of
+    the passed factories (in parallel if 'run_parallel' is true). Parsers that
+    succeed are added to 'parsers' (indexed by score), while the errors from
+    those that fail are added to 'errors' */
+static void tryParsers(const QString &filename, const PropertyMap &map,
+                       const QList<SireIO::detail::ParserFactoryHelper> &factories,
+                       bool run_parallel,
+                       QMap<float,MoleculeParserPtr> &parsers, QStringList &errors)
+{
+    QVector<MoleculeParserPtr> results( factories.count() );
+    QVector<bool> succeeded( factories.count(), false );
+    QVector<QStringList> result_errors( factories.count() );
+
+    auto try_parser = [&](int i)
+    {
+        const auto &factory = factories[i];
+
+        try
+        {
+            const auto parser = factory.construct(filename, map);
+
+            if (parser.read().score() <= 0)
+            {
+                result_errors[i].append( QObject::tr("Failed to parse '%1' with parser '%2' "
+                   "as this file is not recognised as being of the required format.")
+                                .arg(filename).arg(factory.formatName()) );
+            }
+            else
+            {
+                results[i] = parser;
+                succeeded[i] = true;
+            }
+        }
+        catch(const SireError::exception &e)
+        {
+            result_errors[i].append( QObject::tr("Failed to parse '%1' with parser '%2'")
+                                .arg(filename).arg(factory.formatName()) );
+            result_errors[i].append( e.error() );
+        }
+    };
+
+    if (run_parallel and factories.count() > 1)
+    {
+        tbb::parallel_for( tbb::blocked_range<int>(0,factories.count()),
+                           [&](const tbb::blocked_range<int> &r)
+        {
+            for (int i=r.begin(); i<r.end(); ++i)
+            {
+                try_parser(i);
+            }
+        });
+    }
+    else
+    {
+        for (int i=0; i<factories.count(); ++i)
+        {
+            try_parser(i);
+        }
+    }
+
+    for (int i=0; i<factories.count(); ++i)
+    {
+        if (succeeded[i])
+        {
+            parsers.insert(results[i].read().score(), results[i]);
+        }
+
+        errors += result_errors[i];
+    }
+}
+
+/** Internal function that groups the passed factories by the confidence
+    (from MoleculeParser::sniff) that they can parse the file that starts
+    with 'prefix'. The groups are returned in order of decreasing confidence,
+    with the parsers that are certain that they cannot parse the file 
+    in the last group */
+static QList< QList<SireIO::detail::ParserFactoryHelper> > rankParsers(
+                        const QList<SireIO::detail::ParserFactoryHelper> &factories,
+                        const QByteArray &prefix)
+{
+    QMap< double,QList<SireIO::detail::ParserFactoryHelper> > ranked;
+
+    for (const auto &factory : factories)
+    {
+        ranked[ qMax(factory.sniff(prefix), 0.0) ].append(factory);
+    }
+
+    QList< QList<SireIO::detail::ParserFactoryHelper> > groups;
+
+    for (auto it = ranked.constEnd(); it != ranked.constBegin(); )
+    {
+        --it;
+        groups.append(it.value());
+    }
+
+    return groups;
+}
+
 /** Internal function that actually tries to parse the supplied file with name
-    'filename'. This will try to find a parser based on suffix, but if that fails,
-    it will try all parsers. It will choose the parser that doesn't raise an error
-    that scores highest. */
+    'filename'. The start of the file is read once, and every parser is asked
+    (via MoleculeParser::sniff) how confident it is that it could parse the file.
+    Parsers that are associated with the suffix of the file are always tried 
+    first, whatever their confidence, so that a misjudged sniff can never let
+    another parser take the file. Within the suffix parsers, and then within
+    all of the other parsers, the parsers are tried in order of decreasing 
+    confidence, with only the parsers that share the highest remaining 
+    confidence being fully parsed (in parallel) at each step, and parsers that
+    are certain that they cannot parse the file coming last. The text of the 
+    file is read only once, and is shared by all of the parsers that are tried.
+    This returns the parser that doesn't raise an error that scores highest */
 MoleculeParserPtr MoleculeParser::_pvt_parse(const QString &filename,
                                              const PropertyMap &map)
 {
@@ -739,97 +862,94 @@ MoleculeParserPtr MoleculeParser::_pvt_parse(const QString &filename,
                     .arg(filename), CODELOC );
     }
 
-    //try to find the right parser based on the suffix
-    QString suffix = info.suffix();
-
-    QStringList errors;
-    QMap<float,MoleculeParserPtr> parsers;
+    bool run_parallel = true;
 
-    if (not suffix.isEmpty())
+    if (map["parallel"].hasValue())
     {
-        for (auto factory : getParserFactory()->factoriesForSuffix(suffix))
-        {
-            try
-            {
-                const auto parser = factory.construct(filename, map);
+        run_parallel = map["parallel"].value().asA<BooleanProperty>().value();
+    }
 
-                if (parser.read().score() <= 0)
-                {
-                    errors.append( QObject::tr("Failed to parse '%1' with parser '%2' "
-                       "as this file is not recognised as being of the required format.")
-                                    .arg(filename).arg(factory.formatName()) );
-                }
-                else
-                {
-                    parsers.insert(parser.read().score(), parser);
-                }
-            }
-            catch(const SireError::exception &e)
-            {
-                errors.append( QObject::tr("Failed to parse '%1' with parser '%2'")
-                                .arg(filename).arg(factory.formatName()) );
-                errors.append( e.error() );
-            }
-        }
+    //read the start of the file once, so that it can be sniffed by every parser
+    QByteArray prefix;
 
-        if (not parsers.isEmpty())
+    {
+        QFile f(filename);
+
+        if (not f.open(QIODevice::ReadOnly))
         {
-            //return the parser with the highest score
-            return parsers.last();
+            throw SireError::file_error(f, CODELOC);
         }
+
+        prefix = f.read(prefix_size);
+        f.close();
     }
 
-    //none of the tested parsers worked, so let's now try all of the parsers
-    for (auto factory : getParserFactory()->factoriesExcludingSuffix(suffix))
+    QString suffix = info.suffix();
+
+    //work out the order in which the parsers should be tried
+    QList< QList<detail::ParserFactoryHelper> > groups;
+
+    if (not suffix.isEmpty())
     {
-        try
-        {
-            const auto parser = factory.construct(filename, map);
+        groups = ::rankParsers( getParserFactory()->factoriesForSuffix(suffix), prefix );
+    }
 
-            if (parser.read().score() <= 0)
-            {
-                errors.append( QObject::tr("Failed to parse '%1' with parser '%2' "
-                       "as this file is not recognised as being of the required format.")
-                                    .arg(filename).arg(factory.formatName()) );
-            }
-            else
+    groups += ::rankParsers( getParserFactory()->factoriesExcludingSuffix(suffix), prefix );
+
+    //read the text of the file into the file cache before any text
+    //parser is constructed, so that the parsers (which may run in parallel)
+    //all share the same lines, rather than each reading the file again
+    bool read_lines = false;
+
+    auto load_lines = [&](const QList<detail::ParserFactoryHelper> &factories)
+    {
+        if (read_lines)
+            return;
+
+        for (const auto &factory : factories)
+        {
+            if (factory.isTextFile())
             {
-                parsers.insert(parser.read().score(), parser);
+                MoleculeParser::readTextFile(filename);
+                read_lines = true;
+                return;
             }
         }
-        catch(const SireError::exception &e)
+    };
+
+    QStringList errors;
+    QMap<float,MoleculeParserPtr> parsers;
+
+    for (const auto &group : groups)
+    {
+        load_lines(group);
+        ::tryParsers(filename, map, group, run_parallel, parsers, errors);
+
+        if (not parsers.isEmpty())
         {
-            errors.append( QObject::tr("Failed to parse '%1' with parser '%2'")
-                            .arg(filename).arg(factory.formatName()) );
-            errors.append( e.error() );
+            //return the parser with the highest score
+            return parsers.last();
         }
     }
 
-    if (not parsers.isEmpty())
+    if (suffix.isEmpty())
     {
-        return parsers.last();
+        throw SireIO::parse_error( QObject::tr(
+                "There are no parsers available that can parse the file '%1'\n"
+                "Errors reported by individual parsers are:\n\n%2\n")
+                    .arg(filename).arg(errors.join("\n\n")), CODELOC );
     }
     else
     {
-        if (suffix.isEmpty())
-        {
-            throw SireIO::parse_error( QObject::tr(
-                    "There are no parsers available that can parse the file '%1'\n"
-                    "Errors reported by individual parsers are:\n\n%2\n")
-                        .arg(filename).arg(errors.join("\n\n")), CODELOC );
-        }
-        else
-        {
-            throw SireIO::parse_error( QObject::tr(
-                    "There are no parsers available that can parser the file '%1'. "
-                    "All parsers were tried, including those that were associated with "
-                    "the extension of this file. Errors reported "
-                    "by individual parsers are:\n\n%2\n")
-                        .arg(filename).arg(errors.join("\n\n")), CODELOC );
-        }
-
-        return MoleculeParserPtr();
+        throw SireIO::parse_error( QObject::tr(
+                "There are no parsers available that can parser the file '%1'. "
+                "All parsers were tried, including those that were associated with "
+                "the extension of this file. Errors reported "
+                "by individual parsers are:\n\n%2\n")
+                    .arg(filename).arg(errors.join("\n\n")), CODELOC );
     }
+
+    return MoleculeParserPtr();
 }
 
 /** Parse the passed file, returning the resulting Parser. This employs a lot
@@ -970,6 +1090,50 @@ QStringList MoleculeParser::formatSuffix() const
     return QStringList( this->formatName().toLower() );
 }
 
+/** Return the confidence (from 0 to 1) that a file that starts with the
+    passed bytes can be parsed by this parser. This is used to cheaply choose
+    which parsers should try to fully parse a file. 'prefix' contains the
+    first few kilobytes of the file (or the whole file if it is small).
+    A value of 0 means that the file is definitely not in this format,
+    while 1 means that it definitely is. The default implementation
+    returns 0.5 (don't know), so that the file will be fully parsed */
+double MoleculeParser::sniff(const QByteArray&) const
+{
+    return 0.5;
+}
+
+/** Internal function that can be used by sniff to split the passed prefix
+    into lines. The last line is dropped if it may have been cut short.
+    Only the first 'max_lines' lines are returned if 'max_lines' is positive */
+QList<QByteArray> MoleculeParser::prefixLines(const QByteArray &prefix, int max_lines)
+{
+    QList<QByteArray> lines = prefix.split('\n');
+
+    if (prefix.count() >= prefix_size and not lines.isEmpty())
+    {
+        //the last line was probably cut short
+        lines.removeLast();
+    }
+
+    if (max_lines > 0)
+    {
+        while (lines.count() > max_lines)
+        {
+            lines.removeLast();
+        }
+    }
+
+    for (auto &line : lines)
+    {
+        if (line.endsWith('\r'))
+        {
+            line.chop(1);
+        }
+    }
+
+    return lines;
+}
+
 /** This returns a human readable set of lines describing the formats supported
     by MoleculeParser. Each line is formatted as "extension : description" where
     extension is the unique extension of the file used by MoleculeParser, and
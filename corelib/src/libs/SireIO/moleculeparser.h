@@ -84,6 +84,10 @@ namespace detail
 
         QString toString() const;
 
+        double sniff(const QByteArray &prefix) const;
+
+        bool isTextFile() const;
+
         MoleculeParserPtr construct(const QString &filename,
                                     const PropertyMap &map) const;
 
@@ -213,6 +217,8 @@ public:
 
     virtual QStringList formatSuffix() const;
 
+    virtual double sniff(const QByteArray &prefix) const;
+
     double score() const;
 
     void enableParallel();
@@ -253,6 +259,8 @@ protected:
 
     static QVector<QString> readTextFile(QString filename);
 
+    static QList<QByteArray> prefixLines(const QByteArray &prefix, int max_lines = -1);
+
     virtual SireBase::PropertyPtr getForceField(const SireSystem::System &system,
                                                 const PropertyMap &map) const;
 
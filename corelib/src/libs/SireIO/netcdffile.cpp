@@ -1088,6 +1088,47 @@ NetCDFFile::NetCDFFile(const QString &filename, bool overwrite_file,
     #endif
 }
 
+/** Construct to create the file 'filename' for streaming output. The passed
+    global attributes and data are written to the file, with the dimension
+    called 'record_dimension' created as the unlimited (record) dimension.
+    Any data whose first dimension is the record dimension can then be
+    appended to the file (e.g. frame by frame) via NetCDFFile::append.
+    The file is kept open until it is closed or this object is deleted.
+    The other arguments are as for NetCDFFile::write */
+NetCDFFile::NetCDFFile(const QString &filename,
+                       const QHash<QString,QString> &globals,
+                       const QHash<QString,NetCDFData> &data,
+                       const QString &record_dimension,
+                       bool overwrite_file, bool use_64bit_offset, bool use_netcdf4)
+           : NetCDFFile(filename, overwrite_file, use_64bit_offset, use_netcdf4)
+{
+    #ifdef SIRE_USE_NETCDF
+        try
+        {
+            var_ids = this->defineData(globals, data, record_dimension);
+        
+            QStringList variables = data.keys();
+            qSort(variables);
+            
+            for (const auto variable : variables)
+            {
+                const auto vardata = data[variable];
+                const auto dims = vardata.dimensions();
+                
+                this->putData(vardata, var_ids.value(variable,-1),
+                              (not dims.isEmpty() and dims[0] == record_dimension) ? 0 : -1);
+            }
+            
+            call_netcdf_function( [&](){ return nc_sync(hndl); } );
+        }
+        catch(...)
+        {
+            this->close();
+            throw;
+        }
+    #endif
+}
+
 /** Destructor - this will close the NetCDFFile */
 NetCDFFile::~NetCDFFile()
 {
@@ -1209,10 +1250,18 @@ QHash<QString,NetCDFDataInfo> NetCDFFile::getVariablesInfo() const
     return vars;
 }
 
-/** Write all of the passed data to the file */
-void NetCDFFile::writeData(const QHash<QString,QString> &globals,
-                           const QHash<QString,NetCDFData> &variable_data)
+/** Internal function used to define all of the dimensions, variables and
+    attributes of the passed data in the file, returning the IDs of all
+    of the variables. If 'record_dimension' is not empty, then the dimension
+    with this name is created as the unlimited (record) dimension, so that
+    data can later be appended along it. This leaves the file in data mode */
+QHash<QString,int> NetCDFFile::defineData(const QHash<QString,QString> &globals,
+                                          const QHash<QString,NetCDFData> &variable_data,
+                                          const QString &record_dimension)
 {
+    //map of variable info names to IDs
+    QHash<QString,int> var_ids;
+
     if (hndl != -1)
     {
     #ifdef SIRE_USE_NETCDF
@@ -1225,9 +1274,6 @@ void NetCDFFile::writeData(const QHash<QString,QString> &globals,
         //map of dimension names to IDs
         QHash<QString,int> dimension_ids;
         
-        //map of variable info names to IDs
-        QHash<QString,int> var_ids;
-        
         //first we have to set up the NetCDF file, so get all of the
         //dimensions, variables and attributes
         {
@@ -1275,8 +1321,12 @@ void NetCDFFile::writeData(const QHash<QString,QString> &globals,
                                 .arg(NC_MAX_NAME), CODELOC );
                 }
                 
+                //the record dimension is unlimited, so that data can be appended
+                const size_t dim_len = (dim == record_dimension) ? NC_UNLIMITED
+                                                                 : dimensions[dim];
+                
                 call_netcdf_function( [&](){ return nc_def_dim(hndl, c_dim.constData(),
-                                                               dimensions[dim], &idp); } );
+                                                               dim_len, &idp); } );
                 
                 dimension_ids.insert(dim, idp);
             }
@@ -1407,15 +1457,69 @@ void NetCDFFile::writeData(const QHash<QString,QString> &globals,
         //we have finished writing the metadata about the file
         call_netcdf_function( [&](){ return nc_enddef(hndl); } );
         
-        //now that the metadata has been written, we can now write the actual data
-        for (const auto variable : variables)
-        {
-            const auto vardata = variable_data[variable];
-            
-            const int id = var_ids.value(variable, -1);
+    #endif
+    }
+    
+    return var_ids;
+}
+
+/** Internal function used to write the passed data to the variable with
+    ID 'id'. If 'first_record' is not negative, then the variable is
+    a record variable, and the data is written as a hyperslab starting
+    from record 'first_record' (with the number of records given by
+    the size of the first dimension of the data) */
+void NetCDFFile::putData(const NetCDFData &vardata, int id, int first_record)
+{
+    if (hndl == -1)
+        return;
 
+    #ifdef SIRE_USE_NETCDF
+        if (first_record < 0)
+        {
             call_netcdf_function( [&](){
                 return nc_put_var( hndl, id, vardata.memdata.constData() ); } );
+            return;
+        }
+    
+        const auto dim_sizes = vardata.dimensionSizes();
+        
+        if (dim_sizes.isEmpty() or dim_sizes[0] == 0)
+            //there are no records to write
+            return;
+        
+        QVarLengthArray<size_t,8> start;
+        QVarLengthArray<size_t,8> count;
+        
+        for (int i=0; i<dim_sizes.count(); ++i)
+        {
+            start.append(0);
+            count.append(dim_sizes[i]);
+        }
+        
+        start[0] = first_record;
+        
+        call_netcdf_function( [&](){
+            return nc_put_vara( hndl, id, start.constData(), count.constData(),
+                                vardata.memdata.constData() ); } );
+    #endif
+}
+
+/** Write all of the passed data to the file */
+void NetCDFFile::writeData(const QHash<QString,QString> &globals,
+                           const QHash<QString,NetCDFData> &variable_data)
+{
+    if (hndl != -1)
+    {
+    #ifdef SIRE_USE_NETCDF
+        const auto ids = this->defineData(globals, variable_data, QString());
+        
+        //now that the metadata has been written, we can now write the actual data
+        QStringList variables = variable_data.keys();
+        qSort(variables);
+        
+        for (const auto variable : variables)
+        {
+            this->putData(variable_data[variable], ids.value(variable,-1), -1);
         }
         
         //finished writing the file :-)
@@ -1583,3 +1687,252 @@ NetCDFData NetCDFFile::read(const NetCDFDataInfo &variable) const
     
     return data;
 }
+
+/** Read in and return 'count' records of the passed variable, starting from
+    record 'start'. Records are indexed along the first dimension of
+    the variable (normally the unlimited, record dimension, e.g. the frames
+    of a trajectory). This lets large variables be read in bounded
+    memory, e.g. one frame at a time */
+NetCDFData NetCDFFile::read(const NetCDFDataInfo &variable, int start, int count) const
+{
+    if (variable.dim_sizes.isEmpty())
+    {
+        throw SireError::invalid_arg( QObject::tr(
+                "Cannot read records of the variable '%1' in NetCDF file '%2' as "
+                "this is a scalar variable.")
+                    .arg(variable.name()).arg(fname), CODELOC );
+    }
+
+    NetCDFData data(variable);
+    
+    #ifdef SIRE_USE_NETCDF
+    if (hndl != -1)
+    {
+        //find the current number of records, as this may have changed since
+        //the variable info was read (e.g. if the file is being appended to)
+        int dimids[NC_MAX_VAR_DIMS];
+        call_netcdf_function( [&](){ return nc_inq_vardimid(hndl, variable.ID(), dimids); } );
+        
+        size_t nrecords;
+        call_netcdf_function( [&](){ return nc_inq_dimlen(hndl, dimids[0], &nrecords); } );
+        
+        if (start < 0 or count < 0 or size_t(start + count) > nrecords)
+        {
+            throw SireError::invalid_index( QObject::tr(
+                    "Cannot read records %1 to %2 of the variable '%3' in NetCDF "
+                    "file '%4' as the number of records is %5.")
+                        .arg(start).arg(start+count-1).arg(variable.name())
+                        .arg(fname).arg(nrecords), CODELOC );
+        }
+        
+        data.dim_sizes[0] = count;
+        
+        const int data_size = data.dataSize();
+        
+        if (data_size > 0)
+        {
+            QVarLengthArray<size_t,8> starts;
+            QVarLengthArray<size_t,8> counts;
+            
+            for (int i=0; i<data.dim_sizes.count(); ++i)
+            {
+                starts.append(0);
+                counts.append(data.dim_sizes[i]);
+            }
+            
+            starts[0] = start;
+        
+            QByteArray memdata;
+            memdata.fill('\0', data_size);
+            call_netcdf_function( [&](){ return nc_get_vara(hndl, variable.ID(),
+                                                            starts.constData(),
+                                                            counts.constData(),
+                                                            memdata.data()); } );
+            data.setData(memdata);
+        }
+        else
+        {
+            data.setData( QByteArray() );
+        }
+    }
+    #else
+        Q_UNUSED(start);
+        Q_UNUSED(count);
+    #endif
+    
+    return data;
+}
+
+/** Return the current number of records (the size of the unlimited dimension)
+    in the file. This returns 0 if there is no unlimited dimension */
+int NetCDFFile::nRecords() const
+{
+    #ifdef SIRE_USE_NETCDF
+    if (hndl != -1)
+    {
+        int unlimdim;
+        call_netcdf_function( [&](){ return nc_inq_unlimdim(hndl, &unlimdim); } );
+        
+        if (unlimdim == -1)
+            return 0;
+        
+        size_t nrecords;
+        call_netcdf_function( [&](){ return nc_inq_dimlen(hndl, unlimdim, &nrecords); } );
+        
+        return int(nrecords);
+    }
+    #endif
+    
+    return 0;
+}
+
+/** Reopen this file (which must already exist, and have been opened
+    for reading) so that data can be appended to it along its record
+    dimension, e.g. to continue writing a trajectory */
+void NetCDFFile::openForAppending()
+{
+    if (hndl == -1)
+    {
+        throw SireError::io_error( QObject::tr(
+                "Cannot open the NetCDF file '%1' for appending as it is not open.")
+                    .arg(fname), CODELOC );
+    }
+
+    #ifdef SIRE_USE_NETCDF
+        {
+            QMutexLocker lkr(&mutex);
+            nc_close(hndl);
+            hndl = -1;
+        }
+    
+        QByteArray c_filename = fname.toUtf8();
+        call_netcdf_function(
+            [&](){ return nc_open(c_filename.constData(), NC_WRITE, &hndl); }
+                            );
+    
+        var_ids.clear();
+    
+        for (const auto info : this->getVariablesInfo())
+        {
+            var_ids.insert(info.name(), info.ID());
+        }
+    #endif
+}
+
+/** Append the passed data to the end of the file. This is only possible
+    for files created for streaming output. All of the passed variables must
+    already exist in the file, must have the record dimension as their
+    first dimension, and must all contain the same number of records */
+void NetCDFFile::append(const QHash<QString,NetCDFData> &data)
+{
+    if (data.isEmpty())
+        return;
+
+    if (hndl == -1)
+    {
+        throw SireError::io_error( QObject::tr(
+                "Cannot append data to the NetCDF file '%1' as it is not open.")
+                    .arg(fname), CODELOC );
+    }
+
+    #ifdef SIRE_USE_NETCDF
+        int unlimdim;
+        call_netcdf_function( [&](){ return nc_inq_unlimdim(hndl, &unlimdim); } );
+
+        char dim_name[NC_MAX_NAME+1];
+        
+        if (unlimdim != -1)
+        {
+            call_netcdf_function( [&](){ return nc_inq_dimname(hndl, unlimdim, dim_name); } );
+        }
+
+        QStringList variables = data.keys();
+        qSort(variables);
+        
+        int nrecords = -1;
+        
+        //check all of the data before writing anything
+        for (const auto variable : variables)
+        {
+            const auto vardata = data[variable];
+            
+            if (not var_ids.contains(variable))
+            {
+                throw SireError::invalid_key( QObject::tr(
+                        "Cannot append the variable '%1' to the NetCDF file '%2' as "
+                        "it does not exist in the file, or the file was not opened "
+                        "for streaming output. Variables are %3.")
+                            .arg(variable).arg(fname)
+                            .arg(QStringList(var_ids.keys()).join(", ")), CODELOC );
+            }
+            
+            const auto dims = vardata.dimensions();
+            
+            if (unlimdim == -1 or dims.isEmpty() or dims[0] != QString::fromUtf8(dim_name))
+            {
+                throw SireError::incompatible_error( QObject::tr(
+                        "Cannot append the variable '%1' to the NetCDF file '%2' "
+                        "as its first dimension is not the record dimension. "
+                        "Dimensions are %3.")
+                            .arg(variable).arg(fname)
+                            .arg(dims.join(", ")), CODELOC );
+            }
+            
+            const int n = vardata.dimensionSizes()[0];
+            
+            if (nrecords == -1)
+            {
+                nrecords = n;
+            }
+            else if (n != nrecords)
+            {
+                throw SireError::incompatible_error( QObject::tr(
+                        "Cannot append the variable '%1' to the NetCDF file '%2' "
+                        "as the number of records (%3) is not the same as for the "
+                        "other variables (%4).")
+                            .arg(variable).arg(fname).arg(n).arg(nrecords), CODELOC );
+            }
+        }
+        
+        const int first_record = this->nRecords();
+        
+        for (const auto variable : variables)
+        {
+            this->putData(data[variable], var_ids.value(variable), first_record);
+        }
+    #endif
+}
+
+/** Flush all data written to the file to disk, and (for files that are
+    being read) update the file to show data appended by other writers */
+void NetCDFFile::sync()
+{
+    #ifdef SIRE_USE_NETCDF
+    if (hndl != -1)
+    {
+        call_netcdf_function( [&](){ return nc_sync(hndl); } );
+    }
+    #endif
+}
+
+/** Close the file. Nothing can be read from or written to the file after
+    it has been closed */
+void NetCDFFile::close()
+{
+    #ifdef SIRE_USE_NETCDF
+    if (hndl != -1)
+    {
+        QMutexLocker lkr(&mutex);
+        nc_close(hndl);
+        hndl = -1;
+    }
+    #endif
+    
+    var_ids.clear();
+}
+
+/** Return whether or not the file is open */
+bool NetCDFFile::isOpen() const
+{
+    return hndl != -1;
+}
@@ -227,6 +227,11 @@ private:
 
 /** This class provides an internal interface to NetCDF files 
 
+    As well as reading and writing whole variables, this supports
+    streaming of data along the record (unlimited) dimension, e.g.
+    reading and appending one frame of a trajectory at a time,
+    so that the whole file never needs to be held in memory.
+
     @author Christopher Woods
 */
 class SIREIO_EXPORT NetCDFFile : public boost::noncopyable
@@ -236,6 +241,14 @@ public:
 
     NetCDFFile(const QString &filename);
     
+    NetCDFFile(const QString &filename,
+               const QHash<QString,QString> &globals,
+               const QHash<QString,NetCDFData> &data,
+               const QString &record_dimension,
+               bool overwrite_file=true,
+               bool use_64bit_offset=true,
+               bool use_netcdf4=false);
+    
     ~NetCDFFile();
     
     static QString write(const QString &filename,
@@ -252,6 +265,19 @@ public:
     QHash<QString,NetCDFDataInfo> getVariablesInfo() const;
     
     NetCDFData read(const NetCDFDataInfo &variable) const;
+    
+    NetCDFData read(const NetCDFDataInfo &variable, int start, int count) const;
+
+    int nRecords() const;
+
+    void openForAppending();
+
+    void append(const QHash<QString,NetCDFData> &data);
+
+    void sync();
+    void close();
+
+    bool isOpen() const;
 
 private:
     NetCDFFile(const QString &filename, bool overwrite_file,
@@ -259,6 +285,12 @@ private:
 
     void writeData(const QHash<QString,QString> &globals, const QHash<QString,NetCDFData> &data);
 
+    QHash<QString,int> defineData(const QHash<QString,QString> &globals,
+                                  const QHash<QString,NetCDFData> &data,
+                                  const QString &record_dimension);
+
+    void putData(const NetCDFData &data, int id, int first_record);
+
     int call_netcdf_function( std::function<int()> func,
                               int ignored_error = 0) const;
 
@@ -270,6 +302,9 @@ private:
     
     /** Mutex to serialise all file IO operations */
     QMutex mutex;
+
+    /** The IDs of all of the variables in a file opened for streaming output */
+    QHash<QString,int> var_ids;
 };
 
 #ifndef SIRE_SKIP_INLINE_FUNCTIONS
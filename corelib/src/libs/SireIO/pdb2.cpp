@@ -1115,6 +1115,39 @@ QStringList PDB2::formatSuffix() const
     return suffixes;
 }
 
+/** Return the confidence that the file starting with 'prefix' is a
+    PDB file. This looks for the common PDB record names at the
+    start of the lines */
+double PDB2::sniff(const QByteArray &prefix) const
+{
+    static const char* records[] = { "ATOM  ", "HETATM", "HEADER", "REMARK", "CRYST1",
+                                     "MODEL ", "TITLE ", "COMPND", "SEQRES", "ORIGX1",
+                                     "SCALE1", 0 };
+
+    const auto lines = MoleculeParser::prefixLines(prefix);
+
+    int nrecords = 0;
+
+    for (const auto &line : lines)
+    {
+        for (int i=0; records[i] != 0; ++i)
+        {
+            if (line.startsWith(records[i]))
+            {
+                nrecords += 1;
+                break;
+            }
+        }
+    }
+
+    if (nrecords == 0)
+        return 0.0;
+    else if (2*nrecords >= lines.count())
+        return 0.9;
+    else
+        return 0.4;
+}
+
 /** Return whether or not this is a lead parser. The lead parser is responsible
     for starting the process of turning the parsed file into the System. There
     must be one and one-only lead parser in a set of parsers creating a System */
@@ -250,6 +250,8 @@ public:
     QString formatDescription() const;
     QStringList formatSuffix() const;
 
+    double sniff(const QByteArray &prefix) const;
+
     bool isLead() const;
 
     int nMolecules() const;
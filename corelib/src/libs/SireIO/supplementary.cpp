@@ -221,6 +221,14 @@ QStringList Supplementary::formatSuffix() const
     return suffixes;
 }
 
+/** Supplementary files can contain almost anything, so this parser can
+    never recognise one. Returning 0 means that it is only tried once all
+    of the other parsers have been tried */
+double Supplementary::sniff(const QByteArray&) const
+{
+    return 0.0;
+}
+
 /** Return whether or not this parser can follow another lead parser, and add
     data to an existing molecular system. The Supplementary parser cannot follow. */
 bool Supplementary::canFollow() const
@@ -0,0 +1,532 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "SireIO/ambertrajectory.h"
+#include "SireIO/netcdffile.h"
+#include "SireIO/errors.h"
+
+#include "SireMaths/rangenerator.h"
+
+#include "SireError/errors.h"
+
+#include "SireBase/unittest.h"
+
+#include <QTemporaryDir>
+#include <QDebug>
+
+#include <cmath>
+
+using namespace SireIO;
+using namespace SireMaths;
+using namespace SireBase;
+
+#ifdef SIRE_USE_NETCDF
+
+/** The number of atoms in each frame */
+static const int natoms = 25;
+
+/** The number of frames in each trajectory */
+static const int nframes = 12;
+
+/** The frames that are written to, and read back from, the trajectories */
+struct Frames
+{
+    QVector<double> times;
+    QVector< QVector<Vector> > coords;
+    QVector< QVector<Vector> > vels;
+    QVector< QVector<Vector> > frcs;
+    QVector<Vector> box_dims;
+    QVector<Vector> box_angs;
+};
+
+static QVector<Vector> randomVectors(RanGenerator &rand, double range)
+{
+    QVector<Vector> vectors(natoms);
+
+    for (int i=0; i<natoms; ++i)
+    {
+        vectors[i] = Vector( rand.rand(-range,range), rand.rand(-range,range),
+                             rand.rand(-range,range) );
+    }
+
+    return vectors;
+}
+
+static Frames randomFrames(RanGenerator &rand)
+{
+    Frames frames;
+
+    for (int i=0; i<nframes; ++i)
+    {
+        frames.times.append(0.5*i);
+        frames.coords.append( randomVectors(rand, 50) );
+        frames.vels.append( randomVectors(rand, 1) );
+        frames.frcs.append( randomVectors(rand, 100) );
+        frames.box_dims.append( Vector(30 + 0.1*i, 31 - 0.1*i, 32) );
+        frames.box_angs.append( Vector(90, 90 + (i % 2), 109.5) );
+    }
+
+    return frames;
+}
+
+/** Assert that 'value' is equal to 'ref' to within the precision of
+    a float, as the trajectories hold single precision values */
+static void assert_same_value(double value, double ref, QString codeloc)
+{
+    assert_nearly_equal( value, ref, 1e-6*(1+std::abs(ref)), codeloc );
+}
+
+static void assert_same_vector(const Vector &v, const Vector &ref, QString codeloc)
+{
+    for (int dim=0; dim<3; ++dim)
+    {
+        assert_same_value( v[dim], ref[dim], codeloc );
+    }
+}
+
+static void assert_same_vectors(const QVector<Vector> &vectors, const QVector<Vector> &ref,
+                                QString codeloc)
+{
+    assert_equal( vectors.count(), ref.count(), codeloc );
+
+    for (int i=0; i<ref.count(); ++i)
+    {
+        assert_same_vector( vectors[i], ref[i], codeloc );
+    }
+}
+
+static void assert_same_batch(const QVector< QVector<Vector> > &batch,
+                              const QVector< QVector<Vector> > &ref,
+                              int start, QString codeloc)
+{
+    for (int i=0; i<batch.count(); ++i)
+    {
+        assert_same_vectors( batch[i], ref[start+i], codeloc );
+    }
+}
+
+/** Check the first 'n' frames in 'reader' against 'frames', reading
+    them both one at a time and in batches */
+static void check_frames(const AmberTrajectoryReader &reader, const Frames &frames, int n,
+                         bool has_box, bool has_vels, bool has_frcs, bool verbose)
+{
+    if (verbose)
+        qDebug() << reader.toString();
+
+    assert_equal( reader.nAtoms(), natoms, CODELOC );
+    assert_equal( reader.nFrames(), n, CODELOC );
+
+    assert_true( reader.hasTime(), CODELOC );
+    assert_true( reader.hasCoordinates(), CODELOC );
+    assert_equal( reader.hasBox(), has_box, CODELOC );
+    assert_equal( reader.hasVelocities(), has_vels, CODELOC );
+    assert_equal( reader.hasForces(), has_frcs, CODELOC );
+
+    for (int i=0; i<n; ++i)
+    {
+        assert_same_value( reader.time(i), frames.times[i], CODELOC );
+        assert_same_vectors( reader.coordinates(i), frames.coords[i], CODELOC );
+
+        if (has_box)
+        {
+            assert_same_vector( reader.boxDimensions(i), frames.box_dims[i], CODELOC );
+            assert_same_vector( reader.boxAngles(i), frames.box_angs[i], CODELOC );
+        }
+
+        if (has_vels)
+            assert_same_vectors( reader.velocities(i), frames.vels[i], CODELOC );
+
+        if (has_frcs)
+            assert_same_vectors( reader.forces(i), frames.frcs[i], CODELOC );
+    }
+
+    //read the frames in batches of different sizes, including empty batches
+    for (int batch_size=0; batch_size<=n; batch_size += 5)
+    {
+        for (int start=0; start+batch_size <= n; start += qMax(1,batch_size))
+        {
+            const QVector<double> times = reader.times(start, batch_size);
+            const QVector< QVector<Vector> > coords = reader.coordinates(start, batch_size);
+
+            assert_equal( times.count(), batch_size, CODELOC );
+            assert_equal( coords.count(), batch_size, CODELOC );
+
+            for (int i=0; i<batch_size; ++i)
+            {
+                assert_same_value( times[i], frames.times[start+i], CODELOC );
+            }
+
+            assert_same_batch( coords, frames.coords, start, CODELOC );
+
+            if (has_vels)
+                assert_same_batch( reader.velocities(start, batch_size),
+                                   frames.vels, start, CODELOC );
+
+            if (has_frcs)
+                assert_same_batch( reader.forces(start, batch_size),
+                                   frames.frcs, start, CODELOC );
+        }
+    }
+
+    //the whole trajectory in a single batch
+    assert_same_batch( reader.coordinates(0, n), frames.coords, 0, CODELOC );
+
+    //frames beyond the end of the trajectory cannot be read
+    assert_throws( [&](){ reader.coordinates(n); }, SireError::invalid_index(), CODELOC );
+    assert_throws( [&](){ reader.coordinates(-1); }, SireError::invalid_index(), CODELOC );
+    assert_throws( [&](){ reader.coordinates(n-1, 2); }, SireError::invalid_index(), CODELOC );
+
+    if (not has_vels)
+        assert_throws( [&](){ reader.velocities(0); },
+                       SireError::unavailable_resource(), CODELOC );
+
+    if (not has_box)
+        assert_throws( [&](){ reader.boxDimensions(0); },
+                       SireError::unavailable_resource(), CODELOC );
+}
+
+/** Write the frames to 'filename' using NetCDFFile::write, in the same
+    layout as an AMBER trajectory, so that all frames are written in one go */
+static void writeOneShot(const QString &filename, const Frames &frames)
+{
+    QHash<QString,QString> globals;
+    globals.insert( "Conventions", "AMBER" );
+    globals.insert( "ConventionVersion", "1.0" );
+    globals.insert( "title", "one shot" );
+
+    QHash<QString,NetCDFData> data;
+
+    QVector<float> times(nframes);
+    QVector<float> coords(3*natoms*nframes);
+    QVector<float> box_dims(3*nframes);
+
+    for (int i=0; i<nframes; ++i)
+    {
+        times[i] = frames.times[i];
+
+        for (int j=0; j<natoms; ++j)
+        {
+            for (int dim=0; dim<3; ++dim)
+            {
+                coords[3*natoms*i + 3*j + dim] = frames.coords[i][j][dim];
+            }
+        }
+
+        for (int dim=0; dim<3; ++dim)
+        {
+            box_dims[3*i + dim] = frames.box_dims[i][dim];
+        }
+    }
+
+    QVector<float> box_angs(3*nframes);
+
+    for (int i=0; i<nframes; ++i)
+    {
+        for (int dim=0; dim<3; ++dim)
+        {
+            box_angs[3*i + dim] = frames.box_angs[i][dim];
+        }
+    }
+
+    data.insert( "time", NetCDFData("time", times, QStringList({"frame"}),
+                                    QList<int>({nframes})) );
+
+    data.insert( "coordinates", NetCDFData("coordinates", coords,
+                                           QStringList({"frame","atom","spatial"}),
+                                           QList<int>({nframes,natoms,3})) );
+
+    data.insert( "cell_lengths", NetCDFData("cell_lengths", box_dims,
+                                            QStringList({"frame","cell_spatial"}),
+                                            QList<int>({nframes,3})) );
+
+    data.insert( "cell_angles", NetCDFData("cell_angles", box_angs,
+                                           QStringList({"frame","cell_angular"}),
+                                           QList<int>({nframes,3})) );
+
+    NetCDFFile::write(filename, globals, data);
+
+    //the one-shot file has a fixed (not unlimited) frame dimension,
+    //and the data are written exactly as passed
+    NetCDFFile netcdf(filename);
+
+    const QHash<QString,int> dims = netcdf.getDimensions();
+
+    assert_equal( dims.value("frame"), nframes, CODELOC );
+    assert_equal( dims.value("atom"), natoms, CODELOC );
+    assert_equal( netcdf.nRecords(), 0, CODELOC );
+
+    const QHash<QString,NetCDFDataInfo> vars = netcdf.getVariablesInfo();
+
+    assert_true( netcdf.read(vars["time"]).toFloatArray() == times, CODELOC );
+    assert_true( netcdf.read(vars["coordinates"]).toFloatArray() == coords, CODELOC );
+    assert_true( netcdf.read(vars["cell_lengths"]).toFloatArray() == box_dims, CODELOC );
+    assert_true( netcdf.read(vars["cell_angles"]).toFloatArray() == box_angs, CODELOC );
+
+    //reading records of a fixed-size first dimension also works
+    assert_true( netcdf.read(vars["time"], 3, 4).toFloatArray() == times.mid(3, 4),
+                 CODELOC );
+}
+
+/** Write the first frame to 'filename' as an AMBER restart file,
+    which has no frame dimension and holds double precision values */
+static void writeRestart(const QString &filename, const Frames &frames)
+{
+    QHash<QString,QString> globals;
+    globals.insert( "Conventions", "AMBERRESTART" );
+    globals.insert( "ConventionVersion", "1.0" );
+
+    QVector<double> coords(3*natoms);
+
+    for (int j=0; j<natoms; ++j)
+    {
+        for (int dim=0; dim<3; ++dim)
+        {
+            coords[3*j + dim] = frames.coords[0][j][dim];
+        }
+    }
+
+    QHash<QString,NetCDFData> data;
+
+    data.insert( "time", NetCDFData("time", QVector<double>({frames.times[0]}),
+                                    QStringList(), QList<int>()) );
+
+    data.insert( "coordinates", NetCDFData("coordinates", coords,
+                                           QStringList({"atom","spatial"}),
+                                           QList<int>({natoms,3})) );
+
+    NetCDFFile::write(filename, globals, data);
+}
+
+#endif // SIRE_USE_NETCDF
+
+/** Check that frames written to Amber NetCDF trajectories, with and without
+    the periodic box, velocities and forces, are read back one frame at a
+    time and in batches, that a trajectory that is still being written can
+    be followed using refresh, and that writing a whole file in one go
+    still gives a fixed-size file */
+void test_ambertrajectory(bool verbose)
+{
+#ifdef SIRE_USE_NETCDF
+    QTemporaryDir tmpdir;
+    assert_true( tmpdir.isValid(), CODELOC );
+
+    RanGenerator rand(4321);
+
+    const Frames frames = randomFrames(rand);
+
+    //coordinates only
+    {
+        const QString filename = tmpdir.path() + "/coords.nc";
+
+        AmberTrajectoryWriter writer(filename, natoms, false, false, false, "coordinates");
+
+        assert_true( writer.isOpen(), CODELOC );
+
+        for (int i=0; i<nframes; ++i)
+        {
+            writer.append( frames.times[i], frames.coords[i] );
+        }
+
+        //frames must have the right number of atoms
+        assert_throws( [&](){ writer.append(0, frames.coords[0].mid(1)); },
+                       SireError::incompatible_error(), CODELOC );
+
+        assert_equal( writer.nFrames(), nframes, CODELOC );
+
+        writer.close();
+
+        assert_false( writer.isOpen(), CODELOC );
+        assert_throws( [&](){ writer.append(0, frames.coords[0]); },
+                       SireError::io_error(), CODELOC );
+
+        {
+            AmberTrajectoryReader reader(filename);
+            assert_equal( reader.title(), QString("coordinates"), CODELOC );
+            check_frames(reader, frames, nframes, false, false, false, verbose);
+        }
+
+        //reopen the trajectory and append more frames
+        {
+            AmberTrajectoryWriter appender(filename);
+
+            assert_equal( appender.nAtoms(), natoms, CODELOC );
+            assert_equal( appender.nFrames(), nframes, CODELOC );
+
+            Frames more = frames;
+
+            for (int i=0; i<4; ++i)
+            {
+                more.times.append( 100 + i );
+                more.coords.append( randomVectors(rand, 50) );
+
+                appender.append( more.times.last(), more.coords.last() );
+            }
+
+            appender.close();
+
+            AmberTrajectoryReader reader(filename);
+            check_frames(reader, more, nframes+4, false, false, false, verbose);
+        }
+    }
+
+    //coordinates and the periodic box
+    {
+        const QString filename = tmpdir.path() + "/box.nc";
+
+        AmberTrajectoryWriter writer(filename, natoms, false, false, true);
+
+        //the box must be written with every frame
+        assert_throws( [&](){ writer.append(0, frames.coords[0]); },
+                       SireError::incompatible_error(), CODELOC );
+
+        for (int i=0; i<nframes; ++i)
+        {
+            writer.append( frames.times[i], frames.coords[i],
+                           frames.box_dims[i], frames.box_angs[i] );
+        }
+
+        writer.close();
+
+        AmberTrajectoryReader reader(filename);
+        check_frames(reader, frames, nframes, true, false, false, verbose);
+    }
+
+    //coordinates, velocities, forces and the periodic box
+    {
+        const QString filename = tmpdir.path() + "/all.nc";
+
+        AmberTrajectoryWriter writer(filename, natoms, true, true, true);
+
+        assert_throws( [&](){ writer.append(0, frames.coords[0],
+                                            frames.box_dims[0], frames.box_angs[0]); },
+                       SireError::incompatible_error(), CODELOC );
+
+        for (int i=0; i<nframes; ++i)
+        {
+            writer.append( frames.times[i], frames.coords[i], frames.vels[i],
+                           frames.frcs[i], frames.box_dims[i], frames.box_angs[i] );
+        }
+
+        writer.close();
+
+        AmberTrajectoryReader reader(filename);
+        check_frames(reader, frames, nframes, true, true, true, verbose);
+    }
+
+    //follow a trajectory while it is being written
+    {
+        const QString filename = tmpdir.path() + "/growing.nc";
+
+        AmberTrajectoryWriter writer(filename, natoms, true, false, false);
+
+        for (int i=0; i<3; ++i)
+        {
+            writer.append( frames.times[i], frames.coords[i], frames.vels[i],
+                           QVector<Vector>(), Vector(0), Vector(0) );
+        }
+
+        writer.flush();
+
+        AmberTrajectoryReader reader(filename);
+        check_frames(reader, frames, 3, false, true, false, verbose);
+
+        for (int i=3; i<nframes; ++i)
+        {
+            writer.append( frames.times[i], frames.coords[i], frames.vels[i],
+                           QVector<Vector>(), Vector(0), Vector(0) );
+
+            if (i == 7)
+            {
+                writer.flush();
+
+                //the new frames are only seen after a refresh
+                assert_equal( reader.nFrames(), 3, CODELOC );
+                assert_throws( [&](){ reader.coordinates(3); },
+                               SireError::invalid_index(), CODELOC );
+
+                assert_equal( reader.refresh(), 8, CODELOC );
+                check_frames(reader, frames, 8, false, true, false, verbose);
+            }
+        }
+
+        writer.close();
+
+        assert_equal( reader.refresh(), nframes, CODELOC );
+        check_frames(reader, frames, nframes, false, true, false, verbose);
+
+        //refreshing a complete trajectory changes nothing
+        assert_equal( reader.refresh(), nframes, CODELOC );
+    }
+
+    //a trajectory written in one go gives the same frames as one
+    //written frame by frame
+    {
+        const QString filename = tmpdir.path() + "/oneshot.nc";
+
+        writeOneShot(filename, frames);
+
+        AmberTrajectoryReader reader(filename);
+        assert_equal( reader.title(), QString("one shot"), CODELOC );
+        check_frames(reader, frames, nframes, true, false, false, verbose);
+
+        //a fixed-size trajectory cannot be appended to
+        assert_throws( [&](){ AmberTrajectoryWriter appender(filename);
+                              appender.append(0, frames.coords[0],
+                                              frames.box_dims[0], frames.box_angs[0]); },
+                       SireError::incompatible_error(), CODELOC );
+    }
+
+    //a restart file is read as a single frame
+    {
+        const QString filename = tmpdir.path() + "/restart.nc";
+
+        writeRestart(filename, frames);
+
+        AmberTrajectoryReader reader(filename);
+        check_frames(reader, frames, 1, false, false, false, verbose);
+
+        assert_equal( reader.refresh(), 1, CODELOC );
+
+        //a restart file cannot be appended to
+        assert_throws( [&](){ AmberTrajectoryWriter appender(filename); },
+                       SireIO::parse_error(), CODELOC );
+    }
+
+    assert_throws( [&](){ AmberTrajectoryWriter writer(tmpdir.path() + "/empty.nc", 0); },
+                   SireError::invalid_arg(), CODELOC );
+
+    assert_throws( [&](){ AmberTrajectoryReader reader(tmpdir.path() + "/missing.nc"); },
+                   SireError::io_error(), CODELOC );
+#else
+    if (verbose)
+        qDebug() << "Skipping test_ambertrajectory as Sire has been compiled "
+                    "without NetCDF support";
+#endif
+}
+
+SIRE_UNITTEST( test_ambertrajectory )
@@ -0,0 +1,200 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "SireIO/compressedtrajectory.h"
+#include "SireIO/trajectorywriter.h"
+
+#include "SireMaths/rangenerator.h"
+
+#include "SireBase/unittest.h"
+
+#include <QTemporaryDir>
+#include <QDebug>
+
+#include <cmath>
+
+using namespace SireIO;
+using namespace SireMaths;
+using namespace SireBase;
+
+/** Return 'natoms' random coordinates. Half of the atoms are spread over
+    a large box and the rest are clustered, so that both large and small
+    differences between neighbouring atoms are compressed */
+static QVector<Vector> randomCoords(RanGenerator &rand, int natoms)
+{
+    QVector<Vector> coords(natoms);
+
+    for (int i=0; i<natoms; ++i)
+    {
+        if (i % 2 == 0)
+            coords[i] = Vector( rand.rand(-200,200), rand.rand(-200,200),
+                                rand.rand(-200,200) );
+        else
+            coords[i] = coords[i-1] + Vector( rand.rand(-1.5,1.5), rand.rand(-1.5,1.5),
+                                              rand.rand(-1.5,1.5) );
+    }
+
+    return coords;
+}
+
+static void assert_same_coords(const QVector<Vector> &coords, const QVector<Vector> &ref,
+                               double precision, QString codeloc)
+{
+    assert_equal( coords.count(), ref.count(), codeloc );
+
+    //coordinates are rounded to the nearest multiple of the precision
+    const double range = 0.5*precision + 1e-6;
+
+    for (int i=0; i<ref.count(); ++i)
+    {
+        for (int dim=0; dim<3; ++dim)
+        {
+            assert_nearly_equal( coords[i][dim], ref[i][dim], range, codeloc );
+        }
+    }
+}
+
+/** Check the frames in 'filename' against 'frames', where every other
+    frame has a periodic box */
+static void check_frames(const QString &filename, const QList< QVector<Vector> > &frames,
+                         double precision, bool verbose)
+{
+    CompressedTrajectoryReader reader(filename);
+
+    if (verbose)
+        qDebug() << reader.toString();
+
+    assert_equal( reader.nFrames(), frames.count(), CODELOC );
+    assert_equal( reader.nAtoms(), frames.at(0).count(), CODELOC );
+    assert_nearly_equal( reader.precision(), precision, 1e-12, CODELOC );
+
+    for (int i=0; i<frames.count(); ++i)
+    {
+        assert_nearly_equal( reader.time(i), 0.5*i, 1e-12, CODELOC );
+        assert_same_coords( reader.coordinates(i), frames.at(i), precision, CODELOC );
+
+        if (i % 2 == 1)
+        {
+            assert_true( reader.hasBox(i), CODELOC );
+            assert_nearly_equal( reader.boxDimensions(i).x(), 40.0 + i, 1e-12, CODELOC );
+            assert_nearly_equal( reader.boxAngles(i).y(), 90.0, 1e-12, CODELOC );
+        }
+        else
+        {
+            assert_false( reader.hasBox(i), CODELOC );
+        }
+    }
+}
+
+/** Check that frames written to a compressed trajectory (directly, by
+    appending to an existing file, and via the background TrajectoryWriter)
+    are read back to within the precision of the trajectory */
+void test_compressedtrajectory(bool verbose)
+{
+    QTemporaryDir tmpdir;
+    assert_true( tmpdir.isValid(), CODELOC );
+
+    RanGenerator rand(7341);
+
+    const int natoms = 1001;
+
+    QList< QVector<Vector> > frames;
+
+    for (int i=0; i<6; ++i)
+    {
+        frames.append( randomCoords(rand, natoms) );
+    }
+
+    const Vector angles(90, 90, 90);
+
+    foreach (double precision, QList<double>({0.01, 0.001}))
+    {
+        const QString filename = QString("%1/direct_%2.trj")
+                                        .arg(tmpdir.path()).arg(precision);
+
+        //write the first four frames, then reopen the file and append the rest
+        {
+            CompressedTrajectoryWriter writer(filename, natoms, precision);
+
+            for (int i=0; i<4; ++i)
+            {
+                if (i % 2 == 1)
+                    writer.append(0.5*i, frames.at(i), Vector(40.0+i), angles);
+                else
+                    writer.append(0.5*i, frames.at(i));
+            }
+
+            writer.close();
+        }
+
+        {
+            CompressedTrajectoryWriter writer(filename);
+
+            assert_equal( writer.nFrames(), 4, CODELOC );
+
+            for (int i=4; i<frames.count(); ++i)
+            {
+                if (i % 2 == 1)
+                    writer.append(0.5*i, frames.at(i), Vector(40.0+i), angles);
+                else
+                    writer.append(0.5*i, frames.at(i));
+            }
+
+            writer.close();
+        }
+
+        check_frames(filename, frames, precision, verbose);
+
+        //now write the same frames using the background writer
+        const QString bgname = QString("%1/background_%2.trj")
+                                        .arg(tmpdir.path()).arg(precision);
+
+        {
+            TrajectoryWriter writer(bgname, "compressed", precision);
+
+            for (int i=0; i<frames.count(); ++i)
+            {
+                if (i % 2 == 1)
+                    writer.append(0.5*i, frames.at(i), Vector(40.0+i), angles);
+                else
+                    writer.append(0.5*i, frames.at(i));
+            }
+
+            writer.flush();
+
+            assert_equal( writer.nFrames(), frames.count(), CODELOC );
+            assert_equal( writer.nPending(), 0, CODELOC );
+
+            writer.close();
+        }
+
+        check_frames(bgname, frames, precision, verbose);
+    }
+}
+
+SIRE_UNITTEST( test_compressedtrajectory )
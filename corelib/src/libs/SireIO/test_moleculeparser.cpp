@@ -0,0 +1,153 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "SireIO/moleculeparser.h"
+#include "SireIO/grotop.h"
+#include "SireIO/pdb2.h"
+#include "SireIO/supplementary.h"
+
+#include "SireBase/unittest.h"
+
+#include "SireError/errors.h"
+
+#include <QTemporaryDir>
+#include <QFile>
+#include <QDebug>
+
+using namespace SireIO;
+using namespace SireBase;
+
+/** A small Gromacs topology for a single water molecule, in which
+    every directive is followed by a comment */
+static const char *commented_top =
+    "; a water molecule\n"
+    "[ defaults ] ; nbfunc comb-rule gen-pairs fudgeLJ fudgeQQ\n"
+    "  1  2  yes  0.5  0.8333\n"
+    "\n"
+    "[ atomtypes ] ; the atom types\n"
+    "; name  at.num  mass  charge  ptype  sigma  epsilon\n"
+    "  OW  8  15.9994  0.0  A  3.15061e-01  6.36386e-01\n"
+    "  HW  1   1.0080  0.0  A  0.00000e+00  0.00000e+00\n"
+    "\n"
+    "[ moleculetype ] ; the water molecule\n"
+    "; name  nrexcl\n"
+    "  SOL  2\n"
+    "\n"
+    "[ atoms ] ; the atoms\n"
+    ";  nr  type  resnr  residue  atom  cgnr  charge  mass\n"
+    "   1   OW    1      SOL      OW    1     -0.834  15.9994\n"
+    "   2   HW    1      SOL      HW1   1      0.417   1.0080\n"
+    "   3   HW    1      SOL      HW2   1      0.417   1.0080\n"
+    "\n"
+    "[ bonds ] ; the bonds\n"
+    "  1  2  1  0.09572  502416.0\n"
+    "  1  3  1  0.09572  502416.0\n"
+    "\n"
+    "[ angles ] ; the angle\n"
+    "  2  1  3  1  104.52  628.02\n"
+    "\n"
+    "[ system ] ; the system\n"
+    "  water\n"
+    "\n"
+    "[ molecules ] ; the molecules\n"
+    "  SOL  1\n";
+
+/** A small PDB file of a water dimer */
+static const char *water_pdb =
+    "ATOM      1  O00 T4P     1      14.986 -16.180 -11.971\n"
+    "ATOM      2  H01 T4P     1      14.813 -16.720 -11.200\n"
+    "ATOM      3  H02 T4P     1      14.693 -15.304 -11.721\n"
+    "TER\n"
+    "ATOM      4  O00 T4P     2      18.337 -17.553 -16.079\n"
+    "ATOM      5  H01 T4P     2      18.529 -17.598 -17.016\n"
+    "ATOM      6  H02 T4P     2      17.805 -16.763 -15.982\n"
+    "END\n";
+
+/** Write 'text' to the file called 'filename' in 'dir', returning 
+    the full path to the file */
+static QString writeFile(const QTemporaryDir &dir, const QString &filename,
+                         const char *text)
+{
+    const QString path = dir.filePath(filename);
+
+    QFile f(path);
+
+    if (not f.open(QIODevice::WriteOnly))
+        throw SireError::file_error(f, CODELOC);
+
+    f.write(text);
+    f.close();
+
+    return path;
+}
+
+/** Assert that the file 'filename' is parsed by the parser called 'format' */
+static void assert_parsed_as(const QString &filename, const QString &format,
+                             bool verbose, const QString &codeloc)
+{
+    const MoleculeParserPtr parser = MoleculeParser::parse(filename);
+
+    if (verbose)
+        qDebug() << filename << "parsed as" << parser.read().formatName();
+
+    assert_equal( parser.read().formatName(), format, codeloc );
+}
+
+void test_moleculeparser(bool verbose)
+{
+    QTemporaryDir dir;
+
+    assert_true( dir.isValid(), CODELOC );
+
+    //a directive followed by a comment is still recognised
+    const QByteArray top(commented_top);
+    const QByteArray pdb(water_pdb);
+
+    assert_true( GroTop().sniff(top) > 0, CODELOC );
+    assert_equal( GroTop().sniff(pdb), 0.0, CODELOC );
+    assert_true( PDB2().sniff(pdb) > 0, CODELOC );
+    assert_equal( PDB2().sniff(top), 0.0, CODELOC );
+
+    //the catch-all parser never claims a file
+    assert_equal( Supplementary().sniff(top), 0.0, CODELOC );
+    assert_equal( Supplementary().sniff(pdb), 0.0, CODELOC );
+
+    //files with the right suffix go to the right parser
+    assert_parsed_as( writeFile(dir, "water.top", commented_top), "GroTop", verbose, CODELOC );
+    assert_parsed_as( writeFile(dir, "water.pdb", water_pdb), "PDB", verbose, CODELOC );
+
+    //files with a misleading suffix fail over to the parser that recognises them
+    assert_parsed_as( writeFile(dir, "pdb_water.top", water_pdb), "PDB", verbose, CODELOC );
+    assert_parsed_as( writeFile(dir, "top_water.pdb", commented_top), "GroTop", verbose, CODELOC );
+
+    //as do files without a suffix
+    assert_parsed_as( writeFile(dir, "water_top", commented_top), "GroTop", verbose, CODELOC );
+    assert_parsed_as( writeFile(dir, "water_pdb", water_pdb), "PDB", verbose, CODELOC );
+}
+
+SIRE_UNITTEST( test_moleculeparser )
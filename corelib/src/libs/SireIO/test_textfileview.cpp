@@ -0,0 +1,175 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "SireIO/textfileview.h"
+
+#include "SireBase/unittest.h"
+
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QFile>
+#include <QDebug>
+
+using namespace SireIO;
+using namespace SireBase;
+
+/** Write 'contents' to the file 'name' in 'dir', returning the full path */
+static QString writeFile(const QTemporaryDir &dir, const QString &name,
+                         const QByteArray &contents)
+{
+    const QString filename = dir.filePath(name);
+
+    QFile file(filename);
+    assert_true( file.open(QIODevice::WriteOnly | QIODevice::Truncate), CODELOC );
+    assert_equal( file.write(contents), qint64(contents.count()), CODELOC );
+    file.close();
+
+    return filename;
+}
+
+/** Return the lines of 'filename' read using QTextStream::readLine, which
+    is how MoleculeParser::readTextFile used to read files */
+static QVector<QString> readLines(const QString &filename)
+{
+    QFile file(filename);
+    assert_true( file.open(QIODevice::ReadOnly), CODELOC );
+
+    QTextStream ts(&file);
+
+    QVector<QString> lines;
+
+    while (not ts.atEnd())
+    {
+        lines.append( ts.readLine() );
+    }
+
+    return lines;
+}
+
+/** Check that the view of 'filename' gives the lines 'ref', whether
+    the view is built and converted in parallel or in serial */
+static void check_lines(const QString &filename, const QVector<QString> &ref, bool verbose)
+{
+    for (bool run_parallel : {true, false})
+    {
+        const TextFileView view(filename, run_parallel);
+
+        if (verbose)
+            qDebug() << view.toString() << ref.count();
+
+        assert_equal( view.count(), ref.count(), CODELOC );
+        assert_equal( view.toLines(run_parallel), ref, CODELOC );
+
+        for (int i=0; i<ref.count(); ++i)
+        {
+            assert_equal( view.line(i), ref[i], CODELOC );
+            assert_equal( view.lineLength(i), ref[i].count(), CODELOC );
+            assert_equal( view.lineStartsWith(i, ref[i].toUtf8().constData()),
+                          true, CODELOC );
+        }
+    }
+}
+
+/** Check that the lines found by TextFileView match those found by
+    QTextStream::readLine for files with '\n' and "\r\n" line endings,
+    with and without a line break at the end of the file, and that files
+    with '\r' line endings are split into the same lines */
+void test_textfileview(bool verbose)
+{
+    QTemporaryDir tmpdir;
+    assert_true( tmpdir.isValid(), CODELOC );
+
+    const QList<QByteArray> lines = QList<QByteArray>() << "ATOM      1  O   WAT     1"
+                                                        << "" << "  indented line  "
+                                                        << "" << "" << "END";
+
+    int ifile = 0;
+
+    for (const QByteArray &linebreak : { QByteArray("\n"), QByteArray("\r\n"),
+                                         QByteArray("\r") })
+    {
+        const QByteArray text = lines.join(linebreak);
+
+        for (bool final_break : {true, false})
+        {
+            QByteArray contents = text;
+
+            if (final_break)
+                contents += linebreak;
+
+            const QString filename = writeFile(tmpdir, QString("file%1.txt").arg(ifile),
+                                               contents);
+            ifile += 1;
+
+            if (linebreak == "\r")
+            {
+                //QTextStream doesn't split on a lone '\r', so compare against
+                //the lines of the same file written with '\n'
+                QByteArray lf_contents = contents;
+                lf_contents.replace('\r', '\n');
+
+                const QString lf_filename = writeFile(tmpdir, QString("file%1.txt").arg(ifile),
+                                                      lf_contents);
+                ifile += 1;
+
+                check_lines(filename, readLines(lf_filename), verbose);
+            }
+            else
+            {
+                check_lines(filename, readLines(filename), verbose);
+            }
+        }
+    }
+
+    //an empty file, and files holding only a line break
+    check_lines( writeFile(tmpdir, "empty.txt", QByteArray()), QVector<QString>(), verbose );
+    check_lines( writeFile(tmpdir, "lf.txt", "\n"), QVector<QString>(1), verbose );
+    check_lines( writeFile(tmpdir, "crlf.txt", "\r\n"), QVector<QString>(1), verbose );
+    check_lines( writeFile(tmpdir, "cr.txt", "\r"), QVector<QString>(1), verbose );
+
+    //a file that is scanned in more than one chunk, with a "\r\n" that straddles
+    //the two chunks, which must be found as a single line break
+    const int chunk_size = 4 * 1024 * 1024;
+
+    QByteArray big(chunk_size - 1, 'x');
+    big += "\r\n";
+
+    for (int i=0; i<1000; ++i)
+    {
+        big += QByteArray::number(i);
+        big += (i % 2 == 0) ? "\r\n" : "\n";
+    }
+
+    const QString big_filename = writeFile(tmpdir, "big.txt", big);
+
+    check_lines(big_filename, readLines(big_filename), verbose);
+
+    assert_equal( TextFileView(big_filename).count(), 1001, CODELOC );
+}
+
+SIRE_UNITTEST( test_textfileview )
@@ -0,0 +1,294 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "SireIO/textfileview.h"
+
+#include "SireBase/parallel.h"
+
+#include "SireError/errors.h"
+
+#include <QFile>
+#include <QFileInfo>
+
+#include <cstring>
+
+using namespace SireIO;
+
+/** Null constructor */
+TextFileView::TextFileView() : data(0), nbytes(0)
+{}
+
+/** Internal function used to find the offset of the start of the line
+    that follows every line break in the range [start,end) of 'data',
+    which holds 'nbytes' bytes in total. A line break is "\n", "\r\n"
+    or a lone "\r". The byte after a '\r' is looked at even if it is past
+    'end', so that a "\r\n" that straddles two ranges is a single break */
+static QVector<qint64> findLineBreaks(const char *data, qint64 nbytes,
+                                      qint64 start, qint64 end)
+{
+    QVector<qint64> breaks;
+    
+    for (qint64 i=start; i<end; ++i)
+    {
+        const char c = data[i];
+        
+        if (c == '\n')
+        {
+            //the '\n' of a "\r\n" has already been found with the '\r'
+            if (i == 0 or data[i-1] != '\r')
+                breaks.append(i+1);
+        }
+        else if (c == '\r')
+        {
+            if (i+1 < nbytes and data[i+1] == '\n')
+                breaks.append(i+2);
+            else
+                breaks.append(i+1);
+        }
+    }
+    
+    return breaks;
+}
+
+/** Construct a view of the text file 'filename'. The file is memory-mapped
+    and the line breaks are found in parallel if 'run_parallel' is true */
+TextFileView::TextFileView(const QString &filename, bool run_parallel)
+             : data(0), nbytes(0)
+{
+    f.reset( new QFile( QFileInfo(filename).absoluteFilePath() ) );
+    
+    if (not f->open(QIODevice::ReadOnly | QIODevice::Unbuffered))
+    {
+        throw SireError::file_error(*f, CODELOC);
+    }
+    
+    nbytes = f->size();
+    
+    if (nbytes == 0)
+        //there are no lines in an empty file
+        return;
+    
+    data = reinterpret_cast<const char*>( f->map(0, nbytes) );
+    
+    if (data == 0)
+    {
+        throw SireError::file_error( QObject::tr(
+                "Could not memory-map the file '%1': %2")
+                    .arg(f->fileName()).arg(f->errorString()), CODELOC );
+    }
+    
+    //scan for the line breaks in chunks of about 4 MB
+    const qint64 chunk_size = 4 * 1024 * 1024;
+    const int nchunks = int( (nbytes + chunk_size - 1) / chunk_size );
+    
+    QVector< QVector<qint64> > breaks(nchunks);
+    
+    if (run_parallel and nchunks > 1)
+    {
+        tbb::parallel_for( tbb::blocked_range<int>(0,nchunks),
+                           [&](const tbb::blocked_range<int> &r)
+        {
+            for (int i=r.begin(); i<r.end(); ++i)
+            {
+                breaks[i] = ::findLineBreaks(data, nbytes, i*chunk_size,
+                                             qMin(nbytes, (i+1)*chunk_size));
+            }
+        });
+    }
+    else
+    {
+        for (int i=0; i<nchunks; ++i)
+        {
+            breaks[i] = ::findLineBreaks(data, nbytes, i*chunk_size,
+                                         qMin(nbytes, (i+1)*chunk_size));
+        }
+    }
+    
+    int nbreaks = 0;
+    
+    for (const auto &b : breaks)
+    {
+        nbreaks += b.count();
+    }
+    
+    line_starts.reserve(nbreaks + 2);
+    line_starts.append(0);
+    
+    for (const auto &b : breaks)
+    {
+        line_starts += b;
+    }
+    
+    //the last value is the end of the data (the file may not end with a line break)
+    if (line_starts.last() != nbytes)
+    {
+        line_starts.append(nbytes);
+    }
+}
+
+/** Copy constructor - this shares the mapped file */
+TextFileView::TextFileView(const TextFileView &other)
+             : f(other.f), data(other.data), nbytes(other.nbytes),
+               line_starts(other.line_starts)
+{}
+
+/** Destructor - the file is unmapped when the last view is deleted */
+TextFileView::~TextFileView()
+{}
+
+/** Copy assignment operator */
+TextFileView& TextFileView::operator=(const TextFileView &other)
+{
+    if (this != &other)
+    {
+        f = other.f;
+        data = other.data;
+        nbytes = other.nbytes;
+        line_starts = other.line_starts;
+    }
+    
+    return *this;
+}
+
+const char* TextFileView::typeName()
+{
+    return "SireIO::TextFileView";
+}
+
+const char* TextFileView::what() const
+{
+    return TextFileView::typeName();
+}
+
+QString TextFileView::toString() const
+{
+    return QObject::tr("TextFileView( filename = %1, nLines() = %2 )")
+                .arg(this->filename()).arg(this->count());
+}
+
+/** Return the name of the file being viewed */
+QString TextFileView::filename() const
+{
+    if (f.get() == 0)
+        return QString();
+    else
+        return f->fileName();
+}
+
+/** Return whether or not there are no lines in the view */
+bool TextFileView::isEmpty() const
+{
+    return this->count() == 0;
+}
+
+/** Return the number of bytes in the file */
+qint64 TextFileView::size() const
+{
+    return nbytes;
+}
+
+/** Return a pointer to the raw bytes of the file */
+const char* TextFileView::constData() const
+{
+    return data;
+}
+
+/** Assert that 'i' is a valid line index */
+void TextFileView::assertValidIndex(int i) const
+{
+    if (i < 0 or i >= this->count())
+    {
+        throw SireError::invalid_index( QObject::tr(
+                "Cannot access line %1 of the file '%2' as it only has %3 lines.")
+                    .arg(i).arg(this->filename()).arg(this->count()), CODELOC );
+    }
+}
+
+/** Return the bytes of the ith line. This does not copy the data, so the
+    returned array is only valid while this view (or a copy) exists */
+QByteArray TextFileView::lineBytes(int i) const
+{
+    assertValidIndex(i);
+    return QByteArray::fromRawData(lineData(i), lineLength(i));
+}
+
+/** Return the ith line, converted from UTF-8 into a QString */
+QString TextFileView::line(int i) const
+{
+    assertValidIndex(i);
+    return QString::fromUtf8(lineData(i), lineLength(i));
+}
+
+/** Return the ith line, converted from UTF-8 into a QString */
+QString TextFileView::operator[](int i) const
+{
+    return this->line(i);
+}
+
+/** Return whether or not the ith line starts with 'prefix'. This
+    doesn't create a QString for the line, so can be used to quickly
+    skip uninteresting lines */
+bool TextFileView::lineStartsWith(int i, const char *prefix) const
+{
+    assertValidIndex(i);
+    
+    const int len = std::strlen(prefix);
+    
+    return lineLength(i) >= len and std::strncmp(lineData(i), prefix, len) == 0;
+}
+
+/** Return all of the lines as QStrings. The lines are converted in parallel
+    if 'run_parallel' is true */
+QVector<QString> TextFileView::toLines(bool run_parallel) const
+{
+    const int nlines = this->count();
+    
+    QVector<QString> lines(nlines);
+    QString *l = lines.data();
+    
+    if (run_parallel and nlines > 1024)
+    {
+        tbb::parallel_for( tbb::blocked_range<int>(0,nlines),
+                           [&](const tbb::blocked_range<int> &r)
+        {
+            for (int i=r.begin(); i<r.end(); ++i)
+            {
+                l[i] = QString::fromUtf8(lineData(i), lineLength(i));
+            }
+        });
+    }
+    else
+    {
+        for (int i=0; i<nlines; ++i)
+        {
+            l[i] = QString::fromUtf8(lineData(i), lineLength(i));
+        }
+    }
+    
+    return lines;
+}
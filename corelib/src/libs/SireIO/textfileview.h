@@ -0,0 +1,176 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#ifndef SIREIO_TEXTFILEVIEW_H
+#define SIREIO_TEXTFILEVIEW_H
+
+#include "sireglobal.h"
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+#include <boost/shared_ptr.hpp>
+
+SIRE_BEGIN_HEADER
+
+class QFile;
+
+namespace SireIO
+{
+
+/** This class provides a read-only, line-indexed view of the bytes of
+    a text file. The file is memory-mapped (so it is not copied into
+    memory), and the positions of all of the line breaks are found
+    using a parallel scan. Individual lines can then be accessed either
+    as raw bytes (without any copying or conversion) or as QStrings,
+    which are only created for the lines that are requested.
+    
+    Lines are split on "\n", "\r\n" or a lone "\r", and the line
+    breaks are not included in the lines. This matches QTextStream::readLine
+    for files with "\n" or "\r\n" line endings, while also splitting
+    files that use "\r" (which QTextStream would read as a single line).
+    
+    MoleculeParser::readTextFile uses this class to read files, but
+    still converts every line to a QString, as the parsers hold their
+    lines as QStrings. None of the parsers yet read directly from
+    a TextFileView.
+    
+    Copies of a TextFileView share the same mapped file.
+
+    @author Christopher Woods
+*/
+class SIREIO_EXPORT TextFileView
+{
+public:
+    TextFileView();
+    TextFileView(const QString &filename, bool run_parallel = true);
+    
+    TextFileView(const TextFileView &other);
+    
+    ~TextFileView();
+    
+    TextFileView& operator=(const TextFileView &other);
+    
+    static const char* typeName();
+    const char* what() const;
+    
+    QString toString() const;
+    
+    QString filename() const;
+    
+    bool isEmpty() const;
+    
+    int count() const;
+    int nLines() const;
+    
+    qint64 size() const;
+    
+    const char* constData() const;
+    
+    const char* lineData(int i) const;
+    int lineLength(int i) const;
+    
+    QByteArray lineBytes(int i) const;
+    QString line(int i) const;
+    
+    QString operator[](int i) const;
+    
+    bool lineStartsWith(int i, const char *prefix) const;
+    
+    QVector<QString> toLines(bool run_parallel = true) const;
+
+private:
+    void assertValidIndex(int i) const;
+
+    /** The memory-mapped file (shared between copies) */
+    boost::shared_ptr<QFile> f;
+    
+    /** Pointer to the start of the mapped data */
+    const char *data;
+    
+    /** The number of bytes in the file */
+    qint64 nbytes;
+    
+    /** The offset of the start of each line, with one extra
+        value giving the end of the data */
+    QVector<qint64> line_starts;
+};
+
+#ifndef SIRE_SKIP_INLINE_FUNCTIONS
+
+/** Return the number of lines in the file */
+inline int TextFileView::count() const
+{
+    return line_starts.isEmpty() ? 0 : line_starts.count() - 1;
+}
+
+/** Return the number of lines in the file */
+inline int TextFileView::nLines() const
+{
+    return this->count();
+}
+
+/** Return a pointer to the start of the ith line. Note that the line is
+    not null-terminated - use lineLength to find the number of characters */
+inline const char* TextFileView::lineData(int i) const
+{
+    return data + line_starts.constData()[i];
+}
+
+/** Return the number of bytes in the ith line (excluding the line break) */
+inline int TextFileView::lineLength(int i) const
+{
+    const qint64 start = line_starts.constData()[i];
+    qint64 end = line_starts.constData()[i+1];
+    
+    //remove the line break ("\n", "\r\n" or "\r")
+    if (end > start and data[end-1] == '\n')
+    {
+        end -= 1;
+        
+        if (end > start and data[end-1] == '\r')
+            end -= 1;
+    }
+    else if (end > start and data[end-1] == '\r')
+    {
+        end -= 1;
+    }
+    
+    return int(end - start);
+}
+
+#endif // SIRE_SKIP_INLINE_FUNCTIONS
+
+}
+
+SIRE_EXPOSE_CLASS( SireIO::TextFileView )
+
+SIRE_END_HEADER
+
+#endif
@@ -31,13 +31,27 @@
 #include <QDir>
 #include <QByteArray>
 #include <QTemporaryFile>
+#include <QMutex>
+#include <QHash>
+
+#include <boost/weak_ptr.hpp>
 
 #include "trajectorymonitor.h"
+#include "trajectorywriter.h"
 #include "pdb.h"
 
 #include "SireSystem/system.h"
 
 #include "SireMol/moleculegroup.h"
+#include "SireMol/molecule.h"
+#include "SireMol/atomcoords.h"
+
+#include "SireVol/periodicbox.h"
+#include "SireVol/triclinicbox.h"
+
+#include "SireBase/timeproperty.h"
+
+#include "SireUnits/units.h"
 
 #include "SireStream/datastream.h"
 #include "SireStream/shareddatastream.h"
@@ -54,9 +68,49 @@ using namespace SireMol;
 using namespace SireVol;
 using namespace SireBase;
 using namespace SireStream;
+using namespace SireMaths;
+using namespace SireUnits;
 
 static const RegisterMetaType<TrajectoryMonitor> r_trajmon;
 
+Q_GLOBAL_STATIC( QMutex, trajWritersMutex );
+
+typedef QHash< QString,boost::weak_ptr<TrajectoryWriter> > TrajWriterRegistry;
+Q_GLOBAL_STATIC( TrajWriterRegistry, trajWriters );
+
+/** Internal function used to register 'writer' as the writer of its
+    trajectory file, so that it is shared by every monitor (including
+    restored monitors) that streams frames to that file */
+static void registerTrajectoryWriter(const shared_ptr<TrajectoryWriter> &writer)
+{
+    QMutexLocker lkr( trajWritersMutex() );
+    trajWriters()->insert( QFileInfo(writer->filename()).absoluteFilePath(), writer );
+}
+
+/** Internal function used to return the writer for the trajectory file
+    'filename'. If another monitor is still writing to this file then
+    its writer is returned, so that all copies of a restored monitor
+    share a single writer. Otherwise a new writer is created that
+    appends to the existing file */
+static shared_ptr<TrajectoryWriter> getTrajectoryWriter(const QString &filename,
+                                                        const QString &format,
+                                                        double precision)
+{
+    const QString key = QFileInfo(filename).absoluteFilePath();
+
+    QMutexLocker lkr( trajWritersMutex() );
+    
+    shared_ptr<TrajectoryWriter> writer = trajWriters()->value(key).lock();
+    
+    if (writer.get() == 0)
+    {
+        writer.reset( new TrajectoryWriter(filename, format, precision, true) );
+        trajWriters()->insert(key, writer);
+    }
+    
+    return writer;
+}
+
 static QByteArray readFromDisk(const QPair< QString,shared_ptr<QTemporaryFile> > &tmpfile)
 {
     //open the packed data file using a separate file handle
@@ -148,12 +202,16 @@ static QPair< QString,shared_ptr<QTemporaryFile> >
 QDataStream SIREIO_EXPORT &operator<<(QDataStream &ds, 
                                       const TrajectoryMonitor &trajmon)
 {
-    writeHeader(ds, r_trajmon, 2);
+    writeHeader(ds, r_trajmon, 3);
+    
+    //make sure that the trajectory file is up to date with the saved state
+    trajmon.flush();
     
     SharedDataStream sds(ds);
     
     sds << trajmon.io_writer << trajmon.mgid
-        << trajmon.mol_properties << trajmon.temp_dir;
+        << trajmon.mol_properties << trajmon.temp_dir
+        << trajmon.traj_file << trajmon.traj_format << trajmon.traj_precision;
 
     //now write all of the frames
     sds << quint32( trajmon.traj_frames.count() );
@@ -181,7 +239,7 @@ QDataStream SIREIO_EXPORT &operator>>(QDataStream &ds, TrajectoryMonitor &trajmo
 {
     VersionID v = readHeader(ds, r_trajmon);
     
-    if (v == 1 or v == 2)
+    if (v == 1 or v == 2 or v == 3)
     {
         SharedDataStream sds(ds);
         
@@ -189,7 +247,7 @@ QDataStream SIREIO_EXPORT &operator>>(QDataStream &ds, TrajectoryMonitor &trajmo
         
         sds >> new_monitor.io_writer;
         
-        if (v == 2)
+        if (v >= 2)
         {
             sds >> new_monitor.mgid;
         }
@@ -202,6 +260,14 @@ QDataStream SIREIO_EXPORT &operator>>(QDataStream &ds, TrajectoryMonitor &trajmo
 
         sds >> new_monitor.mol_properties >> new_monitor.temp_dir;
 
+        if (v == 3)
+        {
+            //the trajectory writer is found (or recreated) when the next
+            //frame is written, and will then append to the existing file
+            sds >> new_monitor.traj_file >> new_monitor.traj_format
+                >> new_monitor.traj_precision;
+        }
+
         //how many frames need to be read?
         quint32 nframes;
         sds >> nframes;
@@ -222,14 +288,15 @@ QDataStream SIREIO_EXPORT &operator>>(QDataStream &ds, TrajectoryMonitor &trajmo
         trajmon = new_monitor;
     }
     else
-        throw version_error(v, "1,2", r_trajmon, CODELOC);
+        throw version_error(v, "1,2,3", r_trajmon, CODELOC);
         
     return ds;
 }
 
 /** Null constructor */
 TrajectoryMonitor::TrajectoryMonitor()
-                  : ConcreteProperty<TrajectoryMonitor,SystemMonitor>()
+                  : ConcreteProperty<TrajectoryMonitor,SystemMonitor>(),
+                    traj_precision(0.01)
 {}
 
 /** Construct a monitor that monitors the trajectory of the molecules  
@@ -240,7 +307,7 @@ TrajectoryMonitor::TrajectoryMonitor(const MoleculeGroup &molgroup,
                                      const PropertyMap &map)
                   : ConcreteProperty<TrajectoryMonitor,SystemMonitor>(),
                     io_writer( PDB() ), mgid(molgroup.number()),
-                    mol_properties(map)
+                    mol_properties(map), traj_precision(0.01)
 {}
 
 /** Construct a monitor that monitors the trajectory of the molecules in 
@@ -251,7 +318,8 @@ TrajectoryMonitor::TrajectoryMonitor(const MoleculeGroup &molgroup,
                                      const IOBase &writer,
                                      const PropertyMap &map)
                   : ConcreteProperty<TrajectoryMonitor,SystemMonitor>(),
-                    io_writer(writer), mgid(molgroup.number()), mol_properties(map)
+                    io_writer(writer), mgid(molgroup.number()), mol_properties(map),
+                    traj_precision(0.01)
 {}
 
 /** Construct a monitor that monitors the trajectory of the molecules  
@@ -262,7 +330,7 @@ TrajectoryMonitor::TrajectoryMonitor(const MGID &mg_id,
                                      const PropertyMap &map)
                   : ConcreteProperty<TrajectoryMonitor,SystemMonitor>(),
                     io_writer( PDB() ), mgid(mg_id),
-                    mol_properties(map)
+                    mol_properties(map), traj_precision(0.01)
 {}
 
 /** Construct a monitor that monitors the trajectory of the molecules in 
@@ -273,7 +341,8 @@ TrajectoryMonitor::TrajectoryMonitor(const MGID &mg_id,
                                      const IOBase &writer,
                                      const PropertyMap &map)
                   : ConcreteProperty<TrajectoryMonitor,SystemMonitor>(),
-                    io_writer(writer), mgid(mg_id), mol_properties(map)
+                    io_writer(writer), mgid(mg_id), mol_properties(map),
+                    traj_precision(0.01)
 {}
 
 /** Copy constructor */
@@ -281,7 +350,9 @@ TrajectoryMonitor::TrajectoryMonitor(const TrajectoryMonitor &other)
                   : ConcreteProperty<TrajectoryMonitor,SystemMonitor>(other),
                     io_writer(other.io_writer), mgid(other.mgid),
                     traj_frames(other.traj_frames), space_frames(other.space_frames),
-                    mol_properties(other.mol_properties), temp_dir(other.temp_dir)
+                    mol_properties(other.mol_properties), temp_dir(other.temp_dir),
+                    traj_file(other.traj_file), traj_format(other.traj_format),
+                    traj_precision(other.traj_precision), traj_writer(other.traj_writer)
 {}
 
 /** Destructor */
@@ -299,6 +370,10 @@ TrajectoryMonitor& TrajectoryMonitor::operator=(const TrajectoryMonitor &other)
     mol_properties = other.mol_properties;
     space_frames = other.space_frames;
     temp_dir = other.temp_dir;
+    traj_file = other.traj_file;
+    traj_format = other.traj_format;
+    traj_precision = other.traj_precision;
+    traj_writer = other.traj_writer;
     
     return *this;
 }
@@ -311,6 +386,9 @@ bool TrajectoryMonitor::operator==(const TrajectoryMonitor &other) const
             mgid == other.mgid and
             mol_properties == other.mol_properties and
             temp_dir == other.temp_dir and
+            traj_file == other.traj_file and
+            traj_format == other.traj_format and
+            traj_precision == other.traj_precision and
             traj_frames == other.traj_frames and
             space_frames == other.space_frames and 
             SystemMonitor::operator==(other));
@@ -366,6 +444,9 @@ static int nColumns(int n)
     from 0, replacing "XXXXXX" with the frame number */
 void TrajectoryMonitor::writeToDisk(const QString &file_template) const
 {
+    //frames streamed to a binary trajectory are already on disk
+    this->flush();
+
     int nframes = traj_frames.count();
     int i = 0;
     int n = nColumns(nframes);
@@ -444,17 +525,180 @@ void TrajectoryMonitor::writeToDisk(const QString &file_template) const
     }
 }
 
-/** Clear all statistics - this will clear all frames of the trajectory */
+/** Clear all statistics - this will clear all frames of the trajectory
+    that are held by this monitor. Frames that have already been streamed
+    to a binary trajectory file are not removed from that file */
 void TrajectoryMonitor::clearStatistics()
 {
     traj_frames.clear();
     space_frames.clear();
 }
 
+/** Stream the trajectory directly into the binary trajectory file 'filename',
+    rather than writing each frame using the IOBase writer. The format is
+    either "netcdf" (Amber NetCDF trajectory) or "compressed" (lossy compressed
+    trajectory, storing coordinates to 'precision' angstroms, which can be
+    read using CompressedTrajectoryReader). The frames are written by a
+    background thread. This starts a new file (overwriting any existing file).
+    Pass an empty filename to go back to writing frames using the IOBase writer.
+    
+    A monitor that is restored from a checkpoint appends to this file, sharing
+    a single writer between all copies. The file is not truncated on restore,
+    so any frames written after the checkpoint was saved remain in the file,
+    before the frames of the restarted run */
+void TrajectoryMonitor::setTrajectoryFile(const QString &filename, const QString &format,
+                                          double precision)
+{
+    if (filename.isEmpty())
+    {
+        this->flush();
+        traj_writer.reset();
+        traj_file = QString();
+        traj_format = QString();
+        traj_precision = 0.01;
+        return;
+    }
+
+    boost::shared_ptr<TrajectoryWriter> writer( new TrajectoryWriter(filename, format,
+                                                                     precision) );
+
+    this->flush();
+
+    registerTrajectoryWriter(writer);
+
+    traj_writer = writer;
+    traj_file = filename;
+    traj_format = writer->format();
+    traj_precision = precision;
+}
+
+/** Return the name of the binary trajectory file to which frames are streamed.
+    This is empty if frames are written using the IOBase writer */
+QString TrajectoryMonitor::trajectoryFile() const
+{
+    return traj_file;
+}
+
+/** Return the format of the binary trajectory file */
+QString TrajectoryMonitor::trajectoryFormat() const
+{
+    return traj_format;
+}
+
+/** Return the number of frames that have been monitored. For a binary
+    trajectory file this is the number of frames written by this monitor
+    (including those still waiting to be written) */
+int TrajectoryMonitor::nFrames() const
+{
+    if (traj_writer.get() != 0)
+    {
+        return traj_writer->nFrames() + traj_writer->nPending();
+    }
+    else
+    {
+        return traj_frames.count();
+    }
+}
+
+/** Wait until all of the frames streamed to the binary trajectory file have
+    been written, and flush the file to disk */
+void TrajectoryMonitor::flush() const
+{
+    if (traj_writer.get() != 0)
+    {
+        traj_writer->flush();
+    }
+}
+
+/** Internal function used to queue the current frame to be written
+    to the binary trajectory file */
+void TrajectoryMonitor::writeFrame(const System &system, const MoleculeGroup &molgroup)
+{
+    //get the coordinates of all of the atoms, in molecule order
+    const PropertyName coords_property = mol_properties["coordinates"];
+    
+    QVector<Vector> coords;
+    
+    for (const auto molnum : molgroup.molNums())
+    {
+        const Molecule mol = molgroup[molnum].molecule();
+        
+        const auto molcoords = mol.property(coords_property).asA<AtomCoords>();
+        const auto molinfo = mol.info();
+        
+        for (int i=0; i<mol.nAtoms(); ++i)
+        {
+            coords.append( molcoords.at( molinfo.cgAtomIdx( AtomIdx(i) ) ) );
+        }
+    }
+    
+    //get the time
+    double time = 0;
+    
+    try
+    {
+        time = system.property(mol_properties["time"]).asA<TimeProperty>()
+                     .value().to(picosecond);
+    }
+    catch(...)
+    {}
+    
+    //get the periodic box (if any)
+    SpacePtr space;
+    
+    const PropertyName &space_property = mol_properties["space"];
+    
+    if (space_property.hasSource())
+    {
+        if (system.containsProperty(space_property.source()))
+            space = system.property(space_property.source());
+    }
+    else if (space_property.hasValue())
+        space = space_property.value();
+    
+    if (traj_writer.get() == 0)
+    {
+        //this monitor has been restored, so continue the existing trajectory,
+        //sharing the writer with any other copy that is writing to this file
+        traj_writer = getTrajectoryWriter(traj_file, traj_format, traj_precision);
+    }
+    
+    if (space.read().isA<PeriodicBox>())
+    {
+        traj_writer->append(time, coords, space.read().asA<PeriodicBox>().dimensions(),
+                            Vector(90,90,90));
+    }
+    else if (space.read().isA<TriclinicBox>())
+    {
+        const auto &box = space.read().asA<TriclinicBox>();
+        
+        const Vector &v0 = box.vector0();
+        const Vector &v1 = box.vector1();
+        const Vector &v2 = box.vector2();
+        
+        traj_writer->append(time, coords,
+                            Vector( v0.length(), v1.length(), v2.length() ),
+                            Vector( Vector::angle(v1,v2).to(degrees),
+                                    Vector::angle(v0,v2).to(degrees),
+                                    Vector::angle(v0,v1).to(degrees) ));
+    }
+    else
+    {
+        traj_writer->append(time, coords);
+    }
+}
+
 /** Monitor the system, writing an additional frame of the trajectory
     to this monitor */
 void TrajectoryMonitor::monitor(System &system)
 {
+    if (not traj_file.isEmpty())
+    {
+        //errors writing the binary trajectory should not be hidden
+        this->writeFrame(system, system[mgid]);
+        return;
+    }
+
     if (io_writer.isNull())
         //there is nothing to write
         return;
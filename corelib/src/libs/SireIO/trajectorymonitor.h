@@ -66,9 +66,25 @@ using SireMol::MGID;
 
 using SireBase::PropertyMap;
 
+class TrajectoryWriter;
+
 /** This is a monitor that can be used to save a trajectory
     of an arbitrary collection of molecules from the system
     
+    By default, each frame is written using the IOBase writer (e.g. PDB),
+    and is held (compressed) in a temporary file until writeToDisk is
+    called. Alternatively, setTrajectoryFile can be used to stream the
+    frames directly into a binary trajectory file, either in Amber NetCDF
+    format or in a lossy, fixed-precision compressed format. These
+    frames are written by a background thread, so that monitoring
+    the system does not have to wait for the disk.
+    
+    Streamed trajectory files are append-only. A monitor restored from
+    a checkpoint continues the same file, so frames that were written
+    after the checkpoint was saved are not removed, and the frames of
+    the restarted run follow them. Use setTrajectoryFile to start a
+    new file after restoring if a continuous trajectory is needed.
+    
     @author Christopher Woods
 */
 class SIREIO_EXPORT TrajectoryMonitor 
@@ -111,7 +127,21 @@ public:
     
     void writeToDisk(const QString &file_template) const;
     
+    void setTrajectoryFile(const QString &filename,
+                           const QString &format = "netcdf",
+                           double precision = 0.01);
+    
+    QString trajectoryFile() const;
+    QString trajectoryFormat() const;
+    
+    int nFrames() const;
+    
+    void flush() const;
+    
 private:
+    void writeFrame(const System &system, const MoleculeGroup &molgroup);
+
+
     /** The IO object used to create the coordinates file(s) 
         from the system */
     IOPtr io_writer;
@@ -131,6 +161,20 @@ private:
     
     /** Name of the directory in which to save the temporary files */
     QString temp_dir;
+    
+    /** The name of the binary trajectory file to which frames are
+        streamed (empty if the frames are written using 'io_writer') */
+    QString traj_file;
+    
+    /** The format of the binary trajectory file */
+    QString traj_format;
+    
+    /** The precision (in angstroms) of coordinates in compressed trajectories */
+    double traj_precision;
+    
+    /** The background writer used to stream frames to 'traj_file'. This
+        is shared between copies of this monitor */
+    boost::shared_ptr<TrajectoryWriter> traj_writer;
 };
 
 }
@@ -0,0 +1,378 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "SireIO/trajectorywriter.h"
+#include "SireIO/ambertrajectory.h"
+#include "SireIO/compressedtrajectory.h"
+
+#include "SireError/errors.h"
+#include "SireError/printerror.h"
+
+#include <QFileInfo>
+
+using namespace SireIO;
+using namespace SireMaths;
+
+/** Construct a writer that will write the trajectory to the file 'filename'
+    using the passed format (either "netcdf" or "compressed"). The precision
+    (in angstroms) is used for the coordinates of compressed trajectories.
+    If 'append_to_file' is true, then frames are appended to an existing
+    trajectory (if it exists), otherwise any existing file is overwritten.
+    At most 'max_pending' frames will be held in memory waiting to be
+    written. This starts the background thread used to write the frames */
+TrajectoryWriter::TrajectoryWriter(const QString &filename, const QString &format,
+                                   double precision, bool append, int max_frames)
+                 : QThread(), boost::noncopyable(),
+                   fname(filename), fmt(format.toLower()), prec(precision),
+                   max_pending(max_frames), nwritten(0), is_writing(false),
+                   append_to_file(append), been_closed(false)
+{
+    if (fmt == "nc" or fmt == "amber")
+    {
+        fmt = "netcdf";
+    }
+    
+    if (not supportedFormats().contains(fmt))
+    {
+        throw SireError::invalid_arg( QObject::tr(
+                "Cannot write a trajectory using the format '%1'. Supported "
+                "formats are [ %2 ].")
+                    .arg(format).arg(supportedFormats().join(", ")), CODELOC );
+    }
+    
+    if (max_pending < 1)
+    {
+        max_pending = 1;
+    }
+    
+    QThread::start();
+}
+
+/** Destructor - this waits until all of the pending frames have
+    been written, and then closes the file */
+TrajectoryWriter::~TrajectoryWriter()
+{
+    try
+    {
+        this->close();
+    }
+    catch(...)
+    {}
+}
+
+const char* TrajectoryWriter::typeName()
+{
+    return "SireIO::TrajectoryWriter";
+}
+
+const char* TrajectoryWriter::what() const
+{
+    return TrajectoryWriter::typeName();
+}
+
+QString TrajectoryWriter::toString() const
+{
+    return QObject::tr("TrajectoryWriter( filename = %1, format = %2, "
+                       "nFrames() = %3, nPending() = %4 )")
+                .arg(fname).arg(fmt).arg(nFrames()).arg(nPending());
+}
+
+/** Return the formats that can be written */
+QStringList TrajectoryWriter::supportedFormats()
+{
+    return QStringList( { "netcdf", "compressed" } );
+}
+
+/** Return the name of the file being written */
+QString TrajectoryWriter::filename() const
+{
+    return fname;
+}
+
+/** Return the format of the file being written */
+QString TrajectoryWriter::format() const
+{
+    return fmt;
+}
+
+/** Return the precision (in angstroms) of the coordinates written
+    to compressed trajectories */
+double TrajectoryWriter::precision() const
+{
+    return prec;
+}
+
+/** Return the maximum number of frames that can be waiting to be written */
+int TrajectoryWriter::maxPending() const
+{
+    return max_pending;
+}
+
+/** Return the number of frames that have been written to the file */
+int TrajectoryWriter::nFrames() const
+{
+    QMutexLocker lkr(&datamutex);
+    return nwritten;
+}
+
+/** Return the number of frames that are waiting to be written */
+int TrajectoryWriter::nPending() const
+{
+    QMutexLocker lkr(&datamutex);
+    return frame_queue.count() + (is_writing ? 1 : 0);
+}
+
+/** Internal function that rethrows any error raised by the background
+    thread. This must be called with 'datamutex' locked */
+void TrajectoryWriter::assertNoError()
+{
+    if (write_error.get() != 0)
+    {
+        write_error->throwSelf();
+    }
+}
+
+/** Internal function used to add a frame onto the queue, waiting
+    if the queue is full */
+void TrajectoryWriter::enqueue(const Frame &frame)
+{
+    QMutexLocker lkr(&datamutex);
+    
+    assertNoError();
+    
+    if (been_closed)
+    {
+        throw SireError::io_error( QObject::tr(
+                "Cannot write a frame to the trajectory '%1' as it has been closed.")
+                    .arg(fname), CODELOC );
+    }
+    
+    while (frame_queue.count() >= max_pending and write_error.get() == 0)
+    {
+        written_waiter.wait(&datamutex);
+    }
+    
+    assertNoError();
+    
+    frame_queue.enqueue(frame);
+    frame_waiter.wakeAll();
+}
+
+/** Queue a frame at time 'time' (in picoseconds) with the passed
+    coordinates (in angstroms) to be written. This returns immediately */
+void TrajectoryWriter::append(double time, const QVector<Vector> &coordinates)
+{
+    Frame frame;
+    frame.coordinates = coordinates;
+    frame.time = time;
+    frame.has_box = false;
+    
+    this->enqueue(frame);
+}
+
+/** Queue a frame at time 'time' with the passed coordinates and periodic
+    box dimensions (in angstroms) and angles (in degrees) to be written.
+    This returns immediately */
+void TrajectoryWriter::append(double time, const QVector<Vector> &coordinates,
+                              const Vector &box_dimensions, const Vector &box_angles)
+{
+    Frame frame;
+    frame.coordinates = coordinates;
+    frame.box_dimensions = box_dimensions;
+    frame.box_angles = box_angles;
+    frame.time = time;
+    frame.has_box = true;
+    
+    this->enqueue(frame);
+}
+
+/** Wait until all of the queued frames have been written, and then
+    flush the file to disk, so that it can be read by other programs */
+void TrajectoryWriter::flush()
+{
+    QMutexLocker lkr(&datamutex);
+    
+    while ((is_writing or not frame_queue.isEmpty()) and write_error.get() == 0)
+    {
+        written_waiter.wait(&datamutex);
+    }
+    
+    assertNoError();
+    
+    //the background thread is idle and needs the lock to do anything,
+    //so it is safe to flush the writers from this thread
+    if (netcdf_writer.get() != 0)
+    {
+        netcdf_writer->flush();
+    }
+    
+    if (compressed_writer.get() != 0)
+    {
+        compressed_writer->flush();
+    }
+}
+
+/** Wait until all of the queued frames have been written, and then
+    close the file. No more frames can be written after this */
+void TrajectoryWriter::close()
+{
+    QMutexLocker lkr(&datamutex);
+    been_closed = true;
+    frame_waiter.wakeAll();
+    lkr.unlock();
+    
+    while (not QThread::wait(200))
+    {
+        frame_waiter.wakeAll();
+    }
+    
+    lkr.relock();
+    assertNoError();
+}
+
+/** Internal function, called by the background thread, that writes
+    a frame to the file, creating the file if necessary */
+void TrajectoryWriter::writeFrame(const Frame &frame)
+{
+    const bool append_to_existing = append_to_file and QFileInfo(fname).exists();
+
+    if (fmt == "compressed")
+    {
+        if (compressed_writer.get() == 0)
+        {
+            if (append_to_existing)
+            {
+                compressed_writer.reset( new CompressedTrajectoryWriter(fname) );
+            }
+            else
+            {
+                compressed_writer.reset( new CompressedTrajectoryWriter(
+                                            fname, frame.coordinates.count(), prec) );
+            }
+        }
+        
+        if (frame.has_box)
+        {
+            compressed_writer->append(frame.time, frame.coordinates,
+                                      frame.box_dimensions, frame.box_angles);
+        }
+        else
+        {
+            compressed_writer->append(frame.time, frame.coordinates);
+        }
+    }
+    else
+    {
+        if (netcdf_writer.get() == 0)
+        {
+            if (append_to_existing)
+            {
+                netcdf_writer.reset( new AmberTrajectoryWriter(fname) );
+            }
+            else
+            {
+                netcdf_writer.reset( new AmberTrajectoryWriter(
+                                        fname, frame.coordinates.count(),
+                                        false, false, frame.has_box) );
+            }
+        }
+        
+        //the box is ignored if the trajectory was created without one
+        netcdf_writer->append(frame.time, frame.coordinates,
+                              QVector<Vector>(), QVector<Vector>(),
+                              frame.box_dimensions, frame.box_angles);
+    }
+}
+
+/** This is the event loop of the background thread */
+void TrajectoryWriter::run()
+{
+    SireError::setThreadString("TrajectoryWriter");
+    
+    QMutexLocker lkr(&datamutex);
+    
+    while (true)
+    {
+        while (frame_queue.isEmpty() and not been_closed)
+        {
+            frame_waiter.wait(&datamutex);
+        }
+        
+        if (frame_queue.isEmpty())
+            //we have been closed and all frames have been written
+            break;
+        
+        Frame frame = frame_queue.dequeue();
+        is_writing = true;
+        lkr.unlock();
+        
+        boost::shared_ptr<SireError::exception> error;
+        
+        try
+        {
+            this->writeFrame(frame);
+        }
+        catch(const SireError::exception &e)
+        {
+            error.reset( e.clone() );
+        }
+        catch(const std::exception &e)
+        {
+            error.reset( SireError::std_exception(e).clone() );
+        }
+        catch(...)
+        {
+            error.reset( SireError::unknown_exception( QObject::tr(
+                    "An unknown error occurred while writing to the trajectory '%1'.")
+                        .arg(fname), CODELOC ).clone() );
+        }
+        
+        lkr.relock();
+        is_writing = false;
+        
+        if (error.get() != 0)
+        {
+            //stop writing, and report the error to the next caller
+            write_error = error;
+            frame_queue.clear();
+            been_closed = true;
+        }
+        else
+        {
+            nwritten += 1;
+        }
+        
+        written_waiter.wakeAll();
+    }
+    
+    //close the file from this thread, as this is the thread that wrote it
+    netcdf_writer.reset();
+    compressed_writer.reset();
+    
+    written_waiter.wakeAll();
+}
@@ -0,0 +1,187 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#ifndef SIREIO_TRAJECTORYWRITER_H
+#define SIREIO_TRAJECTORYWRITER_H
+
+#include "sireglobal.h"
+
+#include "SireMaths/vector.h"
+
+#include <QQueue>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QStringList>
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+SIRE_BEGIN_HEADER
+
+namespace SireError
+{
+class exception;
+}
+
+namespace SireIO
+{
+
+using SireMaths::Vector;
+
+class AmberTrajectoryWriter;
+class CompressedTrajectoryWriter;
+
+/** This class writes a binary trajectory file asynchronously, using
+    a background thread. Frames are copied into a queue and the call
+    returns immediately, so the simulation thread never waits for
+    the disk. At most 'maxPending()' frames are queued; if the disk
+    cannot keep up then appending a new frame waits until space is
+    available, so that memory use stays bounded.
+
+    Two formats are supported;
+    
+    "netcdf" - Amber NetCDF trajectory (written using AmberTrajectoryWriter)
+    "compressed" - lossy, fixed-precision compressed trajectory
+                   (written using CompressedTrajectoryWriter)
+    
+    The file is created when the first frame is written, as this provides
+    the number of atoms and whether or not there is a periodic box.
+    
+    Any error raised while writing in the background is reported by the
+    next call to append, flush or close.
+
+    @author Christopher Woods
+*/
+class SIREIO_EXPORT TrajectoryWriter : private QThread, public boost::noncopyable
+{
+public:
+    TrajectoryWriter(const QString &filename, const QString &format = "netcdf",
+                     double precision = 0.01, bool append_to_file = false,
+                     int max_pending = 32);
+    
+    ~TrajectoryWriter();
+    
+    static const char* typeName();
+    const char* what() const;
+    
+    QString toString() const;
+    
+    static QStringList supportedFormats();
+    
+    QString filename() const;
+    QString format() const;
+    
+    double precision() const;
+    
+    int maxPending() const;
+    
+    int nFrames() const;
+    int nPending() const;
+    
+    void append(double time, const QVector<Vector> &coordinates);
+    
+    void append(double time, const QVector<Vector> &coordinates,
+                const Vector &box_dimensions, const Vector &box_angles);
+    
+    void flush();
+    void close();
+
+protected:
+    void run();
+
+private:
+    /** A single frame waiting to be written */
+    struct Frame
+    {
+        QVector<Vector> coordinates;
+        Vector box_dimensions;
+        Vector box_angles;
+        double time;
+        bool has_box;
+    };
+
+    void enqueue(const Frame &frame);
+    void writeFrame(const Frame &frame);
+    void assertNoError();
+
+    /** Mutex protecting the queue and the state of the writer */
+    mutable QMutex datamutex;
+    
+    /** Wait condition used to wake the background thread when
+        there are frames to write */
+    QWaitCondition frame_waiter;
+    
+    /** Wait condition used to wake the producer when frames
+        have been written */
+    QWaitCondition written_waiter;
+    
+    /** The frames waiting to be written */
+    QQueue<Frame> frame_queue;
+    
+    /** The Amber NetCDF writer (if writing NetCDF) */
+    boost::shared_ptr<AmberTrajectoryWriter> netcdf_writer;
+    
+    /** The compressed writer (if writing compressed trajectories) */
+    boost::shared_ptr<CompressedTrajectoryWriter> compressed_writer;
+    
+    /** Any error raised by the background thread */
+    boost::shared_ptr<SireError::exception> write_error;
+    
+    /** The name of the file */
+    QString fname;
+    
+    /** The format of the file */
+    QString fmt;
+    
+    /** The precision of coordinates in compressed files */
+    double prec;
+    
+    /** The maximum number of frames that may be queued */
+    qint32 max_pending;
+    
+    /** The number of frames written to the file */
+    qint32 nwritten;
+    
+    /** Whether or not the frame being written is still in progress */
+    bool is_writing;
+    
+    /** Whether or not to append to an existing file */
+    bool append_to_file;
+    
+    /** Whether or not the writer has been closed */
+    bool been_closed;
+};
+
+}
+
+SIRE_EXPOSE_CLASS( SireIO::TrajectoryWriter )
+
+SIRE_END_HEADER
+
+#endif
@@ -1945,6 +1945,68 @@ CLJAtoms CLJAtoms::negate() const
     return ret;
 }
 
+/** Return a copy of these CLJAtoms where all of the atoms have been
+    translated by 'delta'. This is used to create the periodic images
+    of atoms in spaces whose minimum image cannot be calculated within
+    the CLJ kernels (e.g. SireVol::TriclinicBox) */
+CLJAtoms CLJAtoms::translate(const Vector &delta) const
+{
+    CLJAtoms ret(*this);
+    
+    const MultiFloat dx( delta.x() );
+    const MultiFloat dy( delta.y() );
+    const MultiFloat dz( delta.z() );
+    
+    for (int i=0; i<_x.count(); ++i)
+    {
+        ret._x[i] = _x[i] + dx;
+        ret._y[i] = _y[i] + dy;
+        ret._z[i] = _z[i] + dz;
+    }
+    
+    return ret;
+}
+
+/** Place into 'translated' a copy of these CLJAtoms where all of the
+    atoms have been translated by 'delta'. The coordinate arrays of
+    'translated' are reused, so passing the same scratch CLJAtoms for
+    each periodic image avoids allocating a new copy per image */
+void CLJAtoms::translate(const Vector &delta, CLJAtoms &translated) const
+{
+    const int n = _x.count();
+
+    if (translated._x.count() != n)
+    {
+        translated._x.resize(n);
+        translated._y.resize(n);
+        translated._z.resize(n);
+    }
+
+    translated._q = _q;
+    translated._sig = _sig;
+    translated._eps = _eps;
+    translated._id = _id;
+
+    const MultiFloat dx( delta.x() );
+    const MultiFloat dy( delta.y() );
+    const MultiFloat dz( delta.z() );
+
+    const MultiFloat *x = _x.constData();
+    const MultiFloat *y = _y.constData();
+    const MultiFloat *z = _z.constData();
+
+    MultiFloat *tx = translated._x.data();
+    MultiFloat *ty = translated._y.data();
+    MultiFloat *tz = translated._z.data();
+
+    for (int i=0; i<n; ++i)
+    {
+        tx[i] = x[i] + dx;
+        ty[i] = y[i] + dy;
+        tz[i] = z[i] + dz;
+    }
+}
+
 /** Return a squeezed copy of these CLJAtoms whereby all of the 
     dummy atoms are removed and atoms squeezed into a single, contiguous space */
 CLJAtoms CLJAtoms::squeeze() const
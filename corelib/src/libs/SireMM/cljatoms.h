@@ -153,6 +153,8 @@ class SIREMM_EXPORT CLJAtoms
 friend QDataStream& ::operator<<(QDataStream&, const CLJAtoms&);
 friend QDataStream& ::operator>>(QDataStream&, CLJAtoms&);
 
+friend class CLJNeighbourList;
+
 public:
     enum ID_SOURCE
     {
@@ -262,6 +264,8 @@ public:
     Vector maxCoords() const;
     
     CLJAtoms negate() const;
+    CLJAtoms translate(const Vector &delta) const;
+    void translate(const Vector &delta, CLJAtoms &translated) const;
     
     QVector<CLJAtom> atoms() const;
     
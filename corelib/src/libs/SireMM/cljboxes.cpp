@@ -1682,7 +1682,10 @@ QVector<CLJBoxDistance> CLJBoxes::getDistances(const Space &space, const CLJBoxe
 
     dists.reserve((nboxes*nboxes) / 2);
 
-    if (space.isCartesian())
+    //the fast integer box distances are only valid for vacuum or for 
+    //orthorhombic periodic boxes - other periodic spaces (e.g. TriclinicBox)
+    //use the space to calculate the minimum distances between boxes
+    if (space.isCartesian() and (space.isA<PeriodicBox>() or not space.isPeriodic()))
     {
         if (space.isPeriodic())
         {
@@ -1881,7 +1884,8 @@ QVector<CLJBoxDistance> CLJBoxes::getDistances(const Space &space, const CLJBoxe
     
     dists.reserve((n0*n1)/2);
 
-    if (space.isCartesian() and (boxes0.box_length == boxes1.box_length))
+    if (space.isCartesian() and (boxes0.box_length == boxes1.box_length) and
+        (space.isA<PeriodicBox>() or not space.isPeriodic()))
     {
         if (space.isPeriodic())
         {
@@ -31,6 +31,11 @@
 #include "cljatoms.h"
 #include "cljdelta.h"
 #include "cljboxes.h"
+#include "cljneighbourlist.h"
+
+#include "SireFF/energyprofiler.h"
+
+#include "SireError/errors.h"
 
 #include "tbb/blocked_range.h"
 #include "tbb/parallel_for.h"
@@ -484,6 +489,109 @@ namespace SireMM
             double *coul_nrg;
             double *lj_nrg;
         };
+
+        /** This is a private helper class that is used to calculate the
+            coulomb and LJ energy of each cluster in a neighbour list
+            in parallel using Intel TBB */
+        class TotalWithNeighbourList
+        {
+        public:
+            TotalWithNeighbourList() : func(0), atoms(0), neighbours(0)
+            {}
+
+            TotalWithNeighbourList(const CLJFunction* const function,
+                                   const CLJAtoms &cljatoms,
+                                   const CLJNeighbourList &neighbour_list,
+                                   double *coulomb_energy, double *lj_energy)
+                : func(function), atoms(&cljatoms), neighbours(&neighbour_list),
+                  coul_nrg(coulomb_energy), lj_nrg(lj_energy)
+            {}
+
+            ~TotalWithNeighbourList()
+            {}
+
+            void operator()(const tbb::blocked_range<int> &range) const
+            {
+                //scratch space that is reused for each cluster
+                CLJAtoms cluster, nbrs;
+
+                for (int i = range.begin(); i != range.end(); ++i)
+                {
+                    neighbours->getCluster(*atoms, i, cluster);
+
+                    //energy within the cluster
+                    func->total(cluster, coul_nrg[i], lj_nrg[i]);
+
+                    //energy with all of the neighbouring clusters
+                    neighbours->getNeighbours(*atoms, i, nbrs);
+
+                    if (not nbrs.isEmpty())
+                    {
+                        double icnrg(0), iljnrg(0);
+                        func->total(cluster, nbrs, icnrg, iljnrg);
+                        coul_nrg[i] += icnrg;
+                        lj_nrg[i] += iljnrg;
+                    }
+                }
+            }
+
+        private:
+            const CLJFunction* const func;
+            const CLJAtoms* const atoms;
+            const CLJNeighbourList* const neighbours;
+
+            double *coul_nrg;
+            double *lj_nrg;
+        };
+
+        /** This is a private helper class that is used to calculate the
+            forces on the atoms in each box in parallel using Intel TBB.
+            Each task calculates only the forces on the atoms in its own box
+            (using the full list of neighbouring boxes), so that no two tasks
+            write to the same forces */
+        class ForceWithBoxes
+        {
+        public:
+            ForceWithBoxes() : func(0), boxes(0), nbr_start(0), nbrs(0), forces(0)
+            {}
+
+            ForceWithBoxes(const CLJFunction* const function,
+                           const CLJBoxes::Container &cljboxes,
+                           const qint32* const neighbour_start,
+                           const qint32* const neighbours,
+                           CLJForces *box_forces)
+                : func(function), boxes(&cljboxes), nbr_start(neighbour_start),
+                  nbrs(neighbours), forces(box_forces)
+            {}
+
+            ~ForceWithBoxes()
+            {}
+
+            void operator()(const tbb::blocked_range<int> &range) const
+            {
+                const CLJBoxPtr* const b = boxes->constData();
+
+                for (int i = range.begin(); i != range.end(); ++i)
+                {
+                    const CLJAtoms &atoms = b[i].read().atoms();
+
+                    forces[i] = CLJForces(atoms);
+                    func->force(atoms, forces[i]);
+
+                    for (int j = nbr_start[i]; j < nbr_start[i+1]; ++j)
+                    {
+                        func->force(atoms, b[nbrs[j]].read().atoms(), forces[i]);
+                    }
+                }
+            }
+
+        private:
+            const CLJFunction* const func;
+            const CLJBoxes::Container* const boxes;
+            const qint32* const nbr_start;
+            const qint32* const nbrs;
+            CLJForces *forces;
+        };
     
     } // end of namespace detail
 } // end of namespace SireMM
@@ -504,6 +612,7 @@ tuple<double,double> CLJCalculator::calculate(const CLJFunction &func, const CLJ
         
         //get the list of box pairs that are within the cutoff distance
         QVector<CLJBoxDistance> dists = CLJBoxes::getDistances(func.space(), boxes, max_cutoff);
+        SireFF::EnergyProfiler::addPairs(dists.count());
 
         //now create the space to hold the calculated energies
         QVarLengthArray<double> coul_nrgs( dists.count() );
@@ -546,6 +655,7 @@ tuple<double,double> CLJCalculator::calculate(const CLJFunction &func, const CLJ
     {
         //get the list of box pairs that are within the cutoff distance
         QVector<CLJBoxDistance> dists = CLJBoxes::getDistances(func.space(), boxes);
+        SireFF::EnergyProfiler::addPairs(dists.count());
 
         //now create the space to hold the calculated energies
         QVarLengthArray<double> coul_nrgs( dists.count() );
@@ -640,6 +750,7 @@ tuple<double,double> CLJCalculator::calculate(const CLJFunction &func,
             //get the list of box pairs that are within the cutoff distance
             QVector<CLJBoxDistance> dists = CLJBoxes::getDistances(func.space(),
                                                                    boxes0, boxes1, max_cutoff);
+            SireFF::EnergyProfiler::addPairs(dists.count());
 
             //now create the space to hold the calculated energies
             QVarLengthArray<double> coul_nrgs( dists.count() );
@@ -684,6 +795,7 @@ tuple<double,double> CLJCalculator::calculate(const CLJFunction &func,
         {
             //get the list of box pairs that are within the cutoff distance
             QVector<CLJBoxDistance> dists = CLJBoxes::getDistances(func.space(), boxes0, boxes1);
+            SireFF::EnergyProfiler::addPairs(dists.count());
 
             //now create the space to hold the calculated energies
             QVarLengthArray<double> coul_nrgs( dists.count() );
@@ -754,6 +866,7 @@ tuple<double,double> CLJCalculator::calculate(const CLJFunction &func,
         //get the list of box pairs that are within the cutoff distance
         QVector<CLJBoxDistance> dists = CLJBoxes::getDistances(func.space(),
                                                                atoms0, boxes1, max_cutoff);
+        SireFF::EnergyProfiler::addPairs(dists.count());
 
         //first, create the space to hold the calculated energies
         QVarLengthArray<double> coul_nrgs(dists.count());
@@ -834,6 +947,170 @@ tuple<double,double> CLJCalculator::calculate(const CLJFunction &func,
     }
 }
 
+/** Calculate the energy between all of the atoms in 'atoms' using the passed
+    CLJFunction, using the passed Verlet neighbour list to find the pairs
+    of atoms to evaluate. The neighbour list is updated (and rebuilt only
+    if any atom has moved by more than half its skin), so should be
+    kept and passed again on the next call. This returns
+    the coulomb and LJ energy as a tuple (coulomb,lj) */
+tuple<double,double> CLJCalculator::calculate(const CLJFunction &func,
+                                              const CLJAtoms &atoms,
+                                              CLJNeighbourList &neighbours) const
+{
+    if (atoms.isEmpty())
+        return tuple<double,double>(0,0);
+
+    neighbours.update(func, atoms);
+
+    const int nclusters = neighbours.nClusters();
+
+    SireFF::EnergyProfiler::addPairs(nclusters + neighbours.nClusterPairs());
+
+    //first, create the space to hold the calculated energies
+    QVarLengthArray<double> coul_nrgs(nclusters);
+    QVarLengthArray<double> lj_nrgs(nclusters);
+
+    //now create the object that will be used by TBB to calculate the energies
+    detail::TotalWithNeighbourList helper(&func, atoms, neighbours,
+                                          coul_nrgs.data(), lj_nrgs.data());
+
+    //now perform the calculation in parallel
+    tbb::parallel_for(tbb::blocked_range<int>(0,nclusters), helper);
+
+    if (reproducible_sum)
+    {
+        //do a sorted sum of energies so that we get the same result no matter the order
+        //of calculation
+        qSort(coul_nrgs);
+        qSort(lj_nrgs);
+    }
+
+    double cnrg = 0;
+    double ljnrg = 0;
+
+    const double *coul_nrgs_array = coul_nrgs.constData();
+    const double *lj_nrgs_array = lj_nrgs.constData();
+
+    for (int i=0; i<coul_nrgs.count(); ++i)
+    {
+        cnrg += *coul_nrgs_array;
+        ljnrg += *lj_nrgs_array;
+
+        ++coul_nrgs_array;
+        ++lj_nrgs_array;
+    }
+
+    return tuple<double,double>(cnrg,ljnrg);
+}
+
+/** Calculate the forces between all of the atoms in the passed CLJBoxes
+    using the passed CLJFunction. This returns one set of forces for
+    each occupied box, in the same order as CLJBoxes::occupiedBoxes().
+    Use the CLJForces(boxes, forces, indicies) constructor to gather
+    these back into the order of the original atoms. The forces are
+    calculated in parallel over the boxes
+
+    \throw SireError::unsupported
+*/
+QVector<CLJForces> CLJCalculator::calculateForces(const CLJFunction &func,
+                                                  const CLJBoxes &boxes) const
+{
+    if (not func.supportsForceCalculation())
+        throw SireError::unsupported( QObject::tr(
+                "The CLJFunction \"%1\" does not support the calculation of forces.")
+                    .arg(func.what()), CODELOC );
+
+    const int nboxes = boxes.nOccupiedBoxes();
+
+    if (nboxes == 0)
+        return QVector<CLJForces>();
+
+    //get the list of box pairs that are within the cutoff distance
+    QVector<CLJBoxDistance> dists;
+
+    if (func.hasCutoff())
+    {
+        Length coul_cutoff = func.coulombCutoff();
+        Length lj_cutoff = func.ljCutoff();
+
+        Length max_cutoff( coul_cutoff.value() >= lj_cutoff.value() ?
+                           coul_cutoff : lj_cutoff );
+
+        dists = CLJBoxes::getDistances(func.space(), boxes, max_cutoff);
+    }
+    else
+    {
+        dists = CLJBoxes::getDistances(func.space(), boxes);
+    }
+
+    //convert the list of pairs into a full neighbour list for each box
+    QVector<qint32> nbr_start(nboxes+1, 0);
+
+    for (int i=0; i<dists.count(); ++i)
+    {
+        const CLJBoxDistance &dist = dists.constData()[i];
+
+        if (dist.box0() != dist.box1())
+        {
+            nbr_start[dist.box0()+1] += 1;
+            nbr_start[dist.box1()+1] += 1;
+        }
+    }
+
+    for (int i=0; i<nboxes; ++i)
+    {
+        nbr_start[i+1] += nbr_start[i];
+    }
+
+    QVector<qint32> nbrs(nbr_start[nboxes]);
+    QVector<qint32> filled(nboxes, 0);
+
+    for (int i=0; i<dists.count(); ++i)
+    {
+        const CLJBoxDistance &dist = dists.constData()[i];
+
+        if (dist.box0() != dist.box1())
+        {
+            nbrs[ nbr_start[dist.box0()] + filled[dist.box0()] ] = dist.box1();
+            filled[dist.box0()] += 1;
+            nbrs[ nbr_start[dist.box1()] + filled[dist.box1()] ] = dist.box0();
+            filled[dist.box1()] += 1;
+        }
+    }
+
+    //now create the space to hold the calculated forces
+    QVector<CLJForces> forces(nboxes);
+
+    //now create the object that will be used by TBB to calculate the forces
+    detail::ForceWithBoxes helper(&func, boxes.occupiedBoxes(),
+                                  nbr_start.constData(), nbrs.constData(),
+                                  forces.data());
+
+    //now perform the calculation in parallel
+    tbb::parallel_for(tbb::blocked_range<int>(0,nboxes), helper);
+
+    return forces;
+}
+
+/** Calculate the forces between all of the atoms in 'atoms' using the
+    passed CLJFunction. The atoms are divided into boxes so that the
+    forces can be calculated in parallel. The forces are returned in
+    the same order as the atoms in 'atoms'
+
+    \throw SireError::unsupported
+*/
+CLJForces CLJCalculator::calculateForces(const CLJFunction &func,
+                                         const CLJAtoms &atoms) const
+{
+    if (atoms.isEmpty())
+        return CLJForces();
+
+    CLJBoxes boxes;
+    const QVector<CLJBoxIndex> idxs = boxes.add(atoms);
+
+    return CLJForces(boxes, this->calculateForces(func, boxes), idxs);
+}
+
 /** Calculate the energy between all of the atoms in the passed CLJBoxes
     using the passed array of CLJFunctions, returning the energies as
     a tuple of arrays of the coulomb and LJ energy (coulomb,lj) */
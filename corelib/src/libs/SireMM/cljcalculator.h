@@ -31,6 +31,7 @@
 
 #include "cljfunction.h"
 #include "cljboxes.h"
+#include "cljneighbourlist.h"
 
 #include <boost/tuple/tuple.hpp>
 
@@ -90,6 +91,16 @@ public:
                                           const CLJAtoms &atoms0,
                                           const CLJBoxes &boxes1) const;
 
+    boost::tuple<double,double> calculate(const CLJFunction &func,
+                                          const CLJAtoms &atoms,
+                                          CLJNeighbourList &neighbours) const;
+
+    CLJForces calculateForces(const CLJFunction &func,
+                              const CLJAtoms &atoms) const;
+
+    QVector<CLJForces> calculateForces(const CLJFunction &func,
+                                       const CLJBoxes &boxes) const;
+
     boost::tuple< QVector<double>, QVector<double> >
             calculate( const QVector<CLJFunctionPtr> &funcs,
                        const CLJBoxes &boxes0, const CLJBoxes &boxes1) const;
@@ -0,0 +1,654 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "cljewald.h"
+#include "cljboxes.h"
+
+#include "SireMaths/multiint.h"
+#include "SireMaths/constants.h"
+
+#include "SireError/errors.h"
+
+#include "SireStream/datastream.h"
+#include "SireStream/shareddatastream.h"
+
+using namespace SireMM;
+using namespace SireMaths;
+using namespace SireVol;
+using namespace SireStream;
+
+static const RegisterMetaType<CLJEwald> r_ewald(NO_ROOT);
+
+/** The default number of accepted changes after which the
+    structure factors should be rebuilt from scratch */
+static const qint32 default_refresh_interval = 1000;
+
+QDataStream SIREMM_EXPORT &operator<<(QDataStream &ds, const CLJEwald &ewald)
+{
+    writeHeader(ds, r_ewald, 2);
+
+    SharedDataStream sds(ds);
+
+    sds << ewald.func << ewald.kmax
+        << MultiDouble::toArray(ewald.s_re) << MultiDouble::toArray(ewald.s_im)
+        << ewald.recip_nrg << ewald.corr_nrg
+        << ewald.refresh_interval << ewald.naccepted;
+
+    return ds;
+}
+
+QDataStream SIREMM_EXPORT &operator>>(QDataStream &ds, CLJEwald &ewald)
+{
+    VersionID v = readHeader(ds, r_ewald);
+
+    if (v == 1 or v == 2)
+    {
+        SharedDataStream sds(ds);
+
+        QVector<double> s_re, s_im;
+
+        sds >> ewald.func >> ewald.kmax >> s_re >> s_im
+            >> ewald.recip_nrg >> ewald.corr_nrg;
+
+        if (v == 2)
+        {
+            sds >> ewald.refresh_interval >> ewald.naccepted;
+        }
+        else
+        {
+            ewald.refresh_interval = default_refresh_interval;
+            ewald.naccepted = 0;
+        }
+
+        ewald.revert();
+
+        if (s_re.isEmpty())
+        {
+            ewald.nk = 0;
+            ewald.kx.clear();
+            ewald.ky.clear();
+            ewald.kz.clear();
+            ewald.kcoeff.clear();
+            ewald.s_re.clear();
+            ewald.s_im.clear();
+        }
+        else
+        {
+            ewald.buildKVectors();
+            ewald.s_re = MultiDouble::fromArray(s_re);
+            ewald.s_im = MultiDouble::fromArray(s_im);
+        }
+    }
+    else
+        throw version_error(v, "1, 2", r_ewald, CODELOC);
+
+    return ds;
+}
+
+/** Constructor */
+CLJEwald::CLJEwald()
+         : kmax(0), nk(0), recip_nrg(0), corr_nrg(0),
+           delta_recip_nrg(0), delta_corr_nrg(0),
+           refresh_interval(default_refresh_interval), naccepted(0),
+           needs_accepting(false)
+{}
+
+/** Construct to use the passed function to define the Ewald sum. The
+    number of k-vectors is chosen automatically from the Ewald precision */
+CLJEwald::CLJEwald(const CLJSPMEFunction &function)
+         : func(function), kmax(0), nk(0), recip_nrg(0), corr_nrg(0),
+           delta_recip_nrg(0), delta_corr_nrg(0),
+           refresh_interval(default_refresh_interval), naccepted(0),
+           needs_accepting(false)
+{}
+
+/** Construct to use the passed function to define the Ewald sum, using
+    k-vectors with integer components up to 'kmax' along each dimension */
+CLJEwald::CLJEwald(const CLJSPMEFunction &function, qint32 k_max)
+         : func(function), kmax(k_max), nk(0), recip_nrg(0), corr_nrg(0),
+           delta_recip_nrg(0), delta_corr_nrg(0),
+           refresh_interval(default_refresh_interval), naccepted(0),
+           needs_accepting(false)
+{
+    if (kmax < 0)
+        throw SireError::invalid_arg( QObject::tr(
+                "The maximum k-vector index (%1) cannot be negative.").arg(kmax), CODELOC );
+}
+
+/** Construct the Ewald sum for the passed atoms using the passed function
+
+    \throw SireError::incompatible_error
+*/
+CLJEwald::CLJEwald(const CLJSPMEFunction &function, const CLJAtoms &atoms)
+         : func(function), kmax(0), nk(0), recip_nrg(0), corr_nrg(0),
+           delta_recip_nrg(0), delta_corr_nrg(0),
+           refresh_interval(default_refresh_interval), naccepted(0),
+           needs_accepting(false)
+{
+    this->setAtoms(atoms);
+}
+
+/** Construct the Ewald sum for the passed atoms using the passed function
+
+    \throw SireError::incompatible_error
+*/
+CLJEwald::CLJEwald(const CLJSPMEFunction &function, const CLJBoxes &atoms)
+         : func(function), kmax(0), nk(0), recip_nrg(0), corr_nrg(0),
+           delta_recip_nrg(0), delta_corr_nrg(0),
+           refresh_interval(default_refresh_interval), naccepted(0),
+           needs_accepting(false)
+{
+    this->setAtoms(atoms);
+}
+
+/** Copy constructor */
+CLJEwald::CLJEwald(const CLJEwald &other)
+         : func(other.func), kmax(other.kmax), nk(other.nk),
+           kx(other.kx), ky(other.ky), kz(other.kz), kcoeff(other.kcoeff),
+           s_re(other.s_re), s_im(other.s_im),
+           delta_re(other.delta_re), delta_im(other.delta_im),
+           recip_nrg(other.recip_nrg), corr_nrg(other.corr_nrg),
+           delta_recip_nrg(other.delta_recip_nrg), delta_corr_nrg(other.delta_corr_nrg),
+           refresh_interval(other.refresh_interval), naccepted(other.naccepted),
+           needs_accepting(other.needs_accepting)
+{}
+
+/** Destructor */
+CLJEwald::~CLJEwald()
+{}
+
+/** Copy assignment operator */
+CLJEwald& CLJEwald::operator=(const CLJEwald &other)
+{
+    if (this != &other)
+    {
+        func = other.func;
+        kmax = other.kmax;
+        nk = other.nk;
+        kx = other.kx;
+        ky = other.ky;
+        kz = other.kz;
+        kcoeff = other.kcoeff;
+        s_re = other.s_re;
+        s_im = other.s_im;
+        delta_re = other.delta_re;
+        delta_im = other.delta_im;
+        recip_nrg = other.recip_nrg;
+        corr_nrg = other.corr_nrg;
+        delta_recip_nrg = other.delta_recip_nrg;
+        delta_corr_nrg = other.delta_corr_nrg;
+        refresh_interval = other.refresh_interval;
+        naccepted = other.naccepted;
+        needs_accepting = other.needs_accepting;
+    }
+
+    return *this;
+}
+
+/** Comparison operator */
+bool CLJEwald::operator==(const CLJEwald &other) const
+{
+    return func == other.func and kmax == other.kmax and nk == other.nk and
+           recip_nrg == other.recip_nrg and corr_nrg == other.corr_nrg and
+           refresh_interval == other.refresh_interval and
+           needs_accepting == other.needs_accepting and
+           MultiDouble::toArray(s_re) == MultiDouble::toArray(other.s_re) and
+           MultiDouble::toArray(s_im) == MultiDouble::toArray(other.s_im);
+}
+
+/** Comparison operator */
+bool CLJEwald::operator!=(const CLJEwald &other) const
+{
+    return not operator==(other);
+}
+
+const char* CLJEwald::typeName()
+{
+    return QMetaType::typeName( qMetaTypeId<CLJEwald>() );
+}
+
+const char* CLJEwald::what() const
+{
+    return CLJEwald::typeName();
+}
+
+QString CLJEwald::toString() const
+{
+    if (this->isEmpty())
+        return QObject::tr("CLJEwald::null");
+    else
+        return QObject::tr("CLJEwald( nKVectors() == %1, energy() == %2 )")
+                    .arg(nk).arg(this->energy());
+}
+
+/** Return whether or not this Ewald sum is empty (no atoms have been set) */
+bool CLJEwald::isEmpty() const
+{
+    return s_re.isEmpty();
+}
+
+/** Return the function used to define the Ewald sum */
+const CLJSPMEFunction& CLJEwald::function() const
+{
+    return func;
+}
+
+/** Return the maximum k-vector index along each dimension. This
+    is zero if the k-vectors are chosen automatically */
+qint32 CLJEwald::kMax() const
+{
+    return kmax;
+}
+
+/** Return the number of k-vectors in the (half) reciprocal space sum */
+int CLJEwald::nKVectors() const
+{
+    return nk;
+}
+
+/** Internal function used to build the k-vectors for the current box.
+    Only half of k-space is used, as S(-k) is the complex conjugate of S(k)
+
+    \throw SireError::incompatible_error
+*/
+void CLJEwald::buildKVectors()
+{
+    const Vector box = func.boxDimensions();
+    const double beta = func.beta();
+
+    //exp(-k^2 / 4 beta^2) falls below the Ewald precision for k > kcut
+    const double log_precision = -std::log(func.ewaldPrecision());
+    const double kcut2 = 4.0 * beta * beta * log_precision;
+
+    int nmax[3];
+
+    for (int i=0; i<3; ++i)
+    {
+        if (kmax > 0)
+            nmax[i] = kmax;
+        else
+            nmax[i] = qMax(1, int(std::ceil( beta * box[i] *
+                                             std::sqrt(log_precision) / SireMaths::pi )));
+    }
+
+    const double volume = box.x() * box.y() * box.z();
+    const double prefactor = 4.0 * SireMaths::pi / volume;
+
+    QVector<float> nx, ny, nz;
+    QVector<double> coeffs;
+
+    for (int i=0; i<=nmax[0]; ++i)
+    {
+        const double kxi = 2.0 * SireMaths::pi * i / box.x();
+
+        for (int j=-nmax[1]; j<=nmax[1]; ++j)
+        {
+            if (i == 0 and j < 0)
+                continue;
+
+            const double kyj = 2.0 * SireMaths::pi * j / box.y();
+
+            for (int k=-nmax[2]; k<=nmax[2]; ++k)
+            {
+                if (i == 0 and j == 0 and k <= 0)
+                    continue;
+
+                const double kzk = 2.0 * SireMaths::pi * k / box.z();
+                const double k2 = kxi*kxi + kyj*kyj + kzk*kzk;
+
+                if (kmax == 0 and k2 > kcut2)
+                    continue;
+
+                nx.append(i);
+                ny.append(j);
+                nz.append(k);
+                coeffs.append( prefactor * std::exp(-k2 / (4.0*beta*beta)) / k2 );
+            }
+        }
+    }
+
+    nk = coeffs.count();
+
+    //pad the last vector with zero-weighted k-vectors
+    while (coeffs.count() % MultiFloat::count() != 0)
+    {
+        nx.append(0);
+        ny.append(0);
+        nz.append(0);
+        coeffs.append(0);
+    }
+
+    kx = MultiFloat::fromArray(nx);
+    ky = MultiFloat::fromArray(ny);
+    kz = MultiFloat::fromArray(nz);
+    kcoeff = MultiDouble::fromArray(coeffs);
+}
+
+/** Internal function that adds 'scale' times the contribution of the passed
+    atoms to the structure factors in 're' and 'im'. This is the hot loop of
+    the calculation, and is vectorised over the k-vectors */
+void CLJEwald::addStructureFactors(const CLJAtoms &atoms, double scale,
+                                   MultiDouble *re, MultiDouble *im) const
+{
+    const MultiFloat *xa = atoms.x().constData();
+    const MultiFloat *ya = atoms.y().constData();
+    const MultiFloat *za = atoms.z().constData();
+    const MultiFloat *qa = atoms.q().constData();
+    const MultiInt *ida = atoms.ID().constData();
+
+    const qint32 dummy_int = CLJAtoms::idOfDummy()[0];
+
+    const MultiFloat *kxa = kx.constData();
+    const MultiFloat *kya = ky.constData();
+    const MultiFloat *kza = kz.constData();
+
+    const Vector box = func.boxDimensions();
+    const double two_pi = 2.0 * SireMaths::pi;
+
+    const int nvecs = kx.count();
+
+    MultiFloat phase, sin_phase, cos_phase;
+
+    for (int i=0; i<atoms.x().count(); ++i)
+    {
+        for (int ii=0; ii<MultiFloat::count(); ++ii)
+        {
+            if (ida[i][ii] == dummy_int or qa[i][ii] == 0)
+                continue;
+
+            //wrap the atom into the box in double precision, so that
+            //the phases remain small enough to be accurate in single precision
+            double fx = xa[i][ii] / box.x();
+            double fy = ya[i][ii] / box.y();
+            double fz = za[i][ii] / box.z();
+
+            const MultiFloat ux( two_pi * (fx - std::floor(fx)) );
+            const MultiFloat uy( two_pi * (fy - std::floor(fy)) );
+            const MultiFloat uz( two_pi * (fz - std::floor(fz)) );
+
+            const MultiFloat q( scale * qa[i][ii] );
+
+            for (int k=0; k<nvecs; ++k)
+            {
+                phase = kxa[k] * ux;
+                phase.multiplyAdd(kya[k], uy);
+                phase.multiplyAdd(kza[k], uz);
+
+                sincos(phase, sin_phase, cos_phase);
+
+                re[k] += MultiDouble(q * cos_phase);
+                im[k] += MultiDouble(q * sin_phase);
+            }
+        }
+    }
+}
+
+/** Internal function used to return the reciprocal space energy of the
+    passed structure factors */
+double CLJEwald::structureEnergy(const MultiDouble *re, const MultiDouble *im) const
+{
+    const MultiDouble *c = kcoeff.constData();
+
+    MultiDouble nrg(0);
+
+    for (int k=0; k<kcoeff.count(); ++k)
+    {
+        MultiDouble s2 = re[k] * re[k];
+        s2.multiplyAdd(im[k], im[k]);
+        nrg.multiplyAdd(c[k], s2);
+    }
+
+    return nrg.sum();
+}
+
+/** Recalculate the structure factors from scratch for the passed atoms.
+    This discards any pending change
+
+    \throw SireError::incompatible_error
+*/
+void CLJEwald::setAtoms(const CLJAtoms &atoms)
+{
+    this->buildKVectors();
+
+    s_re = QVector<MultiDouble>(kcoeff.count(), MultiDouble(0));
+    s_im = QVector<MultiDouble>(kcoeff.count(), MultiDouble(0));
+
+    this->addStructureFactors(atoms, 1.0, s_re.data(), s_im.data());
+
+    recip_nrg = this->structureEnergy(s_re.constData(), s_im.constData());
+    corr_nrg = func.selfEnergy(atoms) + func.exclusionEnergy(atoms);
+
+    naccepted = 0;
+
+    this->revert();
+}
+
+/** Recalculate the structure factors from scratch for the passed atoms.
+    This discards any pending change
+
+    \throw SireError::incompatible_error
+*/
+void CLJEwald::setAtoms(const CLJBoxes &atoms)
+{
+    this->setAtoms(atoms.atoms());
+}
+
+/** Return the long-range energy (reciprocal space, self and exclusion)
+    of the atoms. This does not include any pending change */
+double CLJEwald::energy() const
+{
+    return recip_nrg + corr_nrg;
+}
+
+/** Return the reciprocal space energy of the atoms */
+double CLJEwald::reciprocalEnergy() const
+{
+    return recip_nrg;
+}
+
+/** Return the sum of the self and exclusion energies of the atoms */
+double CLJEwald::correctionEnergy() const
+{
+    return corr_nrg;
+}
+
+/** Return the real parts of the cached structure factors, one for
+    each of the nKVectors() k-vectors */
+QVector<double> CLJEwald::realStructureFactors() const
+{
+    return MultiDouble::toArray(s_re).mid(0, nk);
+}
+
+/** Return the imaginary parts of the cached structure factors, one for
+    each of the nKVectors() k-vectors */
+QVector<double> CLJEwald::imaginaryStructureFactors() const
+{
+    return MultiDouble::toArray(s_im).mid(0, nk);
+}
+
+/** Set the number of accepted changes after which needsRefresh will
+    return true
+
+    \throw SireError::invalid_arg
+*/
+void CLJEwald::setRefreshInterval(qint32 interval)
+{
+    if (interval <= 0)
+        throw SireError::invalid_arg( QObject::tr(
+                "The refresh interval (%1) must be greater than zero.")
+                    .arg(interval), CODELOC );
+
+    refresh_interval = interval;
+}
+
+/** Return the number of accepted changes after which needsRefresh
+    will return true */
+qint32 CLJEwald::refreshInterval() const
+{
+    return refresh_interval;
+}
+
+/** Return the number of changes that have been accepted since the
+    structure factors were last built from scratch by setAtoms */
+qint32 CLJEwald::nAccepted() const
+{
+    return naccepted;
+}
+
+/** Return whether or not enough changes have been accepted that the
+    structure factors should be rebuilt from scratch, by passing the
+    current atoms to setAtoms. This limits the drift of the cached
+    structure factors caused by the single precision contributions
+    of the moved atoms */
+bool CLJEwald::needsRefresh() const
+{
+    return naccepted >= refresh_interval;
+}
+
+/** Calculate the change in the long-range energy caused by changing
+    the atoms in 'old_atoms' into the atoms in 'new_atoms'. Only the
+    changed atoms are visited, so this scales as O(N_changed x N_k).
+    The change is held as pending until accept or revert are called.
+    Calling this function while a change is pending will replace that change.
+
+    \throw SireError::invalid_state
+*/
+double CLJEwald::calculateDelta(const CLJAtoms &old_atoms, const CLJAtoms &new_atoms)
+{
+    if (this->isEmpty())
+        throw SireError::invalid_state( QObject::tr(
+                "You cannot calculate the change in energy using an empty CLJEwald. "
+                "Please call setAtoms first."), CODELOC );
+
+    delta_re = QVector<MultiDouble>(kcoeff.count(), MultiDouble(0));
+    delta_im = QVector<MultiDouble>(kcoeff.count(), MultiDouble(0));
+
+    MultiDouble *dre = delta_re.data();
+    MultiDouble *dim = delta_im.data();
+
+    this->addStructureFactors(new_atoms, 1.0, dre, dim);
+    this->addStructureFactors(old_atoms, -1.0, dre, dim);
+
+    //the change in energy is sum_k c(k) * ( |S(k) + dS(k)|^2 - |S(k)|^2 )
+    const MultiDouble *re = s_re.constData();
+    const MultiDouble *im = s_im.constData();
+    const MultiDouble *c = kcoeff.constData();
+
+    const MultiDouble two(2.0);
+
+    MultiDouble delta(0);
+    MultiDouble tmp;
+
+    for (int k=0; k<kcoeff.count(); ++k)
+    {
+        tmp = two * re[k];
+        tmp += dre[k];
+        tmp *= dre[k];
+
+        MultiDouble tmp2 = two * im[k];
+        tmp2 += dim[k];
+        tmp.multiplyAdd(tmp2, dim[k]);
+
+        delta.multiplyAdd(c[k], tmp);
+    }
+
+    delta_recip_nrg = delta.sum();
+
+    delta_corr_nrg = func.selfEnergy(new_atoms) - func.selfEnergy(old_atoms) +
+                     func.exclusionEnergy(new_atoms) - func.exclusionEnergy(old_atoms);
+
+    needs_accepting = true;
+
+    return delta_recip_nrg + delta_corr_nrg;
+}
+
+/** Calculate the change in the long-range energy caused by the passed delta.
+    The change is held as pending until accept or revert are called.
+
+    \throw SireError::invalid_state
+*/
+double CLJEwald::calculateDelta(const CLJDelta &delta)
+{
+    return this->calculateDelta(delta.oldAtoms(), delta.newAtoms());
+}
+
+/** Calculate the change in the long-range energy caused by the passed deltas
+    (e.g. from a move that changes several molecules at once). The change is
+    held as pending until accept or revert are called.
+
+    \throw SireError::invalid_state
+*/
+double CLJEwald::calculateDelta(const QVector<CLJDelta> &deltas)
+{
+    return this->calculateDelta( CLJDelta::mergeOld(deltas), CLJDelta::mergeNew(deltas) );
+}
+
+/** Return whether or not there is a pending change that needs to be
+    accepted or reverted */
+bool CLJEwald::needsAccepting() const
+{
+    return needs_accepting;
+}
+
+/** Accept the pending change, adding it into the cached structure factors.
+    The reciprocal space energy is recalculated from the updated structure
+    factors, so that it does not drift away from them */
+void CLJEwald::accept()
+{
+    if (not needs_accepting)
+        return;
+
+    MultiDouble *re = s_re.data();
+    MultiDouble *im = s_im.data();
+
+    const MultiDouble *dre = delta_re.constData();
+    const MultiDouble *dim = delta_im.constData();
+
+    for (int k=0; k<s_re.count(); ++k)
+    {
+        re[k] += dre[k];
+        im[k] += dim[k];
+    }
+
+    recip_nrg = this->structureEnergy(s_re.constData(), s_im.constData());
+    corr_nrg += delta_corr_nrg;
+
+    naccepted += 1;
+
+    this->revert();
+}
+
+/** Revert (discard) the pending change */
+void CLJEwald::revert()
+{
+    delta_re = QVector<MultiDouble>();
+    delta_im = QVector<MultiDouble>();
+    delta_recip_nrg = 0;
+    delta_corr_nrg = 0;
+    needs_accepting = false;
+}
@@ -0,0 +1,205 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#ifndef SIREMM_CLJEWALD_H
+#define SIREMM_CLJEWALD_H
+
+#include "cljspmefunction.h"
+
+#include "SireMaths/multifloat.h"
+#include "SireMaths/multidouble.h"
+
+SIRE_BEGIN_HEADER
+
+namespace SireMM
+{
+class CLJEwald;
+}
+
+QDataStream& operator<<(QDataStream&, const SireMM::CLJEwald&);
+QDataStream& operator>>(QDataStream&, SireMM::CLJEwald&);
+
+namespace SireMM
+{
+
+using SireMaths::MultiFloat;
+using SireMaths::MultiDouble;
+
+/** This class calculates the reciprocal space part of a standard Ewald sum,
+    caching the structure factor S(k) = sum_i q_i exp(i k.r_i) of every
+    k-vector. This makes it well suited to Monte Carlo moves that change
+    only one or a few molecules, as the change in the reciprocal space energy
+    can be calculated in O(N_moved x N_k) by adding the contributions of
+    only the moved atoms (using the old and new coordinates held in a CLJDelta)
+    into the cached structure factors. The loop over k-vectors is vectorised
+    using MultiFloat.
+
+    The Ewald screening parameter and the periodic box are taken from a
+    CLJSPMEFunction, whose pair functions calculate the matching real space
+    energy. The long-range energy returned by this class is the sum of the
+    reciprocal space, self and excluded-pair energies, and so can be used
+    in place of CLJSPMEMesh when the number of k-vectors is small.
+
+    As for CLJSPMEMesh, calculateDelta must be followed by either accept
+    or revert.
+
+    The contributions of the moved atoms are calculated in single precision,
+    so every accepted change adds a rounding error of about 1e-6 |q| per
+    moved atom to each cached structure factor. These errors are independent,
+    so the drift in S(k) grows roughly as the square root of the number of
+    accepted changes (the reciprocal space energy is always recalculated
+    from the cached structure factors, so stays consistent with them).
+    needsRefresh returns true once refreshInterval() changes have been
+    accepted, at which point the owner should call setAtoms with the
+    current atoms to rebuild the structure factors from scratch.
+
+    @author Christopher Woods
+*/
+class SIREMM_EXPORT CLJEwald
+{
+
+friend QDataStream& ::operator<<(QDataStream&, const CLJEwald&);
+friend QDataStream& ::operator>>(QDataStream&, CLJEwald&);
+
+public:
+    CLJEwald();
+    CLJEwald(const CLJSPMEFunction &function);
+    CLJEwald(const CLJSPMEFunction &function, qint32 kmax);
+    CLJEwald(const CLJSPMEFunction &function, const CLJAtoms &atoms);
+    CLJEwald(const CLJSPMEFunction &function, const CLJBoxes &atoms);
+
+    CLJEwald(const CLJEwald &other);
+
+    ~CLJEwald();
+
+    CLJEwald& operator=(const CLJEwald &other);
+
+    bool operator==(const CLJEwald &other) const;
+    bool operator!=(const CLJEwald &other) const;
+
+    static const char* typeName();
+    const char* what() const;
+
+    QString toString() const;
+
+    bool isEmpty() const;
+
+    const CLJSPMEFunction& function() const;
+
+    qint32 kMax() const;
+    int nKVectors() const;
+
+    void setAtoms(const CLJAtoms &atoms);
+    void setAtoms(const CLJBoxes &atoms);
+
+    double energy() const;
+    double reciprocalEnergy() const;
+    double correctionEnergy() const;
+
+    QVector<double> realStructureFactors() const;
+    QVector<double> imaginaryStructureFactors() const;
+
+    void setRefreshInterval(qint32 interval);
+    qint32 refreshInterval() const;
+
+    qint32 nAccepted() const;
+    bool needsRefresh() const;
+
+    double calculateDelta(const CLJAtoms &old_atoms, const CLJAtoms &new_atoms);
+    double calculateDelta(const CLJDelta &delta);
+    double calculateDelta(const QVector<CLJDelta> &deltas);
+
+    bool needsAccepting() const;
+
+    void accept();
+    void revert();
+
+private:
+    void buildKVectors();
+
+    void addStructureFactors(const CLJAtoms &atoms, double scale,
+                             MultiDouble *re, MultiDouble *im) const;
+
+    double structureEnergy(const MultiDouble *re, const MultiDouble *im) const;
+
+    /** The function used to define the Ewald sum */
+    CLJSPMEFunction func;
+
+    /** The maximum k-vector index along each dimension. If this
+        is zero then it is chosen automatically from the Ewald precision */
+    qint32 kmax;
+
+    /** The number of k-vectors */
+    qint32 nk;
+
+    /** The integer components of each k-vector (half of k-space) */
+    QVector<MultiFloat> kx, ky, kz;
+
+    /** The prefactor of each k-vector, (4 pi / V) exp(-k^2 / 4 beta^2) / k^2,
+        which is zero for the padding at the end of the last vector */
+    QVector<MultiDouble> kcoeff;
+
+    /** The real and imaginary parts of the cached structure factors */
+    QVector<MultiDouble> s_re, s_im;
+
+    /** The change in the structure factors caused by the pending change */
+    QVector<MultiDouble> delta_re, delta_im;
+
+    /** The reciprocal space energy of the cached structure factors */
+    double recip_nrg;
+
+    /** The sum of the self and exclusion energies */
+    double corr_nrg;
+
+    /** The pending change in reciprocal space energy */
+    double delta_recip_nrg;
+
+    /** The pending change in self and exclusion energy */
+    double delta_corr_nrg;
+
+    /** The number of accepted changes after which the structure
+        factors should be rebuilt from scratch */
+    qint32 refresh_interval;
+
+    /** The number of changes accepted since the structure factors
+        were last built from scratch */
+    qint32 naccepted;
+
+    /** Whether or not there is a pending change */
+    bool needs_accepting;
+};
+
+}
+
+Q_DECLARE_METATYPE( SireMM::CLJEwald )
+
+SIRE_EXPOSE_CLASS( SireMM::CLJEwald )
+
+SIRE_END_HEADER
+
+#endif
@@ -379,6 +379,27 @@ CLJAtoms::ID_SOURCE CLJExtractor::idSource() const
     return id_source;
 }
 
+/** Return the indicies of the atoms of this molecule in the CLJBoxes, in the
+    order in which the atoms were extracted. Atoms that were not added to
+    the boxes are skipped */
+QVector<CLJBoxIndex> CLJExtractor::boxIndicies() const
+{
+    QVector<CLJBoxIndex> idxs;
+
+    for (int i=0; i<cljidxs.count(); ++i)
+    {
+        const QVector<CLJBoxIndex> &cgidxs = cljidxs.at(i);
+
+        for (int j=0; j<cgidxs.count(); ++j)
+        {
+            if (not cgidxs.at(j).isNull())
+                idxs.append(cgidxs.at(j));
+        }
+    }
+
+    return idxs;
+}
+
 /** Add the extra atoms in 'new_molecule' to the molecule */
 void CLJExtractor::add(const MoleculeView &new_molecule, CLJBoxes &boxes, CLJWorkspace &workspace)
 {
@@ -130,6 +130,8 @@ public:
     bool extractingByMolecule() const;
     
     CLJAtoms::ID_SOURCE idSource() const;
+
+    QVector<CLJBoxIndex> boxIndicies() const;
     
     void add(const MoleculeView &new_molecule, CLJBoxes &boxes, CLJWorkspace &workspace);
     void add(const AtomSelection &new_selection, CLJBoxes &boxes, CLJWorkspace &workspace);
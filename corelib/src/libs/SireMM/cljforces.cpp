@@ -0,0 +1,632 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include <QHash>
+
+#include "cljforces.h"
+#include "cljboxes.h"
+
+#include "atomljs.h"
+
+#include "SireMol/atomcharges.h"
+#include "SireMol/moleculegroup.h"
+#include "SireMol/molecule.h"
+#include "SireMol/moleculeinfodata.h"
+#include "SireMol/partialmolecule.h"
+#include "SireMol/selector.hpp"
+#include "SireMol/atom.h"
+#include "SireMol/molidx.h"
+
+#include "SireID/index.h"
+
+#include "SireFF/forcetable.h"
+
+#include "SireError/errors.h"
+
+#include "SireStream/datastream.h"
+#include "SireStream/shareddatastream.h"
+
+using namespace SireMM;
+using namespace SireMol;
+using namespace SireFF;
+using namespace SireBase;
+using namespace SireStream;
+
+static const RegisterMetaType<CLJForces> r_cljforces(NO_ROOT);
+
+QDataStream SIREMM_EXPORT &operator<<(QDataStream &ds, const CLJForces &forces)
+{
+    writeHeader(ds, r_cljforces, 1);
+    
+    SharedDataStream sds(ds);
+    sds << forces.forces();
+    
+    return ds;
+}
+
+QDataStream SIREMM_EXPORT &operator>>(QDataStream &ds, CLJForces &forces)
+{
+    VersionID v = readHeader(ds, r_cljforces);
+    
+    if (v == 1)
+    {
+        SharedDataStream sds(ds);
+        
+        QVector<Vector> f;
+        sds >> f;
+        
+        forces = CLJForces(f);
+    }
+    else
+        throw version_error(v, "1", r_cljforces, CODELOC);
+    
+    return ds;
+}
+
+/** Null constructor */
+CLJForces::CLJForces()
+{}
+
+/** Construct space for the (zero) forces on 'natoms' atoms. Note that
+    the number of atoms will be padded to a multiple of MultiFloat::count() */
+CLJForces::CLJForces(int natoms)
+{
+    if (natoms > 0)
+    {
+        const int nvecs = (natoms + MultiFloat::count() - 1) / MultiFloat::count();
+        
+        _fx = QVector<MultiFloat>(nvecs, MultiFloat(0));
+        _fy = QVector<MultiFloat>(nvecs, MultiFloat(0));
+        _fz = QVector<MultiFloat>(nvecs, MultiFloat(0));
+    }
+}
+
+/** Construct space for the (zero) forces on the passed atoms */
+CLJForces::CLJForces(const CLJAtoms &atoms)
+{
+    const int nvecs = atoms.x().count();
+    
+    if (nvecs > 0)
+    {
+        _fx = QVector<MultiFloat>(nvecs, MultiFloat(0));
+        _fy = QVector<MultiFloat>(nvecs, MultiFloat(0));
+        _fz = QVector<MultiFloat>(nvecs, MultiFloat(0));
+    }
+}
+
+/** Construct from the passed array of forces */
+CLJForces::CLJForces(const QVector<Vector> &forces)
+{
+    if (not forces.isEmpty())
+    {
+        const int n = forces.count();
+        
+        QVector<float> xf(n);
+        QVector<float> yf(n);
+        QVector<float> zf(n);
+        
+        for (int i=0; i<n; ++i)
+        {
+            const Vector &f = forces.constData()[i];
+            xf[i] = f.x();
+            yf[i] = f.y();
+            zf[i] = f.z();
+        }
+        
+        _fx = MultiFloat::fromArray(xf);
+        _fy = MultiFloat::fromArray(yf);
+        _fz = MultiFloat::fromArray(zf);
+    }
+}
+
+/** Construct by gathering the forces on the atoms in the passed CLJBoxes
+    at the indicies 'atoms' (e.g. as returned from CLJBoxes::add). The forces
+    in 'box_forces' must be in the same order as the occupied boxes in 'boxes',
+    as returned from CLJFunction::force or CLJCalculator::calculateForces. The
+    forces are returned in the same order as the indicies in 'atoms'
+    
+    \throw SireError::incompatible_error
+*/
+CLJForces::CLJForces(const CLJBoxes &boxes, const QVector<CLJForces> &box_forces,
+                     const QVector<CLJBoxIndex> &atoms)
+{
+    if (box_forces.count() != boxes.nOccupiedBoxes())
+        throw SireError::incompatible_error( QObject::tr(
+                "Cannot gather the forces as the number of force arrays (%1) is not "
+                "equal to the number of occupied boxes (%2).")
+                    .arg(box_forces.count()).arg(boxes.nOccupiedBoxes()), CODELOC );
+
+    this->operator=( CLJForces(atoms.count()) );
+    
+    //build the map from box index to the index of the box's forces
+    QHash<CLJBoxIndex,int> box_to_idx;
+    box_to_idx.reserve(boxes.nOccupiedBoxes());
+    
+    for (int i=0; i<boxes.occupiedBoxes().count(); ++i)
+    {
+        box_to_idx.insert( boxes.occupiedBoxes().constData()[i].read().index().boxOnly(), i );
+    }
+    
+    for (int i=0; i<atoms.count(); ++i)
+    {
+        const CLJBoxIndex &idx = atoms.constData()[i];
+        
+        if (idx.isNull())
+            continue;
+        
+        const int ibox = box_to_idx.value(idx.boxOnly(), -1);
+        
+        if (ibox < 0)
+            continue;
+        
+        const CLJForces &f = box_forces.constData()[ibox];
+        
+        if (idx.index() < 0 or idx.index() >= f.count())
+            continue;
+        
+        const int vec = idx.index() / MultiFloat::count();
+        const int sub = idx.index() % MultiFloat::count();
+        
+        const int ivec = i / MultiFloat::count();
+        const int isub = i % MultiFloat::count();
+        
+        _fx[ivec].set(isub, f._fx.constData()[vec][sub]);
+        _fy[ivec].set(isub, f._fy.constData()[vec][sub]);
+        _fz[ivec].set(isub, f._fz.constData()[vec][sub]);
+    }
+}
+
+/** Copy constructor */
+CLJForces::CLJForces(const CLJForces &other)
+          : _fx(other._fx), _fy(other._fy), _fz(other._fz)
+{}
+
+/** Destructor */
+CLJForces::~CLJForces()
+{}
+
+/** Copy assignment operator */
+CLJForces& CLJForces::operator=(const CLJForces &other)
+{
+    if (this != &other)
+    {
+        _fx = other._fx;
+        _fy = other._fy;
+        _fz = other._fz;
+    }
+    
+    return *this;
+}
+
+/** Comparison operator */
+bool CLJForces::operator==(const CLJForces &other) const
+{
+    return this == &other or
+           (_fx == other._fx and _fy == other._fy and _fz == other._fz);
+}
+
+/** Comparison operator */
+bool CLJForces::operator!=(const CLJForces &other) const
+{
+    return not operator==(other);
+}
+
+/** Assert that 'other' holds the forces for the same number of atoms */
+void CLJForces::assertSameSize(const CLJForces &other) const
+{
+    if (_fx.count() != other._fx.count())
+        throw SireError::incompatible_error( QObject::tr(
+                "Cannot combine forces for different numbers of atoms (%1 versus %2).")
+                    .arg(this->count()).arg(other.count()), CODELOC );
+}
+
+/** Add the forces in 'other' onto these forces */
+CLJForces& CLJForces::operator+=(const CLJForces &other)
+{
+    if (other.isEmpty())
+        return *this;
+    else if (this->isEmpty())
+        return this->operator=(other);
+    
+    assertSameSize(other);
+    
+    MultiFloat *fx = _fx.data();
+    MultiFloat *fy = _fy.data();
+    MultiFloat *fz = _fz.data();
+    
+    const MultiFloat *ofx = other._fx.constData();
+    const MultiFloat *ofy = other._fy.constData();
+    const MultiFloat *ofz = other._fz.constData();
+    
+    for (int i=0; i<_fx.count(); ++i)
+    {
+        fx[i] += ofx[i];
+        fy[i] += ofy[i];
+        fz[i] += ofz[i];
+    }
+    
+    return *this;
+}
+
+/** Subtract the forces in 'other' from these forces */
+CLJForces& CLJForces::operator-=(const CLJForces &other)
+{
+    if (other.isEmpty())
+        return *this;
+    else if (this->isEmpty())
+    {
+        this->operator=(other);
+        return this->operator*=(-1);
+    }
+    
+    assertSameSize(other);
+    
+    MultiFloat *fx = _fx.data();
+    MultiFloat *fy = _fy.data();
+    MultiFloat *fz = _fz.data();
+    
+    const MultiFloat *ofx = other._fx.constData();
+    const MultiFloat *ofy = other._fy.constData();
+    const MultiFloat *ofz = other._fz.constData();
+    
+    for (int i=0; i<_fx.count(); ++i)
+    {
+        fx[i] -= ofx[i];
+        fy[i] -= ofy[i];
+        fz[i] -= ofz[i];
+    }
+    
+    return *this;
+}
+
+/** Return the sum of these forces and 'other' */
+CLJForces CLJForces::operator+(const CLJForces &other) const
+{
+    CLJForces ret(*this);
+    ret += other;
+    return ret;
+}
+
+/** Return the difference of these forces and 'other' */
+CLJForces CLJForces::operator-(const CLJForces &other) const
+{
+    CLJForces ret(*this);
+    ret -= other;
+    return ret;
+}
+
+/** Scale all of the forces by 'value' */
+CLJForces& CLJForces::operator*=(double value)
+{
+    const MultiFloat scl(value);
+    
+    MultiFloat *fx = _fx.data();
+    MultiFloat *fy = _fy.data();
+    MultiFloat *fz = _fz.data();
+    
+    for (int i=0; i<_fx.count(); ++i)
+    {
+        fx[i] *= scl;
+        fy[i] *= scl;
+        fz[i] *= scl;
+    }
+    
+    return *this;
+}
+
+/** Return these forces scaled by 'value' */
+CLJForces CLJForces::operator*(double value) const
+{
+    CLJForces ret(*this);
+    ret *= value;
+    return ret;
+}
+
+const char* CLJForces::typeName()
+{
+    return QMetaType::typeName( qMetaTypeId<CLJForces>() );
+}
+
+const char* CLJForces::what() const
+{
+    return CLJForces::typeName();
+}
+
+QString CLJForces::toString() const
+{
+    return QObject::tr("CLJForces( count() == %1 )").arg(this->count());
+}
+
+/** Return the force on the ith atom
+
+    \throw SireError::invalid_index
+*/
+Vector CLJForces::operator[](int i) const
+{
+    if (i < 0 or i >= this->count())
+        throw SireError::invalid_index( QObject::tr(
+                "Invalid index %1. Number of forces is %2.")
+                    .arg(i).arg(this->count()), CODELOC );
+
+    const int vec = i / MultiFloat::count();
+    const int sub = i % MultiFloat::count();
+    
+    return Vector( _fx.constData()[vec][sub],
+                   _fy.constData()[vec][sub],
+                   _fz.constData()[vec][sub] );
+}
+
+/** Return the force on the ith atom
+
+    \throw SireError::invalid_index
+*/
+Vector CLJForces::at(int i) const
+{
+    return this->operator[](i);
+}
+
+/** Return the force on the ith atom
+
+    \throw SireError::invalid_index
+*/
+Vector CLJForces::getitem(int i) const
+{
+    return this->operator[](i);
+}
+
+/** Return the number of forces. Note that this is padded to
+    a multiple of MultiFloat::count() */
+int CLJForces::count() const
+{
+    return MultiFloat::count() * _fx.count();
+}
+
+/** Return the number of forces. Note that this is padded to
+    a multiple of MultiFloat::count() */
+int CLJForces::size() const
+{
+    return this->count();
+}
+
+/** Return whether or not this is empty */
+bool CLJForces::isEmpty() const
+{
+    return _fx.isEmpty();
+}
+
+/** Return whether or not these forces can hold the forces
+    on the passed atoms */
+bool CLJForces::isCompatible(const CLJAtoms &atoms) const
+{
+    return _fx.count() == atoms.x().count();
+}
+
+/** Assert that these forces can hold the forces on the passed atoms
+
+    \throw SireError::incompatible_error
+*/
+void CLJForces::assertCompatible(const CLJAtoms &atoms) const
+{
+    if (not this->isCompatible(atoms))
+        throw SireError::incompatible_error( QObject::tr(
+                "The force array (size %1) is not compatible with the array of "
+                "atoms (size %2).")
+                    .arg(this->count()).arg(atoms.count()), CODELOC );
+}
+
+/** Set all of the forces to zero */
+void CLJForces::zero()
+{
+    const MultiFloat zero(0);
+    
+    MultiFloat *fx = _fx.data();
+    MultiFloat *fy = _fy.data();
+    MultiFloat *fz = _fz.data();
+    
+    for (int i=0; i<_fx.count(); ++i)
+    {
+        fx[i] = zero;
+        fy[i] = zero;
+        fz[i] = zero;
+    }
+}
+
+/** Return all of the forces as an array of vectors (including
+    the forces on any padding atoms) */
+QVector<Vector> CLJForces::forces() const
+{
+    QVector<Vector> f( this->count() );
+    Vector *fa = f.data();
+    
+    int idx = 0;
+    
+    for (int i=0; i<_fx.count(); ++i)
+    {
+        const MultiFloat &fx = _fx.constData()[i];
+        const MultiFloat &fy = _fy.constData()[i];
+        const MultiFloat &fz = _fz.constData()[i];
+        
+        for (int j=0; j<MultiFloat::count(); ++j)
+        {
+            fa[idx] = Vector(fx[j], fy[j], fz[j]);
+            idx += 1;
+        }
+    }
+    
+    return f;
+}
+
+/** Internal function used to add the forces, starting from force 'idx',
+    onto the atoms of 'molecule'. This walks through the atoms in the same
+    order as used when the CLJAtoms were constructed from the molecule,
+    skipping the atoms that have no charge and a dummy LJ parameter.
+    If 'forcetable' is null then the forces for this molecule are skipped.
+    This returns the index of the next unused force */
+int CLJForces::addForces(MolForceTable *forcetable, const MoleculeView &molecule,
+                         int idx, double scale_force, const PropertyMap &map) const
+{
+    const PropertyName chg_property = map["charge"];
+    const PropertyName lj_property = map["LJ"];
+    
+    const int nforces = this->count();
+    
+    if (molecule.selectedAll())
+    {
+        const Molecule mol = molecule.molecule();
+        
+        const AtomCharges &chgs = mol.property(chg_property).asA<AtomCharges>();
+        const AtomLJs &ljs = mol.property(lj_property).asA<AtomLJs>();
+        
+        for (int i=0; i<chgs.nCutGroups(); ++i)
+        {
+            const CGIdx cgidx(i);
+            
+            const Charge *ichg = chgs.constData(cgidx);
+            const LJParameter *ilj = ljs.constData(cgidx);
+            
+            for (int j=0; j<chgs.nAtoms(cgidx); ++j)
+            {
+                if (ichg[j].value() != 0 or (not ilj[j].isDummy()))
+                {
+                    if (idx >= nforces)
+                        throw SireError::incompatible_error( QObject::tr(
+                                "There are not enough forces (%1) for the atoms "
+                                "in molecule %2.")
+                                    .arg(nforces).arg(mol.toString()), CODELOC );
+                
+                    if (forcetable)
+                        forcetable->add( CGAtomIdx(cgidx,Index(j)),
+                                         scale_force * this->operator[](idx) );
+
+                    idx += 1;
+                }
+            }
+        }
+    }
+    else
+    {
+        Selector<Atom> atoms = molecule.atoms();
+        
+        QList<Charge> chgs = atoms.property<Charge>(chg_property);
+        QList<LJParameter> ljs = atoms.property<LJParameter>(lj_property);
+        
+        for (int i=0; i<chgs.count(); ++i)
+        {
+            if (chgs[i].value() != 0 or (not ljs[i].isDummy()))
+            {
+                if (idx >= nforces)
+                    throw SireError::incompatible_error( QObject::tr(
+                            "There are not enough forces (%1) for the atoms "
+                            "in molecule %2.")
+                                .arg(nforces).arg(molecule.toString()), CODELOC );
+            
+                if (forcetable)
+                    forcetable->add( atoms(i).cgAtomIdx(),
+                                     scale_force * this->operator[](idx) );
+
+                idx += 1;
+            }
+        }
+    }
+    
+    return idx;
+}
+
+/** Add these forces, multiplied by 'scale_force', onto the forces in
+    'forcetable' for the atoms in 'molecule'. These forces must have been
+    calculated for CLJAtoms that were constructed from 'molecule' using
+    the same property map
+    
+    \throw SireError::incompatible_error
+*/
+void CLJForces::addTo(MolForceTable &forcetable, const MoleculeView &molecule,
+                      double scale_force, const PropertyMap &map) const
+{
+    if (scale_force == 0 or molecule.isEmpty())
+        return;
+
+    this->addForces(&forcetable, molecule, 0, scale_force, map);
+}
+
+/** Add these forces onto the forces in 'forcetable' for the atoms in
+    'molecule'. These forces must have been calculated for CLJAtoms that
+    were constructed from 'molecule' using the same property map
+    
+    \throw SireError::incompatible_error
+*/
+void CLJForces::addTo(MolForceTable &forcetable, const MoleculeView &molecule,
+                      const PropertyMap &map) const
+{
+    this->addTo(forcetable, molecule, 1.0, map);
+}
+
+/** Add these forces, multiplied by 'scale_force', onto the forces in 'forcetable'
+    for the molecules in 'molecules'. These forces must have been calculated
+    for CLJAtoms that were constructed from 'molecules' using the
+    same property map. Only molecules that are in the forcetable
+    have their forces added
+    
+    \throw SireError::incompatible_error
+*/
+void CLJForces::addTo(ForceTable &forcetable, const MoleculeGroup &molecules,
+                      double scale_force, const PropertyMap &map) const
+{
+    if (scale_force == 0 or molecules.isEmpty())
+        return;
+    
+    int idx = 0;
+    
+    for (int i=0; i<molecules.nMolecules(); ++i)
+    {
+        const MoleculeView &view = molecules[MolIdx(i)];
+        
+        if (forcetable.containsTable(view.data().number()))
+        {
+            idx = this->addForces(&(forcetable.getTable(view.data().number())),
+                                  view, idx, scale_force, map);
+        }
+        else
+        {
+            //still need to skip over this molecule's forces
+            idx = this->addForces(0, view, idx, scale_force, map);
+        }
+    }
+}
+
+/** Add these forces onto the forces in 'forcetable' for the molecules in
+    'molecules'. These forces must have been calculated for CLJAtoms that
+    were constructed from 'molecules' using the same property map. Only
+    molecules that are in the forcetable have their forces added
+    
+    \throw SireError::incompatible_error
+*/
+void CLJForces::addTo(ForceTable &forcetable, const MoleculeGroup &molecules,
+                      const PropertyMap &map) const
+{
+    this->addTo(forcetable, molecules, 1.0, map);
+}
@@ -0,0 +1,188 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#ifndef SIREMM_CLJFORCES_H
+#define SIREMM_CLJFORCES_H
+
+#include "cljatoms.h"
+
+SIRE_BEGIN_HEADER
+
+namespace SireMM
+{
+class CLJForces;
+}
+
+QDataStream& operator<<(QDataStream&, const SireMM::CLJForces&);
+QDataStream& operator>>(QDataStream&, SireMM::CLJForces&);
+
+namespace SireFF
+{
+class ForceTable;
+class MolForceTable;
+}
+
+namespace SireMM
+{
+
+class CLJBoxes;
+class CLJBoxIndex;
+
+using SireFF::ForceTable;
+using SireFF::MolForceTable;
+
+/** This class holds vectorised arrays of the forces on a set of
+    CLJAtoms. The forces are held in the same (padded) order
+    as the atoms in the CLJAtoms, so that they can be accumulated
+    directly by the vectorised force kernels of the CLJFunctions.
+    
+    The forces can be added into a ForceTable (or MolForceTable) as long
+    as the CLJAtoms were created from the same molecule(s) that
+    are passed to 'addTo'
+    
+    @author Christopher Woods
+*/
+class SIREMM_EXPORT CLJForces
+{
+
+friend QDataStream& ::operator<<(QDataStream&, const CLJForces&);
+friend QDataStream& ::operator>>(QDataStream&, CLJForces&);
+
+friend class CLJFunction;
+
+public:
+    CLJForces();
+    CLJForces(int natoms);
+    CLJForces(const CLJAtoms &atoms);
+    CLJForces(const QVector<Vector> &forces);
+    
+    CLJForces(const CLJBoxes &boxes, const QVector<CLJForces> &box_forces,
+              const QVector<CLJBoxIndex> &atoms);
+    
+    CLJForces(const CLJForces &other);
+    
+    ~CLJForces();
+    
+    CLJForces& operator=(const CLJForces &other);
+    
+    bool operator==(const CLJForces &other) const;
+    bool operator!=(const CLJForces &other) const;
+    
+    CLJForces& operator+=(const CLJForces &other);
+    CLJForces& operator-=(const CLJForces &other);
+    
+    CLJForces operator+(const CLJForces &other) const;
+    CLJForces operator-(const CLJForces &other) const;
+    
+    CLJForces& operator*=(double value);
+    CLJForces operator*(double value) const;
+    
+    static const char* typeName();
+    const char* what() const;
+    
+    QString toString() const;
+    
+    Vector operator[](int i) const;
+    Vector at(int i) const;
+    Vector getitem(int i) const;
+    
+    int count() const;
+    int size() const;
+    
+    bool isEmpty() const;
+    
+    bool isCompatible(const CLJAtoms &atoms) const;
+    void assertCompatible(const CLJAtoms &atoms) const;
+    
+    void zero();
+    
+    QVector<Vector> forces() const;
+    
+    const QVector<MultiFloat>& x() const;
+    const QVector<MultiFloat>& y() const;
+    const QVector<MultiFloat>& z() const;
+    
+    void addTo(MolForceTable &forcetable, const MoleculeView &molecule,
+               const PropertyMap &map = PropertyMap()) const;
+    
+    void addTo(MolForceTable &forcetable, const MoleculeView &molecule,
+               double scale_force, const PropertyMap &map = PropertyMap()) const;
+    
+    void addTo(ForceTable &forcetable, const MoleculeGroup &molecules,
+               const PropertyMap &map = PropertyMap()) const;
+    
+    void addTo(ForceTable &forcetable, const MoleculeGroup &molecules,
+               double scale_force, const PropertyMap &map = PropertyMap()) const;
+
+private:
+    void assertSameSize(const CLJForces &other) const;
+
+    int addForces(MolForceTable *forcetable, const MoleculeView &molecule,
+                  int idx, double scale_force, const PropertyMap &map) const;
+
+    /** The x components of the forces */
+    QVector<MultiFloat> _fx;
+    
+    /** The y components of the forces */
+    QVector<MultiFloat> _fy;
+    
+    /** The z components of the forces */
+    QVector<MultiFloat> _fz;
+};
+
+#ifndef SIRE_SKIP_INLINE_FUNCTIONS
+
+/** Return the x components of the forces */
+inline const QVector<MultiFloat>& CLJForces::x() const
+{
+    return _fx;
+}
+
+/** Return the y components of the forces */
+inline const QVector<MultiFloat>& CLJForces::y() const
+{
+    return _fy;
+}
+
+/** Return the z components of the forces */
+inline const QVector<MultiFloat>& CLJForces::z() const
+{
+    return _fz;
+}
+
+#endif // SIRE_SKIP_INLINE_FUNCTIONS
+
+}
+
+Q_DECLARE_METATYPE( SireMM::CLJForces )
+
+SIRE_EXPOSE_CLASS( SireMM::CLJForces )
+
+SIRE_END_HEADER
+
+#endif
@@ -27,6 +27,7 @@
 \*********************************************/
 
 #include <QElapsedTimer>
+#include <QVarLengthArray>
 
 #include "cljfunction.h"
 #include "cljboxes.h"
@@ -36,8 +37,12 @@
 
 #include "SireVol/cartesian.h"
 #include "SireVol/periodicbox.h"
+#include "SireVol/triclinicbox.h"
+#include "SireVol/aabox.h"
 #include "SireVol/gridinfo.h"
 
+#include "SireFF/energyprofiler.h"
+
 #include "SireError/errors.h"
 
 #include "SireBase/properties.h"
@@ -97,7 +102,8 @@ QDataStream SIREMM_EXPORT &operator>>(QDataStream &ds, CLJFunction &cljfunc)
 
 /** Constructor. By default we will use vacuum boundary conditions with
     arithmetic combining rules */
-CLJFunction::CLJFunction() : Property(), use_arithmetic(true), use_box(false)
+CLJFunction::CLJFunction()
+            : Property(), use_arithmetic(true), use_box(false), use_triclinic(false)
 {}
 
 void CLJFunction::extractDetailsFromRules(SireMM::CLJFunction::COMBINING_RULES rules)
@@ -119,7 +125,8 @@ void CLJFunction::extractDetailsFromRules(SireMM::CLJFunction::COMBINING_RULES r
 
 /** Construct, using vacuum boundary conditions, but specifying the combining rules */
 CLJFunction::CLJFunction(COMBINING_RULES combining_rules)
-            : Property(), use_arithmetic(true), use_box(false)
+            : Property(), use_arithmetic(true), use_box(false),
+              use_triclinic(false)
 {
     extractDetailsFromRules(combining_rules);
 }
@@ -129,36 +136,48 @@ void CLJFunction::extractDetailsFromSpace()
     if (spce.isNull())
     {
         use_box = false;
+        use_triclinic = false;
         box_dimensions = Vector(0);
     }
     else if (spce.read().isA<PeriodicBox>())
     {
         use_box = true;
+        use_triclinic = false;
         box_dimensions = spce.read().asA<PeriodicBox>().dimensions();
     }
+    else if (spce.read().isA<TriclinicBox>())
+    {
+        use_box = false;
+        use_triclinic = true;
+        box_dimensions = Vector(0);
+    }
     else if (spce.read().isA<Cartesian>())
     {
         use_box = false;
+        use_triclinic = false;
         box_dimensions = Vector(0);
     }
     else
         throw SireError::unsupported( QObject::tr(
                 "CLJFunction-based forcefields currently only support using either "
-                "periodic (cubic) boundary conditions, or vacuum boundary conditions. "
+                "periodic (cubic or triclinic) boundary conditions, or vacuum "
+                "boundary conditions. "
                 "They are not compatible with the passed space \"%1\".")
                     .arg(spce.read().toString()), CODELOC );
 }
 
 /** Construct, using arithmetic combining rules, but specifying the space */
 CLJFunction::CLJFunction(const Space &space)
-            : Property(), spce(space), use_arithmetic(true), use_box(false)
+            : Property(), spce(space), use_arithmetic(true), use_box(false),
+              use_triclinic(false)
 {
     extractDetailsFromSpace();
 }
 
 /** Construct, specifying both the combining rules and simulation space */
 CLJFunction::CLJFunction(const Space &space, COMBINING_RULES combining_rules)
-            : Property(), spce(space), use_arithmetic(true), use_box(false)
+            : Property(), spce(space), use_arithmetic(true), use_box(false),
+              use_triclinic(false)
 {
     extractDetailsFromSpace();
     extractDetailsFromRules(combining_rules);
@@ -167,7 +186,8 @@ CLJFunction::CLJFunction(const Space &space, COMBINING_RULES combining_rules)
 /** Copy constructor */
 CLJFunction::CLJFunction(const CLJFunction &other)
             : Property(other), spce(other.spce), box_dimensions(other.box_dimensions),
-              use_arithmetic(other.use_arithmetic), use_box(other.use_box)
+              use_arithmetic(other.use_arithmetic), use_box(other.use_box),
+              use_triclinic(other.use_triclinic)
 {}
 
 /** Destructor */
@@ -183,6 +203,7 @@ CLJFunction& CLJFunction::operator=(const CLJFunction &other)
         box_dimensions = other.box_dimensions;
         use_arithmetic = other.use_arithmetic;
         use_box = other.use_box;
+        use_triclinic = other.use_triclinic;
         Property::operator=(other);
     }
     
@@ -389,7 +410,7 @@ const Space& CLJFunction::space() const
 /** Return whether or not the space of the function is periodic */
 bool CLJFunction::isPeriodic() const
 {
-    return use_box;
+    return use_box or use_triclinic;
 }
 
 /** Set the space used by the function */
@@ -653,6 +674,113 @@ double CLJFunction::calcBoxLJEnergyGeo(const CLJAtoms &atoms0, const CLJAtoms &a
     return ljnrg;
 }
 
+/** Return the lattice translations that must be applied to 'atoms1' to 
+    give all of the periodic images of 'atoms1' that are within the cutoff
+    of 'atoms0' in the triclinic box. If 'self' is true, then 'atoms0' and
+    'atoms1' are the same atoms, so the zero translation is removed, and
+    only one of each pair of opposite translations is returned (as the
+    interaction with the image at 't' is the same as that at '-t') */
+QVector<Vector> CLJFunction::triclinicTranslations(const CLJAtoms &atoms0,
+                                                   const CLJAtoms &atoms1,
+                                                   bool self) const
+{
+    const TriclinicBox &box = spce.read().asA<TriclinicBox>();
+    
+    //without a cutoff, only images within the inscribed sphere are
+    //used, which is the equivalent of the minimum image convention
+    const double cutoff = this->hasCutoff() ?
+                             qMax( this->coulombCutoff().value(), this->ljCutoff().value() ) :
+                             box.inscribedRadius();
+
+    const Vector min0 = atoms0.minCoords();
+    const Vector max0 = atoms0.maxCoords();
+    const Vector min1 = atoms1.minCoords();
+    const Vector max1 = atoms1.maxCoords();
+
+    //there are no translations if either set of atoms contains only dummies
+    if (min0.x() > max0.x() or min1.x() > max1.x())
+        return QVector<Vector>();
+
+    const AABox box0 = AABox::from(min0, max0);
+    const AABox box1 = self ? box0 : AABox::from(min1, max1);
+
+    QVector<Vector> translations = box.getImageTranslations(box0, box1, cutoff);
+    
+    if (self)
+    {
+        QMutableVectorIterator<Vector> it(translations);
+        
+        while (it.hasNext())
+        {
+            const Vector &t = it.next();
+            
+            if ( t.x() < 0 or (t.x() == 0 and (t.y() < 0 or (t.y() == 0 and t.z() <= 0))) )
+                it.remove();
+        }
+    }
+    
+    return translations;
+}
+
+/** Calculate the energy between all of the atoms in 'atoms' in a triclinic box.
+    This is the vacuum energy of the atoms plus their energy with each of their
+    periodic images that are within the cutoff. The images are built in a single
+    scratch CLJAtoms that is reused for every translation */
+void CLJFunction::calcTriclinicEnergy(const CLJAtoms &atoms,
+                                      double &cnrg, double &ljnrg) const
+{
+    if (use_arithmetic)
+        this->calcVacEnergyAri(atoms, cnrg, ljnrg);
+    else
+        this->calcVacEnergyGeo(atoms, cnrg, ljnrg);
+
+    CLJAtoms image;
+
+    foreach (const Vector &t, this->triclinicTranslations(atoms, atoms, true))
+    {
+        atoms.translate(t, image);
+
+        double icnrg(0), iljnrg(0);
+
+        if (use_arithmetic)
+            this->calcVacEnergyAri(atoms, image, icnrg, iljnrg, 0);
+        else
+            this->calcVacEnergyGeo(atoms, image, icnrg, iljnrg, 0);
+
+        cnrg += icnrg;
+        ljnrg += iljnrg;
+    }
+}
+
+/** Calculate the energy between the atoms in 'atoms0' and all of the
+    periodic images of 'atoms1' that are within the cutoff in a triclinic box.
+    The interaction of 'atoms0' with 'atoms1' translated by 't' is the same
+    as that of 'atoms0' translated by '-t' with 'atoms1', so it is 'atoms0'
+    (normally the smaller set) that is translated into the scratch image */
+void CLJFunction::calcTriclinicEnergy(const CLJAtoms &atoms0, const CLJAtoms &atoms1,
+                                      double &cnrg, double &ljnrg) const
+{
+    cnrg = 0;
+    ljnrg = 0;
+
+    CLJAtoms image;
+
+    foreach (const Vector &t, this->triclinicTranslations(atoms0, atoms1, false))
+    {
+        atoms0.translate(-t, image);
+
+        double icnrg(0), iljnrg(0);
+
+        if (use_arithmetic)
+            this->calcVacEnergyAri(image, atoms1, icnrg, iljnrg, 0);
+        else
+            this->calcVacEnergyGeo(image, atoms1, icnrg, iljnrg, 0);
+
+        cnrg += icnrg;
+        ljnrg += iljnrg;
+    }
+}
+
 /** Return the total energy between 'atoms', returning the coulomb part in 'cnrg'
     and the LJ part in 'ljnrg' */
 void CLJFunction::operator()(const CLJAtoms &atoms,
@@ -663,6 +791,10 @@ void CLJFunction::operator()(const CLJAtoms &atoms,
         cnrg = 0;
         ljnrg = 0;
     }
+    else if (use_triclinic)
+    {
+        this->calcTriclinicEnergy(atoms, cnrg, ljnrg);
+    }
     else
     {
         if (use_arithmetic)
@@ -693,6 +825,13 @@ void CLJFunction::operator()(const CLJAtoms &atoms0, const CLJAtoms &atoms1,
         ljnrg = 0;
         return;
     }
+    else if (use_triclinic)
+    {
+        if (atoms0.count() > atoms1.count())
+            this->calcTriclinicEnergy(atoms1, atoms0, cnrg, ljnrg);
+        else
+            this->calcTriclinicEnergy(atoms0, atoms1, cnrg, ljnrg);
+    }
     else if (atoms0.count() > atoms1.count())
     {
         if (use_arithmetic)
@@ -736,6 +875,8 @@ void CLJFunction::operator()(const CLJBoxes &atoms, double &cnrg, double &ljnrg)
     cnrg = 0;
     ljnrg = 0;
     
+    qint64 npairs = 0;
+    
     if (this->hasCutoff())
     {
         const float min_cutoff = qMax( this->coulombCutoff(), this->ljCutoff() );
@@ -750,6 +891,7 @@ void CLJFunction::operator()(const CLJBoxes &atoms, double &cnrg, double &ljnrg)
 
             //calculate the self-energy of the box
             this->total(it0->read().atoms(), icnrg, iljnrg);
+            npairs += 1;
         
             cnrg += icnrg;
             ljnrg += iljnrg;
@@ -769,6 +911,7 @@ void CLJFunction::operator()(const CLJBoxes &atoms, double &cnrg, double &ljnrg)
                 {
                     this->total(it0->read().atoms(), it1->read().atoms(),
                                 icnrg, iljnrg, mindist);
+                    npairs += 1;
                     
                     cnrg += icnrg;
                     ljnrg += iljnrg;
@@ -788,6 +931,7 @@ void CLJFunction::operator()(const CLJBoxes &atoms, double &cnrg, double &ljnrg)
 
             //calculate the self-energy of the box
             this->total(it0->read().atoms(), icnrg, iljnrg);
+            npairs += 1;
         
             cnrg += icnrg;
             ljnrg += iljnrg;
@@ -799,12 +943,15 @@ void CLJFunction::operator()(const CLJBoxes &atoms, double &cnrg, double &ljnrg)
             {
                 this->total(it0->read().atoms(), it1->read().atoms(),
                             icnrg, iljnrg);
+                npairs += 1;
                 
                 cnrg += icnrg;
                 ljnrg += iljnrg;
             }
         }
     }
+    
+    SireFF::EnergyProfiler::addPairs(npairs);
 }
 
 /** Return the total energy between 'atoms0' and 'atoms1', returning the coulomb part in 'cnrg'
@@ -815,6 +962,8 @@ void CLJFunction::operator()(const CLJBoxes &atoms0, const CLJBoxes &atoms1,
     cnrg = 0;
     ljnrg = 0;
     
+    qint64 npairs = 0;
+    
     if (this->hasCutoff() and atoms0.length() == atoms1.length())
     {
         const CLJBoxes::Container &boxes0 = atoms0.occupiedBoxes();
@@ -841,6 +990,7 @@ void CLJFunction::operator()(const CLJBoxes &atoms0, const CLJBoxes &atoms1,
                 {
                     this->operator()(it0->read().atoms(), it1->read().atoms(),
                                      icnrg, iljnrg, mindist);
+                    npairs += 1;
                 }
                 
                 cnrg += icnrg;
@@ -865,12 +1015,15 @@ void CLJFunction::operator()(const CLJBoxes &atoms0, const CLJBoxes &atoms1,
                 
                 this->operator()(it0->read().atoms(), it1->read().atoms(),
                                  icnrg, iljnrg);
+                npairs += 1;
                 
                 cnrg += icnrg;
                 ljnrg += iljnrg;
             }
         }
     }
+    
+    SireFF::EnergyProfiler::addPairs(npairs);
 }
 
 /** Return the total energy between 'atoms0' and 'atoms1', returning the coulomb part in 'cnrg'
@@ -989,6 +1142,12 @@ double CLJFunction::coulomb(const CLJAtoms &atoms) const
     {
         return 0;
     }
+    else if (use_triclinic)
+    {
+        double cnrg, ljnrg;
+        this->calcTriclinicEnergy(atoms, cnrg, ljnrg);
+        return cnrg;
+    }
     else
     {
         if (use_arithmetic)
@@ -1022,6 +1181,12 @@ double CLJFunction::coulomb(const CLJAtoms &atoms0, const CLJAtoms &atoms1,
     {
         return 0;
     }
+    else if (use_triclinic)
+    {
+        double cnrg, ljnrg;
+        this->calcTriclinicEnergy(atoms0, atoms1, cnrg, ljnrg);
+        return cnrg;
+    }
     else if (atoms0.count() > atoms1.count())
     {
         if (use_arithmetic)
@@ -1071,6 +1236,12 @@ double CLJFunction::lj(const CLJAtoms &atoms) const
     {
         return 0;
     }
+    else if (use_triclinic)
+    {
+        double cnrg, ljnrg;
+        this->calcTriclinicEnergy(atoms, cnrg, ljnrg);
+        return ljnrg;
+    }
     else
     {
         if (use_arithmetic)
@@ -1104,6 +1275,12 @@ double CLJFunction::lj(const CLJAtoms &atoms0, const CLJAtoms &atoms1,
     {
         return 0;
     }
+    else if (use_triclinic)
+    {
+        double cnrg, ljnrg;
+        this->calcTriclinicEnergy(atoms0, atoms1, cnrg, ljnrg);
+        return ljnrg;
+    }
     else if (atoms0.count() > atoms1.count())
     {
         if (use_arithmetic)
@@ -1146,24 +1323,809 @@ double CLJFunction::lj(const CLJBoxes &atoms0, const CLJBoxes &atoms1) const
     return this->calculate(atoms0, atoms1).get<1>();
 }
 
+/** Return whether or not this function supports the calculation of forces */
+bool CLJFunction::supportsForceCalculation() const
+{
+    return false;
+}
+
+/** Dummy function that needs to be overridden to support force calculations */
+void CLJFunction::calcForce(const CLJAtoms&, CLJForces&) const
+{
+    throw SireError::unsupported( QObject::tr( "The CLJFunction \"%1\" does not "
+            "support the calculation of forces.").arg(this->what()), CODELOC );
+}
+
+/** Dummy function that needs to be overridden to support force calculations */
+void CLJFunction::calcForce(const CLJAtoms&, const CLJAtoms&,
+                            CLJForces&, CLJForces*) const
+{
+    throw SireError::unsupported( QObject::tr( "The CLJFunction \"%1\" does not "
+            "support the calculation of forces.").arg(this->what()), CODELOC );
+}
+
+/** Internal kernel used to calculate the coulomb and LJ forces between
+    the atoms in 'atoms0' and 'atoms1'. The coulomb energy has the general
+    form q0 q1 { 1/r + a r + b r^2 - c }, so the force is
+    q0 q1 { 1/r^2 - a - 2 b r } along the interatomic vector. The forces on
+    atoms0 are added onto fx0/fy0/fz0 and, if fx1 is not null, the
+    equal and opposite forces on atoms1 are added onto fx1/fy1/fz1. If
+    'self' is true then atoms0 and atoms1 are the same set of atoms
+    and each pair is only calculated once */
+template<bool USE_BOX, bool USE_ARITHMETIC>
+static void calcForceKernel(const CLJAtoms &atoms0, const CLJAtoms &atoms1, bool self,
+                            const Vector &box_dimensions,
+                            float coul_a, float coul_b, float coul_cutoff, float lj_cutoff,
+                            MultiFloat *fx0, MultiFloat *fy0, MultiFloat *fz0,
+                            MultiFloat *fx1, MultiFloat *fy1, MultiFloat *fz1)
+{
+    const MultiFloat *x0 = atoms0.x().constData();
+    const MultiFloat *y0 = atoms0.y().constData();
+    const MultiFloat *z0 = atoms0.z().constData();
+    const MultiFloat *q0 = atoms0.q().constData();
+    const MultiFloat *sig0 = atoms0.sigma().constData();
+    const MultiFloat *eps0 = atoms0.epsilon().constData();
+    const MultiInt *id0 = atoms0.ID().constData();
+
+    const MultiFloat *x1 = atoms1.x().constData();
+    const MultiFloat *y1 = atoms1.y().constData();
+    const MultiFloat *z1 = atoms1.z().constData();
+    const MultiFloat *q1 = atoms1.q().constData();
+    const MultiFloat *sig1 = atoms1.sigma().constData();
+    const MultiFloat *eps1 = atoms1.epsilon().constData();
+    const MultiInt *id1 = atoms1.ID().constData();
+
+    const MultiFloat Rc(coul_cutoff);
+    const MultiFloat Rlj(lj_cutoff);
+    const MultiFloat a(coul_a);
+    const MultiFloat two_b(2.0 * coul_b);
+    const MultiFloat half(0.5);
+    const MultiFloat six(6.0);
+    const MultiFloat twelve(12.0);
+    const MultiInt dummy_id = CLJAtoms::idOfDummy();
+    const qint32 dummy_int = dummy_id[0];
+
+    const MultiFloat box_x( box_dimensions.x() );
+    const MultiFloat box_y( box_dimensions.y() );
+    const MultiFloat box_z( box_dimensions.z() );
+
+    const MultiFloat half_box_x( 0.5 * box_dimensions.x() );
+    const MultiFloat half_box_y( 0.5 * box_dimensions.y() );
+    const MultiFloat half_box_z( 0.5 * box_dimensions.z() );
+
+    const MultiFloat neg_half_box_x( -0.5 * box_dimensions.x() );
+    const MultiFloat neg_half_box_y( -0.5 * box_dimensions.y() );
+    const MultiFloat neg_half_box_z( -0.5 * box_dimensions.z() );
+
+    MultiFloat dx, dy, dz, r, one_over_r, one_over_r2, sig2_over_r2, sig6_over_r6;
+    MultiFloat tmp, fscl;
+    MultiInt itmp;
+
+    const int n0 = atoms0.x().count();
+    const int n1 = atoms1.x().count();
+
+    for (int i=0; i<n0; ++i)
+    {
+        for (int ii=0; ii<MultiFloat::count(); ++ii)
+        {
+            if (id0[i][ii] != dummy_int)
+            {
+                const MultiInt id(id0[i][ii]);
+                const MultiFloat x(x0[i][ii]);
+                const MultiFloat y(y0[i][ii]);
+                const MultiFloat z(z0[i][ii]);
+                const MultiFloat q(q0[i][ii]);
+                const MultiFloat eps(eps0[i][ii]);
+                const MultiFloat sig( USE_ARITHMETIC ? sig0[i][ii] * sig0[i][ii]
+                                                     : sig0[i][ii] );
+
+                MultiFloat fx(0), fy(0), fz(0);
+
+                for (int j=(self ? i : 0); j<n1; ++j)
+                {
+                    // if i == j then we double-calculate the forces, so must
+                    // scale them by 0.5
+                    const MultiFloat scale( (self and i == j) ? 0.5 : 1.0 );
+
+                    //calculate the vector from atom j to atom i
+                    dx = x - x1[j];
+                    dy = y - y1[j];
+                    dz = z - z1[j];
+
+                    if (USE_BOX)
+                    {
+                        //apply the minimum image convention
+                        dx -= box_x.logicalAnd( half_box_x.compareLess(dx) );
+                        dx += box_x.logicalAnd( dx.compareLess(neg_half_box_x) );
+                        dy -= box_y.logicalAnd( half_box_y.compareLess(dy) );
+                        dy += box_y.logicalAnd( dy.compareLess(neg_half_box_y) );
+                        dz -= box_z.logicalAnd( half_box_z.compareLess(dz) );
+                        dz += box_z.logicalAnd( dz.compareLess(neg_half_box_z) );
+                    }
+
+                    r = dx * dx;
+                    r.multiplyAdd(dy, dy);
+                    r.multiplyAdd(dz, dz);
+                    r = r.sqrt();
+
+                    one_over_r = r.reciprocal();
+                    one_over_r2 = one_over_r * one_over_r;
+
+                    //calculate the coulomb force divided by r
+                    // force / r = q0q1 * { 1/r^3 - a/r - 2b }
+                    fscl = one_over_r2 * one_over_r;
+                    fscl -= a * one_over_r;
+                    fscl -= two_b;
+                    fscl *= q * q1[j];
+                    fscl &= r.compareLess(Rc);
+
+                    //now the LJ force divided by r
+                    // force / r = 4 eps { 12 (sig/r)^12 - 6 (sig/r)^6 } / r^2
+                    if (USE_ARITHMETIC)
+                    {
+                        tmp = sig + (sig1[j]*sig1[j]);
+                        tmp *= half;
+                    }
+                    else
+                    {
+                        tmp = sig * sig1[j];
+                    }
+
+                    sig2_over_r2 = tmp * one_over_r;
+                    sig2_over_r2 = sig2_over_r2*sig2_over_r2;
+                    sig6_over_r6 = sig2_over_r2*sig2_over_r2;
+                    sig6_over_r6 = sig6_over_r6*sig2_over_r2;
+
+                    tmp = sig6_over_r6 * sig6_over_r6;
+                    tmp *= twelve;
+                    tmp -= six * sig6_over_r6;
+                    tmp *= eps * eps1[j];
+                    tmp *= one_over_r2;
+                    tmp &= r.compareLess(Rlj);
+
+                    fscl += tmp;
+
+                    //remove the forces from dummy atoms and atoms with the same ID
+                    itmp = id1[j].compareEqual(dummy_id);
+                    itmp |= id1[j].compareEqual(id);
+
+                    fscl = fscl.logicalAndNot(itmp);
+                    fscl *= scale;
+
+                    tmp = fscl * dx;
+                    fx += tmp;
+
+                    if (fx1)
+                        fx1[j] -= tmp;
+
+                    tmp = fscl * dy;
+                    fy += tmp;
+
+                    if (fy1)
+                        fy1[j] -= tmp;
+
+                    tmp = fscl * dz;
+                    fz += tmp;
+
+                    if (fz1)
+                        fz1[j] -= tmp;
+                }
+
+                fx0[i].set(ii, fx0[i][ii] + fx.sum());
+                fy0[i].set(ii, fy0[i][ii] + fy.sum());
+                fz0[i].set(ii, fz0[i][ii] + fz.sum());
+            }
+        }
+    }
+}
+
+/** Calculate the forces between all of the atoms in 'atoms', adding them onto
+    'forces'. This is used by CLJFunctions whose coulomb energy has the general
+    form q0 q1 { 1/r + a r + b r^2 - c }, and which use a truncated
+    LJ potential */
+void CLJFunction::calcGeneralForce(const CLJAtoms &atoms,
+                                   float coul_a, float coul_b,
+                                   float coul_cutoff, float lj_cutoff,
+                                   CLJForces &forces) const
+{
+    MultiFloat *fx = forces._fx.data();
+    MultiFloat *fy = forces._fy.data();
+    MultiFloat *fz = forces._fz.data();
+
+    if (use_box)
+    {
+        if (use_arithmetic)
+            calcForceKernel<true,true>(atoms, atoms, true, box_dimensions,
+                                       coul_a, coul_b, coul_cutoff, lj_cutoff,
+                                       fx, fy, fz, fx, fy, fz);
+        else
+            calcForceKernel<true,false>(atoms, atoms, true, box_dimensions,
+                                        coul_a, coul_b, coul_cutoff, lj_cutoff,
+                                        fx, fy, fz, fx, fy, fz);
+    }
+    else
+    {
+        if (use_arithmetic)
+            calcForceKernel<false,true>(atoms, atoms, true, box_dimensions,
+                                        coul_a, coul_b, coul_cutoff, lj_cutoff,
+                                        fx, fy, fz, fx, fy, fz);
+        else
+            calcForceKernel<false,false>(atoms, atoms, true, box_dimensions,
+                                         coul_a, coul_b, coul_cutoff, lj_cutoff,
+                                         fx, fy, fz, fx, fy, fz);
+    }
+}
+
+/** Calculate the forces between the atoms in 'atoms0' and 'atoms1', adding the
+    forces on atoms0 onto 'forces0' and, if 'forces1' is not null, the forces on
+    atoms1 onto 'forces1'. This is used by CLJFunctions whose coulomb energy
+    has the general form q0 q1 { 1/r + a r + b r^2 - c }, and which use a
+    truncated LJ potential */
+void CLJFunction::calcGeneralForce(const CLJAtoms &atoms0, const CLJAtoms &atoms1,
+                                   float coul_a, float coul_b,
+                                   float coul_cutoff, float lj_cutoff,
+                                   CLJForces &forces0, CLJForces *forces1) const
+{
+    MultiFloat *fx0 = forces0._fx.data();
+    MultiFloat *fy0 = forces0._fy.data();
+    MultiFloat *fz0 = forces0._fz.data();
+
+    MultiFloat *fx1 = 0;
+    MultiFloat *fy1 = 0;
+    MultiFloat *fz1 = 0;
+
+    if (forces1)
+    {
+        fx1 = forces1->_fx.data();
+        fy1 = forces1->_fy.data();
+        fz1 = forces1->_fz.data();
+    }
+
+    if (use_box)
+    {
+        if (use_arithmetic)
+            calcForceKernel<true,true>(atoms0, atoms1, false, box_dimensions,
+                                       coul_a, coul_b, coul_cutoff, lj_cutoff,
+                                       fx0, fy0, fz0, fx1, fy1, fz1);
+        else
+            calcForceKernel<true,false>(atoms0, atoms1, false, box_dimensions,
+                                        coul_a, coul_b, coul_cutoff, lj_cutoff,
+                                        fx0, fy0, fz0, fx1, fy1, fz1);
+    }
+    else
+    {
+        if (use_arithmetic)
+            calcForceKernel<false,true>(atoms0, atoms1, false, box_dimensions,
+                                        coul_a, coul_b, coul_cutoff, lj_cutoff,
+                                        fx0, fy0, fz0, fx1, fy1, fz1);
+        else
+            calcForceKernel<false,false>(atoms0, atoms1, false, box_dimensions,
+                                         coul_a, coul_b, coul_cutoff, lj_cutoff,
+                                         fx0, fy0, fz0, fx1, fy1, fz1);
+    }
+}
+
+/** Calculate the forces between all of the atoms in 'atoms', adding them
+    onto 'forces'. If 'forces' is empty then it is resized to hold the
+    forces on 'atoms'. The forces are in units of kcal mol-1 A-1
+
+    \throw SireError::unsupported
+    \throw SireError::incompatible_error
+*/
+void CLJFunction::force(const CLJAtoms &atoms, CLJForces &forces) const
+{
+    if (atoms.isEmpty())
+        return;
+
+    if (forces.isEmpty())
+        forces = CLJForces(atoms);
+    else
+        forces.assertCompatible(atoms);
+
+    this->calcForce(atoms, forces);
+
+    if (use_triclinic)
+    {
+        CLJAtoms image;
+
+        foreach (const Vector &t, this->triclinicTranslations(atoms, atoms, true))
+        {
+            atoms.translate(t, image);
+            this->calcForce(atoms, image, forces, &forces);
+        }
+    }
+}
+
+/** Return the forces between all of the atoms in 'atoms'
+
+    \throw SireError::unsupported
+*/
+CLJForces CLJFunction::force(const CLJAtoms &atoms) const
+{
+    CLJForces forces(atoms);
+    this->force(atoms, forces);
+    return forces;
+}
+
+/** Calculate the forces on the atoms in 'atoms0' caused by the atoms
+    in 'atoms1', adding them onto 'forces0'. If 'forces0' is empty then
+    it is resized to hold the forces on 'atoms0'
+
+    \throw SireError::unsupported
+    \throw SireError::incompatible_error
+*/
+void CLJFunction::force(const CLJAtoms &atoms0, const CLJAtoms &atoms1,
+                        CLJForces &forces0) const
+{
+    if (atoms0.isEmpty() or atoms1.isEmpty())
+        return;
+
+    if (forces0.isEmpty())
+        forces0 = CLJForces(atoms0);
+    else
+        forces0.assertCompatible(atoms0);
+
+    if (use_triclinic)
+    {
+        //the forces do not depend on the translation, so translate
+        //atoms0 by -t rather than atoms1 by t
+        CLJAtoms image;
+
+        foreach (const Vector &t, this->triclinicTranslations(atoms0, atoms1, false))
+        {
+            atoms0.translate(-t, image);
+            this->calcForce(image, atoms1, forces0, 0);
+        }
+    }
+    else
+        this->calcForce(atoms0, atoms1, forces0, 0);
+}
+
+/** Calculate the forces between the atoms in 'atoms0' and 'atoms1', adding
+    the forces on atoms0 onto 'forces0' and the forces on atoms1 onto 'forces1'.
+    Empty force arrays are resized to hold the forces on the atoms
+
+    \throw SireError::unsupported
+    \throw SireError::incompatible_error
+*/
+void CLJFunction::force(const CLJAtoms &atoms0, const CLJAtoms &atoms1,
+                        CLJForces &forces0, CLJForces &forces1) const
+{
+    if (atoms0.isEmpty() or atoms1.isEmpty())
+        return;
+
+    if (forces0.isEmpty())
+        forces0 = CLJForces(atoms0);
+    else
+        forces0.assertCompatible(atoms0);
+
+    if (forces1.isEmpty())
+        forces1 = CLJForces(atoms1);
+    else
+        forces1.assertCompatible(atoms1);
+
+    if (use_triclinic)
+    {
+        CLJAtoms image;
+
+        foreach (const Vector &t, this->triclinicTranslations(atoms0, atoms1, false))
+        {
+            atoms0.translate(-t, image);
+            this->calcForce(image, atoms1, forces0, &forces1);
+        }
+    }
+    else
+        this->calcForce(atoms0, atoms1, forces0, &forces1);
+}
+
+/** Calculate the forces between all of the atoms in 'atoms', adding
+    them onto 'forces'. There is one set of forces per occupied box,
+    in the same order as CLJBoxes::occupiedBoxes(). Use
+    CLJCalculator::calculateForces to perform this calculation
+    in parallel
+
+    \throw SireError::unsupported
+    \throw SireError::incompatible_error
+*/
+void CLJFunction::force(const CLJBoxes &atoms, QVector<CLJForces> &forces) const
+{
+    const CLJBoxes::Container &boxes = atoms.occupiedBoxes();
+
+    if (forces.count() != boxes.count())
+    {
+        if (not forces.isEmpty())
+            throw SireError::incompatible_error( QObject::tr(
+                    "The number of force arrays (%1) is not equal to the number "
+                    "of occupied boxes (%2).")
+                        .arg(forces.count()).arg(boxes.count()), CODELOC );
+
+        forces = QVector<CLJForces>(boxes.count());
+    }
+
+    const float min_cutoff = this->hasCutoff() ?
+                                qMax( this->coulombCutoff(), this->ljCutoff() ) : 0;
+
+    CLJForces *f = forces.data();
+
+    for (int i=0; i<boxes.count(); ++i)
+    {
+        const CLJBox &box0 = boxes.constData()[i].read();
+
+        //calculate the forces within the box
+        this->force(box0.atoms(), f[i]);
+
+        //now calculate the forces with all other boxes
+        for (int j=i+1; j<boxes.count(); ++j)
+        {
+            const CLJBox &box1 = boxes.constData()[j].read();
+
+            if (this->hasCutoff())
+            {
+                if (atoms.getDistance(spce.read(), box0.index(), box1.index())
+                            >= min_cutoff)
+                    continue;
+            }
+
+            this->force(box0.atoms(), box1.atoms(), f[i], f[j]);
+        }
+    }
+}
+
+/** The number of MultiFloat parameters per soft-core state used by
+    the fused multi-state kernel. These are alpha, alpha*shift_delta,
+    (1-alpha)^n, the softened coulomb cutoff, and the a, b and c
+    parameters of the general coulomb form q0 q1 ( 1/r + a r + b r^2 - c ) */
+static const int N_SOFT_STATE_PARAMS = 7;
+
+/** Internal function used to see if all of the passed functions can be
+    calculated together by the fused multi-state soft-core kernel. This is
+    possible if they are all soft-core intermolecular functions that differ
+    only in their soft-core parameters (alpha, shift delta and coulomb power)
+    or dielectric, i.e. they have the same space, cutoffs and combining rules.
+    If they can, then the per-state parameters are placed into 'states' and
+    true is returned */
+bool CLJFunction::getSoftStates(const QVector<CLJFunctionPtr> &funcs,
+                                QVector<MultiFloat> &states)
+{
+    states.clear();
+
+    if (funcs.count() < 2)
+        return false;
+
+    const CLJFunction &func0 = funcs.constData()[0].read();
+
+    const float coul_cutoff = func0.coulombCutoff().value();
+    const float lj_cutoff = func0.ljCutoff().value();
+
+    states.reserve( N_SOFT_STATE_PARAMS * funcs.count() );
+
+    for (int i=0; i<funcs.count(); ++i)
+    {
+        const CLJFunction &func = funcs.constData()[i].read();
+
+        if (not func.isA<CLJSoftFunction>())
+            return false;
+
+        if (func.use_triclinic != func0.use_triclinic or
+            func.use_arithmetic != func0.use_arithmetic or
+            func.use_box != func0.use_box or func.box_dimensions != func0.box_dimensions or
+            func.coulombCutoff().value() != coul_cutoff or
+            func.ljCutoff().value() != lj_cutoff)
+        {
+            return false;
+        }
+
+        if (i > 0 and not func.spce.read().equals(func0.spce.read()))
+            return false;
+
+        const CLJSoftFunction &soft = func.asA<CLJSoftFunction>();
+
+        float coul_a, coul_b, coul_c;
+
+        if (not soft.softCoulombParameters(coul_a, coul_b, coul_c))
+            return false;
+
+        states.append( MultiFloat(soft.alpha()) );
+        states.append( MultiFloat(soft.alphaTimesShiftDelta()) );
+        states.append( MultiFloat(soft.oneMinusAlphaToN()) );
+        states.append( MultiFloat(std::sqrt(soft.alpha() + coul_cutoff*coul_cutoff)) );
+        states.append( MultiFloat(coul_a) );
+        states.append( MultiFloat(coul_b) );
+        states.append( MultiFloat(coul_c) );
+    }
+
+    return true;
+}
+
+/** This is the fused multi-state soft-core kernel. This calculates the
+    coulomb and LJ energies between 'atoms0' and 'atoms1' (or between the
+    atoms in 'atoms0' and themselves if 'atoms1' is null) for all of the
+    soft-core states in 'states'. The distance between each pair of atoms
+    is calculated only once, and is then used for every state. The energies
+    are added onto 'cnrgs' and 'ljnrgs' */
+static void calcSoftMultiKernel(const QVector<MultiFloat> &states,
+                                const CLJAtoms &atoms0, const CLJAtoms *atoms1,
+                                const bool use_arithmetic, const bool use_box,
+                                const Vector &box_dimensions, const float lj_cutoff,
+                                double *cnrgs, double *ljnrgs)
+{
+    const bool self = (atoms1 == 0);
+
+    if (atoms0.isEmpty() or ((not self) and atoms1->isEmpty()))
+        return;
+
+    if ((not self) and atoms0.count() > atoms1->count())
+    {
+        //loop over the smaller set of atoms in the outer loop
+        calcSoftMultiKernel(states, *atoms1, &atoms0, use_arithmetic, use_box,
+                            box_dimensions, lj_cutoff, cnrgs, ljnrgs);
+        return;
+    }
+
+    const CLJAtoms &other = self ? atoms0 : *atoms1;
+
+    const MultiFloat *x0 = atoms0.x().constData();
+    const MultiFloat *y0 = atoms0.y().constData();
+    const MultiFloat *z0 = atoms0.z().constData();
+    const MultiFloat *q0 = atoms0.q().constData();
+    const MultiFloat *sig0 = atoms0.sigma().constData();
+    const MultiFloat *eps0 = atoms0.epsilon().constData();
+    const MultiInt *id0 = atoms0.ID().constData();
+
+    const MultiFloat *x1 = other.x().constData();
+    const MultiFloat *y1 = other.y().constData();
+    const MultiFloat *z1 = other.z().constData();
+    const MultiFloat *q1 = other.q().constData();
+    const MultiFloat *sig1 = other.sigma().constData();
+    const MultiFloat *eps1 = other.epsilon().constData();
+    const MultiInt *id1 = other.ID().constData();
+
+    const MultiFloat Rlj2(lj_cutoff*lj_cutoff);
+    const MultiFloat half(0.5);
+    const MultiInt dummy_id = CLJAtoms::idOfDummy();
+    const qint32 dummy_int = dummy_id[0];
+
+    const MultiFloat box_x( box_dimensions.x() );
+    const MultiFloat box_y( box_dimensions.y() );
+    const MultiFloat box_z( box_dimensions.z() );
+    
+    const MultiFloat half_box_x( 0.5 * box_dimensions.x() );
+    const MultiFloat half_box_y( 0.5 * box_dimensions.y() );
+    const MultiFloat half_box_z( 0.5 * box_dimensions.z() );
+
+    const int nstates = states.count() / N_SOFT_STATE_PARAMS;
+    const MultiFloat *state = states.constData();
+
+    QVarLengthArray<MultiDouble,32> icnrgs(nstates);
+    QVarLengthArray<MultiDouble,32> iljnrgs(nstates);
+
+    for (int k=0; k<nstates; ++k)
+    {
+        icnrgs[k] = MultiDouble(0);
+        iljnrgs[k] = MultiDouble(0);
+    }
+
+    MultiFloat tmp, r2, soft_r, soft_r2, qq, sigma, sig2, epseps, lj_mask;
+    MultiFloat sig2_over_delta, sig6_over_delta3;
+    MultiInt itmp;
+
+    const int n0 = atoms0.x().count();
+    const int n1 = other.x().count();
+
+    for (int i=0; i<n0; ++i)
+    {
+        for (int ii=0; ii<MultiFloat::count(); ++ii)
+        {
+            if (id0[i][ii] == dummy_int or (q0[i][ii] == 0 and eps0[i][ii] == 0))
+                continue;
+
+            const MultiInt id(id0[i][ii]);
+            const MultiFloat x(x0[i][ii]);
+            const MultiFloat y(y0[i][ii]);
+            const MultiFloat z(z0[i][ii]);
+            const MultiFloat q(q0[i][ii]);
+            const MultiFloat sig( use_arithmetic ? sig0[i][ii] * sig0[i][ii]
+                                                 : sig0[i][ii] );
+            const MultiFloat eps(eps0[i][ii]);
+
+            const bool has_coul = (q0[i][ii] != 0);
+            const bool has_lj = (eps0[i][ii] != 0);
+
+            for (int j=(self ? i : 0); j<n1; ++j)
+            {
+                // if i == j then we double-calculate the energies, so must
+                // scale them by 0.5
+                const MultiFloat scale( (self and i == j) ? 0.5 : 1.0 );
+
+                //calculate the distance^2 - this is shared by all states
+                if (use_box)
+                {
+                    tmp = x1[j] - x;
+                    tmp &= MULTIFLOAT_POS_MASK;  // this creates the absolute value :-)
+                    tmp -= box_x.logicalAnd( half_box_x.compareLess(tmp) );
+                    r2 = tmp * tmp;
+
+                    tmp = y1[j] - y;
+                    tmp &= MULTIFLOAT_POS_MASK;
+                    tmp -= box_y.logicalAnd( half_box_y.compareLess(tmp) );
+                    r2.multiplyAdd(tmp, tmp);
+
+                    tmp = z1[j] - z;
+                    tmp &= MULTIFLOAT_POS_MASK;
+                    tmp -= box_z.logicalAnd( half_box_z.compareLess(tmp) );
+                    r2.multiplyAdd(tmp, tmp);
+                }
+                else
+                {
+                    tmp = x1[j] - x;
+                    r2 = tmp * tmp;
+                    tmp = y1[j] - y;
+                    r2.multiplyAdd(tmp, tmp);
+                    tmp = z1[j] - z;
+                    r2.multiplyAdd(tmp, tmp);
+                }
+
+                //make sure that the ID of atoms1 is not zero, and is
+                //also not the same as the atoms0.
+                itmp = id1[j].compareEqual(dummy_id);
+                itmp |= id1[j].compareEqual(id);
+
+                if (has_coul)
+                {
+                    qq = q * q1[j];
+
+                    for (int k=0; k<nstates; ++k)
+                    {
+                        const MultiFloat *s = state + k*N_SOFT_STATE_PARAMS;
+
+                        soft_r2 = r2 + s[0];
+                        soft_r = soft_r2.sqrt();
+
+                        // energy = q0q1 * { 1/r + a r + b r^2 - c }
+                        tmp = soft_r.reciprocal();
+                        tmp.multiplyAdd(s[4], soft_r);
+                        tmp.multiplyAdd(s[5], soft_r2);
+                        tmp -= s[6];
+                        tmp *= s[2] * qq;
+
+                        //apply the cutoff
+                        tmp &= soft_r.compareLess(s[3]);
+
+                        icnrgs[k] += scale * tmp.logicalAndNot(itmp);
+                    }
+                }
+
+                if (has_lj)
+                {
+                    if (use_arithmetic)
+                    {
+                        sigma = sig + (sig1[j]*sig1[j]);
+                        sigma *= half;
+                    }
+                    else
+                    {
+                        sigma = sig * sig1[j];
+                    }
+
+                    sig2 = sigma * sigma;
+                    epseps = eps * eps1[j];
+                    lj_mask = r2.compareLess(Rlj2);
+
+                    for (int k=0; k<nstates; ++k)
+                    {
+                        const MultiFloat *s = state + k*N_SOFT_STATE_PARAMS;
+
+                        tmp = r2;
+                        tmp.multiplyAdd(s[1], sigma);
+
+                        sig2_over_delta = sig2 / tmp;
+                        sig6_over_delta3 = sig2_over_delta * sig2_over_delta * sig2_over_delta;
+
+                        tmp = sig6_over_delta3 * sig6_over_delta3;
+                        tmp -= sig6_over_delta3;
+                        tmp *= epseps;
+
+                        //apply the cutoff
+                        tmp &= lj_mask;
+
+                        iljnrgs[k] += scale * tmp.logicalAndNot(itmp);
+                    }
+                }
+            }
+        }
+    }
+
+    for (int k=0; k<nstates; ++k)
+    {
+        cnrgs[k] += icnrgs[k].sum();
+        ljnrgs[k] += iljnrgs[k].sum();
+    }
+}
+
+/** Calculate the energies of all of the soft-core states in 'states' between
+    'atoms0' and 'atoms1' (or between the atoms in 'atoms0' if 'atoms1' is null)
+    using the fused multi-state kernel, adding them onto 'cnrgs' and 'ljnrgs'.
+    In a triclinic box the kernel is run in vacuum against each periodic image
+    within the cutoff, with the images built in a reused scratch CLJAtoms */
+void CLJFunction::calcSoftMultiEnergy(const QVector<MultiFloat> &states,
+                                      const CLJAtoms &atoms0, const CLJAtoms *atoms1,
+                                      double *cnrgs, double *ljnrgs) const
+{
+    const float lj_cutoff = this->ljCutoff().value();
+
+    if (not use_triclinic)
+    {
+        calcSoftMultiKernel(states, atoms0, atoms1, use_arithmetic, use_box,
+                            box_dimensions, lj_cutoff, cnrgs, ljnrgs);
+        return;
+    }
+
+    CLJAtoms image;
+
+    if (atoms1 == 0)
+    {
+        calcSoftMultiKernel(states, atoms0, 0, use_arithmetic, false,
+                            box_dimensions, lj_cutoff, cnrgs, ljnrgs);
+
+        foreach (const Vector &t, this->triclinicTranslations(atoms0, atoms0, true))
+        {
+            atoms0.translate(t, image);
+            calcSoftMultiKernel(states, atoms0, &image, use_arithmetic, false,
+                                box_dimensions, lj_cutoff, cnrgs, ljnrgs);
+        }
+    }
+    else
+    {
+        if (atoms0.isEmpty() or atoms1->isEmpty())
+            return;
+
+        foreach (const Vector &t, this->triclinicTranslations(atoms0, *atoms1, false))
+        {
+            atoms0.translate(-t, image);
+            calcSoftMultiKernel(states, image, atoms1, use_arithmetic, false,
+                                box_dimensions, lj_cutoff, cnrgs, ljnrgs);
+        }
+    }
+}
+
+/** Calculate the energy of the passed atoms using all of the passed functions,
+    returning the coulomb and LJ energies for each function. If the functions
+    are soft-core functions that differ only in their soft-core parameters
+    (e.g. the same potential at different values of lambda) then the
+    energies are calculated together using a single, fused pass over
+    the atom pairs */
 tuple< QVector<double>,QVector<double> >
 CLJFunction::multiCalculate(const QVector<CLJFunctionPtr> &funcs, const CLJAtoms &atoms)
 {
     if (funcs.isEmpty())
         return tuple< QVector<double>,QVector<double> >();
     
-    QVector<double> cnrgs(funcs.count()), ljnrgs(funcs.count());
+    QVector<double> cnrgs(funcs.count(), 0.0), ljnrgs(funcs.count(), 0.0);
+
+    QVector<MultiFloat> states;
+
+    if (getSoftStates(funcs, states))
+    {
+        const CLJFunction &func0 = funcs.constData()[0].read();
     
-    for (int i=0; i<funcs.count(); ++i)
+        func0.calcSoftMultiEnergy(states, atoms, 0, cnrgs.data(), ljnrgs.data());
+    }
+    else
     {
-        tuple<double,double> nrgs = funcs.constData()[i].read().calculate(atoms);
-        cnrgs[i] = nrgs.get<0>();
-        ljnrgs[i] = nrgs.get<1>();
+        for (int i=0; i<funcs.count(); ++i)
+        {
+            tuple<double,double> nrgs = funcs.constData()[i].read().calculate(atoms);
+            cnrgs[i] = nrgs.get<0>();
+            ljnrgs[i] = nrgs.get<1>();
+        }
     }
     
     return tuple< QVector<double>,QVector<double> >(cnrgs, ljnrgs);
 }
 
+/** Calculate the energy between the passed atoms using all of the passed functions,
+    returning the coulomb and LJ energies for each function. Soft-core functions
+    that differ only in their soft-core parameters are calculated together */
 tuple< QVector<double>,QVector<double> >
 CLJFunction::multiCalculate(const QVector<CLJFunctionPtr> &funcs,
                             const CLJAtoms &atoms0, const CLJAtoms &atoms1,
@@ -1172,37 +2134,100 @@ CLJFunction::multiCalculate(const QVector<CLJFunctionPtr> &funcs,
     if (funcs.isEmpty())
         return tuple< QVector<double>,QVector<double> >();
     
-    QVector<double> cnrgs(funcs.count()), ljnrgs(funcs.count());
+    QVector<double> cnrgs(funcs.count(), 0.0), ljnrgs(funcs.count(), 0.0);
     
-    for (int i=0; i<funcs.count(); ++i)
+    QVector<MultiFloat> states;
+
+    if (getSoftStates(funcs, states))
     {
-        tuple<double,double> nrgs = funcs.constData()[i].read()
+        const CLJFunction &func0 = funcs.constData()[0].read();
+
+        if (min_distance < qMax(func0.coulombCutoff().value(), func0.ljCutoff().value()))
+        {
+            func0.calcSoftMultiEnergy(states, atoms0, &atoms1,
+                                      cnrgs.data(), ljnrgs.data());
+        }
+    }
+    else
+    {
+        for (int i=0; i<funcs.count(); ++i)
+        {
+            tuple<double,double> nrgs = funcs.constData()[i].read()
                                                         .calculate(atoms0, atoms1, min_distance);
-        cnrgs[i] = nrgs.get<0>();
-        ljnrgs[i] = nrgs.get<1>();
+            cnrgs[i] = nrgs.get<0>();
+            ljnrgs[i] = nrgs.get<1>();
+        }
     }
     
     return tuple< QVector<double>,QVector<double> >(cnrgs, ljnrgs);
 }
 
+/** Calculate the energy of the passed atoms using all of the passed functions,
+    returning the coulomb and LJ energies for each function. Soft-core functions
+    that differ only in their soft-core parameters are calculated together,
+    with the search over pairs of boxes performed only once */
 tuple< QVector<double>,QVector<double> >
 CLJFunction::multiCalculate(const QVector<CLJFunctionPtr> &funcs, const CLJBoxes &atoms)
 {
     if (funcs.isEmpty())
         return tuple< QVector<double>,QVector<double> >();
     
-    QVector<double> cnrgs(funcs.count()), ljnrgs(funcs.count());
-    
-    for (int i=0; i<funcs.count(); ++i)
+    QVector<double> cnrgs(funcs.count(), 0.0), ljnrgs(funcs.count(), 0.0);
+
+    QVector<MultiFloat> states;
+
+    if (getSoftStates(funcs, states))
     {
-        tuple<double,double> nrgs = funcs.constData()[i].read().calculate(atoms);
-        cnrgs[i] = nrgs.get<0>();
-        ljnrgs[i] = nrgs.get<1>();
+        const CLJFunction &func0 = funcs.constData()[0].read();
+
+        const float lj_cutoff = func0.ljCutoff().value();
+        const float min_cutoff = qMax( func0.coulombCutoff().value(), lj_cutoff );
+        
+        const CLJBoxes::Container &boxes = atoms.occupiedBoxes();
+        
+        for (CLJBoxes::const_iterator it0 = boxes.constBegin();
+             it0 != boxes.constEnd();
+             ++it0)
+        {
+            //calculate the self-energy of the box
+            func0.calcSoftMultiEnergy(states, it0->read().atoms(), 0,
+                                      cnrgs.data(), ljnrgs.data());
+        
+            //now calculate its interaction with all other boxes
+            CLJBoxes::const_iterator it1 = it0;
+        
+            const CLJBoxIndex &idx0 = it0->read().index();
+        
+            for (++it1; it1 != boxes.constEnd(); ++it1)
+            {
+                const CLJBoxIndex &idx1 = it1->read().index();
+            
+                if (atoms.getDistance(func0.spce.read(), idx0, idx1) < min_cutoff)
+                {
+                    func0.calcSoftMultiEnergy(states, it0->read().atoms(),
+                                              &(it1->read().atoms()),
+                                              cnrgs.data(), ljnrgs.data());
+                }
+            }
+        }
+    }
+    else
+    {
+        for (int i=0; i<funcs.count(); ++i)
+        {
+            tuple<double,double> nrgs = funcs.constData()[i].read().calculate(atoms);
+            cnrgs[i] = nrgs.get<0>();
+            ljnrgs[i] = nrgs.get<1>();
+        }
     }
     
     return tuple< QVector<double>,QVector<double> >(cnrgs, ljnrgs);
 }
 
+/** Calculate the energy between the passed atoms using all of the passed functions,
+    returning the coulomb and LJ energies for each function. Soft-core functions
+    that differ only in their soft-core parameters are calculated together,
+    with the search over pairs of boxes performed only once */
 tuple< QVector<double>,QVector<double> >
 CLJFunction::multiCalculate(const QVector<CLJFunctionPtr> &funcs,
                             const CLJBoxes &atoms0, const CLJBoxes &atoms1)
@@ -1210,18 +2235,57 @@ CLJFunction::multiCalculate(const QVector<CLJFunctionPtr> &funcs,
     if (funcs.isEmpty())
         return tuple< QVector<double>,QVector<double> >();
     
-    QVector<double> cnrgs(funcs.count()), ljnrgs(funcs.count());
-    
-    for (int i=0; i<funcs.count(); ++i)
+    QVector<double> cnrgs(funcs.count(), 0.0), ljnrgs(funcs.count(), 0.0);
+
+    QVector<MultiFloat> states;
+
+    if (atoms0.length() == atoms1.length() and getSoftStates(funcs, states))
     {
-        tuple<double,double> nrgs = funcs.constData()[i].read().calculate(atoms0, atoms1);
-        cnrgs[i] = nrgs.get<0>();
-        ljnrgs[i] = nrgs.get<1>();
+        const CLJFunction &func0 = funcs.constData()[0].read();
+
+        const float lj_cutoff = func0.ljCutoff().value();
+        const float min_cutoff = qMax( func0.coulombCutoff().value(), lj_cutoff );
+
+        const CLJBoxes::Container &boxes0 = atoms0.occupiedBoxes();
+        const CLJBoxes::Container &boxes1 = atoms1.occupiedBoxes();
+        
+        for (CLJBoxes::const_iterator it0 = boxes0.constBegin();
+             it0 != boxes0.constEnd();
+             ++it0)
+        {
+            const CLJBoxIndex &idx0 = it0->read().index();
+        
+            for (CLJBoxes::const_iterator it1 = boxes1.constBegin();
+                 it1 != boxes1.constEnd();
+                 ++it1)
+            {
+                const CLJBoxIndex &idx1 = it1->read().index();
+                
+                if (atoms0.getDistance(func0.spce.read(), idx0, idx1) < min_cutoff)
+                {
+                    func0.calcSoftMultiEnergy(states, it0->read().atoms(),
+                                              &(it1->read().atoms()),
+                                              cnrgs.data(), ljnrgs.data());
+                }
+            }
+        }
+    }
+    else
+    {
+        for (int i=0; i<funcs.count(); ++i)
+        {
+            tuple<double,double> nrgs = funcs.constData()[i].read().calculate(atoms0, atoms1);
+            cnrgs[i] = nrgs.get<0>();
+            ljnrgs[i] = nrgs.get<1>();
+        }
     }
     
     return tuple< QVector<double>,QVector<double> >(cnrgs, ljnrgs);
 }
 
+/** Calculate the energy between the passed atoms using all of the passed functions,
+    returning the coulomb and LJ energies for each function. Soft-core functions
+    that differ only in their soft-core parameters are calculated together */
 tuple< QVector<double>,QVector<double> >
 CLJFunction::multiCalculate(const QVector<CLJFunctionPtr> &funcs,
                             const CLJAtoms &atoms0, const CLJBoxes &atoms1)
@@ -1229,6 +2293,15 @@ CLJFunction::multiCalculate(const QVector<CLJFunctionPtr> &funcs,
     if (funcs.isEmpty())
         return tuple< QVector<double>,QVector<double> >();
     
+    QVector<MultiFloat> states;
+
+    if (getSoftStates(funcs, states))
+    {
+        //place the atoms into boxes so that the box-box search can
+        //be used to skip far-away atoms
+        return multiCalculate(funcs, CLJBoxes(atoms0, atoms1.length()), atoms1);
+    }
+
     QVector<double> cnrgs(funcs.count()), ljnrgs(funcs.count());
     
     for (int i=0; i<funcs.count(); ++i)
@@ -2165,6 +3238,16 @@ float CLJSoftFunction::alphaTimesShiftDelta() const
     return alpha() * shiftDelta();
 }
 
+/** Return the parameters of the softened coulomb energy of this function,
+    written in the general form q0 q1 ( 1/r + a r + b r^2 - c ) (where
+    r is the softened distance). This returns false if the coulomb
+    energy cannot be written in this form, in which case this function
+    cannot be fused with others in CLJFunction::multiCalculate */
+bool CLJSoftFunction::softCoulombParameters(float&, float&, float&) const
+{
+    return false;
+}
+
 /////////
 ///////// Implementation of CLJSoftIntraFunction
 /////////
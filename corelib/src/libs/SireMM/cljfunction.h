@@ -30,6 +30,7 @@
 #define SIREMM_CLJFUNCTION_H
 
 #include "cljatoms.h"
+#include "cljforces.h"
 
 #include "SireMol/atomidx.h"
 #include "SireMol/moleculeview.h"
@@ -208,11 +209,22 @@ public:
     double lj(const CLJBoxes &atoms) const;
     double lj(const CLJBoxes &atoms0, const CLJBoxes &atoms1) const;
 
+    CLJForces force(const CLJAtoms &atoms) const;
+
+    void force(const CLJAtoms &atoms, CLJForces &forces) const;
+    void force(const CLJAtoms &atoms0, const CLJAtoms &atoms1,
+               CLJForces &forces0) const;
+    void force(const CLJAtoms &atoms0, const CLJAtoms &atoms1,
+               CLJForces &forces0, CLJForces &forces1) const;
+
+    void force(const CLJBoxes &atoms, QVector<CLJForces> &forces) const;
+
     virtual CLJFunction* clone() const=0;
 
     static const NullCLJFunction& null();
 
     virtual bool supportsGridCalculation() const;
+    virtual bool supportsForceCalculation() const;
 
     virtual bool hasCutoff() const;
     
@@ -255,6 +267,20 @@ protected:
                              const Vector &box_dimensions,
                              const int start, const int end, float *potential) const;
 
+    virtual void calcForce(const CLJAtoms &atoms, CLJForces &forces) const;
+    virtual void calcForce(const CLJAtoms &atoms0, const CLJAtoms &atoms1,
+                           CLJForces &forces0, CLJForces *forces1) const;
+
+    void calcGeneralForce(const CLJAtoms &atoms,
+                          float coul_a, float coul_b,
+                          float coul_cutoff, float lj_cutoff,
+                          CLJForces &forces) const;
+
+    void calcGeneralForce(const CLJAtoms &atoms0, const CLJAtoms &atoms1,
+                          float coul_a, float coul_b,
+                          float coul_cutoff, float lj_cutoff,
+                          CLJForces &forces0, CLJForces *forces1) const;
+
     virtual void calcVacEnergyAri(const CLJAtoms &atoms,
                                   double &cnrg, double &ljnrg) const=0;
 
@@ -325,6 +351,20 @@ private:
     void extractDetailsFromRules(COMBINING_RULES rules);
     void extractDetailsFromSpace();
 
+    QVector<Vector> triclinicTranslations(const CLJAtoms &atoms0, const CLJAtoms &atoms1,
+                                          bool self) const;
+
+    void calcTriclinicEnergy(const CLJAtoms &atoms, double &cnrg, double &ljnrg) const;
+    void calcTriclinicEnergy(const CLJAtoms &atoms0, const CLJAtoms &atoms1,
+                             double &cnrg, double &ljnrg) const;
+
+    static bool getSoftStates(const QVector<CLJFunctionPtr> &funcs,
+                              QVector<MultiFloat> &states);
+
+    void calcSoftMultiEnergy(const QVector<MultiFloat> &states,
+                             const CLJAtoms &atoms0, const CLJAtoms *atoms1,
+                             double *cnrgs, double *ljnrgs) const;
+
     /** The space used by the function */
     SireVol::SpacePtr spce;
 
@@ -336,6 +376,12 @@ private:
     
     /** Whether or not to use a periodic box */
     bool use_box;
+    
+    /** Whether or not to use a triclinic box. The CLJ kernels
+        cannot apply a triclinic minimum image, so the interactions
+        are calculated using the vacuum kernels against each periodic
+        image within the cutoff, built in a reused scratch CLJAtoms */
+    bool use_triclinic;
 };
 
 /** This is a null (empty) CLJ function that calculates nothing */
@@ -525,6 +571,8 @@ class SIREMM_EXPORT CLJSoftFunction : public CLJCutoffFunction
 friend QDataStream& ::operator<<(QDataStream&, const CLJSoftFunction&);
 friend QDataStream& ::operator>>(QDataStream&, CLJSoftFunction&);
 
+friend class CLJFunction;  // so can fuse the calculation of several soft states
+
 public:
     CLJSoftFunction();
     CLJSoftFunction(Length cutoff);
@@ -573,6 +621,8 @@ protected:
     float oneMinusAlphaToN() const;
     float alphaTimesShiftDelta() const;
 
+    virtual bool softCoulombParameters(float &coul_a, float &coul_b, float &coul_c) const;
+
     /** The value of alpha to use */
     float alpha_value;
     
@@ -29,6 +29,7 @@
 #include "cljgrid.h"
 #include "cljcalculator.h"
 #include "cljshiftfunction.h"
+#include "gridcache.h"
 
 #include "SireVol/cartesian.h"
 
@@ -634,16 +635,46 @@ void CLJGrid::calculateGrid()
         far_atoms = CLJAtoms(far_atms);
     }
     
-    //now, go through any far atoms and add their potentials to the grid
-    //if (parallel_calc)
-    //{
-    //    write a parallel algorithm for calculating the grid - divide the entire
-    //    grid into boxes that can be evaluated in parallel
-    //}
-    //else
-    //{
-            QVector<float> pot = cljfunc.read().calculate(far_atoms, grid_info);
-    //}
+    //see if this grid has already been calculated and saved in the grid cache.
+    //The key is a hash of everything that is used to calculate the grid
+    QString cache_key;
+    QVector<float> pot;
+    
+    if (GridCache::isEnabled())
+    {
+        QByteArray data;
+        {
+            QDataStream ds(&data, QIODevice::WriteOnly);
+            SharedDataStream sds(ds);
+            
+            sds << QString("CLJGrid") << grid_info << cljfunc << far_atoms;
+        }
+        
+        cache_key = GridCache::createKey(data);
+        
+        if (GridCache::load(cache_key, pot))
+        {
+            if (pot.count() != grid_info.nPoints())
+                pot.clear();
+        }
+    }
+    
+    if (pot.isEmpty())
+    {
+        //now, go through any far atoms and add their potentials to the grid
+        //if (parallel_calc)
+        //{
+        //    write a parallel algorithm for calculating the grid - divide the entire
+        //    grid into boxes that can be evaluated in parallel
+        //}
+        //else
+        //{
+                pot = cljfunc.read().calculate(far_atoms, grid_info);
+        //}
+        
+        if (not cache_key.isEmpty())
+            GridCache::save(cache_key, pot);
+    }
     
     //update the object - note that because this is called from a const function
     //we have to be doubly sure that this has not been called twice from two
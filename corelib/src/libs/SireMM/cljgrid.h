@@ -56,7 +56,10 @@ using SireVol::GridInfo;
 
 /** This class holds a 3D grid of the coulomb potential
     at points in space created by a set of atoms, and calculates
-    the coulomb and LJ energies of atoms with that grid
+    the coulomb and LJ energies of atoms with that grid.
+    
+    If the GridCache is enabled, then the grid is saved to, and
+    reused from, the cache
     
     @author Christopher Woods
 */
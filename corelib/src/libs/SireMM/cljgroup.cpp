@@ -28,6 +28,8 @@
 
 #include "cljgroup.h"
 
+#include "SireFF/forcetable.h"
+
 #include "SireStream/datastream.h"
 #include "SireStream/shareddatastream.h"
 
@@ -219,6 +221,98 @@ Molecules CLJGroup::molecules() const
     return mols;
 }
 
+/** Return the numbers of all of the molecules in this group, sorted
+    into ascending order */
+QList<MolNum> CLJGroup::sortedMolNums() const
+{
+    QList<MolNum> molnums = cljexts.keys();
+
+    for (QHash<MolNum,CLJExtractor>::const_iterator it = changed_mols.constBegin();
+         it != changed_mols.constEnd(); ++it)
+    {
+        if (not cljexts.contains(it.key()))
+            molnums.append(it.key());
+    }
+
+    qSort(molnums);
+
+    return molnums;
+}
+
+/** Return the extractor holding the current (possibly changed) state
+    of the molecule with number 'molnum' */
+const CLJExtractor& CLJGroup::currentExtractor(MolNum molnum) const
+{
+    QHash<MolNum,CLJExtractor>::const_iterator it = changed_mols.constFind(molnum);
+
+    if (it != changed_mols.constEnd())
+        return it.value();
+    else
+        return cljexts.constFind(molnum).value();
+}
+
+/** Return all of the atoms in this group. The molecules are returned in
+    order of molecule number, with the atoms of each molecule in the order
+    in which they were extracted. Unlike cljBoxes().atoms(), this order does
+    not change as the molecules are moved, so these atoms can be used
+    with a CLJNeighbourList */
+CLJAtoms CLJGroup::atoms() const
+{
+    QVector<CLJBoxIndex> idxs;
+
+    foreach (const MolNum &molnum, this->sortedMolNums())
+    {
+        idxs += this->currentExtractor(molnum).boxIndicies();
+    }
+
+    return cljboxes.atoms(idxs);
+}
+
+/** Add the passed forces, multiplied by 'scale_force', onto the forces
+    in 'forcetable'. The forces must have been calculated for the atoms
+    returned by atoms(). Only molecules that are in the forcetable
+    have their forces added
+    
+    \throw SireError::incompatible_error
+*/
+void CLJGroup::addForces(ForceTable &forcetable, const CLJForces &forces,
+                         double scale_force) const
+{
+    if (scale_force == 0)
+        return;
+
+    int idx = 0;
+
+    foreach (const MolNum &molnum, this->sortedMolNums())
+    {
+        const CLJExtractor &extractor = this->currentExtractor(molnum);
+
+        const int natoms = extractor.boxIndicies().count();
+
+        if (idx + natoms > forces.count())
+            throw SireError::incompatible_error( QObject::tr(
+                    "There are not enough forces (%1) for the atoms in this CLJGroup. "
+                    "Were they calculated using CLJGroup::atoms()?")
+                        .arg(forces.count()), CODELOC );
+
+        if (natoms > 0 and forcetable.containsTable(molnum))
+        {
+            QVector<Vector> molforces(natoms);
+
+            for (int i=0; i<natoms; ++i)
+            {
+                molforces[i] = forces[idx+i];
+            }
+
+            CLJForces(molforces).addTo(forcetable.getTable(molnum),
+                                       extractor.newMolecule(), scale_force,
+                                       extractor.propertyMap());
+        }
+
+        idx += natoms;
+    }
+}
+
 /** Return the size of the box used by CLJBoxes to partition space */
 Length CLJGroup::boxLength() const
 {
@@ -30,6 +30,7 @@
 #define SIREMM_CLJGROUP_H
 
 #include "cljextractor.h"
+#include "cljforces.h"
 
 #include "SireMol/moleculegroup.h"
 #include "SireBase/chunkedhash.hpp"
@@ -113,6 +114,11 @@ public:
     void accept();
     
     const CLJBoxes& cljBoxes() const;
+
+    CLJAtoms atoms() const;
+    
+    void addForces(ForceTable &forcetable, const CLJForces &forces,
+                   double scale_force=1) const;
     
     CLJAtoms changedAtoms() const;
     CLJAtoms newAtoms() const;
@@ -132,6 +138,9 @@ public:
     bool recalculatingFromScratch() const;
     
 private:
+    QList<MolNum> sortedMolNums() const;
+    const CLJExtractor& currentExtractor(MolNum molnum) const;
+
     /** All of the extractors that manage extracting the charge and LJ 
         properties from all of the molecules */
     SireBase::ChunkedHash<MolNum,CLJExtractor> cljexts;
@@ -0,0 +1,504 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "cljkernels.h"
+
+#include "SireMaths/multifloat.h"
+#include "SireMaths/multiint.h"
+
+#include "SireBase/cpuid.h"
+
+#include "SireError/errors.h"
+
+#include <QAtomicInt>
+
+#include <cmath>
+
+using namespace SireMM;
+using namespace SireMaths;
+using namespace SireBase;
+
+// The instruction-set specific kernels rely on the GCC / clang 'target'
+// attribute, so are only available with those compilers on x86
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+    #define SIRE_HAVE_CLJ_DISPATCH 1
+#else
+    #undef SIRE_HAVE_CLJ_DISPATCH
+#endif
+
+namespace SireMM
+{
+    namespace detail
+    {
+        /** The instruction sets that can be chosen at runtime. COMPILED
+            means the MultiFloat kernels chosen when Sire was compiled */
+        enum CLJ_ISA { CLJ_ISA_COMPILED = 0,
+                       CLJ_ISA_AVX2 = 1,
+                       CLJ_ISA_AVX512F = 2 };
+
+        /** The chosen instruction set. The compiled MultiFloat kernels
+            are used unless a dispatched kernel is explicitly requested */
+        static QAtomicInt chosen_isa(0);
+
+        /** The raw arrays used by the kernels */
+        struct CLJKernelArgs
+        {
+            const float *x0, *y0, *z0, *q0, *sig0, *eps0;
+            const qint32 *id0;
+            int n0;
+
+            const float *x1, *y1, *z1, *q1, *sig1, *eps1;
+            const qint32 *id1;
+            int n1;
+
+            bool is_self;
+            qint32 dummy;
+
+            float a, b, c;
+            float coul_cutoff, lj_cutoff;
+
+            float box_x, box_y, box_z;
+        };
+
+        /** Return the rank of the compiled MultiFloat instruction set,
+            using the same scale as CLJ_ISA (so AVX-512F ranks the same
+            as the dispatched AVX-512F kernels) */
+        static int compiledRank()
+        {
+            #ifdef MULTIFLOAT_AVX512F_IS_AVAILABLE
+                return CLJ_ISA_AVX512F;
+            #else
+            #ifdef MULTIFLOAT_AVX2_IS_AVAILABLE
+                return CLJ_ISA_AVX2;
+            #else
+                return CLJ_ISA_COMPILED;
+            #endif
+            #endif
+        }
+
+        /** Return the best instruction set supported by this processor */
+        static int bestISA()
+        {
+            #ifdef SIRE_HAVE_CLJ_DISPATCH
+                const CPUID cpuid;
+
+                int best = CLJ_ISA_COMPILED;
+
+                if (cpuid.supportsAVX512F())
+                    best = CLJ_ISA_AVX512F;
+                else if (cpuid.supportsAVX2() and cpuid.supportsFMA3())
+                    best = CLJ_ISA_AVX2;
+
+                //prefer the compiled kernels if they are just as good
+                if (best <= compiledRank())
+                    return CLJ_ISA_COMPILED;
+                else
+                    return best;
+            #else
+                return CLJ_ISA_COMPILED;
+            #endif
+        }
+
+        static int getISA()
+        {
+            return chosen_isa.loadAcquire();
+        }
+
+        static QString isaName(int isa)
+        {
+            switch(isa)
+            {
+                case CLJ_ISA_AVX2:
+                    return "avx2";
+                case CLJ_ISA_AVX512F:
+                    return "avx512f";
+                default:
+                    return "compiled";
+            }
+        }
+
+        /** The generic kernel. This is written as plain scalar code over the
+            padded arrays held in CLJAtoms, so that the compiler can vectorise
+            it using whichever instruction set the calling function targets.
+            Masks are applied using selects so that the dummy atoms used for
+            padding (which may have r == 0) do not contribute */
+        template<bool BOX, bool ARI>
+        static inline void cljKernel(const CLJKernelArgs &args, double &cnrg, double &ljnrg)
+        {
+            const float *x1 = args.x1;
+            const float *y1 = args.y1;
+            const float *z1 = args.z1;
+            const float *q1 = args.q1;
+            const float *sig1 = args.sig1;
+            const float *eps1 = args.eps1;
+            const qint32 *id1 = args.id1;
+
+            const qint32 dummy = args.dummy;
+            const float a = args.a;
+            const float b = args.b;
+            const float c = args.c;
+            const float Rc = args.coul_cutoff;
+            const float Rlj = args.lj_cutoff;
+
+            const float box_x = args.box_x;
+            const float box_y = args.box_y;
+            const float box_z = args.box_z;
+            const float half_box_x = 0.5f * box_x;
+            const float half_box_y = 0.5f * box_y;
+            const float half_box_z = 0.5f * box_z;
+
+            const int n1 = args.n1;
+
+            double icnrg = 0;
+            double iljnrg = 0;
+
+            for (int i=0; i<args.n0; ++i)
+            {
+                const qint32 id = args.id0[i];
+
+                if (id == dummy)
+                    continue;
+
+                const float x = args.x0[i];
+                const float y = args.y0[i];
+                const float z = args.z0[i];
+                const float q = args.q0[i];
+                const float sig = ARI ? args.sig0[i] * args.sig0[i] : args.sig0[i];
+                const float eps = args.eps0[i];
+
+                // for the self-energy we only need to visit each pair once
+                const int jstart = args.is_self ? i+1 : 0;
+
+                double jcnrg = 0;
+                double jljnrg = 0;
+
+                #pragma omp simd reduction(+:jcnrg,jljnrg)
+                for (int j=jstart; j<n1; ++j)
+                {
+                    float dx = x1[j] - x;
+                    float dy = y1[j] - y;
+                    float dz = z1[j] - z;
+
+                    if (BOX)
+                    {
+                        dx = std::abs(dx);
+                        dx -= (dx > half_box_x) ? box_x : 0.0f;
+                        dy = std::abs(dy);
+                        dy -= (dy > half_box_y) ? box_y : 0.0f;
+                        dz = std::abs(dz);
+                        dz -= (dz > half_box_z) ? box_z : 0.0f;
+                    }
+
+                    const float r2 = dx*dx + dy*dy + dz*dz;
+                    const float r = std::sqrt(r2);
+                    const float one_over_r = 1.0f / r;
+
+                    //skip dummy atoms and atoms in the same molecule
+                    const bool use = (id1[j] != dummy) & (id1[j] != id);
+
+                    // energy = q0q1 * { 1/r + a r + b r^2 - c }
+                    float cnrg_j = q * q1[j] * (one_over_r + a*r + b*r2 - c);
+                    cnrg_j = (use & (r < Rc)) ? cnrg_j : 0.0f;
+
+                    const float s = ARI ? 0.5f * (sig + sig1[j]*sig1[j]) : sig * sig1[j];
+
+                    float sig6_over_r6 = s * s * one_over_r * one_over_r;
+                    sig6_over_r6 = sig6_over_r6 * sig6_over_r6 * sig6_over_r6;
+
+                    float ljnrg_j = eps * eps1[j] * (sig6_over_r6*sig6_over_r6 - sig6_over_r6);
+                    ljnrg_j = (use & (r < Rlj)) ? ljnrg_j : 0.0f;
+
+                    jcnrg += cnrg_j;
+                    jljnrg += ljnrg_j;
+                }
+
+                icnrg += jcnrg;
+                iljnrg += jljnrg;
+            }
+
+            cnrg = icnrg;
+            ljnrg = iljnrg;
+        }
+
+        static inline void cljKernel(const CLJKernelArgs &args, bool use_box, bool use_ari,
+                                     double &cnrg, double &ljnrg)
+        {
+            if (use_box)
+            {
+                if (use_ari)
+                    cljKernel<true,true>(args, cnrg, ljnrg);
+                else
+                    cljKernel<true,false>(args, cnrg, ljnrg);
+            }
+            else
+            {
+                if (use_ari)
+                    cljKernel<false,true>(args, cnrg, ljnrg);
+                else
+                    cljKernel<false,false>(args, cnrg, ljnrg);
+            }
+        }
+
+        #ifdef SIRE_HAVE_CLJ_DISPATCH
+            /** Version of the kernel compiled for AVX2 with FMA */
+            __attribute__((target("avx2,fma"), flatten))
+            static void cljKernelAVX2(const CLJKernelArgs &args, bool use_box, bool use_ari,
+                                      double &cnrg, double &ljnrg)
+            {
+                cljKernel(args, use_box, use_ari, cnrg, ljnrg);
+            }
+
+            /** Version of the kernel compiled for AVX-512F */
+            __attribute__((target("avx512f,avx2,fma"), flatten))
+            static void cljKernelAVX512F(const CLJKernelArgs &args, bool use_box, bool use_ari,
+                                         double &cnrg, double &ljnrg)
+            {
+                cljKernel(args, use_box, use_ari, cnrg, ljnrg);
+            }
+        #endif
+
+        /** Run the kernel on the best instruction set. This returns false
+            if the compiled MultiFloat kernel should be used instead */
+        static bool runKernel(const CLJAtoms &atoms0, const CLJAtoms &atoms1, bool is_self,
+                              const Vector &box_dimensions, bool use_box,
+                              float coul_a, float coul_b, float coul_c,
+                              float coul_cutoff, float lj_cutoff, bool use_arithmetic,
+                              double &cnrg, double &ljnrg)
+        {
+            const int isa = getISA();
+
+            if (isa == CLJ_ISA_COMPILED)
+                return false;
+
+            CLJKernelArgs args;
+
+            //CLJAtoms stores each property as a contiguous array of floats
+            //(padded with dummy atoms), so the kernels can read these directly
+            args.x0 = reinterpret_cast<const float*>(atoms0.x().constData());
+            args.y0 = reinterpret_cast<const float*>(atoms0.y().constData());
+            args.z0 = reinterpret_cast<const float*>(atoms0.z().constData());
+            args.q0 = reinterpret_cast<const float*>(atoms0.q().constData());
+            args.sig0 = reinterpret_cast<const float*>(atoms0.sigma().constData());
+            args.eps0 = reinterpret_cast<const float*>(atoms0.epsilon().constData());
+            args.id0 = reinterpret_cast<const qint32*>(atoms0.ID().constData());
+            args.n0 = atoms0.x().count() * MultiFloat::count();
+
+            args.x1 = reinterpret_cast<const float*>(atoms1.x().constData());
+            args.y1 = reinterpret_cast<const float*>(atoms1.y().constData());
+            args.z1 = reinterpret_cast<const float*>(atoms1.z().constData());
+            args.q1 = reinterpret_cast<const float*>(atoms1.q().constData());
+            args.sig1 = reinterpret_cast<const float*>(atoms1.sigma().constData());
+            args.eps1 = reinterpret_cast<const float*>(atoms1.epsilon().constData());
+            args.id1 = reinterpret_cast<const qint32*>(atoms1.ID().constData());
+            args.n1 = atoms1.x().count() * MultiFloat::count();
+
+            args.is_self = is_self;
+            args.dummy = CLJAtoms::idOfDummy()[0];
+
+            args.a = coul_a;
+            args.b = coul_b;
+            args.c = coul_c;
+            args.coul_cutoff = coul_cutoff;
+            args.lj_cutoff = lj_cutoff;
+
+            args.box_x = box_dimensions.x();
+            args.box_y = box_dimensions.y();
+            args.box_z = box_dimensions.z();
+
+            #ifdef SIRE_HAVE_CLJ_DISPATCH
+                if (isa == CLJ_ISA_AVX512F)
+                {
+                    cljKernelAVX512F(args, use_box, use_arithmetic, cnrg, ljnrg);
+                    return true;
+                }
+                else if (isa == CLJ_ISA_AVX2)
+                {
+                    cljKernelAVX2(args, use_box, use_arithmetic, cnrg, ljnrg);
+                    return true;
+                }
+            #endif
+
+            return false;
+        }
+
+    } // end of namespace detail
+} // end of namespace SireMM
+
+using namespace SireMM::detail;
+
+/** Return the name of the instruction set that is used for the
+    CLJ kernels. This is "compiled" if the MultiFloat kernels chosen
+    when Sire was compiled are used */
+QString CLJKernels::instructionSet()
+{
+    return isaName(getISA());
+}
+
+/** Return the name of the vector instruction set used by MultiFloat,
+    which was chosen when Sire was compiled */
+QString CLJKernels::compiledInstructionSet()
+{
+    #ifdef MULTIFLOAT_AVX512F_IS_AVAILABLE
+        return "avx512f";
+    #else
+    #ifdef MULTIFLOAT_AVX2_IS_AVAILABLE
+        return "avx2";
+    #else
+    #ifdef MULTIFLOAT_AVX_IS_AVAILABLE
+        return "avx";
+    #else
+    #ifdef MULTIFLOAT_SSE_IS_AVAILABLE
+        return "sse2";
+    #else
+        return "none";
+    #endif
+    #endif
+    #endif
+    #endif
+}
+
+/** Return the names of all instruction sets that can be used on this
+    processor. "compiled" is always available */
+QStringList CLJKernels::availableInstructionSets()
+{
+    QStringList isas;
+    isas.append( isaName(CLJ_ISA_COMPILED) );
+
+    #ifdef SIRE_HAVE_CLJ_DISPATCH
+        const CPUID cpuid;
+
+        if (cpuid.supportsAVX2() and cpuid.supportsFMA3())
+            isas.append( isaName(CLJ_ISA_AVX2) );
+
+        if (cpuid.supportsAVX512F())
+            isas.append( isaName(CLJ_ISA_AVX512F) );
+    #endif
+
+    return isas;
+}
+
+/** Override the instruction set used for the CLJ kernels. This must be
+    one of the values returned by availableInstructionSets, or "auto"
+    to choose the best instruction set supported by this processor
+    (which is only a dispatched kernel if it is better than the
+     compiled MultiFloat kernels)
+
+    \throw SireError::unsupported
+*/
+void CLJKernels::setInstructionSet(const QString &isa)
+{
+    const QString name = isa.toLower();
+
+    if (name == "auto")
+    {
+        chosen_isa.storeRelease( bestISA() );
+        return;
+    }
+
+    if (not availableInstructionSets().contains(name))
+        throw SireError::unsupported( QObject::tr(
+                "Cannot use the instruction set '%1' for the CLJ kernels as it is not "
+                "supported on this processor. Available instruction sets are %2.")
+                    .arg(isa).arg(availableInstructionSets().join(", ")), CODELOC );
+
+    for (int i=CLJ_ISA_COMPILED; i<=CLJ_ISA_AVX512F; ++i)
+    {
+        if (isaName(i) == name)
+        {
+            chosen_isa.storeRelease(i);
+            return;
+        }
+    }
+}
+
+/** Reset the instruction set so that the compiled MultiFloat kernels
+    are used (this is the default) */
+void CLJKernels::resetInstructionSet()
+{
+    chosen_isa.storeRelease( CLJ_ISA_COMPILED );
+}
+
+/** Return whether or not the CLJ kernels are dispatched to one of the
+    instruction-set specific kernels (rather than the compiled MultiFloat kernels) */
+bool CLJKernels::isDispatched()
+{
+    return getISA() != CLJ_ISA_COMPILED;
+}
+
+/** Calculate the coulomb and LJ energy between all pairs of atoms in 'atoms'
+    using the runtime-dispatched kernels, returning the results in 'cnrg' and 'ljnrg'.
+    This returns false (and does nothing) if the compiled MultiFloat
+    kernels should be used instead */
+bool CLJKernels::calcEnergy(const CLJAtoms &atoms,
+                            float coul_a, float coul_b, float coul_c,
+                            float coul_cutoff, float lj_cutoff, bool use_arithmetic,
+                            double &cnrg, double &ljnrg)
+{
+    return runKernel(atoms, atoms, true, Vector(0), false, coul_a, coul_b, coul_c,
+                     coul_cutoff, lj_cutoff, use_arithmetic, cnrg, ljnrg);
+}
+
+/** Calculate the coulomb and LJ energy between all atoms in 'atoms0' and all
+    atoms in 'atoms1' using the runtime-dispatched kernels, returning the
+    results in 'cnrg' and 'ljnrg'. This returns false (and does nothing)
+    if the compiled MultiFloat kernels should be used instead */
+bool CLJKernels::calcEnergy(const CLJAtoms &atoms0, const CLJAtoms &atoms1,
+                            float coul_a, float coul_b, float coul_c,
+                            float coul_cutoff, float lj_cutoff, bool use_arithmetic,
+                            double &cnrg, double &ljnrg)
+{
+    return runKernel(atoms0, atoms1, false, Vector(0), false, coul_a, coul_b, coul_c,
+                     coul_cutoff, lj_cutoff, use_arithmetic, cnrg, ljnrg);
+}
+
+/** Calculate the coulomb and LJ energy between all pairs of atoms in 'atoms'
+    using periodic boundaries in a box of size 'box_dimensions'. This returns
+    false (and does nothing) if the compiled MultiFloat kernels should be
+    used instead */
+bool CLJKernels::calcBoxEnergy(const CLJAtoms &atoms, const Vector &box_dimensions,
+                               float coul_a, float coul_b, float coul_c,
+                               float coul_cutoff, float lj_cutoff, bool use_arithmetic,
+                               double &cnrg, double &ljnrg)
+{
+    return runKernel(atoms, atoms, true, box_dimensions, true, coul_a, coul_b, coul_c,
+                     coul_cutoff, lj_cutoff, use_arithmetic, cnrg, ljnrg);
+}
+
+/** Calculate the coulomb and LJ energy between all atoms in 'atoms0' and all
+    atoms in 'atoms1' using periodic boundaries in a box of size 'box_dimensions'.
+    This returns false (and does nothing) if the compiled MultiFloat
+    kernels should be used instead */
+bool CLJKernels::calcBoxEnergy(const CLJAtoms &atoms0, const CLJAtoms &atoms1,
+                               const Vector &box_dimensions,
+                               float coul_a, float coul_b, float coul_c,
+                               float coul_cutoff, float lj_cutoff, bool use_arithmetic,
+                               double &cnrg, double &ljnrg)
+{
+    return runKernel(atoms0, atoms1, false, box_dimensions, true, coul_a, coul_b, coul_c,
+                     coul_cutoff, lj_cutoff, use_arithmetic, cnrg, ljnrg);
+}
@@ -0,0 +1,110 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#ifndef SIREMM_CLJKERNELS_H
+#define SIREMM_CLJKERNELS_H
+
+#include "cljatoms.h"
+
+#include "SireMaths/vector.h"
+
+#include <QStringList>
+
+SIRE_BEGIN_HEADER
+
+namespace SireMM
+{
+
+using SireMaths::Vector;
+
+/** This class provides the runtime-dispatched versions of the hot
+    coulomb and LJ kernels used by CLJShiftFunction and CLJRFFunction.
+
+    MultiFloat chooses its vector instruction set (SSE, AVX or AVX-512)
+    when Sire is compiled, so a single binary can only use the instruction
+    set of the oldest processor it must run on. The kernels in this class
+    are compiled several times, each targetting a different instruction
+    set (AVX2+FMA and AVX-512F). By default the CLJFunctions use their
+    normal MultiFloat kernels. The dispatched kernels are only used
+    if they are selected using setInstructionSet (passing "auto"
+    chooses the best version supported by the processor, as reported
+    by SireBase::CPUID).
+
+    The coulomb energy is calculated using the general form
+    q0 q1 ( 1/r + a r + b r^2 - c ), which gives shifted
+    electrostatics (a = 1/Rc^2, b = 0, c = 2/Rc) and reaction field
+    (a = 0, b = k_rf, c = c_rf).
+
+    @author Christopher Woods
+*/
+class SIREMM_EXPORT CLJKernels
+{
+public:
+    static QString instructionSet();
+    static QString compiledInstructionSet();
+
+    static QStringList availableInstructionSets();
+
+    static void setInstructionSet(const QString &isa);
+    static void resetInstructionSet();
+
+    static bool isDispatched();
+
+    static bool calcEnergy(const CLJAtoms &atoms,
+                           float coul_a, float coul_b, float coul_c,
+                           float coul_cutoff, float lj_cutoff,
+                           bool use_arithmetic,
+                           double &cnrg, double &ljnrg);
+
+    static bool calcEnergy(const CLJAtoms &atoms0, const CLJAtoms &atoms1,
+                           float coul_a, float coul_b, float coul_c,
+                           float coul_cutoff, float lj_cutoff,
+                           bool use_arithmetic,
+                           double &cnrg, double &ljnrg);
+
+    static bool calcBoxEnergy(const CLJAtoms &atoms, const Vector &box_dimensions,
+                              float coul_a, float coul_b, float coul_c,
+                              float coul_cutoff, float lj_cutoff,
+                              bool use_arithmetic,
+                              double &cnrg, double &ljnrg);
+
+    static bool calcBoxEnergy(const CLJAtoms &atoms0, const CLJAtoms &atoms1,
+                              const Vector &box_dimensions,
+                              float coul_a, float coul_b, float coul_c,
+                              float coul_cutoff, float lj_cutoff,
+                              bool use_arithmetic,
+                              double &cnrg, double &ljnrg);
+};
+
+}
+
+SIRE_EXPOSE_CLASS( SireMM::CLJKernels )
+
+SIRE_END_HEADER
+
+#endif
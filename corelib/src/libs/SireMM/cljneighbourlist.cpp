@@ -0,0 +1,844 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "cljneighbourlist.h"
+#include "cljatoms.h"
+
+#include "SireMaths/multifloat.h"
+#include "SireMaths/multiint.h"
+
+#include "SireVol/space.h"
+#include "SireVol/periodicbox.h"
+#include "SireVol/aabox.h"
+
+#include "SireUnits/units.h"
+
+#include "SireError/errors.h"
+
+#include "SireStream/datastream.h"
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+#include <limits>
+#include <algorithm>
+
+using namespace SireMM;
+using namespace SireMaths;
+using namespace SireVol;
+using namespace SireUnits;
+using namespace SireStream;
+
+static const RegisterMetaType<CLJNeighbourList> r_nbrlist(NO_ROOT);
+
+QDataStream SIREMM_EXPORT &operator<<(QDataStream &ds, const CLJNeighbourList &list)
+{
+    writeHeader(ds, r_nbrlist, 1);
+
+    //only the skin is saved - the list is rebuilt on first use after loading
+    ds << list.skin_size;
+
+    return ds;
+}
+
+QDataStream SIREMM_EXPORT &operator>>(QDataStream &ds, CLJNeighbourList &list)
+{
+    VersionID v = readHeader(ds, r_nbrlist);
+
+    if (v == 1)
+    {
+        float skin_size;
+        ds >> skin_size;
+
+        list = CLJNeighbourList( Length(skin_size) );
+    }
+    else
+        throw version_error(v, "1", r_nbrlist, CODELOC);
+
+    return ds;
+}
+
+/** The default skin size (in angstroms) */
+static const float default_skin = 1.0;
+
+/** Constructor */
+CLJNeighbourList::CLJNeighbourList()
+                 : skin_size(default_skin), built_cutoff(0), nrebuilds(0)
+{}
+
+/** Construct a list that uses the passed skin */
+CLJNeighbourList::CLJNeighbourList(Length skin)
+                 : skin_size(default_skin), built_cutoff(0), nrebuilds(0)
+{
+    this->setSkin(skin);
+}
+
+/** Copy constructor */
+CLJNeighbourList::CLJNeighbourList(const CLJNeighbourList &other)
+                 : skin_size(other.skin_size), built_cutoff(other.built_cutoff),
+                   built_space(other.built_space),
+                   ref_x(other.ref_x), ref_y(other.ref_y), ref_z(other.ref_z),
+                   neighbour_start(other.neighbour_start),
+                   neighbour_clusters(other.neighbour_clusters),
+                   nrebuilds(other.nrebuilds)
+{}
+
+/** Destructor */
+CLJNeighbourList::~CLJNeighbourList()
+{}
+
+/** Copy assignment operator */
+CLJNeighbourList& CLJNeighbourList::operator=(const CLJNeighbourList &other)
+{
+    if (this != &other)
+    {
+        skin_size = other.skin_size;
+        built_cutoff = other.built_cutoff;
+        built_space = other.built_space;
+        ref_x = other.ref_x;
+        ref_y = other.ref_y;
+        ref_z = other.ref_z;
+        neighbour_start = other.neighbour_start;
+        neighbour_clusters = other.neighbour_clusters;
+        nrebuilds = other.nrebuilds;
+    }
+
+    return *this;
+}
+
+/** Comparison operator */
+bool CLJNeighbourList::operator==(const CLJNeighbourList &other) const
+{
+    return skin_size == other.skin_size and built_cutoff == other.built_cutoff and
+           neighbour_start == other.neighbour_start and
+           neighbour_clusters == other.neighbour_clusters;
+}
+
+/** Comparison operator */
+bool CLJNeighbourList::operator!=(const CLJNeighbourList &other) const
+{
+    return not operator==(other);
+}
+
+const char* CLJNeighbourList::typeName()
+{
+    return QMetaType::typeName( qMetaTypeId<CLJNeighbourList>() );
+}
+
+const char* CLJNeighbourList::what() const
+{
+    return CLJNeighbourList::typeName();
+}
+
+QString CLJNeighbourList::toString() const
+{
+    return QObject::tr("CLJNeighbourList( skin() == %1 A, nClusters() == %2, "
+                       "nClusterPairs() == %3 )")
+                .arg(skin_size).arg(nClusters()).arg(nClusterPairs());
+}
+
+/** Return whether or not this list is empty (has not been built) */
+bool CLJNeighbourList::isEmpty() const
+{
+    return neighbour_start.isEmpty();
+}
+
+/** Return the size of the skin that is added onto the cutoff */
+Length CLJNeighbourList::skin() const
+{
+    return Length(skin_size);
+}
+
+/** Set the size of the skin that is added onto the cutoff. A larger
+    skin means that the list is rebuilt less often, but that more
+    out-of-cutoff pairs are evaluated. This clears the list */
+void CLJNeighbourList::setSkin(Length skin)
+{
+    if (skin.value() < 0)
+        throw SireError::invalid_arg( QObject::tr(
+                "The skin of the neighbour list cannot be negative (%1 A)")
+                    .arg(skin.to(angstrom)), CODELOC );
+
+    skin_size = skin.value();
+    this->clear();
+}
+
+/** Return the number of clusters in the list */
+int CLJNeighbourList::nClusters() const
+{
+    return qMax(0, neighbour_start.count() - 1);
+}
+
+/** Return the number of pairs of (different) clusters in the list */
+int CLJNeighbourList::nClusterPairs() const
+{
+    return neighbour_clusters.count();
+}
+
+/** Return the number of times that this list has been rebuilt */
+int CLJNeighbourList::nRebuilds() const
+{
+    return nrebuilds;
+}
+
+/** Clear the list, so that it will be rebuilt when next used */
+void CLJNeighbourList::clear()
+{
+    built_cutoff = 0;
+    built_space = SpacePtr();
+    ref_x.clear();
+    ref_y.clear();
+    ref_z.clear();
+    neighbour_start.clear();
+    neighbour_clusters.clear();
+}
+
+/** Return the cutoff used to build the list for the passed function */
+static float getCutoff(const CLJFunction &func)
+{
+    if (func.hasCutoff())
+        return qMax( func.coulombCutoff().value(), func.ljCutoff().value() );
+    else
+        return std::numeric_limits<float>::max();
+}
+
+/** Return whether or not the list needs to be rebuilt for the passed
+    function and atoms. This is true if the list is empty, the number
+    of atoms, the cutoff or the space has changed, or if any atom has moved by
+    more than half the skin since the list was built */
+bool CLJNeighbourList::needsRebuild(const CLJFunction &func, const CLJAtoms &atoms) const
+{
+    if (this->isEmpty() or atoms.x().count() != ref_x.count() or
+        getCutoff(func) != built_cutoff or func.space() != built_space.read())
+    {
+        return true;
+    }
+
+    if (not func.hasCutoff())
+        //the list contains all pairs
+        return false;
+
+    const MultiFloat *x = atoms.x().constData();
+    const MultiFloat *y = atoms.y().constData();
+    const MultiFloat *z = atoms.z().constData();
+
+    const MultiFloat *x0 = ref_x.constData();
+    const MultiFloat *y0 = ref_y.constData();
+    const MultiFloat *z0 = ref_z.constData();
+
+    const MultiFloat max_dist2( 0.25 * skin_size * skin_size );
+
+    MultiFloat tmp, dist2;
+
+    for (int i=0; i<ref_x.count(); ++i)
+    {
+        tmp = x[i] - x0[i];
+        dist2 = tmp * tmp;
+        tmp = y[i] - y0[i];
+        dist2.multiplyAdd(tmp, tmp);
+        tmp = z[i] - z0[i];
+        dist2.multiplyAdd(tmp, tmp);
+
+        //any atom that has moved more than half the skin?
+        if (not max_dist2.compareLess(dist2).isBinaryZero())
+            return true;
+    }
+
+    return false;
+}
+
+namespace SireMM
+{
+    namespace detail
+    {
+        /** This is a private helper class that bins the centers of the
+            clusters into a grid of cells, so that the neighbours of each
+            cluster need only be searched for in the neighbouring cells */
+        class CLJClusterCells
+        {
+        public:
+            CLJClusterCells(const Space &space, const QVector<Vector> &centers,
+                            const QVector<qint32> &clusters, float min_length);
+
+            /** Return the number of cells */
+            int nCells() const
+            {
+                return cell_start.count() - 1;
+            }
+
+            /** Return the index of the cell containing the ith cluster */
+            int cellOf(int i) const
+            {
+                return cell_of.constData()[i];
+            }
+
+            /** Return the clusters in the passed cell */
+            const qint32* clusters(int cell, int &nclusters) const
+            {
+                const int start = cell_start.constData()[cell];
+                nclusters = cell_start.constData()[cell+1] - start;
+                return cell_members.constData() + start;
+            }
+
+            /** Return the cells that neighbour the passed cell (including
+                the cell itself) */
+            const QVector<qint32>& neighbours(int cell) const
+            {
+                return cell_nbrs.constData()[cell];
+            }
+
+        private:
+            int cellIndex(int i, int j, int k) const
+            {
+                return (i*ny + j)*nz + k;
+            }
+
+            /** The number of cells along each dimension */
+            int nx, ny, nz;
+
+            /** The index of the cell of each cluster (-1 if the
+                cluster contains only dummy atoms) */
+            QVector<qint32> cell_of;
+
+            /** The index into 'cell_members' of the first cluster in
+                each cell (with one extra value giving the total) */
+            QVector<qint32> cell_start;
+
+            /** The clusters in each cell */
+            QVector<qint32> cell_members;
+
+            /** The neighbouring cells of each occupied cell */
+            QVector< QVector<qint32> > cell_nbrs;
+        };
+
+        /** Bin the clusters in 'clusters' (whose centers are in 'centers') into
+            cells that are at least 'min_length' wide. Any two clusters whose centers
+            are closer than 'min_length' will be in the same or neighbouring cells.
+            Cartesian and PeriodicBox spaces use the 27 (periodic) cells around each
+            cell. Other spaces (e.g. TriclinicBox) use the space to find all pairs of
+            occupied cells that are closer than 'min_length' */
+        CLJClusterCells::CLJClusterCells(const Space &space, const QVector<Vector> &centers,
+                                         const QVector<qint32> &clusters, float min_length)
+                        : nx(1), ny(1), nz(1)
+        {
+            const int nclusters = clusters.count();
+            const bool is_box = space.isA<PeriodicBox>();
+            const bool use_stencil = space.isCartesian() and
+                                     (is_box or not space.isPeriodic());
+
+            Vector origin(0);
+            Vector extent(0);
+
+            if (is_box)
+            {
+                extent = space.asA<PeriodicBox>().dimensions();
+            }
+            else
+            {
+                Vector mincoords( std::numeric_limits<double>::max() );
+                Vector maxcoords( -std::numeric_limits<double>::max() );
+
+                for (int i=0; i<nclusters; ++i)
+                {
+                    mincoords.setMin(centers.at(clusters.at(i)));
+                    maxcoords.setMax(centers.at(clusters.at(i)));
+                }
+
+                origin = mincoords;
+                extent = maxcoords - mincoords;
+            }
+
+            //choose the number of cells along each dimension, making the
+            //cells larger for sparse systems so that the number of cells
+            //stays proportional to the number of clusters
+            double length = min_length;
+
+            while (true)
+            {
+                if (is_box)
+                {
+                    nx = qMax(1, int(extent.x() / length));
+                    ny = qMax(1, int(extent.y() / length));
+                    nz = qMax(1, int(extent.z() / length));
+                }
+                else
+                {
+                    nx = int(extent.x() / length) + 1;
+                    ny = int(extent.y() / length) + 1;
+                    nz = int(extent.z() / length) + 1;
+                }
+
+                if (qint64(nx)*qint64(ny)*qint64(nz) <= 8*qint64(nclusters) + 27)
+                    break;
+
+                length *= 1.5;
+            }
+
+            const Vector cell_size = is_box ? Vector(extent.x()/nx, extent.y()/ny,
+                                                     extent.z()/nz)
+                                            : Vector(length);
+
+            //find the cell of each cluster
+            const int ncells = nx*ny*nz;
+            cell_of = QVector<qint32>(centers.count(), -1);
+            cell_start = QVector<qint32>(ncells+1, 0);
+
+            for (int i=0; i<nclusters; ++i)
+            {
+                const int idx = clusters.at(i);
+                Vector c = centers.at(idx) - origin;
+
+                if (is_box)
+                {
+                    //wrap the center back into the box
+                    c = Vector( c.x() - extent.x() * std::floor(c.x() / extent.x()),
+                                c.y() - extent.y() * std::floor(c.y() / extent.y()),
+                                c.z() - extent.z() * std::floor(c.z() / extent.z()) );
+                }
+
+                const int ix = qBound(0, int(c.x() / cell_size.x()), nx-1);
+                const int iy = qBound(0, int(c.y() / cell_size.y()), ny-1);
+                const int iz = qBound(0, int(c.z() / cell_size.z()), nz-1);
+
+                const int cell = cellIndex(ix,iy,iz);
+                cell_of[idx] = cell;
+                cell_start[cell+1] += 1;
+            }
+
+            //now sort the clusters into the cells
+            for (int i=0; i<ncells; ++i)
+            {
+                cell_start[i+1] += cell_start[i];
+            }
+
+            cell_members = QVector<qint32>(nclusters);
+            QVector<qint32> cell_count(ncells, 0);
+
+            for (int i=0; i<nclusters; ++i)
+            {
+                const int idx = clusters.at(i);
+                const int cell = cell_of.at(idx);
+
+                cell_members[ cell_start.at(cell) + cell_count.at(cell) ] = idx;
+                cell_count[cell] += 1;
+            }
+
+            //finally find the neighbours of each occupied cell
+            cell_nbrs = QVector< QVector<qint32> >(ncells);
+
+            QVector<qint32> occupied;
+
+            for (int i=0; i<ncells; ++i)
+            {
+                if (cell_start.at(i+1) > cell_start.at(i))
+                    occupied.append(i);
+            }
+
+            if (use_stencil)
+            {
+                foreach (qint32 cell, occupied)
+                {
+                    const int ix = cell / (ny*nz);
+                    const int iy = (cell / nz) % ny;
+                    const int iz = cell % nz;
+
+                    QVector<qint32> &nbrs = cell_nbrs[cell];
+
+                    for (int dx=-1; dx<=1; ++dx)
+                    {
+                        int jx = ix + dx;
+
+                        if (is_box)
+                            jx = (jx + nx) % nx;
+                        else if (jx < 0 or jx >= nx)
+                            continue;
+
+                        for (int dy=-1; dy<=1; ++dy)
+                        {
+                            int jy = iy + dy;
+
+                            if (is_box)
+                                jy = (jy + ny) % ny;
+                            else if (jy < 0 or jy >= ny)
+                                continue;
+
+                            for (int dz=-1; dz<=1; ++dz)
+                            {
+                                int jz = iz + dz;
+
+                                if (is_box)
+                                    jz = (jz + nz) % nz;
+                                else if (jz < 0 or jz >= nz)
+                                    continue;
+
+                                const int nbr = cellIndex(jx,jy,jz);
+
+                                //small periodic grids wrap onto the same cell
+                                if (cell_start.at(nbr+1) > cell_start.at(nbr) and
+                                    not nbrs.contains(nbr))
+                                {
+                                    nbrs.append(nbr);
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+            else
+            {
+                //use the space to get the distances between the occupied cells
+                QVector<AABox> boxes(occupied.count());
+
+                for (int i=0; i<occupied.count(); ++i)
+                {
+                    const int cell = occupied.at(i);
+                    QVector<Vector> coords;
+
+                    for (int j=cell_start.at(cell); j<cell_start.at(cell+1); ++j)
+                    {
+                        coords.append( centers.at(cell_members.at(j)) );
+                    }
+
+                    boxes[i] = AABox(coords);
+                }
+
+                for (int i=0; i<occupied.count(); ++i)
+                {
+                    cell_nbrs[occupied.at(i)].append(occupied.at(i));
+
+                    for (int j=i+1; j<occupied.count(); ++j)
+                    {
+                        if (space.minimumDistance(boxes.at(i), boxes.at(j)) < min_length)
+                        {
+                            cell_nbrs[occupied.at(i)].append(occupied.at(j));
+                            cell_nbrs[occupied.at(j)].append(occupied.at(i));
+                        }
+                    }
+                }
+            }
+        }
+
+        /** This is a private helper class used to find the neighbours
+            of each cluster in parallel using Intel TBB */
+        class CLJNeighbourSearch
+        {
+        public:
+            CLJNeighbourSearch(const Space &space, const CLJClusterCells &cells,
+                               const QVector<Vector> &centers, const QVector<float> &radii,
+                               const QVector<qint32> &clusters,
+                               float cutoff, QVector< QVector<qint32> > &neighbours)
+                 : spce(space), cls(cells), cents(centers), rads(radii), clstrs(clusters),
+                   cut(cutoff), nbrs(neighbours)
+            {}
+
+            void operator()(const tbb::blocked_range<int> &range) const
+            {
+                const Vector *c = cents.constData();
+                const float *r = rads.constData();
+
+                for (int ii=range.begin(); ii != range.end(); ++ii)
+                {
+                    const int i = clstrs.constData()[ii];
+
+                    QVector<qint32> &nbrs_i = nbrs[i];
+
+                    foreach (qint32 cell, cls.neighbours(cls.cellOf(i)))
+                    {
+                        int n;
+                        const qint32 *js = cls.clusters(cell, n);
+
+                        for (int jj=0; jj<n; ++jj)
+                        {
+                            const int j = js[jj];
+
+                            //only include each pair once
+                            if (j <= i)
+                                continue;
+
+                            if (spce.calcDist(c[i], c[j]) - r[i] - r[j] < cut)
+                                nbrs_i.append(j);
+                        }
+                    }
+
+                    //sort so that the pairs are evaluated in the same order
+                    //regardless of how the clusters were binned
+                    std::sort(nbrs_i.begin(), nbrs_i.end());
+                }
+            }
+
+        private:
+            const Space &spce;
+            const CLJClusterCells &cls;
+            const QVector<Vector> &cents;
+            const QVector<float> &rads;
+            const QVector<qint32> &clstrs;
+            const float cut;
+            QVector< QVector<qint32> > &nbrs;
+        };
+    }
+}
+
+/** Rebuild the list for the passed function and atoms */
+void CLJNeighbourList::rebuild(const CLJFunction &func, const CLJAtoms &atoms)
+{
+    const int nclusters = atoms.x().count();
+
+    const MultiFloat *x = atoms.x().constData();
+    const MultiFloat *y = atoms.y().constData();
+    const MultiFloat *z = atoms.z().constData();
+    const MultiInt *id = atoms.ID().constData();
+
+    const qint32 dummy_int = CLJAtoms::idOfDummy()[0];
+
+    //get the bounding sphere of each cluster
+    QVector<Vector> centers(nclusters);
+    QVector<float> radii(nclusters, -1);
+
+    for (int i=0; i<nclusters; ++i)
+    {
+        Vector mincoords( std::numeric_limits<double>::max() );
+        Vector maxcoords( -std::numeric_limits<double>::max() );
+        bool has_atoms = false;
+
+        for (int ii=0; ii<MultiFloat::count(); ++ii)
+        {
+            if (id[i][ii] != dummy_int)
+            {
+                const Vector coords(x[i][ii], y[i][ii], z[i][ii]);
+                mincoords.setMin(coords);
+                maxcoords.setMax(coords);
+                has_atoms = true;
+            }
+        }
+
+        if (has_atoms)
+        {
+            centers[i] = 0.5 * (mincoords + maxcoords);
+            radii[i] = 0.5 * (maxcoords - mincoords).length();
+        }
+    }
+
+    //find all pairs of clusters within the cutoff plus skin
+    const float cutoff = getCutoff(func);
+
+    QVector<qint32> clusters;
+    float max_radius = 0;
+
+    for (int i=0; i<nclusters; ++i)
+    {
+        //negative radius means that this cluster contains only dummies
+        if (radii.at(i) >= 0)
+        {
+            clusters.append(i);
+            max_radius = qMax(max_radius, radii.at(i));
+        }
+    }
+
+    QVector< QVector<qint32> > neighbours(nclusters);
+
+    if (func.hasCutoff() and not clusters.isEmpty())
+    {
+        const float search_cutoff = cutoff + skin_size;
+
+        //two clusters can only be within the search cutoff if their centers
+        //are closer than this, so this is the minimum size of the cells
+        const detail::CLJClusterCells cells(func.space(), centers, clusters,
+                                            search_cutoff + 2*max_radius);
+
+        detail::CLJNeighbourSearch search(func.space(), cells, centers, radii, clusters,
+                                          search_cutoff, neighbours);
+
+        tbb::parallel_for(tbb::blocked_range<int>(0,clusters.count()), search);
+    }
+    else
+    {
+        //all pairs of clusters interact
+        for (int i=0; i<clusters.count(); ++i)
+        {
+            neighbours[clusters.at(i)] = clusters.mid(i+1);
+        }
+    }
+
+    //now compress this into a single array
+    neighbour_start = QVector<qint32>(nclusters+1, 0);
+    int npairs = 0;
+
+    for (int i=0; i<nclusters; ++i)
+    {
+        neighbour_start[i] = npairs;
+        npairs += neighbours.at(i).count();
+    }
+
+    neighbour_start[nclusters] = npairs;
+
+    neighbour_clusters = QVector<qint32>(npairs);
+    qint32 *nc = neighbour_clusters.data();
+
+    for (int i=0; i<nclusters; ++i)
+    {
+        const QVector<qint32> &nbrs = neighbours.at(i);
+
+        for (int j=0; j<nbrs.count(); ++j)
+        {
+            *nc = nbrs.at(j);
+            ++nc;
+        }
+    }
+
+    //save the reference coordinates
+    ref_x = atoms.x();
+    ref_y = atoms.y();
+    ref_z = atoms.z();
+    built_cutoff = cutoff;
+    built_space = func.space();
+
+    nrebuilds += 1;
+}
+
+/** Update the list for the passed function and atoms, rebuilding it
+    only if needed. This returns whether or not the list was rebuilt */
+bool CLJNeighbourList::update(const CLJFunction &func, const CLJAtoms &atoms)
+{
+    if (this->needsRebuild(func, atoms))
+    {
+        this->rebuild(func, atoms);
+        return true;
+    }
+    else
+        return false;
+}
+
+/** Copy the atoms in the ith cluster of 'atoms' into 'cluster'. This reuses
+    the memory already allocated in 'cluster', so should be used with the
+    same scratch 'cluster' for each cluster in turn
+
+    \throw SireError::invalid_index
+*/
+void CLJNeighbourList::getCluster(const CLJAtoms &atoms, int i, CLJAtoms &cluster) const
+{
+    if (i < 0 or i >= atoms.x().count())
+        throw SireError::invalid_index( QObject::tr(
+                "Invalid cluster index %1. Number of clusters is %2.")
+                    .arg(i).arg(atoms.x().count()), CODELOC );
+
+    const qint32 idx = i;
+    this->gather(atoms, &idx, 1, cluster);
+}
+
+/** Copy all of the atoms in the neighbouring clusters of the ith cluster
+    of 'atoms' into 'neighbours'. Only the neighbours with a higher cluster
+    index than 'i' are copied, so that each pair of clusters is only seen
+    once. This reuses the memory already allocated in 'neighbours', so
+    should be used with the same scratch 'neighbours' for each cluster in turn
+
+    \throw SireError::invalid_index
+*/
+void CLJNeighbourList::getNeighbours(const CLJAtoms &atoms, int i,
+                                     CLJAtoms &neighbours) const
+{
+    if (i < 0 or i >= this->nClusters())
+        throw SireError::invalid_index( QObject::tr(
+                "Invalid cluster index %1. Number of clusters is %2.")
+                    .arg(i).arg(this->nClusters()), CODELOC );
+
+    const int start = neighbour_start.constData()[i];
+    const int n = neighbour_start.constData()[i+1] - start;
+
+    this->gather(atoms, neighbour_clusters.constData() + start, n, neighbours);
+}
+
+/** Internal function used to copy the 'n' clusters of 'atoms' whose indicies
+    are in 'idxs' into 'ret', reusing the memory already allocated in 'ret' */
+void CLJNeighbourList::gather(const CLJAtoms &atoms, const qint32 *idxs, int n,
+                              CLJAtoms &ret) const
+{
+    ret._x.resize(n);
+    ret._y.resize(n);
+    ret._z.resize(n);
+    ret._q.resize(n);
+    ret._sig.resize(n);
+    ret._eps.resize(n);
+    ret._id.resize(n);
+
+    if (n == 0)
+        return;
+
+    MultiFloat *x = ret._x.data();
+    MultiFloat *y = ret._y.data();
+    MultiFloat *z = ret._z.data();
+    MultiFloat *q = ret._q.data();
+    MultiFloat *sig = ret._sig.data();
+    MultiFloat *eps = ret._eps.data();
+    MultiInt *id = ret._id.data();
+
+    const MultiFloat *x0 = atoms._x.constData();
+    const MultiFloat *y0 = atoms._y.constData();
+    const MultiFloat *z0 = atoms._z.constData();
+    const MultiFloat *q0 = atoms._q.constData();
+    const MultiFloat *sig0 = atoms._sig.constData();
+    const MultiFloat *eps0 = atoms._eps.constData();
+    const MultiInt *id0 = atoms._id.constData();
+
+    for (int j=0; j<n; ++j)
+    {
+        const int idx = idxs[j];
+
+        x[j] = x0[idx];
+        y[j] = y0[idx];
+        z[j] = z0[idx];
+        q[j] = q0[idx];
+        sig[j] = sig0[idx];
+        eps[j] = eps0[idx];
+        id[j] = id0[idx];
+    }
+}
+
+/** Return the atoms in the ith cluster of 'atoms'
+
+    \throw SireError::invalid_index
+*/
+CLJAtoms CLJNeighbourList::cluster(const CLJAtoms &atoms, int i) const
+{
+    CLJAtoms ret;
+    this->getCluster(atoms, i, ret);
+    return ret;
+}
+
+/** Return all of the atoms in the neighbouring clusters of the ith
+    cluster of 'atoms', gathered together into a single CLJAtoms.
+    Only the neighbours with a higher cluster index than 'i' are
+    returned, so that each pair of clusters is only seen once
+
+    \throw SireError::invalid_index
+*/
+CLJAtoms CLJNeighbourList::neighbours(const CLJAtoms &atoms, int i) const
+{
+    CLJAtoms ret;
+    this->getNeighbours(atoms, i, ret);
+    return ret;
+}
@@ -0,0 +1,154 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#ifndef SIREMM_CLJNEIGHBOURLIST_H
+#define SIREMM_CLJNEIGHBOURLIST_H
+
+#include "cljfunction.h"
+
+SIRE_BEGIN_HEADER
+
+namespace SireMM
+{
+class CLJNeighbourList;
+}
+
+QDataStream& operator<<(QDataStream&, const SireMM::CLJNeighbourList&);
+QDataStream& operator>>(QDataStream&, SireMM::CLJNeighbourList&);
+
+namespace SireMM
+{
+
+/** This class holds a Verlet cluster-pair neighbour list for a set
+    of CLJAtoms. Each cluster is one MultiFloat vector of atoms
+    (i.e. MultiFloat::count() atoms), so that a cluster pair maps
+    directly onto the vectorised CLJ kernels.
+
+    The list contains every pair of clusters whose bounding spheres
+    are closer than the cutoff of the CLJFunction plus a "skin". The
+    list only needs to be rebuilt when an atom has moved by more than
+    half of the skin since the list was built, so for MD-like workloads
+    the pair search is only performed every few steps, and far fewer
+    out-of-cutoff pairs are evaluated than when looping over all
+    atoms in neighbouring CLJBoxes.
+
+    The pairs of clusters are found by binning the clusters into
+    cells that are at least as wide as the cutoff plus skin (plus the
+    diameter of the largest cluster), so that only clusters in
+    neighbouring cells are compared.
+
+    The list relies on the atoms being in the same order each time
+    (as is the case for CLJGroup::atoms). Use it via
+    CLJCalculator::calculate, or switch on InterFF::setUseNeighbourList.
+
+    @author Christopher Woods
+*/
+class SIREMM_EXPORT CLJNeighbourList
+{
+
+friend QDataStream& ::operator<<(QDataStream&, const CLJNeighbourList&);
+friend QDataStream& ::operator>>(QDataStream&, CLJNeighbourList&);
+
+public:
+    CLJNeighbourList();
+    CLJNeighbourList(Length skin);
+
+    CLJNeighbourList(const CLJNeighbourList &other);
+
+    ~CLJNeighbourList();
+
+    CLJNeighbourList& operator=(const CLJNeighbourList &other);
+
+    bool operator==(const CLJNeighbourList &other) const;
+    bool operator!=(const CLJNeighbourList &other) const;
+
+    static const char* typeName();
+    const char* what() const;
+
+    QString toString() const;
+
+    bool isEmpty() const;
+
+    Length skin() const;
+    void setSkin(Length skin);
+
+    int nClusters() const;
+    int nClusterPairs() const;
+    int nRebuilds() const;
+
+    bool needsRebuild(const CLJFunction &func, const CLJAtoms &atoms) const;
+
+    void rebuild(const CLJFunction &func, const CLJAtoms &atoms);
+
+    bool update(const CLJFunction &func, const CLJAtoms &atoms);
+
+    void clear();
+
+    CLJAtoms cluster(const CLJAtoms &atoms, int i) const;
+    CLJAtoms neighbours(const CLJAtoms &atoms, int i) const;
+
+    void getCluster(const CLJAtoms &atoms, int i, CLJAtoms &cluster) const;
+    void getNeighbours(const CLJAtoms &atoms, int i, CLJAtoms &neighbours) const;
+
+private:
+    void gather(const CLJAtoms &atoms, const qint32 *idxs, int n, CLJAtoms &ret) const;
+
+    /** The size of the skin added onto the cutoff */
+    float skin_size;
+
+    /** The cutoff (excluding the skin) used when the list was built */
+    float built_cutoff;
+
+    /** The space used when the list was built */
+    SireVol::SpacePtr built_space;
+
+    /** The coordinates of the atoms when the list was built */
+    QVector<MultiFloat> ref_x, ref_y, ref_z;
+
+    /** The index into 'neighbour_clusters' of the first neighbour
+        of each cluster (with one extra value giving the total) */
+    QVector<qint32> neighbour_start;
+
+    /** The indicies of the neighbouring clusters of each cluster.
+        Only clusters with a higher index than the cluster itself
+        are included, so that each pair is evaluated only once */
+    QVector<qint32> neighbour_clusters;
+
+    /** The number of times this list has been rebuilt */
+    qint32 nrebuilds;
+};
+
+}
+
+Q_DECLARE_METATYPE( SireMM::CLJNeighbourList )
+
+SIRE_EXPOSE_CLASS( SireMM::CLJNeighbourList )
+
+SIRE_END_HEADER
+
+#endif
@@ -27,6 +27,7 @@
 \*********************************************/
 
 #include "cljrffunction.h"
+#include "cljkernels.h"
 
 #include "SireMaths/multifloat.h"
 #include "SireMaths/multidouble.h"
@@ -53,6 +54,18 @@ using namespace SireBase;
 using namespace SireUnits;
 using namespace SireStream;
 
+/** Return the reaction field constant k_rf for the passed cutoff and dielectric */
+static inline float rfK(float coul_cutoff, float dielectric)
+{
+    return (1.0 / pow_3(coul_cutoff)) * ( (dielectric-1) / (2*dielectric + 1) );
+}
+
+/** Return the reaction field constant c_rf for the passed cutoff and dielectric */
+static inline float rfC(float coul_cutoff, float dielectric)
+{
+    return (1.0 / coul_cutoff) * ( (3*dielectric) / (2*dielectric + 1) );
+}
+
 const float default_dielectric = 1.0;
 
 /////////
@@ -264,6 +277,15 @@ float CLJRFFunction::dielectric() const
 void CLJRFFunction::calcVacEnergyGeo(const CLJAtoms &atoms,
                                      double &cnrg, double &ljnrg) const
 {
+    //use the runtime-dispatched kernel if one has been selected
+    //via CLJKernels::setInstructionSet
+    if (CLJKernels::calcEnergy(atoms,
+                               0, rfK(coul_cutoff, dielectric()), rfC(coul_cutoff, dielectric()),
+                               coul_cutoff, lj_cutoff, false, cnrg, ljnrg))
+    {
+        return;
+    }
+
     const MultiFloat *xa = atoms.x().constData();
     const MultiFloat *ya = atoms.y().constData();
     const MultiFloat *za = atoms.z().constData();
@@ -459,6 +481,15 @@ void CLJRFFunction::calcVacEnergyGeo(const CLJAtoms &atoms,
 void CLJRFFunction::calcVacEnergyGeo(const CLJAtoms &atoms0, const CLJAtoms &atoms1,
                                      double &cnrg, double &ljnrg, float min_distance) const
 {
+    //use the runtime-dispatched kernel if one has been selected
+    //via CLJKernels::setInstructionSet
+    if (CLJKernels::calcEnergy(atoms0, atoms1,
+                               0, rfK(coul_cutoff, dielectric()), rfC(coul_cutoff, dielectric()),
+                               coul_cutoff, lj_cutoff, false, cnrg, ljnrg))
+    {
+        return;
+    }
+
     const MultiFloat *x0 = atoms0.x().constData();
     const MultiFloat *y0 = atoms0.y().constData();
     const MultiFloat *z0 = atoms0.z().constData();
@@ -661,6 +692,15 @@ void CLJRFFunction::calcVacEnergyGeo(const CLJAtoms &atoms0, const CLJAtoms &ato
 void CLJRFFunction::calcBoxEnergyGeo(const CLJAtoms &atoms, const Vector &box_dimensions,
                                      double &cnrg, double &ljnrg) const
 {
+    //use the runtime-dispatched kernel if one has been selected
+    //via CLJKernels::setInstructionSet
+    if (CLJKernels::calcBoxEnergy(atoms, box_dimensions,
+                                  0, rfK(coul_cutoff, dielectric()), rfC(coul_cutoff, dielectric()),
+                                  coul_cutoff, lj_cutoff, false, cnrg, ljnrg))
+    {
+        return;
+    }
+
     const MultiFloat *xa = atoms.x().constData();
     const MultiFloat *ya = atoms.y().constData();
     const MultiFloat *za = atoms.z().constData();
@@ -785,6 +825,15 @@ void CLJRFFunction::calcBoxEnergyGeo(const CLJAtoms &atoms0, const CLJAtoms &ato
                                      const Vector &box_dimensions,
                                      double &cnrg, double &ljnrg, float min_distance) const
 {
+    //use the runtime-dispatched kernel if one has been selected
+    //via CLJKernels::setInstructionSet
+    if (CLJKernels::calcBoxEnergy(atoms0, atoms1, box_dimensions,
+                                  0, rfK(coul_cutoff, dielectric()), rfC(coul_cutoff, dielectric()),
+                                  coul_cutoff, lj_cutoff, false, cnrg, ljnrg))
+    {
+        return;
+    }
+
     const MultiFloat *x0 = atoms0.x().constData();
     const MultiFloat *y0 = atoms0.y().constData();
     const MultiFloat *z0 = atoms0.z().constData();
@@ -916,6 +965,15 @@ void CLJRFFunction::calcBoxEnergyGeo(const CLJAtoms &atoms0, const CLJAtoms &ato
 void CLJRFFunction::calcVacEnergyAri(const CLJAtoms &atoms,
                                      double &cnrg, double &ljnrg) const
 {
+    //use the runtime-dispatched kernel if one has been selected
+    //via CLJKernels::setInstructionSet
+    if (CLJKernels::calcEnergy(atoms,
+                               0, rfK(coul_cutoff, dielectric()), rfC(coul_cutoff, dielectric()),
+                               coul_cutoff, lj_cutoff, true, cnrg, ljnrg))
+    {
+        return;
+    }
+
     const MultiFloat *xa = atoms.x().constData();
     const MultiFloat *ya = atoms.y().constData();
     const MultiFloat *za = atoms.z().constData();
@@ -1117,6 +1175,15 @@ void CLJRFFunction::calcVacEnergyAri(const CLJAtoms &atoms,
 void CLJRFFunction::calcVacEnergyAri(const CLJAtoms &atoms0, const CLJAtoms &atoms1,
                                      double &cnrg, double &ljnrg, float min_distance) const
 {
+    //use the runtime-dispatched kernel if one has been selected
+    //via CLJKernels::setInstructionSet
+    if (CLJKernels::calcEnergy(atoms0, atoms1,
+                               0, rfK(coul_cutoff, dielectric()), rfC(coul_cutoff, dielectric()),
+                               coul_cutoff, lj_cutoff, true, cnrg, ljnrg))
+    {
+        return;
+    }
+
     const MultiFloat *x0 = atoms0.x().constData();
     const MultiFloat *y0 = atoms0.y().constData();
     const MultiFloat *z0 = atoms0.z().constData();
@@ -1661,6 +1728,15 @@ double CLJRFFunction::calcVacLJEnergyAri(const CLJAtoms &atoms0, const CLJAtoms
 void CLJRFFunction::calcBoxEnergyAri(const CLJAtoms &atoms, const Vector &box_dimensions,
                                      double &cnrg, double &ljnrg) const
 {
+    //use the runtime-dispatched kernel if one has been selected
+    //via CLJKernels::setInstructionSet
+    if (CLJKernels::calcBoxEnergy(atoms, box_dimensions,
+                                  0, rfK(coul_cutoff, dielectric()), rfC(coul_cutoff, dielectric()),
+                                  coul_cutoff, lj_cutoff, true, cnrg, ljnrg))
+    {
+        return;
+    }
+
     const MultiFloat *xa = atoms.x().constData();
     const MultiFloat *ya = atoms.y().constData();
     const MultiFloat *za = atoms.z().constData();
@@ -1788,6 +1864,15 @@ void CLJRFFunction::calcBoxEnergyAri(const CLJAtoms &atoms0, const CLJAtoms &ato
                                      const Vector &box_dimensions,
                                      double &cnrg, double &ljnrg, float min_distance) const
 {
+    //use the runtime-dispatched kernel if one has been selected
+    //via CLJKernels::setInstructionSet
+    if (CLJKernels::calcBoxEnergy(atoms0, atoms1, box_dimensions,
+                                  0, rfK(coul_cutoff, dielectric()), rfC(coul_cutoff, dielectric()),
+                                  coul_cutoff, lj_cutoff, true, cnrg, ljnrg))
+    {
+        return;
+    }
+
     const MultiFloat *x0 = atoms0.x().constData();
     const MultiFloat *y0 = atoms0.y().constData();
     const MultiFloat *z0 = atoms0.z().constData();
@@ -1923,6 +2008,31 @@ bool CLJRFFunction::supportsGridCalculation() const
     return true;
 }
 
+/** This function does support the calculation of forces */
+bool CLJRFFunction::supportsForceCalculation() const
+{
+    return true;
+}
+
+/** Calculate the forces between all of the atoms in 'atoms', adding them
+    onto 'forces'. The reaction field coulomb energy is
+    q0q1 * { 1/r + k_rf r^2 - c_rf }, so the force is
+    q0q1 * { 1/r^2 - 2 k_rf r } */
+void CLJRFFunction::calcForce(const CLJAtoms &atoms, CLJForces &forces) const
+{
+    this->calcGeneralForce(atoms, 0, rfK(coul_cutoff, dielectric()),
+                           coul_cutoff, lj_cutoff, forces);
+}
+
+/** Calculate the forces between the atoms in 'atoms0' and 'atoms1', adding
+    them onto 'forces0' and (if it is not null) 'forces1' */
+void CLJRFFunction::calcForce(const CLJAtoms &atoms0, const CLJAtoms &atoms1,
+                              CLJForces &forces0, CLJForces *forces1) const
+{
+    this->calcGeneralForce(atoms0, atoms1, 0, rfK(coul_cutoff, dielectric()),
+                           coul_cutoff, lj_cutoff, forces0, forces1);
+}
+
 /** Calculate the energy on the grid from the passed atoms using vacuum boundary conditions */
 void CLJRFFunction::calcVacGrid(const CLJAtoms &atoms, const GridInfo &grid_info,
                                 const int start, const int end, float *gridpot_array) const
@@ -2264,6 +2374,22 @@ float CLJSoftRFFunction::dielectric() const
     return diel;
 }
 
+/** Return the parameters of the soft-core reaction field coulomb energy in
+    the general form used to fuse soft-core calculations */
+bool CLJSoftRFFunction::softCoulombParameters(float &coul_a, float &coul_b,
+                                              float &coul_c) const
+{
+    const float soft_coul_cutoff = std::sqrt(alpha() + coul_cutoff*coul_cutoff);
+
+    coul_a = 0;
+    coul_b = (1.0 / pow_3(soft_coul_cutoff)) * ( (dielectric()-1) /
+                                                 (2*dielectric() + 1) );
+    coul_c = (1.0 / soft_coul_cutoff ) * ( (3*dielectric()) /
+                                           (2*dielectric() + 1) );
+
+    return true;
+}
+
 QString CLJSoftRFFunction::toString() const
 {
     if (this->hasCutoff())
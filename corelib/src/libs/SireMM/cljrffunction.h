@@ -109,10 +109,15 @@ public:
     float dielectric() const;
 
     bool supportsGridCalculation() const;
+    bool supportsForceCalculation() const;
 
     static CLJFunctionPtr defaultRFFunction();
 
 protected:
+    void calcForce(const CLJAtoms &atoms, CLJForces &forces) const;
+    void calcForce(const CLJAtoms &atoms0, const CLJAtoms &atoms1,
+                   CLJForces &forces0, CLJForces *forces1) const;
+
     void calcVacEnergyAri(const CLJAtoms &atoms,
                           double &cnrg, double &ljnrg) const;
     
@@ -300,6 +305,8 @@ public:
     static CLJFunctionPtr defaultRFFunction();
 
 protected:
+    bool softCoulombParameters(float &coul_a, float &coul_b, float &coul_c) const;
+
     void calcVacEnergyAri(const CLJAtoms &atoms,
                           double &cnrg, double &ljnrg) const;
     
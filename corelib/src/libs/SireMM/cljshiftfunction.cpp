@@ -27,6 +27,7 @@
 \*********************************************/
 
 #include "cljshiftfunction.h"
+#include "cljkernels.h"
 
 #include "SireMaths/multifloat.h"
 #include "SireMaths/multidouble.h"
@@ -194,6 +195,15 @@ QString CLJShiftFunction::toString() const
 void CLJShiftFunction::calcVacEnergyGeo(const CLJAtoms &atoms,
                                         double &cnrg, double &ljnrg) const
 {
+    //use the runtime-dispatched kernel if one has been selected
+    //via CLJKernels::setInstructionSet
+    if (CLJKernels::calcEnergy(atoms,
+                               1.0 / (coul_cutoff*coul_cutoff), 0, 2.0 / coul_cutoff,
+                               coul_cutoff, lj_cutoff, false, cnrg, ljnrg))
+    {
+        return;
+    }
+
     const MultiFloat *xa = atoms.x().constData();
     const MultiFloat *ya = atoms.y().constData();
     const MultiFloat *za = atoms.z().constData();
@@ -388,6 +398,15 @@ void CLJShiftFunction::calcVacEnergyGeo(const CLJAtoms &atoms,
 void CLJShiftFunction::calcVacEnergyGeo(const CLJAtoms &atoms0, const CLJAtoms &atoms1,
                                         double &cnrg, double &ljnrg, float min_distance) const
 {
+    //use the runtime-dispatched kernel if one has been selected
+    //via CLJKernels::setInstructionSet
+    if (CLJKernels::calcEnergy(atoms0, atoms1,
+                               1.0 / (coul_cutoff*coul_cutoff), 0, 2.0 / coul_cutoff,
+                               coul_cutoff, lj_cutoff, false, cnrg, ljnrg))
+    {
+        return;
+    }
+
     const MultiFloat *x0 = atoms0.x().constData();
     const MultiFloat *y0 = atoms0.y().constData();
     const MultiFloat *z0 = atoms0.z().constData();
@@ -588,6 +607,15 @@ void CLJShiftFunction::calcVacEnergyGeo(const CLJAtoms &atoms0, const CLJAtoms &
 void CLJShiftFunction::calcBoxEnergyGeo(const CLJAtoms &atoms, const Vector &box_dimensions,
                                         double &cnrg, double &ljnrg) const
 {
+    //use the runtime-dispatched kernel if one has been selected
+    //via CLJKernels::setInstructionSet
+    if (CLJKernels::calcBoxEnergy(atoms, box_dimensions,
+                                  1.0 / (coul_cutoff*coul_cutoff), 0, 2.0 / coul_cutoff,
+                                  coul_cutoff, lj_cutoff, false, cnrg, ljnrg))
+    {
+        return;
+    }
+
     const MultiFloat *xa = atoms.x().constData();
     const MultiFloat *ya = atoms.y().constData();
     const MultiFloat *za = atoms.z().constData();
@@ -710,6 +738,15 @@ void CLJShiftFunction::calcBoxEnergyGeo(const CLJAtoms &atoms0, const CLJAtoms &
                                         const Vector &box_dimensions,
                                         double &cnrg, double &ljnrg, float min_distance) const
 {
+    //use the runtime-dispatched kernel if one has been selected
+    //via CLJKernels::setInstructionSet
+    if (CLJKernels::calcBoxEnergy(atoms0, atoms1, box_dimensions,
+                                  1.0 / (coul_cutoff*coul_cutoff), 0, 2.0 / coul_cutoff,
+                                  coul_cutoff, lj_cutoff, false, cnrg, ljnrg))
+    {
+        return;
+    }
+
     const MultiFloat *x0 = atoms0.x().constData();
     const MultiFloat *y0 = atoms0.y().constData();
     const MultiFloat *z0 = atoms0.z().constData();
@@ -838,6 +875,15 @@ void CLJShiftFunction::calcBoxEnergyGeo(const CLJAtoms &atoms0, const CLJAtoms &
 void CLJShiftFunction::calcVacEnergyAri(const CLJAtoms &atoms,
                                         double &cnrg, double &ljnrg) const
 {
+    //use the runtime-dispatched kernel if one has been selected
+    //via CLJKernels::setInstructionSet
+    if (CLJKernels::calcEnergy(atoms,
+                               1.0 / (coul_cutoff*coul_cutoff), 0, 2.0 / coul_cutoff,
+                               coul_cutoff, lj_cutoff, true, cnrg, ljnrg))
+    {
+        return;
+    }
+
     const MultiFloat *xa = atoms.x().constData();
     const MultiFloat *ya = atoms.y().constData();
     const MultiFloat *za = atoms.z().constData();
@@ -1038,6 +1084,15 @@ void CLJShiftFunction::calcVacEnergyAri(const CLJAtoms &atoms,
 void CLJShiftFunction::calcVacEnergyAri(const CLJAtoms &atoms0, const CLJAtoms &atoms1,
                                         double &cnrg, double &ljnrg, float min_distance) const
 {
+    //use the runtime-dispatched kernel if one has been selected
+    //via CLJKernels::setInstructionSet
+    if (CLJKernels::calcEnergy(atoms0, atoms1,
+                               1.0 / (coul_cutoff*coul_cutoff), 0, 2.0 / coul_cutoff,
+                               coul_cutoff, lj_cutoff, true, cnrg, ljnrg))
+    {
+        return;
+    }
+
     const MultiFloat *x0 = atoms0.x().constData();
     const MultiFloat *y0 = atoms0.y().constData();
     const MultiFloat *z0 = atoms0.z().constData();
@@ -1575,6 +1630,15 @@ double CLJShiftFunction::calcVacLJEnergyAri(const CLJAtoms &atoms0, const CLJAto
 void CLJShiftFunction::calcBoxEnergyAri(const CLJAtoms &atoms, const Vector &box_dimensions,
                                         double &cnrg, double &ljnrg) const
 {
+    //use the runtime-dispatched kernel if one has been selected
+    //via CLJKernels::setInstructionSet
+    if (CLJKernels::calcBoxEnergy(atoms, box_dimensions,
+                                  1.0 / (coul_cutoff*coul_cutoff), 0, 2.0 / coul_cutoff,
+                                  coul_cutoff, lj_cutoff, true, cnrg, ljnrg))
+    {
+        return;
+    }
+
     const MultiFloat *xa = atoms.x().constData();
     const MultiFloat *ya = atoms.y().constData();
     const MultiFloat *za = atoms.z().constData();
@@ -1700,6 +1764,15 @@ void CLJShiftFunction::calcBoxEnergyAri(const CLJAtoms &atoms0, const CLJAtoms &
                                         const Vector &box_dimensions,
                                         double &cnrg, double &ljnrg, float min_distance) const
 {
+    //use the runtime-dispatched kernel if one has been selected
+    //via CLJKernels::setInstructionSet
+    if (CLJKernels::calcBoxEnergy(atoms0, atoms1, box_dimensions,
+                                  1.0 / (coul_cutoff*coul_cutoff), 0, 2.0 / coul_cutoff,
+                                  coul_cutoff, lj_cutoff, true, cnrg, ljnrg))
+    {
+        return;
+    }
+
     const MultiFloat *x0 = atoms0.x().constData();
     const MultiFloat *y0 = atoms0.y().constData();
     const MultiFloat *z0 = atoms0.z().constData();
@@ -1832,6 +1905,31 @@ bool CLJShiftFunction::supportsGridCalculation() const
     return true;
 }
 
+/** This function does support the calculation of forces */
+bool CLJShiftFunction::supportsForceCalculation() const
+{
+    return true;
+}
+
+/** Calculate the forces between all of the atoms in 'atoms', adding them
+    onto 'forces'. The shifted coulomb energy is
+    q0q1 * { 1/r - 1/Rc + 1/Rc^2 [r - Rc] }, so the force is
+    q0q1 * { 1/r^2 - 1/Rc^2 } */
+void CLJShiftFunction::calcForce(const CLJAtoms &atoms, CLJForces &forces) const
+{
+    this->calcGeneralForce(atoms, 1.0 / (coul_cutoff*coul_cutoff), 0,
+                           coul_cutoff, lj_cutoff, forces);
+}
+
+/** Calculate the forces between the atoms in 'atoms0' and 'atoms1', adding
+    them onto 'forces0' and (if it is not null) 'forces1' */
+void CLJShiftFunction::calcForce(const CLJAtoms &atoms0, const CLJAtoms &atoms1,
+                                 CLJForces &forces0, CLJForces *forces1) const
+{
+    this->calcGeneralForce(atoms0, atoms1, 1.0 / (coul_cutoff*coul_cutoff), 0,
+                           coul_cutoff, lj_cutoff, forces0, forces1);
+}
+
 /** Calculate the energy on the grid from the passed atoms using vacuum boundary conditions */
 void CLJShiftFunction::calcVacGrid(const CLJAtoms &atoms, const GridInfo &grid_info,
                                    const int start, const int end, float *gridpot_array) const
@@ -2102,6 +2200,21 @@ CLJSoftShiftFunction* CLJSoftShiftFunction::clone() const
     return new CLJSoftShiftFunction(*this);
 }
 
+/** Return the parameters of the soft-core shifted coulomb energy in the
+    general form used to fuse soft-core calculations */
+bool CLJSoftShiftFunction::softCoulombParameters(float &coul_a, float &coul_b,
+                                                 float &coul_c) const
+{
+    // 1/r - 1/Rc + 1/Rc^2 [r - Rc] == 1/r + r/Rc^2 - 2/Rc
+    const float soft_coul_cutoff = std::sqrt(alpha() + coul_cutoff*coul_cutoff);
+
+    coul_a = 1.0 / (soft_coul_cutoff*soft_coul_cutoff);
+    coul_b = 0;
+    coul_c = 2.0 / soft_coul_cutoff;
+
+    return true;
+}
+
 QString CLJSoftShiftFunction::toString() const
 {
     if (this->hasCutoff())
@@ -107,10 +107,15 @@ public:
     CLJShiftFunction* clone() const;
 
     bool supportsGridCalculation() const;
+    bool supportsForceCalculation() const;
 
     static CLJFunctionPtr defaultShiftFunction();
 
 protected:
+    void calcForce(const CLJAtoms &atoms, CLJForces &forces) const;
+    void calcForce(const CLJAtoms &atoms0, const CLJAtoms &atoms1,
+                   CLJForces &forces0, CLJForces *forces1) const;
+
     void calcVacEnergyAri(const CLJAtoms &atoms,
                           double &cnrg, double &ljnrg) const;
     
@@ -274,6 +279,8 @@ public:
     static CLJFunctionPtr defaultShiftFunction();
 
 protected:
+    bool softCoulombParameters(float &coul_a, float &coul_b, float &coul_c) const;
+
     void calcVacEnergyAri(const CLJAtoms &atoms,
                           double &cnrg, double &ljnrg) const;
     
@@ -0,0 +1,1591 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "cljspmefunction.h"
+#include "cljboxes.h"
+
+#include "detail/spmefft.h"
+
+#include "SireMaths/multifloat.h"
+#include "SireMaths/multidouble.h"
+#include "SireMaths/multiint.h"
+#include "SireMaths/constants.h"
+
+#include "SireVol/periodicbox.h"
+
+#include "SireBase/numberproperty.h"
+#include "SireBase/lengthproperty.h"
+
+#include "SireUnits/units.h"
+
+#include "SireError/errors.h"
+
+#include "SireStream/datastream.h"
+#include "SireStream/shareddatastream.h"
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+#include <complex>
+#include <vector>
+
+#include <QVarLengthArray>
+#include <QHash>
+
+using namespace SireMM;
+using namespace SireMaths;
+using namespace SireVol;
+using namespace SireBase;
+using namespace SireUnits;
+using namespace SireStream;
+
+static const double default_ewald_precision = 1e-5;
+static const float default_grid_spacing = 1.0;
+static const qint32 default_spline_order = 5;
+
+/////////
+///////// Private helper functions used for the SPME calculation
+/////////
+
+namespace SireMM
+{
+    namespace detail
+    {
+        /** Return a vectorised approximation of erfc(x) for x >= 0, using
+            equation 7.1.26 of Abramowitz and Stegun (absolute error < 1.5e-7,
+            which is below the precision of a float) */
+        static inline MultiFloat spmeErfc(const MultiFloat &x)
+        {
+            static const MultiFloat p(0.3275911f);
+            static const MultiFloat a1(0.254829592f);
+            static const MultiFloat a2(-0.284496736f);
+            static const MultiFloat a3(1.421413741f);
+            static const MultiFloat a4(-1.453152027f);
+            static const MultiFloat a5(1.061405429f);
+            static const MultiFloat one(1.0f);
+
+            const MultiFloat t = (one + p*x).reciprocal();
+
+            MultiFloat poly = a5 * t;
+            poly += a4;
+            poly *= t;
+            poly += a3;
+            poly *= t;
+            poly += a2;
+            poly *= t;
+            poly += a1;
+            poly *= t;
+
+            return poly * SireMaths::exp( -(x*x) );
+        }
+
+        /** Calculate the real space SPME coulomb and LJ energy between the atoms
+            in 'atoms0' and 'atoms1', returning the results in 'cnrg' and 'ljnrg'.
+            If 'self' is true then 'atoms1' is the same as 'atoms0', and each pair
+            of atoms is only evaluated once. USE_BOX selects the orthorhombic
+            minimum image convention for a box of size 'box_dimensions', while
+            USE_ARITHMETIC selects arithmetic rather than geometric combining rules */
+        template<bool USE_BOX, bool USE_ARITHMETIC>
+        static void spmeRealSpaceEnergy(const CLJAtoms &atoms0, const CLJAtoms &atoms1,
+                                        bool self, const Vector &box_dimensions, double beta,
+                                        float coul_cutoff, float lj_cutoff,
+                                        double &cnrg, double &ljnrg)
+        {
+            const MultiFloat *x0 = atoms0.x().constData();
+            const MultiFloat *y0 = atoms0.y().constData();
+            const MultiFloat *z0 = atoms0.z().constData();
+            const MultiFloat *q0 = atoms0.q().constData();
+            const MultiFloat *sig0 = atoms0.sigma().constData();
+            const MultiFloat *eps0 = atoms0.epsilon().constData();
+            const MultiInt *id0 = atoms0.ID().constData();
+
+            const MultiFloat *x1 = atoms1.x().constData();
+            const MultiFloat *y1 = atoms1.y().constData();
+            const MultiFloat *z1 = atoms1.z().constData();
+            const MultiFloat *q1 = atoms1.q().constData();
+            const MultiFloat *sig1 = atoms1.sigma().constData();
+            const MultiFloat *eps1 = atoms1.epsilon().constData();
+            const MultiInt *id1 = atoms1.ID().constData();
+
+            const MultiFloat Rc(coul_cutoff);
+            const MultiFloat Rlj(lj_cutoff);
+            const MultiFloat Beta(beta);
+            const MultiFloat half(0.5);
+            const MultiInt dummy_id = CLJAtoms::idOfDummy();
+            const qint32 dummy_int = dummy_id[0];
+
+            const MultiFloat box_x( box_dimensions.x() );
+            const MultiFloat box_y( box_dimensions.y() );
+            const MultiFloat box_z( box_dimensions.z() );
+
+            const MultiFloat half_box_x( 0.5 * box_dimensions.x() );
+            const MultiFloat half_box_y( 0.5 * box_dimensions.y() );
+            const MultiFloat half_box_z( 0.5 * box_dimensions.z() );
+
+            MultiFloat tmp, r, one_over_r, sig2_over_r2, sig6_over_r6;
+            MultiDouble icnrg(0), iljnrg(0);
+            MultiInt itmp;
+
+            const int n0 = atoms0.x().count();
+            const int n1 = atoms1.x().count();
+
+            for (int i=0; i<n0; ++i)
+            {
+                for (int ii=0; ii<MultiFloat::count(); ++ii)
+                {
+                    if (id0[i][ii] != dummy_int)
+                    {
+                        const MultiInt id(id0[i][ii]);
+                        const MultiFloat x(x0[i][ii]);
+                        const MultiFloat y(y0[i][ii]);
+                        const MultiFloat z(z0[i][ii]);
+                        const MultiFloat q(q0[i][ii]);
+                        const MultiFloat sig( USE_ARITHMETIC ? sig0[i][ii] * sig0[i][ii]
+                                                             : sig0[i][ii] );
+                        const MultiFloat eps(eps0[i][ii]);
+
+                        for (int j=(self ? i : 0); j<n1; ++j)
+                        {
+                            // if i == j then we double-calculate the energies, so must
+                            // scale them by 0.5
+                            const MultiFloat scale( (self and i == j) ? 0.5 : 1.0 );
+
+                            //calculate the distance between the two atoms
+                            if (USE_BOX)
+                            {
+                                tmp = x1[j] - x;
+                                tmp &= MULTIFLOAT_POS_MASK;  // this creates the absolute value :-)
+                                tmp -= box_x.logicalAnd( half_box_x.compareLess(tmp) );
+                                r = tmp * tmp;
+
+                                tmp = y1[j] - y;
+                                tmp &= MULTIFLOAT_POS_MASK;
+                                tmp -= box_y.logicalAnd( half_box_y.compareLess(tmp) );
+                                r.multiplyAdd(tmp, tmp);
+
+                                tmp = z1[j] - z;
+                                tmp &= MULTIFLOAT_POS_MASK;
+                                tmp -= box_z.logicalAnd( half_box_z.compareLess(tmp) );
+                                r.multiplyAdd(tmp, tmp);
+                            }
+                            else
+                            {
+                                tmp = x1[j] - x;
+                                r = tmp * tmp;
+                                tmp = y1[j] - y;
+                                r.multiplyAdd(tmp, tmp);
+                                tmp = z1[j] - z;
+                                r.multiplyAdd(tmp, tmp);
+                            }
+
+                            r = r.sqrt();
+
+                            one_over_r = r.reciprocal();
+
+                            //calculate the real space coulomb energy
+                            // energy = q0q1 * erfc(beta r) / r
+                            tmp = spmeErfc(Beta * r);
+                            tmp *= one_over_r;
+                            tmp *= q * q1[j];
+
+                            //apply the cutoff - this removes all energies where r >= Rc
+                            tmp &= r.compareLess(Rc);
+
+                            //make sure that the ID of atoms1 is not zero, and is
+                            //also not the same as the atoms0.
+                            itmp = id1[j].compareEqual(dummy_id);
+                            itmp |= id1[j].compareEqual(id);
+
+                            icnrg += scale * tmp.logicalAndNot(itmp);
+
+                            //now the LJ energy
+                            if (USE_ARITHMETIC)
+                            {
+                                tmp = sig + (sig1[j]*sig1[j]);
+                                tmp *= half;
+                                sig2_over_r2 = tmp * one_over_r;
+                            }
+                            else
+                            {
+                                sig2_over_r2 = sig * sig1[j] * one_over_r;
+                            }
+
+                            sig2_over_r2 = sig2_over_r2*sig2_over_r2;
+                            sig6_over_r6 = sig2_over_r2*sig2_over_r2;
+                            sig6_over_r6 = sig6_over_r6*sig2_over_r2;
+
+                            tmp = sig6_over_r6 * sig6_over_r6;
+                            tmp -= sig6_over_r6;
+                            tmp *= eps;
+                            tmp *= eps1[j];
+
+                            //apply the cutoff - this removes all energies where r >= Rlj
+                            tmp &= r.compareLess(Rlj);
+                            iljnrg += scale * tmp.logicalAndNot(itmp);
+                        }
+                    }
+                }
+            }
+
+            cnrg = icnrg.sum();
+            ljnrg = iljnrg.sum();
+        }
+
+        /** Calculate the 'order' cardinal B-spline weights for an atom
+            that is a fraction 'w' past a mesh point, placing the
+            results into 'data' */
+        static void spmeSplineWeights(double w, int order, double *data)
+        {
+            data[order-1] = 0;
+            data[1] = w;
+            data[0] = 1 - w;
+
+            for (int j=3; j<order; ++j)
+            {
+                const double div = 1.0 / (j-1);
+                data[j-1] = div * w * data[j-2];
+
+                for (int k=1; k<j-1; ++k)
+                {
+                    data[j-k-1] = div * ((w+k)*data[j-k-2] + (j-k-w)*data[j-k-1]);
+                }
+
+                data[0] = div * (1-w) * data[0];
+            }
+
+            const double div = 1.0 / (order-1);
+            data[order-1] = div * w * data[order-2];
+
+            for (int k=1; k<order-1; ++k)
+            {
+                data[order-k-1] = div * ((w+k)*data[order-k-2] + (order-k-w)*data[order-k-1]);
+            }
+
+            data[0] = div * (1-w) * data[0];
+        }
+
+        /** Return the squared moduli of the Euler exponential splines
+            for a mesh dimension with 'n' points */
+        static QVector<double> spmeBSplineModuli(int n, int order)
+        {
+            QVarLengthArray<double,16> data(order);
+            spmeSplineWeights(0.0, order, data.data());
+
+            QVector<double> moduli(n, 0.0);
+            double *m = moduli.data();
+
+            for (int i=0; i<n; ++i)
+            {
+                double sc = 0;
+                double ss = 0;
+
+                for (int j=0; j<order; ++j)
+                {
+                    const double arg = (2.0 * SireMaths::pi * i * (j+1)) / n;
+                    sc += data[j] * std::cos(arg);
+                    ss += data[j] * std::sin(arg);
+                }
+
+                m[i] = sc*sc + ss*ss;
+            }
+
+            //the moduli can be zero for odd spline orders at the
+            //Nyquist frequency - interpolate across these points
+            for (int i=0; i<n; ++i)
+            {
+                if (m[i] < 1e-7)
+                {
+                    m[i] = 0.5 * (m[(i-1+n) % n] + m[(i+1) % n]);
+                }
+            }
+
+            return moduli;
+        }
+
+        /** Spread a single charge 'q', at scaled fractional coordinates
+            (fx,fy,fz), onto the mesh */
+        static inline void spmeSpreadCharge(double fx, double fy, double fz, double q,
+                                            int order, int nx, int ny, int nz,
+                                            SPMEComplex *mesh)
+        {
+            QVarLengthArray<double,16> wx(order), wy(order), wz(order);
+
+            const int gx = qMin(int(fx), nx-1);
+            const int gy = qMin(int(fy), ny-1);
+            const int gz = qMin(int(fz), nz-1);
+
+            spmeSplineWeights(fx - gx, order, wx.data());
+            spmeSplineWeights(fy - gy, order, wy.data());
+            spmeSplineWeights(fz - gz, order, wz.data());
+
+            for (int a=0; a<order; ++a)
+            {
+                const int ix = (gx + a) % nx;
+                const double qxa = q * wx[a];
+
+                for (int b=0; b<order; ++b)
+                {
+                    const int iy = (gy + b) % ny;
+                    const double qxy = qxa * wy[b];
+
+                    SPMEComplex *row = mesh + (ix*ny + iy)*nz;
+
+                    for (int c=0; c<order; ++c)
+                    {
+                        row[ (gz + c) % nz ] += qxy * wz[c];
+                    }
+                }
+            }
+        }
+
+        /** Spread the charges of the passed atoms onto the mesh, multiplying
+            each charge by 'scale'. Large systems are spread in parallel */
+        static void spmeSpreadCharges(const CLJAtoms &atoms, const Vector &box,
+                                      int order, int nx, int ny, int nz,
+                                      double scale, SPMEComplex *mesh)
+        {
+            const MultiFloat *xa = atoms.x().constData();
+            const MultiFloat *ya = atoms.y().constData();
+            const MultiFloat *za = atoms.z().constData();
+            const MultiFloat *qa = atoms.q().constData();
+            const MultiInt *ida = atoms.ID().constData();
+
+            const qint32 dummy_int = CLJAtoms::idOfDummy()[0];
+
+            const double inv_x = 1.0 / box.x();
+            const double inv_y = 1.0 / box.y();
+            const double inv_z = 1.0 / box.z();
+
+            //get the scaled fractional coordinates and charge of every charged
+            //atom, wrapped into the box
+            QVector<double> grid;
+            grid.reserve( 4 * atoms.x().count() * MultiFloat::count() );
+
+            for (int i=0; i<atoms.x().count(); ++i)
+            {
+                for (int ii=0; ii<MultiFloat::count(); ++ii)
+                {
+                    if (ida[i][ii] == dummy_int or qa[i][ii] == 0)
+                        continue;
+
+                    const double fx = xa[i][ii] * inv_x;
+                    const double fy = ya[i][ii] * inv_y;
+                    const double fz = za[i][ii] * inv_z;
+
+                    grid.append( (fx - std::floor(fx)) * nx );
+                    grid.append( (fy - std::floor(fy)) * ny );
+                    grid.append( (fz - std::floor(fz)) * nz );
+                    grid.append( scale * qa[i][ii] );
+                }
+            }
+
+            const int ncharged = grid.count() / 4;
+            const double *g = grid.constData();
+
+            //each charge is spread over the planes gx to gx+order-1. Dividing
+            //the mesh along x into an even number of slabs that are each at
+            //least 'order' planes wide means that the charges in the even
+            //slabs (and then in the odd slabs) never write to the same points,
+            //so the slabs within each half can be spread in parallel
+            int nslabs = nx / order;
+
+            if (nslabs % 2 == 1)
+                nslabs -= 1;
+
+            if (nslabs < 2 or ncharged < 256)
+            {
+                for (int i=0; i<ncharged; ++i)
+                {
+                    spmeSpreadCharge(g[4*i], g[4*i+1], g[4*i+2], g[4*i+3],
+                                     order, nx, ny, nz, mesh);
+                }
+
+                return;
+            }
+
+            QVector< QVector<int> > slabs(nslabs);
+
+            for (int i=0; i<ncharged; ++i)
+            {
+                const int gx = qMin(int(g[4*i]), nx-1);
+                slabs[ (gx*nslabs) / nx ].append(i);
+            }
+
+            for (int parity=0; parity<2; ++parity)
+            {
+                tbb::parallel_for( tbb::blocked_range<int>(0, nslabs/2),
+                                   [&](const tbb::blocked_range<int> &r)
+                {
+                    for (int s=r.begin(); s<r.end(); ++s)
+                    {
+                        const QVector<int> &slab = slabs.at(2*s + parity);
+
+                        for (int k=0; k<slab.count(); ++k)
+                        {
+                            const int i = slab.constData()[k];
+                            spmeSpreadCharge(g[4*i], g[4*i+1], g[4*i+2], g[4*i+3],
+                                             order, nx, ny, nz, mesh);
+                        }
+                    }
+                });
+            }
+        }
+
+        /** Return the influence function for the mesh (including the B-spline
+            moduli and the 1 / (2 pi V) prefactor) */
+        static QVector<double> spmeInfluenceFunction(const Vector &box, double beta, int order,
+                                                     int nx, int ny, int nz)
+        {
+            const QVector<double> bx = spmeBSplineModuli(nx, order);
+            const QVector<double> by = spmeBSplineModuli(ny, order);
+            const QVector<double> bz = spmeBSplineModuli(nz, order);
+
+            const double volume = box.x() * box.y() * box.z();
+            const double prefactor = 1.0 / (2.0 * SireMaths::pi * volume);
+            const double pi2_over_beta2 = (SireMaths::pi * SireMaths::pi) / (beta * beta);
+
+            QVector<double> influence(nx*ny*nz, 0.0);
+            double *inf = influence.data();
+
+            for (int i=0; i<nx; ++i)
+            {
+                const double mx = (i <= nx/2 ? i : i - nx) / box.x();
+
+                for (int j=0; j<ny; ++j)
+                {
+                    const double my = (j <= ny/2 ? j : j - ny) / box.y();
+
+                    for (int k=0; k<nz; ++k)
+                    {
+                        if (i == 0 and j == 0 and k == 0)
+                            continue;
+
+                        const double mz = (k <= nz/2 ? k : k - nz) / box.z();
+                        const double m2 = mx*mx + my*my + mz*mz;
+
+                        inf[(i*ny + j)*nz + k] = prefactor * std::exp(-pi2_over_beta2 * m2)
+                                                   / (m2 * bx.constData()[i] *
+                                                      by.constData()[j] * bz.constData()[k]);
+                    }
+                }
+            }
+
+            return influence;
+        }
+
+        /** Return the reciprocal space energy of the passed transformed mesh */
+        static double spmeMeshEnergy(const QVector<double> &influence, const SPMEComplex *mesh)
+        {
+            const double *inf = influence.constData();
+            const int npoints = influence.count();
+
+            double nrg = 0;
+
+            for (int i=0; i<npoints; ++i)
+            {
+                nrg += inf[i] * std::norm(mesh[i]);
+            }
+
+            return nrg;
+        }
+
+        /** Return the self energy of the passed atoms */
+        static double spmeSelfEnergy(const CLJAtoms &atoms, double beta)
+        {
+            const MultiFloat *qa = atoms.q().constData();
+            const MultiInt *ida = atoms.ID().constData();
+            const qint32 dummy_int = CLJAtoms::idOfDummy()[0];
+
+            double q2 = 0;
+
+            for (int i=0; i<atoms.q().count(); ++i)
+            {
+                for (int ii=0; ii<MultiFloat::count(); ++ii)
+                {
+                    if (ida[i][ii] != dummy_int)
+                    {
+                        const double q = qa[i][ii];
+                        q2 += q*q;
+                    }
+                }
+            }
+
+            return -beta * q2 / std::sqrt(SireMaths::pi);
+        }
+
+        /** Return the coordinates and charges (packed as x,y,z,q) of all of
+            the charged atoms in 'atoms', grouped by atom ID */
+        static QHash< qint32,QVector<float> > spmeExclusionGroups(const CLJAtoms &atoms)
+        {
+            const MultiFloat *xa = atoms.x().constData();
+            const MultiFloat *ya = atoms.y().constData();
+            const MultiFloat *za = atoms.z().constData();
+            const MultiFloat *qa = atoms.q().constData();
+            const MultiInt *ida = atoms.ID().constData();
+            const qint32 dummy_int = CLJAtoms::idOfDummy()[0];
+
+            QHash< qint32,QVector<float> > groups;
+
+            for (int i=0; i<atoms.x().count(); ++i)
+            {
+                for (int ii=0; ii<MultiFloat::count(); ++ii)
+                {
+                    if (ida[i][ii] != dummy_int and qa[i][ii] != 0)
+                    {
+                        QVector<float> &group = groups[ida[i][ii]];
+                        group.append(xa[i][ii]);
+                        group.append(ya[i][ii]);
+                        group.append(za[i][ii]);
+                        group.append(qa[i][ii]);
+                    }
+                }
+            }
+
+            return groups;
+        }
+
+        /** Return the correction to the reciprocal space energy for all of the
+            pairs of atoms in the passed group (packed as x,y,z,q), which all
+            have the same ID. These pairs are excluded from the real space sum,
+            but are included in the reciprocal space sum */
+        static double spmeExclusionEnergy(const QVector<float> &group,
+                                          const Vector &box, double beta)
+        {
+            const float *g = group.constData();
+            const int n = group.count() / 4;
+
+            double nrg = 0;
+
+            for (int i=0; i<n-1; ++i)
+            {
+                const double x0 = g[4*i];
+                const double y0 = g[4*i+1];
+                const double z0 = g[4*i+2];
+                const double q0 = g[4*i+3];
+
+                for (int j=i+1; j<n; ++j)
+                {
+                    double dx = g[4*j] - x0;
+                    double dy = g[4*j+1] - y0;
+                    double dz = g[4*j+2] - z0;
+
+                    //minimum image convention
+                    dx -= box.x() * std::floor( dx/box.x() + 0.5 );
+                    dy -= box.y() * std::floor( dy/box.y() + 0.5 );
+                    dz -= box.z() * std::floor( dz/box.z() + 0.5 );
+
+                    const double r = std::sqrt(dx*dx + dy*dy + dz*dz);
+
+                    if (r > 0)
+                    {
+                        nrg -= q0 * g[4*j+3] * std::erf(beta*r) / r;
+                    }
+                    else
+                    {
+                        //limit of erf(beta r)/r as r -> 0
+                        nrg -= q0 * g[4*j+3] * 2.0 * beta / std::sqrt(SireMaths::pi);
+                    }
+                }
+            }
+
+            return nrg;
+        }
+
+        /** Return the correction to the reciprocal space energy for all of the
+            pairs of atoms that have the same ID */
+        static double spmeExclusionEnergy(const CLJAtoms &atoms, const Vector &box, double beta)
+        {
+            const QHash< qint32,QVector<float> > groups = spmeExclusionGroups(atoms);
+
+            double nrg = 0;
+
+            for (QHash< qint32,QVector<float> >::const_iterator it = groups.constBegin();
+                 it != groups.constEnd();
+                 ++it)
+            {
+                nrg += spmeExclusionEnergy(it.value(), box, beta);
+            }
+
+            return nrg;
+        }
+
+    } // end of namespace detail
+} // end of namespace SireMM
+
+using namespace SireMM::detail;
+
+/////////
+///////// Implementation of CLJSPMEFunction
+/////////
+
+static const RegisterMetaType<CLJSPMEFunction> r_spme;
+
+QDataStream SIREMM_EXPORT &operator<<(QDataStream &ds, const CLJSPMEFunction &func)
+{
+    writeHeader(ds, r_spme, 1);
+
+    ds << func.ewald_precision << func.grid_spacing << func.spline_order
+       << static_cast<const CLJCutoffFunction&>(func);
+
+    return ds;
+}
+
+QDataStream SIREMM_EXPORT &operator>>(QDataStream &ds, CLJSPMEFunction &func)
+{
+    VersionID v = readHeader(ds, r_spme);
+
+    if (v == 1)
+    {
+        ds >> func.ewald_precision >> func.grid_spacing >> func.spline_order
+           >> static_cast<CLJCutoffFunction&>(func);
+    }
+    else
+        throw version_error(v, "1", r_spme, CODELOC);
+
+    return ds;
+}
+
+CLJSPMEFunction::CLJSPMEFunction()
+                : ConcreteProperty<CLJSPMEFunction,CLJCutoffFunction>(),
+                  ewald_precision(default_ewald_precision),
+                  grid_spacing(default_grid_spacing), spline_order(default_spline_order)
+{}
+
+CLJFunctionPtr CLJSPMEFunction::defaultSPMEFunction()
+{
+    static CLJFunctionPtr ptr( new CLJSPMEFunction() );
+    return ptr;
+}
+
+CLJSPMEFunction::CLJSPMEFunction(Length cutoff)
+                : ConcreteProperty<CLJSPMEFunction,CLJCutoffFunction>(cutoff),
+                  ewald_precision(default_ewald_precision),
+                  grid_spacing(default_grid_spacing), spline_order(default_spline_order)
+{}
+
+CLJSPMEFunction::CLJSPMEFunction(Length coul_cutoff, Length lj_cutoff)
+                : ConcreteProperty<CLJSPMEFunction,CLJCutoffFunction>(coul_cutoff, lj_cutoff),
+                  ewald_precision(default_ewald_precision),
+                  grid_spacing(default_grid_spacing), spline_order(default_spline_order)
+{}
+
+CLJSPMEFunction::CLJSPMEFunction(const Space &space, Length cutoff)
+                : ConcreteProperty<CLJSPMEFunction,CLJCutoffFunction>(space, cutoff),
+                  ewald_precision(default_ewald_precision),
+                  grid_spacing(default_grid_spacing), spline_order(default_spline_order)
+{}
+
+CLJSPMEFunction::CLJSPMEFunction(const Space &space, Length coul_cutoff, Length lj_cutoff)
+                : ConcreteProperty<CLJSPMEFunction,CLJCutoffFunction>(space, coul_cutoff,
+                                                                      lj_cutoff),
+                  ewald_precision(default_ewald_precision),
+                  grid_spacing(default_grid_spacing), spline_order(default_spline_order)
+{}
+
+CLJSPMEFunction::CLJSPMEFunction(Length cutoff, COMBINING_RULES combining_rules)
+                : ConcreteProperty<CLJSPMEFunction,CLJCutoffFunction>(cutoff, combining_rules),
+                  ewald_precision(default_ewald_precision),
+                  grid_spacing(default_grid_spacing), spline_order(default_spline_order)
+{}
+
+CLJSPMEFunction::CLJSPMEFunction(Length coul_cutoff, Length lj_cutoff,
+                                 COMBINING_RULES combining_rules)
+                : ConcreteProperty<CLJSPMEFunction,CLJCutoffFunction>(
+                                 coul_cutoff, lj_cutoff, combining_rules),
+                  ewald_precision(default_ewald_precision),
+                  grid_spacing(default_grid_spacing), spline_order(default_spline_order)
+{}
+
+CLJSPMEFunction::CLJSPMEFunction(const Space &space, COMBINING_RULES combining_rules)
+                : ConcreteProperty<CLJSPMEFunction,CLJCutoffFunction>(space, combining_rules),
+                  ewald_precision(default_ewald_precision),
+                  grid_spacing(default_grid_spacing), spline_order(default_spline_order)
+{}
+
+CLJSPMEFunction::CLJSPMEFunction(const Space &space, Length cutoff,
+                                 COMBINING_RULES combining_rules)
+                : ConcreteProperty<CLJSPMEFunction,CLJCutoffFunction>(
+                                 space, cutoff, combining_rules),
+                  ewald_precision(default_ewald_precision),
+                  grid_spacing(default_grid_spacing), spline_order(default_spline_order)
+{}
+
+CLJSPMEFunction::CLJSPMEFunction(const Space &space, Length coul_cutoff, Length lj_cutoff,
+                                 COMBINING_RULES combining_rules)
+                : ConcreteProperty<CLJSPMEFunction,CLJCutoffFunction>(
+                                 space, coul_cutoff, lj_cutoff, combining_rules),
+                  ewald_precision(default_ewald_precision),
+                  grid_spacing(default_grid_spacing), spline_order(default_spline_order)
+{}
+
+/** Copy constructor */
+CLJSPMEFunction::CLJSPMEFunction(const CLJSPMEFunction &other)
+                : ConcreteProperty<CLJSPMEFunction,CLJCutoffFunction>(other),
+                  ewald_precision(other.ewald_precision),
+                  grid_spacing(other.grid_spacing), spline_order(other.spline_order)
+{}
+
+/** Destructor */
+CLJSPMEFunction::~CLJSPMEFunction()
+{}
+
+/** Copy assignment operator */
+CLJSPMEFunction& CLJSPMEFunction::operator=(const CLJSPMEFunction &other)
+{
+    ewald_precision = other.ewald_precision;
+    grid_spacing = other.grid_spacing;
+    spline_order = other.spline_order;
+    CLJCutoffFunction::operator=(other);
+    return *this;
+}
+
+/** Comparison operator */
+bool CLJSPMEFunction::operator==(const CLJSPMEFunction &other) const
+{
+    return ewald_precision == other.ewald_precision and
+           grid_spacing == other.grid_spacing and
+           spline_order == other.spline_order and
+           CLJCutoffFunction::operator==(other);
+}
+
+/** Comparison operator */
+bool CLJSPMEFunction::operator!=(const CLJSPMEFunction &other) const
+{
+    return not operator==(other);
+}
+
+const char* CLJSPMEFunction::typeName()
+{
+    return QMetaType::typeName( qMetaTypeId<CLJSPMEFunction>() );
+}
+
+const char* CLJSPMEFunction::what() const
+{
+    return CLJSPMEFunction::typeName();
+}
+
+CLJSPMEFunction* CLJSPMEFunction::clone() const
+{
+    return new CLJSPMEFunction(*this);
+}
+
+QString CLJSPMEFunction::toString() const
+{
+    return QObject::tr("CLJSPMEFunction( coulombCutoff() == %1 A, ljCutoff() == %2 A, "
+                       "ewaldPrecision() == %3, gridSpacing() == %4 A, "
+                       "splineOrder() == %5, space() == %6 )")
+                .arg(coulombCutoff().to(angstrom))
+                .arg(ljCutoff().to(angstrom))
+                .arg(ewaldPrecision())
+                .arg(gridSpacing().to(angstrom))
+                .arg(splineOrder())
+                .arg(space().toString());
+}
+
+/** Return the properties of this function */
+Properties CLJSPMEFunction::properties() const
+{
+    Properties props = CLJCutoffFunction::properties();
+    props.setProperty("ewaldPrecision", NumberProperty(ewaldPrecision()));
+    props.setProperty("gridSpacing", LengthProperty(gridSpacing()));
+    props.setProperty("splineOrder", NumberProperty(qint64(splineOrder())));
+    return props;
+}
+
+/** Return a copy of this function where the property 'name' has been set to the
+    value 'value' */
+CLJFunctionPtr CLJSPMEFunction::setProperty(const QString &name, const Property &value) const
+{
+    if (name == "ewaldPrecision")
+    {
+        CLJFunctionPtr ret(*this);
+        ret.edit().asA<CLJSPMEFunction>().setEwaldPrecision(
+                                                value.asA<NumberProperty>().value() );
+        return ret;
+    }
+    else if (name == "gridSpacing")
+    {
+        CLJFunctionPtr ret(*this);
+        ret.edit().asA<CLJSPMEFunction>().setGridSpacing( value.asA<LengthProperty>().value() );
+        return ret;
+    }
+    else if (name == "splineOrder")
+    {
+        CLJFunctionPtr ret(*this);
+        ret.edit().asA<CLJSPMEFunction>().setSplineOrder(
+                                                value.asA<NumberProperty>().asAnInteger() );
+        return ret;
+    }
+    else
+        return CLJCutoffFunction::setProperty(name, value);
+}
+
+/** Return the value of the property with name 'name' */
+PropertyPtr CLJSPMEFunction::property(const QString &name) const
+{
+    if (name == "ewaldPrecision")
+    {
+        return NumberProperty(ewaldPrecision());
+    }
+    else if (name == "gridSpacing")
+    {
+        return LengthProperty(gridSpacing());
+    }
+    else if (name == "splineOrder")
+    {
+        return NumberProperty(qint64(splineOrder()));
+    }
+    else
+    {
+        return CLJCutoffFunction::property(name);
+    }
+}
+
+/** Return whether or not this function contains a property called 'name' */
+bool CLJSPMEFunction::containsProperty(const QString &name) const
+{
+    return (name == "ewaldPrecision") or (name == "gridSpacing") or
+           (name == "splineOrder") or CLJCutoffFunction::containsProperty(name);
+}
+
+/** Set the relative precision of the Ewald sum. This is the approximate
+    relative size of the real space energy at the cutoff, and is used
+    to choose the Ewald screening parameter beta */
+void CLJSPMEFunction::setEwaldPrecision(double precision)
+{
+    if (precision <= 0 or precision >= 0.5)
+        throw SireError::invalid_arg( QObject::tr(
+                "The Ewald precision must lie between 0 and 0.5. The value %1 is "
+                "not valid.").arg(precision), CODELOC );
+
+    ewald_precision = precision;
+}
+
+/** Return the relative precision of the Ewald sum */
+double CLJSPMEFunction::ewaldPrecision() const
+{
+    return ewald_precision;
+}
+
+/** Set the maximum spacing between points on the reciprocal space mesh */
+void CLJSPMEFunction::setGridSpacing(Length spacing)
+{
+    if (spacing.value() <= 0)
+        throw SireError::invalid_arg( QObject::tr(
+                "The SPME grid spacing must be greater than zero (%1 A is not valid)")
+                    .arg(spacing.to(angstrom)), CODELOC );
+
+    grid_spacing = spacing.value();
+}
+
+/** Return the maximum spacing between points on the reciprocal space mesh */
+Length CLJSPMEFunction::gridSpacing() const
+{
+    return Length(grid_spacing);
+}
+
+/** Set the order of the B-splines used to spread the charges onto the mesh */
+void CLJSPMEFunction::setSplineOrder(int order)
+{
+    if (order < 3 or order > 12)
+        throw SireError::invalid_arg( QObject::tr(
+                "The SPME spline order must be between 3 and 12 (%1 is not valid)")
+                    .arg(order), CODELOC );
+
+    spline_order = order;
+}
+
+/** Return the order of the B-splines used to spread the charges onto the mesh */
+int CLJSPMEFunction::splineOrder() const
+{
+    return spline_order;
+}
+
+/** Return the Ewald screening parameter (beta, in inverse angstroms). This
+    is chosen so that erfc(beta * cutoff) is approximately equal to
+    the Ewald precision */
+double CLJSPMEFunction::beta() const
+{
+    return std::sqrt( -std::log(2.0 * ewald_precision) ) / coul_cutoff;
+}
+
+/** Internal function used to return the dimensions of the periodic box
+
+    \throw SireError::incompatible_error
+*/
+Vector CLJSPMEFunction::boxDimensions() const
+{
+    if (not space().isA<PeriodicBox>())
+        throw SireError::incompatible_error( QObject::tr(
+                "The long-range part of the SPME energy can only be calculated "
+                "using an orthorhombic periodic box (PeriodicBox). It cannot be "
+                "calculated using the space %1.")
+                    .arg(space().toString()), CODELOC );
+
+    return space().asA<PeriodicBox>().dimensions();
+}
+
+/** Return the number of points along each dimension of the reciprocal
+    space mesh for the current periodic box
+
+    \throw SireError::incompatible_error
+*/
+QVector<qint32> CLJSPMEFunction::meshDimensions() const
+{
+    const Vector box = this->boxDimensions();
+
+    QVector<qint32> dims(3);
+
+    for (int i=0; i<3; ++i)
+    {
+        dims[i] = qMax( spmeMeshSize( int(std::ceil(box[i] / grid_spacing)) ),
+                        spmeMeshSize( int(spline_order) ) );
+    }
+
+    return dims;
+}
+
+/** Return the reciprocal space energy of the passed atoms
+
+    \throw SireError::incompatible_error
+*/
+double CLJSPMEFunction::reciprocalEnergy(const CLJAtoms &atoms) const
+{
+    const Vector box = this->boxDimensions();
+    const QVector<qint32> dims = this->meshDimensions();
+
+    const int nx = dims[0];
+    const int ny = dims[1];
+    const int nz = dims[2];
+
+    std::vector<SPMEComplex> mesh(nx*ny*nz, SPMEComplex(0,0));
+
+    spmeSpreadCharges(atoms, box, spline_order, nx, ny, nz, 1.0, &(mesh[0]));
+    spmeFFT3D(&(mesh[0]), nx, ny, nz);
+
+    return spmeMeshEnergy( spmeInfluenceFunction(box, this->beta(), spline_order, nx, ny, nz),
+                           &(mesh[0]) );
+}
+
+/** Return the reciprocal space energy of the passed atoms
+
+    \throw SireError::incompatible_error
+*/
+double CLJSPMEFunction::reciprocalEnergy(const CLJBoxes &atoms) const
+{
+    return this->reciprocalEnergy(atoms.atoms());
+}
+
+/** Return the Ewald self energy of the passed atoms */
+double CLJSPMEFunction::selfEnergy(const CLJAtoms &atoms) const
+{
+    return spmeSelfEnergy(atoms, this->beta());
+}
+
+/** Return the Ewald self energy of the passed atoms */
+double CLJSPMEFunction::selfEnergy(const CLJBoxes &atoms) const
+{
+    return this->selfEnergy(atoms.atoms());
+}
+
+/** Return the correction to the reciprocal space energy that removes
+    the interactions between pairs of atoms that have the same ID
+    (and so are excluded from the intermolecular energy)
+
+    \throw SireError::incompatible_error
+*/
+double CLJSPMEFunction::exclusionEnergy(const CLJAtoms &atoms) const
+{
+    return spmeExclusionEnergy(atoms, this->boxDimensions(), this->beta());
+}
+
+/** Return the correction to the reciprocal space energy that removes
+    the interactions between pairs of atoms that have the same ID
+    (and so are excluded from the intermolecular energy)
+
+    \throw SireError::incompatible_error
+*/
+double CLJSPMEFunction::exclusionEnergy(const CLJBoxes &atoms) const
+{
+    return this->exclusionEnergy(atoms.atoms());
+}
+
+/** Return the long-range part of the SPME coulomb energy of the passed
+    atoms. This is the sum of the reciprocal space, self and
+    exclusion energies, and must be added to the real space energy
+    calculated by the pair functions to obtain the total coulomb energy
+
+    \throw SireError::incompatible_error
+*/
+double CLJSPMEFunction::longRangeEnergy(const CLJAtoms &atoms) const
+{
+    return this->reciprocalEnergy(atoms) + this->selfEnergy(atoms) +
+           this->exclusionEnergy(atoms);
+}
+
+/** Return the long-range part of the SPME coulomb energy of the passed
+    atoms
+
+    \throw SireError::incompatible_error
+*/
+double CLJSPMEFunction::longRangeEnergy(const CLJBoxes &atoms) const
+{
+    return this->longRangeEnergy(atoms.atoms());
+}
+
+/** Calculate the real space coulomb and LJ intermolecular energy of all of
+    the atoms in 'atoms', returning the results in the arguments 'cnrg' and 'ljnrg' */
+void CLJSPMEFunction::calcVacEnergyGeo(const CLJAtoms &atoms,
+                                       double &cnrg, double &ljnrg) const
+{
+    spmeRealSpaceEnergy<false,false>(atoms, atoms, true, Vector(0), this->beta(),
+                                     coul_cutoff, lj_cutoff, cnrg, ljnrg);
+}
+
+/** Calculate the real space intermolecular energy between all atoms in 'atoms0'
+    and all atoms in 'atoms1', returning the result in the arguments 'cnrg' and 'ljnrg' */
+void CLJSPMEFunction::calcVacEnergyGeo(const CLJAtoms &atoms0, const CLJAtoms &atoms1,
+                                       double &cnrg, double &ljnrg, float min_distance) const
+{
+    if (min_distance >= qMax(coul_cutoff, lj_cutoff))
+    {
+        //all of the atoms are beyond the cutoffs
+        cnrg = 0;
+        ljnrg = 0;
+        return;
+    }
+
+    spmeRealSpaceEnergy<false,false>(atoms0, atoms1, false, Vector(0), this->beta(),
+                                     coul_cutoff, lj_cutoff, cnrg, ljnrg);
+}
+
+/** Calculate the real space coulomb and LJ intermolecular energy of all of
+    the atoms in 'atoms', returning the results in the arguments 'cnrg' and 'ljnrg' */
+void CLJSPMEFunction::calcVacEnergyAri(const CLJAtoms &atoms,
+                                       double &cnrg, double &ljnrg) const
+{
+    spmeRealSpaceEnergy<false,true>(atoms, atoms, true, Vector(0), this->beta(),
+                                    coul_cutoff, lj_cutoff, cnrg, ljnrg);
+}
+
+/** Calculate the real space intermolecular energy between all atoms in 'atoms0'
+    and all atoms in 'atoms1', returning the result in the arguments 'cnrg' and 'ljnrg' */
+void CLJSPMEFunction::calcVacEnergyAri(const CLJAtoms &atoms0, const CLJAtoms &atoms1,
+                                       double &cnrg, double &ljnrg, float min_distance) const
+{
+    if (min_distance >= qMax(coul_cutoff, lj_cutoff))
+    {
+        //all of the atoms are beyond the cutoffs
+        cnrg = 0;
+        ljnrg = 0;
+        return;
+    }
+
+    spmeRealSpaceEnergy<false,true>(atoms0, atoms1, false, Vector(0), this->beta(),
+                                    coul_cutoff, lj_cutoff, cnrg, ljnrg);
+}
+
+/** Calculate the real space coulomb and LJ intermolecular energy of all of
+    the atoms in 'atoms', assuming periodic boundary conditions in a box of
+    size 'box_dimensions', returning the results in 'cnrg' and 'ljnrg' */
+void CLJSPMEFunction::calcBoxEnergyGeo(const CLJAtoms &atoms, const Vector &box_dimensions,
+                                       double &cnrg, double &ljnrg) const
+{
+    spmeRealSpaceEnergy<true,false>(atoms, atoms, true, box_dimensions, this->beta(),
+                                    coul_cutoff, lj_cutoff, cnrg, ljnrg);
+}
+
+/** Calculate the real space intermolecular energy between all atoms in 'atoms0'
+    and all atoms in 'atoms1', assuming periodic boundary conditions in a box
+    of size 'box_dimensions', returning the result in the arguments 'cnrg' and 'ljnrg' */
+void CLJSPMEFunction::calcBoxEnergyGeo(const CLJAtoms &atoms0, const CLJAtoms &atoms1,
+                                       const Vector &box_dimensions,
+                                       double &cnrg, double &ljnrg, float min_distance) const
+{
+    if (min_distance >= qMax(coul_cutoff, lj_cutoff))
+    {
+        //all of the atoms are beyond the cutoffs
+        cnrg = 0;
+        ljnrg = 0;
+        return;
+    }
+
+    spmeRealSpaceEnergy<true,false>(atoms0, atoms1, false, box_dimensions, this->beta(),
+                                    coul_cutoff, lj_cutoff, cnrg, ljnrg);
+}
+
+/** Calculate the real space coulomb and LJ intermolecular energy of all of
+    the atoms in 'atoms', assuming periodic boundary conditions in a box of
+    size 'box_dimensions', returning the results in 'cnrg' and 'ljnrg' */
+void CLJSPMEFunction::calcBoxEnergyAri(const CLJAtoms &atoms, const Vector &box_dimensions,
+                                       double &cnrg, double &ljnrg) const
+{
+    spmeRealSpaceEnergy<true,true>(atoms, atoms, true, box_dimensions, this->beta(),
+                                   coul_cutoff, lj_cutoff, cnrg, ljnrg);
+}
+
+/** Calculate the real space intermolecular energy between all atoms in 'atoms0'
+    and all atoms in 'atoms1', assuming periodic boundary conditions in a box
+    of size 'box_dimensions', returning the result in the arguments 'cnrg' and 'ljnrg' */
+void CLJSPMEFunction::calcBoxEnergyAri(const CLJAtoms &atoms0, const CLJAtoms &atoms1,
+                                       const Vector &box_dimensions,
+                                       double &cnrg, double &ljnrg, float min_distance) const
+{
+    if (min_distance >= qMax(coul_cutoff, lj_cutoff))
+    {
+        //all of the atoms are beyond the cutoffs
+        cnrg = 0;
+        ljnrg = 0;
+        return;
+    }
+
+    spmeRealSpaceEnergy<true,true>(atoms0, atoms1, false, box_dimensions, this->beta(),
+                                   coul_cutoff, lj_cutoff, cnrg, ljnrg);
+}
+
+/////////
+///////// Implementation of CLJSPMEMesh
+/////////
+
+static const RegisterMetaType<CLJSPMEMesh> r_spmemesh(NO_ROOT);
+
+QDataStream SIREMM_EXPORT &operator<<(QDataStream &ds, const CLJSPMEMesh &mesh)
+{
+    writeHeader(ds, r_spmemesh, 2);
+
+    SharedDataStream sds(ds);
+
+    sds << mesh.func << mesh.box_dims << mesh.nx << mesh.ny << mesh.nz
+        << mesh.influence << mesh.mesh << mesh.recip_nrg << mesh.corr_nrg
+        << mesh.excl_groups << mesh.excl_nrgs;
+
+    return ds;
+}
+
+QDataStream SIREMM_EXPORT &operator>>(QDataStream &ds, CLJSPMEMesh &mesh)
+{
+    VersionID v = readHeader(ds, r_spmemesh);
+
+    if (v == 2)
+    {
+        SharedDataStream sds(ds);
+
+        sds >> mesh.func >> mesh.box_dims >> mesh.nx >> mesh.ny >> mesh.nz
+            >> mesh.influence >> mesh.mesh >> mesh.recip_nrg >> mesh.corr_nrg
+            >> mesh.excl_groups >> mesh.excl_nrgs;
+
+        mesh.revert();
+    }
+    else if (v == 1)
+    {
+        SharedDataStream sds(ds);
+
+        sds >> mesh.func >> mesh.box_dims >> mesh.nx >> mesh.ny >> mesh.nz
+            >> mesh.influence >> mesh.mesh >> mesh.recip_nrg >> mesh.corr_nrg;
+
+        //version 1 did not store the atoms of each ID, so the mesh
+        //has to be rebuilt (by calling setAtoms) before it can be updated
+        mesh.excl_groups.clear();
+        mesh.excl_nrgs.clear();
+        mesh.mesh = QVector<double>();
+        mesh.revert();
+    }
+    else
+        throw version_error(v, "1,2", r_spmemesh, CODELOC);
+
+    return ds;
+}
+
+/** Constructor */
+CLJSPMEMesh::CLJSPMEMesh()
+            : nx(0), ny(0), nz(0), recip_nrg(0), corr_nrg(0),
+              delta_recip_nrg(0), delta_corr_nrg(0), needs_accepting(false)
+{}
+
+/** Construct the mesh for the passed atoms using the passed function
+
+    \throw SireError::incompatible_error
+*/
+CLJSPMEMesh::CLJSPMEMesh(const CLJSPMEFunction &function, const CLJAtoms &atoms)
+            : func(function), nx(0), ny(0), nz(0), recip_nrg(0), corr_nrg(0),
+              delta_recip_nrg(0), delta_corr_nrg(0), needs_accepting(false)
+{
+    this->setAtoms(atoms);
+}
+
+/** Construct the mesh for the passed atoms using the passed function
+
+    \throw SireError::incompatible_error
+*/
+CLJSPMEMesh::CLJSPMEMesh(const CLJSPMEFunction &function, const CLJBoxes &atoms)
+            : func(function), nx(0), ny(0), nz(0), recip_nrg(0), corr_nrg(0),
+              delta_recip_nrg(0), delta_corr_nrg(0), needs_accepting(false)
+{
+    this->setAtoms(atoms);
+}
+
+/** Copy constructor */
+CLJSPMEMesh::CLJSPMEMesh(const CLJSPMEMesh &other)
+            : func(other.func), box_dims(other.box_dims),
+              nx(other.nx), ny(other.ny), nz(other.nz),
+              influence(other.influence), mesh(other.mesh), delta_mesh(other.delta_mesh),
+              recip_nrg(other.recip_nrg), corr_nrg(other.corr_nrg),
+              delta_recip_nrg(other.delta_recip_nrg), delta_corr_nrg(other.delta_corr_nrg),
+              excl_groups(other.excl_groups), excl_nrgs(other.excl_nrgs),
+              delta_excl_groups(other.delta_excl_groups),
+              delta_excl_nrgs(other.delta_excl_nrgs),
+              needs_accepting(other.needs_accepting)
+{}
+
+/** Destructor */
+CLJSPMEMesh::~CLJSPMEMesh()
+{}
+
+/** Copy assignment operator */
+CLJSPMEMesh& CLJSPMEMesh::operator=(const CLJSPMEMesh &other)
+{
+    if (this != &other)
+    {
+        func = other.func;
+        box_dims = other.box_dims;
+        nx = other.nx;
+        ny = other.ny;
+        nz = other.nz;
+        influence = other.influence;
+        mesh = other.mesh;
+        delta_mesh = other.delta_mesh;
+        recip_nrg = other.recip_nrg;
+        corr_nrg = other.corr_nrg;
+        delta_recip_nrg = other.delta_recip_nrg;
+        delta_corr_nrg = other.delta_corr_nrg;
+        excl_groups = other.excl_groups;
+        excl_nrgs = other.excl_nrgs;
+        delta_excl_groups = other.delta_excl_groups;
+        delta_excl_nrgs = other.delta_excl_nrgs;
+        needs_accepting = other.needs_accepting;
+    }
+
+    return *this;
+}
+
+/** Comparison operator */
+bool CLJSPMEMesh::operator==(const CLJSPMEMesh &other) const
+{
+    return func == other.func and box_dims == other.box_dims and
+           nx == other.nx and ny == other.ny and nz == other.nz and
+           recip_nrg == other.recip_nrg and corr_nrg == other.corr_nrg and
+           needs_accepting == other.needs_accepting and mesh == other.mesh;
+}
+
+/** Comparison operator */
+bool CLJSPMEMesh::operator!=(const CLJSPMEMesh &other) const
+{
+    return not operator==(other);
+}
+
+const char* CLJSPMEMesh::typeName()
+{
+    return QMetaType::typeName( qMetaTypeId<CLJSPMEMesh>() );
+}
+
+const char* CLJSPMEMesh::what() const
+{
+    return CLJSPMEMesh::typeName();
+}
+
+QString CLJSPMEMesh::toString() const
+{
+    if (this->isEmpty())
+        return QObject::tr("CLJSPMEMesh::null");
+    else
+        return QObject::tr("CLJSPMEMesh( %1x%2x%3, energy() == %4 )")
+                    .arg(nx).arg(ny).arg(nz).arg(this->energy());
+}
+
+/** Return whether or not this mesh is empty */
+bool CLJSPMEMesh::isEmpty() const
+{
+    return mesh.isEmpty();
+}
+
+/** Return the function used to define the Ewald sum */
+const CLJSPMEFunction& CLJSPMEMesh::function() const
+{
+    return func;
+}
+
+/** Return the number of points along each dimension of the mesh */
+QVector<qint32> CLJSPMEMesh::meshDimensions() const
+{
+    QVector<qint32> dims(3);
+    dims[0] = nx;
+    dims[1] = ny;
+    dims[2] = nz;
+    return dims;
+}
+
+/** Internal function used to build the influence function for the current box */
+void CLJSPMEMesh::buildInfluenceFunction()
+{
+    box_dims = func.boxDimensions();
+
+    const QVector<qint32> dims = func.meshDimensions();
+    nx = dims[0];
+    ny = dims[1];
+    nz = dims[2];
+
+    influence = spmeInfluenceFunction(box_dims, func.beta(), func.splineOrder(), nx, ny, nz);
+}
+
+/** Recalculate the mesh from scratch for the passed atoms. This discards
+    any pending change
+
+    \throw SireError::incompatible_error
+*/
+void CLJSPMEMesh::setAtoms(const CLJAtoms &atoms)
+{
+    this->buildInfluenceFunction();
+
+    mesh = QVector<double>( 2*nx*ny*nz, 0.0 );
+    SPMEComplex *m = reinterpret_cast<SPMEComplex*>(mesh.data());
+
+    spmeSpreadCharges(atoms, box_dims, func.splineOrder(), nx, ny, nz, 1.0, m);
+    spmeFFT3D(m, nx, ny, nz);
+
+    recip_nrg = spmeMeshEnergy(influence, m);
+
+    const double beta = func.beta();
+
+    excl_groups = spmeExclusionGroups(atoms);
+    excl_nrgs.clear();
+    excl_nrgs.reserve(excl_groups.count());
+
+    corr_nrg = spmeSelfEnergy(atoms, beta);
+
+    for (QHash< qint32,QVector<float> >::const_iterator it = excl_groups.constBegin();
+         it != excl_groups.constEnd();
+         ++it)
+    {
+        const double nrg = spmeExclusionEnergy(it.value(), box_dims, beta);
+        excl_nrgs.insert(it.key(), nrg);
+        corr_nrg += nrg;
+    }
+
+    this->revert();
+}
+
+/** Recalculate the mesh from scratch for the passed atoms. This discards
+    any pending change
+
+    \throw SireError::incompatible_error
+*/
+void CLJSPMEMesh::setAtoms(const CLJBoxes &atoms)
+{
+    this->setAtoms(atoms.atoms());
+}
+
+/** Return the long-range energy (reciprocal space, self and exclusion)
+    of the atoms in the mesh. This does not include any pending change */
+double CLJSPMEMesh::energy() const
+{
+    return recip_nrg + corr_nrg;
+}
+
+/** Return the reciprocal space energy of the atoms in the mesh */
+double CLJSPMEMesh::reciprocalEnergy() const
+{
+    return recip_nrg;
+}
+
+/** Return the sum of the self and exclusion energies of the atoms in the mesh */
+double CLJSPMEMesh::correctionEnergy() const
+{
+    return corr_nrg;
+}
+
+/** Calculate the change in the long-range energy caused by changing
+    the atoms in 'old_atoms' into the atoms in 'new_atoms'. The change
+    is held as pending until accept or revert are called. Calling this
+    function while a change is pending will replace that change.
+    The old and new atoms need only contain the atoms that have
+    changed, not all of the atoms of the changed molecules.
+
+    \throw SireError::invalid_state
+*/
+double CLJSPMEMesh::calculateDelta(const CLJAtoms &old_atoms, const CLJAtoms &new_atoms)
+{
+    if (this->isEmpty())
+        throw SireError::invalid_state( QObject::tr(
+                "You cannot calculate the change in energy using an empty CLJSPMEMesh. "
+                "Please call setAtoms first."), CODELOC );
+
+    const int npoints = nx*ny*nz;
+
+    delta_mesh = QVector<double>( 2*npoints, 0.0 );
+    SPMEComplex *dm = reinterpret_cast<SPMEComplex*>(delta_mesh.data());
+
+    //spread only the atoms that have changed onto the difference mesh
+    spmeSpreadCharges(new_atoms, box_dims, func.splineOrder(), nx, ny, nz, 1.0, dm);
+    spmeSpreadCharges(old_atoms, box_dims, func.splineOrder(), nx, ny, nz, -1.0, dm);
+    spmeFFT3D(dm, nx, ny, nz);
+
+    //the change in energy is sum_m inf(m) * ( |F(m) + dF(m)|^2 - |F(m)|^2 )
+    const SPMEComplex *m = reinterpret_cast<const SPMEComplex*>(mesh.constData());
+    const double *inf = influence.constData();
+
+    double delta = 0;
+
+    for (int i=0; i<npoints; ++i)
+    {
+        delta += inf[i] * ( 2.0 * std::real( std::conj(m[i]) * dm[i] ) + std::norm(dm[i]) );
+    }
+
+    delta_recip_nrg = delta;
+
+    const double beta = func.beta();
+
+    delta_corr_nrg = spmeSelfEnergy(new_atoms, beta) - spmeSelfEnergy(old_atoms, beta);
+
+    //update the groups of atoms of each changed ID, by removing the old
+    //atoms and adding the new atoms, and then recalculate their exclusion energies
+    const QHash< qint32,QVector<float> > old_groups = spmeExclusionGroups(old_atoms);
+    const QHash< qint32,QVector<float> > new_groups = spmeExclusionGroups(new_atoms);
+
+    delta_excl_groups.clear();
+    delta_excl_nrgs.clear();
+
+    for (QHash< qint32,QVector<float> >::const_iterator it = old_groups.constBegin();
+         it != old_groups.constEnd();
+         ++it)
+    {
+        QVector<float> group = excl_groups.value(it.key());
+        const QVector<float> &old_group = it.value();
+
+        for (int i=0; i<old_group.count(); i+=4)
+        {
+            for (int j=0; j<group.count(); j+=4)
+            {
+                if (group[j] == old_group[i] and group[j+1] == old_group[i+1] and
+                    group[j+2] == old_group[i+2] and group[j+3] == old_group[i+3])
+                {
+                    group.remove(j, 4);
+                    break;
+                }
+            }
+        }
+
+        delta_excl_groups.insert(it.key(), group);
+    }
+
+    for (QHash< qint32,QVector<float> >::const_iterator it = new_groups.constBegin();
+         it != new_groups.constEnd();
+         ++it)
+    {
+        if (not delta_excl_groups.contains(it.key()))
+            delta_excl_groups.insert(it.key(), excl_groups.value(it.key()));
+
+        delta_excl_groups[it.key()] += it.value();
+    }
+
+    for (QHash< qint32,QVector<float> >::const_iterator it = delta_excl_groups.constBegin();
+         it != delta_excl_groups.constEnd();
+         ++it)
+    {
+        const double nrg = spmeExclusionEnergy(it.value(), box_dims, beta);
+        delta_excl_nrgs.insert(it.key(), nrg);
+        delta_corr_nrg += nrg - excl_nrgs.value(it.key(), 0.0);
+    }
+
+    needs_accepting = true;
+
+    return delta_recip_nrg + delta_corr_nrg;
+}
+
+/** Calculate the change in the long-range energy caused by the passed delta.
+    The change is held as pending until accept or revert are called.
+
+    \throw SireError::invalid_state
+*/
+double CLJSPMEMesh::calculateDelta(const CLJDelta &delta)
+{
+    return this->calculateDelta(delta.oldAtoms(), delta.newAtoms());
+}
+
+/** Return whether or not there is a pending change that needs to be
+    accepted or reverted */
+bool CLJSPMEMesh::needsAccepting() const
+{
+    return needs_accepting;
+}
+
+/** Accept the pending change, adding it into the cached mesh */
+void CLJSPMEMesh::accept()
+{
+    if (not needs_accepting)
+        return;
+
+    double *m = mesh.data();
+    const double *dm = delta_mesh.constData();
+
+    for (int i=0; i<mesh.count(); ++i)
+    {
+        m[i] += dm[i];
+    }
+
+    recip_nrg += delta_recip_nrg;
+    corr_nrg += delta_corr_nrg;
+
+    for (QHash< qint32,QVector<float> >::const_iterator it = delta_excl_groups.constBegin();
+         it != delta_excl_groups.constEnd();
+         ++it)
+    {
+        if (it.value().isEmpty())
+        {
+            excl_groups.remove(it.key());
+            excl_nrgs.remove(it.key());
+        }
+        else
+        {
+            excl_groups.insert(it.key(), it.value());
+            excl_nrgs.insert(it.key(), delta_excl_nrgs.value(it.key()));
+        }
+    }
+
+    this->revert();
+}
+
+/** Revert (discard) the pending change */
+void CLJSPMEMesh::revert()
+{
+    delta_mesh = QVector<double>();
+    delta_recip_nrg = 0;
+    delta_corr_nrg = 0;
+    delta_excl_groups.clear();
+    delta_excl_nrgs.clear();
+    needs_accepting = false;
+}
@@ -0,0 +1,314 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#ifndef SIREMM_CLJSPMEFUNCTION_H
+#define SIREMM_CLJSPMEFUNCTION_H
+
+#include "cljfunction.h"
+#include "cljdelta.h"
+
+#include <QHash>
+
+SIRE_BEGIN_HEADER
+
+namespace SireMM
+{
+class CLJSPMEFunction;
+class CLJSPMEMesh;
+}
+
+QDataStream& operator<<(QDataStream&, const SireMM::CLJSPMEFunction&);
+QDataStream& operator>>(QDataStream&, SireMM::CLJSPMEFunction&);
+
+QDataStream& operator<<(QDataStream&, const SireMM::CLJSPMEMesh&);
+QDataStream& operator>>(QDataStream&, SireMM::CLJSPMEMesh&);
+
+namespace SireMM
+{
+
+/** This CLJFunction calculates the intermolecular coulomb and LJ energy of the passed
+    CLJAtoms using smooth particle mesh Ewald (SPME) electrostatics, as described
+    in Essmann et al., J. Chem. Phys., 103, 8577, 1995
+
+    The pair functions (used by CLJBoxes and CLJCalculator) evaluate only the
+    real-space part of the Ewald sum, i.e. the erfc-screened coulomb energy
+    plus the cutoff LJ energy. The long-range part of the electrostatic
+    energy cannot be decomposed into pairs of boxes, so is calculated
+    separately via longRangeEnergy. This sums the reciprocal space energy
+    (calculated by spreading the charges onto a mesh using cardinal B-splines
+    and transforming the mesh using a parallel 3D FFT), the self energy, and the
+    correction for the excluded pairs of atoms that have the same ID.
+    Use CLJSPMEMesh to hold the transformed mesh between Monte Carlo
+    moves, so that the reciprocal space energy can be updated incrementally.
+
+    SPME requires periodic boundary conditions, so the long-range energy
+    can only be calculated if this function uses a PeriodicBox space.
+
+    @author Christopher Woods
+*/
+class SIREMM_EXPORT CLJSPMEFunction
+        : public SireBase::ConcreteProperty<CLJSPMEFunction,CLJCutoffFunction>
+{
+
+friend QDataStream& ::operator<<(QDataStream&, const CLJSPMEFunction&);
+friend QDataStream& ::operator>>(QDataStream&, CLJSPMEFunction&);
+
+public:
+    CLJSPMEFunction();
+    CLJSPMEFunction(Length cutoff);
+    CLJSPMEFunction(Length coul_cutoff, Length lj_cutoff);
+
+    CLJSPMEFunction(const Space &space, Length cutoff);
+    CLJSPMEFunction(const Space &space, Length coul_cutoff, Length lj_cutoff);
+
+    CLJSPMEFunction(Length cutoff, COMBINING_RULES combining_rules);
+    CLJSPMEFunction(Length coul_cutoff, Length lj_cutoff, COMBINING_RULES combining_rules);
+
+    CLJSPMEFunction(const Space &space, COMBINING_RULES combining_rules);
+    CLJSPMEFunction(const Space &space, Length cutoff, COMBINING_RULES combining_rules);
+    CLJSPMEFunction(const Space &space, Length coul_cutoff, Length lj_cutoff,
+                    COMBINING_RULES combining_rules);
+
+    CLJSPMEFunction(const CLJSPMEFunction &other);
+
+    ~CLJSPMEFunction();
+
+    CLJSPMEFunction& operator=(const CLJSPMEFunction &other);
+
+    bool operator==(const CLJSPMEFunction &other) const;
+    bool operator!=(const CLJSPMEFunction &other) const;
+
+    static const char* typeName();
+    const char* what() const;
+
+    QString toString() const;
+
+    CLJSPMEFunction* clone() const;
+
+    Properties properties() const;
+    CLJFunctionPtr setProperty(const QString &name, const Property &value) const;
+    PropertyPtr property(const QString &name) const;
+    bool containsProperty(const QString &name) const;
+
+    void setEwaldPrecision(double precision);
+    double ewaldPrecision() const;
+
+    void setGridSpacing(Length spacing);
+    Length gridSpacing() const;
+
+    void setSplineOrder(int order);
+    int splineOrder() const;
+
+    double beta() const;
+
+    QVector<qint32> meshDimensions() const;
+
+    double reciprocalEnergy(const CLJAtoms &atoms) const;
+    double reciprocalEnergy(const CLJBoxes &atoms) const;
+
+    double selfEnergy(const CLJAtoms &atoms) const;
+    double selfEnergy(const CLJBoxes &atoms) const;
+
+    double exclusionEnergy(const CLJAtoms &atoms) const;
+    double exclusionEnergy(const CLJBoxes &atoms) const;
+
+    double longRangeEnergy(const CLJAtoms &atoms) const;
+    double longRangeEnergy(const CLJBoxes &atoms) const;
+
+    static CLJFunctionPtr defaultSPMEFunction();
+
+protected:
+    void calcVacEnergyAri(const CLJAtoms &atoms,
+                          double &cnrg, double &ljnrg) const;
+
+    void calcVacEnergyAri(const CLJAtoms &atoms0, const CLJAtoms &atoms1,
+                          double &cnrg, double &ljnrg, float min_distance) const;
+
+    void calcVacEnergyGeo(const CLJAtoms &atoms,
+                          double &cnrg, double &ljnrg) const;
+
+    void calcVacEnergyGeo(const CLJAtoms &atoms0, const CLJAtoms &atoms1,
+                          double &cnrg, double &ljnrg, float min_distance) const;
+
+    void calcBoxEnergyAri(const CLJAtoms &atoms, const Vector &box_dimensions,
+                          double &cnrg, double &ljnrg) const;
+
+    void calcBoxEnergyAri(const CLJAtoms &atoms0, const CLJAtoms &atoms1,
+                          const Vector &box_dimensions, double &cnrg, double &ljnrg,
+                          float min_distance) const;
+
+    void calcBoxEnergyGeo(const CLJAtoms &atoms, const Vector &box_dimensions,
+                          double &cnrg, double &ljnrg) const;
+
+    void calcBoxEnergyGeo(const CLJAtoms &atoms0, const CLJAtoms &atoms1,
+                          const Vector &box_dimensions, double &cnrg, double &ljnrg,
+                          float min_distance) const;
+
+private:
+    friend class CLJSPMEMesh;
+    friend class CLJEwald;
+
+    Vector boxDimensions() const;
+
+    /** The relative precision of the Ewald sum. This is used
+        together with the coulomb cutoff to obtain the Ewald
+        screening parameter (beta) */
+    double ewald_precision;
+
+    /** The maximum spacing between points on the reciprocal space mesh */
+    float grid_spacing;
+
+    /** The order of the cardinal B-splines used to spread the charges */
+    qint32 spline_order;
+};
+
+/** This class holds the Fourier-transformed charge mesh of a periodic
+    system, as calculated using a CLJSPMEFunction. This allows the
+    reciprocal space energy to be updated incrementally during Monte Carlo
+    moves. Only the charges of the atoms that have moved are spread onto
+    a difference mesh, whose transform is combined with the cached transform
+    of the whole system to give the change in reciprocal space energy.
+
+    The change in energy caused by a move is calculated using calculateDelta.
+    This must then be followed by either accept (which adds the change
+    into the cached mesh) or revert (which discards it). The mesh keeps
+    a copy of the charged atoms of each ID, so that the correction for the
+    excluded pairs of atoms is updated correctly even if the old and new
+    atoms only contain part of a molecule.
+
+    @author Christopher Woods
+*/
+class SIREMM_EXPORT CLJSPMEMesh
+{
+
+friend QDataStream& ::operator<<(QDataStream&, const CLJSPMEMesh&);
+friend QDataStream& ::operator>>(QDataStream&, CLJSPMEMesh&);
+
+public:
+    CLJSPMEMesh();
+    CLJSPMEMesh(const CLJSPMEFunction &function, const CLJAtoms &atoms);
+    CLJSPMEMesh(const CLJSPMEFunction &function, const CLJBoxes &atoms);
+
+    CLJSPMEMesh(const CLJSPMEMesh &other);
+
+    ~CLJSPMEMesh();
+
+    CLJSPMEMesh& operator=(const CLJSPMEMesh &other);
+
+    bool operator==(const CLJSPMEMesh &other) const;
+    bool operator!=(const CLJSPMEMesh &other) const;
+
+    static const char* typeName();
+    const char* what() const;
+
+    QString toString() const;
+
+    bool isEmpty() const;
+
+    const CLJSPMEFunction& function() const;
+
+    QVector<qint32> meshDimensions() const;
+
+    void setAtoms(const CLJAtoms &atoms);
+    void setAtoms(const CLJBoxes &atoms);
+
+    double energy() const;
+    double reciprocalEnergy() const;
+    double correctionEnergy() const;
+
+    double calculateDelta(const CLJAtoms &old_atoms, const CLJAtoms &new_atoms);
+    double calculateDelta(const CLJDelta &delta);
+
+    bool needsAccepting() const;
+
+    void accept();
+    void revert();
+
+private:
+    void buildInfluenceFunction();
+
+    /** The function used to define the Ewald sum */
+    CLJSPMEFunction func;
+
+    /** The dimensions of the periodic box */
+    Vector box_dims;
+
+    /** The number of mesh points along each dimension */
+    qint32 nx, ny, nz;
+
+    /** The influence function (including the B-spline moduli and
+        the 1 / (2 pi V) prefactor) for each point on the mesh */
+    QVector<double> influence;
+
+    /** The transformed charge mesh, stored as interleaved
+        real and imaginary parts */
+    QVector<double> mesh;
+
+    /** The transformed difference mesh of the pending change */
+    QVector<double> delta_mesh;
+
+    /** The reciprocal space energy of the cached mesh */
+    double recip_nrg;
+
+    /** The sum of the self and exclusion energies */
+    double corr_nrg;
+
+    /** The pending change in reciprocal space energy */
+    double delta_recip_nrg;
+
+    /** The pending change in self and exclusion energy */
+    double delta_corr_nrg;
+
+    /** The coordinates and charges (packed as x,y,z,q) of the
+        charged atoms of each ID, used to calculate the exclusion energy */
+    QHash< qint32,QVector<float> > excl_groups;
+
+    /** The exclusion energy of each ID */
+    QHash<qint32,double> excl_nrgs;
+
+    /** The new groups of atoms of each ID changed by the pending change */
+    QHash< qint32,QVector<float> > delta_excl_groups;
+
+    /** The new exclusion energies of each ID changed by the pending change */
+    QHash<qint32,double> delta_excl_nrgs;
+
+    /** Whether or not there is a pending change */
+    bool needs_accepting;
+};
+
+}
+
+Q_DECLARE_METATYPE( SireMM::CLJSPMEFunction )
+Q_DECLARE_METATYPE( SireMM::CLJSPMEMesh )
+
+SIRE_EXPOSE_CLASS( SireMM::CLJSPMEFunction )
+SIRE_EXPOSE_CLASS( SireMM::CLJSPMEMesh )
+
+SIRE_END_HEADER
+
+#endif
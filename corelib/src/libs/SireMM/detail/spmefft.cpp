@@ -0,0 +1,235 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "detail/spmefft.h"
+
+#include "SireMaths/constants.h"
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+#include <QVarLengthArray>
+
+#include <vector>
+
+namespace SireMM
+{
+namespace detail
+{
+
+    /** Return the smallest prime factor of 'n' */
+    static int spmeSmallestFactor(int n)
+    {
+        for (int f=2; f*f<=n; ++f)
+        {
+            if (n % f == 0)
+                return f;
+        }
+
+        return n;
+    }
+
+    /** Return the smallest number that is greater than or equal to 'n'
+        and that has no prime factors other than 2, 3 and 5. This
+        is used to choose mesh sizes that can be transformed efficiently */
+    int spmeMeshSize(int n)
+    {
+        if (n < 1)
+            n = 1;
+
+        while (true)
+        {
+            int m = n;
+
+            while (m % 2 == 0)
+                m /= 2;
+            while (m % 3 == 0)
+                m /= 3;
+            while (m % 5 == 0)
+                m /= 5;
+
+            if (m == 1)
+                return n;
+
+            n += 1;
+        }
+    }
+
+    /** Recursive mixed-radix FFT of the 'n' values in 'in' (separated by
+        'in_stride'), placing the result contiguously into 'out'. The passed
+        'twiddles' holds exp(-2 pi i j / N) for the full length N of the
+        transform, with 'twiddle_stride' equal to N / n */
+    static void spmeFFTLine(const SPMEComplex *in, int in_stride,
+                            SPMEComplex *out, int n,
+                            const SPMEComplex *twiddles, int twiddle_stride)
+    {
+        if (n == 1)
+        {
+            out[0] = in[0];
+            return;
+        }
+
+        const int f = spmeSmallestFactor(n);
+        const int m = n / f;
+
+        //transform each of the 'f' interleaved subsequences
+        for (int r=0; r<f; ++r)
+        {
+            spmeFFTLine(in + r*in_stride, in_stride*f, out + r*m, m,
+                        twiddles, twiddle_stride*f);
+        }
+
+        //now combine them using an f-point DFT (f is 2, 3 or 5 for
+        //the mesh sizes that we use)
+        QVarLengthArray<SPMEComplex,8> t(f);
+        QVarLengthArray<SPMEComplex,8> u(f);
+
+        for (int k=0; k<m; ++k)
+        {
+            for (int r=0; r<f; ++r)
+            {
+                t[r] = out[r*m + k] * twiddles[r*k*twiddle_stride];
+            }
+
+            for (int s=0; s<f; ++s)
+            {
+                SPMEComplex sum(0,0);
+
+                for (int r=0; r<f; ++r)
+                {
+                    sum += t[r] * twiddles[ ((r*s) % f) * m * twiddle_stride ];
+                }
+
+                u[s] = sum;
+            }
+
+            for (int s=0; s<f; ++s)
+            {
+                out[k + s*m] = u[s];
+            }
+        }
+    }
+
+    /** This is a private helper class that is used to perform the FFT
+        of all of the lines of the mesh along one dimension in parallel
+        using Intel TBB */
+    class SPMEFFTLines
+    {
+    public:
+        SPMEFFTLines() : mesh(0), twiddles(0), n(0), stride(0), block(0), block_stride(0)
+        {}
+
+        SPMEFFTLines(SPMEComplex *_mesh, const SPMEComplex *_twiddles,
+                     int _n, int _stride, int _block, int _block_stride)
+            : mesh(_mesh), twiddles(_twiddles), n(_n), stride(_stride),
+              block(_block), block_stride(_block_stride)
+        {}
+
+        ~SPMEFFTLines()
+        {}
+
+        void operator()(const tbb::blocked_range<int> &range) const
+        {
+            std::vector<SPMEComplex> buffer(n);
+
+            for (int l = range.begin(); l != range.end(); ++l)
+            {
+                //the lines are arranged as 'block' consecutive lines
+                //(separated by 1) repeated every 'block_stride' values
+                SPMEComplex *line = mesh + (l / block) * block_stride + (l % block);
+
+                spmeFFTLine(line, stride, &(buffer[0]), n, twiddles, 1);
+
+                for (int j=0; j<n; ++j)
+                {
+                    line[j*stride] = buffer[j];
+                }
+            }
+        }
+
+    private:
+        SPMEComplex *mesh;
+        const SPMEComplex *twiddles;
+        int n;
+        int stride;
+        int block;
+        int block_stride;
+    };
+
+    /** Perform an in-place 3D FFT of the passed mesh, which has dimensions
+        nx*ny*nz (with z changing fastest) */
+    void spmeFFT3D(SPMEComplex *mesh, int nx, int ny, int nz)
+    {
+        const int dims[3] = { nx, ny, nz };
+        const int npoints = nx*ny*nz;
+
+        for (int d=0; d<3; ++d)
+        {
+            const int n = dims[d];
+
+            if (n == 1)
+                continue;
+
+            std::vector<SPMEComplex> twiddles(n);
+
+            for (int j=0; j<n; ++j)
+            {
+                twiddles[j] = std::polar(1.0, -2.0 * SireMaths::pi * j / n);
+            }
+
+            int stride, block, block_stride;
+
+            if (d == 2)
+            {
+                //contiguous lines along z
+                stride = 1;
+                block = 1;
+                block_stride = nz;
+            }
+            else if (d == 1)
+            {
+                //lines along y, with nz lines per x-plane
+                stride = nz;
+                block = nz;
+                block_stride = ny*nz;
+            }
+            else
+            {
+                //lines along x, with ny*nz lines in the x=0 plane
+                stride = ny*nz;
+                block = ny*nz;
+                block_stride = ny*nz;
+            }
+
+            SPMEFFTLines helper(mesh, &(twiddles[0]), n, stride, block, block_stride);
+            tbb::parallel_for(tbb::blocked_range<int>(0, npoints/n), helper);
+        }
+    }
+
+} // end of namespace detail
+} // end of namespace SireMM
@@ -0,0 +1,64 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#ifndef SIREMM_DETAIL_SPMEFFT_H
+#define SIREMM_DETAIL_SPMEFFT_H
+
+#include "sireglobal.h"
+
+#include <complex>
+
+SIRE_BEGIN_HEADER
+
+namespace SireMM
+{
+namespace detail
+{
+
+typedef std::complex<double> SPMEComplex;
+
+/** Perform an in-place, unnormalised forward 3D FFT of the passed mesh,
+    which has dimensions nx*ny*nz (with z changing fastest). This uses
+    a recursive mixed-radix transform of each line of the mesh, with the
+    lines along each dimension transformed in parallel. The transform
+    is fastest for dimensions that have no prime factors other than
+    2, 3 and 5, but is correct for any dimension. This is used by
+    CLJSPMEFunction and CLJSPMEMesh */
+SIREMM_EXPORT void spmeFFT3D(SPMEComplex *mesh, int nx, int ny, int nz);
+
+/** Return the smallest number that is greater than or equal to 'n'
+    and that has no prime factors other than 2, 3 and 5. This
+    is used to choose mesh sizes that can be transformed efficiently */
+SIREMM_EXPORT int spmeMeshSize(int n);
+
+} // end of namespace detail
+} // end of namespace SireMM
+
+SIRE_END_HEADER
+
+#endif
@@ -0,0 +1,360 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "gridcache.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QMutex>
+
+#include <QDebug>
+
+#include <cstring>
+#include <limits>
+
+using namespace SireMM;
+
+namespace SireMM
+{
+    namespace detail
+    {
+        /** The global settings of the grid cache */
+        class GridCacheData
+        {
+        public:
+            GridCacheData()
+            {
+                directory = QString::fromLocal8Bit( qgetenv("SIRE_GRID_CACHE") );
+            }
+            
+            ~GridCacheData()
+            {}
+            
+            /** Mutex to protect access to the settings */
+            QMutex mutex;
+            
+            /** The directory containing the cached grids */
+            QString directory;
+        };
+        
+        /** The header at the start of each cached grid file. This is
+            followed by 'ngrids' quint64 values giving the number of
+            points in each grid, and then the grid values themselves */
+        struct GridCacheHeader
+        {
+            /** Magic string identifying the file ("SIREGRID") */
+            char magic[8];
+            
+            /** The version of the file format */
+            quint32 version;
+            
+            /** The size in bytes of each grid value (4 or 8) */
+            quint32 value_size;
+            
+            /** The number of grids in the file */
+            quint32 ngrids;
+            
+            /** Value used to check that the file was written on
+                a machine with the same byte order */
+            quint32 byte_order;
+        };
+    }
+}
+
+using namespace SireMM::detail;
+
+Q_GLOBAL_STATIC( GridCacheData, cacheData );
+
+static const char GRID_CACHE_MAGIC[8] = { 'S', 'I', 'R', 'E', 'G', 'R', 'I', 'D' };
+static const quint32 GRID_CACHE_VERSION = 1;
+static const quint32 GRID_CACHE_BYTE_ORDER = 0x01020304;
+
+/** Return the full path to the file for the grid with the passed key,
+    or an empty string if the cache is disabled */
+static QString getFilename(const QString &key)
+{
+    QString dir = GridCache::cacheDirectory();
+    
+    if (dir.isEmpty() or key.isEmpty())
+        return QString();
+    
+    return QDir(dir).filePath( QString("%1.grid").arg(key) );
+}
+
+/** Internal function used to read the grids of type T from the file
+    for the passed key. This memory-maps the file and copies the 
+    grids from the mapped memory */
+template<class T>
+static bool loadGrids(const QString &key, QVector< QVector<T> > &grids)
+{
+    const QString filename = getFilename(key);
+    
+    if (filename.isEmpty())
+        return false;
+    
+    QFile f(filename);
+    
+    if (not f.exists())
+        return false;
+    
+    if (not f.open(QIODevice::ReadOnly))
+        return false;
+    
+    const qint64 size = f.size();
+    
+    if (size < qint64(sizeof(GridCacheHeader)))
+        return false;
+    
+    uchar *mem = f.map(0, size);
+    
+    if (mem == 0)
+        return false;
+    
+    bool ok = false;
+    
+    GridCacheHeader header;
+    std::memcpy(&header, mem, sizeof(GridCacheHeader));
+    
+    if (std::memcmp(header.magic, GRID_CACHE_MAGIC, 8) == 0 and
+        header.version == GRID_CACHE_VERSION and
+        header.value_size == sizeof(T) and
+        header.byte_order == GRID_CACHE_BYTE_ORDER)
+    {
+        //check that each size is bounded by the size of the file before
+        //using it, so that a corrupt file cannot cause an overflow
+        qint64 remaining = size - qint64(sizeof(GridCacheHeader));
+        
+        if (header.ngrids <= quint64(remaining) / sizeof(quint64) and
+            header.ngrids <= quint32(std::numeric_limits<int>::max()))
+        {
+            const int ngrids = header.ngrids;
+            
+            QVector<quint64> npoints(ngrids);
+            std::memcpy(npoints.data(), mem + sizeof(GridCacheHeader),
+                        ngrids * sizeof(quint64));
+            
+            qint64 offset = sizeof(GridCacheHeader) + ngrids * sizeof(quint64);
+            remaining = size - offset;
+            
+            bool valid = true;
+            
+            for (int i=0; i<ngrids; ++i)
+            {
+                if (npoints[i] > quint64(remaining) / sizeof(T) or
+                    npoints[i] > quint64(std::numeric_limits<int>::max()))
+                {
+                    valid = false;
+                    break;
+                }
+                
+                remaining -= qint64(npoints[i] * sizeof(T));
+            }
+            
+            if (valid and remaining == 0)
+            {
+                QVector< QVector<T> > loaded(ngrids);
+                
+                for (int i=0; i<ngrids; ++i)
+                {
+                    const int n = int(npoints[i]);
+                    
+                    QVector<T> grid(n);
+                    
+                    if (n > 0)
+                        std::memcpy(grid.data(), mem + offset, n * sizeof(T));
+                    
+                    offset += n * sizeof(T);
+                    loaded[i] = grid;
+                }
+                
+                grids = loaded;
+                ok = true;
+            }
+        }
+    }
+    
+    f.unmap(mem);
+    
+    if (not ok)
+        qDebug() << "Ignoring invalid cached grid file" << filename;
+    
+    return ok;
+}
+
+/** Internal function used to write the passed grids of type T to the 
+    file for the passed key. The file is written atomically (to a temporary
+    file that is then renamed), so that other processes will never
+    see a partially-written grid */
+template<class T>
+static bool saveGrids(const QString &key, const QVector< QVector<T> > &grids)
+{
+    const QString filename = getFilename(key);
+    
+    if (filename.isEmpty())
+        return false;
+    
+    QDir().mkpath( QFileInfo(filename).absolutePath() );
+    
+    QSaveFile f(filename);
+    
+    if (not f.open(QIODevice::WriteOnly))
+    {
+        qDebug() << "Cannot write the cached grid file" << filename;
+        return false;
+    }
+    
+    GridCacheHeader header;
+    std::memcpy(header.magic, GRID_CACHE_MAGIC, 8);
+    header.version = GRID_CACHE_VERSION;
+    header.value_size = sizeof(T);
+    header.ngrids = grids.count();
+    header.byte_order = GRID_CACHE_BYTE_ORDER;
+    
+    f.write( (const char*)(&header), sizeof(GridCacheHeader) );
+    
+    for (int i=0; i<grids.count(); ++i)
+    {
+        quint64 npoints = grids.at(i).count();
+        f.write( (const char*)(&npoints), sizeof(quint64) );
+    }
+    
+    for (int i=0; i<grids.count(); ++i)
+    {
+        const QVector<T> &grid = grids.at(i);
+        f.write( (const char*)(grid.constData()), grid.count() * sizeof(T) );
+    }
+    
+    return f.commit();
+}
+
+/** Return the directory used to hold the cached grids. This is
+    empty if the cache is disabled */
+QString GridCache::cacheDirectory()
+{
+    GridCacheData *d = cacheData();
+    
+    QMutexLocker lkr(&(d->mutex));
+    return d->directory;
+}
+
+/** Set the directory used to hold the cached grids. Pass an empty
+    string to disable the cache */
+void GridCache::setCacheDirectory(const QString &directory)
+{
+    GridCacheData *d = cacheData();
+    
+    QMutexLocker lkr(&(d->mutex));
+    
+    if (directory.isEmpty())
+        d->directory = QString();
+    else
+        d->directory = QFileInfo(directory).absoluteFilePath();
+}
+
+/** Return whether or not the grid cache is enabled */
+bool GridCache::isEnabled()
+{
+    return not GridCache::cacheDirectory().isEmpty();
+}
+
+/** Create the key for a grid from the passed data. The data
+    should contain everything that was used to build the grid */
+QString GridCache::createKey(const QByteArray &data)
+{
+    return QString::fromLatin1( QCryptographicHash::hash(data, 
+                                        QCryptographicHash::Sha1).toHex() );
+}
+
+/** Return whether or not the cache contains a grid with the passed key */
+bool GridCache::contains(const QString &key)
+{
+    const QString filename = getFilename(key);
+    
+    if (filename.isEmpty())
+        return false;
+    else
+        return QFile::exists(filename);
+}
+
+/** Load the grid with the passed key into 'grid'. This returns
+    whether or not the grid was loaded */
+bool GridCache::load(const QString &key, QVector<float> &grid)
+{
+    QVector< QVector<float> > grids;
+    
+    if (loadGrids<float>(key, grids) and grids.count() == 1)
+    {
+        grid = grids.at(0);
+        return true;
+    }
+    else
+        return false;
+}
+
+/** Load the set of grids with the passed key into 'grids'. This
+    returns whether or not the grids were loaded */
+bool GridCache::load(const QString &key, QVector< QVector<double> > &grids)
+{
+    return loadGrids<double>(key, grids);
+}
+
+/** Save the passed grid into the cache using the passed key. This
+    returns whether or not the grid was saved */
+bool GridCache::save(const QString &key, const QVector<float> &grid)
+{
+    QVector< QVector<float> > grids;
+    grids.append(grid);
+    
+    return saveGrids<float>(key, grids);
+}
+
+/** Save the passed set of grids into the cache using the passed key.
+    This returns whether or not the grids were saved */
+bool GridCache::save(const QString &key, const QVector< QVector<double> > &grids)
+{
+    return saveGrids<double>(key, grids);
+}
+
+/** Remove all of the grids from the cache */
+void GridCache::clear()
+{
+    const QString dir = GridCache::cacheDirectory();
+    
+    if (dir.isEmpty())
+        return;
+    
+    QDir d(dir);
+    
+    foreach (const QString &filename, d.entryList(QStringList("*.grid"), QDir::Files))
+    {
+        d.remove(filename);
+    }
+}
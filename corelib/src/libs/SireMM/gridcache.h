@@ -0,0 +1,90 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#ifndef SIREMM_GRIDCACHE_H
+#define SIREMM_GRIDCACHE_H
+
+#include "sireglobal.h"
+
+#include <QString>
+#include <QVector>
+#include <QByteArray>
+
+SIRE_BEGIN_HEADER
+
+namespace SireMM
+{
+
+/** This class provides a persistent, on-disk cache of the potential
+    grids built by CLJGrid and GridFF2. Building a grid for a large set
+    of fixed atoms (e.g. a protein) is expensive, and the same grid is
+    often rebuilt by many processes (e.g. when screening many ligands
+    against the same receptor). The grids are stored in a cache directory,
+    keyed by a hash of everything used to build them (the coordinates and 
+    parameters of the atoms, the settings of the energy function and the
+    dimensions of the grid), so that a grid only needs to be built once.
+
+    Each grid is written to its own binary file, with a small header
+    followed by the raw grid values, so that it can be memory-mapped
+    when it is read back in. Files are written atomically, so the cache
+    can be shared between processes that are running at the same time.
+
+    The cache is disabled by default. It is enabled by setting the
+    cache directory, either using GridCache::setCacheDirectory, or
+    via the SIRE_GRID_CACHE environment variable.
+
+    @author Christopher Woods
+*/
+class SIREMM_EXPORT GridCache
+{
+public:
+    static QString cacheDirectory();
+    static void setCacheDirectory(const QString &directory);
+
+    static bool isEnabled();
+
+    static QString createKey(const QByteArray &data);
+
+    static bool contains(const QString &key);
+
+    static bool load(const QString &key, QVector<float> &grid);
+    static bool load(const QString &key, QVector< QVector<double> > &grids);
+
+    static bool save(const QString &key, const QVector<float> &grid);
+    static bool save(const QString &key, const QVector< QVector<double> > &grids);
+
+    static void clear();
+};
+
+}
+
+SIRE_EXPOSE_CLASS( SireMM::GridCache )
+
+SIRE_END_HEADER
+
+#endif
@@ -28,6 +28,7 @@
 
 #include "gridff2.h"
 #include "cljpotential.h"
+#include "gridcache.h"
 
 #include "SireMol/atomcoords.h"
 #include "SireMol/atomcharges.h"
@@ -39,6 +40,8 @@
 
 #include "SireUnits/units.h"
 
+#include "SireBase/parallel.h"
+
 #include "SireStream/datastream.h"
 #include "SireStream/shareddatastream.h"
 #include "SireStream/streamdata.hpp"
@@ -66,7 +69,7 @@ static const RegisterMetaType<GridFF2> r_gridff2;
 
 QDataStream SIREMM_EXPORT &operator<<(QDataStream &ds, const GridFF2 &gridff2)
 {
-    writeHeader(ds, r_gridff2, 1);
+    writeHeader(ds, r_gridff2, 2);
     
     SharedDataStream sds(ds);
     
@@ -107,6 +110,8 @@ QDataStream SIREMM_EXPORT &operator<<(QDataStream &ds, const GridFF2 &gridff2)
 
     sds << used_ljs;
     
+    sds << gridff2.use_lj_grids << gridff2.use_tricubic;
+    
     sds << static_cast<const InterGroupCLJFF&>(gridff2);
     
     return ds;
@@ -116,7 +121,7 @@ QDataStream SIREMM_EXPORT &operator>>(QDataStream &ds, GridFF2 &gridff2)
 {
     VersionID v = readHeader(ds, r_gridff2);
 
-    if (v == 1)
+    if (v == 1 or v == 2)
     {
         SharedDataStream sds(ds);
         
@@ -187,12 +192,19 @@ QDataStream SIREMM_EXPORT &operator>>(QDataStream &ds, GridFF2 &gridff2)
         gridff2.fixedatoms_params = fixedatoms_params;
         gridff2.closemols_params = closemols_params;
         
+        if (v == 2)
+        {
+            //the LJ grids are not streamed, so will be rebuilt the next
+            //time that the energy is calculated
+            sds >> gridff2.use_lj_grids >> gridff2.use_tricubic;
+        }
+        
         sds >> static_cast<InterGroupCLJFF&>(gridff2);
 
         gridff2.need_update_ljpairs = true;
     }
     else
-        throw version_error(v, "1", r_gridff2, CODELOC);
+        throw version_error(v, "1,2", r_gridff2, CODELOC);
         
     return ds;
 }
@@ -201,7 +213,8 @@ QDataStream SIREMM_EXPORT &operator>>(QDataStream &ds, GridFF2 &gridff2)
 GridFF2::GridFF2() 
        : ConcreteProperty<GridFF2,InterGroupCLJFF>(),
          buffer_size(2.5), grid_spacing(1.0), 
-         coul_cutoff(50), lj_cutoff(7.5)
+         coul_cutoff(50), lj_cutoff(7.5),
+         use_lj_grids(false), use_tricubic(false)
 {
     this->setSwitchingFunction(NoCutoff());
 }
@@ -210,7 +223,8 @@ GridFF2::GridFF2()
 GridFF2::GridFF2(const QString &name) 
        : ConcreteProperty<GridFF2,InterGroupCLJFF>(name),
          buffer_size(2.5), grid_spacing(1.0), 
-         coul_cutoff(50), lj_cutoff(7.5)
+         coul_cutoff(50), lj_cutoff(7.5),
+         use_lj_grids(false), use_tricubic(false)
 {
     this->setSwitchingFunction(NoCutoff());
 }
@@ -223,11 +237,16 @@ GridFF2::GridFF2(const GridFF2 &other)
          coul_cutoff(other.coul_cutoff), lj_cutoff(other.lj_cutoff),
          dimx(other.dimx), dimy(other.dimy), dimz(other.dimz),
          gridpot(other.gridpot),
+         ljgrids(other.ljgrids), ljgrid_ids(other.ljgrid_ids),
          fixedatoms_coords(other.fixedatoms_coords),
          fixedatoms_params(other.fixedatoms_params),
          closemols_coords(other.closemols_coords),
          closemols_params(other.closemols_params),
-         oldnrgs(other.oldnrgs)
+         close_mols_x(other.close_mols_x), close_mols_y(other.close_mols_y),
+         close_mols_z(other.close_mols_z), close_mols_q(other.close_mols_q),
+         close_mols_sig(other.close_mols_sig), close_mols_eps(other.close_mols_eps),
+         oldnrgs(other.oldnrgs),
+         use_lj_grids(other.use_lj_grids), use_tricubic(other.use_tricubic)
 {
     this->setSwitchingFunction(NoCutoff());
 }
@@ -260,11 +279,21 @@ GridFF2& GridFF2::operator=(const GridFF2 &other)
         dimy = other.dimy;
         dimz = other.dimz;
         gridpot = other.gridpot;
+        ljgrids = other.ljgrids;
+        ljgrid_ids = other.ljgrid_ids;
         fixedatoms_coords = other.fixedatoms_coords;
         fixedatoms_params = other.fixedatoms_params;
         closemols_coords = other.closemols_coords;
         closemols_params = other.closemols_params;
+        close_mols_x = other.close_mols_x;
+        close_mols_y = other.close_mols_y;
+        close_mols_z = other.close_mols_z;
+        close_mols_q = other.close_mols_q;
+        close_mols_sig = other.close_mols_sig;
+        close_mols_eps = other.close_mols_eps;
         oldnrgs = other.oldnrgs;
+        use_lj_grids = other.use_lj_grids;
+        use_tricubic = other.use_tricubic;
     
         InterGroupCLJFF::operator=(other);
     }
@@ -277,6 +306,8 @@ bool GridFF2::operator==(const GridFF2 &other) const
 {
     return buffer_size == other.buffer_size and
            grid_spacing == other.grid_spacing and
+           use_lj_grids == other.use_lj_grids and
+           use_tricubic == other.use_tricubic and
            InterGroupCLJFF::operator==(other);
 }
 
@@ -517,6 +548,63 @@ bool GridFF2::setReactionFieldDielectric(double dielectric)
     return false;
 }
 
+/** Turn on or off the use of grids for the LJ energy. If this is on,
+    then a grid of LJ potentials is built for each distinct LJ parameter
+    used by the atoms in group 1, and the coulomb and LJ energies
+    of group 1 molecules are calculated only by interpolating from
+    the grids. This means that the cost of moving a group 1 molecule
+    depends only on its number of atoms, rather than on the number of
+    fixed atoms close to the grid. As the LJ potential is very steep,
+    this should be used with a small grid spacing, and ideally with
+    tricubic interpolation */
+bool GridFF2::setUseLJGrids(bool on)
+{
+    if (use_lj_grids != on)
+    {
+        use_lj_grids = on;
+        this->mustNowRecalculateFromScratch();
+        return true;
+    }
+    else
+        return false;
+}
+
+/** Turn on or off the use of tricubic interpolation of the grids.
+    This is more accurate than the default trilinear interpolation,
+    but needs 64 rather than 8 grid points for each atom */
+bool GridFF2::setUseTricubicInterpolation(bool on)
+{
+    if (use_tricubic != on)
+    {
+        use_tricubic = on;
+        this->mustNowRecalculateFromScratch();
+        return true;
+    }
+    else
+        return false;
+}
+
+/** Return whether or not grids are used for the LJ energy */
+bool GridFF2::usesLJGrids() const
+{
+    return use_lj_grids;
+}
+
+/** Return whether or not tricubic interpolation is used to 
+    interpolate the grids */
+bool GridFF2::usesTricubicInterpolation() const
+{
+    return use_tricubic;
+}
+
+/** Return the number of LJ grids (one for each distinct LJ parameter
+    of the atoms in group 1). This is zero if LJ grids are not used,
+    or if the grids have not yet been built */
+int GridFF2::nLJGrids() const
+{
+    return ljgrids.count();
+}
+
 /** Return the buffer size used when building grids */
 SireUnits::Dimension::Length GridFF2::buffer() const
 {
@@ -761,6 +849,133 @@ void GridFF2::addToGrid(const QVector<float> &vx,
     }
 }
 
+/** The maximum value of any point in the LJ grids. This prevents
+    the grids from holding infinities for points that lie on top
+    of atoms */
+static const double MAX_LJ_GRID_NRG = 1000.0;
+
+/** Function used to build the LJ grids from the passed points. There is
+    one grid for each LJ parameter in 'ljgrid_ids', holding the LJ 
+    energy of an atom with that parameter at each grid point */
+void GridFF2::addToLJGrids(const QVector<float> &vx,
+                           const QVector<float> &vy,
+                           const QVector<float> &vz,
+                           const QVector<float> &vsig,
+                           const QVector<float> &veps)
+{
+    const int ngrids = ljgrid_ids.count();
+
+    ljgrids = QVector< QVector<double> >(ngrids);
+    
+    if (ngrids == 0)
+        return;
+
+    //get the sigma and square root of epsilon for each grid
+    QVector<float> grid_sig(ngrids);
+    QVector<float> grid_eps(ngrids);
+    
+    LJParameterDB::lock();
+    for (QHash<quint32,qint32>::const_iterator it = ljgrid_ids.constBegin();
+         it != ljgrid_ids.constEnd();
+         ++it)
+    {
+        const LJParameter lj = LJParameterDB::_locked_getLJParameter(it.key());
+        grid_sig[it.value()] = lj.sigma();
+        grid_eps[it.value()] = std::sqrt(lj.epsilon());
+    }
+    LJParameterDB::unlock();
+
+    const QVector<MultiFloat> mx = MultiFloat::fromArray(vx);
+    const QVector<MultiFloat> my = MultiFloat::fromArray(vy);
+    const QVector<MultiFloat> mz = MultiFloat::fromArray(vz);
+    const QVector<MultiFloat> msig = MultiFloat::fromArray(vsig);
+    QVector<MultiFloat> meps = MultiFloat::fromArray(veps);
+
+    for (int i=0; i<meps.count(); ++i)
+    {
+        meps[i] = meps[i].sqrt();
+    }
+
+    const Vector minpoint = gridbox.minCoords();
+
+    const int npts = dimx*dimy*dimz;
+    const int nvecs = mx.count();
+
+    const MultiFloat *ax = mx.constData();
+    const MultiFloat *ay = my.constData();
+    const MultiFloat *az = mz.constData();
+    const MultiFloat *asig = msig.constData();
+    const MultiFloat *aeps = meps.constData();
+
+    const MultiFloat Rlj(lj_cutoff);
+    const MultiFloat half(0.5);
+    
+    //minimum distance, used to prevent division by zero for 
+    //grid points that lie on top of atoms
+    const MultiFloat min_r(0.01);
+
+    for (int igrid=0; igrid<ngrids; ++igrid)
+    {
+        QVector<double> ljpot(npts, 0.0);
+        double *pot = ljpot.data();
+        
+        const MultiFloat sig( grid_sig.at(igrid) );
+        const MultiFloat eps( grid_eps.at(igrid) );
+    
+        //loop over each grid point in parallel
+        tbb::parallel_for( tbb::blocked_range<int>(0,npts),
+                           [&](const tbb::blocked_range<int> &range)
+        {
+            MultiFloat r, tmp, sig2_over_r2, sig6_over_r6;
+            MultiFloat gx, gy, gz;
+            MultiDouble ljnrg;
+        
+            for (int ipt=range.begin(); ipt<range.end(); ++ipt)
+            {
+                getGridPoint(ipt, minpoint, dimx, dimy, dimz, grid_spacing, gx, gy, gz);
+                
+                ljnrg = 0;
+                
+                for (int ivec=0; ivec<nvecs; ++ivec)
+                {
+                    //calculate the distance between the atom and grid point (r)
+                    tmp = ax[ivec] - gx;
+                    r = tmp * tmp;
+                    tmp = ay[ivec] - gy;
+                    r.multiplyAdd(tmp, tmp);
+                    tmp = az[ivec] - gz;
+                    r.multiplyAdd(tmp, tmp);
+                    r = r.sqrt();
+                    r = r.max(min_r);
+                    
+                    //arithmetic combining rules
+                    tmp = sig + asig[ivec];
+                    tmp *= half;
+                    
+                    sig2_over_r2 = tmp * r.reciprocal();
+                    sig2_over_r2 = sig2_over_r2*sig2_over_r2;
+                    sig6_over_r6 = sig2_over_r2*sig2_over_r2;
+                    sig6_over_r6 = sig6_over_r6*sig2_over_r2;
+
+                    tmp = sig6_over_r6 * sig6_over_r6;
+                    tmp -= sig6_over_r6;
+                    tmp *= eps;
+                    tmp *= aeps[ivec];
+                    
+                    //apply the cutoff - compare r against Rlj. This will
+                    //return 1 if r is less than Rlj, or 0 otherwise. Logical
+                    //and will then remove all energies where r >= Rlj
+                    ljnrg += tmp.logicalAnd( r.compareLess(Rlj) );
+                }
+                
+                pot[ipt] = std::min( 4.0 * ljnrg.sum(), MAX_LJ_GRID_NRG );
+            }
+        });
+        
+        ljgrids[igrid] = ljpot;
+    }
+}
+
 inline double getDist(double p, double minp, double maxp)
 {
     if (p < minp)
@@ -959,7 +1174,6 @@ void GridFF2::rebuildGrid()
     far_mols_q.reserve(1024);
 
     int atomcount = 0;
-    int gridcount = 0;
 
     const double image_cutoff = coul_cutoff + gridbox.halfExtents().length();
     
@@ -1003,29 +1217,10 @@ void GridFF2::rebuildGrid()
                         far_mols_y.append(c.y());
                         far_mols_z.append(c.z());
                         far_mols_q.append(params.reduced_charge);
-                    
-                        if (far_mols_x.count() > 1023)
-                        {
-                            addToGrid(far_mols_x, far_mols_y, far_mols_z, far_mols_q);
-                            gridcount += far_mols_x.count();
-                            far_mols_x.clear();
-                            far_mols_y.clear();
-                            far_mols_z.clear();
-                            far_mols_q.clear();
-                            //qDebug() << "Added" << i+1 << "of" << fixedatoms_coords.count()
-                            //         << "fixed atoms to the grid...";
-                        }
                     }
                 }
             }
         }
-        
-        addToGrid(far_mols_x, far_mols_y, far_mols_z, far_mols_q);
-        gridcount += far_mols_x.count();
-        far_mols_x.clear();
-        far_mols_y.clear();
-        far_mols_z.clear();
-        far_mols_q.clear();
     }
     
     if (not cljmols.isEmpty())
@@ -1060,7 +1255,7 @@ void GridFF2::rebuildGrid()
                     if (params.reduced_charge == 0 and params.ljid == 0)
                         continue;
 
-                    QVector<Vector> coords = spce.getImagesWithin(fixedatoms_coords.constData()[i],
+                    QVector<Vector> coords = spce.getImagesWithin(coordgroup.constData()[i],
                                                                   grid_center, image_cutoff);
             
                     for (int j=0; j<coords.count(); ++j)
@@ -1091,31 +1286,155 @@ void GridFF2::rebuildGrid()
                                 far_mols_y.append(c.y());
                                 far_mols_z.append(c.z());
                                 far_mols_q.append(params.reduced_charge);
-                    
-                                if (far_mols_x.count() > 1023)
-                                {
-                                    addToGrid(far_mols_x, far_mols_y, far_mols_z, far_mols_q);
-                                    gridcount += far_mols_x.count();
-                                    far_mols_x.clear();
-                                    far_mols_y.clear();
-                                    far_mols_z.clear();
-                                    far_mols_q.clear();
-                                }
                             }
                         }
                     }
                 }
             }
         }
-        
-        addToGrid(far_mols_x, far_mols_y, far_mols_z, far_mols_q);
-        gridcount += far_mols_x.count();
-        far_mols_x.clear();
-        far_mols_y.clear();
-        far_mols_z.clear();
-        far_mols_q.clear();
     }
  
+    if (use_lj_grids)
+    {
+        //find all of the LJ parameters used by the atoms in group 0
+        ljgrid_ids.clear();
+        
+        for (ChunkedVector<CLJMolecule>::const_iterator
+                                    it = mols[0].moleculesByIndex().constBegin();
+             it != mols[0].moleculesByIndex().constEnd();
+             ++it)
+        {
+            const CLJParameters::Array *params_array
+                                = (*it).parameters().atomicParameters().constData();
+        
+            for (int igroup=0; igroup<(*it).coordinates().count(); ++igroup)
+            {
+                const CLJParameters::Array &params = params_array[igroup];
+            
+                for (int i=0; i<params.count(); ++i)
+                {
+                    const quint32 ljid = params.constData()[i].ljid;
+                
+                    if (ljid != 0 and not ljgrid_ids.contains(ljid))
+                        ljgrid_ids.insert(ljid, ljgrid_ids.count());
+                }
+            }
+        }
+    
+        //the coulomb potential of the close atoms is also added onto the grid
+        for (int i=0; i<cmols_q.count(); ++i)
+        {
+            if (cmols_q.at(i) != 0)
+            {
+                far_mols_x.append(cmols_x.at(i));
+                far_mols_y.append(cmols_y.at(i));
+                far_mols_z.append(cmols_z.at(i));
+                far_mols_q.append(cmols_q.at(i));
+            }
+        }
+    }
+    
+    //see if these grids have already been calculated and saved in the
+    //grid cache. The key is a hash of everything that is used to build the grids
+    QString cache_key;
+    bool loaded_grids = false;
+    
+    if (GridCache::isEnabled())
+    {
+        QByteArray data;
+        {
+            QDataStream ds(&data, QIODevice::WriteOnly);
+            
+            ds << QString("GridFF2")
+               << gridbox.minCoords().x() << gridbox.minCoords().y() << gridbox.minCoords().z()
+               << dimx << dimy << dimz << grid_spacing
+               << coul_cutoff << lj_cutoff
+               << shiftElectrostatics() << useReactionField() << reactionFieldDielectric()
+               << use_lj_grids
+               << far_mols_x << far_mols_y << far_mols_z << far_mols_q;
+            
+            if (use_lj_grids)
+            {
+                //LJ IDs are only valid in this process, so use the LJ parameters
+                QVector<double> grid_ljs( 2*ljgrid_ids.count() );
+                
+                for (QHash<quint32,qint32>::const_iterator it = ljgrid_ids.constBegin();
+                     it != ljgrid_ids.constEnd();
+                     ++it)
+                {
+                    const LJParameter lj = LJParameterDB::getLJParameter(it.key());
+                    grid_ljs[2*it.value()] = lj.sigma();
+                    grid_ljs[2*it.value()+1] = lj.epsilon();
+                }
+                
+                ds << grid_ljs << cmols_x << cmols_y << cmols_z << cmols_sig << cmols_eps;
+            }
+        }
+        
+        cache_key = GridCache::createKey(data);
+        
+        QVector< QVector<double> > grids;
+        
+        if (GridCache::load(cache_key, grids))
+        {
+            const int npts = dimx*dimy*dimz;
+        
+            loaded_grids = (grids.count() == 1 + (use_lj_grids ? ljgrid_ids.count() : 0));
+            
+            for (int i=0; i<grids.count(); ++i)
+            {
+                loaded_grids = loaded_grids and (grids.at(i).count() == npts);
+            }
+            
+            if (loaded_grids)
+            {
+                gridpot = grids.at(0);
+                ljgrids = grids.mid(1);
+            }
+        }
+    }
+    
+    if (not loaded_grids)
+    {
+        //add the potentials of the far atoms onto the grid, 1024 atoms at a time
+        for (int i=0; i<far_mols_x.count(); i += 1024)
+        {
+            addToGrid(far_mols_x.mid(i,1024), far_mols_y.mid(i,1024),
+                      far_mols_z.mid(i,1024), far_mols_q.mid(i,1024));
+        }
+        
+        if (use_lj_grids)
+        {
+            //now build the LJ grids from the close atoms
+            addToLJGrids(cmols_x, cmols_y, cmols_z, cmols_sig, cmols_eps);
+        }
+        
+        if (not cache_key.isEmpty())
+        {
+            QVector< QVector<double> > grids;
+            grids.append(gridpot);
+            grids += ljgrids;
+            
+            GridCache::save(cache_key, grids);
+        }
+    }
+    
+    far_mols_x.clear();
+    far_mols_y.clear();
+    far_mols_z.clear();
+    far_mols_q.clear();
+    
+    if (use_lj_grids)
+    {
+        //there are now no atoms whose energy must be calculated explicitly
+        cmols_x.clear();
+        cmols_y.clear();
+        cmols_z.clear();
+        cmols_q.clear();
+        cmols_sig.clear();
+        cmols_eps.clear();
+    }
+
     // convert the QVector<float> arrays into QVector<MultiFloat>
     close_mols_x = MultiFloat::fromArray(cmols_x);
     close_mols_y = MultiFloat::fromArray(cmols_y);
@@ -1391,6 +1710,127 @@ void GridFF2::calculateEnergy(const CLJAtoms &atoms0, const CLJAtoms &atoms1,
     return_ljnrg = 4.0 * iljnrg.sum();  // SHOULD PUT FACTOR OF FOUR INTO EPSILON PARAMETERS
 }
 
+/** Return whether or not the passed group of atoms lies within the grid,
+    and (if LJ grids are used) whether there is an LJ grid for each of
+    their LJ parameters. If not, then the grid must be rebuilt */
+bool GridFF2::isOnGrid(const CoordGroup &coords, const CLJParameters::Array &params) const
+{
+    if (not gridbox.contains(coords.aaBox()))
+        return false;
+
+    if (use_lj_grids)
+    {
+        for (int i=0; i<params.count(); ++i)
+        {
+            const quint32 ljid = params.constData()[i].ljid;
+        
+            if (ljid != 0 and not ljgrid_ids.contains(ljid))
+                return false;
+        }
+    }
+    
+    return true;
+}
+
+/** Return the Catmull-Rom cubic interpolation weights for the four 
+    points surrounding the fractional coordinate 't' */
+static void getCubicWeights(double t, double w[4])
+{
+    const double t2 = t*t;
+    const double t3 = t2*t;
+    
+    w[0] = 0.5 * (-t3 + 2*t2 - t);
+    w[1] = 0.5 * (3*t3 - 5*t2 + 2);
+    w[2] = 0.5 * (-3*t3 + 4*t2 + t);
+    w[3] = 0.5 * (t3 - t2);
+}
+
+/** Interpolate the value of the passed grid at the point with fractional
+    coordinates R, S, T from the grid point i_0, j_0, k_0 */
+double GridFF2::interpolate(const double *grid, int i_0, int j_0, int k_0,
+                            double R, double S, double T) const
+{
+    int i000 = gridIndexToArrayIndex(i_0  , j_0  , k_0  , dimx, dimy, dimz);
+    int i001 = gridIndexToArrayIndex(i_0  , j_0  , k_0+1, dimx, dimy, dimz);
+    int i010 = gridIndexToArrayIndex(i_0  , j_0+1, k_0  , dimx, dimy, dimz);
+    int i100 = gridIndexToArrayIndex(i_0+1, j_0  , k_0  , dimx, dimy, dimz);
+    int i011 = gridIndexToArrayIndex(i_0  , j_0+1, k_0+1, dimx, dimy, dimz);
+    int i101 = gridIndexToArrayIndex(i_0+1, j_0  , k_0+1, dimx, dimy, dimz);
+    int i110 = gridIndexToArrayIndex(i_0+1, j_0+1, k_0  , dimx, dimy, dimz);
+    int i111 = gridIndexToArrayIndex(i_0+1, j_0+1, k_0+1, dimx, dimy, dimz);
+
+    if (use_tricubic and i_0 > 0 and i_0 < int(dimx-2) and
+                         j_0 > 0 and j_0 < int(dimy-2) and
+                         k_0 > 0 and k_0 < int(dimz-2))
+    {
+        //use tricubic (Catmull-Rom) interpolation over the 4x4x4
+        //points surrounding the atom. The z index is contiguous in
+        //memory, so each set of four points in z is read as a row
+        double wx[4], wy[4], wz[4];
+        getCubicWeights(R, wx);
+        getCubicWeights(S, wy);
+        getCubicWeights(T, wz);
+        
+        double phi = 0;
+        
+        for (int a=0; a<4; ++a)
+        {
+            for (int b=0; b<4; ++b)
+            {
+                const double *row = grid + gridIndexToArrayIndex(i_0-1+a, j_0-1+b, k_0-1,
+                                                                 dimx, dimy, dimz);
+                
+                phi += wx[a] * wy[b] * (wz[0]*row[0] + wz[1]*row[1] +
+                                        wz[2]*row[2] + wz[3]*row[3]);
+            }
+        }
+        
+        //cubic interpolation can overshoot next to the steep parts of the
+        //potential, so clamp the value to the range of the surrounding points
+        const double minval = qMin( qMin( qMin(grid[i000], grid[i001]),
+                                          qMin(grid[i010], grid[i100]) ),
+                                    qMin( qMin(grid[i011], grid[i101]),
+                                          qMin(grid[i110], grid[i111]) ) );
+
+        const double maxval = qMax( qMax( qMax(grid[i000], grid[i001]),
+                                          qMax(grid[i010], grid[i100]) ),
+                                    qMax( qMax(grid[i011], grid[i101]),
+                                          qMax(grid[i110], grid[i111]) ) );
+        
+        return qMax( minval, qMin(maxval, phi) );
+    }
+    else
+    {
+        //use tri-linear interpolation to get the potential at the atom
+        //
+        // This is described in 
+        //
+        // Davis, Madura and McCammon, Comp. Phys. Comm., 62, 187-197, 1991
+        //
+        // phi(x,y,z) = phi(i  ,j  ,k  )*(1-R)(1-S)(1-T) +
+        //              phi(i+1,j  ,k  )*(  R)(1-S)(1-T) +
+        //              phi(i  ,j+1,k  )*(1-R)(  S)(1-T) +
+        //              phi(i  ,j  ,k+1)*(1-R)(1-S)(  T) +
+        //              phi(i+1,j+1,k  )*(  R)(  S)(1-T) +
+        //              phi(i+1,j  ,k+1)*(  R)(1-S)(  T) +
+        //              phi(i  ,j+1,k+1)*(1-R)(  S)(  T) +
+        //              phi(i+1,j+1,k+1)*(  R)(  S)(  T) +
+        //
+        // where R, S and T are the coordinates of the atom in 
+        // fractional grid coordinates from the point (i,j,k), e.g.
+        // (0,0,0) is (i,j,k) and (1,1,1) is (i+1,j+1,k+1)
+        //
+        return (grid[i000] * (1-R)*(1-S)*(1-T)) + 
+               (grid[i001] * (1-R)*(1-S)*(  T)) +
+               (grid[i010] * (1-R)*(  S)*(1-T)) +
+               (grid[i100] * (  R)*(1-S)*(1-T)) +
+               (grid[i011] * (1-R)*(  S)*(  T)) +
+               (grid[i101] * (  R)*(1-S)*(  T)) +
+               (grid[i110] * (  R)*(  S)*(1-T)) +
+               (grid[i111] * (  R)*(  S)*(  T));
+    }
+}
+
 void GridFF2::calculateEnergy(const CoordGroup &coords0, 
                               const GridFF2::CLJParameters::Array &params0,
                               double &return_cnrg, double &return_ljnrg)
@@ -1412,16 +1852,19 @@ void GridFF2::calculateEnergy(const CoordGroup &coords0,
 
     BOOST_ASSERT( closemols_coords.count() == closemols_params.count() );
 
-    CLJAtoms atoms0(coords0, params0);
-    CLJAtoms atoms1;
-    atoms1.x = close_mols_x;
-    atoms1.y = close_mols_y;
-    atoms1.z = close_mols_z;
-    atoms1.q = close_mols_q;
-    atoms1.sig = close_mols_sig;
-    atoms1.eps = close_mols_eps;
-
-    calculateEnergy(atoms0, atoms1, cnrg, ljnrg);
+    if (not close_mols_x.isEmpty())
+    {
+        CLJAtoms atoms0(coords0, params0);
+        CLJAtoms atoms1;
+        atoms1.x = close_mols_x;
+        atoms1.y = close_mols_y;
+        atoms1.z = close_mols_z;
+        atoms1.q = close_mols_q;
+        atoms1.sig = close_mols_sig;
+        atoms1.eps = close_mols_eps;
+
+        calculateEnergy(atoms0, atoms1, cnrg, ljnrg);
+    }
 
     //now calculate the energy in the grid
     if (not gridpot.isEmpty())
@@ -1448,25 +1891,6 @@ void GridFF2::calculateEnergy(const CoordGroup &coords0,
             }
             else
             {
-                //use tri-linear interpolation to get the potential at the atom
-                //
-                // This is described in 
-                //
-                // Davis, Madura and McCammon, Comp. Phys. Comm., 62, 187-197, 1991
-                //
-                // phi(x,y,z) = phi(i  ,j  ,k  )*(1-R)(1-S)(1-T) +
-                //              phi(i+1,j  ,k  )*(  R)(1-S)(1-T) +
-                //              phi(i  ,j+1,k  )*(1-R)(  S)(1-T) +
-                //              phi(i  ,j  ,k+1)*(1-R)(1-S)(  T) +
-                //              phi(i+1,j+1,k  )*(  R)(  S)(1-T) +
-                //              phi(i+1,j  ,k+1)*(  R)(1-S)(  T) +
-                //              phi(i  ,j+1,k+1)*(1-R)(  S)(  T) +
-                //              phi(i+1,j+1,k+1)*(  R)(  S)(  T) +
-                //
-                // where R, S and T are the coordinates of the atom in 
-                // fractional grid coordinates from the point (i,j,k), e.g.
-                // (0,0,0) is (i,j,k) and (1,1,1) is (i+1,j+1,k+1)
-                //
                 const Vector c000 = gridbox.minCoords() + 
                                         Vector( i_0 * grid_spacing,
                                                 j_0 * grid_spacing,
@@ -1477,25 +1901,18 @@ void GridFF2::calculateEnergy(const CoordGroup &coords0,
                 const double S = RST.y();
                 const double T = RST.z();
                 
-                int i000 = gridIndexToArrayIndex(i_0  , j_0  , k_0  , dimx, dimy, dimz);
-                int i001 = gridIndexToArrayIndex(i_0  , j_0  , k_0+1, dimx, dimy, dimz);
-                int i010 = gridIndexToArrayIndex(i_0  , j_0+1, k_0  , dimx, dimy, dimz);
-                int i100 = gridIndexToArrayIndex(i_0+1, j_0  , k_0  , dimx, dimy, dimz);
-                int i011 = gridIndexToArrayIndex(i_0  , j_0+1, k_0+1, dimx, dimy, dimz);
-                int i101 = gridIndexToArrayIndex(i_0+1, j_0  , k_0+1, dimx, dimy, dimz);
-                int i110 = gridIndexToArrayIndex(i_0+1, j_0+1, k_0  , dimx, dimy, dimz);
-                int i111 = gridIndexToArrayIndex(i_0+1, j_0+1, k_0+1, dimx, dimy, dimz);
+                if (p0.reduced_charge != 0)
+                {
+                    gridnrg += p0.reduced_charge *
+                                    interpolate(gridpot_array, i_0, j_0, k_0, R, S, T);
+                }
                 
-                double phi = (gridpot_array[i000] * (1-R)*(1-S)*(1-T)) + 
-                             (gridpot_array[i001] * (1-R)*(1-S)*(  T)) +
-                             (gridpot_array[i010] * (1-R)*(  S)*(1-T)) +
-                             (gridpot_array[i100] * (  R)*(1-S)*(1-T)) +
-                             (gridpot_array[i011] * (1-R)*(  S)*(  T)) +
-                             (gridpot_array[i101] * (  R)*(1-S)*(  T)) +
-                             (gridpot_array[i110] * (  R)*(  S)*(1-T)) +
-                             (gridpot_array[i111] * (  R)*(  S)*(  T));                         
-                                  
-                gridnrg += phi * p0.reduced_charge;
+                if (use_lj_grids and p0.ljid != 0)
+                {
+                    const QVector<double> &ljgrid = ljgrids.at( ljgrid_ids.value(p0.ljid) );
+                    
+                    ljnrg += interpolate(ljgrid.constData(), i_0, j_0, k_0, R, S, T);
+                }
             }
         }
     }
@@ -1508,6 +1925,8 @@ void GridFF2::calculateEnergy(const CoordGroup &coords0,
 void GridFF2::mustNowRecalculateFromScratch()
 {
     gridpot.clear();
+    ljgrids.clear();
+    ljgrid_ids.clear();
     closemols_coords.clear();
     closemols_params.clear();
     oldnrgs.clear();
@@ -1656,7 +2075,7 @@ void GridFF2::recalculateEnergy()
             {
                 const CoordGroup &group = groups_array[igroup];
 
-                if (not gridbox.contains(group.aaBox()))
+                if (not this->isOnGrid(group, params_array[igroup]))
                 {
                     //this group lies outside the grid - we need to recalculate
                     //the grid
@@ -1717,7 +2136,7 @@ void GridFF2::recalculateEnergy()
                 {
                     const CoordGroup &group = groups_array[igroup];
 
-                    if (not gridbox.contains(group.aaBox()))
+                    if (not this->isOnGrid(group, params_array[igroup]))
                     {
                         //this group lies outside the grid - we need to recalculate
                         //the grid
@@ -1763,7 +2182,7 @@ void GridFF2::recalculateEnergy()
                     {
                         const CoordGroup &group = groups_array[igroup];
 
-                        if (not gridbox.contains(group.aaBox()))
+                        if (not this->isOnGrid(group, params_array[igroup]))
                         {
                             //this group lies outside the grid - we need to recalculate
                             //the grid
@@ -1796,7 +2215,7 @@ void GridFF2::recalculateEnergy()
                     {
                         const CoordGroup &group = groups_array[igroup];
 
-                        if (not gridbox.contains(group.aaBox()))
+                        if (not this->isOnGrid(group, params_array[igroup]))
                         {
                             //this group lies outside the grid - we need to recalculate
                             //the grid
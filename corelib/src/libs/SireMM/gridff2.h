@@ -53,6 +53,17 @@ namespace SireMM
     are represented using a grid. This is ideal for situations
     where the molecules on group 2 move little, or not at all.
     
+    By default, the LJ energy (and the coulomb energy of atoms
+    close to the grid) is calculated explicitly. Optionally, 
+    a grid of LJ potentials can be built for each distinct
+    LJ parameter used by the atoms in group 1, in which case
+    the energy of a group 1 molecule is obtained purely from
+    grid lookups. The potentials can be interpolated using
+    either trilinear or tricubic interpolation.
+    
+    If the GridCache is enabled, then the grids are saved to, and
+    reused from, the cache
+    
     @author Christopher Woods
 */
 class SIREMM_EXPORT GridFF2
@@ -101,12 +112,20 @@ public:
     bool setUseReactionField(bool on);
     bool setReactionFieldDielectric(double dielectric);
     
+    bool setUseLJGrids(bool on);
+    bool setUseTricubicInterpolation(bool on);
+    
     SireUnits::Dimension::Length buffer() const;
     SireUnits::Dimension::Length spacing() const;
 
     SireUnits::Dimension::Length coulombCutoff() const;
     SireUnits::Dimension::Length ljCutoff() const;
 
+    bool usesLJGrids() const;
+    bool usesTricubicInterpolation() const;
+    
+    int nLJGrids() const;
+
     void mustNowRecalculateFromScratch();    
 
 protected:
@@ -197,6 +216,16 @@ private:
     void addToGrid(const QVector<float> &vx, const QVector<float> &vy,
                    const QVector<float> &vz, const QVector<float> &vq);
 
+    void addToLJGrids(const QVector<float> &vx, const QVector<float> &vy,
+                      const QVector<float> &vz, const QVector<float> &vsig,
+                      const QVector<float> &veps);
+
+    bool isOnGrid(const SireVol::CoordGroup &coords,
+                  const CLJParameters::Array &params) const;
+
+    double interpolate(const double *grid, int i_0, int j_0, int k_0,
+                       double R, double S, double T) const;
+
     void calculateEnergy(const SireVol::CoordGroup &coords,
                          const CLJParameters::Array &params,
                          double &cnrg, double &ljnrg);
@@ -229,6 +258,13 @@ private:
     /** The grid of coulomb potentials */
     QVector<double> gridpot;
     
+    /** The grids of LJ potentials, one for each distinct LJ
+        parameter used by the atoms in group 1 */
+    QVector< QVector<double> > ljgrids;
+    
+    /** The index of the LJ grid in 'ljgrids' for each LJ parameter ID */
+    QHash<quint32,qint32> ljgrid_ids;
+    
     /** The set of coordinates and parameters for the fixed atoms.
         These are atoms which exist only in this GridFF, thereby
         allowing them to be present in the energy expression without
@@ -253,6 +289,13 @@ private:
     
     /** The old energy of each molecule */
     QHash<SireMol::MolNum,CLJEnergy> oldnrgs;
+    
+    /** Whether or not to use grids for the LJ energy */
+    bool use_lj_grids;
+    
+    /** Whether or not to use tricubic (rather than trilinear)
+        interpolation of the grids */
+    bool use_tricubic;
 };
 
 }
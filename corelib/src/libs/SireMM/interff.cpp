@@ -34,6 +34,11 @@
 #include "SireBase/lengthproperty.h"
 #include "SireBase/refcountdata.h"
 
+#include "SireFF/energyprofiler.h"
+#include "SireFF/errors.h"
+
+#include "SireCAS/symbols.h"
+
 #include "SireError/errors.h"
 #include "SireBase/errors.h"
 
@@ -48,6 +53,8 @@
 #include "SireStream/datastream.h"
 #include "SireStream/shareddatastream.h"
 
+#include "tostring.h"
+
 #include <QElapsedTimer>
 #include <QRegExp>
 #include <QDebug>
@@ -58,6 +65,8 @@ using namespace SireFF;
 using namespace SireBase;
 using namespace SireStream;
 
+using SireCAS::Symbol;
+
 namespace SireMM
 {
     namespace detail
@@ -66,7 +75,8 @@ namespace SireMM
         {
         public:
             InterFFData() : RefCountData(), fixed_only(false),
-                            parallel_calc(true), repro_sum(false)
+                            parallel_calc(true), repro_sum(false),
+                            use_nbrlist(false), nbrlist_skin(CLJNeighbourList().skin())
             {}
             
             InterFFData(const InterFFData &other)
@@ -77,7 +87,9 @@ namespace SireMM
                    props(other.props),
                    fixed_only(other.fixed_only),
                    parallel_calc(other.parallel_calc),
-                   repro_sum(other.repro_sum)
+                   repro_sum(other.repro_sum),
+                   use_nbrlist(other.use_nbrlist),
+                   nbrlist_skin(other.nbrlist_skin)
             {}
             
             ~InterFFData()
@@ -105,6 +117,13 @@ namespace SireMM
             
             /** Whether or not to sum energies using a reproducible sum */
             bool repro_sum;
+
+            /** Whether or not to use neighbour lists to calculate the
+                energy from scratch */
+            bool use_nbrlist;
+
+            /** The skin used for the neighbour lists */
+            Length nbrlist_skin;
         };
     }
 }
@@ -113,7 +132,7 @@ static RegisterMetaType<InterFF> r_interff;
 
 QDataStream SIREMM_EXPORT &operator<<(QDataStream &ds, const InterFF &interff)
 {
-    writeHeader(ds, r_interff, 3);
+    writeHeader(ds, r_interff, 5);
     
     SharedDataStream sds(ds);
     
@@ -123,6 +142,8 @@ QDataStream SIREMM_EXPORT &operator<<(QDataStream &ds, const InterFF &interff)
         << interff.d->fixed_atoms
         << interff.d->fixed_only << interff.d->parallel_calc
         << interff.d->repro_sum
+        << interff.spme_meshes
+        << interff.d->use_nbrlist << interff.d->nbrlist_skin.value()
         << static_cast<const G1FF&>(interff);
 
     return ds;
@@ -132,7 +153,28 @@ QDataStream SIREMM_EXPORT &operator>>(QDataStream &ds, InterFF &interff)
 {
     VersionID v = readHeader(ds, r_interff);
     
-    if (v == 3)
+    if (v == 5)
+    {
+        SharedDataStream sds(ds);
+
+        double skin;
+
+        sds >> interff.cljgroup >> interff.needs_accepting
+            >> interff.d->cljfuncs >> interff.d->cljcomps
+            >> interff.d->fixed_atoms
+            >> interff.d->fixed_only >> interff.d->parallel_calc
+            >> interff.d->repro_sum
+            >> interff.spme_meshes
+            >> interff.d->use_nbrlist >> skin
+            >> static_cast<G1FF&>(interff);
+
+        interff.d->nbrlist_skin = Length(skin);
+        interff.nbr_lists.clear();
+
+        interff.rebuildProps();
+        interff._pvt_updateName();
+    }
+    else if (v == 4)
     {
         SharedDataStream sds(ds);
         
@@ -141,13 +183,49 @@ QDataStream SIREMM_EXPORT &operator>>(QDataStream &ds, InterFF &interff)
             >> interff.d->fixed_atoms
             >> interff.d->fixed_only >> interff.d->parallel_calc
             >> interff.d->repro_sum
+            >> interff.spme_meshes
             >> static_cast<G1FF&>(interff);
         
+        interff.d->use_nbrlist = false;
+        interff.d->nbrlist_skin = CLJNeighbourList().skin();
+        interff.nbr_lists.clear();
+
         interff.rebuildProps();
         interff._pvt_updateName();
     }
+    else if (v == 3)
+    {
+        SharedDataStream sds(ds);
+        
+        sds >> interff.cljgroup >> interff.needs_accepting
+            >> interff.d->cljfuncs >> interff.d->cljcomps
+            >> interff.d->fixed_atoms
+            >> interff.d->fixed_only >> interff.d->parallel_calc
+            >> interff.d->repro_sum
+            >> static_cast<G1FF&>(interff);
+        
+        interff.spme_meshes.clear();
+        
+        interff.d->use_nbrlist = false;
+        interff.d->nbrlist_skin = CLJNeighbourList().skin();
+        interff.nbr_lists.clear();
+
+        interff.rebuildProps();
+        interff._pvt_updateName();
+        
+        //version 3 did not include the long-range SPME energy, so any
+        //CLJSPMEFunction needs the energy to be recalculated
+        for (int i=0; i<interff.d->cljfuncs.count(); ++i)
+        {
+            if (interff.d->cljfuncs.at(i).read().isA<CLJSPMEFunction>())
+            {
+                interff.mustNowRecalculateFromScratch();
+                break;
+            }
+        }
+    }
     else
-        throw version_error(v, "3", r_interff, CODELOC);
+        throw version_error(v, "3,4,5", r_interff, CODELOC);
     
     return ds;
 }
@@ -176,6 +254,8 @@ InterFF::InterFF(const QString &name)
 InterFF::InterFF(const InterFF &other)
         : ConcreteProperty<InterFF,G1FF>(other),
           cljgroup(other.cljgroup), d(other.d),
+          spme_meshes(other.spme_meshes),
+          nbr_lists(other.nbr_lists),
           needs_accepting(other.needs_accepting)
 {}
 
@@ -356,6 +436,8 @@ InterFF& InterFF::operator=(const InterFF &other)
         cljgroup = other.cljgroup;
         needs_accepting = other.needs_accepting;
         d = other.d;
+        spme_meshes = other.spme_meshes;
+        nbr_lists = other.nbr_lists;
         G1FF::operator=(other);
     }
     
@@ -420,6 +502,8 @@ void InterFF::rebuildProps()
     d->props.setProperty("fixedOnly", BooleanProperty(d->fixed_only));
     d->props.setProperty("parallelCalculation", BooleanProperty(d->parallel_calc));
     d->props.setProperty("reproducibleCalculation", BooleanProperty(d->repro_sum));
+    d->props.setProperty("useNeighbourList", BooleanProperty(d->use_nbrlist));
+    d->props.setProperty("neighbourListSkin", LengthProperty(d->nbrlist_skin));
 
     for (int i=0; i<d->fixed_atoms.count(); ++i)
     {
@@ -548,6 +632,30 @@ bool InterFF::setProperty(const QString &name, const Property &property)
         else
             return false;
     }
+    else if (name == "useNeighbourList")
+    {
+        bool use_nbrlist = property.asA<BooleanProperty>().value();
+
+        if (use_nbrlist != d.constData()->use_nbrlist)
+        {
+            this->setUseNeighbourList(use_nbrlist);
+            return true;
+        }
+        else
+            return false;
+    }
+    else if (name == "neighbourListSkin")
+    {
+        Length skin = property.asA<LengthProperty>().value();
+
+        if (skin != d.constData()->nbrlist_skin)
+        {
+            this->setNeighbourListSkin(skin);
+            return true;
+        }
+        else
+            return false;
+    }
     else
     {
         //see if the property is in the default CLJFunction
@@ -884,6 +992,61 @@ bool InterFF::usesReproducibleCalculation() const
     return d->repro_sum;
 }
 
+/** Switch on or off the use of Verlet neighbour lists (CLJNeighbourList)
+    when the energy is calculated from scratch. The neighbour lists are only
+    rebuilt when an atom has moved by more than half of the skin, so this
+    is quicker for molecular dynamics, where every molecule moves by a
+    small amount each step. When this is on, the energy is recalculated
+    from scratch whenever more than half of the molecules have changed */
+void InterFF::setUseNeighbourList(bool on)
+{
+    if (on != d.constData()->use_nbrlist)
+    {
+        d->use_nbrlist = on;
+        d->props.setProperty("useNeighbourList", BooleanProperty(on));
+        nbr_lists.clear();
+    }
+}
+
+/** Turn on the use of Verlet neighbour lists to calculate the energy */
+void InterFF::enableNeighbourList()
+{
+    this->setUseNeighbourList(true);
+}
+
+/** Turn off the use of Verlet neighbour lists to calculate the energy.
+    This is off by default */
+void InterFF::disableNeighbourList()
+{
+    this->setUseNeighbourList(false);
+}
+
+/** Return whether or not Verlet neighbour lists are used to calculate the energy */
+bool InterFF::usesNeighbourList() const
+{
+    return d.constData()->use_nbrlist;
+}
+
+/** Set the skin added onto the cutoff when building the neighbour lists */
+void InterFF::setNeighbourListSkin(Length skin)
+{
+    if (skin != d.constData()->nbrlist_skin)
+    {
+        //validate the skin
+        CLJNeighbourList(skin);
+
+        d->nbrlist_skin = skin;
+        d->props.setProperty("neighbourListSkin", LengthProperty(skin));
+        nbr_lists.clear();
+    }
+}
+
+/** Return the skin added onto the cutoff when building the neighbour lists */
+Length InterFF::neighbourListSkin() const
+{
+    return d.constData()->nbrlist_skin;
+}
+
 /** Return whether or not only the energy between the mobile and fixed
     atoms is being calculated */
 bool InterFF::fixedOnly() const
@@ -987,11 +1150,119 @@ void InterFF::mustNowReallyRecalculateFromScratch()
     this->setDirty();
 }
 
+/** Internal function used to rebuild the reciprocal space meshes of any
+    CLJSPMEFunctions from all of the atoms in this forcefield. This returns
+    the long-range coulomb energy for each CLJFunction (zero for any
+    function that is not a CLJSPMEFunction)
+
+    \throw SireError::incompatible_error
+*/
+QVector<double> InterFF::rebuildSPMEMeshes()
+{
+    const QVector<CLJFunctionPtr> &funcs = d.constData()->cljfuncs;
+
+    QVector<double> nrgs(funcs.count(), 0.0);
+    spme_meshes.clear();
+
+    if (d.constData()->fixed_only)
+        return nrgs;
+
+    for (int i=0; i<funcs.count(); ++i)
+    {
+        if (funcs.at(i).read().isA<CLJSPMEFunction>())
+        {
+            if (spme_meshes.isEmpty())
+                spme_meshes.resize(funcs.count());
+
+            spme_meshes[i] = CLJSPMEMesh(funcs.at(i).read().asA<CLJSPMEFunction>(),
+                                         cljgroup.cljBoxes());
+            nrgs[i] = spme_meshes.at(i).energy();
+        }
+    }
+
+    return nrgs;
+}
+
+/** Internal function used to calculate the change in the long-range
+    coulomb energy of each CLJFunction caused by the atoms that have
+    changed since the last time the CLJGroup was accepted */
+QVector<double> InterFF::calculateSPMEDeltas()
+{
+    QVector<double> deltas(d.constData()->cljfuncs.count(), 0.0);
+
+    if (spme_meshes.isEmpty())
+        return deltas;
+
+    const CLJAtoms old_atoms = cljgroup.oldAtoms();
+    const CLJAtoms new_atoms = cljgroup.newAtoms();
+
+    for (int i=0; i<spme_meshes.count(); ++i)
+    {
+        if (not spme_meshes.at(i).isEmpty())
+            deltas[i] = spme_meshes[i].calculateDelta(old_atoms, new_atoms);
+    }
+
+    return deltas;
+}
+
+/** Internal function used to accept any pending changes in the SPME meshes */
+void InterFF::acceptSPMEMeshes()
+{
+    for (int i=0; i<spme_meshes.count(); ++i)
+    {
+        spme_meshes[i].accept();
+    }
+}
+
+/** Internal function used to calculate the energy of all of the atoms in
+    this forcefield from scratch for each of the CLJFunctions, using a Verlet
+    neighbour list for each function. The lists are kept between calls and
+    are only rebuilt when needed */
+tuple< QVector<double>,QVector<double> > InterFF::calculateWithNeighbourLists()
+{
+    const QVector<CLJFunctionPtr> &funcs = d.constData()->cljfuncs;
+
+    if (nbr_lists.count() != funcs.count())
+        nbr_lists = QVector<CLJNeighbourList>(funcs.count(),
+                                              CLJNeighbourList(d.constData()->nbrlist_skin));
+
+    //the atoms are returned in the same order each time, as needed by the lists
+    const CLJAtoms atoms = cljgroup.atoms();
+
+    QVector<double> cnrgs(funcs.count(), 0.0);
+    QVector<double> ljnrgs(funcs.count(), 0.0);
+
+    CLJCalculator calc(d.constData()->repro_sum);
+
+    for (int i=0; i<funcs.count(); ++i)
+    {
+        tuple<double,double> nrgs = calc.calculate(funcs.at(i).read(), atoms, nbr_lists[i]);
+
+        cnrgs[i] = nrgs.get<0>();
+        ljnrgs[i] = nrgs.get<1>();
+    }
+
+    return tuple< QVector<double>,QVector<double> >(cnrgs, ljnrgs);
+}
+
 /** Recalculate the energy of this forcefield */
 void InterFF::recalculateEnergy()
 {
+    //when using neighbour lists it is quicker to recalculate the energy from
+    //scratch than to calculate the change in energy once most of the molecules
+    //have moved (e.g. after a molecular dynamics step)
+    if (d.constData()->use_nbrlist and not d.constData()->fixed_only and
+        cljgroup.needsAccepting() and not cljgroup.recalculatingFromScratch() and
+        2 * cljgroup.nChangedMolecules() > this->nMolecules())
+    {
+        cljgroup.mustRecalculateFromScratch();
+        needs_accepting = false;
+    }
+
     if (cljgroup.recalculatingFromScratch())
     {
+        EnergyProfiler::recordFullCalculation();
+
         //calculate the energy from first principles and regenerate the
         //grid if needed
         cljgroup.accept();
@@ -999,6 +1270,8 @@ void InterFF::recalculateEnergy()
         
         if (cljgroup.isEmpty())
         {
+            spme_meshes.clear();
+
             //no atoms
             if (d.constData()->cljcomps.count() == 1)
             {
@@ -1023,7 +1296,15 @@ void InterFF::recalculateEnergy()
             
             if (not d.constData()->fixed_only)
             {
-                if (d.constData()->parallel_calc)
+                if (d.constData()->use_nbrlist)
+                {
+                    tuple< QVector<double>,QVector<double> > nbr_nrgs
+                                                    = this->calculateWithNeighbourLists();
+
+                    nrgs = tuple<double,double>(nbr_nrgs.get<0>().at(0),
+                                                nbr_nrgs.get<1>().at(0));
+                }
+                else if (d.constData()->parallel_calc)
                 {
                     CLJCalculator calc(d->repro_sum);
                     nrgs = calc.calculate(cljFunction(), cljgroup.cljBoxes());
@@ -1043,6 +1324,9 @@ void InterFF::recalculateEnergy()
                 nrgs.get<0>() += grid_nrgs.get<0>();
                 nrgs.get<1>() += grid_nrgs.get<1>();
             }
+
+            //add on any long-range SPME energy
+            nrgs.get<0>() += this->rebuildSPMEMeshes().at(0);
             
             d.constData()->cljcomps.setEnergy(*this, MultiCLJEnergy(nrgs.get<0>(), nrgs.get<1>()));
         }
@@ -1052,7 +1336,11 @@ void InterFF::recalculateEnergy()
             
             if (not d.constData()->fixed_only)
             {
-                if (d.constData()->parallel_calc)
+                if (d.constData()->use_nbrlist)
+                {
+                    nrgs = this->calculateWithNeighbourLists();
+                }
+                else if (d.constData()->parallel_calc)
                 {
                     CLJCalculator calc(d->repro_sum);
                     nrgs = calc.calculate(d.constData()->cljfuncs, cljgroup.cljBoxes());
@@ -1082,6 +1370,14 @@ void InterFF::recalculateEnergy()
                     nrgs.get<1>()[i] += grid_nrgs.get<1>();
                 }
             }
+
+            //add on any long-range SPME energies
+            const QVector<double> spme_nrgs = this->rebuildSPMEMeshes();
+
+            for (int i=0; i<spme_nrgs.count(); ++i)
+            {
+                nrgs.get<0>()[i] += spme_nrgs.at(i);
+            }
             
             d.constData()->cljcomps.setEnergy(*this, MultiCLJEnergy(nrgs.get<0>(), nrgs.get<1>()));
         }
@@ -1090,6 +1386,8 @@ void InterFF::recalculateEnergy()
     }
     else if (cljgroup.needsAccepting())
     {
+        EnergyProfiler::recordDeltaCalculation();
+
         //we can calculate using just the change in energy
         if (d.constData()->cljfuncs.count() == 1)
         {
@@ -1153,6 +1451,9 @@ void InterFF::recalculateEnergy()
                 delta_nrgs.get<0>() += grid_deltas.get<0>();
                 delta_nrgs.get<1>() += grid_deltas.get<1>();
             }
+
+            //add on any change in the long-range SPME energy
+            delta_nrgs.get<0>() += this->calculateSPMEDeltas().at(0);
             
             d.constData()->cljcomps.changeEnergy(*this,
                                         MultiCLJEnergy(delta_nrgs.get<0>(), delta_nrgs.get<1>()));
@@ -1230,6 +1531,14 @@ void InterFF::recalculateEnergy()
                     delta_nrgs.get<1>()[i] += grid_deltas.get<1>();
                 }
             }
+
+            //add on any change in the long-range SPME energies
+            const QVector<double> spme_deltas = this->calculateSPMEDeltas();
+
+            for (int i=0; i<spme_deltas.count(); ++i)
+            {
+                delta_nrgs.get<0>()[i] += spme_deltas.at(i);
+            }
             
             d.constData()->cljcomps.changeEnergy(*this,
                                         MultiCLJEnergy(delta_nrgs.get<0>(), delta_nrgs.get<1>()));
@@ -1242,6 +1551,8 @@ void InterFF::recalculateEnergy()
     }
     else
     {
+        EnergyProfiler::recordFullCalculation();
+
         //recalculate everything from scratch as this has been requested
         //calculate the energy from scratch
         cljgroup.accept();
@@ -1272,6 +1583,9 @@ void InterFF::recalculateEnergy()
                 nrgs.get<0>() += grid_nrgs.get<0>();
                 nrgs.get<1>() += grid_nrgs.get<1>();
             }
+
+            //add on any long-range SPME energy
+            nrgs.get<0>() += this->rebuildSPMEMeshes().at(0);
             
             d.constData()->cljcomps.setEnergy(*this, MultiCLJEnergy(nrgs.get<0>(), nrgs.get<1>()));
         }
@@ -1312,6 +1626,14 @@ void InterFF::recalculateEnergy()
                     nrgs.get<1>()[i] += grid_nrgs.get<1>();
                 }
             }
+
+            //add on any long-range SPME energies
+            const QVector<double> spme_nrgs = this->rebuildSPMEMeshes();
+
+            for (int i=0; i<spme_nrgs.count(); ++i)
+            {
+                nrgs.get<0>()[i] += spme_nrgs.at(i);
+            }
             
             d.constData()->cljcomps.setEnergy(*this, MultiCLJEnergy(nrgs.get<0>(), nrgs.get<1>()));
         }
@@ -1320,16 +1642,193 @@ void InterFF::recalculateEnergy()
     }
 }
 
+/** Return the total energy of this forcefield */
+SireUnits::Dimension::MolarEnergy InterFF::energy()
+{
+    return G1FF::energy();
+}
+
+/** Return the energy of the component 'component' of this forcefield */
+SireUnits::Dimension::MolarEnergy InterFF::energy(const Symbol &component)
+{
+    return G1FF::energy(component);
+}
+
+/** Calculate the energies of molecules in the passed energy table
+    caused by this forcefield. This is not yet supported */
+void InterFF::energy(EnergyTable&, double)
+{
+    throw SireError::incomplete_code( QObject::tr(
+            "InterFF does not yet support energy table calculations!"), CODELOC );
+}
+
+/** Calculate the energies of molecules in the passed energy table
+    caused by the component 'symbol'. This is not yet supported */
+void InterFF::energy(EnergyTable&, const Symbol&, double)
+{
+    throw SireError::incomplete_code( QObject::tr(
+            "InterFF does not yet support energy table calculations!"), CODELOC );
+}
+
+/** Internal function used to return the index of the CLJFunction
+    whose total energy is represented by 'symbol'
+    
+    \throw SireError::unsupported
+    \throw SireFF::missing_component
+*/
+static int forceFunctionIndex(const MultiCLJComponent &comps, const Symbol &symbol)
+{
+    foreach (const QString &key, comps.keys())
+    {
+        if (symbol == comps.total(key))
+            return comps.indexOf(key);
+        
+        else if (symbol == comps.coulomb(key) or symbol == comps.lj(key))
+            throw SireError::unsupported( QObject::tr(
+                    "Forces can only be calculated for the total CLJ energy (%1), "
+                    "not for the component %2.")
+                        .arg(comps.total(key).toString(), symbol.toString()), CODELOC );
+    }
+    
+    throw SireFF::missing_component( QObject::tr(
+            "There is no component %1 in this forcefield. Available "
+            "components are %2.")
+                .arg(symbol.toString(), Sire::toString(comps.symbols())), CODELOC );
+    
+    return -1;
+}
+
+/** Calculate the forces acting on the molecules in the passed force table
+    caused by the component of this forcefield represented by 'symbol',
+    and add them onto the forces already in the force table (optionally
+    scaled by 'scale_force'). Forces can only be calculated for the
+    total energy of each CLJFunction. The interactions with the fixed atoms are
+    calculated explicitly, even if a grid is used for the energy
+    
+    \throw SireError::unsupported
+    \throw SireFF::missing_component
+*/
+void InterFF::force(ForceTable &forcetable, const Symbol &symbol, double scale_force)
+{
+    if (scale_force == 0)
+        return;
+    
+    const int idx = forceFunctionIndex(d.constData()->cljcomps, symbol);
+    
+    const CLJFunction &func = d.constData()->cljfuncs.at(idx).read();
+    
+    if (not func.supportsForceCalculation())
+        throw SireError::unsupported( QObject::tr(
+                "Cannot calculate the forces for %1 as the CLJFunction \"%2\" "
+                "does not support the calculation of forces.")
+                    .arg(symbol.toString(), func.what()), CODELOC );
+
+    //the atoms are returned in a fixed order, which is used to add
+    //the forces back onto the molecules
+    const CLJAtoms atoms = cljgroup.atoms();
+    
+    CLJForces forces(atoms);
+    
+    if (not d.constData()->fixed_only)
+    {
+        if (d.constData()->parallel_calc)
+        {
+            CLJCalculator calc(d.constData()->repro_sum);
+            forces = calc.calculateForces(func, atoms);
+        }
+        else
+        {
+            func.force(atoms, forces);
+        }
+    }
+    
+    //the interactions with the fixed atoms are calculated explicitly
+    const CLJAtoms fixed_atoms = d.constData()->fixed_atoms.at(idx).fixedAtoms();
+    
+    func.force(atoms, fixed_atoms, forces);
+    
+    cljgroup.addForces(forcetable, forces, scale_force);
+}
+
+/** Calculate the forces acting on the molecules in the passed force table
+    caused by this forcefield, and add them onto the forces already
+    in the force table (optionally scaled by 'scale_force')
+    
+    \throw SireError::unsupported
+*/
+void InterFF::force(ForceTable &forcetable, double scale_force)
+{
+    this->force(forcetable, d.constData()->cljcomps.total(), scale_force);
+}
+
+void InterFF::field(FieldTable&, double)
+{
+    throw SireError::incomplete_code( QObject::tr(
+                "Calculating the field of an InterFF has yet to "
+                "be implemented."), CODELOC );
+}
+
+void InterFF::field(FieldTable&, const Symbol&, double)
+{
+    throw SireError::incomplete_code( QObject::tr(
+                "Calculating the field of an InterFF has yet to "
+                "be implemented."), CODELOC );
+}
+
+void InterFF::field(FieldTable&, const Probe&, double)
+{
+    throw SireError::incomplete_code( QObject::tr(
+                "Calculating the field of an InterFF has yet to "
+                "be implemented."), CODELOC );
+}
+
+void InterFF::field(FieldTable&, const Symbol&, const Probe&, double)
+{
+    throw SireError::incomplete_code( QObject::tr(
+                "Calculating the field of an InterFF has yet to "
+                "be implemented."), CODELOC );
+}
+
+void InterFF::potential(PotentialTable&, double)
+{
+    throw SireError::incomplete_code( QObject::tr(
+                "Calculating the potential of an InterFF has yet to "
+                "be implemented."), CODELOC );
+}
+
+void InterFF::potential(PotentialTable&, const Symbol&, double)
+{
+    throw SireError::incomplete_code( QObject::tr(
+                "Calculating the potential of an InterFF has yet to "
+                "be implemented."), CODELOC );
+}
+
+void InterFF::potential(PotentialTable&, const Probe&, double)
+{
+    throw SireError::incomplete_code( QObject::tr(
+                "Calculating the potential of an InterFF has yet to "
+                "be implemented."), CODELOC );
+}
+
+void InterFF::potential(PotentialTable&, const Symbol&, const Probe&, double)
+{
+    throw SireError::incomplete_code( QObject::tr(
+                "Calculating the potential of an InterFF has yet to "
+                "be implemented."), CODELOC );
+}
+
 /** Function called to add a molecule to this forcefield */
 void InterFF::_pvt_added(const SireMol::PartialMolecule &mol, const SireBase::PropertyMap &map)
 {
     if (needs_accepting)
     {
         cljgroup.accept();
+        this->acceptSPMEMeshes();
         needs_accepting = false;
     }
 
     cljgroup.add(mol, map);
+    nbr_lists.clear();
     setDirty();
 }
 
@@ -1339,10 +1838,12 @@ void InterFF::_pvt_removed(const SireMol::PartialMolecule &mol)
     if (needs_accepting)
     {
         cljgroup.accept();
+        this->acceptSPMEMeshes();
         needs_accepting = false;
     }
 
     cljgroup.remove(mol);
+    nbr_lists.clear();
     setDirty();
 }
 
@@ -1352,6 +1853,7 @@ void InterFF::_pvt_changed(const Molecule &molecule, bool auto_update)
     if (needs_accepting)
     {
         cljgroup.accept();
+        this->acceptSPMEMeshes();
         needs_accepting = false;
     }
 
@@ -1365,6 +1867,7 @@ void InterFF::_pvt_changed(const QList<SireMol::Molecule> &molecules, bool auto_
     if (needs_accepting)
     {
         cljgroup.accept();
+        this->acceptSPMEMeshes();
         needs_accepting = false;
     }
 
@@ -1382,10 +1885,12 @@ void InterFF::_pvt_removedAll()
     if (needs_accepting)
     {
         cljgroup.accept();
+        this->acceptSPMEMeshes();
         needs_accepting = false;
     }
 
     cljgroup.removeAll();
+    nbr_lists.clear();
     this->setDirty();
 }
 
@@ -1412,6 +1917,7 @@ void InterFF::accept()
     if (needs_accepting)
     {
         cljgroup.accept();
+        this->acceptSPMEMeshes();
         needs_accepting = false;
     }
     
@@ -32,11 +32,14 @@
 #include "cljgrid.h"
 #include "cljfunction.h"
 #include "cljgroup.h"
+#include "cljneighbourlist.h"
+#include "cljspmefunction.h"
 #include "multicljcomponent.h"
 
 #include "SireBase/shareddatapointer.hpp"
 
 #include "SireFF/g1ff.h"
+#include "SireFF/ff3d.h"
 
 SIRE_BEGIN_HEADER
 
@@ -63,10 +66,31 @@ namespace detail
     and Lennard Jones (LJ) energy of all contained molecule views.
     It also calculates the interactions with any fixed atoms added
     to this forcefield
+
+    If any of the CLJFunctions is a CLJSPMEFunction then the long-range
+    (reciprocal space, self and exclusion) part of its coulomb energy
+    is added, with the reciprocal space mesh held between moves so that
+    it can be updated incrementally. Only the molecules in this forcefield
+    are placed onto the mesh, i.e. the long-range energy does not include
+    any fixed atoms.
+
+    If neighbour lists are switched on (setUseNeighbourList) then
+    the energy is calculated from scratch using a Verlet cluster-pair
+    neighbour list (CLJNeighbourList) for each CLJFunction, which
+    is only rebuilt when an atom has moved by more than half of the
+    skin. This suits molecular dynamics, where every molecule moves
+    each step.
+
+    The forces on the molecules are calculated for the total energy
+    of each CLJFunction that supports force calculation (see
+    CLJFunction::supportsForceCalculation). The fixed atoms are
+    included explicitly (not via the grid), while the SPME long-range
+    terms are not supported.
     
     @author Christopher Woods
 */
-class SIREMM_EXPORT InterFF : public SireBase::ConcreteProperty<InterFF,SireFF::G1FF>
+class SIREMM_EXPORT InterFF : public SireBase::ConcreteProperty<InterFF,SireFF::G1FF>,
+                            public SireFF::FF3D
 {
 
 friend QDataStream& ::operator<<(QDataStream&, const InterFF&);
@@ -142,11 +166,54 @@ public:
     void setUseReproducibleCalculation(bool on);
     bool usesReproducibleCalculation() const;
 
+    void enableNeighbourList();
+    void disableNeighbourList();
+    void setUseNeighbourList(bool on);
+    bool usesNeighbourList() const;
+
+    void setNeighbourListSkin(Length skin);
+    Length neighbourListSkin() const;
+
     bool setProperty(const QString &name, const Property &property);
     const Property& property(const QString &name) const;
     bool containsProperty(const QString &name) const;
     const Properties& properties() const;
 
+    SireUnits::Dimension::MolarEnergy energy();
+    SireUnits::Dimension::MolarEnergy energy(const SireCAS::Symbol &component);
+
+    void energy(SireFF::EnergyTable &energytable, double scale_energy=1);
+    
+    void energy(SireFF::EnergyTable &energytable, const SireCAS::Symbol &symbol,
+                double scale_energy=1);
+
+    void force(SireFF::ForceTable &forcetable, double scale_force=1);
+    
+    void force(SireFF::ForceTable &forcetable, const SireCAS::Symbol &symbol,
+               double scale_force=1);
+               
+    void field(SireFF::FieldTable &fieldtable, double scale_field=1);
+    
+    void field(SireFF::FieldTable &fieldtable, const SireCAS::Symbol &component,
+               double scale_field=1);
+               
+    void potential(SireFF::PotentialTable &potentialtable, double scale_potential=1);
+    
+    void potential(SireFF::PotentialTable &potentialtable, const SireCAS::Symbol &component,
+                   double scale_potential=1);
+
+    void field(SireFF::FieldTable &fieldtable, const SireFF::Probe &probe,
+               double scale_field=1);
+    
+    void field(SireFF::FieldTable &fieldtable, const SireCAS::Symbol &component,
+               const SireFF::Probe &probe, double scale_field=1);
+               
+    void potential(SireFF::PotentialTable &potentialtable, const SireFF::Probe &probe,
+                   double scale_potential=1);
+    
+    void potential(SireFF::PotentialTable &potentialtable, const SireCAS::Symbol &component,
+                   const SireFF::Probe &probe, double scale_potential=1);
+
     void mustNowRecalculateFromScratch();    
 
     void accept();
@@ -159,6 +226,12 @@ private:
     void rebuildProps();
     
     void regridAtoms();
+
+    QVector<double> rebuildSPMEMeshes();
+    QVector<double> calculateSPMEDeltas();
+    void acceptSPMEMeshes();
+
+    boost::tuple< QVector<double>,QVector<double> > calculateWithNeighbourLists();
     
     void _pvt_added(const SireMol::PartialMolecule &mol,
                     const SireBase::PropertyMap &map);
@@ -181,6 +254,16 @@ private:
     /** Implicitly shared pointer to the (mostly) const data for this forcefield */
     SireBase::SharedDataPointer<detail::InterFFData> d;
     
+    /** The reciprocal space meshes for each of the CLJFunctions
+        that are CLJSPMEFunctions (empty for the other functions,
+        or if there are no CLJSPMEFunctions) */
+    QVector<CLJSPMEMesh> spme_meshes;
+
+    /** The Verlet neighbour lists for each of the CLJFunctions,
+        used if neighbour lists are switched on. These are rebuilt
+        on demand, so are not saved */
+    QVector<CLJNeighbourList> nbr_lists;
+
     /** Whether or not we need to 'accept' this move */
     bool needs_accepting;
 };
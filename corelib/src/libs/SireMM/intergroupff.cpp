@@ -34,6 +34,11 @@
 #include "SireBase/lengthproperty.h"
 #include "SireBase/refcountdata.h"
 
+#include "SireFF/energyprofiler.h"
+#include "SireFF/errors.h"
+
+#include "SireCAS/symbols.h"
+
 #include "SireError/errors.h"
 #include "SireBase/errors.h"
 
@@ -48,6 +53,8 @@
 #include "SireStream/datastream.h"
 #include "SireStream/shareddatastream.h"
 
+#include "tostring.h"
+
 #include <QElapsedTimer>
 #include <QDebug>
 
@@ -57,6 +64,8 @@ using namespace SireFF;
 using namespace SireBase;
 using namespace SireStream;
 
+using SireCAS::Symbol;
+
 namespace SireMM
 {
     namespace detail
@@ -1007,6 +1016,8 @@ void InterGroupFF::recalculateEnergy()
 {
     if (cljgroup[0].recalculatingFromScratch() or cljgroup[1].recalculatingFromScratch())
     {
+        EnergyProfiler::recordFullCalculation();
+
         //calculate the energy from first principles and regenerate the
         //grid if needed
         cljgroup[0].accept();
@@ -1119,6 +1130,8 @@ void InterGroupFF::recalculateEnergy()
     }
     else if (cljgroup[0].needsAccepting())
     {
+        EnergyProfiler::recordDeltaCalculation();
+
         CLJAtoms changed_atoms = cljgroup[0].changedAtoms();
 
         //we can calculate using just the change in energy
@@ -1196,6 +1209,8 @@ void InterGroupFF::recalculateEnergy()
     }
     else if (cljgroup[1].needsAccepting())
     {
+        EnergyProfiler::recordDeltaCalculation();
+
         CLJAtoms changed_atoms = cljgroup[1].changedAtoms();
 
         //we can calculate using just the change in energy
@@ -1252,6 +1267,8 @@ void InterGroupFF::recalculateEnergy()
     }
     else
     {
+        EnergyProfiler::recordFullCalculation();
+
         //recalculate everything from scratch as this has been requested
         //calculate the energy from scratch
         cljgroup[0].accept();
@@ -1335,6 +1352,177 @@ void InterGroupFF::recalculateEnergy()
     }
 }
 
+/** Return the total energy of this forcefield */
+SireUnits::Dimension::MolarEnergy InterGroupFF::energy()
+{
+    return G2FF::energy();
+}
+
+/** Return the energy of the component 'component' of this forcefield */
+SireUnits::Dimension::MolarEnergy InterGroupFF::energy(const Symbol &component)
+{
+    return G2FF::energy(component);
+}
+
+/** Calculate the energies of molecules in the passed energy table
+    caused by this forcefield. This is not yet supported */
+void InterGroupFF::energy(EnergyTable&, double)
+{
+    throw SireError::incomplete_code( QObject::tr(
+            "InterGroupFF does not yet support energy table calculations!"), CODELOC );
+}
+
+/** Calculate the energies of molecules in the passed energy table
+    caused by the component 'symbol'. This is not yet supported */
+void InterGroupFF::energy(EnergyTable&, const Symbol&, double)
+{
+    throw SireError::incomplete_code( QObject::tr(
+            "InterGroupFF does not yet support energy table calculations!"), CODELOC );
+}
+
+/** Internal function used to return the index of the CLJFunction
+    whose total energy is represented by 'symbol'
+    
+    \throw SireError::unsupported
+    \throw SireFF::missing_component
+*/
+static int forceFunctionIndex(const MultiCLJComponent &comps, const Symbol &symbol)
+{
+    foreach (const QString &key, comps.keys())
+    {
+        if (symbol == comps.total(key))
+            return comps.indexOf(key);
+        
+        else if (symbol == comps.coulomb(key) or symbol == comps.lj(key))
+            throw SireError::unsupported( QObject::tr(
+                    "Forces can only be calculated for the total CLJ energy (%1), "
+                    "not for the component %2.")
+                        .arg(comps.total(key).toString(), symbol.toString()), CODELOC );
+    }
+    
+    throw SireFF::missing_component( QObject::tr(
+            "There is no component %1 in this forcefield. Available "
+            "components are %2.")
+                .arg(symbol.toString(), Sire::toString(comps.symbols())), CODELOC );
+    
+    return -1;
+}
+
+/** Calculate the forces acting on the molecules in the passed force table
+    caused by the component of this forcefield represented by 'symbol',
+    and add them onto the forces already in the force table (optionally
+    scaled by 'scale_force'). Forces can only be calculated for the
+    total energy of each CLJFunction. The interactions between group 0 and
+    the fixed atoms are calculated explicitly, even if a grid is used
+    for the energy
+    
+    \throw SireError::unsupported
+    \throw SireFF::missing_component
+*/
+void InterGroupFF::force(ForceTable &forcetable, const Symbol &symbol, double scale_force)
+{
+    if (scale_force == 0)
+        return;
+    
+    const int idx = forceFunctionIndex(d.constData()->cljcomps, symbol);
+    
+    const CLJFunction &func = d.constData()->cljfuncs.at(idx).read();
+    
+    if (not func.supportsForceCalculation())
+        throw SireError::unsupported( QObject::tr(
+                "Cannot calculate the forces for %1 as the CLJFunction \"%2\" "
+                "does not support the calculation of forces.")
+                    .arg(symbol.toString(), func.what()), CODELOC );
+
+    //the atoms are returned in a fixed order, which is used to add
+    //the forces back onto the molecules
+    const CLJAtoms atoms0 = cljgroup[0].atoms();
+    const CLJAtoms atoms1 = cljgroup[1].atoms();
+    
+    CLJForces forces0(atoms0);
+    CLJForces forces1(atoms1);
+    
+    if (not d.constData()->fixed_only)
+    {
+        func.force(atoms0, atoms1, forces0, forces1);
+    }
+    
+    //the interactions with the fixed atoms are calculated explicitly
+    const CLJAtoms fixed_atoms = d.constData()->fixed_atoms.at(idx).fixedAtoms();
+    
+    func.force(atoms0, fixed_atoms, forces0);
+    
+    cljgroup[0].addForces(forcetable, forces0, scale_force);
+    cljgroup[1].addForces(forcetable, forces1, scale_force);
+}
+
+/** Calculate the forces acting on the molecules in the passed force table
+    caused by this forcefield, and add them onto the forces already
+    in the force table (optionally scaled by 'scale_force')
+    
+    \throw SireError::unsupported
+*/
+void InterGroupFF::force(ForceTable &forcetable, double scale_force)
+{
+    this->force(forcetable, d.constData()->cljcomps.total(), scale_force);
+}
+
+void InterGroupFF::field(FieldTable&, double)
+{
+    throw SireError::incomplete_code( QObject::tr(
+                "Calculating the field of an InterGroupFF has yet to "
+                "be implemented."), CODELOC );
+}
+
+void InterGroupFF::field(FieldTable&, const Symbol&, double)
+{
+    throw SireError::incomplete_code( QObject::tr(
+                "Calculating the field of an InterGroupFF has yet to "
+                "be implemented."), CODELOC );
+}
+
+void InterGroupFF::field(FieldTable&, const Probe&, double)
+{
+    throw SireError::incomplete_code( QObject::tr(
+                "Calculating the field of an InterGroupFF has yet to "
+                "be implemented."), CODELOC );
+}
+
+void InterGroupFF::field(FieldTable&, const Symbol&, const Probe&, double)
+{
+    throw SireError::incomplete_code( QObject::tr(
+                "Calculating the field of an InterGroupFF has yet to "
+                "be implemented."), CODELOC );
+}
+
+void InterGroupFF::potential(PotentialTable&, double)
+{
+    throw SireError::incomplete_code( QObject::tr(
+                "Calculating the potential of an InterGroupFF has yet to "
+                "be implemented."), CODELOC );
+}
+
+void InterGroupFF::potential(PotentialTable&, const Symbol&, double)
+{
+    throw SireError::incomplete_code( QObject::tr(
+                "Calculating the potential of an InterGroupFF has yet to "
+                "be implemented."), CODELOC );
+}
+
+void InterGroupFF::potential(PotentialTable&, const Probe&, double)
+{
+    throw SireError::incomplete_code( QObject::tr(
+                "Calculating the potential of an InterGroupFF has yet to "
+                "be implemented."), CODELOC );
+}
+
+void InterGroupFF::potential(PotentialTable&, const Symbol&, const Probe&, double)
+{
+    throw SireError::incomplete_code( QObject::tr(
+                "Calculating the potential of an InterGroupFF has yet to "
+                "be implemented."), CODELOC );
+}
+
 /** Function called to add a molecule to this forcefield */
 void InterGroupFF::_pvt_added(quint32 group_id,
                               const SireMol::PartialMolecule &mol, const SireBase::PropertyMap &map)
@@ -37,6 +37,7 @@
 #include "SireBase/shareddatapointer.hpp"
 
 #include "SireFF/g2ff.h"
+#include "SireFF/ff3d.h"
 
 SIRE_BEGIN_HEADER
 
@@ -65,10 +66,16 @@ namespace detail
  
     It also calculates the interactions between all molecules in group 0
     with any fixed atoms added to this forcefield
+
+    The forces on the molecules are calculated for the total energy
+    of each CLJFunction that supports force calculation (see
+    CLJFunction::supportsForceCalculation). The fixed atoms are
+    included explicitly (not via the grid).
     
     @author Christopher Woods
 */
-class SIREMM_EXPORT InterGroupFF : public SireBase::ConcreteProperty<InterGroupFF,SireFF::G2FF>
+class SIREMM_EXPORT InterGroupFF : public SireBase::ConcreteProperty<InterGroupFF,SireFF::G2FF>,
+                                 public SireFF::FF3D
 {
 
 friend QDataStream& ::operator<<(QDataStream&, const InterGroupFF&);
@@ -149,6 +156,41 @@ public:
     bool containsProperty(const QString &name) const;
     const Properties& properties() const;
 
+    SireUnits::Dimension::MolarEnergy energy();
+    SireUnits::Dimension::MolarEnergy energy(const SireCAS::Symbol &component);
+
+    void energy(SireFF::EnergyTable &energytable, double scale_energy=1);
+    
+    void energy(SireFF::EnergyTable &energytable, const SireCAS::Symbol &symbol,
+                double scale_energy=1);
+
+    void force(SireFF::ForceTable &forcetable, double scale_force=1);
+    
+    void force(SireFF::ForceTable &forcetable, const SireCAS::Symbol &symbol,
+               double scale_force=1);
+               
+    void field(SireFF::FieldTable &fieldtable, double scale_field=1);
+    
+    void field(SireFF::FieldTable &fieldtable, const SireCAS::Symbol &component,
+               double scale_field=1);
+               
+    void potential(SireFF::PotentialTable &potentialtable, double scale_potential=1);
+    
+    void potential(SireFF::PotentialTable &potentialtable, const SireCAS::Symbol &component,
+                   double scale_potential=1);
+
+    void field(SireFF::FieldTable &fieldtable, const SireFF::Probe &probe,
+               double scale_field=1);
+    
+    void field(SireFF::FieldTable &fieldtable, const SireCAS::Symbol &component,
+               const SireFF::Probe &probe, double scale_field=1);
+               
+    void potential(SireFF::PotentialTable &potentialtable, const SireFF::Probe &probe,
+                   double scale_potential=1);
+    
+    void potential(SireFF::PotentialTable &potentialtable, const SireCAS::Symbol &component,
+                   const SireFF::Probe &probe, double scale_potential=1);
+
     void mustNowRecalculateFromScratch();    
 
     void accept();
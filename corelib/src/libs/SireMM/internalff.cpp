@@ -39,6 +39,7 @@
 #include "SireMol/mover.hpp"
 
 #include "SireFF/detail/atomiccoords3d.h"
+#include "SireFF/energyprofiler.h"
 
 #include "SireFF/errors.h"
 #include "SireBase/errors.h"
@@ -52,7 +53,11 @@
 
 #include "tostring.h"
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
 #include <QDebug>
+#include <QVarLengthArray>
 
 #include <cstdio>
 
@@ -338,100 +343,30 @@ static const Vector& getCoords(const CGAtomIdx &atom,
     return cgroup_array[ atom.cutGroup() ].constData()[ atom.atom() ];
 }
 
-/** Calculate the energy caused by the physical terms (bond, angle, dihedral) */
+/** Calculate the energy caused by the physical terms (bond, angle, dihedral).
+    These are evaluated using the packed, bucketed terms, so that harmonic
+    bonds and angles and cosine-series dihedrals use the vectorised kernels */
 void InternalPotential::calculatePhysicalEnergy(
                                          const GroupInternalParameters &group_params,
                                          const CoordGroup *cgroup_array,
                                          InternalPotential::Energy &energy,
                                          double scale_energy) const
 {
-    if (not group_params.bondPotential().isEmpty())
+    const detail::PackedInternals &packed = group_params.packedInternals();
+
+    if (packed.nBonds() > 0)
     {
-        //bonds only use the symbol 'r', representing the bond length
-        Values vals;
-        const Symbol &r = InternalPotential::symbols().bond().r();
-    
-        int nbonds = group_params.bondPotential().count();
-        const TwoAtomFunction *bonds_array = group_params.bondPotential().constData();
-        
-        double bndnrg = 0;
-        
-        for (int i=0; i<nbonds; ++i)
-        {
-            const TwoAtomFunction &bond = bonds_array[i];
-            
-            //get the coordinates of the two atoms in the bond
-            const Vector &atom0 = getCoords(bond.atom0(), cgroup_array);
-            const Vector &atom1 = getCoords(bond.atom1(), cgroup_array);
-            
-            //calculate the interatomic distance, r
-            double dist = Vector::distance(atom0, atom1);
-            
-            //substitute this distance into 'vals'
-            vals.set( r, dist );
-            
-            //calculate the energy
-            bndnrg += bond.function().evaluate(vals);
-        }
-        
-        energy += BondEnergy( scale_energy * bndnrg );
+        energy += BondEnergy( scale_energy * packed.bondEnergy(cgroup_array) );
     }
     
-    if (not group_params.anglePotential().isEmpty())
+    if (packed.nAngles() > 0)
     {
-        //angles use the symbol 'theta', representing the angle size
-        Values vals;
-        const Symbol &theta = InternalPotential::symbols().angle().theta();
-        
-        int nangles = group_params.anglePotential().count();
-        const ThreeAtomFunction *angles_array 
-                                    = group_params.anglePotential().constData();
-         
-        double angnrg = 0;
-                                                              
-        for (int i=0; i<nangles; ++i)
-        {
-            const ThreeAtomFunction &angle = angles_array[i];
-            
-            Angle ang = Vector::angle( getCoords(angle.atom0(), cgroup_array),
-                                       getCoords(angle.atom1(), cgroup_array),
-                                       getCoords(angle.atom2(), cgroup_array) );
-                           
-            vals.set(theta, ang.to(radians));
-            
-            angnrg += angle.function().evaluate(vals);
-        }
-        
-        energy += AngleEnergy( scale_energy * angnrg );
+        energy += AngleEnergy( scale_energy * packed.angleEnergy(cgroup_array) );
     }
     
-    if (not group_params.dihedralPotential().isEmpty())
+    if (packed.nDihedrals() > 0)
     {
-        //angles use the symbol 'phi', representing the torsion angle
-        Values vals;
-        const Symbol &phi = InternalPotential::symbols().dihedral().phi();
-        
-        int ndihedrals = group_params.dihedralPotential().count();
-        const FourAtomFunction *dihedrals_array 
-                                    = group_params.dihedralPotential().constData();
-         
-        double dihnrg = 0;
-                                                              
-        for (int i=0; i<ndihedrals; ++i)
-        {
-            const FourAtomFunction &dihedral = dihedrals_array[i];
-            
-            Angle ang = Vector::dihedral( getCoords(dihedral.atom0(), cgroup_array),
-                                          getCoords(dihedral.atom1(), cgroup_array),
-                                          getCoords(dihedral.atom2(), cgroup_array),
-                                          getCoords(dihedral.atom3(), cgroup_array) );
-                           
-            vals.set(phi, ang.to(radians));
-
-            dihnrg += dihedral.function().evaluate(vals);
-        }
-        
-        energy += DihedralEnergy( scale_energy * dihnrg );
+        energy += DihedralEnergy( scale_energy * packed.dihedralEnergy(cgroup_array) );
     }
 }
 
@@ -444,13 +379,12 @@ void InternalPotential::calculateNonPhysicalEnergy(
 {
     if (not group_params.improperPotential().isEmpty())
     {
-        Values vals;
-        const Symbol &theta = InternalPotential::symbols().improper().theta();
-        const Symbol &phi = InternalPotential::symbols().improper().phi();
-        
+        //impropers are compiled as functions of theta and phi (in that order)
         int nimpropers = group_params.improperPotential().count();
         const FourAtomFunction *impropers_array 
                                     = group_params.improperPotential().constData();
+        const CompiledExpression *funcs_array
+                                    = group_params.compiledImproperPotential().constData();
     
         double impnrg = 0;
         
@@ -466,10 +400,10 @@ void InternalPotential::calculateNonPhysicalEnergy(
             Angle theta_angle = torsion.improperAngle();
             Angle phi_angle = torsion.angle();
             
-            vals.set(theta, theta_angle);
-            vals.set(phi, phi_angle);
+            const double inputs[2] = { theta_angle.to(radians),
+                                       phi_angle.to(radians) };
             
-            impnrg += improper.function().evaluate(vals);
+            impnrg += funcs_array[i].evaluate(inputs);
         }
         
         energy += ImproperEnergy( scale_energy * impnrg );
@@ -477,12 +411,11 @@ void InternalPotential::calculateNonPhysicalEnergy(
     
     if (not group_params.ureyBradleyPotential().isEmpty())
     {
-        Values vals;
-        const Symbol &r = InternalPotential::symbols().ureyBradley().r();
-        
         int nubs = group_params.ureyBradleyPotential().count();
         const TwoAtomFunction *ub_array 
                                 = group_params.ureyBradleyPotential().constData();
+        const CompiledExpression *funcs_array
+                                = group_params.compiledUreyBradleyPotential().constData();
                                 
         double ubnrg = 0;
         
@@ -493,9 +426,7 @@ void InternalPotential::calculateNonPhysicalEnergy(
             double dist = Vector::distance( getCoords(ub.atom0(), cgroup_array),
                                             getCoords(ub.atom1(), cgroup_array) );
                                             
-            vals.set( r, dist );
-            
-            ubnrg += ub.function().evaluate(vals);
+            ubnrg += funcs_array[i].evaluate(dist);
         }
         
         energy += UreyBradleyEnergy( scale_energy * ubnrg );
@@ -720,9 +651,6 @@ void InternalPotential::calculateBondForce(const InternalPotential::Molecule &mo
     const CoordGroup *cgroup_array 
                              = molecule.parameters().atomicCoordinates().constData();
 
-    Values vals;
-    const Symbol &r = InternalPotential::symbols().bond().r();
-
     for (int i=0; i<ngroups; ++i)
     {
         const GroupInternalParameters &group_params = params_array[i];
@@ -735,15 +663,32 @@ void InternalPotential::calculateBondForce(const InternalPotential::Molecule &mo
             continue;
         }
                       
-        int nbonds = group_params.bondForces().count();
-        const TwoAtomFunction *bonds_array = group_params.bondForces().constData();
+        //use the packed bonds, which have analytic forces for harmonic bonds
+        const detail::PackedInternals &packed = group_params.packedInternals();
         
-        for (int j=0; j<nbonds; ++j)
+        int nbonds = packed.nBonds();
+        int nharmonic = packed.nHarmonicBonds();
+        const CGAtomIdx *atoms = packed.bondAtoms();
+        
+        //the harmonic bonds are calculated together using vectorised code
+        if (nharmonic > 0)
         {
-            const TwoAtomFunction &bond = bonds_array[j];
+            QVarLengthArray<Vector,128> harmonic_forces(2*nharmonic);
+            packed.harmonicBondForces(cgroup_array, harmonic_forces.data());
             
-            const Vector &atom0 = getCoords(bond.atom0(), cgroup_array);
-            const Vector &atom1 = getCoords(bond.atom1(), cgroup_array);
+            for (int j=0; j<2*nharmonic; ++j)
+            {
+                addForce(scale_force * harmonic_forces[j], atoms[j], forces);
+            }
+        }
+        
+        for (int j=nharmonic; j<nbonds; ++j)
+        {
+            const CGAtomIdx &bond_atom0 = atoms[2*j];
+            const CGAtomIdx &bond_atom1 = atoms[2*j+1];
+            
+            const Vector &atom0 = getCoords(bond_atom0, cgroup_array);
+            const Vector &atom1 = getCoords(bond_atom1, cgroup_array);
             
             Vector v01 = atom0 - atom1;
             double dist = v01.length();
@@ -753,14 +698,13 @@ void InternalPotential::calculateBondForce(const InternalPotential::Molecule &mo
                 continue;
             
             v01 /= dist;
-            vals.set( r, dist );
 
             //evaluate the force vector
-            Vector force = -scale_force * bond.function().evaluate(vals) * v01;
+            Vector force = -scale_force * packed.bondForce(j, dist) * v01;
 
             //add the force onto the forces array
-            addForce(-force, bond.atom0(), forces);
-            addForce(force, bond.atom1(), forces);
+            addForce(-force, bond_atom0, forces);
+            addForce(force, bond_atom1, forces);
         }
     }
 }
@@ -848,9 +792,6 @@ void InternalPotential::calculateAngleForce(const InternalPotential::Molecule &m
     const CoordGroup *cgroup_array 
                              = molecule.parameters().atomicCoordinates().constData();
 
-    Values vals;
-    const Symbol &theta = InternalPotential::symbols().angle().theta();
-
     for (int i=0; i<ngroups; ++i)
     {
         const GroupInternalParameters &group_params = params_array[i];
@@ -864,16 +805,34 @@ void InternalPotential::calculateAngleForce(const InternalPotential::Molecule &m
             continue;
         }
                       
-        int nangles = group_params.angleForces().count();
-        const ThreeAtomFunction *angles_array = group_params.angleForces().constData();
+        //use the packed angles, which have analytic forces for harmonic angles
+        const detail::PackedInternals &packed = group_params.packedInternals();
+        
+        int nangles = packed.nAngles();
+        int nharmonic = packed.nHarmonicAngles();
+        const CGAtomIdx *atoms = packed.angleAtoms();
+        
+        //the harmonic angles are calculated together using vectorised code
+        if (nharmonic > 0)
+        {
+            QVarLengthArray<Vector,128> harmonic_forces(3*nharmonic);
+            packed.harmonicAngleForces(cgroup_array, harmonic_forces.data());
+            
+            for (int j=0; j<3*nharmonic; ++j)
+            {
+                addForce(scale_force * harmonic_forces[j], atoms[j], forces);
+            }
+        }
         
-        for (int j=0; j<nangles; ++j)
+        for (int j=nharmonic; j<nangles; ++j)
         {
-            const ThreeAtomFunction &angle = angles_array[j];
+            const CGAtomIdx &angle_atom0 = atoms[3*j];
+            const CGAtomIdx &angle_atom1 = atoms[3*j+1];
+            const CGAtomIdx &angle_atom2 = atoms[3*j+2];
             
-            const Vector &atom0 = getCoords(angle.atom0(), cgroup_array);
-            const Vector &atom1 = getCoords(angle.atom1(), cgroup_array);
-            const Vector &atom2 = getCoords(angle.atom2(), cgroup_array);
+            const Vector &atom0 = getCoords(angle_atom0, cgroup_array);
+            const Vector &atom1 = getCoords(angle_atom1, cgroup_array);
+            const Vector &atom2 = getCoords(angle_atom2, cgroup_array);
 
             //-d V(theta) / dr  = -d V(theta) / dtheta  *  dtheta / dr
             
@@ -887,13 +846,12 @@ void InternalPotential::calculateAngleForce(const InternalPotential::Molecule &m
                           t, r01, r21);
                           
             //now calcualte -d V(theta) / d theta
-            vals.set(theta, t);
-            const double dv_by_dtheta = -scale_force * angle.function().evaluate(vals);
+            const double dv_by_dtheta = -scale_force * packed.angleForce(j, t.to(radians));
 
             //add the force onto the forces array
-            addForce(dv_by_dtheta * dtheta_by_d0, angle.atom0(), forces);
-            addForce(dv_by_dtheta * dtheta_by_d1, angle.atom1(), forces);
-            addForce(dv_by_dtheta * dtheta_by_d2, angle.atom2(), forces);
+            addForce(dv_by_dtheta * dtheta_by_d0, angle_atom0, forces);
+            addForce(dv_by_dtheta * dtheta_by_d1, angle_atom1, forces);
+            addForce(dv_by_dtheta * dtheta_by_d2, angle_atom2, forces);
         }
     }
 }
@@ -1023,9 +981,6 @@ void InternalPotential::calculateDihedralForce(
     const CoordGroup *cgroup_array 
                              = molecule.parameters().atomicCoordinates().constData();
 
-    Values vals;
-    const Symbol &phi = InternalPotential::symbols().dihedral().phi();
-
     for (int i=0; i<ngroups; ++i)
     {
         const GroupInternalParameters &group_params = params_array[i];
@@ -1040,18 +995,37 @@ void InternalPotential::calculateDihedralForce(
             continue;
         }
                       
-        int ndihedrals = group_params.dihedralForces().count();
-        const FourAtomFunction *dihedrals_array 
-                                    = group_params.dihedralForces().constData();
+        //use the packed dihedrals, which have analytic forces for
+        //cosine-series dihedrals
+        const detail::PackedInternals &packed = group_params.packedInternals();
+        
+        int ndihedrals = packed.nDihedrals();
+        int ncosine = packed.nCosineDihedrals();
+        const CGAtomIdx *atoms = packed.dihedralAtoms();
+        
+        //the cosine-series dihedrals are calculated together using vectorised code
+        if (ncosine > 0)
+        {
+            QVarLengthArray<Vector,128> cosine_forces(4*ncosine);
+            packed.cosineDihedralForces(cgroup_array, cosine_forces.data());
+            
+            for (int j=0; j<4*ncosine; ++j)
+            {
+                addForce(scale_force * cosine_forces[j], atoms[j], forces);
+            }
+        }
         
-        for (int j=0; j<ndihedrals; ++j)
+        for (int j=ncosine; j<ndihedrals; ++j)
         {
-            const FourAtomFunction &dihedral = dihedrals_array[j];
+            const CGAtomIdx &dihedral_atom0 = atoms[4*j];
+            const CGAtomIdx &dihedral_atom1 = atoms[4*j+1];
+            const CGAtomIdx &dihedral_atom2 = atoms[4*j+2];
+            const CGAtomIdx &dihedral_atom3 = atoms[4*j+3];
             
-            const Vector &atom0 = getCoords(dihedral.atom0(), cgroup_array);
-            const Vector &atom1 = getCoords(dihedral.atom1(), cgroup_array);
-            const Vector &atom2 = getCoords(dihedral.atom2(), cgroup_array);
-            const Vector &atom3 = getCoords(dihedral.atom3(), cgroup_array);
+            const Vector &atom0 = getCoords(dihedral_atom0, cgroup_array);
+            const Vector &atom1 = getCoords(dihedral_atom1, cgroup_array);
+            const Vector &atom2 = getCoords(dihedral_atom2, cgroup_array);
+            const Vector &atom3 = getCoords(dihedral_atom3, cgroup_array);
 
             //-d V(phi) / dr  = -d V(phi) / dphi  *  dphi / dr
             
@@ -1062,14 +1036,14 @@ void InternalPotential::calculateDihedralForce(
                         dphi_by_d0, dphi_by_d1, dphi_by_d2, dphi_by_d3);
                           
             //now calcualte -d V(phi) / d phi
-            vals.set(phi, Vector::dihedral(atom0,atom1,atom2,atom3).to(radians));
-            double dv_by_dphi = -scale_force * dihedral.function().evaluate(vals);
+            const double phi = Vector::dihedral(atom0,atom1,atom2,atom3).to(radians);
+            double dv_by_dphi = -scale_force * packed.dihedralForce(j, phi);
 
             //add the force onto the forces array
-            addForce(dv_by_dphi * dphi_by_d0, dihedral.atom0(), forces);
-            addForce(dv_by_dphi * dphi_by_d1, dihedral.atom1(), forces);
-            addForce(dv_by_dphi * dphi_by_d2, dihedral.atom2(), forces);
-            addForce(dv_by_dphi * dphi_by_d3, dihedral.atom3(), forces);
+            addForce(dv_by_dphi * dphi_by_d0, dihedral_atom0, forces);
+            addForce(dv_by_dphi * dphi_by_d1, dihedral_atom1, forces);
+            addForce(dv_by_dphi * dphi_by_d2, dihedral_atom2, forces);
+            addForce(dv_by_dphi * dphi_by_d3, dihedral_atom3, forces);
         }
     }
 }
@@ -2628,21 +2602,65 @@ const FFComponent& InternalFF::_pvt_components() const
     will recalculate the energy using the quickest possible route, e.g.
     if will only recalculate the energies of molecules that have changed
     since the last evaluation */
+namespace SireMM
+{
+    namespace detail
+    {
+        /** Functor used to calculate the internal energies of 
+            the molecules in parallel */
+        class MoleculeEnergies
+        {
+        public:
+            MoleculeEnergies(const InternalPotential *potential,
+                             const ChunkedVector<InternalPotential::Molecule> *molecules,
+                             InternalPotential::Energy *energies)
+                : pot(potential), mols(molecules), nrgs(energies)
+            {}
+            
+            ~MoleculeEnergies()
+            {}
+            
+            void operator()(const tbb::blocked_range<int> &range) const
+            {
+                for (int i = range.begin(); i != range.end(); ++i)
+                {
+                    pot->calculateEnergy( mols->at(i), nrgs[i] );
+                }
+            }
+            
+        private:
+            const InternalPotential *pot;
+            const ChunkedVector<InternalPotential::Molecule> *mols;
+            InternalPotential::Energy *nrgs;
+        };
+    }
+}
+
 void InternalFF::recalculateEnergy()
 {
     if (changed_mols.isEmpty())
     {
         //nothing appears to have changed, so lets recalculate
         //everything from scratch
+        EnergyProfiler::recordFullCalculation();
+    
         int nmols = mols.count();
         const ChunkedVector<InternalPotential::Molecule> &mols_array 
                                             = mols.moleculesByIndex();
         
+        //each molecule is independent, so calculate their energies
+        //in parallel and then sum them in a fixed order so that
+        //the result is reproducible
+        QVector<Energy> mol_nrgs(nmols);
+        
+        tbb::parallel_for( tbb::blocked_range<int>(0,nmols),
+                           MoleculeEnergies(this, &mols_array, mol_nrgs.data()) );
+        
         Energy total_nrg;
         
         for (int i=0; i<nmols; ++i)
         {
-            InternalPotential::calculateEnergy( mols_array[i], total_nrg );
+            total_nrg += mol_nrgs.at(i);
         }
         
         if (calc_14_nrgs)
@@ -2668,6 +2686,8 @@ void InternalFF::recalculateEnergy()
     {
         //only some of the molecules have changed - calculate the
         //change in energy
+        EnergyProfiler::recordDeltaCalculation();
+    
         Energy old_nrg;
         Energy new_nrg;
 
@@ -56,6 +56,58 @@ using namespace SireFF::detail;
 
 using namespace SireStream;
 
+Q_GLOBAL_STATIC( InternalSymbols, compiledSymbols );
+
+/** Compile the energy functions of the internals in 'potential' against
+    the input symbols 'symbols', so that InternalFF can evaluate them
+    without walking the expression trees */
+template<class T>
+static QVector<CompiledExpression> compileFunctions(const QVector<T> &potential,
+                                                    const QList<Symbol> &symbols)
+{
+    QVector<CompiledExpression> compiled( potential.count() );
+    
+    for (int i=0; i<potential.count(); ++i)
+    {
+        compiled[i] = CompiledExpression(potential.at(i).function(), symbols);
+    }
+    
+    return compiled;
+}
+
+/** Compile the bond (or Urey-Bradley) potentials - these use only 'r' */
+static QVector<CompiledExpression> compileBonds(
+                                        const QVector<TwoAtomFunction> &potential)
+{
+    return compileFunctions( potential,
+                             QList<Symbol>() << compiledSymbols()->bond().r() );
+}
+
+/** Compile the angle potentials - these use only 'theta' */
+static QVector<CompiledExpression> compileAngles(
+                                        const QVector<ThreeAtomFunction> &potential)
+{
+    return compileFunctions( potential,
+                             QList<Symbol>() << compiledSymbols()->angle().theta() );
+}
+
+/** Compile the dihedral potentials - these use only 'phi' */
+static QVector<CompiledExpression> compileDihedrals(
+                                        const QVector<FourAtomFunction> &potential)
+{
+    return compileFunctions( potential,
+                             QList<Symbol>() << compiledSymbols()->dihedral().phi() );
+}
+
+/** Compile the improper potentials - these use 'theta' and 'phi' */
+static QVector<CompiledExpression> compileImpropers(
+                                        const QVector<FourAtomFunction> &potential)
+{
+    return compileFunctions( potential,
+                             QList<Symbol>() << compiledSymbols()->improper().theta()
+                                             << compiledSymbols()->improper().phi() );
+}
+
 //////////
 ////////// Implementation of SireMM::detail::CGIDQuad
 //////////
@@ -277,6 +329,9 @@ QDataStream& operator>>(QDataStream &ds,
     sds >> group.improper_params
         >> group.improper_theta_forces >> group.improper_phi_forces
         >> group.ub_params >> group.ub_forces;
+    
+    group.improper_compiled = compileImpropers(group.improper_params);
+    group.ub_compiled = compileBonds(group.ub_params);
         
     return ds;
 }
@@ -292,7 +347,9 @@ GroupInternalNonPhysParameters::GroupInternalNonPhysParameters(
           improper_params(other.improper_params),
           improper_theta_forces(other.improper_theta_forces),
           improper_phi_forces(other.improper_phi_forces),
-          ub_params(other.ub_params), ub_forces(other.ub_forces)
+          ub_params(other.ub_params), ub_forces(other.ub_forces),
+          improper_compiled(other.improper_compiled),
+          ub_compiled(other.ub_compiled)
 {}
 
 /** Destructor */
@@ -311,6 +368,9 @@ GroupInternalNonPhysParameters& GroupInternalNonPhysParameters::operator=(
         
         ub_params = other.ub_params;
         ub_forces = other.ub_forces;
+        
+        improper_compiled = other.improper_compiled;
+        ub_compiled = other.ub_compiled;
     }
     
     return *this;
@@ -493,6 +553,14 @@ QDataStream& operator>>(QDataStream &ds,
         >> group.angle_params >> group.angle_forces
         >> group.dihedral_params >> group.dihedral_forces
         >> group.nonphys_terms >> group.cross_terms;
+    
+    group.bond_compiled = compileBonds(group.bond_params);
+    group.angle_compiled = compileAngles(group.angle_params);
+    group.dihedral_compiled = compileDihedrals(group.dihedral_params);
+    
+    group.packed.setBonds(group.bond_params, group.bond_compiled);
+    group.packed.setAngles(group.angle_params, group.angle_compiled);
+    group.packed.setDihedrals(group.dihedral_params, group.dihedral_compiled);
         
     return ds;
 }
@@ -526,6 +594,9 @@ GroupInternalParametersData::GroupInternalParametersData(
         bond_params(other.bond_params), bond_forces(other.bond_forces),
         angle_params(other.angle_params), angle_forces(other.angle_forces),
         dihedral_params(other.dihedral_params), dihedral_forces(other.dihedral_forces),
+        bond_compiled(other.bond_compiled), angle_compiled(other.angle_compiled),
+        dihedral_compiled(other.dihedral_compiled),
+        packed(other.packed),
         nonphys_terms(other.nonphys_terms),
         cross_terms(other.cross_terms)
 {}
@@ -547,6 +618,10 @@ GroupInternalParametersData& GroupInternalParametersData::operator=(
         angle_forces = other.angle_forces;
         dihedral_params = other.dihedral_params;
         dihedral_forces = other.dihedral_forces;
+        bond_compiled = other.bond_compiled;
+        angle_compiled = other.angle_compiled;
+        dihedral_compiled = other.dihedral_compiled;
+        packed = other.packed;
         nonphys_terms = other.nonphys_terms;
         cross_terms = other.cross_terms;
     }
@@ -861,6 +936,47 @@ const QVector<TwoAtomFunction>& GroupInternalParameters::ureyBradleyForces() con
     return d->nonphys_terms->ub_forces;
 }
 
+/** Return the bond, angle and dihedral terms of this group
+    packed into buckets by functional form */
+const detail::PackedInternals& GroupInternalParameters::packedInternals() const
+{
+    return d->packed;
+}
+
+/** Return the compiled bond potentials for this group */
+const QVector<CompiledExpression>& GroupInternalParameters::compiledBondPotential() const
+{
+    return d->bond_compiled;
+}
+
+/** Return the compiled angle potentials for this group */
+const QVector<CompiledExpression>& GroupInternalParameters::compiledAnglePotential() const
+{
+    return d->angle_compiled;
+}
+
+/** Return the compiled dihedral potentials for this group */
+const QVector<CompiledExpression>& 
+GroupInternalParameters::compiledDihedralPotential() const
+{
+    return d->dihedral_compiled;
+}
+
+/** Return the compiled improper potentials for this group. These
+    take the values of theta and phi (in that order) as inputs */
+const QVector<CompiledExpression>& 
+GroupInternalParameters::compiledImproperPotential() const
+{
+    return d->nonphys_terms->improper_compiled;
+}
+
+/** Return the compiled Urey-Bradley potentials for this group */
+const QVector<CompiledExpression>& 
+GroupInternalParameters::compiledUreyBradleyPotential() const
+{
+    return d->nonphys_terms->ub_compiled;
+}
+
 /** Return the stretch-stretch potentials for this group */
 const QVector<ThreeAtomFunction>& 
 GroupInternalParameters::stretchStretchPotential() const
@@ -1001,6 +1117,8 @@ void GroupInternalParameters::setBondPotential(
 {
     d->bond_params = potential;
     d->bond_forces = forces;
+    d->bond_compiled = compileBonds(potential);
+    d->packed.setBonds(potential, d->bond_compiled);
 }
                        
 /** Internal function used to set the angle parameters */
@@ -1010,6 +1128,8 @@ void GroupInternalParameters::setAnglePotential(
 {
     d->angle_params = potential;
     d->angle_forces = forces;
+    d->angle_compiled = compileAngles(potential);
+    d->packed.setAngles(potential, d->angle_compiled);
 }
 
 /** Internal function used to set the dihedral parameters */
@@ -1019,6 +1139,8 @@ void GroupInternalParameters::setDihedralPotential(
 {
     d->dihedral_params = potential;
     d->dihedral_forces = forces;
+    d->dihedral_compiled = compileDihedrals(potential);
+    d->packed.setDihedrals(potential, d->dihedral_compiled);
 }
 
 /** Internal function used to set the improper parameters */
@@ -1030,6 +1152,7 @@ void GroupInternalParameters::setImproperPotential(
     d->nonphys_terms->improper_params = potential;
     d->nonphys_terms->improper_theta_forces = theta_forces;
     d->nonphys_terms->improper_phi_forces = phi_forces;
+    d->nonphys_terms->improper_compiled = compileImpropers(potential);
 }
                            
 /** Internal function used to set the Urey-Bradley parameters */
@@ -1039,6 +1162,7 @@ void GroupInternalParameters::setUreyBradleyPotential(
 {
     d->nonphys_terms->ub_params = potential;
     d->nonphys_terms->ub_forces = forces;
+    d->nonphys_terms->ub_compiled = compileBonds(potential);
 }
 
 /** Internal function used to set the stretch-stretch parameters */
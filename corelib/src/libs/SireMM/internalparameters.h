@@ -34,10 +34,13 @@
 #include "twoatomfunctions.h"
 #include "threeatomfunctions.h"
 #include "fouratomfunctions.h"
+#include "packedinternals.h"
 
 #include "SireBase/refcountdata.h"
 #include "SireBase/shareddatapointer.hpp"
 
+#include "SireCAS/compiledexpression.h"
+
 #include "SireMol/cgidx.h"
 
 #include "SireFF/detail/atomiccoords3d.h"
@@ -85,6 +88,8 @@ using SireMol::PartialMolecule;
 
 using SireBase::PropertyName;
 
+using SireCAS::CompiledExpression;
+
 namespace detail
 {
 
@@ -153,6 +158,9 @@ public:
 
     /** The array of Urey-Bradley parameters and forces */
     QVector<TwoAtomFunction> ub_params, ub_forces;
+
+    /** The compiled improper and Urey-Bradley potentials */
+    QVector<SireCAS::CompiledExpression> improper_compiled, ub_compiled;
 };
 
 /** Internal class used to hold the cross-term parameters
@@ -250,6 +258,14 @@ public:
     /** The array of dihedral parameters and forces */
     QVector<FourAtomFunction> dihedral_params, dihedral_forces;
 
+    /** The compiled bond, angle and dihedral potentials */
+    QVector<SireCAS::CompiledExpression> bond_compiled, angle_compiled,
+                                         dihedral_compiled;
+
+    /** The bond, angle and dihedral terms packed into buckets
+        by functional form */
+    PackedInternals packed;
+
     /** Shared pointer to the non-physical terms (impropers
         and Urey-Bradley) - no all groups will have these
         terms, so it is best to hide them to save space */
@@ -356,6 +372,14 @@ public:
     
     const QVector<TwoAtomFunction>& ureyBradleyPotential() const;
     const QVector<TwoAtomFunction>& ureyBradleyForces() const;
+
+    const QVector<SireCAS::CompiledExpression>& compiledBondPotential() const;
+    const QVector<SireCAS::CompiledExpression>& compiledAnglePotential() const;
+    const QVector<SireCAS::CompiledExpression>& compiledDihedralPotential() const;
+    const QVector<SireCAS::CompiledExpression>& compiledImproperPotential() const;
+    const QVector<SireCAS::CompiledExpression>& compiledUreyBradleyPotential() const;
+
+    const detail::PackedInternals& packedInternals() const;
     
     const QVector<ThreeAtomFunction>& stretchStretchPotential() const;
     const QVector<ThreeAtomFunction>& stretchStretch_R01_Forces() const;
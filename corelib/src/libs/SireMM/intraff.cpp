@@ -35,6 +35,8 @@
 #include "SireBase/lengthproperty.h"
 #include "SireBase/refcountdata.h"
 
+#include "SireFF/energyprofiler.h"
+
 #include "SireError/errors.h"
 #include "SireBase/errors.h"
 
@@ -1103,6 +1105,8 @@ void IntraFF::recalculateEnergy()
         cljenergy = MultiCLJEnergy(zero, zero);
     }
     
+    int nrecalculated = 0;
+    
     for (MolData::iterator it = moldata.begin();
          it != moldata.end();
          ++it)
@@ -1111,6 +1115,7 @@ void IntraFF::recalculateEnergy()
         {
             cljenergy += this->calcEnergy(*(it.value()));
             needs_accepting = needs_accepting or it.value().constData()->needs_accepting;
+            nrecalculated += 1;
         }
         else
         {
@@ -1118,6 +1123,12 @@ void IntraFF::recalculateEnergy()
         }
     }
 
+    //this is a full recalculation only if every molecule had to be recalculated
+    if (nrecalculated == moldata.count())
+        EnergyProfiler::recordFullCalculation();
+    else
+        EnergyProfiler::recordDeltaCalculation();
+
     d.constData()->cljcomps.setEnergy(*this, cljenergy);
     setClean();
 }
@@ -35,6 +35,8 @@
 #include "SireBase/lengthproperty.h"
 #include "SireBase/refcountdata.h"
 
+#include "SireFF/energyprofiler.h"
+
 #include "SireError/errors.h"
 #include "SireBase/errors.h"
 
@@ -1233,6 +1235,8 @@ void IntraGroupFF::recalculateEnergy()
         cljenergy = MultiCLJEnergy(zero, zero);
     }
     
+    int nrecalculated = 0;
+    
     for (MolData::iterator it = moldata.begin();
          it != moldata.end();
          ++it)
@@ -1241,6 +1245,7 @@ void IntraGroupFF::recalculateEnergy()
         {
             cljenergy += this->calcEnergy(*(it.value()));
             needs_accepting = needs_accepting or it.value().constData()->needs_accepting;
+            nrecalculated += 1;
         }
         else
         {
@@ -1248,6 +1253,12 @@ void IntraGroupFF::recalculateEnergy()
         }
     }
 
+    //this is a full recalculation only if every molecule had to be recalculated
+    if (nrecalculated == moldata.count())
+        EnergyProfiler::recordFullCalculation();
+    else
+        EnergyProfiler::recordDeltaCalculation();
+
     d.constData()->cljcomps.setEnergy(*this, cljenergy);
     setClean();
 }
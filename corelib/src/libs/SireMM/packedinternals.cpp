@@ -0,0 +1,841 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "packedinternals.h"
+
+#include "SireVol/coordgroup.h"
+
+#include "SireMaths/vector.h"
+#include "SireMaths/maths.h"
+
+#include "SireUnits/dimensions.h"
+#include "SireUnits/units.h"
+
+#include <QVarLengthArray>
+
+#include <cmath>
+
+using namespace SireMM;
+using namespace SireMM::detail;
+using namespace SireMaths;
+using namespace SireVol;
+using namespace SireCAS;
+using namespace SireUnits;
+using namespace SireUnits::Dimension;
+
+/** Return the coordinates of the atom 'atom' using the coordinates in 'cgroup_array' */
+static const Vector& getCoords(const CGAtomIdx &atom,
+                               const CoordGroup *cgroup_array)
+{
+    return cgroup_array[ atom.cutGroup() ].constData()[ atom.atom() ];
+}
+
+/** Pack the harmonic parameters (k, a, b) of the terms whose compiled
+    functions are in 'harmonic' into MultiDoubles. Padding values have
+    k == 0, so contribute nothing to the energy */
+static void packHarmonic(const QVector<CompiledExpression> &harmonic,
+                         QVector<MultiDouble> &k, QVector<MultiDouble> &a,
+                         QVector<MultiDouble> &b)
+{
+    const int n = harmonic.count();
+    
+    QVector<double> kvals(n), avals(n), bvals(n);
+    
+    for (int i=0; i<n; ++i)
+    {
+        const QVector<double> params = harmonic.at(i).parameters();
+        kvals[i] = params.at(0);
+        avals[i] = params.at(1);
+        bvals[i] = params.at(2);
+    }
+    
+    k = MultiDouble::fromArray(kvals);
+    a = MultiDouble::fromArray(avals);
+    b = MultiDouble::fromArray(bvals);
+}
+
+/** Return the scalar value at index 'i' of the packed array 'array' */
+static double unpack(const QVector<MultiDouble> &array, int i)
+{
+    return array.constData()[ i / MultiDouble::count() ].at( i % MultiDouble::count() );
+}
+
+/** Return the compiled function -dE/dx of the compiled energy 'nrg' */
+static CompiledExpression compileForce(const CompiledExpression &nrg)
+{
+    if (nrg.inputs().isEmpty())
+        return CompiledExpression();
+        
+    const Symbol &x = nrg.inputs().at(0);
+    
+    return CompiledExpression( -(nrg.expression().differentiate(x)), nrg.inputs() );
+}
+
+/** Constructor */
+PackedInternals::PackedInternals()
+                : nharm_bonds(0), nharm_angles(0), ncos_dihedrals(0)
+{}
+
+/** Copy constructor */
+PackedInternals::PackedInternals(const PackedInternals &other)
+    : bond_atoms(other.bond_atoms),
+      bond_k(other.bond_k), bond_a(other.bond_a), bond_b(other.bond_b),
+      bond_nrgs(other.bond_nrgs), bond_frcs(other.bond_frcs),
+      angle_atoms(other.angle_atoms),
+      angle_k(other.angle_k), angle_a(other.angle_a), angle_b(other.angle_b),
+      angle_nrgs(other.angle_nrgs), angle_frcs(other.angle_frcs),
+      dihedral_atoms(other.dihedral_atoms),
+      cos_c(other.cos_c), cos_start(other.cos_start),
+      cos_k(other.cos_k), cos_n(other.cos_n), cos_d(other.cos_d),
+      dihedral_nrgs(other.dihedral_nrgs), dihedral_frcs(other.dihedral_frcs),
+      nharm_bonds(other.nharm_bonds), nharm_angles(other.nharm_angles),
+      ncos_dihedrals(other.ncos_dihedrals)
+{}
+
+/** Destructor */
+PackedInternals::~PackedInternals()
+{}
+
+/** Copy assignment operator */
+PackedInternals& PackedInternals::operator=(const PackedInternals &other)
+{
+    if (this != &other)
+    {
+        bond_atoms = other.bond_atoms;
+        bond_k = other.bond_k;
+        bond_a = other.bond_a;
+        bond_b = other.bond_b;
+        bond_nrgs = other.bond_nrgs;
+        bond_frcs = other.bond_frcs;
+        
+        angle_atoms = other.angle_atoms;
+        angle_k = other.angle_k;
+        angle_a = other.angle_a;
+        angle_b = other.angle_b;
+        angle_nrgs = other.angle_nrgs;
+        angle_frcs = other.angle_frcs;
+        
+        dihedral_atoms = other.dihedral_atoms;
+        cos_c = other.cos_c;
+        cos_start = other.cos_start;
+        cos_k = other.cos_k;
+        cos_n = other.cos_n;
+        cos_d = other.cos_d;
+        dihedral_nrgs = other.dihedral_nrgs;
+        dihedral_frcs = other.dihedral_frcs;
+        
+        nharm_bonds = other.nharm_bonds;
+        nharm_angles = other.nharm_angles;
+        ncos_dihedrals = other.ncos_dihedrals;
+    }
+    
+    return *this;
+}
+
+/** Sort the bonds in 'bonds' (whose compiled energy functions are
+    in 'compiled') into the harmonic and generic buckets */
+void PackedInternals::setBonds(const QVector<TwoAtomFunction> &bonds,
+                               const QVector<CompiledExpression> &compiled)
+{
+    QVector<CompiledExpression> harmonic;
+    QVector<CGAtomIdx> harmonic_atoms, generic_atoms;
+    
+    bond_nrgs.clear();
+    bond_frcs.clear();
+    
+    for (int i=0; i<bonds.count(); ++i)
+    {
+        const TwoAtomFunction &bond = bonds.at(i);
+        const CompiledExpression &func = compiled.at(i);
+        
+        if (func.kernel() == CompiledExpression::HARMONIC)
+        {
+            harmonic.append(func);
+            harmonic_atoms << bond.atom0() << bond.atom1();
+        }
+        else
+        {
+            bond_nrgs.append(func);
+            bond_frcs.append( compileForce(func) );
+            generic_atoms << bond.atom0() << bond.atom1();
+        }
+    }
+    
+    nharm_bonds = harmonic.count();
+    bond_atoms = harmonic_atoms + generic_atoms;
+    packHarmonic(harmonic, bond_k, bond_a, bond_b);
+}
+
+/** Sort the angles in 'angles' (whose compiled energy functions are
+    in 'compiled') into the harmonic and generic buckets */
+void PackedInternals::setAngles(const QVector<ThreeAtomFunction> &angles,
+                                const QVector<CompiledExpression> &compiled)
+{
+    QVector<CompiledExpression> harmonic;
+    QVector<CGAtomIdx> harmonic_atoms, generic_atoms;
+    
+    angle_nrgs.clear();
+    angle_frcs.clear();
+    
+    for (int i=0; i<angles.count(); ++i)
+    {
+        const ThreeAtomFunction &angle = angles.at(i);
+        const CompiledExpression &func = compiled.at(i);
+        
+        if (func.kernel() == CompiledExpression::HARMONIC)
+        {
+            harmonic.append(func);
+            harmonic_atoms << angle.atom0() << angle.atom1() << angle.atom2();
+        }
+        else
+        {
+            angle_nrgs.append(func);
+            angle_frcs.append( compileForce(func) );
+            generic_atoms << angle.atom0() << angle.atom1() << angle.atom2();
+        }
+    }
+    
+    nharm_angles = harmonic.count();
+    angle_atoms = harmonic_atoms + generic_atoms;
+    packHarmonic(harmonic, angle_k, angle_a, angle_b);
+}
+
+/** Sort the dihedrals in 'dihedrals' (whose compiled energy functions are
+    in 'compiled') into the cosine and generic buckets */
+void PackedInternals::setDihedrals(const QVector<FourAtomFunction> &dihedrals,
+                                   const QVector<CompiledExpression> &compiled)
+{
+    QVector<CGAtomIdx> cosine_atoms, generic_atoms;
+    
+    cos_c.clear();
+    cos_start.clear();
+    cos_k.clear();
+    cos_n.clear();
+    cos_d.clear();
+    dihedral_nrgs.clear();
+    dihedral_frcs.clear();
+    
+    for (int i=0; i<dihedrals.count(); ++i)
+    {
+        const FourAtomFunction &dihedral = dihedrals.at(i);
+        const CompiledExpression &func = compiled.at(i);
+        
+        if (func.kernel() == CompiledExpression::FOURIER)
+        {
+            const QVector<double> params = func.parameters();
+            
+            cos_c.append(params.at(0));
+            cos_start.append(cos_k.count());
+            
+            for (int j=1; j<params.count(); j+=3)
+            {
+                cos_k.append(params.at(j));
+                cos_n.append(params.at(j+1));
+                cos_d.append(params.at(j+2));
+            }
+            
+            cosine_atoms << dihedral.atom0() << dihedral.atom1()
+                         << dihedral.atom2() << dihedral.atom3();
+        }
+        else
+        {
+            dihedral_nrgs.append(func);
+            dihedral_frcs.append( compileForce(func) );
+            generic_atoms << dihedral.atom0() << dihedral.atom1()
+                          << dihedral.atom2() << dihedral.atom3();
+        }
+    }
+    
+    cos_start.append(cos_k.count());
+    
+    ncos_dihedrals = cos_c.count();
+    dihedral_atoms = cosine_atoms + generic_atoms;
+}
+
+/** Return the total energy of the bonds, using the coordinates
+    in 'cgroup_array' */
+double PackedInternals::bondEnergy(const CoordGroup *cgroup_array) const
+{
+    const CGAtomIdx *atoms = bond_atoms.constData();
+    
+    double nrg = 0;
+    
+    if (nharm_bonds > 0)
+    {
+        //gather the bond vectors, then calculate the energies
+        //MultiDouble::count() bonds at a time
+        QVarLengthArray<double,256> dx(nharm_bonds), dy(nharm_bonds), dz(nharm_bonds);
+        
+        for (int i=0; i<nharm_bonds; ++i)
+        {
+            const Vector d = getCoords(atoms[2*i], cgroup_array) -
+                             getCoords(atoms[2*i+1], cgroup_array);
+            
+            dx[i] = d.x();
+            dy[i] = d.y();
+            dz[i] = d.z();
+        }
+        
+        const QVector<MultiDouble> mx = MultiDouble::fromArray(dx.constData(), nharm_bonds);
+        const QVector<MultiDouble> my = MultiDouble::fromArray(dy.constData(), nharm_bonds);
+        const QVector<MultiDouble> mz = MultiDouble::fromArray(dz.constData(), nharm_bonds);
+        
+        const MultiDouble *k = bond_k.constData();
+        const MultiDouble *a = bond_a.constData();
+        const MultiDouble *b = bond_b.constData();
+        
+        MultiDouble total(0);
+        
+        for (int i=0; i<mx.count(); ++i)
+        {
+            const MultiDouble r = (mx[i]*mx[i] + my[i]*my[i] + mz[i]*mz[i]).sqrt();
+            const MultiDouble t = a[i]*r + b[i];
+            
+            total += k[i] * t * t;
+        }
+        
+        nrg += total.sum();
+    }
+    
+    for (int i=nharm_bonds; i<nBonds(); ++i)
+    {
+        const double r = Vector::distance( getCoords(atoms[2*i], cgroup_array),
+                                           getCoords(atoms[2*i+1], cgroup_array) );
+                                           
+        nrg += bond_nrgs.constData()[i-nharm_bonds].evaluate(r);
+    }
+    
+    return nrg;
+}
+
+/** Return the total energy of the angles, using the coordinates
+    in 'cgroup_array' */
+double PackedInternals::angleEnergy(const CoordGroup *cgroup_array) const
+{
+    const CGAtomIdx *atoms = angle_atoms.constData();
+    
+    double nrg = 0;
+    
+    if (nharm_angles > 0)
+    {
+        //calculate the cosine of each angle MultiDouble::count() angles at
+        //a time, then calculate the angles (there is no vectorised acos)
+        //and then the energies
+        QVarLengthArray<double,256> ax(nharm_angles), ay(nharm_angles), az(nharm_angles);
+        QVarLengthArray<double,256> bx(nharm_angles), by(nharm_angles), bz(nharm_angles);
+        
+        for (int i=0; i<nharm_angles; ++i)
+        {
+            const Vector &atom1 = getCoords(atoms[3*i+1], cgroup_array);
+        
+            const Vector v10 = getCoords(atoms[3*i], cgroup_array) - atom1;
+            const Vector v12 = getCoords(atoms[3*i+2], cgroup_array) - atom1;
+            
+            ax[i] = v10.x();
+            ay[i] = v10.y();
+            az[i] = v10.z();
+            bx[i] = v12.x();
+            by[i] = v12.y();
+            bz[i] = v12.z();
+        }
+        
+        QVector<MultiDouble> max = MultiDouble::fromArray(ax.constData(), nharm_angles);
+        QVector<MultiDouble> may = MultiDouble::fromArray(ay.constData(), nharm_angles);
+        QVector<MultiDouble> maz = MultiDouble::fromArray(az.constData(), nharm_angles);
+        QVector<MultiDouble> mbx = MultiDouble::fromArray(bx.constData(), nharm_angles);
+        QVector<MultiDouble> mby = MultiDouble::fromArray(by.constData(), nharm_angles);
+        QVector<MultiDouble> mbz = MultiDouble::fromArray(bz.constData(), nharm_angles);
+        
+        const MultiDouble *k = angle_k.constData();
+        const MultiDouble *a = angle_a.constData();
+        const MultiDouble *b = angle_b.constData();
+        
+        MultiDouble total(0);
+        
+        for (int i=0; i<max.count(); ++i)
+        {
+            const MultiDouble d = max[i]*mbx[i] + may[i]*mby[i] + maz[i]*mbz[i];
+            const MultiDouble lt = (max[i]*max[i] + may[i]*may[i] + maz[i]*maz[i]).sqrt() *
+                                   (mbx[i]*mbx[i] + mby[i]*mby[i] + mbz[i]*mbz[i]).sqrt();
+            
+            //same as Vector::angle
+            MultiDouble theta(0);
+            
+            for (int j=0; j<MultiDouble::count(); ++j)
+            {
+                const double l = lt.at(j);
+                
+                if (not SireMaths::isZero(l))
+                    theta.set(j, std::acos(d.at(j) / l));
+            }
+            
+            const MultiDouble t = a[i]*theta + b[i];
+            
+            total += k[i] * t * t;
+        }
+        
+        nrg += total.sum();
+    }
+    
+    for (int i=nharm_angles; i<nAngles(); ++i)
+    {
+        Angle theta = Vector::angle( getCoords(atoms[3*i], cgroup_array),
+                                     getCoords(atoms[3*i+1], cgroup_array),
+                                     getCoords(atoms[3*i+2], cgroup_array) );
+                                     
+        nrg += angle_nrgs.constData()[i-nharm_angles].evaluate( theta.to(radians) );
+    }
+    
+    return nrg;
+}
+
+/** Return the total energy of the dihedrals, using the coordinates
+    in 'cgroup_array' */
+double PackedInternals::dihedralEnergy(const CoordGroup *cgroup_array) const
+{
+    const CGAtomIdx *atoms = dihedral_atoms.constData();
+    
+    double nrg = 0;
+    
+    if (ncos_dihedrals > 0)
+    {
+        const double *c = cos_c.constData();
+        const qint32 *start = cos_start.constData();
+        const double *k = cos_k.constData();
+        const double *n = cos_n.constData();
+        const double *d = cos_d.constData();
+        
+        for (int i=0; i<ncos_dihedrals; ++i)
+        {
+            const double phi = Vector::dihedral( getCoords(atoms[4*i], cgroup_array),
+                                                 getCoords(atoms[4*i+1], cgroup_array),
+                                                 getCoords(atoms[4*i+2], cgroup_array),
+                                                 getCoords(atoms[4*i+3], cgroup_array) )
+                                            .to(radians);
+            
+            nrg += c[i];
+            
+            for (int j=start[i]; j<start[i+1]; ++j)
+            {
+                nrg += k[j] * std::cos( n[j]*phi + d[j] );
+            }
+        }
+    }
+    
+    for (int i=ncos_dihedrals; i<nDihedrals(); ++i)
+    {
+        Angle phi = Vector::dihedral( getCoords(atoms[4*i], cgroup_array),
+                                      getCoords(atoms[4*i+1], cgroup_array),
+                                      getCoords(atoms[4*i+2], cgroup_array),
+                                      getCoords(atoms[4*i+3], cgroup_array) );
+                                      
+        nrg += dihedral_nrgs.constData()[i-ncos_dihedrals].evaluate( phi.to(radians) );
+    }
+    
+    return nrg;
+}
+
+/** Return the force (-dE/dr) of the ith bond for the bond length 'r' */
+double PackedInternals::bondForce(int i, double r) const
+{
+    if (i < nharm_bonds)
+    {
+        const double k = unpack(bond_k, i);
+        const double a = unpack(bond_a, i);
+        const double b = unpack(bond_b, i);
+        
+        return -2.0 * k * a * (a*r + b);
+    }
+    else
+        return bond_frcs.constData()[i-nharm_bonds].evaluate(r);
+}
+
+/** Return the force (-dE/dtheta) of the ith angle for the angle 'theta' */
+double PackedInternals::angleForce(int i, double theta) const
+{
+    if (i < nharm_angles)
+    {
+        const double k = unpack(angle_k, i);
+        const double a = unpack(angle_a, i);
+        const double b = unpack(angle_b, i);
+        
+        return -2.0 * k * a * (a*theta + b);
+    }
+    else
+        return angle_frcs.constData()[i-nharm_angles].evaluate(theta);
+}
+
+/** Return the force (-dE/dphi) of the ith dihedral for the torsion 'phi' */
+double PackedInternals::dihedralForce(int i, double phi) const
+{
+    if (i < ncos_dihedrals)
+    {
+        double force = 0;
+        
+        for (int j=cos_start.at(i); j<cos_start.at(i+1); ++j)
+        {
+            force += cos_k.at(j) * cos_n.at(j) * std::sin( cos_n.at(j)*phi + cos_d.at(j) );
+        }
+        
+        return force;
+    }
+    else
+        return dihedral_frcs.constData()[i-ncos_dihedrals].evaluate(phi);
+}
+
+/** Calculate the forces on the atoms of the harmonic bonds, using the
+    coordinates in 'cgroup_array'. The force on each atom (-dE/dr) is
+    written into 'forces', which must have space for two vectors per
+    harmonic bond, in the same order as bondAtoms(). The bonds are
+    evaluated MultiDouble::count() at a time. Bonds of zero length
+    have no direction, and so have no force */
+void PackedInternals::harmonicBondForces(const CoordGroup *cgroup_array,
+                                         Vector *forces) const
+{
+    if (nharm_bonds == 0)
+        return;
+
+    const CGAtomIdx *atoms = bond_atoms.constData();
+    
+    QVarLengthArray<double,256> dx(nharm_bonds), dy(nharm_bonds), dz(nharm_bonds);
+    
+    for (int i=0; i<nharm_bonds; ++i)
+    {
+        const Vector d = getCoords(atoms[2*i], cgroup_array) -
+                         getCoords(atoms[2*i+1], cgroup_array);
+        
+        dx[i] = d.x();
+        dy[i] = d.y();
+        dz[i] = d.z();
+    }
+    
+    const QVector<MultiDouble> mx = MultiDouble::fromArray(dx.constData(), nharm_bonds);
+    const QVector<MultiDouble> my = MultiDouble::fromArray(dy.constData(), nharm_bonds);
+    const QVector<MultiDouble> mz = MultiDouble::fromArray(dz.constData(), nharm_bonds);
+    
+    const MultiDouble *k = bond_k.constData();
+    const MultiDouble *a = bond_a.constData();
+    const MultiDouble *b = bond_b.constData();
+    
+    const MultiDouble zero(0);
+    const MultiDouble minus_two(-2);
+    
+    for (int i=0; i<mx.count(); ++i)
+    {
+        const MultiDouble r = (mx[i]*mx[i] + my[i]*my[i] + mz[i]*mz[i]).sqrt();
+        
+        //(-dE/dr) / r, which multiplies the bond vector to give the force
+        const MultiDouble f = (minus_two * k[i] * a[i] * (a[i]*r + b[i]) / r)
+                                    .logicalAnd( r.compareNotEqual(zero) );
+        
+        const MultiDouble fx = f * mx[i];
+        const MultiDouble fy = f * my[i];
+        const MultiDouble fz = f * mz[i];
+        
+        const int nlanes = qMin( MultiDouble::count(),
+                                 nharm_bonds - i*MultiDouble::count() );
+        
+        for (int j=0; j<nlanes; ++j)
+        {
+            const int idx = i*MultiDouble::count() + j;
+            
+            forces[2*idx] = Vector( fx.at(j), fy.at(j), fz.at(j) );
+            forces[2*idx+1] = -forces[2*idx];
+        }
+    }
+}
+
+/** Calculate the forces on the atoms of the harmonic angles, using the
+    coordinates in 'cgroup_array'. The force on each atom is written
+    into 'forces', which must have space for three vectors per
+    harmonic angle, in the same order as angleAtoms(). The angles are
+    evaluated MultiDouble::count() at a time, using the same d theta / dr
+    as InternalPotential uses for the generic angles. Angles with a bond
+    of zero length, or whose bonds are perpendicular, have no force */
+void PackedInternals::harmonicAngleForces(const CoordGroup *cgroup_array,
+                                          Vector *forces) const
+{
+    if (nharm_angles == 0)
+        return;
+
+    const CGAtomIdx *atoms = angle_atoms.constData();
+    
+    QVarLengthArray<double,256> ax(nharm_angles), ay(nharm_angles), az(nharm_angles);
+    QVarLengthArray<double,256> bx(nharm_angles), by(nharm_angles), bz(nharm_angles);
+    
+    for (int i=0; i<nharm_angles; ++i)
+    {
+        const Vector &atom1 = getCoords(atoms[3*i+1], cgroup_array);
+    
+        const Vector v10 = getCoords(atoms[3*i], cgroup_array) - atom1;
+        const Vector v12 = getCoords(atoms[3*i+2], cgroup_array) - atom1;
+        
+        ax[i] = v10.x();
+        ay[i] = v10.y();
+        az[i] = v10.z();
+        bx[i] = v12.x();
+        by[i] = v12.y();
+        bz[i] = v12.z();
+    }
+    
+    const QVector<MultiDouble> max = MultiDouble::fromArray(ax.constData(), nharm_angles);
+    const QVector<MultiDouble> may = MultiDouble::fromArray(ay.constData(), nharm_angles);
+    const QVector<MultiDouble> maz = MultiDouble::fromArray(az.constData(), nharm_angles);
+    const QVector<MultiDouble> mbx = MultiDouble::fromArray(bx.constData(), nharm_angles);
+    const QVector<MultiDouble> mby = MultiDouble::fromArray(by.constData(), nharm_angles);
+    const QVector<MultiDouble> mbz = MultiDouble::fromArray(bz.constData(), nharm_angles);
+    
+    const MultiDouble *k = angle_k.constData();
+    const MultiDouble *a = angle_a.constData();
+    const MultiDouble *b = angle_b.constData();
+    
+    const MultiDouble zero(0);
+    const MultiDouble one(1);
+    const MultiDouble two(2);
+    
+    for (int i=0; i<max.count(); ++i)
+    {
+        const MultiDouble ra2 = max[i]*max[i] + may[i]*may[i] + maz[i]*maz[i];
+        const MultiDouble rb2 = mbx[i]*mbx[i] + mby[i]*mby[i] + mbz[i]*mbz[i];
+        
+        const MultiDouble inv_ra = one / ra2.sqrt();
+        const MultiDouble inv_rb = one / rb2.sqrt();
+        
+        //work with normalised vectors to prevent numerical error
+        const MultiDouble Ax = max[i] * inv_ra;
+        const MultiDouble Ay = may[i] * inv_ra;
+        const MultiDouble Az = maz[i] * inv_ra;
+        const MultiDouble Bx = mbx[i] * inv_rb;
+        const MultiDouble By = mby[i] * inv_rb;
+        const MultiDouble Bz = mbz[i] * inv_rb;
+        
+        const MultiDouble A_B = Ax*Bx + Ay*By + Az*Bz;
+        
+        //there is no force if either bond has zero length (this also
+        //masks out the padding) or if the bonds are perpendicular
+        const MultiDouble mask = (ra2*rb2).compareGreater(zero)
+                                    .logicalAnd( A_B.compareNotEqual(zero) );
+        
+        //calculate the angles (there is no vectorised acos) and
+        //then dE/dtheta. Masked-out lanes are cleared below
+        MultiDouble theta(0);
+        
+        for (int j=0; j<MultiDouble::count(); ++j)
+        {
+            theta.set(j, std::acos(A_B.at(j)));
+        }
+        
+        const MultiDouble g = two * k[i] * a[i] * (a[i]*theta + b[i]);
+        
+        //now d theta / dr for the first and last atoms
+        const MultiDouble d0x = inv_ra * (Bx + A_B*Ax);
+        const MultiDouble d0y = inv_ra * (By + A_B*Ay);
+        const MultiDouble d0z = inv_ra * (Bz + A_B*Az);
+        const MultiDouble d2x = inv_rb * (Ax + A_B*Bx);
+        const MultiDouble d2y = inv_rb * (Ay + A_B*By);
+        const MultiDouble d2z = inv_rb * (Az + A_B*Bz);
+        
+        const MultiDouble f0x = (g * d0x).logicalAnd(mask);
+        const MultiDouble f0y = (g * d0y).logicalAnd(mask);
+        const MultiDouble f0z = (g * d0z).logicalAnd(mask);
+        const MultiDouble f2x = (g * d2x).logicalAnd(mask);
+        const MultiDouble f2y = (g * d2y).logicalAnd(mask);
+        const MultiDouble f2z = (g * d2z).logicalAnd(mask);
+        
+        const int nlanes = qMin( MultiDouble::count(),
+                                 nharm_angles - i*MultiDouble::count() );
+        
+        for (int j=0; j<nlanes; ++j)
+        {
+            const int idx = i*MultiDouble::count() + j;
+            
+            forces[3*idx] = Vector( f0x.at(j), f0y.at(j), f0z.at(j) );
+            forces[3*idx+2] = Vector( f2x.at(j), f2y.at(j), f2z.at(j) );
+            forces[3*idx+1] = -(forces[3*idx] + forces[3*idx+2]);
+        }
+    }
+}
+
+/** Calculate the forces on the atoms of the cosine-series dihedrals,
+    using the coordinates in 'cgroup_array'. The force on each atom
+    is written into 'forces', which must have space for four vectors per
+    cosine dihedral, in the same order as dihedralAtoms(). The derivatives
+    d phi / dr are evaluated MultiDouble::count() dihedrals at a time, using
+    the algorithm of Blondel and Karplus (J. Comp. Chem. 17, 1132-1141, 1996)
+    as used by InternalPotential for the generic dihedrals. The torsion
+    itself is calculated using Vector::dihedral, so that it matches
+    that used for the energy. Dihedrals with a bond of zero length,
+    or whose atoms lie in a plane, have no force */
+void PackedInternals::cosineDihedralForces(const CoordGroup *cgroup_array,
+                                           Vector *forces) const
+{
+    if (ncos_dihedrals == 0)
+        return;
+
+    const CGAtomIdx *atoms = dihedral_atoms.constData();
+    
+    const int n = ncos_dihedrals;
+    
+    QVarLengthArray<double,256> fx(n), fy(n), fz(n), gx(n), gy(n), gz(n), hx(n), hy(n), hz(n);
+    QVarLengthArray<double,256> dv_by_dphi(n);
+    
+    const qint32 *start = cos_start.constData();
+    const double *k = cos_k.constData();
+    const double *nn = cos_n.constData();
+    const double *d = cos_d.constData();
+    
+    for (int i=0; i<n; ++i)
+    {
+        const Vector &atom0 = getCoords(atoms[4*i], cgroup_array);
+        const Vector &atom1 = getCoords(atoms[4*i+1], cgroup_array);
+        const Vector &atom2 = getCoords(atoms[4*i+2], cgroup_array);
+        const Vector &atom3 = getCoords(atoms[4*i+3], cgroup_array);
+        
+        const Vector F = atom0 - atom1;
+        const Vector G = atom1 - atom2;
+        const Vector H = atom3 - atom2;
+        
+        fx[i] = F.x();
+        fy[i] = F.y();
+        fz[i] = F.z();
+        gx[i] = G.x();
+        gy[i] = G.y();
+        gz[i] = G.z();
+        hx[i] = H.x();
+        hy[i] = H.y();
+        hz[i] = H.z();
+        
+        //dE/dphi of the cosine series (there is no vectorised sin)
+        const double phi = Vector::dihedral(atom0, atom1, atom2, atom3).to(radians);
+        
+        double dv = 0;
+        
+        for (int j=start[i]; j<start[i+1]; ++j)
+        {
+            dv -= k[j] * nn[j] * std::sin( nn[j]*phi + d[j] );
+        }
+        
+        dv_by_dphi[i] = dv;
+    }
+    
+    const QVector<MultiDouble> mfx = MultiDouble::fromArray(fx.constData(), n);
+    const QVector<MultiDouble> mfy = MultiDouble::fromArray(fy.constData(), n);
+    const QVector<MultiDouble> mfz = MultiDouble::fromArray(fz.constData(), n);
+    const QVector<MultiDouble> mgx = MultiDouble::fromArray(gx.constData(), n);
+    const QVector<MultiDouble> mgy = MultiDouble::fromArray(gy.constData(), n);
+    const QVector<MultiDouble> mgz = MultiDouble::fromArray(gz.constData(), n);
+    const QVector<MultiDouble> mhx = MultiDouble::fromArray(hx.constData(), n);
+    const QVector<MultiDouble> mhy = MultiDouble::fromArray(hy.constData(), n);
+    const QVector<MultiDouble> mhz = MultiDouble::fromArray(hz.constData(), n);
+    const QVector<MultiDouble> mdv = MultiDouble::fromArray(dv_by_dphi.constData(), n);
+    
+    const MultiDouble zero(0);
+    const MultiDouble one(1);
+    
+    for (int i=0; i<mfx.count(); ++i)
+    {
+        const MultiDouble rf2 = mfx[i]*mfx[i] + mfy[i]*mfy[i] + mfz[i]*mfz[i];
+        const MultiDouble rg2 = mgx[i]*mgx[i] + mgy[i]*mgy[i] + mgz[i]*mgz[i];
+        const MultiDouble rh2 = mhx[i]*mhx[i] + mhy[i]*mhy[i] + mhz[i]*mhz[i];
+        
+        //work with normalised vectors to prevent build-up of numerical error
+        const MultiDouble inv_rf = one / rf2.sqrt();
+        const MultiDouble inv_rg = one / rg2.sqrt();
+        const MultiDouble inv_rh = one / rh2.sqrt();
+        
+        const MultiDouble Fx = mfx[i] * inv_rf;
+        const MultiDouble Fy = mfy[i] * inv_rf;
+        const MultiDouble Fz = mfz[i] * inv_rf;
+        const MultiDouble Gx = mgx[i] * inv_rg;
+        const MultiDouble Gy = mgy[i] * inv_rg;
+        const MultiDouble Gz = mgz[i] * inv_rg;
+        const MultiDouble Hx = mhx[i] * inv_rh;
+        const MultiDouble Hy = mhy[i] * inv_rh;
+        const MultiDouble Hz = mhz[i] * inv_rh;
+        
+        const MultiDouble F_G = Fx*Gx + Fy*Gy + Fz*Gz;
+        const MultiDouble H_G = Hx*Gx + Hy*Gy + Hz*Gz;
+        
+        //A = F x G and B = H x G
+        MultiDouble Ax = Fy*Gz - Fz*Gy;
+        MultiDouble Ay = Fz*Gx - Fx*Gz;
+        MultiDouble Az = Fx*Gy - Fy*Gx;
+        MultiDouble Bx = Hy*Gz - Hz*Gy;
+        MultiDouble By = Hz*Gx - Hx*Gz;
+        MultiDouble Bz = Hx*Gy - Hy*Gx;
+        
+        const MultiDouble ra = (Ax*Ax + Ay*Ay + Az*Az).sqrt();
+        const MultiDouble rb = (Bx*Bx + By*By + Bz*Bz).sqrt();
+        
+        //there is no force if any bond has zero length (this also
+        //masks out the padding) or if the atoms lie in a plane
+        const MultiDouble mask = (rf2*rg2*rh2).compareGreater(zero)
+                                    .logicalAnd( (ra*rb).compareNotEqual(zero) );
+        
+        const MultiDouble inv_ra = one / ra;
+        const MultiDouble inv_rb = one / rb;
+        
+        Ax *= inv_ra;
+        Ay *= inv_ra;
+        Az *= inv_ra;
+        Bx *= inv_rb;
+        By *= inv_rb;
+        Bz *= inv_rb;
+        
+        //scale d phi / dr by dE/dphi, as is done for the generic dihedrals
+        const MultiDouble &g = mdv[i];
+        
+        const MultiDouble dfx = (g * -inv_rf * Ax).logicalAnd(mask);
+        const MultiDouble dfy = (g * -inv_rf * Ay).logicalAnd(mask);
+        const MultiDouble dfz = (g * -inv_rf * Az).logicalAnd(mask);
+        
+        const MultiDouble dhx = (g * inv_rh * Bx).logicalAnd(mask);
+        const MultiDouble dhy = (g * inv_rh * By).logicalAnd(mask);
+        const MultiDouble dhz = (g * inv_rh * Bz).logicalAnd(mask);
+        
+        const MultiDouble dgx = (g * inv_rg * (F_G*Ax - H_G*Bx)).logicalAnd(mask);
+        const MultiDouble dgy = (g * inv_rg * (F_G*Ay - H_G*By)).logicalAnd(mask);
+        const MultiDouble dgz = (g * inv_rg * (F_G*Az - H_G*Bz)).logicalAnd(mask);
+        
+        const int nlanes = qMin( MultiDouble::count(), n - i*MultiDouble::count() );
+        
+        for (int j=0; j<nlanes; ++j)
+        {
+            const int idx = i*MultiDouble::count() + j;
+            
+            const Vector dphi_by_dF( dfx.at(j), dfy.at(j), dfz.at(j) );
+            const Vector dphi_by_dG( dgx.at(j), dgy.at(j), dgz.at(j) );
+            const Vector dphi_by_dH( dhx.at(j), dhy.at(j), dhz.at(j) );
+            
+            forces[4*idx] = dphi_by_dF;
+            forces[4*idx+1] = dphi_by_dG - dphi_by_dF;
+            forces[4*idx+2] = -dphi_by_dG - dphi_by_dH;
+            forces[4*idx+3] = dphi_by_dH;
+        }
+    }
+}
@@ -0,0 +1,243 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#ifndef SIREMM_PACKEDINTERNALS_H
+#define SIREMM_PACKEDINTERNALS_H
+
+#include "twoatomfunctions.h"
+#include "threeatomfunctions.h"
+#include "fouratomfunctions.h"
+
+#include "SireCAS/compiledexpression.h"
+
+#include "SireMaths/multidouble.h"
+
+SIRE_BEGIN_HEADER
+
+namespace SireMaths
+{
+class Vector;
+}
+
+namespace SireVol
+{
+class CoordGroup;
+}
+
+namespace SireMM
+{
+
+namespace detail
+{
+
+using SireCAS::CompiledExpression;
+using SireMaths::MultiDouble;
+using SireMaths::Vector;
+using SireVol::CoordGroup;
+
+/** This internal class holds the bond, angle and dihedral terms of a
+    GroupInternalParameters sorted into buckets by functional form,
+    with the atom indicies and parameters of each bucket packed into
+    contiguous arrays.
+
+    The buckets are;
+
+    harmonic - bonds and angles of the form k (a x + b)^2. The parameters
+               are packed into MultiDoubles, so that the energy is
+               evaluated MultiDouble::count() terms at a time
+               
+    cosine   - dihedrals of the form c + sum_i k_i cos( n_i phi + d_i ),
+               with the cosine terms of all dihedrals flattened into
+               a single array
+               
+    generic  - anything else, which is evaluated using the compiled
+               expression of the energy, and of -dE/dx for the force
+
+    The terms are classified once, when the parameters are set, using
+    the kernel chosen by SireCAS::CompiledExpression. Within each of the
+    bond, angle and dihedral arrays the terms are stored with the
+    harmonic (or cosine) bucket first, followed by the generic bucket.
+
+    The forces of the harmonic and cosine buckets are also calculated
+    MultiDouble::count() terms at a time. MultiDouble has no
+    trigonometric functions, so the angles, and the cosine series of
+    the dihedrals, are evaluated one lane at a time.
+
+    @author Christopher Woods
+*/
+class PackedInternals
+{
+public:
+    PackedInternals();
+
+    PackedInternals(const PackedInternals &other);
+
+    ~PackedInternals();
+
+    PackedInternals& operator=(const PackedInternals &other);
+
+    void setBonds(const QVector<TwoAtomFunction> &bonds,
+                  const QVector<CompiledExpression> &compiled);
+
+    void setAngles(const QVector<ThreeAtomFunction> &angles,
+                   const QVector<CompiledExpression> &compiled);
+
+    void setDihedrals(const QVector<FourAtomFunction> &dihedrals,
+                      const QVector<CompiledExpression> &compiled);
+
+    int nBonds() const;
+    int nAngles() const;
+    int nDihedrals() const;
+
+    int nHarmonicBonds() const;
+    int nHarmonicAngles() const;
+    int nCosineDihedrals() const;
+
+    const CGAtomIdx* bondAtoms() const;
+    const CGAtomIdx* angleAtoms() const;
+    const CGAtomIdx* dihedralAtoms() const;
+
+    double bondEnergy(const CoordGroup *cgroup_array) const;
+    double angleEnergy(const CoordGroup *cgroup_array) const;
+    double dihedralEnergy(const CoordGroup *cgroup_array) const;
+
+    double bondForce(int i, double r) const;
+    double angleForce(int i, double theta) const;
+    double dihedralForce(int i, double phi) const;
+
+    void harmonicBondForces(const CoordGroup *cgroup_array, Vector *forces) const;
+    void harmonicAngleForces(const CoordGroup *cgroup_array, Vector *forces) const;
+    void cosineDihedralForces(const CoordGroup *cgroup_array, Vector *forces) const;
+
+private:
+    /** The atoms in each bond (two per bond) */
+    QVector<CGAtomIdx> bond_atoms;
+
+    /** The packed parameters of the harmonic bonds */
+    QVector<MultiDouble> bond_k, bond_a, bond_b;
+
+    /** The compiled energy and force (-dE/dr) functions of
+        the generic bonds */
+    QVector<CompiledExpression> bond_nrgs, bond_frcs;
+
+    /** The atoms in each angle (three per angle) */
+    QVector<CGAtomIdx> angle_atoms;
+
+    /** The packed parameters of the harmonic angles */
+    QVector<MultiDouble> angle_k, angle_a, angle_b;
+
+    /** The compiled energy and force (-dE/dtheta) functions of
+        the generic angles */
+    QVector<CompiledExpression> angle_nrgs, angle_frcs;
+
+    /** The atoms in each dihedral (four per dihedral) */
+    QVector<CGAtomIdx> dihedral_atoms;
+
+    /** The constant part of each cosine dihedral */
+    QVector<double> cos_c;
+
+    /** The index of the first cosine term of each cosine dihedral
+        (with an extra value at the end that gives the total) */
+    QVector<qint32> cos_start;
+
+    /** The k, n and d parameters of all of the cosine terms */
+    QVector<double> cos_k, cos_n, cos_d;
+
+    /** The compiled energy and force (-dE/dphi) functions of
+        the generic dihedrals */
+    QVector<CompiledExpression> dihedral_nrgs, dihedral_frcs;
+
+    /** The number of terms in the harmonic and cosine buckets */
+    qint32 nharm_bonds, nharm_angles, ncos_dihedrals;
+};
+
+#ifndef SIRE_SKIP_INLINE_FUNCTIONS
+
+/** Return the total number of bonds */
+inline int PackedInternals::nBonds() const
+{
+    return bond_atoms.count() / 2;
+}
+
+/** Return the total number of angles */
+inline int PackedInternals::nAngles() const
+{
+    return angle_atoms.count() / 3;
+}
+
+/** Return the total number of dihedrals */
+inline int PackedInternals::nDihedrals() const
+{
+    return dihedral_atoms.count() / 4;
+}
+
+/** Return the number of bonds in the harmonic bucket */
+inline int PackedInternals::nHarmonicBonds() const
+{
+    return nharm_bonds;
+}
+
+/** Return the number of angles in the harmonic bucket */
+inline int PackedInternals::nHarmonicAngles() const
+{
+    return nharm_angles;
+}
+
+/** Return the number of dihedrals in the cosine bucket */
+inline int PackedInternals::nCosineDihedrals() const
+{
+    return ncos_dihedrals;
+}
+
+/** Return the packed array of bond atoms (two per bond) */
+inline const CGAtomIdx* PackedInternals::bondAtoms() const
+{
+    return bond_atoms.constData();
+}
+
+/** Return the packed array of angle atoms (three per angle) */
+inline const CGAtomIdx* PackedInternals::angleAtoms() const
+{
+    return angle_atoms.constData();
+}
+
+/** Return the packed array of dihedral atoms (four per dihedral) */
+inline const CGAtomIdx* PackedInternals::dihedralAtoms() const
+{
+    return dihedral_atoms.constData();
+}
+
+#endif // SIRE_SKIP_INLINE_FUNCTIONS
+
+} // end of namespace detail
+
+} // end of namespace SireMM
+
+SIRE_END_HEADER
+
+#endif
@@ -0,0 +1,285 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "SireMM/cljspmefunction.h"
+#include "SireMM/cljewald.h"
+#include "SireMM/cljatoms.h"
+
+#include "SireVol/periodicbox.h"
+
+#include "SireMaths/rangenerator.h"
+
+#include "SireUnits/units.h"
+
+#include "SireError/errors.h"
+
+#include "SireBase/unittest.h"
+
+#include <QDebug>
+
+#include <cmath>
+
+using namespace SireMM;
+using namespace SireMaths;
+using namespace SireVol;
+using namespace SireUnits;
+using namespace SireUnits::Dimension;
+using namespace SireBase;
+
+/** Return the largest absolute difference between the passed structure factors */
+static double maxDifference(const QVector<double> &a, const QVector<double> &b)
+{
+    assert_equal( a.count(), b.count(), CODELOC );
+
+    double maxdiff = 0;
+
+    for (int i=0; i<a.count(); ++i)
+    {
+        maxdiff = qMax(maxdiff, std::abs(a[i] - b[i]));
+    }
+
+    return maxdiff;
+}
+
+/** Return a copy of the atoms of molecule 'mol' (three atoms per molecule)
+    translated by 'delta', with the last atom also nudged by 'nudge' */
+static QVector<CLJAtom> moveMolecule(const QVector<CLJAtom> &atoms, int mol,
+                                     const Vector &delta, const Vector &nudge)
+{
+    QVector<CLJAtom> moved;
+
+    for (int i=3*mol; i<3*mol+3; ++i)
+    {
+        Vector coords = atoms[i].coordinates() + delta;
+
+        if (i == 3*mol+2)
+            coords += nudge;
+
+        moved.append( CLJAtom(coords, atoms[i].charge(), atoms[i].ljParameter(),
+                              atoms[i].ID()) );
+    }
+
+    return moved;
+}
+
+void test_cljewald(bool verbose)
+{
+    RanGenerator rand(1234);
+
+    //build a box of 20 neutral three-atom molecules, each with its own ID
+    const double box = 20.0;
+    const int nmols = 20;
+
+    QVector<CLJAtom> cljatoms;
+
+    for (int i=0; i<nmols; ++i)
+    {
+        const Vector center( rand.rand(0,box), rand.rand(0,box), rand.rand(0,box) );
+        const double qh = rand.rand(0.2, 0.6);
+
+        cljatoms.append( CLJAtom(center, (-2*qh)*mod_electron,
+                                 LJParameter(3.15*angstrom, 0.15*kcal_per_mol), i+1) );
+
+        cljatoms.append( CLJAtom(center + rand.vectorOnSphere(1.0), qh*mod_electron,
+                                 LJParameter::dummy(), i+1) );
+
+        cljatoms.append( CLJAtom(center + rand.vectorOnSphere(1.0), qh*mod_electron,
+                                 LJParameter::dummy(), i+1) );
+    }
+
+    const CLJSPMEFunction func( PeriodicBox(Vector(box)), 9*angstrom );
+
+    //the largest charge, used to scale the expected single precision drift
+    double qmax = 0;
+
+    for (int i=0; i<cljatoms.count(); ++i)
+    {
+        qmax = qMax(qmax, std::abs(cljatoms[i].charge().value()));
+    }
+
+    //the energies of a freshly built sum must agree with those of the function
+    {
+        const CLJAtoms atoms(cljatoms);
+        const CLJEwald ewald(func, atoms);
+
+        const double recip_nrg = func.reciprocalEnergy(atoms);
+        const double corr_nrg = func.selfEnergy(atoms) + func.exclusionEnergy(atoms);
+
+        if (verbose)
+            qDebug() << "CLJEwald recip" << ewald.reciprocalEnergy() << "SPME recip" << recip_nrg
+                     << "correction" << ewald.correctionEnergy() << corr_nrg;
+
+        assert_nearly_equal( ewald.reciprocalEnergy(), recip_nrg,
+                             1e-3 * std::abs(recip_nrg) + 1e-3, CODELOC );
+        assert_nearly_equal( ewald.correctionEnergy(), corr_nrg,
+                             1e-9 * std::abs(corr_nrg) + 1e-9, CODELOC );
+
+        assert_equal( ewald.realStructureFactors().count(), ewald.nKVectors(), CODELOC );
+        assert_equal( ewald.imaginaryStructureFactors().count(), ewald.nKVectors(), CODELOC );
+        assert_equal( ewald.nAccepted(), 0, CODELOC );
+        assert_false( ewald.needsRefresh(), CODELOC );
+    }
+
+    //run a series of moves, randomly accepting or rejecting each one, and
+    //check that the incrementally updated structure factors and energy match
+    //those built from scratch for the final configuration
+    const int nmoves = 3000;
+
+    CLJEwald ewald(func, CLJAtoms(cljatoms));
+    ewald.setRefreshInterval(nmoves + 1);
+
+    int naccepted = 0;
+
+    for (int move=0; move<nmoves; ++move)
+    {
+        const int mol = rand.randInt(nmols-1);
+
+        QVector<CLJAtom> old_atoms = cljatoms.mid(3*mol, 3);
+        QVector<CLJAtom> new_atoms = moveMolecule(cljatoms, mol, rand.vectorOnSphere(0.3),
+                                                  rand.vectorOnSphere(0.02));
+
+        const double old_nrg = ewald.energy();
+        const QVector<double> old_re = ewald.realStructureFactors();
+        const QVector<double> old_im = ewald.imaginaryStructureFactors();
+
+        const double delta = ewald.calculateDelta( CLJAtoms(old_atoms), CLJAtoms(new_atoms) );
+
+        assert_true( ewald.needsAccepting(), CODELOC );
+
+        //nothing is changed until the move is accepted
+        assert_equal( ewald.energy(), old_nrg, CODELOC );
+
+        if (rand.randBool())
+        {
+            ewald.accept();
+            naccepted += 1;
+
+            for (int i=0; i<3; ++i)
+            {
+                cljatoms[3*mol+i] = new_atoms[i];
+            }
+
+            assert_nearly_equal( ewald.energy(), old_nrg + delta,
+                                 1e-9 * std::abs(old_nrg) + 1e-9, CODELOC );
+        }
+        else
+        {
+            ewald.revert();
+
+            assert_equal( ewald.energy(), old_nrg, CODELOC );
+            assert_equal( maxDifference(ewald.realStructureFactors(), old_re), 0.0, CODELOC );
+            assert_equal( maxDifference(ewald.imaginaryStructureFactors(), old_im),
+                          0.0, CODELOC );
+        }
+
+        assert_false( ewald.needsAccepting(), CODELOC );
+    }
+
+    assert_equal( ewald.nAccepted(), naccepted, CODELOC );
+    assert_false( ewald.needsRefresh(), CODELOC );
+
+    const CLJEwald fresh(func, CLJAtoms(cljatoms));
+
+    assert_equal( ewald.nKVectors(), fresh.nKVectors(), CODELOC );
+
+    const double re_diff = maxDifference(ewald.realStructureFactors(),
+                                         fresh.realStructureFactors());
+    const double im_diff = maxDifference(ewald.imaginaryStructureFactors(),
+                                         fresh.imaginaryStructureFactors());
+
+    //each accepted move adds single precision contributions from six atoms
+    //(three old, three new), each with a rounding error of about 1e-6 |q|,
+    //which accumulate as a random walk. Both sums also carry the error of
+    //their initial build. Allow a factor of ten on top of this estimate
+    const double drift_bound = 1e-5 * qmax * ( std::sqrt(6.0*naccepted) +
+                                               std::sqrt(double(cljatoms.count())) );
+
+    if (verbose)
+        qDebug() << naccepted << "accepted moves. Max S(k) drift" << re_diff << im_diff
+                 << "bound" << drift_bound << "energy" << ewald.energy()
+                 << "from scratch" << fresh.energy();
+
+    assert_true( re_diff < drift_bound, CODELOC );
+    assert_true( im_diff < drift_bound, CODELOC );
+
+    assert_nearly_equal( ewald.reciprocalEnergy(), fresh.reciprocalEnergy(),
+                         1e-4 * std::abs(fresh.reciprocalEnergy()) + 1e-3, CODELOC );
+    assert_nearly_equal( ewald.correctionEnergy(), fresh.correctionEnergy(),
+                         1e-9 * std::abs(fresh.correctionEnergy()) + 1e-6, CODELOC );
+
+    //the reported energy must always be that of the cached structure factors,
+    //so it must also agree with the SPME reciprocal energy of the final atoms
+    assert_nearly_equal( ewald.reciprocalEnergy(), func.reciprocalEnergy(CLJAtoms(cljatoms)),
+                         1e-3 * std::abs(fresh.reciprocalEnergy()) + 1e-3, CODELOC );
+
+    //check that a refresh is requested after the refresh interval, and that
+    //calling setAtoms resets the sum to one built from scratch
+    assert_throws( [&](){ ewald.setRefreshInterval(0); }, SireError::invalid_arg(), CODELOC );
+
+    ewald.setRefreshInterval(10);
+    assert_equal( ewald.refreshInterval(), 10, CODELOC );
+    assert_true( ewald.needsRefresh(), CODELOC );
+
+    ewald.setAtoms( CLJAtoms(cljatoms) );
+
+    assert_equal( ewald.nAccepted(), 0, CODELOC );
+    assert_false( ewald.needsRefresh(), CODELOC );
+    assert_equal( maxDifference(ewald.realStructureFactors(), fresh.realStructureFactors()),
+                  0.0, CODELOC );
+    assert_equal( maxDifference(ewald.imaginaryStructureFactors(),
+                                fresh.imaginaryStructureFactors()), 0.0, CODELOC );
+    assert_equal( ewald.energy(), fresh.energy(), CODELOC );
+
+    for (int i=0; i<10; ++i)
+    {
+        const int mol = rand.randInt(nmols-1);
+
+        QVector<CLJAtom> new_atoms = moveMolecule(cljatoms, mol, rand.vectorOnSphere(0.3),
+                                                  Vector(0));
+
+        assert_false( ewald.needsRefresh(), CODELOC );
+
+        ewald.calculateDelta( CLJAtoms(cljatoms.mid(3*mol,3)), CLJAtoms(new_atoms) );
+        ewald.accept();
+
+        for (int j=0; j<3; ++j)
+        {
+            cljatoms[3*mol+j] = new_atoms[j];
+        }
+    }
+
+    assert_equal( ewald.nAccepted(), 10, CODELOC );
+    assert_true( ewald.needsRefresh(), CODELOC );
+
+    ewald.setAtoms( CLJAtoms(cljatoms) );
+
+    assert_false( ewald.needsRefresh(), CODELOC );
+    assert_equal( ewald.energy(), CLJEwald(func, CLJAtoms(cljatoms)).energy(), CODELOC );
+}
+
+SIRE_UNITTEST( test_cljewald )
@@ -0,0 +1,283 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "SireMM/cljforces.h"
+#include "SireMM/cljcalculator.h"
+#include "SireMM/cljshiftfunction.h"
+#include "SireMM/cljrffunction.h"
+#include "SireMM/cljatoms.h"
+
+#include "SireVol/cartesian.h"
+#include "SireVol/periodicbox.h"
+
+#include "SireMaths/rangenerator.h"
+
+#include "SireUnits/units.h"
+
+#include "SireBase/unittest.h"
+
+#include <QDebug>
+
+#include <cmath>
+
+using namespace SireMM;
+using namespace SireMaths;
+using namespace SireVol;
+using namespace SireUnits;
+using namespace SireUnits::Dimension;
+using namespace SireBase;
+
+/** The step used for the finite difference derivatives */
+static const double delta = 0.005;
+
+/** Return atoms placed on a jittered 4x4x3 lattice with a spacing of 3 A,
+    so that no two atoms are too close. Pairs of atoms share the same ID,
+    starting from 'first_id' */
+static QVector<CLJAtom> latticeAtoms(RanGenerator &rand, qint32 first_id)
+{
+    QVector<CLJAtom> atoms;
+
+    for (int i=0; i<4; ++i)
+    {
+        for (int j=0; j<4; ++j)
+        {
+            for (int k=0; k<3; ++k)
+            {
+                const Vector coords( 3.0*i + rand.rand(-0.3,0.3),
+                                     3.0*j + rand.rand(-0.3,0.3),
+                                     3.0*k + rand.rand(-0.3,0.3) );
+
+                atoms.append( CLJAtom(coords, rand.rand(-0.5,0.5)*mod_electron,
+                                      LJParameter(2.5*angstrom, 0.2*kcal_per_mol),
+                                      first_id + atoms.count()/2) );
+            }
+        }
+    }
+
+    return atoms;
+}
+
+/** Return a copy of 'atoms' with atom 'i' moved by 'step' */
+static QVector<CLJAtom> moveAtom(const QVector<CLJAtom> &atoms, int i, const Vector &step)
+{
+    QVector<CLJAtom> moved = atoms;
+
+    moved[i] = CLJAtom( atoms[i].coordinates() + step, atoms[i].charge(),
+                        atoms[i].ljParameter(), atoms[i].ID() );
+
+    return moved;
+}
+
+/** Return the total energy of 'atoms', or of 'atoms0' with 'atoms1' */
+static double totalEnergy(const CLJFunction &func, const QVector<CLJAtom> &atoms0,
+                          const QVector<CLJAtom> &atoms1 = QVector<CLJAtom>())
+{
+    boost::tuple<double,double> nrgs;
+
+    if (atoms1.isEmpty())
+        nrgs = func.calculate( CLJAtoms(atoms0) );
+    else
+        nrgs = func.calculate( CLJAtoms(atoms0), CLJAtoms(atoms1) );
+
+    return nrgs.get<0>() + nrgs.get<1>();
+}
+
+/** Return whether or not the atom 'atom' has a partner in 'others' (with a
+    different ID) that sits so close to the cutoff that the truncated LJ energy
+    makes the finite difference meaningless */
+static bool nearCutoff(const CLJFunction &func, const CLJAtom &atom,
+                       const QVector<CLJAtom> &others)
+{
+    const double cutoff = func.ljCutoff().value();
+
+    foreach (const CLJAtom &other, others)
+    {
+        if (other.ID() != atom.ID())
+        {
+            const double r = func.space().calcDist(atom.coordinates(), other.coordinates());
+
+            if (std::abs(r - cutoff) < 4*delta)
+                return true;
+        }
+    }
+
+    return false;
+}
+
+/** Return the force on atom 'i' in 'atoms0' from the central finite difference
+    of the energy */
+static Vector numericalForce(const CLJFunction &func, const QVector<CLJAtom> &atoms0,
+                             const QVector<CLJAtom> &atoms1, int i)
+{
+    Vector force;
+
+    for (int dim=0; dim<3; ++dim)
+    {
+        Vector step(0);
+        step.set(dim, delta);
+
+        const double nrg_plus = totalEnergy(func, moveAtom(atoms0, i, step), atoms1);
+        const double nrg_minus = totalEnergy(func, moveAtom(atoms0, i, -step), atoms1);
+
+        force.set(dim, -(nrg_plus - nrg_minus) / (2*delta));
+    }
+
+    return force;
+}
+
+static void assert_same_force(const Vector &force, const Vector &ref, QString codeloc)
+{
+    for (int dim=0; dim<3; ++dim)
+    {
+        assert_nearly_equal( force[dim], ref[dim], 0.01*std::abs(ref[dim]) + 0.02, codeloc );
+    }
+}
+
+static void test_forces(const CLJFunction &func, bool verbose)
+{
+    RanGenerator rand(4231);
+
+    const QVector<CLJAtom> atoms0 = latticeAtoms(rand, 1);
+
+    QVector<CLJAtom> atoms1 = latticeAtoms(rand, 1000);
+
+    //shift the second set of atoms so that it overlaps half of the first
+    for (int i=0; i<atoms1.count(); ++i)
+    {
+        atoms1[i] = CLJAtom( atoms1[i].coordinates() + Vector(1.5,1.5,4.5),
+                             atoms1[i].charge(), atoms1[i].ljParameter(), atoms1[i].ID() );
+    }
+
+    //forces between all pairs of atoms in the same set
+    const CLJAtoms cljatoms0(atoms0);
+    const CLJForces forces = func.force(cljatoms0);
+
+    assert_true( forces.isCompatible(cljatoms0), CODELOC );
+
+    int ntested = 0;
+
+    for (int i=0; i<atoms0.count(); i += 5)
+    {
+        if (nearCutoff(func, atoms0[i], atoms0))
+            continue;
+
+        const Vector ref = numericalForce(func, atoms0, QVector<CLJAtom>(), i);
+
+        if (verbose)
+            qDebug() << func.toString() << i << forces[i].toString() << ref.toString();
+
+        assert_same_force(forces[i], ref, CODELOC);
+        ntested += 1;
+    }
+
+    assert_true( ntested > 0, CODELOC );
+
+    //the parallel calculation over boxes must give the same forces
+    const CLJForces box_forces = CLJCalculator().calculateForces(func, cljatoms0);
+
+    assert_equal( box_forces.count(), forces.count(), CODELOC );
+
+    for (int i=0; i<atoms0.count(); ++i)
+    {
+        for (int dim=0; dim<3; ++dim)
+        {
+            assert_nearly_equal( box_forces[i][dim], forces[i][dim],
+                                 1e-3*std::abs(forces[i][dim]) + 1e-3, CODELOC );
+        }
+    }
+
+    //forces between the two sets of atoms
+    const CLJAtoms cljatoms1(atoms1);
+
+    CLJForces forces0, forces1;
+    func.force(cljatoms0, cljatoms1, forces0, forces1);
+
+    ntested = 0;
+
+    for (int i=0; i<atoms0.count(); i += 5)
+    {
+        if (nearCutoff(func, atoms0[i], atoms1))
+            continue;
+
+        assert_same_force(forces0[i], numericalForce(func, atoms0, atoms1, i), CODELOC);
+        ntested += 1;
+    }
+
+    for (int i=0; i<atoms1.count(); i += 5)
+    {
+        if (nearCutoff(func, atoms1[i], atoms0))
+            continue;
+
+        assert_same_force(forces1[i], numericalForce(func, atoms1, atoms0, i), CODELOC);
+        ntested += 1;
+    }
+
+    assert_true( ntested > 0, CODELOC );
+
+    //the one-sided calculation must give the same forces on atoms0, and
+    //Newton's third law means that the total force must be zero
+    CLJForces one_sided;
+    func.force(cljatoms0, cljatoms1, one_sided);
+
+    Vector total;
+
+    for (int i=0; i<atoms0.count(); ++i)
+    {
+        for (int dim=0; dim<3; ++dim)
+        {
+            assert_nearly_equal( one_sided[i][dim], forces0[i][dim],
+                                 1e-4*std::abs(forces0[i][dim]) + 1e-4, CODELOC );
+        }
+
+        total += forces0[i];
+    }
+
+    for (int i=0; i<atoms1.count(); ++i)
+    {
+        total += forces1[i];
+    }
+
+    assert_nearly_equal( total.length(), 0.0, 1e-2, CODELOC );
+}
+
+void test_cljforces(bool verbose)
+{
+    QList<SpacePtr> spaces;
+    spaces.append( Cartesian() );
+    spaces.append( PeriodicBox(Vector(12.0)) );
+
+    foreach (const SpacePtr &space, spaces)
+    {
+        test_forces( CLJShiftFunction(space.read(), 5*angstrom), verbose );
+        test_forces( CLJShiftFunction(space.read(), 5*angstrom,
+                                      CLJFunction::ARITHMETIC), verbose );
+        test_forces( CLJRFFunction(space.read(), 5*angstrom), verbose );
+    }
+}
+
+SIRE_UNITTEST( test_cljforces )
@@ -0,0 +1,218 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "SireMM/cljkernels.h"
+#include "SireMM/cljshiftfunction.h"
+#include "SireMM/cljrffunction.h"
+#include "SireMM/cljatoms.h"
+
+#include "SireVol/cartesian.h"
+#include "SireVol/periodicbox.h"
+
+#include "SireMaths/rangenerator.h"
+
+#include "SireUnits/units.h"
+
+#include "SireBase/unittest.h"
+
+#include <QDebug>
+
+#include <cmath>
+
+using namespace SireMM;
+using namespace SireMaths;
+using namespace SireVol;
+using namespace SireUnits;
+using namespace SireUnits::Dimension;
+using namespace SireBase;
+
+/** Return 'natoms' atoms randomly placed in a box of size 'box', cycling
+    through charged LJ atoms, charge-only atoms, LJ-only atoms and
+    atoms with neither charge nor LJ, with pairs of atoms sharing an ID */
+static QVector<CLJAtom> mixedAtoms(RanGenerator &rand, int natoms, double box, int id_offset)
+{
+    QVector<CLJAtom> atoms;
+
+    for (int i=0; i<natoms; ++i)
+    {
+        const Vector coords( rand.rand(0,box), rand.rand(0,box), rand.rand(0,box) );
+        const qint32 id = id_offset + i/2 + 1;
+
+        switch (i % 4)
+        {
+        case 0:
+            atoms.append( CLJAtom(coords, rand.rand(-0.8,0.8)*mod_electron,
+                                  LJParameter(rand.rand(2.5,3.5)*angstrom,
+                                              rand.rand(0.05,0.3)*kcal_per_mol), id) );
+            break;
+        case 1:
+            atoms.append( CLJAtom(coords, rand.rand(-0.8,0.8)*mod_electron,
+                                  LJParameter::dummy(), id) );
+            break;
+        case 2:
+            atoms.append( CLJAtom(coords, 0*mod_electron,
+                                  LJParameter(rand.rand(2.5,3.5)*angstrom,
+                                              rand.rand(0.05,0.3)*kcal_per_mol), id) );
+            break;
+        default:
+            atoms.append( CLJAtom(coords, 0*mod_electron, LJParameter::dummy(), id) );
+            break;
+        }
+    }
+
+    return atoms;
+}
+
+/** Calculate the energies of 'atoms0', 'atoms1' and of the pair using 'func',
+    returning them as coulomb and LJ pairs in 'nrgs' */
+static QVector<double> calculateEnergies(const CLJFunction &func,
+                                         const CLJAtoms &atoms0, const CLJAtoms &atoms1,
+                                         const CLJAtoms &all_atoms)
+{
+    QVector<double> nrgs;
+
+    boost::tuple<double,double> nrg = func.calculate(atoms0);
+    nrgs.append(nrg.get<0>());
+    nrgs.append(nrg.get<1>());
+
+    nrg = func.calculate(atoms1);
+    nrgs.append(nrg.get<0>());
+    nrgs.append(nrg.get<1>());
+
+    nrg = func.calculate(atoms0, atoms1);
+    nrgs.append(nrg.get<0>());
+    nrgs.append(nrg.get<1>());
+
+    nrg = func.calculate(all_atoms);
+    nrgs.append(nrg.get<0>());
+    nrgs.append(nrg.get<1>());
+
+    return nrgs;
+}
+
+static void assert_energies_equal(const QVector<double> &nrgs, const QVector<double> &ref,
+                                  const QString &codeloc)
+{
+    assert_equal( nrgs.count(), ref.count(), codeloc );
+
+    for (int i=0; i<ref.count(); ++i)
+    {
+        //the kernels calculate pair energies in single precision
+        assert_nearly_equal( nrgs[i], ref[i], 1e-4 * std::abs(ref[i]) + 1e-4, codeloc );
+    }
+}
+
+void test_cljkernels(bool verbose)
+{
+    RanGenerator rand(4242);
+
+    //use atom counts that are not a multiple of the vector size, so that
+    //the CLJAtoms are padded with dummy atoms
+    const double box = 18.0;
+
+    const QVector<CLJAtom> cljatoms0 = mixedAtoms(rand, 37, box, 0);
+    const QVector<CLJAtom> cljatoms1 = mixedAtoms(rand, 29, box, 1000);
+
+    const CLJAtoms atoms0(cljatoms0);
+    const CLJAtoms atoms1(cljatoms1);
+    const CLJAtoms all_atoms(cljatoms0 + cljatoms1);
+
+    //the compiled MultiFloat kernels must be used by default
+    assert_equal( CLJKernels::instructionSet(), QString("compiled"), CODELOC );
+    assert_false( CLJKernels::isDispatched(), CODELOC );
+
+    const QStringList isas = CLJKernels::availableInstructionSets();
+
+    if (verbose)
+        qDebug() << "Compiled instruction set" << CLJKernels::compiledInstructionSet()
+                 << "available" << isas;
+
+    QList<SpacePtr> spaces;
+    spaces.append( Cartesian() );
+    spaces.append( PeriodicBox(Vector(box)) );
+
+    try
+    {
+        foreach (const SpacePtr &space, spaces)
+        {
+            for (int rules=0; rules<2; ++rules)
+            {
+                const CLJFunction::COMBINING_RULES combining_rules =
+                            (rules == 0) ? CLJFunction::GEOMETRIC : CLJFunction::ARITHMETIC;
+
+                CLJShiftFunction shift(space.read(), 8*angstrom, 6*angstrom, combining_rules);
+
+                CLJRFFunction rf(space.read(), 8*angstrom, 6*angstrom, combining_rules);
+                rf.setDielectric(78.3);
+
+                QList<CLJFunctionPtr> funcs;
+                funcs.append(shift);
+                funcs.append(rf);
+
+                foreach (const CLJFunctionPtr &func, funcs)
+                {
+                    CLJKernels::resetInstructionSet();
+
+                    const QVector<double> ref = calculateEnergies(func.read(), atoms0,
+                                                                  atoms1, all_atoms);
+
+                    //the energy of all atoms together must equal the sum of the
+                    //energies of the two groups and their interaction
+                    assert_nearly_equal( ref[6], ref[0] + ref[2] + ref[4],
+                                         1e-4 * std::abs(ref[6]) + 1e-4, CODELOC );
+                    assert_nearly_equal( ref[7], ref[1] + ref[3] + ref[5],
+                                         1e-4 * std::abs(ref[7]) + 1e-4, CODELOC );
+
+                    foreach (const QString &isa, isas)
+                    {
+                        CLJKernels::setInstructionSet(isa);
+
+                        const QVector<double> nrgs = calculateEnergies(func.read(), atoms0,
+                                                                       atoms1, all_atoms);
+
+                        if (verbose)
+                            qDebug() << func.read().what() << space.read().what()
+                                     << (rules == 0 ? "geometric" : "arithmetic")
+                                     << isa << nrgs;
+
+                        assert_energies_equal(nrgs, ref, CODELOC);
+                    }
+                }
+            }
+        }
+    }
+    catch(...)
+    {
+        CLJKernels::resetInstructionSet();
+        throw;
+    }
+
+    CLJKernels::resetInstructionSet();
+}
+
+SIRE_UNITTEST( test_cljkernels )
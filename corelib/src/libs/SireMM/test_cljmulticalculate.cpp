@@ -0,0 +1,283 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "SireMM/cljshiftfunction.h"
+#include "SireMM/cljrffunction.h"
+#include "SireMM/cljboxes.h"
+#include "SireMM/cljatoms.h"
+
+#include "SireVol/cartesian.h"
+#include "SireVol/periodicbox.h"
+
+#include "SireMaths/rangenerator.h"
+
+#include "SireUnits/units.h"
+
+#include "SireBase/unittest.h"
+
+#include <QDebug>
+
+#include <cmath>
+
+using namespace SireMM;
+using namespace SireMaths;
+using namespace SireVol;
+using namespace SireUnits;
+using namespace SireBase;
+using boost::tuple;
+
+/** The length of the side of the box holding the atoms */
+static const double box_length = 12.0;
+
+/** Return 'natoms' random points in the box that are at least 2 A apart
+    (including across the periodic boundaries), so that the LJ
+    energies stay finite */
+static QVector<Vector> randomPoints(RanGenerator &rand, int natoms)
+{
+    const PeriodicBox box( Vector(box_length) );
+
+    QVector<Vector> points;
+
+    while (points.count() < natoms)
+    {
+        const Vector point( rand.rand(0,box_length), rand.rand(0,box_length),
+                            rand.rand(0,box_length) );
+
+        bool too_close = false;
+
+        foreach (const Vector &other, points)
+        {
+            if (box.calcDist(point, other) < 2.0)
+            {
+                too_close = true;
+                break;
+            }
+        }
+
+        if (not too_close)
+            points.append(point);
+    }
+
+    return points;
+}
+
+/** Return atoms at the points from 'start' to 'end'. Pairs of atoms share
+    the same ID, starting from 'first_id'. Some atoms are uncharged, and
+    some have no LJ parameters */
+static CLJAtoms makeAtoms(RanGenerator &rand, const QVector<Vector> &points,
+                          int start, int end, qint32 first_id)
+{
+    QVector<CLJAtom> atoms;
+
+    for (int i=start; i<end; ++i)
+    {
+        const double q = (i % 7 == 3) ? 0.0 : rand.rand(-0.5,0.5);
+
+        const LJParameter lj = (i % 5 == 2) ? LJParameter::dummy()
+                                            : LJParameter( rand.rand(2.0,3.0)*angstrom,
+                                                           rand.rand(0.1,0.3)*kcal_per_mol );
+
+        atoms.append( CLJAtom(points[i], q*mod_electron, lj, first_id + atoms.count()/2) );
+    }
+
+    return CLJAtoms(atoms);
+}
+
+static void assert_same_energy(double nrg, double ref, QString codeloc)
+{
+    assert_nearly_equal( nrg, ref, 1e-4*std::abs(ref) + 1e-3, codeloc );
+}
+
+static void assert_same_multi(const tuple< QVector<double>,QVector<double> > &nrgs,
+                              const QVector< tuple<double,double> > &ref,
+                              QString codeloc)
+{
+    assert_equal( nrgs.get<0>().count(), ref.count(), codeloc );
+    assert_equal( nrgs.get<1>().count(), ref.count(), codeloc );
+
+    for (int i=0; i<ref.count(); ++i)
+    {
+        assert_same_energy( nrgs.get<0>()[i], ref[i].get<0>(), codeloc );
+        assert_same_energy( nrgs.get<1>()[i], ref[i].get<1>(), codeloc );
+    }
+}
+
+/** Check that every variant of CLJFunction::multiCalculate gives the same
+    energies as calling calculate on each of the functions in turn */
+static void test_funcs(const QString &name, const QVector<CLJFunctionPtr> &funcs,
+                       const CLJAtoms &atoms0, const CLJAtoms &atoms1, bool verbose)
+{
+    if (verbose)
+        qDebug() << "Testing" << name << "with" << funcs.count() << "functions";
+
+    const CLJBoxes boxes0(atoms0);
+    const CLJBoxes boxes1(atoms1);
+
+    QVector< tuple<double,double> > ref, ref01, ref_far;
+
+    foreach (const CLJFunctionPtr &func, funcs)
+    {
+        ref.append( func.read().calculate(atoms0) );
+        ref01.append( func.read().calculate(atoms0, atoms1) );
+        ref_far.append( func.read().calculate(atoms0, atoms1, 100.0) );
+
+        if (verbose)
+            qDebug() << func.read().toString() << ref.last().get<0>() << ref.last().get<1>()
+                     << ref01.last().get<0>() << ref01.last().get<1>();
+    }
+
+    assert_same_multi( CLJFunction::multiCalculate(funcs, atoms0), ref, CODELOC );
+    assert_same_multi( CLJFunction::multiCalculate(funcs, boxes0), ref, CODELOC );
+
+    assert_same_multi( CLJFunction::multiCalculate(funcs, atoms0, atoms1), ref01, CODELOC );
+    assert_same_multi( CLJFunction::multiCalculate(funcs, atoms1, atoms0), ref01, CODELOC );
+    assert_same_multi( CLJFunction::multiCalculate(funcs, boxes0, boxes1), ref01, CODELOC );
+    assert_same_multi( CLJFunction::multiCalculate(funcs, atoms0, boxes1), ref01, CODELOC );
+
+    //a minimum distance beyond the cutoff skips the calculation
+    assert_same_multi( CLJFunction::multiCalculate(funcs, atoms0, atoms1, 100.0),
+                       ref_far, CODELOC );
+}
+
+/** Return soft-core functions of type T at several values of alpha (including
+    the end states) in 'space', using the passed shift delta and coulomb power */
+template<class T>
+static QVector<CLJFunctionPtr> softFunctions(const Space &space,
+                                             CLJFunction::COMBINING_RULES rules,
+                                             float shift_delta, float coulomb_power)
+{
+    QVector<CLJFunctionPtr> funcs;
+
+    for (int i=0; i<5; ++i)
+    {
+        T func(space, 5*angstrom, rules);
+        func.setAlpha(0.25*i);
+        func.setShiftDelta(shift_delta);
+        func.setCoulombPower(coulomb_power);
+
+        funcs.append(func);
+    }
+
+    return funcs;
+}
+
+static void test_rules(CLJFunction::COMBINING_RULES rules, bool verbose)
+{
+    const PeriodicBox periodic( Vector(box_length) );
+    const Cartesian vacuum;
+
+    RanGenerator rand(8642);
+
+    const QVector<Vector> points = randomPoints(rand, 100);
+    const CLJAtoms atoms0 = makeAtoms(rand, points, 0, 60, 1);
+    const CLJAtoms atoms1 = makeAtoms(rand, points, 60, 100, 1000);
+
+    //soft-core reaction field and shifted functions, periodic and in vacuum,
+    //with default and non-default shift deltas and coulomb powers
+    test_funcs( "soft RF, periodic",
+                softFunctions<CLJSoftRFFunction>(periodic, rules, 2.0, 1),
+                atoms0, atoms1, verbose );
+
+    test_funcs( "soft RF, vacuum",
+                softFunctions<CLJSoftRFFunction>(vacuum, rules, 2.0, 1),
+                atoms0, atoms1, verbose );
+
+    test_funcs( "soft shift, vacuum",
+                softFunctions<CLJSoftShiftFunction>(vacuum, rules, 2.0, 1),
+                atoms0, atoms1, verbose );
+
+    test_funcs( "soft RF, shift delta 0.7, coulomb power 3",
+                softFunctions<CLJSoftRFFunction>(periodic, rules, 0.7, 3),
+                atoms0, atoms1, verbose );
+
+    test_funcs( "soft shift, shift delta 3.5, coulomb power 2",
+                softFunctions<CLJSoftShiftFunction>(vacuum, rules, 3.5, 2),
+                atoms0, atoms1, verbose );
+
+    {
+        QVector<CLJFunctionPtr> funcs = softFunctions<CLJSoftRFFunction>(periodic, rules, 2.0, 1);
+
+        for (int i=0; i<funcs.count(); ++i)
+        {
+            funcs[i].edit().asA<CLJSoftRFFunction>().setDielectric(20 + 20*i);
+        }
+
+        test_funcs( "soft RF, different dielectrics", funcs, atoms0, atoms1, verbose );
+    }
+
+    //mixed lists that cannot be fused, and so must fall back to
+    //calling each function in turn
+    {
+        QVector<CLJFunctionPtr> funcs = softFunctions<CLJSoftShiftFunction>(periodic, rules,
+                                                                            2.0, 1);
+        funcs.append( CLJShiftFunction(periodic, 5*angstrom, rules) );
+
+        test_funcs( "soft and hard functions", funcs, atoms0, atoms1, verbose );
+    }
+
+    {
+        QVector<CLJFunctionPtr> funcs = softFunctions<CLJSoftShiftFunction>(periodic, rules,
+                                                                            2.0, 1);
+        funcs += softFunctions<CLJSoftShiftFunction>(vacuum, rules, 2.0, 1);
+
+        test_funcs( "soft functions in different spaces", funcs, atoms0, atoms1, verbose );
+    }
+
+    {
+        QVector<CLJFunctionPtr> funcs = softFunctions<CLJSoftRFFunction>(periodic, rules,
+                                                                         2.0, 1);
+        funcs[2].edit().asA<CLJSoftRFFunction>().setCutoff(5*angstrom, 4*angstrom);
+
+        test_funcs( "soft functions with different cutoffs", funcs, atoms0, atoms1, verbose );
+    }
+
+    {
+        QVector<CLJFunctionPtr> funcs = softFunctions<CLJSoftRFFunction>(periodic, rules,
+                                                                         2.0, 1);
+
+        CLJSoftShiftFunction other_rules(periodic, 5*angstrom,
+                                         rules == CLJFunction::ARITHMETIC ?
+                                                CLJFunction::GEOMETRIC :
+                                                CLJFunction::ARITHMETIC);
+        other_rules.setAlpha(0.5);
+        funcs.insert(1, other_rules);
+
+        test_funcs( "soft functions with different combining rules",
+                    funcs, atoms0, atoms1, verbose );
+    }
+}
+
+/** Check that the fused multi-state soft-core path of multiCalculate
+    agrees with calculating each function separately */
+void test_cljmulticalculate(bool verbose)
+{
+    test_rules( CLJFunction::GEOMETRIC, verbose );
+    test_rules( CLJFunction::ARITHMETIC, verbose );
+}
+
+SIRE_UNITTEST( test_cljmulticalculate )
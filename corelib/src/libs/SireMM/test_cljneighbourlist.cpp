@@ -0,0 +1,172 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "SireMM/cljneighbourlist.h"
+#include "SireMM/cljcalculator.h"
+#include "SireMM/cljshiftfunction.h"
+#include "SireMM/cljatoms.h"
+
+#include "SireVol/cartesian.h"
+#include "SireVol/periodicbox.h"
+#include "SireVol/triclinicbox.h"
+
+#include "SireMaths/rangenerator.h"
+
+#include "SireUnits/units.h"
+
+#include "SireBase/unittest.h"
+
+#include <QDebug>
+
+#include <cmath>
+
+using namespace SireMM;
+using namespace SireMaths;
+using namespace SireVol;
+using namespace SireUnits;
+using namespace SireUnits::Dimension;
+using namespace SireBase;
+
+/** Return 'ngroups' groups of eight atoms randomly placed in a box of size
+    'box', plus a few extra atoms so that the last cluster is padded */
+static QVector<CLJAtom> clusteredAtoms(RanGenerator &rand, int ngroups, double box)
+{
+    QVector<CLJAtom> atoms;
+
+    for (int i=0; i<ngroups; ++i)
+    {
+        const Vector center( rand.rand(0,box), rand.rand(0,box), rand.rand(0,box) );
+
+        for (int j=0; j<8; ++j)
+        {
+            atoms.append( CLJAtom(center + rand.vectorOnSphere(rand.rand(0,1.5)),
+                                  rand.rand(-0.5,0.5)*mod_electron,
+                                  LJParameter(3.0*angstrom, 0.2*kcal_per_mol),
+                                  atoms.count()/2 + 1) );
+        }
+    }
+
+    for (int i=0; i<3; ++i)
+    {
+        atoms.append( CLJAtom(Vector(rand.rand(0,box), rand.rand(0,box), rand.rand(0,box)),
+                              rand.rand(-0.5,0.5)*mod_electron,
+                              LJParameter(3.0*angstrom, 0.2*kcal_per_mol),
+                              atoms.count()/2 + 1) );
+    }
+
+    return atoms;
+}
+
+/** Return a copy of 'atoms' where every atom has been moved by 'delta' in
+    a random direction */
+static QVector<CLJAtom> moveAtoms(RanGenerator &rand, const QVector<CLJAtom> &atoms,
+                                  double delta)
+{
+    QVector<CLJAtom> moved = atoms;
+
+    for (int i=0; i<moved.count(); ++i)
+    {
+        moved[i] = CLJAtom( atoms[i].coordinates() + rand.vectorOnSphere(delta),
+                            atoms[i].charge(), atoms[i].ljParameter(), atoms[i].ID() );
+    }
+
+    return moved;
+}
+
+void test_cljneighbourlist(bool verbose)
+{
+    RanGenerator rand(1729);
+
+    const double box = 30.0;
+    const QVector<CLJAtom> cljatoms = clusteredAtoms(rand, 120, box);
+
+    QList<SpacePtr> spaces;
+    spaces.append( Cartesian() );
+    spaces.append( PeriodicBox(Vector(box)) );
+    spaces.append( TriclinicBox(Vector(box,0,0), Vector(0,box,0), Vector(0,0,box)) );
+
+    const CLJCalculator calc;
+
+    foreach (const SpacePtr &space, spaces)
+    {
+        const CLJShiftFunction func(space.read(), 8*angstrom);
+
+        CLJNeighbourList list(1.5*angstrom);
+
+        //the energy from the list must match the energy of all pairs
+        CLJAtoms atoms(cljatoms);
+
+        boost::tuple<double,double> ref = func.calculate(atoms);
+        boost::tuple<double,double> nrg = calc.calculate(func, atoms, list);
+
+        if (verbose)
+            qDebug() << space.read().toString() << "all pairs" << ref.get<0>() << ref.get<1>()
+                     << "neighbour list" << nrg.get<0>() << nrg.get<1>()
+                     << list.toString();
+
+        assert_equal( list.nRebuilds(), 1, CODELOC );
+        assert_true( list.nClusterPairs() < list.nClusters()*(list.nClusters()-1)/2,
+                     CODELOC );
+
+        assert_nearly_equal( nrg.get<0>(), ref.get<0>(), 1e-4*std::abs(ref.get<0>()) + 1e-4,
+                             CODELOC );
+        assert_nearly_equal( nrg.get<1>(), ref.get<1>(), 1e-4*std::abs(ref.get<1>()) + 1e-4,
+                             CODELOC );
+
+        //moving every atom by less than half the skin must not rebuild the list,
+        //and must still give the right energy
+        atoms = CLJAtoms( moveAtoms(rand, cljatoms, 0.7) );
+
+        assert_false( list.needsRebuild(func, atoms), CODELOC );
+
+        ref = func.calculate(atoms);
+        nrg = calc.calculate(func, atoms, list);
+
+        assert_equal( list.nRebuilds(), 1, CODELOC );
+        assert_nearly_equal( nrg.get<0>(), ref.get<0>(), 1e-4*std::abs(ref.get<0>()) + 1e-4,
+                             CODELOC );
+        assert_nearly_equal( nrg.get<1>(), ref.get<1>(), 1e-4*std::abs(ref.get<1>()) + 1e-4,
+                             CODELOC );
+
+        //moving further must rebuild the list
+        atoms = CLJAtoms( moveAtoms(rand, cljatoms, 2.0) );
+
+        assert_true( list.needsRebuild(func, atoms), CODELOC );
+
+        ref = func.calculate(atoms);
+        nrg = calc.calculate(func, atoms, list);
+
+        assert_equal( list.nRebuilds(), 2, CODELOC );
+        assert_nearly_equal( nrg.get<0>(), ref.get<0>(), 1e-4*std::abs(ref.get<0>()) + 1e-4,
+                             CODELOC );
+        assert_nearly_equal( nrg.get<1>(), ref.get<1>(), 1e-4*std::abs(ref.get<1>()) + 1e-4,
+                             CODELOC );
+    }
+}
+
+SIRE_UNITTEST( test_cljneighbourlist )
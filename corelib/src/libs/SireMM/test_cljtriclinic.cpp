@@ -0,0 +1,266 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "SireMM/cljshiftfunction.h"
+#include "SireMM/cljforces.h"
+#include "SireMM/cljboxes.h"
+#include "SireMM/cljatoms.h"
+
+#include "SireVol/periodicbox.h"
+#include "SireVol/triclinicbox.h"
+
+#include "SireMaths/rangenerator.h"
+
+#include "SireUnits/units.h"
+
+#include "SireBase/unittest.h"
+
+#include <QDebug>
+
+#include <cmath>
+
+using namespace SireMM;
+using namespace SireMaths;
+using namespace SireVol;
+using namespace SireUnits;
+using namespace SireBase;
+using boost::tuple;
+
+/** The length of the side of the cubic box */
+static const double box_length = 12.0;
+
+/** Return 'natoms' random points in the cubic box that are at least
+    2 A apart, so that the LJ energies stay finite */
+static QVector<Vector> randomPoints(RanGenerator &rand, int natoms)
+{
+    const PeriodicBox box( Vector(box_length) );
+
+    QVector<Vector> points;
+
+    while (points.count() < natoms)
+    {
+        const Vector point( rand.rand(0,box_length), rand.rand(0,box_length),
+                            rand.rand(0,box_length) );
+
+        bool too_close = false;
+
+        foreach (const Vector &other, points)
+        {
+            if (box.calcDist(point, other) < 2.0)
+            {
+                too_close = true;
+                break;
+            }
+        }
+
+        if (not too_close)
+            points.append(point);
+    }
+
+    return points;
+}
+
+/** Return atoms at the points from 'start' to 'end'. Pairs of atoms share
+    the same ID, starting from 'first_id'. If 'shift' is true then atoms
+    near the edges are moved by a lattice vector so that they lie outside
+    the box (but close enough that the PeriodicBox kernels can still
+    wrap them with a single box shift) */
+static CLJAtoms makeAtoms(RanGenerator &rand, const QVector<Vector> &points,
+                          int start, int end, qint32 first_id, bool shift)
+{
+    QVector<CLJAtom> atoms;
+
+    for (int i=start; i<end; ++i)
+    {
+        Vector point = points[i];
+
+        if (shift)
+        {
+            if (point.x() > 0.75*box_length)
+                point -= Vector(box_length, 0, 0);
+
+            if (point.z() < 0.25*box_length)
+                point += Vector(0, 0, box_length);
+        }
+
+        atoms.append( CLJAtom(point, rand.rand(-0.5,0.5)*mod_electron,
+                              LJParameter(2.5*angstrom, 0.2*kcal_per_mol),
+                              first_id + atoms.count()/2) );
+    }
+
+    return CLJAtoms(atoms);
+}
+
+static void assert_same_energy(double nrg, double ref, QString codeloc)
+{
+    assert_nearly_equal( nrg, ref, 1e-4*std::abs(ref) + 1e-3, codeloc );
+}
+
+static void assert_same_energies(const tuple<double,double> &nrgs,
+                                 const tuple<double,double> &ref, QString codeloc)
+{
+    assert_same_energy( nrgs.get<0>(), ref.get<0>(), codeloc );
+    assert_same_energy( nrgs.get<1>(), ref.get<1>(), codeloc );
+}
+
+static void assert_same_forces(const CLJForces &forces, const CLJForces &ref, QString codeloc)
+{
+    assert_equal( forces.count(), ref.count(), codeloc );
+
+    for (int i=0; i<ref.count(); ++i)
+    {
+        for (int dim=0; dim<3; ++dim)
+        {
+            assert_nearly_equal( forces[i][dim], ref[i][dim],
+                                 1e-3*std::abs(ref[i][dim]) + 1e-3, codeloc );
+        }
+    }
+}
+
+static void assert_same_multi(const tuple< QVector<double>,QVector<double> > &nrgs,
+                              const tuple< QVector<double>,QVector<double> > &ref,
+                              QString codeloc)
+{
+    assert_equal( nrgs.get<0>().count(), ref.get<0>().count(), codeloc );
+
+    for (int i=0; i<ref.get<0>().count(); ++i)
+    {
+        assert_same_energy( nrgs.get<0>()[i], ref.get<0>()[i], codeloc );
+        assert_same_energy( nrgs.get<1>()[i], ref.get<1>()[i], codeloc );
+    }
+}
+
+/** Return soft-core functions at several values of alpha in 'space' */
+static QVector<CLJFunctionPtr> softFunctions(const Space &space,
+                                             CLJFunction::COMBINING_RULES rules)
+{
+    QVector<CLJFunctionPtr> funcs;
+
+    for (int i=0; i<4; ++i)
+    {
+        CLJSoftShiftFunction func(space, 5*angstrom, rules);
+        func.setAlpha(0.25*i);
+        func.setShiftDelta(1.5);
+        func.setCoulombPower(1);
+
+        funcs.append(func);
+    }
+
+    return funcs;
+}
+
+static void test_rules(CLJFunction::COMBINING_RULES rules, bool verbose)
+{
+    const PeriodicBox periodic( Vector(box_length) );
+    const TriclinicBox triclinic( Vector(box_length,0,0), Vector(0,box_length,0),
+                                  Vector(0,0,box_length) );
+
+    RanGenerator rand(3152);
+
+    //some of atoms1 lie outside the box so must be imaged
+    const QVector<Vector> points = randomPoints(rand, 100);
+    const CLJAtoms atoms0 = makeAtoms(rand, points, 0, 60, 1, false);
+    const CLJAtoms atoms1 = makeAtoms(rand, points, 60, 100, 1000, true);
+
+    const CLJShiftFunction pfunc(periodic, 5*angstrom, rules);
+    const CLJShiftFunction tfunc(triclinic, 5*angstrom, rules);
+
+    if (verbose)
+        qDebug() << pfunc.toString() << tfunc.toString();
+
+    //energies
+    assert_same_energies( tfunc.calculate(atoms0), pfunc.calculate(atoms0), CODELOC );
+    assert_same_energies( tfunc.calculate(atoms0, atoms1),
+                          pfunc.calculate(atoms0, atoms1), CODELOC );
+    assert_same_energies( tfunc.calculate(atoms1, atoms0),
+                          pfunc.calculate(atoms0, atoms1), CODELOC );
+
+    const CLJBoxes boxes0(atoms0);
+    const CLJBoxes boxes1(atoms1);
+
+    assert_same_energies( tfunc.calculate(boxes0), pfunc.calculate(atoms0), CODELOC );
+    assert_same_energies( tfunc.calculate(boxes0, boxes1),
+                          pfunc.calculate(atoms0, atoms1), CODELOC );
+
+    //forces
+    assert_same_forces( tfunc.force(atoms0), pfunc.force(atoms0), CODELOC );
+
+    CLJForces pforces0, pforces1, tforces0, tforces1;
+    pfunc.force(atoms0, atoms1, pforces0, pforces1);
+    tfunc.force(atoms0, atoms1, tforces0, tforces1);
+
+    assert_same_forces( tforces0, pforces0, CODELOC );
+    assert_same_forces( tforces1, pforces1, CODELOC );
+
+    CLJForces one_sided;
+    tfunc.force(atoms0, atoms1, one_sided);
+    assert_same_forces( one_sided, pforces0, CODELOC );
+
+    //the fused multi-state soft-core path
+    const QVector<CLJFunctionPtr> pfuncs = softFunctions(periodic, rules);
+    const QVector<CLJFunctionPtr> tfuncs = softFunctions(triclinic, rules);
+
+    //the reference is the periodic energy of each function calculated separately
+    QVector<double> ref_c, ref_lj, ref_c01, ref_lj01;
+
+    foreach (const CLJFunctionPtr &func, pfuncs)
+    {
+        tuple<double,double> nrgs = func.read().calculate(atoms0);
+        ref_c.append(nrgs.get<0>());
+        ref_lj.append(nrgs.get<1>());
+
+        nrgs = func.read().calculate(atoms0, atoms1);
+        ref_c01.append(nrgs.get<0>());
+        ref_lj01.append(nrgs.get<1>());
+    }
+
+    const tuple< QVector<double>,QVector<double> > ref(ref_c, ref_lj);
+    const tuple< QVector<double>,QVector<double> > ref01(ref_c01, ref_lj01);
+
+    if (verbose)
+        qDebug() << ref_c << ref_lj << ref_c01 << ref_lj01;
+
+    assert_same_multi( CLJFunction::multiCalculate(pfuncs, atoms0), ref, CODELOC );
+    assert_same_multi( CLJFunction::multiCalculate(tfuncs, atoms0), ref, CODELOC );
+    assert_same_multi( CLJFunction::multiCalculate(tfuncs, boxes0), ref, CODELOC );
+
+    assert_same_multi( CLJFunction::multiCalculate(tfuncs, atoms0, atoms1), ref01, CODELOC );
+    assert_same_multi( CLJFunction::multiCalculate(tfuncs, boxes0, boxes1), ref01, CODELOC );
+    assert_same_multi( CLJFunction::multiCalculate(tfuncs, atoms0, boxes1), ref01, CODELOC );
+}
+
+/** Check that a cubic TriclinicBox gives the same energies and forces
+    as the equivalent PeriodicBox, including through the fused multi-state
+    soft-core kernel */
+void test_cljtriclinic(bool verbose)
+{
+    test_rules( CLJFunction::GEOMETRIC, verbose );
+    test_rules( CLJFunction::ARITHMETIC, verbose );
+}
+
+SIRE_UNITTEST( test_cljtriclinic )
@@ -0,0 +1,140 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "SireMM/restraintff.h"
+#include "SireMM/distancerestraint.h"
+
+#include "SireFF/forcefields.h"
+#include "SireFF/point.h"
+
+#include "SireCAS/expression.h"
+#include "SireCAS/values.h"
+
+#include "SireMaths/vector.h"
+
+#include "SireUnits/units.h"
+
+#include "SireBase/unittest.h"
+
+#include <QDebug>
+
+#include <cmath>
+
+using namespace SireMM;
+using namespace SireFF;
+using namespace SireCAS;
+using namespace SireMaths;
+using namespace SireUnits;
+using namespace SireBase;
+
+/** Assert that every energy component returned by ForceFields::energies
+    (which uses the cache of compiled components) is equal to the value
+    calculated directly by ForceFields::energy */
+static void assert_same_energies(ForceFields &ffields, bool verbose, QString codeloc)
+{
+    const Values nrgs = ffields.energies();
+
+    assert_true( not nrgs.isEmpty(), codeloc );
+
+    foreach (const Symbol &symbol, nrgs.symbols())
+    {
+        const double nrg = ffields.energy(symbol).value();
+
+        if (verbose)
+            qDebug() << symbol.toString() << nrgs.value(symbol) << nrg;
+
+        assert_nearly_equal( nrgs.value(symbol), nrg, 1e-9*(1+std::abs(nrg)), codeloc );
+    }
+}
+
+/** Check that changing a constant component of a ForceFields is seen
+    by the cached energy components returned by ForceFields::energies */
+void test_forcefieldsenergies(bool verbose)
+{
+    RestraintFF restraintff("restraint");
+
+    restraintff.add( DistanceRestraint::harmonic(PointRef(Vector(0,0,0)),
+                                                 PointRef(Vector(3,0,0)),
+                                     5 * kcal_per_mol / (angstrom*angstrom)) );
+
+    ForceFields ffields(restraintff);
+
+    const Symbol e_restraint = restraintff.components().total();
+
+    const Symbol lam("lambda");
+    const Symbol mu("mu");
+    const Symbol e_lam("E_lambda");
+    const Symbol e_mu("E_mu");
+
+    //a constant value, and a constant expression that depends on it
+    ffields.setConstantComponent(lam, 0.5);
+    ffields.setConstantComponent(mu, 1 - Expression(lam));
+
+    ffields.setEnergyComponent(e_lam, Expression(lam) * Expression(e_restraint));
+    ffields.setEnergyComponent(e_mu, Expression(mu) * Expression(e_restraint));
+
+    const double nrg = ffields.energy(e_restraint).value();
+
+    assert_true( std::abs(nrg) > 1, CODELOC );
+
+    assert_same_energies(ffields, verbose, CODELOC);
+
+    //change the value of the constant - this takes the short-cut that
+    //only replaces the value, so must also throw away the compiled components
+    for (int i=0; i<=4; ++i)
+    {
+        const double lamval = 0.25 * i;
+
+        ffields.setConstantComponent(lam, lamval);
+
+        assert_same_energies(ffields, verbose, CODELOC);
+
+        const Values nrgs = ffields.energies();
+
+        assert_nearly_equal( nrgs.value(e_lam), lamval * nrg, 1e-9*std::abs(nrg), CODELOC );
+        assert_nearly_equal( nrgs.value(e_mu), (1-lamval) * nrg, 1e-9*std::abs(nrg), CODELOC );
+    }
+
+    //setting the same value again must not change anything
+    ffields.setConstantComponent(lam, 1.0);
+    assert_same_energies(ffields, verbose, CODELOC);
+
+    //a copy shares the cache, so changing the constant in the copy
+    //must not affect the original
+    ForceFields copy(ffields);
+
+    copy.setConstantComponent(lam, 0.0);
+
+    assert_nearly_equal( copy.energies().value(e_lam), 0.0, 1e-9, CODELOC );
+    assert_nearly_equal( ffields.energies().value(e_lam), nrg, 1e-9*std::abs(nrg), CODELOC );
+
+    assert_same_energies(copy, verbose, CODELOC);
+    assert_same_energies(ffields, verbose, CODELOC);
+}
+
+SIRE_UNITTEST( test_forcefieldsenergies )
@@ -0,0 +1,383 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "SireMM/gridcache.h"
+#include "SireMM/cljgrid.h"
+#include "SireMM/cljshiftfunction.h"
+#include "SireMM/cljatoms.h"
+
+#include "SireVol/aabox.h"
+
+#include "SireMaths/rangenerator.h"
+
+#include "SireUnits/units.h"
+
+#include "SireBase/unittest.h"
+
+#include <QTemporaryDir>
+#include <QDir>
+#include <QFile>
+#include <QDebug>
+
+#include <cstring>
+#include <cmath>
+
+using namespace SireMM;
+using namespace SireVol;
+using namespace SireMaths;
+using namespace SireUnits;
+using namespace SireBase;
+
+/** The offset of the number of grids in the header of a grid file */
+static const int NGRIDS_OFFSET = 16;
+
+/** The offset of the number of points in the first grid */
+static const int NPOINTS_OFFSET = 24;
+
+/** Return the names of all of the grid files in the cache */
+static QStringList gridFiles()
+{
+    return QDir(GridCache::cacheDirectory()).entryList(QStringList("*.grid"), QDir::Files);
+}
+
+/** Return the contents of the cached grid file 'filename' */
+static QByteArray readGridFile(const QString &filename)
+{
+    QFile f( QDir(GridCache::cacheDirectory()).filePath(filename) );
+    assert_true( f.open(QIODevice::ReadOnly), CODELOC );
+    return f.readAll();
+}
+
+/** Replace the contents of the cached grid file 'filename' with 'data' */
+static void writeGridFile(const QString &filename, const QByteArray &data)
+{
+    QFile f( QDir(GridCache::cacheDirectory()).filePath(filename) );
+    assert_true( f.open(QIODevice::WriteOnly | QIODevice::Truncate), CODELOC );
+    assert_equal( int(f.write(data)), data.count(), CODELOC );
+}
+
+/** Return a copy of 'data' with the quint32 at 'offset' set to 'value' */
+static QByteArray setUInt32(QByteArray data, int offset, quint32 value)
+{
+    std::memcpy(data.data() + offset, &value, sizeof(quint32));
+    return data;
+}
+
+/** Return a copy of 'data' with the quint64 at 'offset' set to 'value' */
+static QByteArray setUInt64(QByteArray data, int offset, quint64 value)
+{
+    std::memcpy(data.data() + offset, &value, sizeof(quint64));
+    return data;
+}
+
+/** Calculate the coulomb and LJ energy of 'atoms' with the fixed atoms
+    'fixed' using a CLJGrid */
+static void gridEnergy(const CLJFunction &func, const CLJAtoms &fixed, const CLJAtoms &atoms,
+                       double &cnrg, double &ljnrg)
+{
+    CLJGrid grid(func, AABox(Vector(2), Vector(2)), 0.5*angstrom);
+    grid.setFixedAtoms(fixed);
+
+    assert_true( grid.usesGrid(), CODELOC );
+
+    grid.total(atoms, cnrg, ljnrg);
+}
+
+void test_gridcache(bool verbose)
+{
+    QTemporaryDir tmpdir;
+    assert_true( tmpdir.isValid(), CODELOC );
+
+    const QString old_directory = GridCache::cacheDirectory();
+
+    GridCache::setCacheDirectory( QDir(tmpdir.path()).filePath("cache") );
+    assert_true( GridCache::isEnabled(), CODELOC );
+
+    RanGenerator rand(97531);
+
+    //save and load grids of floats and doubles
+    QVector<float> fgrid(1001);
+
+    for (int i=0; i<fgrid.count(); ++i)
+    {
+        fgrid[i] = rand.rand(-10, 10);
+    }
+
+    QVector< QVector<double> > dgrids(3);
+
+    for (int i=0; i<dgrids.count(); ++i)
+    {
+        dgrids[i] = QVector<double>(100 + 37*i);
+
+        for (int j=0; j<dgrids[i].count(); ++j)
+        {
+            dgrids[i][j] = rand.rand(-10, 10);
+        }
+    }
+
+    //include an empty grid
+    dgrids.append( QVector<double>() );
+
+    const QString fkey = GridCache::createKey("float grid");
+    const QString dkey = GridCache::createKey("double grids");
+
+    assert_not_equal( fkey, dkey, CODELOC );
+    assert_false( GridCache::contains(fkey), CODELOC );
+
+    QVector<float> loaded_fgrid;
+    QVector< QVector<double> > loaded_dgrids;
+
+    assert_false( GridCache::load(fkey, loaded_fgrid), CODELOC );
+
+    assert_true( GridCache::save(fkey, fgrid), CODELOC );
+    assert_true( GridCache::save(dkey, dgrids), CODELOC );
+
+    assert_true( GridCache::contains(fkey), CODELOC );
+    assert_equal( gridFiles().count(), 2, CODELOC );
+
+    assert_true( GridCache::load(fkey, loaded_fgrid), CODELOC );
+    assert_true( GridCache::load(dkey, loaded_dgrids), CODELOC );
+
+    assert_true( loaded_fgrid == fgrid, CODELOC );
+    assert_true( loaded_dgrids == dgrids, CODELOC );
+
+    //a grid of floats cannot be loaded as doubles
+    assert_false( GridCache::load(fkey, loaded_dgrids), CODELOC );
+
+    //check that truncated or corrupt files are ignored
+    const QString ffile = QString("%1.grid").arg(fkey);
+    const QString dfile = QString("%1.grid").arg(dkey);
+
+    const QByteArray fdata = readGridFile(ffile);
+    const QByteArray ddata = readGridFile(dfile);
+
+    QList<QByteArray> corrupt_fdata;
+    QList<QByteArray> corrupt_ddata;
+
+    //truncated files
+    corrupt_fdata << fdata.left(fdata.count() - 4) << fdata.left(10) << QByteArray();
+    corrupt_ddata << ddata.left(ddata.count() - 1) << ddata.left(NPOINTS_OFFSET + 8);
+
+    //too much data
+    corrupt_fdata << fdata + QByteArray(4, '\0');
+
+    //a bad magic string
+    QByteArray bad_magic = fdata;
+    bad_magic[0] = 'X';
+    corrupt_fdata << bad_magic;
+
+    //too many grids, including a count that would overflow if multiplied
+    //by the size of each count
+    corrupt_fdata << setUInt32(fdata, NGRIDS_OFFSET, 2)
+                  << setUInt32(fdata, NGRIDS_OFFSET, 0xFFFFFFFF);
+    corrupt_ddata << setUInt32(ddata, NGRIDS_OFFSET, 0x80000001);
+
+    //numbers of points that are too large, or that would overflow (either
+    //when multiplied by the size of each value, or when converted to an int)
+    //to give the correct total size
+    corrupt_fdata << setUInt64(fdata, NPOINTS_OFFSET, fgrid.count() + 1)
+                  << setUInt64(fdata, NPOINTS_OFFSET, (quint64(1) << 62) + fgrid.count())
+                  << setUInt64(fdata, NPOINTS_OFFSET, (quint64(1) << 32) + fgrid.count());
+
+    corrupt_ddata << setUInt64( setUInt64(ddata, NPOINTS_OFFSET, (quint64(1) << 61)),
+                                NPOINTS_OFFSET + 8, dgrids[1].count() + dgrids[0].count() );
+
+    for (int i=0; i<corrupt_fdata.count(); ++i)
+    {
+        writeGridFile(ffile, corrupt_fdata[i]);
+
+        QVector<float> grid = fgrid;
+
+        if (verbose)
+            qDebug() << "Loading corrupt float grid" << i;
+
+        assert_false( GridCache::load(fkey, grid), CODELOC );
+
+        //the passed grid is not changed
+        assert_true( grid == fgrid, CODELOC );
+    }
+
+    for (int i=0; i<corrupt_ddata.count(); ++i)
+    {
+        writeGridFile(dfile, corrupt_ddata[i]);
+
+        QVector< QVector<double> > grids = dgrids;
+
+        if (verbose)
+            qDebug() << "Loading corrupt double grids" << i;
+
+        assert_false( GridCache::load(dkey, grids), CODELOC );
+        assert_true( grids == dgrids, CODELOC );
+    }
+
+    //restoring the files makes them loadable again
+    writeGridFile(ffile, fdata);
+    writeGridFile(dfile, ddata);
+
+    assert_true( GridCache::load(fkey, loaded_fgrid), CODELOC );
+    assert_true( loaded_fgrid == fgrid, CODELOC );
+
+    GridCache::clear();
+    assert_equal( gridFiles().count(), 0, CODELOC );
+
+    //now check that the CLJGrid reads the grid from the cache. The mobile
+    //atoms are in the grid box, while the fixed atoms are beyond the LJ cutoff
+    //(so all of their interactions are calculated using the grid)
+    QVector<CLJAtom> mobile, fixed;
+
+    for (int i=0; i<10; ++i)
+    {
+        mobile.append( CLJAtom( Vector(rand.rand(0,4), rand.rand(0,4), rand.rand(0,4)),
+                                rand.rand(-0.5,0.5)*mod_electron,
+                                LJParameter(3*angstrom, 0.1*kcal_per_mol) ) );
+    }
+
+    for (int i=0; i<200; ++i)
+    {
+        fixed.append( CLJAtom( Vector(2) + rand.vectorOnSphere(rand.rand(10,14)),
+                               rand.rand(-0.5,0.5)*mod_electron,
+                               LJParameter(3*angstrom, 0.1*kcal_per_mol) ) );
+    }
+
+    const CLJAtoms mobile_atoms(mobile);
+    const CLJAtoms fixed_atoms(fixed);
+
+    const CLJShiftFunction func(15*angstrom, 5*angstrom);
+
+    //the energy with a freshly built grid, without the cache
+    GridCache::setCacheDirectory( QString() );
+    assert_false( GridCache::isEnabled(), CODELOC );
+
+    double ref_cnrg, ref_ljnrg;
+    gridEnergy(func, fixed_atoms, mobile_atoms, ref_cnrg, ref_ljnrg);
+
+    assert_true( ref_cnrg != 0, CODELOC );
+
+    GridCache::setCacheDirectory( QDir(tmpdir.path()).filePath("cache") );
+
+    //the first grid is built and saved, and the second is loaded, which
+    //must give identical energies
+    double built_cnrg, built_ljnrg;
+    gridEnergy(func, fixed_atoms, mobile_atoms, built_cnrg, built_ljnrg);
+
+    assert_equal( gridFiles().count(), 1, CODELOC );
+
+    assert_nearly_equal( built_cnrg, ref_cnrg, 1e-6 * std::abs(ref_cnrg), CODELOC );
+    assert_nearly_equal( built_ljnrg, ref_ljnrg, 1e-6 * std::abs(ref_ljnrg) + 1e-9, CODELOC );
+
+    double loaded_cnrg, loaded_ljnrg;
+    gridEnergy(func, fixed_atoms, mobile_atoms, loaded_cnrg, loaded_ljnrg);
+
+    assert_equal( gridFiles().count(), 1, CODELOC );
+
+    assert_equal( loaded_cnrg, built_cnrg, CODELOC );
+    assert_equal( loaded_ljnrg, built_ljnrg, CODELOC );
+
+    const QString gridfile = gridFiles().at(0);
+    const QByteArray griddata = readGridFile(gridfile);
+
+    //check that the grid really is loaded from the cache, by zeroing
+    //the cached potentials
+    {
+        const int header_size = NPOINTS_OFFSET + 8;
+
+        QByteArray zeroed = griddata;
+        std::memset(zeroed.data() + header_size, 0, zeroed.count() - header_size);
+        writeGridFile(gridfile, zeroed);
+
+        double cnrg, ljnrg;
+        gridEnergy(func, fixed_atoms, mobile_atoms, cnrg, ljnrg);
+
+        assert_equal( cnrg, 0.0, CODELOC );
+
+        writeGridFile(gridfile, griddata);
+    }
+
+    //a truncated or corrupt file is ignored, and the grid is rebuilt
+    //and saved again
+    QList<QByteArray> corrupt;
+    corrupt << griddata.left(griddata.count() - 4)
+            << setUInt64(griddata, NPOINTS_OFFSET, (quint64(1) << 62) +
+                                                   (griddata.count() - NPOINTS_OFFSET - 8) / 4)
+            << setUInt32(griddata, NGRIDS_OFFSET, 0xFFFFFFFF);
+
+    foreach (const QByteArray &data, corrupt)
+    {
+        writeGridFile(gridfile, data);
+
+        double cnrg, ljnrg;
+        gridEnergy(func, fixed_atoms, mobile_atoms, cnrg, ljnrg);
+
+        assert_nearly_equal( cnrg, ref_cnrg, 1e-6 * std::abs(ref_cnrg), CODELOC );
+        assert_nearly_equal( ljnrg, ref_ljnrg, 1e-6 * std::abs(ref_ljnrg) + 1e-9, CODELOC );
+
+        //the rebuilt grid replaces the corrupt file
+        assert_equal( readGridFile(gridfile).count(), griddata.count(), CODELOC );
+
+        writeGridFile(gridfile, griddata);
+    }
+
+    //changing the function or the fixed atoms must miss the cache
+    int nfiles = 1;
+
+    QList<CLJShiftFunction> funcs;
+    funcs << CLJShiftFunction(14*angstrom, 5*angstrom)
+          << CLJShiftFunction(15*angstrom, 4.5*angstrom);
+
+    foreach (const CLJShiftFunction &f, funcs)
+    {
+        double cnrg, ljnrg;
+        gridEnergy(f, fixed_atoms, mobile_atoms, cnrg, ljnrg);
+
+        nfiles += 1;
+        assert_equal( gridFiles().count(), nfiles, CODELOC );
+    }
+
+    QVector<CLJAtom> changed = fixed;
+    changed[17] = CLJAtom( fixed[17].coordinates(), fixed[17].charge() + 0.1*mod_electron,
+                           fixed[17].ljParameter() );
+
+    double changed_cnrg, changed_ljnrg;
+    gridEnergy(func, CLJAtoms(changed), mobile_atoms, changed_cnrg, changed_ljnrg);
+
+    nfiles += 1;
+    assert_equal( gridFiles().count(), nfiles, CODELOC );
+    assert_true( changed_cnrg != ref_cnrg, CODELOC );
+
+    //and the original grid is still loaded from the cache
+    double cnrg, ljnrg;
+    gridEnergy(func, fixed_atoms, mobile_atoms, cnrg, ljnrg);
+
+    assert_equal( cnrg, built_cnrg, CODELOC );
+    assert_equal( gridFiles().count(), nfiles, CODELOC );
+
+    GridCache::clear();
+    GridCache::setCacheDirectory(old_directory);
+}
+
+SIRE_UNITTEST( test_gridcache )
@@ -0,0 +1,264 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "SireMM/gridff2.h"
+#include "SireMM/atomljs.h"
+#include "SireMM/ljparameter.h"
+
+#include "SireMol/molecule.h"
+#include "SireMol/moleculeinfo.h"
+#include "SireMol/moleditor.h"
+#include "SireMol/atomeditor.h"
+#include "SireMol/cgeditor.h"
+#include "SireMol/atomcoords.h"
+#include "SireMol/atomcharges.h"
+#include "SireMol/mgidx.h"
+#include "SireMol/mover.hpp"
+
+#include "SireVol/coordgroup.h"
+
+#include "SireMaths/rangenerator.h"
+
+#include "SireUnits/units.h"
+
+#include "SireBase/unittest.h"
+
+#include <QDebug>
+
+#include <cmath>
+
+using namespace SireMM;
+using namespace SireMol;
+using namespace SireVol;
+using namespace SireMaths;
+using namespace SireUnits;
+using namespace SireBase;
+
+/** The LJ cutoff used by the grids. This is long enough that every pair
+    of atoms (and every grid point near the solute) is within the cutoff,
+    so that the grids and the explicit energies see the same atoms */
+static const double lj_cutoff = 15.0;
+
+/** Return an uncharged molecule with the passed atoms and LJ parameters,
+    all in a single CutGroup */
+static Molecule createMolecule(const QVector<Vector> &coords,
+                               const QVector<LJParameter> &ljs)
+{
+    MolStructureEditor editor;
+
+    CGStructureEditor cgroup = editor.add( CGName("1") );
+
+    for (int i=0; i<coords.count(); ++i)
+    {
+        AtomStructureEditor atom = editor.add( AtomNum(i+1) );
+        atom = atom.rename( AtomName(QString("X%1").arg(i+1)) );
+        atom = atom.reparent( cgroup.index() );
+    }
+
+    Molecule mol = editor.commit();
+
+    AtomLJs atomljs( mol.data().info() );
+    AtomCharges charges( mol.data().info(), 0*mod_electron );
+
+    for (int i=0; i<coords.count(); ++i)
+    {
+        atomljs.set( CGAtomIdx(CGIdx(0),Index(i)), ljs[i] );
+    }
+
+    QVector< QVector<Vector> > cgcoords;
+    cgcoords.append(coords);
+
+    return mol.edit().setProperty("coordinates", AtomCoords(CoordGroupArray(cgcoords)))
+                     .setProperty("charge", charges)
+                     .setProperty("LJ", atomljs)
+                     .commit();
+}
+
+/** Return the LJ energy between the two sets of atoms, calculated
+    explicitly using arithmetic combining rules and the LJ cutoff */
+static double explicitLJEnergy(const QVector<Vector> &coords0, const QVector<LJParameter> &ljs0,
+                               const QVector<Vector> &coords1, const QVector<LJParameter> &ljs1)
+{
+    double nrg = 0;
+
+    for (int i=0; i<coords0.count(); ++i)
+    {
+        for (int j=0; j<coords1.count(); ++j)
+        {
+            const double r = Vector::distance(coords0[i], coords1[j]);
+
+            if (r >= lj_cutoff)
+                continue;
+
+            const double sig = 0.5 * (ljs0[i].sigma() + ljs1[j].sigma());
+            const double eps = std::sqrt(ljs0[i].epsilon() * ljs1[j].epsilon());
+
+            const double sig6_over_r6 = std::pow(sig/r, 6);
+
+            nrg += 4 * eps * (sig6_over_r6*sig6_over_r6 - sig6_over_r6);
+        }
+    }
+
+    return nrg;
+}
+
+/** Return the LJ and coulomb energies of 'solute' with 'solvent'
+    calculated using a GridFF2 */
+static double gridEnergy(const Molecule &solute, const Molecule &solvent,
+                         bool use_lj_grids, bool use_tricubic,
+                         const Vector &delta, bool verbose)
+{
+    GridFF2 gridff("gridff");
+
+    gridff.setGridSpacing(0.25*angstrom);
+    gridff.setBuffer(2.5*angstrom);
+    gridff.setLJCutoff(lj_cutoff*angstrom);
+    gridff.setUseLJGrids(use_lj_grids);
+    gridff.setUseTricubicInterpolation(use_tricubic);
+
+    gridff.add(solute, MGIdx(0));
+    gridff.add(solvent, MGIdx(1));
+
+    double ljnrg = gridff.energy(gridff.components().lj()).value();
+
+    if (use_lj_grids)
+        assert_equal( gridff.nLJGrids(), 2, CODELOC );
+    else
+        assert_equal( gridff.nLJGrids(), 0, CODELOC );
+
+    //the molecules are uncharged
+    assert_nearly_equal( gridff.energy(gridff.components().coulomb()).value(),
+                         0.0, 1e-6, CODELOC );
+
+    if (not delta.isZero())
+    {
+        //move the solute by less than the buffer, so that the
+        //grid is reused rather than rebuilt
+        gridff.update( solute.move().translate(delta).commit() );
+        ljnrg = gridff.energy(gridff.components().lj()).value();
+    }
+
+    if (verbose)
+        qDebug() << use_lj_grids << use_tricubic << delta.toString() << ljnrg;
+
+    return ljnrg;
+}
+
+/** Check that the LJ grids of GridFF2 give the same energy as calculating
+    the LJ energy explicitly, to within the interpolation error */
+void test_gridff2(bool verbose)
+{
+    RanGenerator rand(7134);
+
+    //a small solute with two LJ types, away from the origin so
+    //that it is far from the zero coordinates of the padding atoms
+    QVector<Vector> solute_coords;
+    QVector<LJParameter> solute_ljs;
+
+    for (int i=0; i<3; ++i)
+    {
+        for (int j=0; j<2; ++j)
+        {
+            solute_coords.append( Vector(10 + 1.6*i + rand.rand(-0.2,0.2),
+                                         10 + 1.6*j + rand.rand(-0.2,0.2),
+                                         10 + rand.rand(-0.2,0.2)) );
+
+            if ((i+j) % 2 == 0)
+                solute_ljs.append( LJParameter(3.0*angstrom, 0.1*kcal_per_mol) );
+            else
+                solute_ljs.append( LJParameter(2.5*angstrom, 0.05*kcal_per_mol) );
+        }
+    }
+
+    //a solvent of 40 atoms around the solute, none of which is too
+    //close to the solute or to each other
+    QVector<Vector> solvent_coords;
+    QVector<LJParameter> solvent_ljs;
+
+    while (solvent_coords.count() < 40)
+    {
+        const Vector c( 10 + rand.rand(-6,9), 10 + rand.rand(-6,8), 10 + rand.rand(-6,6) );
+
+        bool too_close = false;
+
+        foreach (const Vector &s, solute_coords)
+        {
+            too_close = too_close or Vector::distance(c, s) < 3.4;
+        }
+
+        foreach (const Vector &s, solvent_coords)
+        {
+            too_close = too_close or Vector::distance(c, s) < 2.0;
+        }
+
+        if (not too_close)
+        {
+            solvent_coords.append(c);
+            solvent_ljs.append( LJParameter(3.2*angstrom, 0.15*kcal_per_mol) );
+        }
+    }
+
+    const Molecule solute = createMolecule(solute_coords, solute_ljs);
+    const Molecule solvent = createMolecule(solvent_coords, solvent_ljs);
+
+    QList<Vector> deltas;
+    deltas.append( Vector(0) );
+    deltas.append( Vector(0.3, -0.2, 0.1) );
+
+    foreach (const Vector &delta, deltas)
+    {
+        QVector<Vector> moved_coords = solute_coords;
+
+        for (int i=0; i<moved_coords.count(); ++i)
+        {
+            moved_coords[i] += delta;
+        }
+
+        const double ref = explicitLJEnergy(moved_coords, solute_ljs,
+                                            solvent_coords, solvent_ljs);
+
+        if (verbose)
+            qDebug() << "explicit" << delta.toString() << ref;
+
+        assert_true( ref < -0.5, CODELOC );
+
+        //without LJ grids, the LJ energy is calculated explicitly (in single precision)
+        assert_nearly_equal( gridEnergy(solute, solvent, false, false, delta, verbose),
+                             ref, 1e-4*std::abs(ref), CODELOC );
+
+        //trilinear interpolation of the LJ grids
+        assert_nearly_equal( gridEnergy(solute, solvent, true, false, delta, verbose),
+                             ref, 0.01*std::abs(ref), CODELOC );
+
+        //tricubic interpolation is much more accurate
+        assert_nearly_equal( gridEnergy(solute, solvent, true, true, delta, verbose),
+                             ref, 0.0025*std::abs(ref), CODELOC );
+    }
+}
+
+SIRE_UNITTEST( test_gridff2 )
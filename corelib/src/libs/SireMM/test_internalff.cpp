@@ -0,0 +1,504 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "SireMM/internalff.h"
+#include "SireMM/twoatomfunctions.h"
+#include "SireMM/threeatomfunctions.h"
+#include "SireMM/fouratomfunctions.h"
+
+#include "SireMol/molecule.h"
+#include "SireMol/moleculeinfo.h"
+#include "SireMol/moleditor.h"
+#include "SireMol/atomeditor.h"
+#include "SireMol/cgeditor.h"
+#include "SireMol/atomcoords.h"
+#include "SireMol/moleculegroup.h"
+
+#include "SireFF/forcetable.h"
+
+#include "SireCAS/compiledexpression.h"
+#include "SireCAS/trigfuncs.h"
+#include "SireCAS/values.h"
+
+#include "SireVol/coordgroup.h"
+
+#include "SireMaths/torsion.h"
+#include "SireMaths/multidouble.h"
+#include "SireMaths/rangenerator.h"
+
+#include "SireUnits/units.h"
+
+#include "SireBase/unittest.h"
+
+#include <QDebug>
+
+#include <cmath>
+
+using namespace SireMM;
+using namespace SireMol;
+using namespace SireFF;
+using namespace SireCAS;
+using namespace SireVol;
+using namespace SireMaths;
+using namespace SireUnits;
+using namespace SireBase;
+
+/** Return the potential of the ith bond of a chain. The even bonds
+    are harmonic, so are evaluated in the packed harmonic bucket, while
+    the odd bonds have a cubic term, so are evaluated as generic bonds */
+static Expression bondPotential(int i)
+{
+    const Symbol &r = InternalPotential::symbols().bond().r();
+    const double r0 = 1.4 + 0.02*i;
+
+    if (i % 2 == 0)
+        return (300 + 10*i) * (r - r0).pow(2);
+    else
+        return 250 * (r - r0).pow(2) - 120 * (r - r0).pow(3);
+}
+
+/** Return the potential of the ith angle of a chain. Angles are either
+    harmonic in theta or (generic) harmonic in cos(theta) */
+static Expression anglePotential(int i)
+{
+    const Symbol &theta = InternalPotential::symbols().angle().theta();
+    const double theta0 = 1.8 + 0.05*i;
+
+    if (i % 3 != 1)
+        return (50 + 5*i) * (theta - theta0).pow(2);
+    else
+        return 40 * (Cos(theta) - std::cos(theta0)).pow(2);
+}
+
+/** Return the potential of the ith dihedral of a chain. Dihedrals are
+    either cosine series (including a sine term, which is rewritten
+    as a phase-shifted cosine) or (generic) harmonic in phi */
+static Expression dihedralPotential(int i)
+{
+    const Symbol &phi = InternalPotential::symbols().dihedral().phi();
+
+    if (i % 3 == 2)
+        return 2 * (phi - 2.5).pow(2);
+    else
+        return (1.5 + 0.1*i) * (1 + Cos(phi)) + 0.5 * (1 + Cos(3*phi - 0.3))
+                    + 0.25 * Sin(2*phi);
+}
+
+/** Return the potential of the improper around atom i+1 of a chain,
+    which depends on both theta and phi */
+static Expression improperPotential(int i)
+{
+    const Symbol &theta = InternalPotential::symbols().improper().theta();
+    const Symbol &phi = InternalPotential::symbols().improper().phi();
+
+    return (2 + 0.1*i) * (1 - Cos(2*phi)) + 5 * (theta - 0.2).pow(2);
+}
+
+/** Return the Urey-Bradley potential between atoms i and i+2 of a chain */
+static Expression ubPotential(int i)
+{
+    const Symbol &r = InternalPotential::symbols().ureyBradley().r();
+
+    return (20 + i) * (r - 2.4).pow(2);
+}
+
+/** Return a chain molecule with the passed coordinates, with its atoms divided
+    in order between 'ncgroups' CutGroups, and with the bonds, angles, dihedrals,
+    impropers and Urey-Bradley terms of a chain */
+static Molecule createChain(const QVector<Vector> &coords, int ncgroups)
+{
+    const int natoms = coords.count();
+
+    MolStructureEditor editor;
+
+    for (int i=0; i<ncgroups; ++i)
+    {
+        editor.add( CGName(QString::number(i+1)) );
+    }
+
+    QVector< QVector<Vector> > cgcoords(ncgroups);
+
+    for (int i=0; i<natoms; ++i)
+    {
+        const int cgidx = (i * ncgroups) / natoms;
+
+        AtomStructureEditor atom = editor.add( AtomNum(i+1) );
+        atom = atom.rename( AtomName(QString("C%1").arg(i+1)) );
+        atom = atom.reparent( CGIdx(cgidx) );
+
+        cgcoords[cgidx].append(coords[i]);
+    }
+
+    Molecule mol = editor.commit();
+
+    TwoAtomFunctions bonds(mol.data().info());
+    ThreeAtomFunctions angles(mol.data().info());
+    FourAtomFunctions dihedrals(mol.data().info());
+    FourAtomFunctions impropers(mol.data().info());
+    TwoAtomFunctions ubs(mol.data().info());
+
+    for (int i=0; i<natoms-1; ++i)
+    {
+        bonds.set( AtomIdx(i), AtomIdx(i+1), bondPotential(i) );
+    }
+
+    for (int i=0; i<natoms-2; ++i)
+    {
+        angles.set( AtomIdx(i), AtomIdx(i+1), AtomIdx(i+2), anglePotential(i) );
+        ubs.set( AtomIdx(i), AtomIdx(i+2), ubPotential(i) );
+    }
+
+    for (int i=0; i<natoms-3; ++i)
+    {
+        dihedrals.set( AtomIdx(i), AtomIdx(i+1), AtomIdx(i+2), AtomIdx(i+3),
+                       dihedralPotential(i) );
+
+        if (i % 2 == 0)
+            impropers.set( AtomIdx(i), AtomIdx(i+1), AtomIdx(i+2), AtomIdx(i+3),
+                           improperPotential(i) );
+    }
+
+    return mol.edit().setProperty("coordinates", AtomCoords(CoordGroupArray(cgcoords)))
+                     .setProperty("bond", bonds)
+                     .setProperty("angle", angles)
+                     .setProperty("dihedral", dihedrals)
+                     .setProperty("improper", impropers)
+                     .setProperty("Urey-Bradley", ubs)
+                     .commit();
+}
+
+/** Return the derivative of 'f' with respect to 'x', evaluated at 'x' */
+static double derivative(const Expression &f, const Symbol &x, double val)
+{
+    Values values;
+    values.set(x, val);
+
+    return f.differentiate(x).evaluate(values);
+}
+
+/** Return the value of 'f' evaluated at 'x' */
+static double evaluate(const Expression &f, const Symbol &x, double val)
+{
+    Values values;
+    values.set(x, val);
+
+    return f.evaluate(values);
+}
+
+/** The energies and forces of a chain calculated term by term, by evaluating
+    the expression of each term, as InternalPotential did before the bonds,
+    angles and dihedrals were packed */
+struct ChainReference
+{
+    ChainReference(const QVector<Vector> &coords);
+
+    double bond_nrg;
+    double angle_nrg;
+    double dihedral_nrg;
+    double improper_nrg;
+    double ub_nrg;
+
+    QVector<Vector> bond_forces;
+    QVector<Vector> angle_forces;
+    QVector<Vector> dihedral_forces;
+};
+
+ChainReference::ChainReference(const QVector<Vector> &coords)
+               : bond_nrg(0), angle_nrg(0), dihedral_nrg(0),
+                 improper_nrg(0), ub_nrg(0),
+                 bond_forces(coords.count(), Vector(0)),
+                 angle_forces(coords.count(), Vector(0)),
+                 dihedral_forces(coords.count(), Vector(0))
+{
+    const InternalSymbols &symbols = InternalPotential::symbols();
+    const int natoms = coords.count();
+
+    //bonds, with no force between overlapping atoms
+    for (int i=0; i<natoms-1; ++i)
+    {
+        const Vector v01 = coords[i] - coords[i+1];
+        const double r = v01.length();
+
+        bond_nrg += evaluate(bondPotential(i), symbols.bond().r(), r);
+
+        if (r == 0)
+            continue;
+
+        const Vector force = -derivative(bondPotential(i), symbols.bond().r(), r)
+                                    * (v01 / r);
+
+        bond_forces[i] += force;
+        bond_forces[i+1] -= force;
+    }
+
+    //angles, using d theta / dr of InternalPotential
+    for (int i=0; i<natoms-2; ++i)
+    {
+        const double theta = Vector::angle(coords[i], coords[i+1], coords[i+2])
+                                    .to(radians);
+
+        angle_nrg += evaluate(anglePotential(i), symbols.angle().theta(), theta);
+
+        Vector A = coords[i] - coords[i+1];
+        Vector B = coords[i+2] - coords[i+1];
+
+        const double rA = A.length();
+        const double rB = B.length();
+
+        if (rA * rB == 0)
+            continue;
+
+        A /= rA;
+        B /= rB;
+
+        const double A_B = Vector::dot(A,B);
+
+        if (A_B == 0)
+            continue;
+
+        const double dv_by_dtheta = derivative(anglePotential(i), symbols.angle().theta(),
+                                               std::acos(A_B));
+
+        const Vector f0 = (dv_by_dtheta / rA) * (B + A_B*A);
+        const Vector f2 = (dv_by_dtheta / rB) * (A + A_B*B);
+
+        angle_forces[i] += f0;
+        angle_forces[i+1] -= (f0 + f2);
+        angle_forces[i+2] += f2;
+    }
+
+    //dihedrals, using d phi / dr of InternalPotential (Blondel and Karplus)
+    for (int i=0; i<natoms-3; ++i)
+    {
+        const double phi = Vector::dihedral(coords[i], coords[i+1],
+                                            coords[i+2], coords[i+3]).to(radians);
+
+        dihedral_nrg += evaluate(dihedralPotential(i), symbols.dihedral().phi(), phi);
+
+        Vector F = coords[i] - coords[i+1];
+        Vector G = coords[i+1] - coords[i+2];
+        Vector H = coords[i+3] - coords[i+2];
+
+        const double rF = F.length();
+        const double rG = G.length();
+        const double rH = H.length();
+
+        if (rF * rG * rH == 0)
+            continue;
+
+        F /= rF;
+        G /= rG;
+        H /= rH;
+
+        const double F_G = Vector::dot(F,G);
+        const double H_G = Vector::dot(H,G);
+
+        Vector A( F.y()*G.z() - F.z()*G.y(),
+                  F.z()*G.x() - F.x()*G.z(),
+                  F.x()*G.y() - F.y()*G.x() );
+
+        Vector B( H.y()*G.z() - H.z()*G.y(),
+                  H.z()*G.x() - H.x()*G.z(),
+                  H.x()*G.y() - H.y()*G.x() );
+
+        const double rA = A.length();
+        const double rB = B.length();
+
+        if (rA * rB == 0)
+            continue;
+
+        A /= rA;
+        B /= rB;
+
+        const double dv_by_dphi = derivative(dihedralPotential(i),
+                                             symbols.dihedral().phi(), phi);
+
+        const Vector dphi_by_dF = (-dv_by_dphi / rF) * A;
+        const Vector dphi_by_dH = (dv_by_dphi / rH) * B;
+        const Vector dphi_by_dG = (dv_by_dphi / rG) * (F_G*A - H_G*B);
+
+        dihedral_forces[i] += dphi_by_dF;
+        dihedral_forces[i+1] += dphi_by_dG - dphi_by_dF;
+        dihedral_forces[i+2] -= dphi_by_dG + dphi_by_dH;
+        dihedral_forces[i+3] += dphi_by_dH;
+    }
+
+    //impropers and Urey-Bradley terms (energies only)
+    for (int i=0; i<natoms-3; i+=2)
+    {
+        Torsion torsion(coords[i], coords[i+1], coords[i+2], coords[i+3]);
+
+        Values values;
+        values.set(symbols.improper().theta(), torsion.improperAngle().to(radians));
+        values.set(symbols.improper().phi(), torsion.angle().to(radians));
+
+        improper_nrg += improperPotential(i).evaluate(values);
+    }
+
+    for (int i=0; i<natoms-2; ++i)
+    {
+        ub_nrg += evaluate(ubPotential(i), symbols.ureyBradley().r(),
+                           Vector::distance(coords[i], coords[i+2]));
+    }
+}
+
+static void assert_same_forces(const QVector<Vector> &forces, const QVector<Vector> &ref,
+                               QString codeloc)
+{
+    assert_equal( forces.count(), ref.count(), codeloc );
+
+    for (int i=0; i<ref.count(); ++i)
+    {
+        for (int dim=0; dim<3; ++dim)
+        {
+            assert_true( std::isfinite(forces[i][dim]), codeloc );
+            assert_nearly_equal( forces[i][dim], ref[i][dim],
+                                 1e-6*std::abs(ref[i][dim]) + 1e-8, codeloc );
+        }
+    }
+}
+
+/** Return the forces on 'mol' from the component 'component' of 'ff' */
+static QVector<Vector> getForces(InternalFF &ff, const Molecule &mol, const Symbol &component)
+{
+    MoleculeGroup molgroup("test");
+    molgroup.add(mol);
+
+    ForceTable forcetable(molgroup);
+    ff.force(forcetable, component);
+
+    return forcetable.getTable(mol.number()).toVector();
+}
+
+/** Compare the packed energies and forces of the chain with coordinates
+    'coords' (divided between 'ncgroups' CutGroups) against those
+    calculated term by term */
+static void test_chain(const QVector<Vector> &coords, int ncgroups, bool verbose)
+{
+    const Molecule mol = createChain(coords, ncgroups);
+
+    InternalFF ff("internal");
+    ff.add(mol);
+
+    const ChainReference ref(coords);
+
+    const double bond_nrg = ff.energy( ff.components().bond() ).value();
+    const double angle_nrg = ff.energy( ff.components().angle() ).value();
+    const double dihedral_nrg = ff.energy( ff.components().dihedral() ).value();
+    const double improper_nrg = ff.energy( ff.components().improper() ).value();
+    const double ub_nrg = ff.energy( ff.components().ureyBradley() ).value();
+
+    if (verbose)
+    {
+        qDebug() << coords.count() << ncgroups << bond_nrg << ref.bond_nrg
+                 << angle_nrg << ref.angle_nrg << dihedral_nrg << ref.dihedral_nrg
+                 << improper_nrg << ref.improper_nrg << ub_nrg << ref.ub_nrg;
+    }
+
+    assert_nearly_equal( bond_nrg, ref.bond_nrg, 1e-6*std::abs(ref.bond_nrg) + 1e-8, CODELOC );
+    assert_nearly_equal( angle_nrg, ref.angle_nrg,
+                         1e-6*std::abs(ref.angle_nrg) + 1e-8, CODELOC );
+    assert_nearly_equal( dihedral_nrg, ref.dihedral_nrg,
+                         1e-6*std::abs(ref.dihedral_nrg) + 1e-8, CODELOC );
+    assert_nearly_equal( improper_nrg, ref.improper_nrg,
+                         1e-6*std::abs(ref.improper_nrg) + 1e-8, CODELOC );
+    assert_nearly_equal( ub_nrg, ref.ub_nrg, 1e-6*std::abs(ref.ub_nrg) + 1e-8, CODELOC );
+
+    assert_same_forces( getForces(ff, mol, ff.components().bond()),
+                        ref.bond_forces, CODELOC );
+    assert_same_forces( getForces(ff, mol, ff.components().angle()),
+                        ref.angle_forces, CODELOC );
+    assert_same_forces( getForces(ff, mol, ff.components().dihedral()),
+                        ref.dihedral_forces, CODELOC );
+}
+
+void test_internalff(bool verbose)
+{
+    //make sure that the chains exercise both the packed and the generic buckets
+    const QList<Symbol> r_input = QList<Symbol>() << InternalPotential::symbols().bond().r();
+    const QList<Symbol> theta_input = QList<Symbol>()
+                                        << InternalPotential::symbols().angle().theta();
+    const QList<Symbol> phi_input = QList<Symbol>()
+                                        << InternalPotential::symbols().dihedral().phi();
+
+    assert_equal( int(CompiledExpression(bondPotential(0), r_input).kernel()),
+                  int(CompiledExpression::HARMONIC), CODELOC );
+    assert_not_equal( int(CompiledExpression(bondPotential(1), r_input).kernel()),
+                      int(CompiledExpression::HARMONIC), CODELOC );
+    assert_equal( int(CompiledExpression(anglePotential(0), theta_input).kernel()),
+                  int(CompiledExpression::HARMONIC), CODELOC );
+    assert_not_equal( int(CompiledExpression(anglePotential(1), theta_input).kernel()),
+                      int(CompiledExpression::HARMONIC), CODELOC );
+    assert_equal( int(CompiledExpression(dihedralPotential(0), phi_input).kernel()),
+                  int(CompiledExpression::FOURIER), CODELOC );
+    assert_not_equal( int(CompiledExpression(dihedralPotential(2), phi_input).kernel()),
+                      int(CompiledExpression::FOURIER), CODELOC );
+
+    RanGenerator rand(8231);
+
+    //chains of different lengths, so that the number of terms in each
+    //bucket is not (always) a multiple of MultiDouble::count()
+    for (int natoms=4; natoms <= 3*MultiDouble::count() + 5; natoms += 3)
+    {
+        QVector<Vector> coords(natoms);
+
+        for (int i=1; i<natoms; ++i)
+        {
+            coords[i] = coords[i-1] + rand.vectorOnSphere( rand.rand(1.2, 1.7) );
+        }
+
+        test_chain(coords, 1, verbose);
+        test_chain(coords, 3, verbose);
+    }
+
+    //a chain with overlapping atoms, giving zero-length harmonic (2-3)
+    //and generic (5-6) bonds, and so angles and dihedrals with zero-length bonds
+    QVector<Vector> coords(10);
+
+    for (int i=1; i<10; ++i)
+    {
+        coords[i] = coords[i-1] + rand.vectorOnSphere(1.5);
+    }
+
+    coords[3] = coords[2];
+    coords[6] = coords[5];
+
+    test_chain(coords, 1, verbose);
+    test_chain(coords, 2, verbose);
+
+    //a chain whose atoms lie on a line, so the angles are 180 degrees
+    //and the dihedrals are undefined
+    for (int i=0; i<10; ++i)
+    {
+        coords[i] = Vector(1.5*i, 0, 0);
+    }
+
+    test_chain(coords, 1, verbose);
+}
+
+SIRE_UNITTEST( test_internalff )
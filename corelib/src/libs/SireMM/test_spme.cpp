@@ -0,0 +1,278 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "SireMM/cljspmefunction.h"
+#include "SireMM/cljewald.h"
+#include "SireMM/cljatoms.h"
+#include "SireMM/detail/spmefft.h"
+
+#include "SireVol/periodicbox.h"
+
+#include "SireMaths/multifloat.h"
+#include "SireMaths/multiint.h"
+#include "SireMaths/rangenerator.h"
+#include "SireMaths/constants.h"
+
+#include "SireUnits/units.h"
+
+#include "SireBase/unittest.h"
+
+#include <QDebug>
+
+#include <complex>
+#include <cmath>
+
+using namespace SireMM;
+using namespace SireMM::detail;
+using namespace SireMaths;
+using namespace SireVol;
+using namespace SireUnits;
+using namespace SireUnits::Dimension;
+using namespace SireBase;
+
+/** Return the Ewald energy of the passed atoms calculated by direct
+    summation in double precision, using the same charges, IDs and
+    Ewald parameters as used by 'func' */
+static double directEwaldEnergy(const CLJAtoms &atoms, const CLJSPMEFunction &func,
+                                double box, int kmax)
+{
+    //unpack the atoms that are not dummies
+    QVector<double> x, y, z, q;
+    QVector<qint32> ids;
+
+    const qint32 dummy_int = CLJAtoms::idOfDummy()[0];
+
+    for (int i=0; i<atoms.x().count(); ++i)
+    {
+        for (int ii=0; ii<MultiFloat::count(); ++ii)
+        {
+            if (atoms.ID()[i][ii] != dummy_int)
+            {
+                x.append( atoms.x()[i][ii] );
+                y.append( atoms.y()[i][ii] );
+                z.append( atoms.z()[i][ii] );
+                q.append( atoms.q()[i][ii] );
+                ids.append( atoms.ID()[i][ii] );
+            }
+        }
+    }
+
+    const int n = x.count();
+    const double beta = func.beta();
+    const double cutoff = func.coulombCutoff();
+    const double volume = box*box*box;
+
+    double real_nrg = 0;
+    double excl_nrg = 0;
+    double self_nrg = 0;
+
+    for (int i=0; i<n; ++i)
+    {
+        self_nrg -= beta * q[i] * q[i] / std::sqrt(SireMaths::pi);
+
+        for (int j=i+1; j<n; ++j)
+        {
+            double dx = x[j] - x[i];
+            double dy = y[j] - y[i];
+            double dz = z[j] - z[i];
+
+            dx -= box * std::floor( dx/box + 0.5 );
+            dy -= box * std::floor( dy/box + 0.5 );
+            dz -= box * std::floor( dz/box + 0.5 );
+
+            const double r = std::sqrt(dx*dx + dy*dy + dz*dz);
+
+            if (ids[i] == ids[j])
+                excl_nrg -= q[i] * q[j] * std::erf(beta*r) / r;
+            else if (r < cutoff)
+                real_nrg += q[i] * q[j] * std::erfc(beta*r) / r;
+        }
+    }
+
+    double recip_nrg = 0;
+
+    for (int kx=-kmax; kx<=kmax; ++kx)
+    {
+        for (int ky=-kmax; ky<=kmax; ++ky)
+        {
+            for (int kz=-kmax; kz<=kmax; ++kz)
+            {
+                if (kx == 0 and ky == 0 and kz == 0)
+                    continue;
+
+                const double m2 = (kx*kx + ky*ky + kz*kz) / (box*box);
+
+                std::complex<double> s(0,0);
+
+                for (int i=0; i<n; ++i)
+                {
+                    const double arg = 2.0 * SireMaths::pi * (kx*x[i] + ky*y[i] + kz*z[i]) / box;
+                    s += q[i] * std::complex<double>( std::cos(arg), std::sin(arg) );
+                }
+
+                recip_nrg += std::exp( -SireMaths::pi * SireMaths::pi * m2 / (beta*beta) )
+                                / m2 * std::norm(s);
+            }
+        }
+    }
+
+    recip_nrg /= (2.0 * SireMaths::pi * volume);
+
+    return real_nrg + recip_nrg + self_nrg + excl_nrg;
+}
+
+void test_spme(bool verbose)
+{
+    RanGenerator rand(42);
+
+    //test the 3D FFT against a naive discrete Fourier transform, using
+    //mesh sizes that exercise the radix 2, 3 and 5 and the prime passes
+    const int dims[5][3] = { {6,10,15}, {7,5,11}, {8,8,8}, {1,4,9}, {13,2,3} };
+
+    for (int d=0; d<5; ++d)
+    {
+        const int nx = dims[d][0];
+        const int ny = dims[d][1];
+        const int nz = dims[d][2];
+
+        QVector<SPMEComplex> values(nx*ny*nz);
+
+        for (int i=0; i<values.count(); ++i)
+        {
+            values[i] = SPMEComplex( rand.rand(-1,1), rand.rand(-1,1) );
+        }
+
+        QVector<SPMEComplex> transformed = values;
+        spmeFFT3D(transformed.data(), nx, ny, nz);
+
+        for (int i=0; i<nx; ++i)
+        {
+            for (int j=0; j<ny; ++j)
+            {
+                for (int k=0; k<nz; ++k)
+                {
+                    SPMEComplex sum(0,0);
+
+                    for (int a=0; a<nx; ++a)
+                    {
+                        for (int b=0; b<ny; ++b)
+                        {
+                            for (int c=0; c<nz; ++c)
+                            {
+                                const double arg = -2.0 * SireMaths::pi *
+                                                      ( double(i*a)/nx + double(j*b)/ny +
+                                                        double(k*c)/nz );
+
+                                sum += values[(a*ny + b)*nz + c] *
+                                            SPMEComplex( std::cos(arg), std::sin(arg) );
+                            }
+                        }
+                    }
+
+                    assert_nearly_equal( std::abs(sum - transformed[(i*ny + j)*nz + k]),
+                                         0.0, 1e-9, CODELOC );
+                }
+            }
+        }
+
+        if (verbose)
+            qDebug() << "FFT" << nx << ny << nz << "agrees with the naive DFT";
+    }
+
+    //build a box of 20 neutral three-atom molecules, each with its own ID
+    const double box = 20.0;
+    const int nmols = 20;
+
+    QVector<CLJAtom> cljatoms;
+
+    for (int i=0; i<nmols; ++i)
+    {
+        const Vector center( rand.rand(0,box), rand.rand(0,box), rand.rand(0,box) );
+        const double qh = rand.rand(0.2, 0.6);
+
+        cljatoms.append( CLJAtom(center, (-2*qh)*mod_electron,
+                                 LJParameter(3.15*angstrom, 0.15*kcal_per_mol), i+1) );
+
+        cljatoms.append( CLJAtom(center + rand.vectorOnSphere(1.0), qh*mod_electron,
+                                 LJParameter::dummy(), i+1) );
+
+        cljatoms.append( CLJAtom(center + rand.vectorOnSphere(1.0), qh*mod_electron,
+                                 LJParameter::dummy(), i+1) );
+    }
+
+    const CLJAtoms atoms(cljatoms);
+
+    const CLJSPMEFunction func( PeriodicBox(Vector(box)), 9*angstrom );
+
+    //compare the SPME energy against a direct Ewald sum
+    const double spme_nrg = func.coulomb(atoms) + func.longRangeEnergy(atoms);
+    const double direct_nrg = directEwaldEnergy(atoms, func, box, 14);
+
+    if (verbose)
+        qDebug() << "SPME" << spme_nrg << "direct Ewald" << direct_nrg;
+
+    assert_nearly_equal( spme_nrg, direct_nrg, 1e-3 * std::abs(direct_nrg) + 1e-3, CODELOC );
+
+    //compare the long-range energy against the explicit Ewald sum in CLJEwald
+    const double ewald_nrg = CLJEwald(func, atoms).energy();
+    const double long_nrg = func.longRangeEnergy(atoms);
+
+    if (verbose)
+        qDebug() << "SPME long range" << long_nrg << "CLJEwald" << ewald_nrg;
+
+    assert_nearly_equal( long_nrg, ewald_nrg, 1e-3 * std::abs(ewald_nrg) + 1e-3, CODELOC );
+
+    //move a single atom of one molecule, and check that the incrementally
+    //updated mesh matches a mesh built from scratch
+    CLJSPMEMesh mesh(func, atoms);
+
+    QVector<CLJAtom> moved_atoms = cljatoms;
+    const int moved = 3*5 + 1;
+
+    moved_atoms[moved] = CLJAtom( cljatoms[moved].coordinates() + Vector(0.3, -0.2, 0.4),
+                                  cljatoms[moved].charge(), cljatoms[moved].ljParameter(),
+                                  cljatoms[moved].ID() );
+
+    const double delta = mesh.calculateDelta( CLJAtoms(cljatoms[moved]),
+                                              CLJAtoms(moved_atoms[moved]) );
+
+    assert_true( mesh.needsAccepting(), CODELOC );
+
+    const double old_nrg = mesh.energy();
+    mesh.accept();
+
+    const CLJSPMEMesh new_mesh(func, CLJAtoms(moved_atoms));
+
+    if (verbose)
+        qDebug() << "Incremental" << mesh.energy() << "from scratch" << new_mesh.energy();
+
+    assert_nearly_equal( old_nrg + delta, mesh.energy(), 1e-9, CODELOC );
+    assert_nearly_equal( mesh.energy(), new_mesh.energy(), 1e-6, CODELOC );
+}
+
+SIRE_UNITTEST( test_spme )
@@ -1077,6 +1077,295 @@ QVector<int> SIREMATHS_EXPORT brute_force_linear_assignment(const NMatrix &costs
     return min_rows_to_columns;
 }
 
+namespace detail
+{
+
+/** Internal function used to run the auction algorithm at a single
+    value of epsilon. This starts from the passed assignment and prices,
+    and returns false if a complete assignment could not be found
+    within 'max_bids' bids, or if a price rose above 'price_limit' 
+    (meaning that there is no complete assignment using only the
+    candidate columns) */
+static bool runAuction( const QVector< QVector<int> > &columns,
+                        const QVector< QVector<double> > &costs,
+                        QVector<int> &rows_to_columns,
+                        QVector<int> &columns_to_rows,
+                        QVector<double> &prices,
+                        double eps, double range, double price_limit,
+                        qint64 max_bids )
+{
+    const int n = columns.count();
+
+    int *rows_to_columns_array = rows_to_columns.data();
+    int *columns_to_rows_array = columns_to_rows.data();
+    double *prices_array = prices.data();
+
+    QVector<int> unassigned;
+    unassigned.reserve(n);
+    
+    for (int i=0; i<n; ++i)
+    {
+        if (rows_to_columns_array[i] == -1)
+            unassigned.append(i);
+    }
+    
+    qint64 nbids = 0;
+    
+    while (not unassigned.isEmpty())
+    {
+        const int i = unassigned.last();
+        unassigned.removeLast();
+        
+        const int ncols = columns.at(i).count();
+        const int *cols = columns.at(i).constData();
+        const double *c = costs.at(i).constData();
+        
+        //find the best and second best columns for this row
+        int best_j = -1;
+        double best = std::numeric_limits<double>::max();
+        double second = std::numeric_limits<double>::max();
+        
+        for (int k=0; k<ncols; ++k)
+        {
+            const double val = c[k] + prices_array[cols[k]];
+            
+            if (val < best)
+            {
+                second = best;
+                best = val;
+                best_j = cols[k];
+            }
+            else if (val < second)
+            {
+                second = val;
+            }
+        }
+        
+        //bid for the best column, raising its price so that this row
+        //is only just happier with it than with its second best choice
+        if (ncols == 1)
+            prices_array[best_j] += range + eps;
+        else
+            prices_array[best_j] += (second - best) + eps;
+
+        if (prices_array[best_j] > price_limit)
+            return false;
+        
+        const int old_i = columns_to_rows_array[best_j];
+        
+        if (old_i != -1)
+        {
+            rows_to_columns_array[old_i] = -1;
+            unassigned.append(old_i);
+        }
+        
+        columns_to_rows_array[best_j] = i;
+        rows_to_columns_array[i] = best_j;
+        
+        nbids += 1;
+        
+        if (nbids > max_bids)
+            return false;
+    }
+    
+    return true;
+}
+
+} // end of namespace detail
+
+/** Solve the sparse linear assignment problem, in which each row can
+    only be assigned to a set of candidate columns. 'columns' contains
+    the indicies of the candidate columns for each row, and 'costs' 
+    contains the costs of assigning each row to each of those columns
+    (so costs[i][k] is the cost of assigning row i to column columns[i][k]).
+    There must be the same number of rows and columns.
+    
+    The solution can be warm-started from the solution of a similar problem
+    (e.g. the same problem after a few rows have changed). On entry,
+    'rows_to_columns' contains the initial assignment of each row (or -1
+    for unassigned rows - any rows whose costs have changed should be
+    unassigned), and 'prices' contains the price of each column from the
+    previous solution. Both are reset if they are the wrong size. On exit,
+    these contain the new assignment and prices, which can be used to 
+    warm-start the next solution.
+    
+    This uses the forward auction algorithm, with epsilon scaling, from;
+    
+    "The auction algorithm: A distributed relaxation method for the 
+     assignment problem", D. P. Bertsekas, Annals of Operations
+     Research, 14, 105-123, 1988
+     
+    The total cost of the assignment is within n * epsilon of the optimum
+    (using only the candidate columns). The caller can check whether a
+    non-candidate column would lower the cost of row i by checking if 
+    cost(i,j) + prices[j] is less than the value for the assigned column
+    by more than epsilon.
+    
+    This returns whether or not a complete assignment was found. If not,
+    then there is (probably) no complete assignment that uses only 
+    the candidate columns
+*/
+bool SIREMATHS_EXPORT solve_sparse_linear_assignment( 
+                                        const QVector< QVector<int> > &columns,
+                                        const QVector< QVector<double> > &costs,
+                                        QVector<int> &rows_to_columns,
+                                        QVector<double> &prices,
+                                        double epsilon )
+{
+    const int n = columns.count();
+    
+    if (costs.count() != n)
+        throw SireError::invalid_arg( QObject::tr(
+                "The number of rows of costs (%1) is not equal to the number "
+                "of rows of columns (%2).").arg(costs.count()).arg(n), CODELOC );
+    
+    if (n == 0)
+    {
+        rows_to_columns = QVector<int>();
+        prices = QVector<double>();
+        return true;
+    }
+    
+    //check the candidates and find the range of the costs
+    double mincost = std::numeric_limits<double>::max();
+    double maxcost = -std::numeric_limits<double>::max();
+    qint64 ncandidates = 0;
+    
+    for (int i=0; i<n; ++i)
+    {
+        const QVector<int> &cols = columns.at(i);
+        const QVector<double> &c = costs.at(i);
+        
+        if (cols.count() != c.count())
+            throw SireError::invalid_arg( QObject::tr(
+                    "The number of candidate columns for row %1 (%2) is not equal "
+                    "to the number of costs (%3).")
+                        .arg(i).arg(cols.count()).arg(c.count()), CODELOC );
+    
+        if (cols.isEmpty())
+            //this row cannot be assigned
+            return false;
+        
+        for (int k=0; k<cols.count(); ++k)
+        {
+            if (cols.at(k) < 0 or cols.at(k) >= n)
+                throw SireError::invalid_arg( QObject::tr(
+                        "Invalid candidate column %1 for row %2. The number of "
+                        "columns is %3.").arg(cols.at(k)).arg(i).arg(n), CODELOC );
+        
+            mincost = qMin(mincost, c.at(k));
+            maxcost = qMax(maxcost, c.at(k));
+        }
+        
+        ncandidates += cols.count();
+    }
+    
+    const double range = maxcost - mincost;
+    
+    if (epsilon <= 0)
+        epsilon = 1.0e-9 * qMax(range, 1.0) / n;
+    
+    if (prices.count() != n)
+        prices = QVector<double>(n, 0.0);
+        
+    if (rows_to_columns.count() != n)
+        rows_to_columns = QVector<int>(n, -1);
+    
+    //build the column to row mapping from the initial assignment, 
+    //unassigning any rows that conflict
+    QVector<int> columns_to_rows(n, -1);
+    int nassigned = 0;
+    
+    for (int i=0; i<n; ++i)
+    {
+        const int j = rows_to_columns.at(i);
+        
+        if (j < 0 or j >= n or columns_to_rows.at(j) != -1)
+        {
+            rows_to_columns[i] = -1;
+        }
+        else
+        {
+            columns_to_rows[j] = i;
+            nassigned += 1;
+        }
+    }
+    
+    double max_price = prices.at(0);
+    
+    for (int j=1; j<n; ++j)
+    {
+        max_price = qMax(max_price, prices.at(j));
+    }
+    
+    //the prices of a feasible problem are bounded - if a price rises
+    //above this limit then there is no complete assignment
+    const double price_limit = max_price + 2*(n+1)*(range + qMax(epsilon, range/4));
+    
+    //limit on the number of bids in each auction - this stops price
+    //wars from taking too long - if this is hit then we fall back to
+    //epsilon scaling
+    const qint64 max_bids = 64 * (ncandidates + n);
+    
+    if (nassigned > 0)
+    {
+        //warm start - try to complete the assignment using the final
+        //value of epsilon, which only needs to reassign the unassigned rows
+        if (detail::runAuction(columns, costs, rows_to_columns, columns_to_rows,
+                               prices, epsilon, range, price_limit, max_bids))
+        {
+            return true;
+        }
+        
+        //this didn't work, so start again using epsilon scaling (keeping
+        //the current prices, as these are still a good starting point)
+        rows_to_columns.fill(-1);
+        columns_to_rows.fill(-1);
+    }
+    
+    double eps = qMax(epsilon, range / 4);
+    
+    while (true)
+    {
+        if (not detail::runAuction(columns, costs, rows_to_columns, columns_to_rows,
+                                   prices, eps, range, price_limit, max_bids))
+        {
+            return false;
+        }
+        
+        if (eps <= epsilon)
+            break;
+        
+        //reduce epsilon and reassign all of the rows, keeping the prices
+        eps = qMax(epsilon, eps / 5);
+        rows_to_columns.fill(-1);
+        columns_to_rows.fill(-1);
+    }
+    
+    return true;
+}
+
+/** Solve the sparse linear assignment problem from scratch, returning
+    the column assigned to each row. This returns an empty vector if 
+    there is no complete assignment that uses only the candidate columns.
+    See the warm-startable version of this function for details */
+QVector<int> SIREMATHS_EXPORT solve_sparse_linear_assignment( 
+                                        const QVector< QVector<int> > &columns,
+                                        const QVector< QVector<double> > &costs,
+                                        double epsilon )
+{
+    QVector<int> rows_to_columns;
+    QVector<double> prices;
+    
+    if (solve_sparse_linear_assignment(columns, costs, rows_to_columns, 
+                                       prices, epsilon))
+    {
+        return rows_to_columns;
+    }
+    else
+        return QVector<int>();
+}
+
 /** Return the minimum possible total cost from the linear assignment 
     costs matrix 'costs' */
 double SIREMATHS_EXPORT get_lowest_total_cost( const NMatrix &costs )
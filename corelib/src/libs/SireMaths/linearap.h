@@ -45,6 +45,16 @@ QVector<int> solve_linear_assignment( const NMatrix &costs,
 
 QVector<int> brute_force_linear_assignment( const NMatrix &costs );
 
+bool solve_sparse_linear_assignment( const QVector< QVector<int> > &columns,
+                                     const QVector< QVector<double> > &costs,
+                                     QVector<int> &rows_to_columns,
+                                     QVector<double> &prices,
+                                     double epsilon = 0 );
+
+QVector<int> solve_sparse_linear_assignment( const QVector< QVector<int> > &columns,
+                                             const QVector< QVector<double> > &costs,
+                                             double epsilon = 0 );
+
 double calculate_total_cost( const NMatrix &costs,
                              const QVector<int> &rows_to_columns );
 
@@ -58,6 +68,7 @@ SIRE_EXPOSE_FUNCTION( SireMaths::calculate_total_cost )
 SIRE_EXPOSE_FUNCTION( SireMaths::get_lowest_total_cost )
 
 SIRE_EXPOSE_FUNCTION( SireMaths::brute_force_linear_assignment )
+SIRE_EXPOSE_FUNCTION( SireMaths::solve_sparse_linear_assignment )
 
 SIRE_END_HEADER
 
@@ -29,6 +29,8 @@
 #include <QMutex>
 #include <QVector>
 #include <QUuid>
+#include <QThreadStorage>
+#include <QAtomicInt>
 
 #include <QDebug>
 
@@ -39,6 +41,7 @@
 
 #include "rangenerator.h"
 #include "vector.h"
+#include "constants.h"
 
 #include "ThirdParty/MersenneTwister.h"       // CONDITIONAL_INCLUDE
 
@@ -86,16 +89,22 @@ typedef MTRand::uint32 MTUInt32;
 
 public:
     /** Construct a generator with a random seed */
-    RanGeneratorPvt() : mutex(QMutex::NonRecursive)
-    {}
+    RanGeneratorPvt() : mutex(QMutex::NonRecursive), thread_safe(true)
+    {
+        //the generator has been randomly seeded - use it to choose
+        //a seed that can be recorded
+        this->_pvt_randomSeed();
+    }
 
     /** Construct a generator with a specified seed */
     RanGeneratorPvt(quint32 seed) : mutex(QMutex::NonRecursive),
-                                    mersenne_generator(seed)
+                                    mersenne_generator(seed),
+                                    seed_array(1, seed), thread_safe(true)
     {}
 
     /** Construct a generator with a specified seed */
-    RanGeneratorPvt(const QVector<quint32> &s) : mutex(QMutex::NonRecursive)
+    RanGeneratorPvt(const QVector<quint32> &s) : mutex(QMutex::NonRecursive),
+                                                 thread_safe(true)
     {
         this->seed(s);
     }
@@ -106,6 +115,8 @@ public:
         QMutexLocker lkr( const_cast<QMutex*>( &(other.mutex) ) );
         
         mersenne_generator = other.mersenne_generator;
+        seed_array = other.seed_array;
+        thread_safe = other.thread_safe;
     }
 
     /** Destructor */
@@ -118,12 +129,61 @@ public:
     /** The actual generator (Mersenne Twister) */
     MTRand mersenne_generator;
 
+    /** The seed used to seed the generator - this is used to
+        seed the generator's substreams */
+    QVector<quint32> seed_array;
+
+    /** Whether or not access to the generator must be serialised.
+        This is false for substreams, which must only be used by 
+        one thread at a time */
+    bool thread_safe;
+
+    /** Return the mutex to lock to use the generator, or 0 if
+        the generator does not need to be locked */
+    QMutex* locker()
+    {
+        if (thread_safe)
+            return &mutex;
+        else
+            return 0;
+    }
+
+    /** Reseed the generator using a random seed chosen from
+        the generator itself. The lock must be held */
+    void _pvt_randomSeed()
+    {
+        QVector<quint32> s(4);
+
+        for (int i=0; i<4; ++i)
+        {
+            s[i] = mersenne_generator.randInt();
+        }
+
+        this->_pvt_seed(s);
+    }
+
+    /** Reseed the generator from an array of uints. The lock must be held */
+    void _pvt_seed(const QVector<quint32> &s)
+    {
+        //we need to convert this into an array of MTRand::uint32
+        int sz = s.count();
+
+        boost::scoped_array<MTUInt32> array( new MTUInt32[sz] );
+
+        for (int i=0; i<sz; ++i)
+            array[i] = s.constData()[i];
+
+        mersenne_generator.seed( array.get(),  sz );
+        seed_array = s;
+    }
+
     /** Randomly seed the generator */
     void seed()
     {
         QMutexLocker lkr(&mutex);
 
         mersenne_generator.seed();
+        this->_pvt_randomSeed();
     }
 
     /** Reseed the generator from an array of uints */
@@ -137,15 +197,7 @@ public:
 
         QMutexLocker lkr(&mutex);
 
-        //we need to convert this into an array of MTRand::uint32
-        int sz = s.count();
-
-        boost::scoped_array<MTUInt32> array( new MTUInt32[sz] );
-
-        for (int i=0; i<sz; ++i)
-            array[i] = s.constData()[i];
-
-        mersenne_generator.seed( array.get(),  sz );
+        this->_pvt_seed(s);
     }
 
     /** Reseed the generator */
@@ -154,6 +206,14 @@ public:
         QMutexLocker lkr(&mutex);
 
         mersenne_generator.seed(s);
+        seed_array = QVector<quint32>(1, s);
+    }
+
+    /** Return the seed used to seed this generator */
+    QVector<quint32> getSeed()
+    {
+        QMutexLocker lkr(&mutex);
+        return seed_array;
     }
 
     /** Return an array containing the state of the random generator */
@@ -207,6 +267,10 @@ public:
         QMutexLocker lkr(&mutex);
 
         mersenne_generator.load(array.get());
+        
+        //we don't know the seed for this state, so use the start
+        //of the state to seed any substreams
+        seed_array = state.mid(0, 4);
     }
 };
 
@@ -245,10 +309,12 @@ static const RegisterMetaType<RanGenerator> r_rangen(NO_ROOT);
 /** Serialise to a binary data stream */
 QDataStream SIREMATHS_EXPORT &operator<<(QDataStream &ds, const RanGenerator &rangen)
 {
-    writeHeader(ds, r_rangen, 1);
+    writeHeader(ds, r_rangen, 2);
 
     SharedDataStream sds(ds);
     sds << rangen.d;
+    
+    ds << rangen.nonconst_d().getSeed() << rangen.isThreadSafe();
 
     return ds;
 }
@@ -258,7 +324,23 @@ QDataStream SIREMATHS_EXPORT &operator>>(QDataStream &ds, RanGenerator &rangen)
 {
     VersionID v = readHeader(ds, r_rangen);
 
-    if (v == 1)
+    if (v == 2)
+    {
+        //I need to detach from shared storage
+        rangen.d.reset(new RanGeneratorPvt());
+    
+        SharedDataStream sds(ds);
+        sds >> rangen.d;
+        
+        QVector<quint32> seed;
+        bool thread_safe;
+        
+        ds >> seed >> thread_safe;
+        
+        rangen.d->seed_array = seed;
+        rangen.d->thread_safe = thread_safe;
+    }
+    else if (v == 1)
     {
         //I need to detach from shared storage
         rangen.d.reset(new RanGeneratorPvt());
@@ -267,7 +349,7 @@ QDataStream SIREMATHS_EXPORT &operator>>(QDataStream &ds, RanGenerator &rangen)
         sds >> rangen.d;
     }
     else
-        throw version_error(v, "1", r_rangen, CODELOC);
+        throw version_error(v, "1,2", r_rangen, CODELOC);
 
     return ds;
 }
@@ -320,11 +402,28 @@ RanGenerator::RanGenerator(const QVector<quint32> &seed)
              : d( new RanGeneratorPvt(seed) )
 {}
 
+/** Internal function used to return the storage for a copy of the
+    generator 'd'. Thread-safe generators are explicitly shared (this
+    is to prevent repeat random numbers from being generated by implicit
+    copies!). Substreams are not locked, so they must never be shared
+    between copies (which may be used by different threads). Instead,
+    a copy of a substream is an independent generator that starts
+    from the same state */
+static boost::shared_ptr<RanGeneratorPvt> copyOf(
+                                const boost::shared_ptr<RanGeneratorPvt> &d)
+{
+    if (d->thread_safe)
+        return d;
+    else
+        return boost::shared_ptr<RanGeneratorPvt>( new RanGeneratorPvt(*d) );
+}
+
 /** Copy constructor - this takes an explicitly shared
     copy of 'other' (this is to prevent repeat random numbers
-    from being generated by implicit copies!) */
+    from being generated by implicit copies!), unless 'other' is
+    a substream, in which case this takes an independent copy */
 RanGenerator::RanGenerator(const RanGenerator &other)
-             : d( other.d )
+             : d( copyOf(other.d) )
 {}
 
 /** Destructor */
@@ -343,7 +442,9 @@ void RanGenerator::detach()
 /** Copy assignment */
 RanGenerator& RanGenerator::operator=(const RanGenerator &other)
 {
-    d = other.d;
+    if (this != &other)
+        d = copyOf(other.d);
+
     return *this;
 }
 
@@ -401,7 +502,7 @@ void RanGenerator::seed(const QVector<quint32> &s)
     all explicit copies of one another! */
 void RanGenerator::seed(const RanGenerator &other)
 {
-    d = other.d;
+    d = copyOf(other.d);
 }
 
 /** Call this function to seed the qrand generator for this thread */
@@ -417,7 +518,7 @@ namespace SireMaths
 /** Return a random real number on [0,1] */
 double RanGenerator::rand() const
 {
-    QMutexLocker lkr( &(nonconst_d().mutex) );
+    QMutexLocker lkr( nonconst_d().locker() );
     return nonconst_d().mersenne_generator.rand();
 }
 
@@ -481,7 +582,7 @@ void RanGenerator::nrand(QVector<double> &result) const
 
     if (n > 0)
     {
-        QMutexLocker lkr( &(nonconst_d().mutex) );
+        QMutexLocker lkr( nonconst_d().locker() );
     
         double *d = result.data();
     
@@ -511,7 +612,7 @@ void RanGenerator::nrand(QVector<double> &result, double maxval) const
         }
         else
         {
-            QMutexLocker lkr( &(nonconst_d().mutex) );
+            QMutexLocker lkr( nonconst_d().locker() );
 
             for (int i=0; i<n; ++i)
             {
@@ -548,7 +649,7 @@ void RanGenerator::nrand(QVector<double> &result, double minval, double maxval)
         }
         else
         {
-            QMutexLocker lkr( &(nonconst_d().mutex) );
+            QMutexLocker lkr( nonconst_d().locker() );
 
             for (int i=0; i<n; ++i)
             {
@@ -600,7 +701,7 @@ QVector<double> RanGenerator::nrand(int n, double minval, double maxval) const
 /** Return a high-precision random real number on [0,1) */
 double RanGenerator::rand53() const
 {
-    QMutexLocker lkr( &(nonconst_d().mutex) );
+    QMutexLocker lkr( nonconst_d().locker() );
     return nonconst_d().mersenne_generator.rand53();
 }
 
@@ -620,7 +721,7 @@ double RanGenerator::rand53(double minval, double maxval) const
     with supplied mean and variance. */
 double RanGenerator::randNorm(double mean, double variance) const
 {
-    QMutexLocker lkr( &(nonconst_d().mutex) );
+    QMutexLocker lkr( nonconst_d().locker() );
     return nonconst_d().mersenne_generator.randNorm(mean, variance);
 }
 
@@ -628,8 +729,8 @@ double RanGenerator::randNorm(double mean, double variance) const
     with mean 0 and standard deviation 1 */
 double RanGenerator::randNorm() const
 {
-    QMutexLocker lkr( &(nonconst_d().mutex) );
-    return nonconst_d().mersenne_generator.randNorm(1,0);
+    QMutexLocker lkr( nonconst_d().locker() );
+    return nonconst_d().mersenne_generator.randNorm(0,1);
 }
 
 /** Return a random number from the normal distribution
@@ -645,26 +746,60 @@ double RanGenerator::locked_randNorm(double mean, double variance) const
     lock when calling this function */
 double RanGenerator::locked_randNorm() const
 {
-    return nonconst_d().mersenne_generator.randNorm(1,0);
+    return nonconst_d().mersenne_generator.randNorm(0,1);
 }
 
 /** Fill the passed array with random numbers drawn from the normal
-    distribution with supplied mean and variance */
+    distribution with supplied mean and variance. This generates all of
+    the uniform random numbers in one go (so the generator is only locked
+    once), and then converts them using the Box-Muller method, using each
+    pair of uniform numbers to give two normal numbers. The conversion
+    is a simple loop over arrays, which the compiler can vectorise */
 void RanGenerator::nrandNorm(QVector<double> &result, double mean, double variance) const
 {
     const int n = result.count();
     
-    if (n > 0)
+    if (n <= 0)
+        return;
+
+    const int npairs = (n + 1) / 2;
+    
+    QVector<double> uniform_r(npairs);
+    QVector<double> uniform_phi(npairs);
+    
+    double *r = uniform_r.data();
+    double *phi = uniform_phi.data();
+    
     {
-        double *d = result.data();
+        QMutexLocker lkr( nonconst_d().locker() );
         
-        QMutexLocker lkr( &(nonconst_d().mutex) );
+        MTRand &generator = nonconst_d().mersenne_generator;
         
-        for (int i=0; i<n; ++i)
+        for (int i=0; i<npairs; ++i)
         {
-            d[i] = nonconst_d().mersenne_generator.randNorm(mean, variance);
+            r[i] = 1.0 - generator.randDblExc();
+            phi[i] = generator.randExc();
         }
     }
+    
+    for (int i=0; i<npairs; ++i)
+    {
+        r[i] = variance * std::sqrt( -2.0 * std::log(r[i]) );
+        phi[i] *= SireMaths::two_pi;
+    }
+    
+    double *d = result.data();
+    
+    for (int i=0; i<n/2; ++i)
+    {
+        d[2*i] = mean + r[i] * std::cos(phi[i]);
+        d[2*i+1] = mean + r[i] * std::sin(phi[i]);
+    }
+    
+    if (n % 2 == 1)
+    {
+        d[n-1] = mean + r[npairs-1] * std::cos(phi[npairs-1]);
+    }
 }
 
 /** Return an array of 'N' random numbers drawn from the normal distribution with
@@ -706,38 +841,14 @@ Vector RanGenerator::locked_vectorOnSphere() const
 /** Return a random vector on the unit sphere */
 Vector RanGenerator::vectorOnSphere() const
 {
-    QMutexLocker lkr( &(nonconst_d().mutex) );
+    QMutexLocker lkr( nonconst_d().locker() );
     return locked_vectorOnSphere();
 }
 
 /** Fill the passed array with random vectors on a unit sphere */
 void RanGenerator::nvectorOnSphere(QVector<Vector> &result) const
 {
-    const int n = result.count();
-    
-    if (n > 0)
-    {
-        QMutexLocker lkr( &(nonconst_d().mutex) );
-        
-        int i=0;
-        
-        while (i < n)
-        {
-            Vector &v = result[i];
-            
-            v.setX( 1.0 - 2.0 * nonconst_d().mersenne_generator.rand() );
-            v.setY( 1.0 - 2.0 * nonconst_d().mersenne_generator.rand() );
-            v.setZ( 1.0 - 2.0 * nonconst_d().mersenne_generator.rand() );
-            
-            const double lgth2 = v.length2();
-            
-            if (lgth2 < 1)
-            {
-                v /= std::sqrt(lgth2);
-                i += 1;
-            }
-        }
-    }
+    this->nvectorOnSphere(result, 1.0);
 }
 
 /** Return an array of 'n' random vectors on a unit sphere */
@@ -766,34 +877,48 @@ Vector RanGenerator::locked_vectorOnSphere(double radius) const
     return radius * this->locked_vectorOnSphere();
 }
 
-/** Fill the passed array with random vectors on a sphere with radius 'radius' */
+/** Fill the passed array with random vectors on a sphere with radius 'radius'.
+    This generates all of the uniform random numbers in one go (so the
+    generator is only locked once), and then converts them using
+    Archimedes' projection (the height is uniform on [-radius,radius] and
+    the angle is uniform on [0,2pi)). Unlike rejection sampling, this uses
+    exactly two random numbers per vector, and the conversion is a simple
+    loop over arrays, which the compiler can vectorise */
 void RanGenerator::nvectorOnSphere(QVector<Vector> &result, double radius) const
 {
     const int n = result.count();
     
-    if (n > 0)
+    if (n <= 0)
+        return;
+
+    QVector<double> uniform_z(n);
+    QVector<double> uniform_phi(n);
+    
+    double *z = uniform_z.data();
+    double *phi = uniform_phi.data();
+    
     {
-        QMutexLocker lkr( &(nonconst_d().mutex) );
+        QMutexLocker lkr( nonconst_d().locker() );
         
-        int i=0;
+        MTRand &generator = nonconst_d().mersenne_generator;
         
-        while (i < n)
+        for (int i=0; i<n; ++i)
         {
-            Vector &v = result[i];
-            
-            v.setX( 1.0 - 2.0 * nonconst_d().mersenne_generator.rand() );
-            v.setY( 1.0 - 2.0 * nonconst_d().mersenne_generator.rand() );
-            v.setZ( 1.0 - 2.0 * nonconst_d().mersenne_generator.rand() );
-            
-            const double lgth2 = v.length2();
-            
-            if (lgth2 < 1)
-            {
-                v *= (radius * std::sqrt(lgth2));
-                i += 1;
-            }
+            z[i] = generator.rand();
+            phi[i] = generator.randExc();
         }
     }
+    
+    Vector *v = result.data();
+    
+    for (int i=0; i<n; ++i)
+    {
+        const double h = 1.0 - 2.0*z[i];
+        const double r = radius * std::sqrt( qMax(0.0, 1.0 - h*h) );
+        const double angle = SireMaths::two_pi * phi[i];
+        
+        v[i] = Vector( r * std::cos(angle), r * std::sin(angle), radius * h );
+    }
 }
 
 /** Return an array of 'n' random vectors on a sphere of radius 'radius' */
@@ -812,7 +937,7 @@ QVector<Vector> RanGenerator::nvectorOnSphere(int n, double radius) const
 /** Return a random 32bit unsigned integer in [0,2^32 - 1] */
 quint32 RanGenerator::randInt() const
 {
-    QMutexLocker lkr( &(nonconst_d().mutex) );
+    QMutexLocker lkr( nonconst_d().locker() );
     return nonconst_d().mersenne_generator.randInt();
 }
 
@@ -825,7 +950,7 @@ bool RanGenerator::randBool() const
 /** Return a random 32bit unsigned integer in [0,maxval] */
 quint32 RanGenerator::randInt(quint32 maxval) const
 {
-    QMutexLocker lkr( &(nonconst_d().mutex) );
+    QMutexLocker lkr( nonconst_d().locker() );
     return nonconst_d().mersenne_generator.randInt(maxval);
 }
 
@@ -851,14 +976,14 @@ static quint64 randInt64(MTRand &mersenne_generator)
 /** Return a random 64bit unsigned integer on [0,2^64 - 1] */
 quint64 RanGenerator::randInt64() const
 {
-    QMutexLocker lkr( &(nonconst_d().mutex) );
+    QMutexLocker lkr( nonconst_d().locker() );
     return ::randInt64(nonconst_d().mersenne_generator);
 }
 
 /** Return a random 64bit unsigned integer on [0,maxval] */
 quint64 RanGenerator::randInt64(quint64 maxval) const
 {
-    QMutexLocker lkr( &(nonconst_d().mutex) );
+    QMutexLocker lkr( nonconst_d().locker() );
 
     if (maxval <= std::numeric_limits<quint32>::max())
         //maxval can fit into a 32bit int - there is no
@@ -924,6 +1049,80 @@ void RanGenerator::setState(const QVector<quint32> &state)
     }
 }
 
+/** Return whether or not this generator is thread-safe (i.e. it
+    can be used simultaneously by several threads). All generators
+    are thread-safe except for substreams */
+bool RanGenerator::isThreadSafe() const
+{
+    return d->thread_safe;
+}
+
+/** Return the seed used to seed this generator. Note that a generator
+    whose state was loaded via setState will use the start of that
+    state as its seed */
+QVector<quint32> RanGenerator::getSeed() const
+{
+    return nonconst_d().getSeed();
+}
+
+/** Return a new generator for the substream with index 'index'. 
+    Each substream is seeded from the seed of this generator 
+    combined with 'index', so the substreams are independent of
+    one another and of this generator, and are reproducible 
+    (the same seed and index always give the same stream). This
+    is used to give each thread or replica its own generator.
+    
+    Substreams are not thread-safe, i.e. they do not lock on
+    each random number, so must only be used by one thread at a time.
+    For this reason, copies of a substream are not shared - each copy
+    is an independent generator that starts from the state of the
+    substream when it was copied
+*/
+RanGenerator RanGenerator::substream(quint32 index) const
+{
+    QVector<quint32> seed = this->getSeed();
+    
+    //add a marker so that the substream seed can't
+    //equal a seed that was passed by the user
+    seed.append( 0x9e3779b9 );
+    seed.append( index );
+    
+    RanGenerator rangen(seed);
+    rangen.d->thread_safe = false;
+    
+    return rangen;
+}
+
+Q_GLOBAL_STATIC( QThreadStorage<RanGenerator*>, threadGenerators );
+
+/** The number of thread-local generators that have been created */
+static QAtomicInt nthread_generators(0);
+
+/** Return the generator for the calling thread. This is a substream
+    of the global generator that is created the first time this
+    function is called in each thread. As it is only used by this 
+    thread, it does not need to be locked, and so there is no 
+    contention between threads. Note that the substream given to 
+    each thread depends on the order in which the threads first
+    call this function, so use RanGenerator::substream if you 
+    need reproducible streams. The returned generator must not be
+    passed to another thread (a copy can be passed, but will repeat
+    the random numbers of this thread's generator) */
+const RanGenerator& RanGenerator::threadLocal()
+{
+    QThreadStorage<RanGenerator*> *generators = threadGenerators();
+    
+    if (not generators->hasLocalData())
+    {
+        int index = nthread_generators.fetchAndAddOrdered(1);
+        
+        generators->setLocalData( new RanGenerator(
+                                    RanGenerator::global().substream(index) ) );
+    }
+    
+    return *(generators->localData());
+}
+
 Q_GLOBAL_STATIC( RanGenerator, globalGenerator );
 
 /** Return a reference to the global random number generator 
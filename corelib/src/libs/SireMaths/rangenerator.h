@@ -153,10 +153,17 @@ public:
     QVector<quint32> getState() const;
     void setState(const QVector<quint32> &state);
     
+    QVector<quint32> getSeed() const;
+    
+    RanGenerator substream(quint32 index) const;
+    
+    bool isThreadSafe() const;
+    
     void lock() const;
     void unlock() const;
     
     static const RanGenerator& global();
+    static const RanGenerator& threadLocal();
     
     static void seedGlobal();
     static void seedGlobal(quint32 seed);
@@ -0,0 +1,635 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "streamingfreeenergyaverage.h"
+
+#include "SireUnits/units.h"
+
+#include "SireMaths/maths.h"
+
+#include "SireError/errors.h"
+
+#include "SireStream/datastream.h"
+#include "SireStream/shareddatastream.h"
+
+#include <cmath>
+
+using namespace SireMaths;
+using namespace SireUnits;
+using namespace SireUnits::Dimension;
+using namespace SireBase;
+using namespace SireStream;
+
+/** The maximum number of levels of blocking (block sizes of 1 to 2^47 samples) */
+static const int MAX_BLOCK_LEVELS = 48;
+
+/** The minimum number of blocks needed before a level of blocking
+    is used to estimate the statistical inefficiency */
+static const int MIN_BLOCKS = 16;
+
+/** The maximum number of segments in the coarse-grained time series */
+static const int MAX_SEGMENTS = 128;
+
+static const RegisterMetaType<StreamingFreeEnergyAverage> r_avg;
+
+/** Serialise to a binary datastream */
+QDataStream SIREMATHS_EXPORT &operator<<(QDataStream &ds,
+                                         const StreamingFreeEnergyAverage &avg)
+{
+    writeHeader(ds, r_avg, 1);
+    
+    SharedDataStream sds(ds);
+    
+    sds << avg.temp << avg.is_forwards_free_energy
+        << avg.welford_mean << avg.welford_m2 << avg.minval << avg.maxval
+        << avg.lse_shift << avg.lse_sum << avg.lse_sum2
+        << avg.block_sum << avg.block_sum2 << avg.block_count
+        << avg.block_pending << avg.block_has_pending
+        << avg.seg_sum << avg.seg_sum2
+        << avg.cur_sum << avg.cur_sum2 << avg.cur_count << avg.seg_width
+        << static_cast<const Accumulator&>(avg);
+    
+    return ds;
+}
+
+/** Extract from a binary datastream */
+QDataStream SIREMATHS_EXPORT &operator>>(QDataStream &ds, StreamingFreeEnergyAverage &avg)
+{
+    VersionID v = readHeader(ds, r_avg);
+    
+    if (v == 1)
+    {
+        SharedDataStream sds(ds);
+        
+        sds >> avg.temp >> avg.is_forwards_free_energy
+            >> avg.welford_mean >> avg.welford_m2 >> avg.minval >> avg.maxval
+            >> avg.lse_shift >> avg.lse_sum >> avg.lse_sum2
+            >> avg.block_sum >> avg.block_sum2 >> avg.block_count
+            >> avg.block_pending >> avg.block_has_pending
+            >> avg.seg_sum >> avg.seg_sum2
+            >> avg.cur_sum >> avg.cur_sum2 >> avg.cur_count >> avg.seg_width
+            >> static_cast<Accumulator&>(avg);
+    }
+    else
+        throw version_error(v, "1", r_avg, CODELOC);
+        
+    return ds;
+}
+
+/** Constructor - this defaults to accumulating the average
+    at room temperature (25 C) */
+StreamingFreeEnergyAverage::StreamingFreeEnergyAverage()
+      : ConcreteProperty<StreamingFreeEnergyAverage,Accumulator>(),
+        temp( double(25*celsius) ), is_forwards_free_energy(true)
+{
+    this->clear();
+}
+
+/** Constructor - this defaults to accumulating the average
+    at room temperature (25 C), specifying whether or not this is
+    a forwards or backwards free energy */
+StreamingFreeEnergyAverage::StreamingFreeEnergyAverage(bool forwards)
+      : ConcreteProperty<StreamingFreeEnergyAverage,Accumulator>(),
+        temp( double(25*celsius) ), is_forwards_free_energy(forwards)
+{
+    this->clear();
+}
+
+/** Constructor - accumulate the average at the passed temperature,
+    specifying whether or not this is a forwards or backwards free energy */
+StreamingFreeEnergyAverage::StreamingFreeEnergyAverage(const Temperature &temperature,
+                                                       bool forwards)
+      : ConcreteProperty<StreamingFreeEnergyAverage,Accumulator>(),
+        temp( temperature.to(kelvin) ), is_forwards_free_energy(forwards)
+{
+    this->clear();
+}
+
+/** Copy constructor */
+StreamingFreeEnergyAverage::StreamingFreeEnergyAverage(const StreamingFreeEnergyAverage &other)
+      : ConcreteProperty<StreamingFreeEnergyAverage,Accumulator>(other),
+        temp(other.temp), is_forwards_free_energy(other.is_forwards_free_energy),
+        welford_mean(other.welford_mean), welford_m2(other.welford_m2),
+        minval(other.minval), maxval(other.maxval),
+        lse_shift(other.lse_shift), lse_sum(other.lse_sum), lse_sum2(other.lse_sum2),
+        block_sum(other.block_sum), block_sum2(other.block_sum2),
+        block_count(other.block_count), block_pending(other.block_pending),
+        block_has_pending(other.block_has_pending),
+        seg_sum(other.seg_sum), seg_sum2(other.seg_sum2),
+        cur_sum(other.cur_sum), cur_sum2(other.cur_sum2), cur_count(other.cur_count),
+        seg_width(other.seg_width)
+{}
+
+/** Destructor */
+StreamingFreeEnergyAverage::~StreamingFreeEnergyAverage()
+{}
+
+/** Copy assignment operator */
+StreamingFreeEnergyAverage& StreamingFreeEnergyAverage::operator=(
+                                        const StreamingFreeEnergyAverage &other)
+{
+    if (this != &other)
+    {
+        temp = other.temp;
+        is_forwards_free_energy = other.is_forwards_free_energy;
+        welford_mean = other.welford_mean;
+        welford_m2 = other.welford_m2;
+        minval = other.minval;
+        maxval = other.maxval;
+        lse_shift = other.lse_shift;
+        lse_sum = other.lse_sum;
+        lse_sum2 = other.lse_sum2;
+        block_sum = other.block_sum;
+        block_sum2 = other.block_sum2;
+        block_count = other.block_count;
+        block_pending = other.block_pending;
+        block_has_pending = other.block_has_pending;
+        seg_sum = other.seg_sum;
+        seg_sum2 = other.seg_sum2;
+        cur_sum = other.cur_sum;
+        cur_sum2 = other.cur_sum2;
+        cur_count = other.cur_count;
+        seg_width = other.seg_width;
+        Accumulator::operator=(other);
+    }
+    
+    return *this;
+}
+
+/** Comparison operator */
+bool StreamingFreeEnergyAverage::operator==(const StreamingFreeEnergyAverage &other) const
+{
+    return this == &other or
+           (temp == other.temp and is_forwards_free_energy == other.is_forwards_free_energy
+            and welford_mean == other.welford_mean and welford_m2 == other.welford_m2
+            and lse_shift == other.lse_shift and lse_sum == other.lse_sum
+            and lse_sum2 == other.lse_sum2 and block_sum == other.block_sum
+            and block_sum2 == other.block_sum2 and block_count == other.block_count
+            and seg_sum == other.seg_sum and seg_sum2 == other.seg_sum2
+            and cur_count == other.cur_count and seg_width == other.seg_width
+            and Accumulator::operator==(other));
+}
+
+/** Comparison operator */
+bool StreamingFreeEnergyAverage::operator!=(const StreamingFreeEnergyAverage &other) const
+{
+    return not operator==(other);
+}
+
+/** Combine the averages from 'other' into this average. This is used to
+    combine the averages collected from different replicas. Note that
+    the coarse-grained time series of 'other' is not included, so the
+    equilibration detection is based only on the samples in this average
+
+    \throw SireError::incompatible_error
+*/
+StreamingFreeEnergyAverage& StreamingFreeEnergyAverage::operator+=(
+                                        const StreamingFreeEnergyAverage &other)
+{
+    if (temp != other.temp or is_forwards_free_energy != other.is_forwards_free_energy)
+        throw SireError::incompatible_error( QObject::tr(
+                "Cannot add together these two StreamingFreeEnergyAverage objects as "
+                "they have different temperatures or directions. %1 vs. %2.")
+                    .arg(this->toString()).arg(other.toString()), CODELOC );
+
+    if (other.nSamples() == 0)
+        return *this;
+    
+    else if (this->nSamples() == 0)
+    {
+        this->operator=(other);
+        return *this;
+    }
+
+    //combine the log-sum-exps
+    if (other.lse_shift > lse_shift)
+    {
+        const double f = std::exp(lse_shift - other.lse_shift);
+        lse_sum = lse_sum*f + other.lse_sum;
+        lse_sum2 = lse_sum2*f*f + other.lse_sum2;
+        lse_shift = other.lse_shift;
+    }
+    else
+    {
+        const double f = std::exp(other.lse_shift - lse_shift);
+        lse_sum += other.lse_sum * f;
+        lse_sum2 += other.lse_sum2 * f*f;
+    }
+
+    //combine the means and variances (Chan et al.)
+    const double na = this->nSamples();
+    const double nb = other.nSamples();
+    const double n = na + nb;
+    const double delta = other.welford_mean - welford_mean;
+
+    welford_mean += delta * nb / n;
+    welford_m2 += other.welford_m2 + delta*delta*na*nb / n;
+
+    minval = qMin(minval, other.minval);
+    maxval = qMax(maxval, other.maxval);
+
+    //the blocks of independent replicas are independent, so can be combined
+    for (int i=0; i<MAX_BLOCK_LEVELS; ++i)
+    {
+        block_sum[i] += other.block_sum[i];
+        block_sum2[i] += other.block_sum2[i];
+        block_count[i] += other.block_count[i];
+    }
+
+    Accumulator::add(other.nSamples());
+
+    return *this;
+}
+
+/** Return the combination of this average with 'other' */
+StreamingFreeEnergyAverage StreamingFreeEnergyAverage::operator+(
+                                        const StreamingFreeEnergyAverage &other) const
+{
+    StreamingFreeEnergyAverage ret(*this);
+    ret += other;
+    return ret;
+}
+
+const char* StreamingFreeEnergyAverage::typeName()
+{
+    return QMetaType::typeName( qMetaTypeId<StreamingFreeEnergyAverage>() );
+}
+
+QString StreamingFreeEnergyAverage::toString() const
+{
+    return QObject::tr("StreamingFreeEnergyAverage( dG = %1 kcal mol-1, "
+                       "error = %2 kcal mol-1, average = %3 kcal mol-1, "
+                       "stdev = %4 kcal mol-1, nSamples = %5, "
+                       "statisticalInefficiency = %6, isForwardsFreeEnergy() = %7 )")
+                            .arg(this->fepFreeEnergy())
+                            .arg(this->standardError())
+                            .arg(this->average())
+                            .arg(this->standardDeviation())
+                            .arg(nSamples())
+                            .arg(this->statisticalInefficiency())
+                            .arg(isForwardsFreeEnergy());
+}
+
+/** Return the temperature at which the free energy average is accumulated */
+Temperature StreamingFreeEnergyAverage::temperature() const
+{
+    return Temperature(temp);
+}
+
+/** Return whether or not this is a forwards free energy */
+bool StreamingFreeEnergyAverage::isForwardsFreeEnergy() const
+{
+    return is_forwards_free_energy;
+}
+
+/** Return whether or not this is a backwards free energy */
+bool StreamingFreeEnergyAverage::isBackwardsFreeEnergy() const
+{
+    return not isForwardsFreeEnergy();
+}
+
+/** Return 1 / kT */
+double StreamingFreeEnergyAverage::beta() const
+{
+    return 1.0 / (k_boltz * temp);
+}
+
+/** Completely clear the statistics in this accumulator */
+void StreamingFreeEnergyAverage::clear()
+{
+    welford_mean = 0;
+    welford_m2 = 0;
+    minval = 0;
+    maxval = 0;
+    lse_shift = 0;
+    lse_sum = 0;
+    lse_sum2 = 0;
+
+    block_sum = QVector<double>(MAX_BLOCK_LEVELS, 0.0);
+    block_sum2 = QVector<double>(MAX_BLOCK_LEVELS, 0.0);
+    block_count = QVector<qint64>(MAX_BLOCK_LEVELS, 0);
+    block_pending = QVector<double>(MAX_BLOCK_LEVELS, 0.0);
+    block_has_pending = QVector<bool>(MAX_BLOCK_LEVELS, false);
+
+    seg_sum.clear();
+    seg_sum2.clear();
+    cur_sum = 0;
+    cur_sum2 = 0;
+    cur_count = 0;
+    seg_width = 1;
+
+    Accumulator::clear();
+}
+
+/** Add 'value' to the blocks at each level of blocking */
+void StreamingFreeEnergyAverage::addToBlocks(double value)
+{
+    double v = value;
+
+    for (int i=0; i<MAX_BLOCK_LEVELS; ++i)
+    {
+        block_sum[i] += v;
+        block_sum2[i] += v*v;
+        block_count[i] += 1;
+
+        if (block_has_pending[i])
+        {
+            //this completes a block at the next level
+            v = 0.5 * (block_pending[i] + v);
+            block_has_pending[i] = false;
+        }
+        else
+        {
+            block_pending[i] = v;
+            block_has_pending[i] = true;
+            break;
+        }
+    }
+}
+
+/** Add 'value' to the coarse-grained time series. When the series is
+    full, neighbouring segments are merged, doubling the segment width */
+void StreamingFreeEnergyAverage::addToSegments(double value)
+{
+    cur_sum += value;
+    cur_sum2 += value*value;
+    cur_count += 1;
+
+    if (cur_count < seg_width)
+        return;
+
+    seg_sum.append(cur_sum);
+    seg_sum2.append(cur_sum2);
+    cur_sum = 0;
+    cur_sum2 = 0;
+    cur_count = 0;
+
+    if (seg_sum.count() >= MAX_SEGMENTS)
+    {
+        const int nhalf = seg_sum.count() / 2;
+
+        for (int i=0; i<nhalf; ++i)
+        {
+            seg_sum[i] = seg_sum[2*i] + seg_sum[2*i+1];
+            seg_sum2[i] = seg_sum2[2*i] + seg_sum2[2*i+1];
+        }
+
+        seg_sum.resize(nhalf);
+        seg_sum2.resize(nhalf);
+        seg_width *= 2;
+    }
+}
+
+/** Accumulate the energy difference 'value' (in kcal mol-1) onto the average */
+void StreamingFreeEnergyAverage::accumulate(double value)
+{
+    const double x = -beta() * value;
+
+    if (nSamples() == 0)
+    {
+        lse_shift = x;
+        lse_sum = 1;
+        lse_sum2 = 1;
+        minval = value;
+        maxval = value;
+    }
+    else
+    {
+        if (x > lse_shift)
+        {
+            //rescale the sums so that the largest value is exp(0)
+            const double f = std::exp(lse_shift - x);
+            lse_sum = lse_sum*f + 1.0;
+            lse_sum2 = lse_sum2*f*f + 1.0;
+            lse_shift = x;
+        }
+        else
+        {
+            const double e = std::exp(x - lse_shift);
+            lse_sum += e;
+            lse_sum2 += e*e;
+        }
+
+        minval = qMin(minval, value);
+        maxval = qMax(maxval, value);
+    }
+
+    //Welford's algorithm for the mean and variance
+    const double n = nSamples() + 1;
+    const double delta = value - welford_mean;
+    welford_mean += delta / n;
+    welford_m2 += delta * (value - welford_mean);
+
+    this->addToBlocks(value);
+    this->addToSegments(value);
+
+    Accumulator::accumulate(value);
+}
+
+/** Return the average energy difference */
+double StreamingFreeEnergyAverage::average() const
+{
+    return welford_mean;
+}
+
+/** Return the variance of the energy difference */
+double StreamingFreeEnergyAverage::variance() const
+{
+    if (nSamples() == 0)
+        return 0;
+    else
+        return welford_m2 / nSamples();
+}
+
+/** Return the standard deviation of the energy difference */
+double StreamingFreeEnergyAverage::standardDeviation() const
+{
+    return std::sqrt( this->variance() );
+}
+
+/** Return the smallest energy difference */
+double StreamingFreeEnergyAverage::minimum() const
+{
+    return minval;
+}
+
+/** Return the largest energy difference */
+double StreamingFreeEnergyAverage::maximum() const
+{
+    return maxval;
+}
+
+/** Return the FEP free energy, -kT ln < exp(-beta dU) >. Note that if this
+    is a backwards free energy, then this will return the negative (so that
+    it is easy to combine backwards and forwards values) */
+double StreamingFreeEnergyAverage::fepFreeEnergy() const
+{
+    if (nSamples() == 0)
+        return 0;
+
+    double dg = -(lse_shift + std::log(lse_sum) - std::log(double(nSamples()))) / beta();
+
+    if (not is_forwards_free_energy)
+        dg *= -1;
+
+    return dg;
+}
+
+/** Return the second order Taylor (cumulant) expansion estimate of the
+    free energy, < dU > - beta/2 var(dU) */
+double StreamingFreeEnergyAverage::taylorExpansion() const
+{
+    double dg = this->average() - 0.5 * beta() * this->variance();
+
+    if (not is_forwards_free_energy)
+        dg *= -1;
+
+    return dg;
+}
+
+/** Allow automatic casting to a double to retrieve the free energy */
+StreamingFreeEnergyAverage::operator double() const
+{
+    return this->fepFreeEnergy();
+}
+
+/** Return the statistical inefficiency of the energy differences, estimated
+    using block averaging. This is the number of correlated samples that are
+    equivalent to one independent sample (so is 1 for uncorrelated data).
+    The largest estimate from any level of blocking with enough blocks is
+    returned, which approximates the plateau of the blocking curve */
+double StreamingFreeEnergyAverage::statisticalInefficiency() const
+{
+    const double var0 = this->variance();
+
+    if (var0 <= 0)
+        return 1;
+
+    double g = 1;
+    double block_size = 1;
+
+    for (int i=1; i<MAX_BLOCK_LEVELS; ++i)
+    {
+        block_size *= 2;
+
+        if (block_count[i] < MIN_BLOCKS)
+            break;
+
+        const double mean = block_sum[i] / block_count[i];
+        const double var = (block_sum2[i] / block_count[i]) - mean*mean;
+
+        g = qMax(g, block_size * var / var0);
+    }
+
+    return g;
+}
+
+/** Return the effective number of independent samples */
+double StreamingFreeEnergyAverage::nEffectiveSamples() const
+{
+    return nSamples() / this->statisticalInefficiency();
+}
+
+/** Return the standard error on the FEP free energy (in kcal mol-1). This
+    is calculated from the relative variance of exp(-beta dU), corrected
+    for the correlation between samples using the statistical inefficiency */
+double StreamingFreeEnergyAverage::standardError() const
+{
+    const double n = nSamples();
+
+    if (n < 2)
+        return 0;
+
+    //var(w) / <w>^2, where w = exp(-beta dU)
+    const double relvar = qMax( 0.0, (n * lse_sum2 / (lse_sum*lse_sum)) - 1.0 );
+
+    return std::sqrt( relvar * this->statisticalInefficiency() / n ) / beta();
+}
+
+/** Return the number of samples at the start of the simulation that should
+    be discarded as equilibration. This chooses the start point that
+    maximises the number of effective (uncorrelated) samples in the rest
+    of the simulation (the method of Chodera, J. Chem. Theory Comput. 2016),
+    using the coarse-grained time series, so the result is a multiple
+    of the current segment width */
+qint64 StreamingFreeEnergyAverage::equilibrationSamples() const
+{
+    const int nseg = seg_sum.count();
+
+    if (nseg < 4)
+        return 0;
+
+    double best_neff = 0;
+    int best_start = 0;
+
+    //never discard more than half of the simulation
+    for (int start=0; start <= nseg/2; ++start)
+    {
+        double sum = 0;
+        double sum2 = 0;
+        double segsum2 = 0;
+
+        for (int i=start; i<nseg; ++i)
+        {
+            const double segmean = seg_sum[i] / seg_width;
+
+            sum += seg_sum[i];
+            sum2 += seg_sum2[i];
+            segsum2 += segmean * segmean;
+        }
+
+        const int m = nseg - start;
+        const double n = double(m) * seg_width;
+
+        const double mean = sum / n;
+        const double var = (sum2 / n) - mean*mean;
+        const double segvar = (segsum2 / m) - mean*mean;
+
+        double g = 1;
+
+        if (var > 0)
+            g = qMax(1.0, seg_width * segvar / var);
+
+        const double neff = n / g;
+
+        if (neff > best_neff)
+        {
+            best_neff = neff;
+            best_start = start;
+        }
+    }
+
+    return qint64(best_start) * seg_width;
+}
+
+/** Return whether or not the free energy has converged, i.e. that its
+    standard error is less than 'error' */
+bool StreamingFreeEnergyAverage::isConverged(const MolarEnergy &error) const
+{
+    return nSamples() > 1 and this->standardError() < error.value();
+}
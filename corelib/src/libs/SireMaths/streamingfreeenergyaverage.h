@@ -0,0 +1,188 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#ifndef SIREMATHS_STREAMINGFREEENERGYAVERAGE_H
+#define SIREMATHS_STREAMINGFREEENERGYAVERAGE_H
+
+#include "accumulator.h"
+
+#include "SireUnits/dimensions.h"
+#include "SireUnits/temperature.h"
+
+SIRE_BEGIN_HEADER
+
+namespace SireMaths
+{
+class StreamingFreeEnergyAverage;
+}
+
+QDataStream& operator<<(QDataStream&, const SireMaths::StreamingFreeEnergyAverage&);
+QDataStream& operator>>(QDataStream&, SireMaths::StreamingFreeEnergyAverage&);
+
+namespace SireMaths
+{
+
+/** This class is used to accumulate a free energy average using a fixed
+    amount of memory, no matter how many samples are collected. Unlike
+    FreeEnergyAverage, it does not record a histogram of the energies.
+    Instead it accumulates;
+
+    (1) a running log-sum-exp of -beta dU (and of -2 beta dU), from which
+        the FEP free energy, and its relative variance, are calculated
+        without overflow;
+
+    (2) the mean and variance of dU using Welford's algorithm, from which
+        the Taylor expansion estimate is calculated;
+
+    (3) the sums of block averages for block sizes of 1, 2, 4, 8 ... samples
+        (Flyvbjerg-Petersen blocking), from which the statistical inefficiency,
+        and thus the standard error on the free energy, is calculated;
+
+    (4) a coarse-grained time series of at most 128 segment averages,
+        which is used to detect the number of samples at the start of
+        the simulation that should be discarded as equilibration.
+
+    Averages from different replicas can be cheaply combined using
+    operator+=. Note that the coarse-grained time series (and so the
+    equilibration detection) is that of the left-hand average, as
+    the time series of independent replicas cannot be joined.
+
+    @author Christopher Woods
+*/
+class SIREMATHS_EXPORT StreamingFreeEnergyAverage
+        : public SireBase::ConcreteProperty<StreamingFreeEnergyAverage,Accumulator>
+{
+
+friend QDataStream& ::operator<<(QDataStream&, const StreamingFreeEnergyAverage&);
+friend QDataStream& ::operator>>(QDataStream&, StreamingFreeEnergyAverage&);
+
+public:
+    StreamingFreeEnergyAverage();
+    StreamingFreeEnergyAverage(bool forwards_free_energy);
+    StreamingFreeEnergyAverage(const SireUnits::Dimension::Temperature &temperature,
+                               bool forwards_free_energy=true);
+
+    StreamingFreeEnergyAverage(const StreamingFreeEnergyAverage &other);
+
+    ~StreamingFreeEnergyAverage();
+
+    StreamingFreeEnergyAverage& operator=(const StreamingFreeEnergyAverage &other);
+
+    bool operator==(const StreamingFreeEnergyAverage &other) const;
+    bool operator!=(const StreamingFreeEnergyAverage &other) const;
+
+    StreamingFreeEnergyAverage operator+(const StreamingFreeEnergyAverage &other) const;
+
+    StreamingFreeEnergyAverage& operator+=(const StreamingFreeEnergyAverage &other);
+
+    static const char* typeName();
+
+    QString toString() const;
+
+    SireUnits::Dimension::Temperature temperature() const;
+
+    bool isForwardsFreeEnergy() const;
+    bool isBackwardsFreeEnergy() const;
+
+    void clear();
+
+    void accumulate(double value);
+
+    double average() const;
+    double variance() const;
+    double standardDeviation() const;
+
+    double minimum() const;
+    double maximum() const;
+
+    double fepFreeEnergy() const;
+    double taylorExpansion() const;
+
+    operator double() const;
+
+    double statisticalInefficiency() const;
+    double nEffectiveSamples() const;
+
+    double standardError() const;
+
+    qint64 equilibrationSamples() const;
+
+    bool isConverged(const SireUnits::Dimension::MolarEnergy &error) const;
+
+private:
+    void addToBlocks(double value);
+    void addToSegments(double value);
+
+    double beta() const;
+
+    /** The temperature (in kelvin) */
+    double temp;
+
+    /** Whether or not this is a forwards free energy */
+    bool is_forwards_free_energy;
+
+    /** The running Welford mean and sum of squared deviations of dU */
+    double welford_mean, welford_m2;
+
+    /** The minimum and maximum values of dU */
+    double minval, maxval;
+
+    /** The running log-sum-exp of -beta dU, held as the shift
+        and the sums of exp(x - shift) and exp(2(x - shift)) */
+    double lse_shift, lse_sum, lse_sum2;
+
+    /** The sum of block averages, and of their squares, and the
+        number of complete blocks, at each level of blocking */
+    QVector<double> block_sum, block_sum2;
+    QVector<qint64> block_count;
+
+    /** The incomplete block waiting for its partner at each level */
+    QVector<double> block_pending;
+    QVector<bool> block_has_pending;
+
+    /** The sums of dU, and of dU^2, in each complete segment of the
+        coarse-grained time series */
+    QVector<double> seg_sum, seg_sum2;
+
+    /** The sums for the incomplete segment at the end of the series */
+    double cur_sum, cur_sum2;
+    qint64 cur_count;
+
+    /** The number of samples in each segment */
+    qint64 seg_width;
+};
+
+}
+
+Q_DECLARE_METATYPE( SireMaths::StreamingFreeEnergyAverage )
+
+SIRE_EXPOSE_CLASS( SireMaths::StreamingFreeEnergyAverage )
+
+SIRE_END_HEADER
+
+#endif
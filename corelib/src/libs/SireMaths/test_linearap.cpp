@@ -0,0 +1,247 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "SireMaths/linearap.h"
+#include "SireMaths/nmatrix.h"
+#include "SireMaths/rangenerator.h"
+
+#include "SireBase/unittest.h"
+
+#include "SireError/errors.h"
+
+#include <QDebug>
+
+using namespace SireMaths;
+using namespace SireBase;
+
+/** The cost given to non-candidate columns in the dense problem. This is
+    larger than the cost of any complete assignment using only candidates,
+    so the dense solver will never choose a non-candidate column */
+static const double non_candidate_cost = 1e6;
+
+/** Return a random n by n matrix of costs in [0,100] */
+static NMatrix randomCosts(RanGenerator &rand, int n)
+{
+    NMatrix costs(n, n);
+
+    for (int i=0; i<n; ++i)
+    {
+        for (int j=0; j<n; ++j)
+        {
+            costs(i,j) = rand.rand(0, 100);
+        }
+    }
+
+    return costs;
+}
+
+/** Choose the candidate columns of each row. Each row is offered each 
+    column with probability 'fraction', and always its diagonal column, 
+    so that a complete assignment exists */
+static QVector< QVector<int> > randomCandidates(RanGenerator &rand, int n,
+                                                double fraction)
+{
+    QVector< QVector<int> > columns(n);
+
+    for (int i=0; i<n; ++i)
+    {
+        for (int j=0; j<n; ++j)
+        {
+            if (j == i or rand.rand() < fraction)
+                columns[i].append(j);
+        }
+    }
+
+    return columns;
+}
+
+/** Return the sparse costs of the candidate columns 'columns' */
+static QVector< QVector<double> > sparseCosts(const NMatrix &costs,
+                                              const QVector< QVector<int> > &columns)
+{
+    QVector< QVector<double> > sparse(columns.count());
+
+    for (int i=0; i<columns.count(); ++i)
+    {
+        for (const int j : columns.at(i))
+        {
+            sparse[i].append( costs(i,j) );
+        }
+    }
+
+    return sparse;
+}
+
+/** Return the dense costs, with non-candidate columns priced out */
+static NMatrix denseCosts(const NMatrix &costs,
+                          const QVector< QVector<int> > &columns)
+{
+    NMatrix dense(costs.nRows(), costs.nColumns(), non_candidate_cost);
+
+    for (int i=0; i<columns.count(); ++i)
+    {
+        for (const int j : columns.at(i))
+        {
+            dense(i,j) = costs(i,j);
+        }
+    }
+
+    return dense;
+}
+
+/** Assert that 'rows_to_columns' is a complete assignment that uses only
+    the candidate columns */
+static void assert_valid(const QVector<int> &rows_to_columns,
+                         const QVector< QVector<int> > &columns)
+{
+    const int n = columns.count();
+
+    assert_equal( rows_to_columns.count(), n, CODELOC );
+
+    QVector<bool> used(n, false);
+
+    for (int i=0; i<n; ++i)
+    {
+        const int j = rows_to_columns.at(i);
+
+        assert_true( j >= 0 and j < n, CODELOC );
+        assert_true( not used.at(j), CODELOC );
+        assert_true( columns.at(i).contains(j), CODELOC );
+
+        used[j] = true;
+    }
+}
+
+void test_linearap(bool verbose)
+{
+    RanGenerator rand(4321);
+
+    const int sizes[] = { 1, 2, 5, 20, 60 };
+    const double fractions[] = { 1.0, 0.25, 0.05 };
+
+    for (const int n : sizes)
+    {
+        for (const double fraction : fractions)
+        {
+            for (int trial=0; trial<5; ++trial)
+            {
+                NMatrix costs = randomCosts(rand, n);
+                const QVector< QVector<int> > columns = randomCandidates(rand, n, fraction);
+
+                NMatrix dense = denseCosts(costs, columns);
+                const double optimum = calculate_total_cost( dense,
+                                                 solve_linear_assignment(dense) );
+
+                QVector<int> rows_to_columns;
+                QVector<double> prices;
+
+                assert_true( solve_sparse_linear_assignment(columns, 
+                                                            sparseCosts(costs, columns),
+                                                            rows_to_columns, prices),
+                             CODELOC );
+
+                assert_valid(rows_to_columns, columns);
+
+                const double total = calculate_total_cost(dense, rows_to_columns);
+
+                if (verbose)
+                    qDebug() << n << fraction << trial << "sparse" << total
+                             << "dense" << optimum;
+
+                //the default epsilon keeps the auction within n*epsilon
+                //(about 1e-7) of the optimum
+                assert_nearly_equal( total, optimum, 1e-6, CODELOC );
+
+                //the cold-start form returns the same assignment
+                assert_equal( solve_sparse_linear_assignment(columns,
+                                                     sparseCosts(costs, columns)),
+                              rows_to_columns, CODELOC );
+
+                //change the costs of a few rows, unassign them and warm-start
+                //from the previous solution
+                for (int k=0; k < qMin(3, n); ++k)
+                {
+                    const int i = rand.randInt(n-1);
+
+                    for (int j=0; j<n; ++j)
+                    {
+                        costs(i,j) = rand.rand(0, 100);
+                    }
+
+                    rows_to_columns[i] = -1;
+                }
+
+                dense = denseCosts(costs, columns);
+                const double new_optimum = calculate_total_cost( dense,
+                                                 solve_linear_assignment(dense) );
+
+                assert_true( solve_sparse_linear_assignment(columns,
+                                                            sparseCosts(costs, columns),
+                                                            rows_to_columns, prices),
+                             CODELOC );
+
+                assert_valid(rows_to_columns, columns);
+                assert_nearly_equal( calculate_total_cost(dense, rows_to_columns),
+                                     new_optimum, 1e-6, CODELOC );
+            }
+        }
+    }
+
+    //there is no complete assignment if two rows share a single candidate
+    QVector< QVector<int> > columns(3);
+    QVector< QVector<double> > costs(3);
+
+    columns[0] = QVector<int>() << 0;
+    columns[1] = QVector<int>() << 0;
+    columns[2] = QVector<int>() << 1 << 2;
+    costs[0] = QVector<double>() << 1.0;
+    costs[1] = QVector<double>() << 2.0;
+    costs[2] = QVector<double>() << 3.0 << 4.0;
+
+    QVector<int> rows_to_columns;
+    QVector<double> prices;
+
+    assert_true( not solve_sparse_linear_assignment(columns, costs,
+                                                    rows_to_columns, prices), CODELOC );
+
+    assert_true( solve_sparse_linear_assignment(columns, costs).isEmpty(), CODELOC );
+
+    //mismatched candidates and costs are rejected
+    costs[2] = QVector<double>() << 3.0;
+
+    assert_throws( [&](){ solve_sparse_linear_assignment(columns, costs); },
+                   SireError::invalid_arg(), CODELOC );
+
+    //as are out of range columns
+    columns[2] = QVector<int>() << 3;
+
+    assert_throws( [&](){ solve_sparse_linear_assignment(columns, costs); },
+                   SireError::invalid_arg(), CODELOC );
+}
+
+SIRE_UNITTEST( test_linearap )
@@ -0,0 +1,203 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "SireMaths/rangenerator.h"
+#include "SireMaths/vector.h"
+
+#include "SireBase/unittest.h"
+
+#include <QDebug>
+
+#include <cmath>
+
+using namespace SireMaths;
+using namespace SireBase;
+
+/** Return the next 'n' random integers from 'rand' */
+static QVector<quint32> nextInts(const RanGenerator &rand, int n)
+{
+    QVector<quint32> values(n);
+
+    for (int i=0; i<n; ++i)
+    {
+        values[i] = rand.randInt();
+    }
+
+    return values;
+}
+
+/** Assert that the mean and variance of 'values' match 'mean' and
+    'variance', to within five standard errors */
+static void assert_normal(const QVector<double> &values, double mean, double variance,
+                          bool verbose, const QString &codeloc)
+{
+    const int n = values.count();
+
+    double sum = 0;
+    double sum2 = 0;
+
+    for (const double value : values)
+    {
+        sum += value;
+        sum2 += value*value;
+    }
+
+    const double avg = sum / n;
+    const double var = sum2 / n - avg*avg;
+
+    if (verbose)
+        qDebug() << n << "mean" << avg << mean << "variance" << var << variance;
+
+    assert_nearly_equal( avg, mean, 5.0 * std::sqrt(variance / n), codeloc );
+    assert_nearly_equal( var, variance, 5.0 * variance * std::sqrt(2.0 / n), codeloc );
+}
+
+void test_rangenerator(bool verbose)
+{
+    //the same seed and index give the same substream
+    const RanGenerator a(4242), b(4242);
+
+    assert_equal( nextInts(a.substream(3), 100), nextInts(b.substream(3), 100), CODELOC );
+
+    //while different indicies, seeds, and the parent generator all differ
+    assert_not_equal( nextInts(a.substream(3), 100), nextInts(a.substream(4), 100), CODELOC );
+    assert_not_equal( nextInts(a.substream(3), 100), 
+                      nextInts(RanGenerator(4243).substream(3), 100), CODELOC );
+    assert_not_equal( nextInts(RanGenerator(4242), 100), 
+                      nextInts(a.substream(0), 100), CODELOC );
+
+    //taking a substream doesn't advance the parent generator
+    {
+        RanGenerator c(4242), d(4242);
+        c.substream(7);
+
+        assert_equal( nextInts(c, 100), nextInts(d, 100), CODELOC );
+    }
+
+    //thread-safe generators are shared by their copies...
+    {
+        RanGenerator g(99);
+        RanGenerator h(g);
+
+        assert_true( g.isThreadSafe(), CODELOC );
+        assert_true( g == h, CODELOC );
+
+        const QVector<quint32> first = nextInts(g, 10);
+        assert_not_equal( nextInts(h, 10), first, CODELOC );
+    }
+
+    //...while copies of substreams are independent generators that
+    //start from the same state, so they can't race on shared state
+    {
+        const RanGenerator s = a.substream(11);
+        RanGenerator copy(s);
+        RanGenerator assigned;
+        assigned = s;
+
+        assert_true( not s.isThreadSafe(), CODELOC );
+        assert_true( not copy.isThreadSafe(), CODELOC );
+        assert_true( copy != s, CODELOC );
+        assert_true( assigned != s, CODELOC );
+
+        const QVector<quint32> from_copy = nextInts(copy, 100);
+
+        assert_equal( nextInts(s, 100), from_copy, CODELOC );
+        assert_equal( nextInts(assigned, 100), from_copy, CODELOC );
+    }
+
+    //the thread-local generator is an unlocked substream that
+    //is reused by this thread
+    assert_true( not RanGenerator::threadLocal().isThreadSafe(), CODELOC );
+    assert_true( &(RanGenerator::threadLocal()) == &(RanGenerator::threadLocal()), CODELOC );
+
+    //batched normal numbers have the right mean and variance for
+    //both odd and even counts
+    RanGenerator rand(1357);
+
+    const int ns[] = { 100000, 100001 };
+
+    for (const int n : ns)
+    {
+        const QVector<double> values = rand.nrandNorm(n, 2.0, 3.0);
+
+        assert_equal( values.count(), n, CODELOC );
+        assert_normal( values, 2.0, 9.0, verbose, CODELOC );
+
+        //the odd value at the end is also drawn from the distribution
+        assert_true( std::isfinite(values.last()), CODELOC );
+    }
+
+    //randNorm() gives the standard normal distribution
+    {
+        QVector<double> values(100000);
+
+        for (int i=0; i<values.count(); ++i)
+        {
+            values[i] = rand.randNorm();
+        }
+
+        assert_normal( values, 0.0, 1.0, verbose, CODELOC );
+    }
+
+    //nvectorOnSphere(n,radius) places the vectors on the sphere, uniformly
+    const double radius = 2.5;
+    const QVector<Vector> vectors = rand.nvectorOnSphere(100000, radius);
+
+    Vector sum;
+    double sum_z2 = 0;
+
+    for (const Vector &v : vectors)
+    {
+        assert_nearly_equal( v.length(), radius, 1e-9, CODELOC );
+
+        sum += v;
+        sum_z2 += v.z() * v.z();
+    }
+
+    const double n = vectors.count();
+    const double error = 5.0 * radius / std::sqrt(3.0 * n);
+
+    if (verbose)
+        qDebug() << "mean vector" << (sum / n).toString() << "mean z^2" << sum_z2 / n;
+
+    assert_nearly_equal( sum.x() / n, 0.0, error, CODELOC );
+    assert_nearly_equal( sum.y() / n, 0.0, error, CODELOC );
+    assert_nearly_equal( sum.z() / n, 0.0, error, CODELOC );
+
+    //<z^2> = r^2 / 3 for a uniform distribution on the sphere
+    assert_nearly_equal( sum_z2 / n, radius*radius / 3.0, 
+                         5.0 * radius*radius / std::sqrt(5.0 * n), CODELOC );
+
+    //as do the unit sphere functions
+    for (const Vector &v : rand.nvectorOnSphere(1000))
+    {
+        assert_nearly_equal( v.length(), 1.0, 1e-9, CODELOC );
+    }
+}
+
+SIRE_UNITTEST( test_rangenerator )
@@ -0,0 +1,192 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "SireMaths/streamingfreeenergyaverage.h"
+#include "SireMaths/rangenerator.h"
+
+#include "SireUnits/units.h"
+
+#include "SireBase/unittest.h"
+
+#include "SireError/errors.h"
+
+#include <QDebug>
+
+#include <cmath>
+
+using namespace SireMaths;
+using namespace SireUnits;
+using namespace SireBase;
+
+/** Return 'n' correlated energy differences (in kcal mol-1), generated
+    by an AR(1) process, so that the statistical inefficiency is
+    well above one */
+static QVector<double> correlatedSeries(RanGenerator &rand, int n)
+{
+    QVector<double> values(n);
+
+    double x = 0;
+
+    for (int i=0; i<n; ++i)
+    {
+        x = 0.9*x + rand.randNorm(0, 0.2);
+        values[i] = 1.5 + x;
+    }
+
+    return values;
+}
+
+/** Assert that 'a' and 'b' are equal to within a relative tolerance */
+static void assert_close(double a, double b, const QString &codeloc)
+{
+    assert_nearly_equal( a, b, 1e-9 * qMax(1.0, std::abs(b)), codeloc );
+}
+
+/** Assert that the averages 'merged' and 'single' agree on all of the
+    statistics that do not depend on the block boundaries */
+static void assert_same_stats(const StreamingFreeEnergyAverage &merged,
+                              const StreamingFreeEnergyAverage &single)
+{
+    assert_equal( merged.nSamples(), single.nSamples(), CODELOC );
+    assert_close( merged.average(), single.average(), CODELOC );
+    assert_close( merged.variance(), single.variance(), CODELOC );
+    assert_close( merged.minimum(), single.minimum(), CODELOC );
+    assert_close( merged.maximum(), single.maximum(), CODELOC );
+    assert_close( merged.fepFreeEnergy(), single.fepFreeEnergy(), CODELOC );
+    assert_close( merged.taylorExpansion(), single.taylorExpansion(), CODELOC );
+}
+
+void test_streamingfreeenergyaverage(bool verbose)
+{
+    RanGenerator rand(1234);
+
+    const Temperature temperature = 300*kelvin;
+    const double beta = 1.0 / (k_boltz * 300.0);
+
+    //four replicas whose lengths are a multiple of every block size that has
+    //enough blocks to be used, so the blocks line up with a single pass
+    const int nreplicas = 4;
+    const int nsamples = 1024;
+
+    QVector<double> all_values;
+
+    StreamingFreeEnergyAverage single(temperature);
+    StreamingFreeEnergyAverage merged(temperature);
+    StreamingFreeEnergyAverage summed(temperature);
+
+    for (int i=0; i<nreplicas; ++i)
+    {
+        const QVector<double> values = correlatedSeries(rand, nsamples);
+
+        StreamingFreeEnergyAverage replica(temperature);
+
+        for (const double value : values)
+        {
+            single.accumulate(value);
+            replica.accumulate(value);
+        }
+
+        all_values += values;
+
+        merged += replica;
+        summed = summed + replica;
+    }
+
+    if (verbose)
+    {
+        qDebug() << "single" << single.toString();
+        qDebug() << "merged" << merged.toString();
+    }
+
+    assert_same_stats(merged, single);
+    assert_same_stats(summed, single);
+
+    //the blocks line up, so the correlation analysis is the same too
+    assert_close( merged.statisticalInefficiency(), single.statisticalInefficiency(), CODELOC );
+    assert_close( merged.standardError(), single.standardError(), CODELOC );
+
+    //the series is correlated, so this must be picked up by the blocking
+    assert_true( single.statisticalInefficiency() > 2, CODELOC );
+
+    //check the single pass against a direct (two-pass) calculation
+    double sum = 0;
+    double sum_exp = 0;
+
+    for (const double value : all_values)
+    {
+        sum += value;
+        sum_exp += std::exp(-beta * value);
+    }
+
+    const double mean = sum / all_values.count();
+
+    double sum_dev2 = 0;
+
+    for (const double value : all_values)
+    {
+        sum_dev2 += (value - mean) * (value - mean);
+    }
+
+    assert_close( single.average(), mean, CODELOC );
+    assert_close( single.variance(), sum_dev2 / all_values.count(), CODELOC );
+    assert_close( single.fepFreeEnergy(),
+                  -std::log(sum_exp / all_values.count()) / beta, CODELOC );
+
+    //replicas of different lengths still combine exactly, apart from the
+    //block averages, which cannot be joined across replicas
+    const QVector<double> values_a = correlatedSeries(rand, 1000);
+    const QVector<double> values_b = correlatedSeries(rand, 1537);
+
+    StreamingFreeEnergyAverage a(temperature), b(temperature), ab(temperature);
+
+    for (const double value : values_a)
+    {
+        a.accumulate(value);
+        ab.accumulate(value);
+    }
+
+    for (const double value : values_b)
+    {
+        b.accumulate(value);
+        ab.accumulate(value);
+    }
+
+    assert_same_stats(a + b, ab);
+
+    //merging with an empty average changes nothing
+    StreamingFreeEnergyAverage empty(temperature);
+
+    assert_same_stats(empty + a, a);
+    assert_same_stats(a + empty, a);
+
+    //averages at different temperatures cannot be merged
+    assert_throws( [&](){ a += StreamingFreeEnergyAverage(310*kelvin); },
+                   SireError::incompatible_error(), CODELOC );
+}
+
+SIRE_UNITTEST( test_streamingfreeenergyaverage )
@@ -46,6 +46,100 @@ using namespace SireStream;
 
 RegisterMetaType<AtomSelection> r_selection;
 
+/** The number of atoms at or above which partial selections
+    are held as a dense bitset rather than as sets of indicies */
+static const int DENSE_SELECTION_NATOMS = 256;
+
+namespace SireMol
+{
+    namespace detail
+    {
+        /** Return the number of 64bit words needed to hold 'nats' bits */
+        inline int nBitWords(int nats)
+        {
+            return (nats + 63) / 64;
+        }
+        
+        /** Return whether or not bit 'i' is set */
+        inline bool testBit(const quint64 *bits, int i)
+        {
+            return (bits[i >> 6] >> (i & 63)) & quint64(1);
+        }
+        
+        /** Set bit 'i' */
+        inline void setBit(quint64 *bits, int i)
+        {
+            bits[i >> 6] |= (quint64(1) << (i & 63));
+        }
+        
+        /** Clear bit 'i' */
+        inline void clearBit(quint64 *bits, int i)
+        {
+            bits[i >> 6] &= ~(quint64(1) << (i & 63));
+        }
+        
+        /** Return the number of set bits in 'word' */
+        inline int countBits(quint64 word)
+        {
+            #if defined(__GNUC__) || defined(__clang__)
+                return __builtin_popcountll(word);
+            #else
+                word = word - ((word >> 1) & Q_UINT64_C(0x5555555555555555));
+                word = (word & Q_UINT64_C(0x3333333333333333)) +
+                       ((word >> 2) & Q_UINT64_C(0x3333333333333333));
+                word = (word + (word >> 4)) & Q_UINT64_C(0x0f0f0f0f0f0f0f0f);
+                return int( (word * Q_UINT64_C(0x0101010101010101)) >> 56 );
+            #endif
+        }
+        
+        /** Return the index of the lowest set bit in the (non-zero) 'word' */
+        inline int lowestBit(quint64 word)
+        {
+            #if defined(__GNUC__) || defined(__clang__)
+                return __builtin_ctzll(word);
+            #else
+                int i = 0;
+                
+                while ((word & quint64(1)) == 0)
+                {
+                    word >>= 1;
+                    ++i;
+                }
+                
+                return i;
+            #endif
+        }
+        
+        /** Return the total number of set bits in 'bits' */
+        int countBits(const QVector<quint64> &bits)
+        {
+            const quint64 *bits_array = bits.constData();
+            const int nwords = bits.count();
+            
+            int n = 0;
+            
+            for (int i=0; i<nwords; ++i)
+            {
+                n += countBits(bits_array[i]);
+            }
+            
+            return n;
+        }
+        
+        /** Return a bitset of 'nats' bits where all of the bits are set */
+        QVector<quint64> allBits(int nats)
+        {
+            QVector<quint64> bits( nBitWords(nats), ~quint64(0) );
+            
+            if (nats % 64 != 0)
+                bits.last() = (quint64(1) << (nats % 64)) - 1;
+            
+            return bits;
+        }
+    
+    } // end of namespace detail
+} // end of namespace SireMol
+
 /** Serialise to a binary datastream */
 QDataStream SIREMOL_EXPORT &operator<<(QDataStream &ds,
                                        const AtomSelection &selection)
@@ -54,8 +148,14 @@ QDataStream SIREMOL_EXPORT &operator<<(QDataStream &ds,
     
     SharedDataStream sds(ds);
 
-    sds << selection.d << selection.selected_atoms 
-        << selection.nselected;
+    //the bitset is only an in-memory representation, so always
+    //write the selection as sets of indicies
+    if (selection.atom_bits.isEmpty())
+        sds << selection.d << selection.selected_atoms 
+            << selection.nselected;
+    else
+        sds << selection.d << selection._pvt_sparseAtoms()
+            << selection.nselected;
         
     return ds;
 }
@@ -72,6 +172,8 @@ QDataStream SIREMOL_EXPORT &operator>>(QDataStream &ds,
         
         sds >> selection.d >> selection.selected_atoms
             >> selection.nselected;
+        
+        selection.atom_bits.clear();
     }
     else if (v == 1)
     {
@@ -80,6 +182,8 @@ QDataStream SIREMOL_EXPORT &operator>>(QDataStream &ds,
         sds >> selection.d >> selection.selected_atoms
             >> selection.nselected;
         
+        selection.atom_bits.clear();
+        
         if (not (selection.selectedAll() or selection.selectedNone()))
         {
             //we need to invert the CutGroup selections.
@@ -153,7 +257,7 @@ AtomSelection::AtomSelection(const MoleculeInfoData &molinfo)
 /** Copy constructor */
 AtomSelection::AtomSelection(const AtomSelection &other)
               : ConcreteProperty<AtomSelection,MoleculeProperty>(other),
-                selected_atoms(other.selected_atoms),
+                selected_atoms(other.selected_atoms), atom_bits(other.atom_bits),
                 d(other.d), nselected(other.nselected)
 {}
 
@@ -167,6 +271,7 @@ AtomSelection& AtomSelection::operator=(const AtomSelection &other)
     MoleculeProperty::operator=(other);
 
     selected_atoms = other.selected_atoms;
+    atom_bits = other.atom_bits;
     d = other.d;
     nselected = other.nselected;
     
@@ -176,19 +281,146 @@ AtomSelection& AtomSelection::operator=(const AtomSelection &other)
 /** Comparison operator */
 bool AtomSelection::operator==(const AtomSelection &other) const
 {
-    return this == &other or
-           ( nselected == other.nselected and 
-             (d == other.d or *d == *(other.d)) and
-             selected_atoms == other.selected_atoms );
+    if (this == &other)
+        return true;
+    else if (nselected != other.nselected or (d != other.d and *d != *(other.d)))
+        return false;
+    else if (atom_bits.isEmpty() and other.atom_bits.isEmpty())
+        return selected_atoms == other.selected_atoms;
+    else
+        return this->_pvt_bits() == other._pvt_bits();
 }
 
 /** Comparison operator */
 bool AtomSelection::operator!=(const AtomSelection &other) const
 {
-    return this != &other and
-           ( nselected != other.nselected or
-             (d != other.d and *d != *(other.d)) or
-             selected_atoms != other.selected_atoms );
+    return not AtomSelection::operator==(other);
+}
+
+/** Return whether or not operations involving this selection and
+    'other' should be performed using bitsets */
+bool AtomSelection::_pvt_useBits(const AtomSelection &other) const
+{
+    return not (atom_bits.isEmpty() and other.atom_bits.isEmpty()) or
+           info().nAtoms() >= DENSE_SELECTION_NATOMS;
+}
+
+/** Switch this selection to use a bitset if the molecule is large
+    enough, returning whether or not the bitset is being used */
+bool AtomSelection::_pvt_useBits()
+{
+    if (not atom_bits.isEmpty())
+        return true;
+    else if (info().nAtoms() < DENSE_SELECTION_NATOMS)
+        return false;
+    
+    atom_bits = this->_pvt_bits();
+    selected_atoms.clear();
+    
+    return true;
+}
+
+/** Return the selection as a bitset, indexed by AtomIdx */
+QVector<quint64> AtomSelection::_pvt_bits() const
+{
+    if (not atom_bits.isEmpty())
+        return atom_bits;
+    
+    const int nats = info().nAtoms();
+    
+    if (this->selectedAll())
+        return detail::allBits(nats);
+    
+    QVector<quint64> bits( detail::nBitWords(nats), 0 );
+    
+    if (nselected == 0)
+        return bits;
+    
+    quint64 *bits_array = bits.data();
+    
+    for (auto it = selected_atoms.constBegin(); it != selected_atoms.constEnd(); ++it)
+    {
+        const QList<AtomIdx> &cgatoms = info().getAtomsIn(it.key());
+    
+        if (it->isEmpty())
+        {
+            //all atoms in the CutGroup are selected
+            for (const AtomIdx &atom : cgatoms)
+            {
+                detail::setBit(bits_array, atom.value());
+            }
+        }
+        else
+        {
+            for (const Index &idx : *it)
+            {
+                detail::setBit(bits_array, cgatoms.at(idx.value()).value());
+            }
+        }
+    }
+    
+    return bits;
+}
+
+/** Return the selection as sets of indicies arranged by CGIdx */
+QHash< CGIdx, QSet<Index> > AtomSelection::_pvt_sparseAtoms() const
+{
+    if (atom_bits.isEmpty())
+        return selected_atoms;
+    
+    QHash< CGIdx, QSet<Index> > atoms;
+    
+    const quint64 *bits_array = atom_bits.constData();
+    const int ncg = info().nCutGroups();
+    
+    for (CGIdx i(0); i<ncg; ++i)
+    {
+        const QList<AtomIdx> &cgatoms = info().getAtomsIn(i);
+        
+        QSet<Index> idxs;
+        
+        for (int j=0; j<cgatoms.count(); ++j)
+        {
+            if (detail::testBit(bits_array, cgatoms.at(j).value()))
+                idxs.insert( Index(j) );
+        }
+        
+        if (idxs.count() == cgatoms.count())
+            //all atoms selected, which is represented by an empty set
+            atoms.insert(i, QSet<Index>());
+        else if (not idxs.isEmpty())
+            atoms.insert(i, idxs);
+    }
+    
+    return atoms;
+}
+
+/** Set this selection equal to the atoms that are set in 'bits'. This
+    holds the selection as a bitset if the molecule is large enough */
+void AtomSelection::_pvt_setBits(const QVector<quint64> &bits)
+{
+    atom_bits = bits;
+    selected_atoms.clear();
+    nselected = detail::countBits(bits);
+    
+    this->_pvt_checkBits();
+    
+    if ((not atom_bits.isEmpty()) and info().nAtoms() < DENSE_SELECTION_NATOMS)
+    {
+        selected_atoms = this->_pvt_sparseAtoms();
+        atom_bits.clear();
+    }
+}
+
+/** Check whether a bitset selection has become all or none
+    selected, in which case the bitset is no longer needed */
+void AtomSelection::_pvt_checkBits()
+{
+    if (nselected == 0 or nselected == info().nAtoms())
+    {
+        atom_bits.clear();
+        selected_atoms.clear();
+    }
 }
 
 /** Return wheter no atoms are selected */
@@ -211,6 +443,9 @@ int AtomSelection::nSelected() const
 
 bool AtomSelection::_pvt_selected(const CGAtomIdx &cgatomidx) const
 {
+    if (not atom_bits.isEmpty())
+        return detail::testBit(atom_bits.constData(), info().atomIdx(cgatomidx).value());
+
     auto it = selected_atoms.constFind( cgatomidx.cutGroup() );
     
     if (it != selected_atoms.constEnd())
@@ -274,6 +509,20 @@ bool AtomSelection::selected(const AtomID &atomid) const
 bool AtomSelection::selected(CGIdx cgidx) const
 {
     cgidx = CGIdx( cgidx.map(info().nCutGroups()) );
+    
+    if (not atom_bits.isEmpty())
+    {
+        const quint64 *bits_array = atom_bits.constData();
+    
+        for (const AtomIdx &atom : info().getAtomsIn(cgidx))
+        {
+            if (detail::testBit(bits_array, atom.value()))
+                return true;
+        }
+        
+        return false;
+    }
+    
     return this->selectedAll() or selected_atoms.contains(cgidx);
 }
 
@@ -286,7 +535,7 @@ bool AtomSelection::selected(ResIdx residx) const
 {
     residx = ResIdx( residx.map(info().nResidues()) );
     
-    if (selected_atoms.isEmpty())
+    if (this->selectedAll() or this->selectedNone())
         return nselected > 0;
     else
     {
@@ -309,7 +558,7 @@ bool AtomSelection::selected(ChainIdx chainidx) const
 {
     chainidx = ChainIdx( chainidx.map(info().nChains()) );
     
-    if (selected_atoms.isEmpty())
+    if (this->selectedAll() or this->selectedNone())
         return nselected > 0;
     else
     {
@@ -335,7 +584,7 @@ bool AtomSelection::selected(SegIdx segidx) const
 {
     segidx = SegIdx( segidx.map(info().nSegments()) );
     
-    if (selected_atoms.isEmpty())
+    if (this->selectedAll() or this->selectedNone())
         return nselected > 0;
     else
     {
@@ -431,6 +680,23 @@ bool AtomSelection::selected(const AtomSelection &selection) const
         return false;
     else if (this->selectedAll() or selection.selectedAll())
         return true;
+    else if (this->_pvt_useBits(selection))
+    {
+        //compare the bitsets a word at a time
+        const QVector<quint64> bits0 = this->_pvt_bits();
+        const QVector<quint64> bits1 = selection._pvt_bits();
+        
+        const quint64 *bits0_array = bits0.constData();
+        const quint64 *bits1_array = bits1.constData();
+        
+        for (int i=0; i<bits0.count(); ++i)
+        {
+            if (bits0_array[i] & bits1_array[i])
+                return true;
+        }
+        
+        return false;
+    }
             
     //now do the hard stuff!
     if (selection.selectedAllCutGroups())
@@ -489,8 +755,18 @@ bool AtomSelection::selectedAllAtoms() const
     one selected atom */
 bool AtomSelection::selectedAllCutGroups() const
 {
-    if (selected_atoms.isEmpty())
+    if (this->selectedAll() or this->selectedNone())
         return nselected > 0;
+    else if (not atom_bits.isEmpty())
+    {
+        for (CGIdx i(0); i<info().nCutGroups(); ++i)
+        {
+            if (not this->selected(i))
+                return false;
+        }
+        
+        return true;
+    }
     else
         return selected_atoms.count() == info().nCutGroups();
 }
@@ -499,7 +775,7 @@ bool AtomSelection::selectedAllCutGroups() const
     one selected atom */
 bool AtomSelection::selectedAllResidues() const
 {
-    if (selected_atoms.isEmpty())
+    if (this->selectedAll() or this->selectedNone())
         return nselected > 0;
     else
     {
@@ -517,7 +793,7 @@ bool AtomSelection::selectedAllResidues() const
     one selected atom */
 bool AtomSelection::selectedAllChains() const
 {
-    if (selected_atoms.isEmpty())
+    if (this->selectedAll() or this->selectedNone())
         return nselected > 0;
     else
     {
@@ -535,7 +811,7 @@ bool AtomSelection::selectedAllChains() const
     one selected atom */
 bool AtomSelection::selectedAllSegments() const
 {
-    if (selected_atoms.isEmpty())
+    if (this->selectedAll() or this->selectedNone())
         return nselected > 0;
     else
     {
@@ -672,7 +948,7 @@ bool AtomSelection::selectedNone(const AtomSelection &selection) const
 /** Return whether or not all of the atoms are selected */
 bool AtomSelection::selectedAll() const
 {
-    return nselected != 0 and selected_atoms.isEmpty();
+    return nselected != 0 and selected_atoms.isEmpty() and atom_bits.isEmpty();
 }
 
 /** Return whether or not the atom at index 'atomidx' is selected 
@@ -689,8 +965,21 @@ bool AtomSelection::_pvt_selectedAll(CGIdx cgidx) const
     if (nselected > 0)
     {
         //have all atoms been selected?
-        if (selected_atoms.isEmpty())
+        if (this->selectedAll())
             return true;
+        
+        if (not atom_bits.isEmpty())
+        {
+            const quint64 *bits_array = atom_bits.constData();
+            
+            for (const AtomIdx &atom : info().getAtomsIn(cgidx))
+            {
+                if (not detail::testBit(bits_array, atom.value()))
+                    return false;
+            }
+            
+            return true;
+        }
     
         const auto it = selected_atoms.constFind(cgidx);
         
@@ -849,6 +1138,21 @@ QSet<Index> AtomSelection::selectedAtoms(CGIdx cgidx) const
         
         return ret;
     }
+    else if (not atom_bits.isEmpty())
+    {
+        const quint64 *bits_array = atom_bits.constData();
+        const QList<AtomIdx> &cgatoms = info().getAtomsIn(cgidx);
+        
+        QSet<Index> ret;
+        
+        for (int i=0; i<cgatoms.count(); ++i)
+        {
+            if (detail::testBit(bits_array, cgatoms.at(i).value()))
+                ret.insert( Index(i) );
+        }
+        
+        return ret;
+    }
     else
     {
         const auto it = selected_atoms.constFind(cgidx);
@@ -886,6 +1190,18 @@ QList<CGIdx> AtomSelection::selectedCutGroups() const
     {
         return info().getCutGroups();
     }
+    else if (not atom_bits.isEmpty())
+    {
+        QList<CGIdx> cgidxs;
+        
+        for (CGIdx i(0); i<info().nCutGroups(); ++i)
+        {
+            if (this->selected(i))
+                cgidxs.append(i);
+        }
+        
+        return cgidxs;
+    }
     else
     {
         QList<CGIdx> keys = selected_atoms.keys();
@@ -1029,6 +1345,23 @@ bool AtomSelection::selectedAll(const AtomSelection &selection) const
         return true;
     else if (selection.selectedAll())
         return false;
+    else if (this->_pvt_useBits(selection))
+    {
+        //every bit set in 'selection' must also be set in this selection
+        const QVector<quint64> bits0 = this->_pvt_bits();
+        const QVector<quint64> bits1 = selection._pvt_bits();
+        
+        const quint64 *bits0_array = bits0.constData();
+        const quint64 *bits1_array = bits1.constData();
+        
+        for (int i=0; i<bits0.count(); ++i)
+        {
+            if (bits1_array[i] & ~bits0_array[i])
+                return false;
+        }
+        
+        return true;
+    }
     else if (selection.selectedAllCutGroups() and not this->selectedAllCutGroups())
         return false;
             
@@ -1092,6 +1425,20 @@ int AtomSelection::nSelected(CGIdx cgidx) const
 {
     if (this->selectedAll(cgidx))
         return info().nAtoms(cgidx);
+    else if (not atom_bits.isEmpty())
+    {
+        const quint64 *bits_array = atom_bits.constData();
+    
+        int nats = 0;
+        
+        for (const AtomIdx &atom : info().getAtomsIn(CGIdx(cgidx.map(info().nCutGroups()))))
+        {
+            if (detail::testBit(bits_array, atom.value()))
+                ++nats;
+        }
+        
+        return nats;
+    }
     else
     {
         return selected_atoms.value( CGIdx(cgidx.map(info().nCutGroups())) ).count();
@@ -1293,6 +1640,24 @@ int AtomSelection::nSelected(const AtomSelection &selection) const
         return this->nSelected();
     else if (this->selectedAll())
         return selection.nSelected();
+    else if (this->_pvt_useBits(selection))
+    {
+        //count the bits in common a word at a time
+        const QVector<quint64> bits0 = this->_pvt_bits();
+        const QVector<quint64> bits1 = selection._pvt_bits();
+        
+        const quint64 *bits0_array = bits0.constData();
+        const quint64 *bits1_array = bits1.constData();
+        
+        int nats = 0;
+        
+        for (int i=0; i<bits0.count(); ++i)
+        {
+            nats += detail::countBits( bits0_array[i] & bits1_array[i] );
+        }
+        
+        return nats;
+    }
      
     int nats = 0;
               
@@ -1352,6 +1717,18 @@ int AtomSelection::nSelectedCutGroups() const
 {
     if (this->selectedAll())
         return info().nCutGroups();
+    else if (not atom_bits.isEmpty())
+    {
+        int ncg = 0;
+        
+        for (CGIdx i(0); i<info().nCutGroups(); ++i)
+        {
+            if (this->selected(i))
+                ++ncg;
+        }
+        
+        return ncg;
+    }
     else
     {
         return selected_atoms.count();
@@ -1463,6 +1840,7 @@ int AtomSelection::nSegments() const
 AtomSelection& AtomSelection::selectAll()
 {
     selected_atoms.clear();
+    atom_bits.clear();
     nselected = info().nAtoms();
     
     return *this;
@@ -1472,6 +1850,7 @@ AtomSelection& AtomSelection::selectAll()
 AtomSelection& AtomSelection::deselectAll()
 {
     selected_atoms.clear();
+    atom_bits.clear();
     nselected = 0;
     
     return *this;
@@ -1495,6 +1874,13 @@ void AtomSelection::_pvt_select(const CGAtomIdx &cgatomidx)
         return;
     }
     
+    if (this->_pvt_useBits())
+    {
+        detail::setBit(atom_bits.data(), info().atomIdx(cgatomidx).value());
+        ++nselected;
+        return;
+    }
+    
     //if the cutgroup is already in selected_atoms then it has been selected before
     auto it = selected_atoms.find(cgatomidx.cutGroup());
     
@@ -1569,9 +1955,17 @@ void AtomSelection::_pvt_deselect(const CGAtomIdx &cgatomidx)
     {
         //we have just removed the last selected atom
         selected_atoms.clear();
+        atom_bits.clear();
         nselected = 0;
         return;
     }
+    else if (this->_pvt_useBits())
+    {
+        detail::clearBit(atom_bits.data(), info().atomIdx(cgatomidx).value());
+        --nselected;
+        this->_pvt_checkBits();
+        return;
+    }
     else if ( this->selectedAll() )
     {
         //we need to create space for all CutGroups
@@ -1702,6 +2096,21 @@ void AtomSelection::_pvt_select(CGIdx cgidx)
     if (this->selectedAll(cgidx))
         return;
     
+    else if (this->_pvt_useBits())
+    {
+        quint64 *bits_array = atom_bits.data();
+    
+        for (const AtomIdx &atom : info().getAtomsIn(cgidx))
+        {
+            if (not detail::testBit(bits_array, atom.value()))
+            {
+                detail::setBit(bits_array, atom.value());
+                ++nselected;
+            }
+        }
+        
+        this->_pvt_checkBits();
+    }
     else if (this->selectedNone())
     {
         if (info().nCutGroups() == 1)
@@ -1736,6 +2145,26 @@ void AtomSelection::_pvt_select(CGIdx cgidx)
 
 void AtomSelection::_pvt_deselect(CGIdx cgidx)
 {
+    if (this->selectedNone())
+        return;
+    
+    else if (this->_pvt_useBits())
+    {
+        quint64 *bits_array = atom_bits.data();
+    
+        for (const AtomIdx &atom : info().getAtomsIn(cgidx))
+        {
+            if (detail::testBit(bits_array, atom.value()))
+            {
+                detail::clearBit(bits_array, atom.value());
+                --nselected;
+            }
+        }
+        
+        this->_pvt_checkBits();
+        return;
+    }
+
     //have we selected this CutGroup?
     if (this->selectedAll())
     {
@@ -2526,8 +2955,24 @@ void AtomSelection::_pvt_select(const AtomSelection &selection)
         return;
     else if (selection.selectedAll())
     {
-        selected_atoms.clear();
-        nselected = info().nAtoms();
+        this->selectAll();
+        return;
+    }
+    else if (this->_pvt_useBits(selection))
+    {
+        //unite the bitsets a word at a time
+        QVector<quint64> bits = this->_pvt_bits();
+        const QVector<quint64> other_bits = selection._pvt_bits();
+        
+        quint64 *bits_array = bits.data();
+        const quint64 *other_bits_array = other_bits.constData();
+        
+        for (int i=0; i<bits.count(); ++i)
+        {
+            bits_array[i] |= other_bits_array[i];
+        }
+        
+        this->_pvt_setBits(bits);
         return;
     }
     
@@ -2591,6 +3036,23 @@ AtomSelection& AtomSelection::deselect(const AtomSelection &selection)
         this->deselectAll();
         return *this;
     }
+    else if (this->_pvt_useBits(selection))
+    {
+        //subtract the bitsets a word at a time
+        QVector<quint64> bits = this->_pvt_bits();
+        const QVector<quint64> other_bits = selection._pvt_bits();
+        
+        quint64 *bits_array = bits.data();
+        const quint64 *other_bits_array = other_bits.constData();
+        
+        for (int i=0; i<bits.count(); ++i)
+        {
+            bits_array[i] &= ~other_bits_array[i];
+        }
+        
+        this->_pvt_setBits(bits);
+        return *this;
+    }
     
     if (selection.selectedAllCutGroups())
     {
@@ -2641,6 +3103,7 @@ AtomSelection& AtomSelection::selectOnly(const AtomSelection &selection)
     info().assertEqualTo(selection.info());
     
     selected_atoms = selection.selected_atoms;
+    atom_bits = selection.atom_bits;
     nselected = selection.nselected;
     
     return *this;
@@ -2653,6 +3116,24 @@ AtomSelection& AtomSelection::invert()
         return this->selectNone();
     else if (this->selectedNone())
         return this->selectAll();
+    else if (this->_pvt_useBits(*this))
+    {
+        //invert the bitset a word at a time, masking off the
+        //unused bits at the end of the last word
+        QVector<quint64> bits = this->_pvt_bits();
+        const QVector<quint64> mask = detail::allBits(info().nAtoms());
+        
+        quint64 *bits_array = bits.data();
+        const quint64 *mask_array = mask.constData();
+        
+        for (int i=0; i<bits.count(); ++i)
+        {
+            bits_array[i] = ~bits_array[i] & mask_array[i];
+        }
+        
+        this->_pvt_setBits(bits);
+        return *this;
+    }
         
     for (CGIdx i(0); i<info().nCutGroups(); ++i)
     {
@@ -2925,6 +3406,23 @@ AtomSelection& AtomSelection::intersect(const AtomSelection &other)
     {
         return *this;
     }
+    else if (this->_pvt_useBits(other))
+    {
+        //intersect the bitsets a word at a time
+        QVector<quint64> bits = this->_pvt_bits();
+        const QVector<quint64> other_bits = other._pvt_bits();
+        
+        quint64 *bits_array = bits.data();
+        const quint64 *other_bits_array = other_bits.constData();
+        
+        for (int i=0; i<bits.count(); ++i)
+        {
+            bits_array[i] &= other_bits_array[i];
+        }
+        
+        this->_pvt_setBits(bits);
+        return *this;
+    }
     else
     {
         if (this->selectedAllCutGroups() and other.selectedAllCutGroups())
@@ -3748,6 +4246,30 @@ QVector<AtomIdx> AtomSelection::selectedAtoms() const
             ret_array[i] = i;
         }
     }
+    else if (not atom_bits.isEmpty())
+    {
+        //iterate over the set bits - these are already in AtomIdx order
+        const quint64 *bits_array = atom_bits.constData();
+        const int nwords = atom_bits.count();
+        
+        int count = 0;
+        
+        for (int i=0; i<nwords; ++i)
+        {
+            quint64 word = bits_array[i];
+            
+            while (word != 0)
+            {
+                ret_array[count] = AtomIdx( 64*i + detail::lowestBit(word) );
+                ++count;
+                
+                //clear the lowest set bit
+                word &= (word - 1);
+            }
+        }
+        
+        return ret;
+    }
     else if (this->selectedAllCutGroups())
     {
         int count = 0;
@@ -31,6 +31,7 @@
 
 #include <QSet>
 #include <QHash>
+#include <QVector>
 
 #include "molviewproperty.h"
 
@@ -83,6 +84,11 @@ using SireBase::SharedDataPointer;
 /** This class holds information about a selection of atoms in a Molecule.
     The selection is held in the most memory-efficient manner possible,
     and takes advantage of the CutGroup-based layout of Molecule objects.
+    Partial selections of small molecules are held as sets of atom
+    indicies per CutGroup, while partial selections of large molecules
+    (e.g. proteins or a water box held as a single molecule) are held
+    as a dense bitset over AtomIdx, so that counting, intersecting,
+    uniting and inverting selections are performed a word at a time.
 
     This is a const-class, which returns new AtomSelections that
     represent any change.
@@ -480,9 +486,25 @@ private:
     template<class IDXS>
     void _pvt_deselectAtoms(const IDXS &atoms);
 
-    /** The indicies of selected atoms, arranged by CGIdx */
+    bool _pvt_useBits();
+    bool _pvt_useBits(const AtomSelection &other) const;
+    
+    QVector<quint64> _pvt_bits() const;
+    QHash< CGIdx, QSet<Index> > _pvt_sparseAtoms() const;
+    
+    void _pvt_setBits(const QVector<quint64> &bits);
+    void _pvt_checkBits();
+
+    /** The indicies of selected atoms, arranged by CGIdx. This is
+        empty if all or no atoms are selected, or if the selection
+        is held as a bitset */
     QHash< CGIdx, QSet<Index> > selected_atoms;
 
+    /** The selected atoms as a dense bitset, indexed by AtomIdx.
+        This is only used for partial selections of large molecules,
+        and is empty otherwise */
+    QVector<quint64> atom_bits;
+
     /** The MoleculeInfo describing the molecule whose parts
         are being selected by this object */
     SharedDataPointer<MoleculeInfoData> d;
@@ -280,6 +280,10 @@ MoleculeData::MoleculeData(const StructureEditor &editor)
     //create the info object from this editor
     molinfo = SharedDataPointer<MoleculeInfoData>( new MoleculeInfoData(editor) );
     
+    //share the layout with any identical molecule if this has been requested
+    if (MoleculeInfoData::sharesLayouts())
+        molinfo = MoleculeInfoData::shared(molinfo);
+    
     //now copy across the properties...
     props = editor.properties();
     
@@ -185,6 +185,39 @@ public:
     CGAtomIdx cgatomidx;
 };
 
+/** This is the registry of molecule layouts that are shared between
+    molecules with identical topologies (e.g. all of the waters in
+    a box of water). Layouts are indexed by a hash of their atom
+    and residue names, and the registry holds a reference to each
+    layout so that it can be found by later molecules */
+class MolInfoRegistry
+{
+public:
+    MolInfoRegistry();
+    ~MolInfoRegistry();
+    
+    SharedDataPointer<MoleculeInfoData> registerLayout(
+                            const SharedDataPointer<MoleculeInfoData> &molinfo);
+    
+    int count();
+    void clear();
+
+private:
+    static uint layoutHash(const MoleculeInfoData &molinfo);
+
+    void prune();
+
+    /** Mutex used to serialise access to the registry */
+    QMutex mutex;
+
+    /** All of the registered layouts, indexed by their hash */
+    QMultiHash< uint,SharedDataPointer<MoleculeInfoData> > layouts;
+    
+    /** The number of layouts at which the registry will next
+        be pruned of layouts that are no longer in use */
+    int prune_at;
+};
+
 } // end of namespace detail
 } // end of namespace SireMol
 
@@ -390,6 +423,110 @@ bool SegInfo::operator!=(const SegInfo &other) const
     return name != other.name or atom_indicies != other.atom_indicies;
 }
 
+////////
+//////// Implementation of detail::MolInfoRegistry
+////////
+
+Q_GLOBAL_STATIC( MolInfoRegistry, molInfoRegistry );
+
+/** Whether or not newly created molecules share identical layouts */
+static bool share_layouts = false;
+
+MolInfoRegistry::MolInfoRegistry() : prune_at(1024)
+{}
+
+MolInfoRegistry::~MolInfoRegistry()
+{}
+
+/** Return a hash of the passed layout. This only uses the
+    numbers of each part and the names of the atoms and residues, 
+    which is enough to distinguish different molecules */
+uint MolInfoRegistry::layoutHash(const MoleculeInfoData &molinfo)
+{
+    uint h = qHash(molinfo.atoms_by_index.count()) ^
+             ( qHash(molinfo.res_by_index.count()) << 8 ) ^
+             ( qHash(molinfo.cg_by_index.count()) << 16 );
+
+    const AtomInfo *atoms = molinfo.atoms_by_index.constData();
+    
+    for (int i=0; i<molinfo.atoms_by_index.count(); ++i)
+    {
+        h = 31*h + qHash(atoms[i].name.value());
+    }
+    
+    const ResInfo *residues = molinfo.res_by_index.constData();
+    
+    for (int i=0; i<molinfo.res_by_index.count(); ++i)
+    {
+        h = 31*h + qHash(residues[i].name.value());
+    }
+    
+    return h;
+}
+
+/** Remove all layouts that are now only referenced by the registry */
+void MolInfoRegistry::prune()
+{
+    QMutableHashIterator< uint,SharedDataPointer<MoleculeInfoData> > it(layouts);
+    
+    while (it.hasNext())
+    {
+        it.next();
+        
+        if (it.value().constData()->ref.hasSingleReference())
+            it.remove();
+    }
+    
+    prune_at = qMax(1024, 2*layouts.count());
+}
+
+/** Return the registered layout that is identical to 'molinfo'. If
+    there is no such layout, then 'molinfo' is registered and returned */
+SharedDataPointer<MoleculeInfoData> MolInfoRegistry::registerLayout(
+                            const SharedDataPointer<MoleculeInfoData> &molinfo)
+{
+    if (molinfo.constData() == 0 or molinfo->atoms_by_index.isEmpty())
+        return molinfo;
+
+    uint h = layoutHash(*molinfo);
+    
+    QMutexLocker lkr(&mutex);
+    
+    QMultiHash< uint,SharedDataPointer<MoleculeInfoData> >::const_iterator
+                                                    it = layouts.constFind(h);
+    
+    while (it != layouts.constEnd() and it.key() == h)
+    {
+        if (it.value()->hasSameLayout(*molinfo))
+            return it.value();
+    
+        ++it;
+    }
+    
+    if (layouts.count() >= prune_at)
+        this->prune();
+    
+    layouts.insert(h, molinfo);
+    
+    return molinfo;
+}
+
+/** Return the number of layouts in the registry */
+int MolInfoRegistry::count()
+{
+    QMutexLocker lkr(&mutex);
+    this->prune();
+    return layouts.count();
+}
+
+/** Clear the registry */
+void MolInfoRegistry::clear()
+{
+    QMutexLocker lkr(&mutex);
+    layouts.clear();
+    prune_at = 1024;
+}
+
 ////////
 //////// Implementation of MoleculeInfoData
 ////////
@@ -1010,7 +1147,7 @@ void MoleculeInfoData::squeeze(const MoleculeInfoData &other) const
     int nats = atoms_by_index.count();
 
     const AtomInfo *this_atom_array = atoms_by_index.constData();
-    const AtomInfo *other_atom_array = atoms_by_index.constData();
+    const AtomInfo *other_atom_array = other.atoms_by_index.constData();
 
     if (this_atom_array == other_atom_array)
     {
@@ -1063,6 +1200,83 @@ void MoleculeInfoData::squeeze(const MoleculeInfoData &other) const
     }
 }
 
+/** Return whether or not the passed layout has the same fingerprint 
+    as this layout, i.e. the same number of atoms, residues, CutGroups,
+    chains and segments */
+bool MoleculeInfoData::_pvt_hasSameFingerprint(const MoleculeInfoData &other) const
+{
+    return atoms_by_index.count() == other.atoms_by_index.count() and
+           res_by_index.count() == other.res_by_index.count() and
+           cg_by_index.count() == other.cg_by_index.count() and
+           chains_by_index.count() == other.chains_by_index.count() and
+           seg_by_index.count() == other.seg_by_index.count();
+}
+
+/** Return whether or not this layout is identical to 'other', 
+    i.e. it has the same atoms, residues, CutGroups, chains and segments,
+    with the same names and numbers, arranged in the same way. Unlike
+    the comparison operator, this does not compare the UIDs of the layouts */
+bool MoleculeInfoData::hasSameLayout(const MoleculeInfoData &other) const
+{
+    if (uid == other.uid)
+        return true;
+    
+    else if (not this->_pvt_hasSameFingerprint(other))
+        return false;
+        
+    else
+        return atoms_by_index == other.atoms_by_index and
+               res_by_index == other.res_by_index and
+               cg_by_index == other.cg_by_index and
+               chains_by_index == other.chains_by_index and
+               seg_by_index == other.seg_by_index;
+}
+
+/** Switch on or off the sharing of identical layouts between molecules.
+    When this is on, any newly created molecule whose layout is identical
+    to that of an existing molecule will share the existing layout (and
+    its UID). This can massively reduce the memory used by large systems
+    that contain many copies of the same molecule (e.g. water or lipids).
+    Sharing is off by default */
+void MoleculeInfoData::setShareLayouts(bool on)
+{
+    share_layouts = on;
+    
+    if (not on)
+        molInfoRegistry()->clear();
+}
+
+/** Return whether or not newly created molecules share identical layouts */
+bool MoleculeInfoData::sharesLayouts()
+{
+    return share_layouts;
+}
+
+/** Return the number of distinct layouts that are currently available
+    to be shared */
+int MoleculeInfoData::nSharedLayouts()
+{
+    return molInfoRegistry()->count();
+}
+
+/** Clear the registry of shared layouts. Molecules that already share
+    a layout will continue to do so, but new molecules will no longer
+    be able to share any of the existing layouts */
+void MoleculeInfoData::clearSharedLayouts()
+{
+    molInfoRegistry()->clear();
+}
+
+/** Return the shared layout that is identical to 'molinfo'. If no such
+    layout exists, then 'molinfo' is registered as the shared copy of 
+    its layout and is returned. Note that this registers layouts
+    regardless of whether or not sharing has been switched on */
+SharedDataPointer<MoleculeInfoData> MoleculeInfoData::shared(
+                                const SharedDataPointer<MoleculeInfoData> &molinfo)
+{
+    return molInfoRegistry()->registerLayout(molinfo);
+}
+
 /** Comparison operator - two molinfos are equal if they have the same UID */
 bool MoleculeInfoData::operator==(const MoleculeInfoData &other) const
 {
@@ -119,6 +119,14 @@ class SegInfo;
     layout within the program (thus allowing for a quick and simple
     test to ensure that molecules have the same layout of data).
     
+    Large systems often contain thousands of copies of the same molecule
+    (e.g. waters or lipids). If layout sharing is switched on (via
+    MoleculeInfoData::setShareLayouts), then every newly created molecule
+    whose layout is identical to an existing one (same atoms, residues,
+    CutGroups, chains and segments, with the same names and numbers)
+    will share that existing MoleculeInfoData (and thus also its UID),
+    so that only one copy of the layout is held in memory.
+    
     @author Christopher Woods
 */
 class SIREMOL_EXPORT MoleculeInfoData : public MolInfo, public SireBase::RefCountData
@@ -127,6 +135,8 @@ class SIREMOL_EXPORT MoleculeInfoData : public MolInfo, public SireBase::RefCoun
 friend QDataStream& ::operator<<(QDataStream&, const MoleculeInfoData&);
 friend QDataStream& ::operator>>(QDataStream&, MoleculeInfoData&);
 
+friend class detail::MolInfoRegistry;
+
 public:
     MoleculeInfoData();
     
@@ -356,13 +366,24 @@ public:
 
     void assertEqualTo(const MoleculeInfoData &other) const;
     
+    bool hasSameLayout(const MoleculeInfoData &other) const;
+    
     static const MoleculeInfoData& null();
     
+    static void setShareLayouts(bool on);
+    static bool sharesLayouts();
+    
+    static int nSharedLayouts();
+    static void clearSharedLayouts();
+    
+    static SireBase::SharedDataPointer<MoleculeInfoData> shared(
+                        const SireBase::SharedDataPointer<MoleculeInfoData> &molinfo);
+    
 private:
     
     void rebuildNameAndNumberIndexes();
     
-    bool _pvt_hasSameFingerprint(const MoleculeInfoData &other);
+    bool _pvt_hasSameFingerprint(const MoleculeInfoData &other) const;
     
     QList<AtomIdx> _pvt_getAtomsIn(const QList<ResIdx> &residxs) const;
     QList<AtomIdx> _pvt_getAtomsIn(const QList<ResIdx> &residxs,
@@ -0,0 +1,319 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "packedcoords.h"
+#include "molecules.h"
+#include "moleculedata.h"
+#include "atomcoords.h"
+
+#include "SireMol/errors.h"
+
+#include "SireStream/datastream.h"
+#include "SireStream/shareddatastream.h"
+
+#include <QDebug>
+
+using namespace SireMol;
+using namespace SireVol;
+using namespace SireBase;
+using namespace SireStream;
+
+static const RegisterMetaType<PackedCoords> r_packedcoords(NO_ROOT);
+
+/** Serialise to a binary datastream */
+QDataStream SIREMOL_EXPORT &operator<<(QDataStream &ds, const PackedCoords &packed)
+{
+    writeHeader(ds, r_packedcoords, 1);
+    
+    SharedDataStream sds(ds);
+    
+    sds << packed.molnums << packed.coords << packed.coords_property;
+    
+    return ds;
+}
+
+/** Extract from a binary datastream */
+QDataStream SIREMOL_EXPORT &operator>>(QDataStream &ds, PackedCoords &packed)
+{
+    VersionID v = readHeader(ds, r_packedcoords);
+    
+    if (v == 1)
+    {
+        SharedDataStream sds(ds);
+        
+        sds >> packed.molnums >> packed.coords >> packed.coords_property;
+        
+        packed.rebuildIndex();
+    }
+    else
+        throw version_error(v, "1", r_packedcoords, CODELOC);
+    
+    return ds;
+}
+
+/** Constructor */
+PackedCoords::PackedCoords()
+{
+    coord_offsets.append(0);
+}
+
+/** Construct an arena that holds the coordinates of all of the
+    passed molecules (using the passed property map to find the 
+    coordinates property). Molecules that don't have any coordinates
+    are not included */
+PackedCoords::PackedCoords(const Molecules &molecules, const PropertyMap &map)
+             : coords_property(map["coordinates"])
+{
+    QList<MolNum> nums = molecules.molNums().toList();
+    qSort(nums);
+    
+    QVector<CoordGroupArray> arrays;
+    arrays.reserve(nums.count());
+    molnums.reserve(nums.count());
+    
+    foreach (MolNum molnum, nums)
+    {
+        const MoleculeData &moldata = molecules[molnum].data();
+        
+        if (moldata.hasProperty(coords_property))
+        {
+            arrays.append( moldata.property(coords_property)
+                                  .asA<AtomCoords>().array() );
+            molnums.append(molnum);
+        }
+    }
+    
+    coords = CoordGroupArrayArray(arrays);
+    
+    this->rebuildIndex();
+}
+
+/** Copy constructor */
+PackedCoords::PackedCoords(const PackedCoords &other)
+             : molnums(other.molnums), molnum_to_idx(other.molnum_to_idx),
+               coord_offsets(other.coord_offsets), coords(other.coords),
+               coords_property(other.coords_property)
+{}
+
+/** Destructor */
+PackedCoords::~PackedCoords()
+{}
+
+/** Copy assignment operator */
+PackedCoords& PackedCoords::operator=(const PackedCoords &other)
+{
+    if (this != &other)
+    {
+        molnums = other.molnums;
+        molnum_to_idx = other.molnum_to_idx;
+        coord_offsets = other.coord_offsets;
+        coords = other.coords;
+        coords_property = other.coords_property;
+    }
+    
+    return *this;
+}
+
+/** Comparison operator */
+bool PackedCoords::operator==(const PackedCoords &other) const
+{
+    return this == &other or
+           (molnums == other.molnums and coords_property == other.coords_property and
+            coords == other.coords);
+}
+
+/** Comparison operator */
+bool PackedCoords::operator!=(const PackedCoords &other) const
+{
+    return not PackedCoords::operator==(other);
+}
+
+const char* PackedCoords::typeName()
+{
+    return QMetaType::typeName( qMetaTypeId<PackedCoords>() );
+}
+
+const char* PackedCoords::what() const
+{
+    return PackedCoords::typeName();
+}
+
+QString PackedCoords::toString() const
+{
+    return QObject::tr("PackedCoords( nMolecules() == %1, nCoords() == %2 )")
+                .arg(this->nMolecules()).arg(this->nCoords());
+}
+
+/** Rebuild the index from molecule number to position in the arena */
+void PackedCoords::rebuildIndex()
+{
+    molnum_to_idx.clear();
+    molnum_to_idx.reserve(molnums.count());
+    
+    coord_offsets = QVector<qint32>(molnums.count() + 1, 0);
+    
+    for (int i=0; i<molnums.count(); ++i)
+    {
+        molnum_to_idx.insert(molnums.at(i), i);
+        coord_offsets[i+1] = coord_offsets[i] + coords.at(i).nCoords();
+    }
+}
+
+/** Return the property used to find the coordinates of the molecules */
+const PropertyName& PackedCoords::coordinatesProperty() const
+{
+    return coords_property;
+}
+
+/** Return the numbers of the molecules in the arena, in the order
+    in which their coordinates are packed */
+const QVector<MolNum>& PackedCoords::molNums() const
+{
+    return molnums;
+}
+
+/** Return whether or not the arena contains the molecule with number 'molnum' */
+bool PackedCoords::contains(MolNum molnum) const
+{
+    return molnum_to_idx.contains(molnum);
+}
+
+/** Assert that the arena contains the molecule with number 'molnum'
+
+    \throw SireMol::missing_molecule
+*/
+void PackedCoords::assertContains(MolNum molnum) const
+{
+    if (not molnum_to_idx.contains(molnum))
+        throw SireMol::missing_molecule( QObject::tr(
+                "There is no molecule with number %1 in this PackedCoords.")
+                    .arg(molnum.toString()), CODELOC );
+}
+
+/** Return the index of the molecule with number 'molnum' in the arena
+
+    \throw SireMol::missing_molecule
+*/
+int PackedCoords::indexOf(MolNum molnum) const
+{
+    this->assertContains(molnum);
+    return molnum_to_idx.value(molnum);
+}
+
+/** Return the index of the first coordinate of the molecule with 
+    number 'molnum' in the arena, i.e. the coordinates of this molecule
+    are at constCoordsData() + offset(molnum)
+
+    \throw SireMol::missing_molecule
+*/
+int PackedCoords::offset(MolNum molnum) const
+{
+    return coord_offsets.at( this->indexOf(molnum) );
+}
+
+/** Return the coordinates of the molecule with number 'molnum'
+
+    \throw SireMol::missing_molecule
+*/
+const CoordGroupArray& PackedCoords::coordinates(MolNum molnum) const
+{
+    return coords.at( this->indexOf(molnum) );
+}
+
+/** Replace the coordinates in the arena with 'coordinates', which must
+    hold nCoords() coordinates in the same order as constCoordsData()
+    (molecules in order, then CutGroups, then atoms). The layout of the
+    arena is unchanged. Note that molecules that were packed into the old
+    arena keep using the old coordinates - use System::updateCoordinates
+    to copy these coordinates into a system
+    
+    \throw SireError::incompatible_error
+*/
+void PackedCoords::setCoordinates(const QVector<Vector> &coordinates)
+{
+    if (coordinates.count() != this->nCoords())
+        throw SireError::incompatible_error( QObject::tr(
+                "Cannot set the coordinates of the arena as the number of "
+                "coordinates passed (%1) is not equal to the number in the "
+                "arena (%2).")
+                    .arg(coordinates.count()).arg(this->nCoords()), CODELOC );
+
+    const Vector *c = coordinates.constData();
+    
+    QVector<CoordGroupArray> arrays(coords.count());
+    
+    for (int i=0; i<coords.count(); ++i)
+    {
+        const CoordGroupArray &old_array = coords.at(i);
+        
+        QVector<CoordGroup> cgroups(old_array.count());
+        
+        for (int j=0; j<old_array.count(); ++j)
+        {
+            const int n = old_array.at(j).count();
+            cgroups[j] = CoordGroup(n, c);
+            c += n;
+        }
+        
+        arrays[i] = CoordGroupArray(cgroups);
+    }
+    
+    coords = CoordGroupArrayArray(arrays);
+}
+
+/** Return a copy of 'molecules' in which each molecule that is in this 
+    arena uses the arena to hold its coordinates. This reduces the memory
+    used by the molecules, as well as placing their coordinates next to
+    each other in memory. Only molecules whose coordinates are unchanged
+    since the arena was created are updated */
+Molecules PackedCoords::pack(const Molecules &molecules) const
+{
+    Molecules packed = molecules;
+    
+    for (int i=0; i<molnums.count(); ++i)
+    {
+        if (not molecules.contains(molnums.at(i)))
+            continue;
+    
+        MoleculeData moldata = molecules[molnums.at(i)].data();
+        
+        if (not moldata.hasProperty(coords_property))
+            continue;
+        
+        const CoordGroupArray &packed_coords = coords.at(i);
+        
+        if (moldata.property(coords_property).asA<AtomCoords>().array() 
+                                                            == packed_coords)
+        {
+            moldata.setProperty(coords_property.source(), AtomCoords(packed_coords));
+            packed.update(moldata);
+        }
+    }
+    
+    return packed;
+}
@@ -0,0 +1,202 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#ifndef SIREMOL_PACKEDCOORDS_H
+#define SIREMOL_PACKEDCOORDS_H
+
+#include "molnum.h"
+
+#include "SireVol/coordgroup.h"
+
+#include "SireBase/propertymap.h"
+
+#include <QHash>
+#include <QVector>
+
+SIRE_BEGIN_HEADER
+
+namespace SireMol
+{
+class PackedCoords;
+}
+
+QDataStream& operator<<(QDataStream&, const SireMol::PackedCoords&);
+QDataStream& operator>>(QDataStream&, SireMol::PackedCoords&);
+
+namespace SireMol
+{
+
+class Molecules;
+
+using SireVol::CoordGroup;
+using SireVol::CoordGroupArray;
+using SireVol::CoordGroupArrayArray;
+
+using SireMaths::Vector;
+
+using SireBase::PropertyMap;
+using SireBase::PropertyName;
+
+/** This class holds the coordinates of lots of molecules packed
+    together into a single, contiguous block of memory (an arena),
+    in order of increasing molecule number. This provides a 
+    view of the coordinates of a whole system that can be iterated
+    over without going through each molecule in turn, e.g.
+    
+    const Vector *coords = packed.constCoordsData();
+    
+    for (int i=0; i<packed.nCoords(); ++i)
+    {
+        ...use coords[i]
+    }
+    
+    The coordinates of each molecule are implicitly shared with
+    the arena, so the molecules returned by PackedCoords::pack
+    use the arena for their coordinates (rather than their own
+    separate arrays), and so cost no extra memory. A molecule 
+    only takes its own copy of its coordinates when it is moved,
+    at which point this view will no longer reflect that molecule.
+
+    @author Christopher Woods
+*/
+class SIREMOL_EXPORT PackedCoords
+{
+
+friend QDataStream& ::operator<<(QDataStream&, const PackedCoords&);
+friend QDataStream& ::operator>>(QDataStream&, PackedCoords&);
+
+public:
+    PackedCoords();
+    PackedCoords(const Molecules &molecules, const PropertyMap &map = PropertyMap());
+    
+    PackedCoords(const PackedCoords &other);
+    
+    ~PackedCoords();
+    
+    PackedCoords& operator=(const PackedCoords &other);
+    
+    bool operator==(const PackedCoords &other) const;
+    bool operator!=(const PackedCoords &other) const;
+    
+    static const char* typeName();
+    
+    const char* what() const;
+    
+    QString toString() const;
+    
+    bool isEmpty() const;
+    
+    int nMolecules() const;
+    int nCoords() const;
+    
+    const PropertyName& coordinatesProperty() const;
+    
+    const QVector<MolNum>& molNums() const;
+    
+    bool contains(MolNum molnum) const;
+    
+    int indexOf(MolNum molnum) const;
+    
+    int offset(MolNum molnum) const;
+    
+    const CoordGroupArrayArray& coordinates() const;
+    const CoordGroupArray& coordinates(MolNum molnum) const;
+    
+    const Vector* constCoordsData() const;
+    
+    void setCoordinates(const QVector<Vector> &coordinates);
+    
+    Molecules pack(const Molecules &molecules) const;
+
+    void assertContains(MolNum molnum) const;
+
+private:
+    void rebuildIndex();
+
+    /** The numbers of the molecules in the arena, in order */
+    QVector<MolNum> molnums;
+    
+    /** The index of each molecule in the arena */
+    QHash<MolNum,qint32> molnum_to_idx;
+    
+    /** The index of the first coordinate of each molecule
+        in the arena (with one extra value giving the total) */
+    QVector<qint32> coord_offsets;
+    
+    /** The arena holding the coordinates of all of the molecules */
+    CoordGroupArrayArray coords;
+    
+    /** The property used to find the coordinates of each molecule */
+    PropertyName coords_property;
+};
+
+#ifndef SIRE_SKIP_INLINE_FUNCTIONS
+
+/** Return whether or not this arena is empty */
+inline bool PackedCoords::isEmpty() const
+{
+    return molnums.isEmpty();
+}
+
+/** Return the number of molecules in the arena */
+inline int PackedCoords::nMolecules() const
+{
+    return molnums.count();
+}
+
+/** Return the total number of coordinates in the arena */
+inline int PackedCoords::nCoords() const
+{
+    return coords.nCoords();
+}
+
+/** Return a raw pointer to the start of the arena. This can be used
+    to iterate over all nCoords() coordinates of all of the molecules */
+inline const Vector* PackedCoords::constCoordsData() const
+{
+    return coords.constCoordsData();
+}
+
+/** Return the arena holding the coordinates of all of the molecules.
+    The ith CoordGroupArray holds the coordinates of the ith molecule */
+inline const CoordGroupArrayArray& PackedCoords::coordinates() const
+{
+    return coords;
+}
+
+#endif //SIRE_SKIP_INLINE_FUNCTIONS
+
+}
+
+Q_DECLARE_METATYPE( SireMol::PackedCoords )
+
+SIRE_EXPOSE_CLASS( SireMol::PackedCoords )
+
+SIRE_END_HEADER
+
+#endif
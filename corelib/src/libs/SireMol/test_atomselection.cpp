@@ -0,0 +1,311 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "SireMol/atomselection.h"
+#include "SireMol/molecule.h"
+#include "SireMol/moleculedata.h"
+#include "SireMol/moleculeinfodata.h"
+#include "SireMol/moleditor.h"
+#include "SireMol/atomeditor.h"
+#include "SireMol/cgeditor.h"
+
+#include "SireMaths/rangenerator.h"
+
+#include "SireBase/unittest.h"
+
+#include <QDataStream>
+#include <QByteArray>
+#include <QDebug>
+
+#include <algorithm>
+
+using namespace SireMol;
+using namespace SireMaths;
+using namespace SireBase;
+
+/** The number of CutGroups in each molecule */
+static const int ncgroups = 3;
+
+/** Return a molecule with 'natoms' atoms, divided between CutGroups
+    so that the CutGroup order of the atoms is different to their
+    AtomIdx order */
+static Molecule createMolecule(int natoms)
+{
+    MolStructureEditor editor;
+
+    QList<CGIdx> cgidxs;
+
+    for (int i=0; i<ncgroups; ++i)
+    {
+        cgidxs.append( editor.add( CGName(QString::number(i)) ).index() );
+    }
+
+    for (int i=0; i<natoms; ++i)
+    {
+        AtomStructureEditor atom = editor.add( AtomNum(i+1) );
+        atom = atom.rename( AtomName(QString("X%1").arg(i+1)) );
+        atom = atom.reparent( cgidxs.at(i % ncgroups) );
+    }
+
+    return editor.commit();
+}
+
+/** Return a random selection of the atoms in 'molinfo', in which each
+    atom is selected with probability 'fraction'. The selection is held
+    both as an AtomSelection and as the reference array 'ref' */
+static AtomSelection randomSelection(const MoleculeInfoData &molinfo, double fraction,
+                                     RanGenerator &rand, QVector<bool> &ref)
+{
+    AtomSelection selection(molinfo);
+    selection.selectNone();
+
+    ref = QVector<bool>(molinfo.nAtoms(), false);
+
+    for (int i=0; i<molinfo.nAtoms(); ++i)
+    {
+        if (rand.rand() < fraction)
+        {
+            selection.select( AtomIdx(i) );
+            ref[i] = true;
+        }
+    }
+
+    return selection;
+}
+
+/** Return a copy of 'selection' that has been written to, and read from,
+    a binary stream. The stream holds the sparse form of the selection,
+    and the copy keeps that form until it is edited */
+static AtomSelection streamed(const AtomSelection &selection)
+{
+    QByteArray data;
+    QDataStream ds(&data, QIODevice::WriteOnly);
+    ds << selection;
+
+    AtomSelection loaded;
+    QDataStream ds2(data);
+    ds2 >> loaded;
+
+    return loaded;
+}
+
+/** Assert that 'selection' selects exactly the atoms set in 'ref' */
+static void assert_same_selection(const AtomSelection &selection, const QVector<bool> &ref,
+                                  QString codeloc)
+{
+    const MoleculeInfoData &molinfo = selection.info();
+
+    QVector<AtomIdx> ref_atoms;
+
+    for (int i=0; i<ref.count(); ++i)
+    {
+        if (ref[i])
+            ref_atoms.append( AtomIdx(i) );
+
+        assert_equal( selection.selected(AtomIdx(i)), bool(ref[i]), codeloc );
+    }
+
+    assert_equal( selection.nSelected(), ref_atoms.count(), codeloc );
+    assert_equal( selection.isEmpty(), ref_atoms.isEmpty(), codeloc );
+    assert_equal( selection.selectedAll(), ref_atoms.count() == ref.count(), codeloc );
+
+    //the sparse form lists the atoms in CutGroup order, so sort them
+    QVector<AtomIdx> atoms = selection.selectedAtoms();
+    std::sort( atoms.begin(), atoms.end() );
+
+    assert_true( atoms == ref_atoms, codeloc );
+
+    for (CGIdx i(0); i<molinfo.nCutGroups(); ++i)
+    {
+        const QList<AtomIdx> cgatoms = molinfo.getAtomsIn(i);
+
+        QSet<Index> ref_idxs;
+
+        for (int j=0; j<cgatoms.count(); ++j)
+        {
+            if (ref[cgatoms[j].value()])
+                ref_idxs.insert( Index(j) );
+        }
+
+        assert_true( selection.selectedAtoms(i) == ref_idxs, codeloc );
+        assert_equal( selection.nSelected(i), ref_idxs.count(), codeloc );
+    }
+}
+
+/** Assert that 'selection' selects exactly the atoms set in 'ref', and
+    that the sparse form read back from a binary stream does the same */
+static void assert_selection(const AtomSelection &selection, const QVector<bool> &ref,
+                             QString codeloc)
+{
+    assert_same_selection(selection, ref, codeloc);
+
+    const AtomSelection loaded = streamed(selection);
+
+    assert_true( loaded == selection, codeloc );
+    assert_true( selection == loaded, codeloc );
+    assert_same_selection(loaded, ref, codeloc);
+}
+
+/** Check the operations on random selections of a molecule with 'natoms' atoms */
+static void test_natoms(int natoms, RanGenerator &rand, bool verbose)
+{
+    const Molecule mol = createMolecule(natoms);
+    const MoleculeInfoData &molinfo = mol.data().info();
+
+    if (verbose)
+        qDebug() << "Testing selections of a molecule with" << natoms << "atoms";
+
+    //include the empty and full selections, and selections that are
+    //nearly empty or nearly full
+    const double fractions[] = { 0.0, 0.01, 0.3, 0.5, 0.7, 0.99, 1.0 };
+    const int nfractions = sizeof(fractions) / sizeof(double);
+
+    for (int i=0; i<nfractions; ++i)
+    {
+        for (int j=0; j<nfractions; ++j)
+        {
+            QVector<bool> ref0, ref1;
+            const AtomSelection sel0 = randomSelection(molinfo, fractions[i], rand, ref0);
+            const AtomSelection sel1 = randomSelection(molinfo, fractions[j], rand, ref1);
+
+            assert_selection(sel0, ref0, CODELOC);
+            assert_selection(sel1, ref1, CODELOC);
+
+            QVector<bool> ref_unite(natoms), ref_subtract(natoms),
+                          ref_intersect(natoms), ref_invert(natoms);
+
+            int ncommon = 0;
+            bool contains_all = true;
+
+            for (int k=0; k<natoms; ++k)
+            {
+                ref_unite[k] = ref0[k] or ref1[k];
+                ref_subtract[k] = ref0[k] and not ref1[k];
+                ref_intersect[k] = ref0[k] and ref1[k];
+                ref_invert[k] = not ref0[k];
+
+                if (ref_intersect[k])
+                    ++ncommon;
+
+                if (ref1[k] and not ref0[k])
+                    contains_all = false;
+            }
+
+            //combine the selections in their in-memory form, and also
+            //against the sparse form read from a stream
+            const AtomSelection sparse1 = streamed(sel1);
+
+            for (int k=0; k<2; ++k)
+            {
+                const AtomSelection &other = (k == 0) ? sel1 : sparse1;
+
+                AtomSelection sel = sel0;
+                sel.unite(other);
+                assert_selection(sel, ref_unite, CODELOC);
+
+                sel = sel0;
+                sel.subtract(other);
+                assert_selection(sel, ref_subtract, CODELOC);
+
+                sel = sel0;
+                sel.intersect(other);
+                assert_selection(sel, ref_intersect, CODELOC);
+
+                assert_equal( sel0.selected(other), ncommon > 0, CODELOC );
+                assert_equal( sel0.nSelected(other), ncommon, CODELOC );
+                assert_equal( sel0.selectedAll(other),
+                              contains_all and not (sel0.isEmpty() or other.isEmpty()),
+                              CODELOC );
+            }
+
+            AtomSelection sel = sel0;
+            sel.invert();
+            assert_selection(sel, ref_invert, CODELOC);
+
+            sel.invert();
+            assert_selection(sel, ref0, CODELOC);
+
+            //selecting and deselecting whole CutGroups
+            sel = sel0;
+            QVector<bool> ref_cg = ref0;
+
+            sel.select( CGIdx(1) );
+            sel.deselect( CGIdx(2) );
+
+            foreach (AtomIdx atom, molinfo.getAtomsIn(CGIdx(1)))
+            {
+                ref_cg[atom.value()] = true;
+            }
+
+            foreach (AtomIdx atom, molinfo.getAtomsIn(CGIdx(2)))
+            {
+                ref_cg[atom.value()] = false;
+            }
+
+            assert_selection(sel, ref_cg, CODELOC);
+        }
+    }
+
+    //build a selection one atom at a time until everything is
+    //selected, and then deselect them again
+    AtomSelection sel(molinfo);
+    sel.selectNone();
+
+    QVector<bool> ref(natoms, false);
+
+    for (int i=natoms-1; i>=0; --i)
+    {
+        sel.select( AtomIdx(i) );
+        ref[i] = true;
+    }
+
+    assert_selection(sel, ref, CODELOC);
+    assert_true( sel == AtomSelection(molinfo), CODELOC );
+
+    for (int i=0; i<natoms; ++i)
+    {
+        sel.deselect( AtomIdx(i) );
+        ref[i] = false;
+    }
+
+    assert_selection(sel, ref, CODELOC);
+}
+
+/** Check that partial selections of molecules just below the size at
+    which they are held as a bitset give the same results as those just
+    at and above this size, and as the sparse form of the same selection */
+void test_atomselection(bool verbose)
+{
+    RanGenerator rand(2468);
+
+    test_natoms(255, rand, verbose);
+    test_natoms(256, rand, verbose);
+    test_natoms(257, rand, verbose);
+}
+
+SIRE_UNITTEST( test_atomselection )
@@ -290,6 +290,10 @@ AtomVelocities HMCGenerator::generate(const MoleculeView &molview,
     Velocity3D *vels_array = vels.data();
     const MolarMass *masses_array = masses.constData();
     
+    //generate all of the normally distributed random numbers in one go,
+    //as this is much quicker than generating them one at a time
+    const QVector<double> rands = rand().nrandNorm(3*sz, 0, 1);
+    
     for (int i=0; i<sz; ++i)
     {
         //generate random momenta from the following gaussian
@@ -315,9 +319,7 @@ AtomVelocities HMCGenerator::generate(const MoleculeView &molview,
         //
         // First generate a random vector from a normal distribution
         // with 0 mean and unit variance
-        Vector norm_rand( rand().randNorm(0,1),
-                          rand().randNorm(0,1),
-                          rand().randNorm(0,1) );
+        Vector norm_rand( rands[3*i], rands[3*i+1], rands[3*i+2] );
         
         // the velocity is this, multiplied by sqrt( kT / m )
         if (masses_array[i].value() == 0)
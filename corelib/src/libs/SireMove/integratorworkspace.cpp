@@ -43,6 +43,7 @@
 #include "SireMol/molidx.h"
 
 #include "SireBase/quickcopy.hpp"
+#include "SireBase/parallel.h"
 
 #include "SireStream/datastream.h"
 #include "SireStream/shareddatastream.h"
@@ -1125,10 +1126,12 @@ void AtomicVelocityWorkspace::commitCoordinates()
     
     PropertyName coords_property = coordinatesProperty();
     
-    Molecules changed_mols;
-    changed_mols.reserve(nmols);
+    //create the moved molecules in parallel, so that they can then
+    //be updated in the system in a single pass
+    QVector<Molecule> changed_mols(nmols);
+    Molecule *changed_mols_array = changed_mols.data();
     
-    for (int i=0; i<nmols; ++i)
+    auto commit_coords = [&](int i)
     {
         MolNum molnum = molgroup.molNumAt(i);
         
@@ -1142,12 +1145,31 @@ void AtomicVelocityWorkspace::commitCoordinates()
         else
             coords.copyFrom(coords_array[i], mol.selection());
 
-        changed_mols.add( mol.molecule().edit()
-                             .setProperty(coords_property, coords)
-                             .commit() );
+        changed_mols_array[i] = mol.molecule().edit()
+                                   .setProperty(coords_property, coords)
+                                   .commit();
+    };
+    
+    if (nmols > 1)
+    {
+        tbb::parallel_for( tbb::blocked_range<int>(0,nmols),
+                           [&](const tbb::blocked_range<int> &r)
+        {
+            for (int i=r.begin(); i<r.end(); ++i)
+            {
+                commit_coords(i);
+            }
+        });
+    }
+    else
+    {
+        for (int i=0; i<nmols; ++i)
+        {
+            commit_coords(i);
+        }
     }
     
-    IntegratorWorkspace::pvt_update(changed_mols);
+    IntegratorWorkspace::pvt_update( Molecules(changed_mols) );
 }
 
 /** Save the velocities back to the system */
@@ -38,6 +38,8 @@
 
 #include <QDebug>
 
+#include <algorithm>
+
 using namespace SireSystem;
 using namespace SireFF;
 using namespace SireMol;
@@ -131,102 +133,281 @@ bool CloseMols::differentMolecules(const QHash<MolNum,double> &molecules) const
         return true;
 }
 
-/** Internal function that rescans through the molecules to find 
-    the closest ones to the point - this returns whether or not this
-    changes the identity of the close molecules */
-bool CloseMols::recalculate()
-{
-    QHash<MolNum,double> old_close_mols = close_mols;
+/** The average number of molecules placed into each cell */
+static const double MOLS_PER_CELL = 2.0;
 
-    //clear the current list
-    close_mols = QHash<MolNum,double>();
-    furthest_molnum = MolNum();
-    cutoff_dist2 = 0;
+/** The maximum number of cells along each dimension */
+static const double MAX_CELLS_PER_DIM = 64.0;
 
-    if (nclosest <= 0)
-        return false;
+/** The minimum size of each cell, in angstroms */
+static const double MIN_CELL_SPACING = 1.0;
 
-    const Molecules &molecules = molgroup.read().molecules();
+/** Return the vector from 'point' to the center of the molecule 
+    'moldata', using the minimum image convention of 'space' */
+static Vector getDelta(const MoleculeData &moldata, const Vector &point,
+                       const Space &space, const PropertyName &coords_property)
+{
+    //just get the center of the whole molecule
+    const Vector center = moldata.property(coords_property)
+                                 .asA<AtomCoords>()
+                                 .array().aaBox().center();
     
-    const quint32 nmols = molecules.nMolecules();
+    return space.getMinimumImage(center, point) - point;
+}
 
-    const Vector &point = p.read().point();
+/** Internal function that recalculates the vectors from the point
+    to all of the molecules in the group, and rebuilds the cells
+    into which the molecules are binned */
+void CloseMols::rebuildCells()
+{
+    mol_deltas = QHash<MolNum,Vector>();
+    mol_cells = QHash<MolNum,qint32>();
+    cells = QVector< QVector<MolNum> >();
+    cell_grid = GridInfo();
+
+    const Molecules &molecules = molgroup.read().molecules();
     
-    const Space &space = spce.read();
+    const int nmols = molecules.nMolecules();
     
+    if (nmols == 0)
+        return;
+    
+    const Vector &point = p.read().point();
+    const Space &space = spce.read();
     const PropertyName &coords_property = map["coordinates"];
     
-    if (nmols <= nclosest)
+    mol_deltas.reserve(nmols);
+    
+    //the grid must always contain the point (which is at the origin)
+    Vector mincoords(0), maxcoords(0);
+    
+    for (Molecules::const_iterator it = molecules.constBegin();
+         it != molecules.constEnd();
+         ++it)
     {
-        //we are selecting all of the molecules
-        close_mols.reserve(nmols);
-        
-        for (Molecules::const_iterator it = molecules.constBegin();
-             it != molecules.constEnd();
-             ++it)
-        {
-            //just get the center of the whole molecule
-            const Vector &center = it->data().property(coords_property)
-                                             .asA<AtomCoords>()
-                                             .array().aaBox().center();
-                                             
-            const double dist = space.calcDist(point, center);
-            close_mols.insert(it.key(), dist);
-        }
+        const Vector delta = getDelta(it->data(), point, space, coords_property);
         
-        cutoff_dist2 = std::numeric_limits<double>::max();
+        mol_deltas.insert(it.key(), delta);
+        mincoords.setMin(delta);
+        maxcoords.setMax(delta);
+    }
+    
+    //choose a cell size that gives a few molecules per cell, without
+    //creating an excessive number of cells for sparse groups
+    const Vector extents = maxcoords - mincoords;
+    
+    const double max_extent = qMax( extents.x(), qMax(extents.y(), extents.z()) );
+    
+    const double volume = qMax(extents.x(), MIN_CELL_SPACING) *
+                          qMax(extents.y(), MIN_CELL_SPACING) *
+                          qMax(extents.z(), MIN_CELL_SPACING);
+    
+    double spacing = std::pow( MOLS_PER_CELL * volume / nmols, 1.0/3.0 );
+    spacing = qMax( spacing, max_extent / MAX_CELLS_PER_DIM );
+    spacing = qMax( spacing, MIN_CELL_SPACING );
+    
+    cell_grid = GridInfo( AABox::from(mincoords, maxcoords),
+                          SireUnits::Dimension::Length(spacing) );
+    
+    cells = QVector< QVector<MolNum> >( cell_grid.nPoints() );
+    mol_cells.reserve(nmols);
+    
+    for (QHash<MolNum,Vector>::const_iterator it = mol_deltas.constBegin();
+         it != mol_deltas.constEnd();
+         ++it)
+    {
+        const qint32 idx = cell_grid.gridToArrayIndex(
+                                        cell_grid.closestIndexTo(it.value()) );
         
-        return this->differentMolecules(old_close_mols);
+        cells[idx].append(it.key());
+        mol_cells.insert(it.key(), idx);
     }
+}
 
-    close_mols.reserve(nclosest);
+/** Internal function that records that the vector from the point to
+    the molecule with number 'molnum' is now 'delta', moving the molecule
+    into its new cell if needed. This returns the distance^2 from the
+    point to the molecule. Molecules that have moved outside of the grid
+    are placed into the closest cell on the edge of the grid, which is
+    closer than their true position, so the search in 'findClosest'
+    remains correct */
+double CloseMols::updateCells(MolNum molnum, const Vector &delta)
+{
+    mol_deltas[molnum] = delta;
 
-    quint32 nfound = 0;
+    const qint32 new_idx = cell_grid.gridToArrayIndex(
+                                        cell_grid.closestIndexTo(delta) );
     
-    for (Molecules::const_iterator it = molecules.constBegin();
-         it != molecules.constEnd();
-         ++it)
+    QHash<MolNum,qint32>::iterator it = mol_cells.find(molnum);
+    
+    if (it == mol_cells.end())
     {
-        //just get the center of the whole molecule
-        const Vector &center = it->data().property(coords_property)
-                                         .asA<AtomCoords>()
-                                         .array().aaBox().center();
-        
-        const double dist2 = space.calcDist2(point, center);
-        
-        if (nfound < nclosest)
+        cells[new_idx].append(molnum);
+        mol_cells.insert(molnum, new_idx);
+    }
+    else if (it.value() != new_idx)
+    {
+        cells[it.value()].removeOne(molnum);
+        cells[new_idx].append(molnum);
+        it.value() = new_idx;
+    }
+    
+    return delta.length2();
+}
+
+/** Internal function that searches outwards through the cells from the
+    point to find the 'n' closest molecules. This returns the distance^2 
+    and number of each molecule, sorted in order of increasing distance 
+    (with the lowest molecule number first for molecules at the
+    same distance) */
+QVector< QPair<double,MolNum> > CloseMols::findClosest(int n) const
+{
+    QVector< QPair<double,MolNum> > closest;
+    
+    if (n <= 0 or mol_deltas.isEmpty())
+        return closest;
+    
+    n = qMin(n, mol_deltas.count());
+    closest.reserve(n);
+    
+    const GridIndex center = cell_grid.closestIndexTo( Vector(0) );
+    
+    const int dimx = cell_grid.dimX();
+    const int dimy = cell_grid.dimY();
+    const int dimz = cell_grid.dimZ();
+    
+    const int nshells = qMax( dimx, qMax(dimy, dimz) );
+    const double spacing = cell_grid.spacing().value();
+    
+    //'closest' is kept as a max-heap, so that the furthest of the
+    //molecules found so far is at the front
+    auto visit = [&](int i, int j, int k)
+    {
+        foreach (const MolNum molnum, cells.at(cell_grid.gridToArrayIndex(i,j,k)))
         {
-            //there is still space for this molecule
-            ++nfound;
-            
-            close_mols.insert(it.key(), std::sqrt(dist2));
+            const QPair<double,MolNum> mol( mol_deltas.value(molnum).length2(),
+                                            molnum );
             
-            if (dist2 > cutoff_dist2)
+            if (closest.count() < n)
             {
-                cutoff_dist2 = dist2;
-                furthest_molnum = it.key();
+                closest.append(mol);
+                std::push_heap(closest.begin(), closest.end());
             }
-            else if (dist2 == cutoff_dist2 and it.key() > furthest_molnum)
+            else if (mol < closest.first())
             {
-                furthest_molnum = it.key();
+                std::pop_heap(closest.begin(), closest.end());
+                closest.last() = mol;
+                std::push_heap(closest.begin(), closest.end());
             }
         }
-        else
+    };
+    
+    for (int shell=0; shell<nshells; ++shell)
+    {
+        //visit only the cells on the surface of this shell
+        for (int i = qMax(0, center.i()-shell); 
+             i <= qMin(dimx-1, center.i()+shell); ++i)
         {
-            //there isn't space - is this molecule closer than one
-            //of the existing molecules?
-            if (dist2 < cutoff_dist2 or
-                (dist2 == cutoff_dist2 and it.key() < furthest_molnum))
+            const bool i_face = std::abs(i - center.i()) == shell;
+        
+            for (int j = qMax(0, center.j()-shell);
+                 j <= qMin(dimy-1, center.j()+shell); ++j)
             {
-                //it is - replace the current furthest molecule with this molecule
-                close_mols.remove(furthest_molnum);
-                close_mols.insert(it.key(), std::sqrt(dist2));
-                
-                this->getNewFurthestMolNum();
+                if (i_face or std::abs(j - center.j()) == shell)
+                {
+                    for (int k = qMax(0, center.k()-shell);
+                         k <= qMin(dimz-1, center.k()+shell); ++k)
+                    {
+                        visit(i, j, k);
+                    }
+                }
+                else
+                {
+                    if (center.k() - shell >= 0)
+                        visit(i, j, center.k()-shell);
+                    
+                    if (shell > 0 and center.k() + shell < dimz)
+                        visit(i, j, center.k()+shell);
+                }
             }
         }
+        
+        //every molecule in the cells beyond this shell is at least 
+        //shell*spacing from the point
+        if (closest.count() == n)
+        {
+            const double min_dist = shell * spacing;
+            
+            if (closest.first().first < min_dist*min_dist)
+                break;
+        }
     }
     
+    std::sort_heap(closest.begin(), closest.end());
+    
+    return closest;
+}
+
+/** Internal function that uses the cells to find the closest molecules
+    to the point, updating 'close_mols', 'furthest_molnum' and 'cutoff_dist2' */
+void CloseMols::findCloseMols()
+{
+    close_mols = QHash<MolNum,double>();
+    furthest_molnum = MolNum();
+    cutoff_dist2 = 0;
+    
+    if (nclosest <= 0)
+        return;
+    
+    const QVector< QPair<double,MolNum> > closest = this->findClosest(nclosest);
+    
+    if (closest.isEmpty())
+        return;
+    
+    close_mols.reserve(closest.count());
+    
+    for (int i=0; i<closest.count(); ++i)
+    {
+        close_mols.insert(closest.at(i).second, std::sqrt(closest.at(i).first));
+    }
+    
+    if (quint32(mol_deltas.count()) <= nclosest)
+    {
+        //we are selecting all of the molecules
+        cutoff_dist2 = std::numeric_limits<double>::max();
+    }
+    else
+    {
+        furthest_molnum = closest.last().second;
+        cutoff_dist2 = closest.last().first;
+    }
+}
+
+/** Internal function that rescans through the molecules to find 
+    the closest ones to the point - this returns whether or not this
+    changes the identity of the close molecules */
+bool CloseMols::recalculate()
+{
+    QHash<MolNum,double> old_close_mols = close_mols;
+
+    if (nclosest <= 0)
+    {
+        //clear the current list
+        close_mols = QHash<MolNum,double>();
+        furthest_molnum = MolNum();
+        cutoff_dist2 = 0;
+        
+        mol_deltas = QHash<MolNum,Vector>();
+        mol_cells = QHash<MolNum,qint32>();
+        cells = QVector< QVector<MolNum> >();
+        cell_grid = GridInfo();
+        
+        return false;
+    }
+
+    this->rebuildCells();
+    this->findCloseMols();
+    
     return this->differentMolecules(old_close_mols);
 }
 
@@ -236,6 +417,9 @@ bool CloseMols::recalculate()
     molecules */
 bool CloseMols::recalculate(MolNum changed_mol)
 {
+    if (nclosest <= 0)
+        return false;
+
     const Molecules &molecules = molgroup.read().molecules();
 
     Molecules::const_iterator it = molecules.constFind(changed_mol);
@@ -243,28 +427,29 @@ bool CloseMols::recalculate(MolNum changed_mol)
     if (it == molecules.constEnd())
         //this molecule is not contained
         return false;
-
-    const Vector &point = p.read().point();
-    const Space &space = spce.read();
-
-    const PropertyName &coords_property = map["coordinates"];
+    
+    if (cells.isEmpty())
+        //the cells have not yet been built
+        return this->recalculate();
 
     //calculate the distance from the new molecule to the point
-    const Vector &center = it->data().property(coords_property)
-                                     .asA<AtomCoords>()
-                                     .array().aaBox().center();
-    
-    const double dist2 = space.calcDist2(point, center);
+    const double dist2 = this->updateCells(changed_mol,
+                                getDelta(it->data(), p.read().point(),
+                                         spce.read(), map["coordinates"]));
     
     //is this already a close molecule?
     if (close_mols.contains(changed_mol))
     {
         if (dist2 > cutoff_dist2 or
             (dist2 == cutoff_dist2 and changed_mol > furthest_molnum))
+        {
             //the molecule has moved beyond the cutoff, so other
-            //molecules in the group may now be closer - we now need
-            //to rescan all molecules
-            return this->recalculate();
+            //molecules in the group may now be closer - search
+            //through the cells to find the new closest molecules
+            QHash<MolNum,double> old_close_mols = close_mols;
+            this->findCloseMols();
+            return this->differentMolecules(old_close_mols);
+        }
         else
         {
             //the molecule has moved, but this cannot affect the order
@@ -310,6 +495,12 @@ bool CloseMols::recalculate(const Molecules &changed_mols)
     
     else if (changed_mols.nMolecules() == 1)
         return this->recalculate( changed_mols.constBegin().key() );
+    
+    else if (nclosest <= 0)
+        return false;
+    
+    else if (cells.isEmpty())
+        return this->recalculate();
 
     const Vector &point = p.read().point();
     const Space &space = spce.read();
@@ -319,6 +510,7 @@ bool CloseMols::recalculate(const Molecules &changed_mols)
     const Molecules &molecules = molgroup.read().molecules();
 
     bool changed_order = false;
+    bool needs_search = false;
 
     QHash<MolNum,double> old_close_mols = close_mols;
 
@@ -328,26 +520,33 @@ bool CloseMols::recalculate(const Molecules &changed_mols)
     {
         const MolNum changed_mol = it.key();
         
-        if (not molecules.contains(changed_mol))
+        Molecules::const_iterator mol = molecules.constFind(changed_mol);
+        
+        if (mol == molecules.constEnd())
             continue;
             
         //calculate the distance from the new molecule to the point
-        const Vector &center = molecules.constFind(changed_mol)
-                                        ->data().property(coords_property)
-                                                .asA<AtomCoords>()
-                                                .array().aaBox().center();
-
-        const double dist2 = space.calcDist2(point, center);
+        const double dist2 = this->updateCells(changed_mol,
+                                    getDelta(mol->data(), point,
+                                             space, coords_property));
+        
+        if (needs_search)
+            //all of the remaining molecules just need to be moved
+            //into their new cells
+            continue;
     
         //is this already a close molecule?
         if (close_mols.contains(changed_mol))
         {
             if (dist2 > cutoff_dist2 or
                 (dist2 == cutoff_dist2 and changed_mol > furthest_molnum))
+            {
                 //the molecule has moved beyond the cutoff, so other
                 //molecules in the group may now be closer - we now need
-                //to rescan all molecules
-                return this->recalculate();
+                //to search through the cells once all of the changed
+                //molecules have been updated
+                needs_search = true;
+            }
             else
             {
                 //the molecule has moved, but this cannot affect the order
@@ -377,7 +576,12 @@ bool CloseMols::recalculate(const Molecules &changed_mols)
         }
     }
     
-    if (changed_order)
+    if (needs_search)
+    {
+        this->findCloseMols();
+        return this->differentMolecules(old_close_mols);
+    }
+    else if (changed_order)
         return this->differentMolecules(old_close_mols);
     else
         return false;
@@ -428,7 +632,9 @@ CloseMols::CloseMols(const CloseMols &other)
             nclosest(other.nclosest), map(other.map), 
             close_mols(other.close_mols),
             furthest_molnum(other.furthest_molnum),
-            cutoff_dist2(other.cutoff_dist2)
+            cutoff_dist2(other.cutoff_dist2),
+            mol_deltas(other.mol_deltas), cell_grid(other.cell_grid),
+            cells(other.cells), mol_cells(other.mol_cells)
 {}
 
 /** Destructor */
@@ -448,6 +654,10 @@ CloseMols& CloseMols::operator=(const CloseMols &other)
         close_mols = other.close_mols;
         furthest_molnum = other.furthest_molnum;
         cutoff_dist2 = other.cutoff_dist2;
+        mol_deltas = other.mol_deltas;
+        cell_grid = other.cell_grid;
+        cells = other.cells;
+        mol_cells = other.mol_cells;
     }
     
     return *this;
@@ -522,6 +732,52 @@ const QHash<MolNum,double>& CloseMols::closeMolecules() const
     return close_mols;
 }
 
+/** Return the numbers of the close molecules, sorted in order
+    of increasing distance from the point */
+QList<MolNum> CloseMols::closestMolecules() const
+{
+    QVector< QPair<double,MolNum> > closest;
+    closest.reserve(close_mols.count());
+    
+    for (QHash<MolNum,double>::const_iterator it = close_mols.constBegin();
+         it != close_mols.constEnd();
+         ++it)
+    {
+        closest.append( QPair<double,MolNum>(it.value(), it.key()) );
+    }
+    
+    std::sort(closest.begin(), closest.end());
+    
+    QList<MolNum> molnums;
+    molnums.reserve(closest.count());
+    
+    for (int i=0; i<closest.count(); ++i)
+    {
+        molnums.append(closest.at(i).second);
+    }
+    
+    return molnums;
+}
+
+/** Return the numbers of the 'n' molecules in the group that are closest
+    to the point, sorted in order of increasing distance. 'n' can be
+    larger than nClosest(), as the molecules are found by searching
+    through the cells around the point */
+QList<MolNum> CloseMols::closestMolecules(int n) const
+{
+    const QVector< QPair<double,MolNum> > closest = this->findClosest(n);
+    
+    QList<MolNum> molnums;
+    molnums.reserve(closest.count());
+    
+    for (int i=0; i<closest.count(); ++i)
+    {
+        molnums.append(closest.at(i).second);
+    }
+    
+    return molnums;
+}
+
 /** Internal function used to update the data for this object from
     the passed system - this returns (via arguments) whether or not
     the location of the point has changed (point_changed), whether
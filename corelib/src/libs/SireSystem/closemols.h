@@ -37,6 +37,7 @@
 
 #include "SireMol/moleculegroup.h"
 #include "SireVol/space.h"
+#include "SireVol/gridinfo.h"
 
 SIRE_BEGIN_HEADER
 
@@ -61,10 +62,19 @@ using SireMol::Molecules;
 
 using SireVol::Space;
 
+using SireMaths::Vector;
+
 using SireBase::PropertyMap;
 
 /** This class is used to maintain a list of the closest molecules
     to a specified point
+
+    The vector from the point to the center of each molecule is cached
+    and binned into a cell list (laid out on a SireVol::GridInfo around
+    the point). Updates that provide a hint of which molecules have
+    changed only recalculate and rebin those molecules, and the closest
+    molecules are then found by searching outwards through the cells
+    from the point, rather than by rescanning every molecule in the group.
     
     @author Christopher Woods
 */
@@ -112,6 +122,9 @@ public:
     
     bool isClose(MolNum molnum) const;
     
+    QList<MolNum> closestMolecules() const;
+    QList<MolNum> closestMolecules(int n) const;
+    
     bool update(const System &system);
     bool update(const System &system, MolNum changed_mol);
     bool update(const System &system, const Molecules &molecules);
@@ -123,6 +136,12 @@ private:
 
     void getNewFurthestMolNum();
 
+    void rebuildCells();
+    double updateCells(MolNum molnum, const Vector &delta);
+    
+    QVector< QPair<double,MolNum> > findClosest(int n) const;
+    void findCloseMols();
+
     bool differentMolecules(const QHash<MolNum,double> &mols) const;
     
     void updateData(const System &system,
@@ -156,6 +175,21 @@ private:
     
     /** The distance^2 from the point to the furthest recorded molecule */
     double cutoff_dist2;
+    
+    /** The (minimum image) vector from the point to the center
+        of each molecule in the group */
+    QHash<MolNum,Vector> mol_deltas;
+    
+    /** The grid that defines the cells used to bin the molecules.
+        The grid is centered on the point, with the molecules binned
+        into the cell of the closest grid point to 'mol_deltas' */
+    SireVol::GridInfo cell_grid;
+    
+    /** The numbers of the molecules in each cell */
+    QVector< QVector<MolNum> > cells;
+    
+    /** The index of the cell containing each molecule */
+    QHash<MolNum,qint32> mol_cells;
 };
 
 /** Return whether or not the molecule with number 'molnum' is
@@ -27,6 +27,9 @@
 \*********************************************/
 
 #include <QVarLengthArray>
+#include <QSet>
+
+#include <algorithm>
 
 #include "identityconstraint.h"
 #include "system.h"
@@ -241,6 +244,7 @@ private:
     void recalculateDistances(const Molecules &molecules);
 
     void assignMoleculesToPoints();
+    QVector<int> sparseAssignMoleculesToPoints();
 
     /** The (squared) distances between all molecules and all points */
     QHash<MolNum,NVector> point_distances;
@@ -250,6 +254,26 @@ private:
         nth molecule is assigned to the nth point */
     QVector<int> mol_to_point;
     
+    /** The numbers of the molecules (in group order) used for the
+        last sparse assignment. The sparse assignment is only 
+        warm-started if the molecules are unchanged */
+    QVector<MolNum> sparse_molnums;
+    
+    /** The indicies of the candidate points of each molecule
+        in the sparse assignment */
+    QVector< QVector<int> > candidate_points;
+    
+    /** The assignment of each molecule to a point from the last
+        sparse assignment */
+    QVector<int> sparse_assignment;
+    
+    /** The prices of each point from the last sparse assignment */
+    QVector<double> point_prices;
+    
+    /** The molecules whose distances have changed since the
+        last assignment */
+    QSet<MolNum> moved_mols;
+    
     /** Whether or not the set of distances have changed since the
         last time the constraint was applied - if they have, then
         the order of molecules needs to be recalculated */
@@ -1834,6 +1858,11 @@ ManyPointsHelper::ManyPointsHelper(const ManyPointsHelper &other)
                  : IdentityConstraintPvt(other),
                    point_distances(other.point_distances),
                    mol_to_point(other.mol_to_point),
+                   sparse_molnums(other.sparse_molnums),
+                   candidate_points(other.candidate_points),
+                   sparse_assignment(other.sparse_assignment),
+                   point_prices(other.point_prices),
+                   moved_mols(other.moved_mols),
                    distances_changed(other.distances_changed)
 {}
 
@@ -1891,6 +1920,7 @@ void ManyPointsHelper::recalculateDistances(MolNum molnum)
     if (these_distances_changed)
     {
         point_distances.insert(molnum, distances);
+        moved_mols.insert(molnum);
         distances_changed = true;
     }
 }
@@ -1956,6 +1986,7 @@ void ManyPointsHelper::recalculateDistances(const Molecules &new_molecules)
         if (these_distances_changed)
         {
             point_distances.insert(molnum, distances);
+            moved_mols.insert(molnum);
             distances_changed = true;
         }
     }
@@ -1967,6 +1998,10 @@ void ManyPointsHelper::recalculateDistances()
 {
     point_distances = QHash<MolNum,NVector>();
     
+    //all distances have changed, so the sparse assignment cannot be warm-started
+    sparse_molnums = QVector<MolNum>();
+    moved_mols.clear();
+    
     const Molecules &molecules = this->moleculeGroup().molecules();
     
     point_distances.reserve(molecules.nMolecules());
@@ -2008,6 +2043,165 @@ void ManyPointsHelper::recalculateDistances()
     distances_changed = true;
 }
 
+/** The minimum number of points for which the sparse assignment is used */
+static const int MIN_SPARSE_POINTS = 32;
+
+/** The number of closest points that are initially used as candidates
+    for each molecule in the sparse assignment */
+static const int N_CANDIDATE_POINTS = 8;
+
+/** Return the indicies of the 'n' smallest values in the passed array */
+static QVector<int> getClosestPoints(const double *distances, int npoints, int n)
+{
+    QVector< QPair<double,int> > dists(npoints);
+    
+    for (int i=0; i<npoints; ++i)
+    {
+        dists[i] = QPair<double,int>(distances[i], i);
+    }
+    
+    n = qMin(n, npoints);
+    
+    std::partial_sort( dists.begin(), dists.begin() + n, dists.end() );
+    
+    QVector<int> closest(n);
+    
+    for (int i=0; i<n; ++i)
+    {
+        closest[i] = dists.at(i).second;
+    }
+    
+    return closest;
+}
+
+/** This function works out the optimum assignment of molecules to
+    points using a sparse assignment, in which each molecule is only
+    considered for its closest points. The assignment is warm-started
+    from the previous assignment, so that only the molecules that have
+    moved since then need to be re-matched. The assignment is checked
+    against the distances to all of the points, and any molecule that 
+    would be better assigned to a point that is not one of its candidates
+    has that point added, and the assignment is repeated. This means that
+    the result is the same as the full assignment, but costs much less 
+    than O(N^3). This returns the assignment of each molecule to a point, 
+    or an empty array if a sparse assignment was not possible */
+QVector<int> ManyPointsHelper::sparseAssignMoleculesToPoints()
+{
+    const QVector<MolNum> &molnums = this->moleculeGroup().molNums();
+    const MolNum *molnums_array = molnums.constData();
+    
+    const int n = molnums.count();
+    
+    //get the distances between each molecule and all of the points
+    QVector<const double*> distances(n);
+    
+    for (int i=0; i<n; ++i)
+    {
+        QHash<MolNum,NVector>::const_iterator 
+                                    it = point_distances.constFind(molnums_array[i]);
+                                                
+        BOOST_ASSERT( it != point_distances.constEnd() );
+        BOOST_ASSERT( it.value().count() == n );
+        
+        distances[i] = it.value().constData();
+    }
+    
+    if (sparse_molnums != molnums)
+    {
+        //the molecules have changed, so start the assignment from scratch
+        sparse_molnums = molnums;
+        candidate_points = QVector< QVector<int> >(n);
+        sparse_assignment = QVector<int>();
+        point_prices = QVector<double>();
+    }
+    else
+    {
+        //only the molecules that have moved need to be re-matched
+        for (int i=0; i<n; ++i)
+        {
+            if (moved_mols.contains(molnums_array[i]))
+            {
+                candidate_points[i] = QVector<int>();
+                sparse_assignment[i] = -1;
+            }
+        }
+    }
+    
+    moved_mols.clear();
+    
+    for (int i=0; i<n; ++i)
+    {
+        if (candidate_points.at(i).isEmpty())
+            candidate_points[i] = ::getClosestPoints(distances[i], n, N_CANDIDATE_POINTS);
+    }
+    
+    //the assignment is within n*epsilon (A^2) of the optimum
+    const double epsilon = 1.0e-4 / n;
+    
+    while (true)
+    {
+        QVector< QVector<double> > costs(n);
+        
+        for (int i=0; i<n; ++i)
+        {
+            const QVector<int> &candidates = candidate_points.at(i);
+            QVector<double> c(candidates.count());
+            
+            for (int k=0; k<candidates.count(); ++k)
+            {
+                c[k] = distances[i][ candidates.at(k) ];
+            }
+            
+            costs[i] = c;
+        }
+        
+        if (not solve_sparse_linear_assignment(candidate_points, costs,
+                                               sparse_assignment, point_prices,
+                                               epsilon))
+        {
+            //there is no assignment using only the candidate points
+            sparse_molnums = QVector<MolNum>();
+            return QVector<int>();
+        }
+        
+        //check that no molecule would be better assigned to a point that
+        //is not one of its candidates
+        const double *prices = point_prices.constData();
+        bool is_optimal = true;
+        
+        for (int i=0; i<n; ++i)
+        {
+            const int j = sparse_assignment.at(i);
+            
+            double best = distances[i][j] + prices[j] - epsilon;
+            int best_k = -1;
+            
+            for (int k=0; k<n; ++k)
+            {
+                const double val = distances[i][k] + prices[k];
+                
+                if (val < best)
+                {
+                    best = val;
+                    best_k = k;
+                }
+            }
+            
+            if (best_k != -1)
+            {
+                candidate_points[i].append(best_k);
+                sparse_assignment[i] = -1;
+                is_optimal = false;
+            }
+        }
+        
+        if (is_optimal)
+            break;
+    }
+    
+    return sparse_assignment;
+}
+
 /** This function uses the distances between all points and molecules
     stored in 'point_distances' to work out the optimum assignment
     of molecules to points such that the total distance between
@@ -2030,83 +2224,95 @@ void ManyPointsHelper::assignMoleculesToPoints()
 
     const int npoints = identity_points.count();
     
-    //construct the matrix that contains the distances between every
-    //molecule and every point - one molecule per row, one point
-    //per column - this has to be a square matrix, so missing rows/columns
-    //are given a value of 0
-    NMatrix distmatrix;
+    QVector<int> point_to_mol;
     
-    if (nmols == npoints)
+    if (nmols == npoints and npoints >= MIN_SPARSE_POINTS)
     {
-        distmatrix = NMatrix(nmols, nmols);
-        distmatrix.transpose(); // change to row-major memory order
-        
-        for (int i=0; i<nmols; ++i)
+        //there are lots of molecules - use the sparse, warm-started
+        //assignment, which only needs to re-match the molecules that have moved
+        point_to_mol = this->sparseAssignMoleculesToPoints();
+    }
+    
+    if (point_to_mol.isEmpty())
+    {
+        //construct the matrix that contains the distances between every
+        //molecule and every point - one molecule per row, one point
+        //per column - this has to be a square matrix, so missing rows/columns
+        //are given a value of 0
+        NMatrix distmatrix;
+    
+        if (nmols == npoints)
         {
-            const MolNum &molnum = molnums_array[i];
+            distmatrix = NMatrix(nmols, nmols);
+            distmatrix.transpose(); // change to row-major memory order
+        
+            for (int i=0; i<nmols; ++i)
+            {
+                const MolNum &molnum = molnums_array[i];
             
-            QHash<MolNum,NVector>::const_iterator 
-                                       it = point_distances.constFind(molnum);
+                QHash<MolNum,NVector>::const_iterator 
+                                           it = point_distances.constFind(molnum);
                                                 
-            BOOST_ASSERT( it != point_distances.constEnd() );
+                BOOST_ASSERT( it != point_distances.constEnd() );
             
-            distmatrix.setRow(i, it.value());
+                distmatrix.setRow(i, it.value());
+            }
         }
-    }
-    else if (nmols > npoints)
-    {
-        //there are more molecules than points - we create some extra
-        //points which have zero distance to all molecules
-        distmatrix = NMatrix(nmols, nmols);
-        distmatrix.transpose(); // change to row-major memory order
+        else if (nmols > npoints)
+        {
+            //there are more molecules than points - we create some extra
+            //points which have zero distance to all molecules
+            distmatrix = NMatrix(nmols, nmols);
+            distmatrix.transpose(); // change to row-major memory order
         
-        const int nzeroes = nmols - npoints;
+            const int nzeroes = nmols - npoints;
 
-        NVector new_row(npoints + nzeroes, 0.0);
+            NVector new_row(npoints + nzeroes, 0.0);
         
-        for (int i=0; i<nmols; ++i)
-        {
-            const MolNum &molnum = molnums_array[i];
+            for (int i=0; i<nmols; ++i)
+            {
+                const MolNum &molnum = molnums_array[i];
             
-            QHash<MolNum,NVector>::const_iterator 
-                                     it = point_distances.constFind(molnum);
+                QHash<MolNum,NVector>::const_iterator 
+                                         it = point_distances.constFind(molnum);
                                                 
-            BOOST_ASSERT( it != point_distances.constEnd() );
+                BOOST_ASSERT( it != point_distances.constEnd() );
             
-            const NVector &distances = it.value();
+                const NVector &distances = it.value();
             
-            BOOST_ASSERT( distances.count() == npoints );
+                BOOST_ASSERT( distances.count() == npoints );
             
-            memcpy( new_row.data(), distances.constData(), npoints*sizeof(double) );
+                memcpy( new_row.data(), distances.constData(), npoints*sizeof(double) );
 
-            distmatrix.setRow(i, new_row);
+                distmatrix.setRow(i, new_row);
+            }
         }
-    }
-    else
-    {
-        //there are more points than molecules - we create some extra
-        //molecules that are all equally a very long way from all of the points
-        distmatrix = NMatrix(npoints, npoints, std::numeric_limits<double>::max());
-        distmatrix.transpose(); // change to row-major memory order
-
-        //copy the distances to the real molecules
-        for (int i=0; i<nmols; ++i)
+        else
         {
-            const MolNum &molnum = molnums_array[i];
+            //there are more points than molecules - we create some extra
+            //molecules that are all equally a very long way from all of the points
+            distmatrix = NMatrix(npoints, npoints, std::numeric_limits<double>::max());
+            distmatrix.transpose(); // change to row-major memory order
+
+            //copy the distances to the real molecules
+            for (int i=0; i<nmols; ++i)
+            {
+                const MolNum &molnum = molnums_array[i];
             
-            QHash<MolNum,NVector>::const_iterator 
-                                        it = point_distances.constFind(molnum);
+                QHash<MolNum,NVector>::const_iterator 
+                                            it = point_distances.constFind(molnum);
                                                 
-            BOOST_ASSERT( it != point_distances.constEnd() );
+                BOOST_ASSERT( it != point_distances.constEnd() );
             
-            distmatrix.setRow(i, it.value());
+                distmatrix.setRow(i, it.value());
+            }
         }
-    }
 
-    //now calculate optimum assignment of molecules to points that
-    //minimises the total distance between each molecule and its
-    //assigned point
-    QVector<int> point_to_mol = solve_linear_assignment(distmatrix);
+        //now calculate optimum assignment of molecules to points that
+        //minimises the total distance between each molecule and its
+        //assigned point
+        point_to_mol = solve_linear_assignment(distmatrix);
+    }
     
     //point_to_mol maps points to molecules - we need to swap this
     //so that mol_to_point maps molecules to points
@@ -50,8 +50,11 @@
 #include "SireMol/molecules.h"
 #include "SireMol/moleculegroup.h"
 #include "SireMol/atomcoords.h"
+#include "SireMol/moleditor.h"
+#include "SireMol/cgatomidx.h"
 
 #include "SireBase/savestate.h"
+#include "SireBase/parallel.h"
 
 #include "SireMol/errors.h"
 #include "SireError/errors.h"
@@ -2865,6 +2868,229 @@ void System::update(const MoleculeGroup &molgroup, bool auto_commit)
     this->update(molgroup.molecules(), auto_commit);
 }
 
+/** Pack the coordinates of all of the molecules in this system into
+    a single, contiguous arena, and update the molecules so that they
+    hold their coordinates in that arena (so that no extra memory is used).
+    This returns the PackedCoords view of the arena, which can be used
+    for fast passes over all of the coordinates in the system. Note that
+    this updates the molecules, so the forcefields will see them as
+    having changed */
+PackedCoords System::packCoordinates(const PropertyMap &map)
+{
+    Molecules mols = this->molecules();
+    
+    PackedCoords packed(mols, map);
+    
+    if (not packed.isEmpty())
+        this->update( packed.pack(mols) );
+    
+    return packed;
+}
+
+/** Return the molecules whose numbers are in 'molnums', checking that
+    each has an AtomCoords coordinates property called 'coords_property'
+    
+    \throw SireMol::missing_molecule
+    \throw SireBase::missing_property
+    \throw SireError::invalid_cast
+*/
+static QVector<Molecule> getMoleculesToMove(const System &system,
+                                            const QVector<MolNum> &molnums,
+                                            const PropertyName &coords_property)
+{
+    QVector<Molecule> mols(molnums.count());
+    Molecule *mols_array = mols.data();
+    
+    for (int i=0; i<molnums.count(); ++i)
+    {
+        mols_array[i] = system.at(molnums.at(i)).molecule();
+        mols_array[i].property(coords_property).asA<AtomCoords>();
+    }
+    
+    return mols;
+}
+
+/** Update the coordinates of the molecules whose numbers are in 'molnums'
+    from the passed flat (structure of arrays) coordinates. 'x', 'y' and
+    'z' hold the x, y and z coordinates (in angstroms) of each atom of 
+    each molecule, with the atoms of each molecule in AtomIdx order, and 
+    the molecules in the order in 'molnums'. Each must hold one value for
+    every atom in the molecules.
+    
+    This is much quicker than moving each molecule in turn, as the
+    new versions of the molecules are created in parallel, and are
+    then updated in the system in a single pass (so that each
+    molecule group is only given a single new version). This is
+    designed to copy coordinates back from an integrator or an 
+    external MD engine.
+    
+    \throw SireMol::missing_molecule
+    \throw SireBase::missing_property
+    \throw SireError::invalid_cast
+    \throw SireError::incompatible_error
+*/
+void System::updateCoordinates(const QVector<MolNum> &molnums,
+                               const QVector<double> &x, const QVector<double> &y,
+                               const QVector<double> &z,
+                               const PropertyMap &map, bool auto_commit)
+{
+    if (x.count() != y.count() or x.count() != z.count())
+        throw SireError::incompatible_error( QObject::tr(
+                "Cannot update the coordinates as the number of x (%1), "
+                "y (%2) and z (%3) values are not the same.")
+                    .arg(x.count()).arg(y.count()).arg(z.count()), CODELOC );
+
+    const int nmols = molnums.count();
+    
+    if (nmols == 0)
+        return;
+    
+    const PropertyName coords_property = map["coordinates"];
+    
+    QVector<Molecule> mols = getMoleculesToMove(*this, molnums, coords_property);
+    Molecule *mols_array = mols.data();
+    
+    //find the index of the first atom of each molecule
+    QVector<int> offsets(nmols+1, 0);
+    int *offsets_array = offsets.data();
+    
+    for (int i=0; i<nmols; ++i)
+    {
+        offsets_array[i+1] = offsets_array[i] + mols_array[i].nAtoms();
+    }
+    
+    if (offsets_array[nmols] != x.count())
+        throw SireError::incompatible_error( QObject::tr(
+                "Cannot update the coordinates as the number of coordinates "
+                "passed (%1) does not equal the number of atoms in "
+                "the %2 molecule(s) (%3).")
+                    .arg(x.count()).arg(nmols).arg(offsets_array[nmols]), CODELOC );
+    
+    const double *x_array = x.constData();
+    const double *y_array = y.constData();
+    const double *z_array = z.constData();
+    
+    auto update_coords = [&](int i)
+    {
+        const MoleculeInfoData &molinfo = mols_array[i].data().info();
+        const int nats = molinfo.nAtoms();
+        const int start = offsets_array[i];
+        
+        QVector< QVector<SireMaths::Vector> > coords(molinfo.nCutGroups());
+        
+        for (int j=0; j<molinfo.nCutGroups(); ++j)
+        {
+            coords[j] = QVector<SireMaths::Vector>(molinfo.nAtoms(CGIdx(j)));
+        }
+        
+        for (int j=0; j<nats; ++j)
+        {
+            const CGAtomIdx &cgatomidx = molinfo.cgAtomIdx(AtomIdx(j));
+            
+            coords[cgatomidx.cutGroup()][cgatomidx.atom()] 
+                        = SireMaths::Vector(x_array[start+j], y_array[start+j],
+                                            z_array[start+j]);
+        }
+        
+        mols_array[i] = mols_array[i].edit()
+                            .setProperty(coords_property,
+                                         AtomCoords(SireVol::CoordGroupArray(coords)))
+                            .commit();
+    };
+    
+    if (nmols > 1)
+    {
+        tbb::parallel_for( tbb::blocked_range<int>(0,nmols),
+                           [&](const tbb::blocked_range<int> &r)
+        {
+            for (int i=r.begin(); i<r.end(); ++i)
+            {
+                update_coords(i);
+            }
+        });
+    }
+    else
+    {
+        update_coords(0);
+    }
+    
+    this->update( Molecules(mols), auto_commit );
+}
+
+/** Update the coordinates of all of the molecules in the arena 'coords'
+    so that they are equal to those in the arena (e.g. after they have
+    been set using PackedCoords::setCoordinates). The molecules
+    share their coordinates with the arena, so no extra memory is used.
+    All of the molecules are updated in a single pass, so each
+    molecule group is only given a single new version.
+    
+    \throw SireMol::missing_molecule
+    \throw SireBase::missing_property
+    \throw SireError::invalid_cast
+    \throw SireError::incompatible_error
+*/
+void System::updateCoordinates(const PackedCoords &coords, bool auto_commit)
+{
+    const int nmols = coords.nMolecules();
+    
+    if (nmols == 0)
+        return;
+    
+    const PropertyName &coords_property = coords.coordinatesProperty();
+    
+    QVector<Molecule> mols = getMoleculesToMove(*this, coords.molNums(), coords_property);
+    Molecule *mols_array = mols.data();
+    
+    const SireVol::CoordGroupArray *arrays = coords.coordinates().constData();
+    
+    //check that each molecule has the same layout as its coordinates in the arena
+    for (int i=0; i<nmols; ++i)
+    {
+        const MoleculeInfoData &molinfo = mols_array[i].data().info();
+        
+        bool compatible = (molinfo.nCutGroups() == arrays[i].count());
+        
+        for (int j=0; compatible and j<molinfo.nCutGroups(); ++j)
+        {
+            compatible = (molinfo.nAtoms(CGIdx(j)) == arrays[i].at(j).count());
+        }
+        
+        if (not compatible)
+            throw SireError::incompatible_error( QObject::tr(
+                    "Cannot update the coordinates of molecule %1 as its layout "
+                    "(%2 atoms in %3 CutGroups) is different to that of its "
+                    "coordinates in the arena (%4 atoms in %5 CutGroups).")
+                        .arg(mols_array[i].number().toString())
+                        .arg(molinfo.nAtoms()).arg(molinfo.nCutGroups())
+                        .arg(arrays[i].nCoords()).arg(arrays[i].count()), CODELOC );
+    }
+    
+    auto update_coords = [&](int i)
+    {
+        mols_array[i] = mols_array[i].edit()
+                            .setProperty(coords_property, AtomCoords(arrays[i]))
+                            .commit();
+    };
+    
+    if (nmols > 1)
+    {
+        tbb::parallel_for( tbb::blocked_range<int>(0,nmols),
+                           [&](const tbb::blocked_range<int> &r)
+        {
+            for (int i=r.begin(); i<r.end(); ++i)
+            {
+                update_coords(i);
+            }
+        });
+    }
+    else
+    {
+        update_coords(0);
+    }
+    
+    this->update( Molecules(mols), auto_commit );
+}
+
 /** Set the contents of the molecule group(s) identified by the ID 'mgid'
     so that they contain just the view of the molecule in 'molview'.
     The version of the molecule already present in this set is used if 
@@ -40,6 +40,7 @@
 #include "SireMol/moleculegroup.h"
 #include "SireMol/moleculegroups.h"
 #include "SireMol/mgnum.h"
+#include "SireMol/packedcoords.h"
 
 #include "SireFF/forcefields.h"
 
@@ -84,6 +85,7 @@ using SireMol::MoleculeData;
 using SireMol::MoleculeView;
 using SireMol::ViewsOfMol;
 using SireMol::Molecules;
+using SireMol::PackedCoords;
 
 using SireVol::Space;
 using SireVol::Space;
@@ -410,6 +412,15 @@ public:
     void update(const MoleculeData &moldata, bool auto_commit=true);
     void update(const Molecules &molecules, bool auto_commit=true);
     void update(const MoleculeGroup &molgroup, bool auto_commit=true);
+
+    PackedCoords packCoordinates(const PropertyMap &map = PropertyMap());
+
+    void updateCoordinates(const QVector<MolNum> &molnums,
+                           const QVector<double> &x, const QVector<double> &y,
+                           const QVector<double> &z,
+                           const PropertyMap &map = PropertyMap(),
+                           bool auto_commit=true);
+    void updateCoordinates(const PackedCoords &coords, bool auto_commit=true);
     
     void setContents(const MGID &mgid, const MoleculeView &molview,
                      const PropertyMap &map);
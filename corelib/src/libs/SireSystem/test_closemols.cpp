@@ -0,0 +1,257 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "SireSystem/closemols.h"
+#include "SireSystem/system.h"
+
+#include "SireFF/point.h"
+
+#include "SireMol/molecule.h"
+#include "SireMol/moleculedata.h"
+#include "SireMol/moleculegroup.h"
+#include "SireMol/molecules.h"
+#include "SireMol/moleditor.h"
+#include "SireMol/atomeditor.h"
+#include "SireMol/cgeditor.h"
+#include "SireMol/atomcoords.h"
+#include "SireMol/mover.hpp"
+
+#include "SireVol/cartesian.h"
+#include "SireVol/periodicbox.h"
+#include "SireVol/coordgroup.h"
+
+#include "SireMaths/rangenerator.h"
+
+#include "SireBase/unittest.h"
+
+#include <QDebug>
+
+#include <algorithm>
+
+using namespace SireSystem;
+using namespace SireFF;
+using namespace SireMol;
+using namespace SireVol;
+using namespace SireMaths;
+using namespace SireBase;
+
+/** The number of molecules in the group */
+static const int nmols = 400;
+
+/** The number of close molecules to record */
+static const int nclose = 10;
+
+/** The size of the box in which the molecules are placed */
+static const double box_size = 30.0;
+
+/** Return a molecule with two atoms, at 'center' +/- 'bond' */
+static Molecule createMolecule(const Vector &center, const Vector &bond)
+{
+    MolStructureEditor editor;
+
+    CGStructureEditor cgroup = editor.add( CGName("1") );
+
+    for (int i=0; i<2; ++i)
+    {
+        AtomStructureEditor atom = editor.add( AtomNum(i+1) );
+        atom = atom.rename( AtomName(QString("X%1").arg(i+1)) );
+        atom = atom.reparent( cgroup.index() );
+    }
+
+    Molecule mol = editor.commit();
+
+    QVector< QVector<Vector> > cgcoords(1);
+    cgcoords[0].append( center + bond );
+    cgcoords[0].append( center - bond );
+
+    return mol.edit().setProperty("coordinates", AtomCoords(CoordGroupArray(cgcoords)))
+                     .commit();
+}
+
+/** Return a random vector with each component in [-maxval,maxval] */
+static Vector randomVector(RanGenerator &rand, double maxval)
+{
+    return Vector( rand.rand(-maxval, maxval),
+                   rand.rand(-maxval, maxval),
+                   rand.rand(-maxval, maxval) );
+}
+
+/** Return the distance from 'point' to the center of every molecule in
+    'molgroup', found by scanning through all of the molecules, sorted 
+    in order of increasing distance */
+static QVector< QPair<double,MolNum> > bruteForce(const MoleculeGroup &molgroup,
+                                                  const Vector &point,
+                                                  const Space &space)
+{
+    QVector< QPair<double,MolNum> > dists;
+
+    const Molecules &molecules = molgroup.molecules();
+
+    for (Molecules::const_iterator it = molecules.constBegin();
+         it != molecules.constEnd();
+         ++it)
+    {
+        const Vector center = it->data().property("coordinates")
+                                        .asA<AtomCoords>().array().aaBox().center();
+
+        dists.append( QPair<double,MolNum>(space.calcDist(center, point), it.key()) );
+    }
+
+    std::sort(dists.begin(), dists.end());
+
+    return dists;
+}
+
+/** Return the numbers of the first 'n' molecules in 'dists' */
+static QList<MolNum> firstMolNums(const QVector< QPair<double,MolNum> > &dists, int n)
+{
+    QList<MolNum> molnums;
+
+    for (int i=0; i < qMin(n, dists.count()); ++i)
+    {
+        molnums.append(dists.at(i).second);
+    }
+
+    return molnums;
+}
+
+/** Assert that 'closemols' agrees with a brute-force scan of the
+    molecule group in 'system' */
+static void assert_matches(const CloseMols &closemols, const System &system,
+                           const MGName &mgname, const Vector &point,
+                           const Space &space)
+{
+    const QVector< QPair<double,MolNum> > dists = bruteForce(system[mgname], 
+                                                             point, space);
+
+    assert_equal( closemols.closestMolecules(), firstMolNums(dists, nclose), CODELOC );
+    assert_equal( closemols.closeMolecules().count(), nclose, CODELOC );
+
+    for (int i=0; i<nclose; ++i)
+    {
+        const MolNum molnum = dists.at(i).second;
+
+        assert_true( closemols.isClose(molnum), CODELOC );
+        assert_nearly_equal( closemols.closeMolecules().value(molnum),
+                             dists.at(i).first, 1e-9, CODELOC );
+    }
+
+    assert_true( not closemols.isClose(dists.at(nclose).second), CODELOC );
+
+    //the n-nearest query can look beyond the close molecules
+    const int ns[] = { 0, 1, 7, 50, nmols, nmols+5 };
+
+    for (const int n : ns)
+    {
+        assert_equal( closemols.closestMolecules(n), firstMolNums(dists, n), CODELOC );
+    }
+}
+
+void test_closemols(bool verbose)
+{
+    RanGenerator rand(2468);
+
+    const Vector point(12, 17, 9);
+
+    QList<SpacePtr> spaces;
+    spaces.append( Cartesian() );
+    spaces.append( PeriodicBox(Vector(box_size)) );
+
+    foreach (const SpacePtr &space, spaces)
+    {
+        const MGName mgname("solvent");
+
+        MoleculeGroup molgroup("solvent");
+
+        for (int i=0; i<nmols; ++i)
+        {
+            molgroup.add( createMolecule( randomVector(rand, 0.5*box_size) 
+                                            + Vector(0.5*box_size),
+                                          randomVector(rand, 1.0) ) );
+        }
+
+        System system;
+        system.add(molgroup);
+        system.setProperty("space", space.read());
+
+        CloseMols closemols( PointRef(point), system[mgname], space.read(), nclose );
+
+        assert_matches(closemols, system, mgname, point, space.read());
+
+        for (int step=0; step<200; ++step)
+        {
+            const QSet<MolNum> old_close = closemols.closeMolecules().keys().toSet();
+
+            //move one or more random molecules. Small moves shuffle the
+            //order, while large moves take molecules through (and, for
+            //the cartesian space, out of) the grid of cells
+            const int nmoved = 1 + rand.randInt(2);
+            Molecules moved;
+
+            for (int i=0; i<nmoved; ++i)
+            {
+                const MolNum molnum = system[mgname].molNumAt( rand.randInt(nmols-1) );
+
+                if (moved.contains(molnum))
+                    continue;
+
+                const double maxdelta = rand.randBool() ? 1.0 : box_size;
+
+                Molecule mol = system[molnum].molecule();
+                mol = mol.move().translate( randomVector(rand, maxdelta) ).commit();
+
+                system.update(mol.data());
+                moved.add(mol);
+            }
+
+            bool changed;
+
+            if (moved.nMolecules() == 1)
+                changed = closemols.update(system, moved.constBegin().key());
+            else
+                changed = closemols.update(system, moved);
+
+            if (verbose)
+                qDebug() << space.read().what() << step << changed
+                         << Sire::toString(closemols.closestMolecules());
+
+            assert_matches(closemols, system, mgname, point, space.read());
+
+            const QSet<MolNum> new_close = closemols.closeMolecules().keys().toSet();
+
+            assert_equal( changed, new_close != old_close, CODELOC );
+        }
+
+        //a full update without a hint agrees with the incremental updates
+        CloseMols rebuilt( PointRef(point), system[mgname], space.read(), nclose );
+
+        assert_equal( rebuilt.closestMolecules(), closemols.closestMolecules(), CODELOC );
+    }
+}
+
+SIRE_UNITTEST( test_closemols )
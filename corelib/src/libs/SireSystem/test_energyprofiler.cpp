@@ -0,0 +1,356 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "SireSystem/system.h"
+
+#include "SireFF/energyprofiler.h"
+
+#include "SireMM/interff.h"
+#include "SireMM/atomljs.h"
+#include "SireMM/ljparameter.h"
+
+#include "SireMol/molecule.h"
+#include "SireMol/moleculedata.h"
+#include "SireMol/moleculeinfodata.h"
+#include "SireMol/moleculegroup.h"
+#include "SireMol/moleditor.h"
+#include "SireMol/atomeditor.h"
+#include "SireMol/cgeditor.h"
+#include "SireMol/atomcoords.h"
+#include "SireMol/atomcharges.h"
+#include "SireMol/mover.hpp"
+
+#include "SireVol/coordgroup.h"
+
+#include "SireMaths/rangenerator.h"
+
+#include "SireUnits/units.h"
+
+#include "SireBase/unittest.h"
+
+#include <QDebug>
+
+#include <cmath>
+
+using namespace SireSystem;
+using namespace SireFF;
+using namespace SireMM;
+using namespace SireMol;
+using namespace SireVol;
+using namespace SireMaths;
+using namespace SireUnits;
+using namespace SireBase;
+
+/** The number of molecules in the system */
+static const int nmols = 12;
+
+/** Return a charged three-atom molecule around 'center' */
+static Molecule createMolecule(const Vector &center, RanGenerator &rand)
+{
+    MolStructureEditor editor;
+
+    CGStructureEditor cgroup = editor.add( CGName("0") );
+
+    for (int i=0; i<3; ++i)
+    {
+        AtomStructureEditor atom = editor.add( AtomNum(i+1) );
+        atom = atom.rename( AtomName(QString("X%1").arg(i+1)) );
+        atom = atom.reparent( cgroup.index() );
+    }
+
+    Molecule mol = editor.commit();
+
+    const MoleculeInfoData &molinfo = mol.data().info();
+
+    AtomCharges charges(molinfo, 0*mod_electron);
+    AtomLJs ljs(molinfo);
+
+    QVector<Vector> coords;
+
+    for (int i=0; i<3; ++i)
+    {
+        const CGAtomIdx cgatomidx( CGIdx(0), Index(i) );
+
+        charges.set( cgatomidx, ((i == 0) ? -0.8 : 0.4)*mod_electron );
+        ljs.set( cgatomidx, LJParameter(3.0*angstrom, 0.15*kcal_per_mol) );
+
+        if (i == 0)
+            coords.append(center);
+        else
+            coords.append( center + rand.vectorOnSphere(1.0) );
+    }
+
+    QVector< QVector<Vector> > cgcoords;
+    cgcoords.append(coords);
+
+    return mol.edit().setProperty("coordinates", AtomCoords(CoordGroupArray(cgcoords)))
+                     .setProperty("charge", charges)
+                     .setProperty("LJ", ljs)
+                     .commit();
+}
+
+/** Assert that the profile of the forcefield called 'ffname' has recorded
+    'nevals' recalculations, of which 'nfull' were from scratch and
+    'ndelta' used only the change in energy */
+static void assert_profile(const EnergyProfile &profile, const QString &ffname,
+                           qint64 nevals, qint64 nfull, qint64 ndelta, QString codeloc)
+{
+    assert_equal( profile.nEvaluations(ffname), nevals, codeloc );
+    assert_equal( profile.nFullCalculations(ffname), nfull, codeloc );
+    assert_equal( profile.nDeltaCalculations(ffname), ndelta, codeloc );
+}
+
+/** Move the molecule with number 'molnum' in 'system', and
+    return the energy of the system */
+static double moveMolecule(System &system, MolNum molnum, const Vector &delta)
+{
+    system.update( system[molnum].molecule().move().translate(delta).commit() );
+    return system.energy().value();
+}
+
+/** Check that the EnergyProfiler records the full and delta recalculations
+    and the pair counts of each forcefield in a System against the name
+    of that forcefield, that nested timers are attributed to the right
+    forcefield, and that nothing is recorded when profiling is disabled */
+void test_energyprofiler(bool verbose)
+{
+    RanGenerator rand(8135);
+
+    //all molecules are in 'all', and the even molecules are also in 'even'
+    MoleculeGroup all("all");
+    MoleculeGroup even("even");
+
+    for (int i=0; i<nmols; ++i)
+    {
+        const Vector center( 4.0*(i % 3), 4.0*((i / 3) % 2), 4.0*(i / 6) );
+
+        const Molecule mol = createMolecule(center, rand);
+
+        all.add(mol);
+
+        if (i % 2 == 0)
+            even.add(mol);
+    }
+
+    //one forcefield uses the parallel CLJCalculator, and the other the
+    //serial box loops, as both report the number of box pairs
+    InterFF allff("allff");
+    allff.setUseParallelCalculation(true);
+    allff.add(all);
+
+    InterFF evenff("evenff");
+    evenff.setUseParallelCalculation(false);
+    evenff.add(even);
+
+    System system;
+    system.add(allff);
+    system.add(evenff);
+    system.add(all);
+
+    const MolNum even_mol = even.molNumAt(1);
+    const MolNum odd_mol = all.molNumAt(1);
+
+    assert_false( even.contains(odd_mol), CODELOC );
+
+    const Vector delta(0.3, -0.2, 0.1);
+
+    //profiling must not change the energy, so calculate the reference
+    //energies before profiling is switched on
+    System ref = system;
+    const double ref_nrg = ref.energy().value();
+    const double ref_moved_nrg = moveMolecule(ref, even_mol, delta);
+
+    EnergyProfiler::reset();
+    EnergyProfiler::enable();
+
+    assert_true( EnergyProfiler::isEnabled(), CODELOC );
+    assert_true( EnergyProfiler::report().isEmpty(), CODELOC );
+
+    //the first energy is calculated from scratch
+    assert_nearly_equal( system.energy().value(), ref_nrg, 1e-9*(1+std::abs(ref_nrg)),
+                         CODELOC );
+
+    EnergyProfile profile = EnergyProfiler::report();
+
+    if (verbose)
+        qDebug() << profile.toString();
+
+    assert_equal( profile.forceFields().count(), 2, CODELOC );
+    assert_true( profile.forceFields().contains("allff"), CODELOC );
+    assert_true( profile.forceFields().contains("evenff"), CODELOC );
+    assert_equal( profile.forceFieldType("allff"), QString(allff.what()), CODELOC );
+
+    assert_profile( profile, "allff", 1, 1, 0, CODELOC );
+    assert_profile( profile, "evenff", 1, 1, 0, CODELOC );
+
+    const qint64 all_pairs = profile.nPairs("allff");
+    const qint64 even_pairs = profile.nPairs("evenff");
+
+    assert_true( all_pairs > 0, CODELOC );
+    assert_true( even_pairs > 0, CODELOC );
+    assert_equal( profile.nPairs(), all_pairs + even_pairs, CODELOC );
+    assert_equal( profile.nEvaluations(), qint64(2), CODELOC );
+
+    //the energy is clean, so asking again does not recalculate anything
+    system.energy();
+    assert_true( EnergyProfiler::report() == profile, CODELOC );
+
+    //moving a molecule in both forcefields recalculates the change in energy
+    //of both, while moving a molecule only in 'allff' leaves 'evenff' alone
+    assert_nearly_equal( moveMolecule(system, even_mol, delta), ref_moved_nrg,
+                         1e-9*(1+std::abs(ref_moved_nrg)), CODELOC );
+
+    system.accept();
+
+    profile = EnergyProfiler::report();
+
+    assert_profile( profile, "allff", 2, 1, 1, CODELOC );
+    assert_profile( profile, "evenff", 2, 1, 1, CODELOC );
+
+    const qint64 even_pairs_before = profile.nPairs("evenff");
+
+    for (int i=0; i<3; ++i)
+    {
+        moveMolecule(system, odd_mol, delta);
+        system.accept();
+    }
+
+    profile = EnergyProfiler::report();
+
+    if (verbose)
+        qDebug() << profile.toString();
+
+    assert_profile( profile, "allff", 5, 1, 4, CODELOC );
+    assert_profile( profile, "evenff", 2, 1, 1, CODELOC );
+    assert_equal( profile.nPairs("evenff"), even_pairs_before, CODELOC );
+
+    //recalculating from scratch counts the same number of pairs each time
+    //the coordinates are unchanged
+    system.mustNowRecalculateFromScratch();
+    system.energy();
+
+    EnergyProfile full_profile = EnergyProfiler::report();
+
+    assert_profile( full_profile, "allff", 6, 2, 4, CODELOC );
+    assert_profile( full_profile, "evenff", 3, 2, 1, CODELOC );
+
+    assert_true( full_profile.nPairs("evenff") > even_pairs_before, CODELOC );
+
+    const qint64 all_full_pairs = full_profile.nPairs("allff") - profile.nPairs("allff");
+    const qint64 even_full_pairs = full_profile.nPairs("evenff") - profile.nPairs("evenff");
+
+    system.mustNowRecalculateFromScratch();
+    system.energy();
+
+    profile = EnergyProfiler::report();
+
+    assert_profile( profile, "allff", 7, 3, 4, CODELOC );
+    assert_profile( profile, "evenff", 4, 3, 1, CODELOC );
+
+    assert_equal( profile.nPairs("allff") - full_profile.nPairs("allff"), all_full_pairs,
+                  CODELOC );
+    assert_equal( profile.nPairs("evenff") - full_profile.nPairs("evenff"), even_full_pairs,
+                  CODELOC );
+
+    assert_true( profile.totalTime("allff") >= 0, CODELOC );
+    assert_nearly_equal( profile.totalTime(), profile.totalTime("allff") +
+                                              profile.totalTime("evenff"), 1e-9, CODELOC );
+
+    //nothing is recorded against forcefields that have not been recalculated
+    assert_profile( profile, "missing", 0, 0, 0, CODELOC );
+    assert_equal( profile.nPairs("missing"), qint64(0), CODELOC );
+
+    //counts made outside of any recalculation are not attributed to anything
+    EnergyProfiler::reset();
+    EnergyProfiler::addPairs(10);
+    EnergyProfiler::recordFullCalculation();
+    assert_true( EnergyProfiler::report().isEmpty(), CODELOC );
+
+    //nested timers attribute their counts to the innermost recalculation
+    {
+        EnergyProfiler::Timer outer(allff);
+        EnergyProfiler::addPairs(5);
+
+        {
+            EnergyProfiler::Timer inner(evenff);
+            EnergyProfiler::addPairs(3);
+            EnergyProfiler::recordDeltaCalculation();
+        }
+
+        //the inner timer has finished, so this is back to the outer timer
+        EnergyProfiler::addPairs(2);
+        EnergyProfiler::recordFullCalculation();
+
+        profile = EnergyProfiler::report();
+
+        assert_profile( profile, "evenff", 1, 0, 1, CODELOC );
+        assert_equal( profile.nPairs("evenff"), qint64(3), CODELOC );
+        assert_profile( profile, "allff", 0, 0, 0, CODELOC );
+    }
+
+    profile = EnergyProfiler::report();
+
+    if (verbose)
+        qDebug() << profile.toString();
+
+    assert_profile( profile, "allff", 1, 1, 0, CODELOC );
+    assert_equal( profile.nPairs("allff"), qint64(7), CODELOC );
+    assert_profile( profile, "evenff", 1, 0, 1, CODELOC );
+    assert_equal( profile.nPairs("evenff"), qint64(3), CODELOC );
+
+    //the log interval cannot be negative
+    EnergyProfiler::setLogInterval(-5);
+    assert_equal( EnergyProfiler::logInterval(), 0, CODELOC );
+
+    //nothing is recorded while profiling is disabled, but the data
+    //collected so far is kept until the profiler is reset
+    EnergyProfiler::disable();
+    assert_false( EnergyProfiler::isEnabled(), CODELOC );
+
+    system.mustNowRecalculateFromScratch();
+    system.energy();
+    moveMolecule(system, even_mol, delta);
+    system.accept();
+
+    {
+        EnergyProfiler::Timer timer(allff);
+        EnergyProfiler::addPairs(100);
+        EnergyProfiler::recordFullCalculation();
+    }
+
+    assert_true( EnergyProfiler::report() == profile, CODELOC );
+
+    EnergyProfiler::reset();
+    assert_true( EnergyProfiler::report().isEmpty(), CODELOC );
+
+    system.mustNowRecalculateFromScratch();
+    system.energy();
+    assert_true( EnergyProfiler::report().isEmpty(), CODELOC );
+}
+
+SIRE_UNITTEST( test_energyprofiler )
@@ -0,0 +1,388 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "SireSystem/system.h"
+
+#include "SireMM/intercljff.h"
+#include "SireMM/atomljs.h"
+#include "SireMM/ljparameter.h"
+
+#include "SireMol/molecule.h"
+#include "SireMol/moleculedata.h"
+#include "SireMol/moleculeinfodata.h"
+#include "SireMol/moleculegroup.h"
+#include "SireMol/molecules.h"
+#include "SireMol/moleditor.h"
+#include "SireMol/atomeditor.h"
+#include "SireMol/reseditor.h"
+#include "SireMol/cgeditor.h"
+#include "SireMol/atomcoords.h"
+#include "SireMol/atomcharges.h"
+#include "SireMol/packedcoords.h"
+#include "SireMol/atom.h"
+#include "SireMol/mover.hpp"
+
+#include "SireVol/coordgroup.h"
+
+#include "SireCAS/values.h"
+
+#include "SireMaths/rangenerator.h"
+
+#include "SireUnits/units.h"
+
+#include "SireBase/unittest.h"
+
+#include <QDebug>
+
+#include <cmath>
+
+using namespace SireSystem;
+using namespace SireMM;
+using namespace SireMol;
+using namespace SireVol;
+using namespace SireCAS;
+using namespace SireMaths;
+using namespace SireUnits;
+using namespace SireBase;
+
+/** The number of water molecules in the system */
+static const int nwaters = 10;
+
+/** Return a three-atom water molecule around 'center', in a residue called
+    'resname' and with atoms called 'atomnames'. The molecule has charges
+    and LJ parameters, so that it can be added to a CLJ forcefield */
+static Molecule createWater(const QString &resname, const QStringList &atomnames,
+                            const Vector &center, RanGenerator &rand)
+{
+    MolStructureEditor editor;
+
+    ResStructureEditor res = editor.add( ResNum(1) );
+    res = res.rename( ResName(resname) );
+
+    CGStructureEditor cgroup = editor.add( CGName("0") );
+
+    for (int i=0; i<atomnames.count(); ++i)
+    {
+        AtomStructureEditor atom = editor.add( AtomNum(i+1) );
+        atom = atom.rename( AtomName(atomnames[i]) );
+        atom = atom.reparent( res.index() );
+        atom = atom.reparent( cgroup.index() );
+    }
+
+    Molecule mol = editor.commit();
+
+    const MoleculeInfoData &molinfo = mol.data().info();
+
+    AtomCharges charges(molinfo, 0*mod_electron);
+    AtomLJs ljs(molinfo);
+
+    QVector<Vector> coords;
+
+    for (int i=0; i<molinfo.nAtoms(); ++i)
+    {
+        const CGAtomIdx cgatomidx( CGIdx(0), Index(i) );
+
+        if (i == 0)
+        {
+            charges.set( cgatomidx, -0.834*mod_electron );
+            ljs.set( cgatomidx, LJParameter(3.15*angstrom, 0.152*kcal_per_mol) );
+            coords.append(center);
+        }
+        else
+        {
+            charges.set( cgatomidx, 0.417*mod_electron );
+            ljs.set( cgatomidx, LJParameter::dummy() );
+            coords.append( center + rand.vectorOnSphere(0.96) );
+        }
+    }
+
+    QVector< QVector<Vector> > cgcoords;
+    cgcoords.append(coords);
+
+    return mol.edit().setProperty("coordinates", AtomCoords(CoordGroupArray(cgcoords)))
+                     .setProperty("charge", charges)
+                     .setProperty("LJ", ljs)
+                     .commit();
+}
+
+/** Return the names of the atoms of a water molecule */
+static QStringList waterNames()
+{
+    QStringList names;
+    names << "O" << "H1" << "H2";
+    return names;
+}
+
+/** Return the coordinates of the atoms of 'mol', in AtomIdx order */
+static QVector<Vector> atomCoordinates(const Molecule &mol)
+{
+    QVector<Vector> coords;
+
+    for (int i=0; i<mol.nAtoms(); ++i)
+    {
+        coords.append( mol.atom(AtomIdx(i)).property<Vector>("coordinates") );
+    }
+
+    return coords;
+}
+
+/** Assert that the molecules in 'system' have the same coordinates
+    as those in 'ref' */
+static void assert_same_coordinates(const System &system, const System &ref, QString codeloc)
+{
+    const Molecules mols = ref.molecules();
+
+    assert_equal( system.molecules().count(), mols.count(), codeloc );
+
+    for (Molecules::const_iterator it = mols.constBegin(); it != mols.constEnd(); ++it)
+    {
+        const QVector<Vector> coords = atomCoordinates( system[it.key()].molecule() );
+        const QVector<Vector> ref_coords = atomCoordinates( it->molecule() );
+
+        assert_equal( coords.count(), ref_coords.count(), codeloc );
+
+        for (int i=0; i<coords.count(); ++i)
+        {
+            assert_equal( Vector::distance(coords[i], ref_coords[i]), 0.0, codeloc );
+        }
+    }
+}
+
+/** Assert that every energy component of 'system' is the same as in 'ref' */
+static void assert_same_energies(System &system, System &ref, bool verbose, QString codeloc)
+{
+    const Values nrgs = system.energies();
+    const Values ref_nrgs = ref.energies();
+
+    assert_equal( nrgs.count(), ref_nrgs.count(), codeloc );
+
+    foreach (const Symbol &symbol, ref_nrgs.symbols())
+    {
+        const double ref_nrg = ref_nrgs.value(symbol);
+
+        if (verbose)
+            qDebug() << symbol.toString() << nrgs.value(symbol) << ref_nrg;
+
+        assert_nearly_equal( nrgs.value(symbol), ref_nrg, 1e-9*(1+std::abs(ref_nrg)), codeloc );
+    }
+
+    const double ref_nrg = ref.energy().value();
+
+    assert_true( std::abs(ref_nrg) > 1e-3, codeloc );
+    assert_nearly_equal( system.energy().value(), ref_nrg, 1e-9*(1+std::abs(ref_nrg)), codeloc );
+}
+
+/** Check that identical molecules share their layout only when this
+    is switched on, that the registry of shared layouts is emptied as
+    the molecules are released, and that packing the coordinates of
+    a system does not change its coordinates or energies */
+void test_sharedlayouts(bool verbose)
+{
+    RanGenerator rand(9753);
+
+    QStringList renamed_atoms = waterNames();
+    renamed_atoms[2] = "H3";
+
+    //sharing is off by default, so identical molecules have their own layouts
+    MoleculeInfoData::setShareLayouts(false);
+
+    assert_false( MoleculeInfoData::sharesLayouts(), CODELOC );
+
+    {
+        const Molecule water0 = createWater("WAT", waterNames(), Vector(0), rand);
+        const Molecule water1 = createWater("WAT", waterNames(), Vector(5), rand);
+
+        const MoleculeInfoData &info0 = water0.data().info();
+        const MoleculeInfoData &info1 = water1.data().info();
+
+        assert_true( &info0 != &info1, CODELOC );
+        assert_true( info0.UID() != info1.UID(), CODELOC );
+
+        assert_true( info0.hasSameLayout(info1), CODELOC );
+        assert_true( info1.hasSameLayout(info0), CODELOC );
+
+        assert_equal( MoleculeInfoData::nSharedLayouts(), 0, CODELOC );
+    }
+
+    MoleculeInfoData::setShareLayouts(true);
+
+    assert_true( MoleculeInfoData::sharesLayouts(), CODELOC );
+
+    {
+        const Molecule water0 = createWater("WAT", waterNames(), Vector(0), rand);
+        const Molecule water1 = createWater("WAT", waterNames(), Vector(5), rand);
+
+        const MoleculeInfoData &info0 = water0.data().info();
+        const MoleculeInfoData &info1 = water1.data().info();
+
+        //identical molecules now share the same layout object
+        assert_true( &info0 == &info1, CODELOC );
+        assert_true( info0.UID() == info1.UID(), CODELOC );
+        assert_equal( MoleculeInfoData::nSharedLayouts(), 1, CODELOC );
+
+        {
+            //renaming an atom or a residue gives a different layout
+            const Molecule atom_renamed = createWater("WAT", renamed_atoms, Vector(0), rand);
+            const Molecule res_renamed = createWater("SOL", waterNames(), Vector(0), rand);
+
+            const MoleculeInfoData &atom_info = atom_renamed.data().info();
+            const MoleculeInfoData &res_info = res_renamed.data().info();
+
+            assert_false( info0.hasSameLayout(atom_info), CODELOC );
+            assert_false( atom_info.hasSameLayout(info0), CODELOC );
+            assert_false( info0.hasSameLayout(res_info), CODELOC );
+            assert_false( res_info.hasSameLayout(info0), CODELOC );
+            assert_false( atom_info.hasSameLayout(res_info), CODELOC );
+
+            assert_true( atom_info.UID() != info0.UID(), CODELOC );
+            assert_true( res_info.UID() != info0.UID(), CODELOC );
+            assert_true( atom_info.UID() != res_info.UID(), CODELOC );
+
+            assert_equal( MoleculeInfoData::nSharedLayouts(), 3, CODELOC );
+
+            //a second copy of a renamed molecule shares its layout
+            const Molecule atom_renamed2 = createWater("WAT", renamed_atoms, Vector(5), rand);
+
+            assert_true( &(atom_renamed2.data().info()) == &atom_info, CODELOC );
+            assert_equal( MoleculeInfoData::nSharedLayouts(), 3, CODELOC );
+        }
+
+        //the renamed molecules have been released, so their layouts
+        //are no longer available to share
+        assert_equal( MoleculeInfoData::nSharedLayouts(), 1, CODELOC );
+    }
+
+    assert_equal( MoleculeInfoData::nSharedLayouts(), 0, CODELOC );
+
+    //pack the coordinates of a system of waters that share their layout
+    {
+        MoleculeGroup waters("waters");
+
+        for (int i=0; i<nwaters; ++i)
+        {
+            const Vector center( 4.0*(i % 3) + rand.rand(-0.2,0.2),
+                                 4.0*((i / 3) % 3) + rand.rand(-0.2,0.2),
+                                 4.0*(i / 9) + rand.rand(-0.2,0.2) );
+
+            waters.add( createWater("WAT", waterNames(), center, rand) );
+        }
+
+        assert_equal( MoleculeInfoData::nSharedLayouts(), 1, CODELOC );
+
+        InterCLJFF cljff("cljff");
+        cljff.add(waters);
+
+        System system;
+        system.add(cljff);
+        system.add(waters);
+
+        System packed_system = system;
+        const PackedCoords packed = packed_system.packCoordinates();
+
+        assert_equal( packed.nMolecules(), nwaters, CODELOC );
+        assert_equal( packed.nCoords(), 3*nwaters, CODELOC );
+
+        assert_same_coordinates(packed_system, system, CODELOC);
+        assert_same_energies(packed_system, system, verbose, CODELOC);
+
+        //the arena holds the coordinates of the molecules in molecule order,
+        //and each molecule uses the arena for its coordinates
+        const Vector *arena = packed.constCoordsData();
+
+        foreach (MolNum molnum, packed.molNums())
+        {
+            const Molecule mol = packed_system[molnum].molecule();
+
+            const CoordGroupArray &coords = mol.property("coordinates")
+                                               .asA<AtomCoords>().array();
+
+            assert_true( coords.constCoordsData() == arena + packed.offset(molnum),
+                         CODELOC );
+
+            assert_true( coords.constCoordsData() ==
+                         packed.coordinates(molnum).constCoordsData(), CODELOC );
+        }
+
+        //packing the molecules directly gives the same coordinates
+        const Molecules packed_mols = packed.pack( system.molecules() );
+
+        assert_equal( packed_mols.count(), nwaters, CODELOC );
+
+        for (Molecules::const_iterator it = packed_mols.constBegin();
+             it != packed_mols.constEnd(); ++it)
+        {
+            const QVector<Vector> coords = atomCoordinates( it->molecule() );
+            const QVector<Vector> ref_coords = atomCoordinates( system[it.key()].molecule() );
+
+            assert_equal( coords.count(), ref_coords.count(), CODELOC );
+
+            for (int i=0; i<coords.count(); ++i)
+            {
+                assert_equal( Vector::distance(coords[i], ref_coords[i]), 0.0, CODELOC );
+            }
+        }
+
+        //moving a molecule in the packed system gives the same energy as
+        //the unpacked system, and leaves the arena unchanged
+        const MolNum moved = packed.molNums().at(2);
+        const QVector<Vector> arena_coords = atomCoordinates( packed_system[moved].molecule() );
+
+        const Vector delta(0.5, -0.3, 0.2);
+
+        system.update( system[moved].molecule().move().translate(delta).commit() );
+        packed_system.update( packed_system[moved].molecule().move().translate(delta).commit() );
+
+        assert_same_coordinates(packed_system, system, CODELOC);
+        assert_same_energies(packed_system, system, verbose, CODELOC);
+
+        const Vector *moved_arena = packed.constCoordsData() + packed.offset(moved);
+
+        for (int i=0; i<arena_coords.count(); ++i)
+        {
+            assert_equal( Vector::distance(moved_arena[i], arena_coords[i]), 0.0, CODELOC );
+        }
+    }
+
+    assert_equal( MoleculeInfoData::nSharedLayouts(), 0, CODELOC );
+
+    //switching sharing off again empties the registry
+    {
+        MoleculeInfoData::setShareLayouts(true);
+
+        const Molecule water = createWater("WAT", waterNames(), Vector(0), rand);
+
+        assert_equal( MoleculeInfoData::nSharedLayouts(), 1, CODELOC );
+
+        MoleculeInfoData::setShareLayouts(false);
+
+        assert_false( MoleculeInfoData::sharesLayouts(), CODELOC );
+        assert_equal( MoleculeInfoData::nSharedLayouts(), 0, CODELOC );
+    }
+}
+
+SIRE_UNITTEST( test_sharedlayouts )
@@ -0,0 +1,331 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2018  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include "SireSystem/system.h"
+
+#include "SireMol/molecule.h"
+#include "SireMol/moleculedata.h"
+#include "SireMol/moleculeinfodata.h"
+#include "SireMol/moleculegroup.h"
+#include "SireMol/molecules.h"
+#include "SireMol/moleditor.h"
+#include "SireMol/atomeditor.h"
+#include "SireMol/cgeditor.h"
+#include "SireMol/atomcoords.h"
+#include "SireMol/packedcoords.h"
+#include "SireMol/atom.h"
+#include "SireMol/mover.hpp"
+#include "SireMol/errors.h"
+
+#include "SireVol/coordgroup.h"
+
+#include "SireMaths/rangenerator.h"
+
+#include "SireBase/stringproperty.h"
+#include "SireBase/errors.h"
+#include "SireBase/unittest.h"
+
+#include <QDebug>
+
+using namespace SireSystem;
+using namespace SireMol;
+using namespace SireVol;
+using namespace SireMaths;
+using namespace SireBase;
+
+/** The number of molecules in the system */
+static const int nmols = 12;
+
+/** Return a molecule with 'natoms' atoms around 'center'. The atoms are
+    split between two CutGroups so that the CutGroup order of the atoms
+    is different to their AtomIdx order */
+static Molecule createMolecule(int natoms, const Vector &center, RanGenerator &rand)
+{
+    MolStructureEditor editor;
+
+    CGStructureEditor cg0 = editor.add( CGName("0") );
+    CGStructureEditor cg1 = editor.add( CGName("1") );
+
+    for (int i=0; i<natoms; ++i)
+    {
+        AtomStructureEditor atom = editor.add( AtomNum(i+1) );
+        atom = atom.rename( AtomName(QString("X%1").arg(i+1)) );
+        atom = atom.reparent( (i % 2 == 0) ? cg0.index() : cg1.index() );
+    }
+
+    Molecule mol = editor.commit();
+
+    const MoleculeInfoData &molinfo = mol.data().info();
+
+    QVector< QVector<Vector> > cgcoords(molinfo.nCutGroups());
+
+    for (int i=0; i<molinfo.nCutGroups(); ++i)
+    {
+        for (int j=0; j<molinfo.nAtoms(CGIdx(i)); ++j)
+        {
+            cgcoords[i].append( center + rand.vectorOnSphere(1.5) );
+        }
+    }
+
+    return mol.edit().setProperty("coordinates", AtomCoords(CoordGroupArray(cgcoords)))
+                     .commit();
+}
+
+/** Return the coordinates of the atoms of 'mol', in AtomIdx order */
+static QVector<Vector> atomCoordinates(const Molecule &mol)
+{
+    QVector<Vector> coords;
+
+    for (int i=0; i<mol.nAtoms(); ++i)
+    {
+        coords.append( mol.atom(AtomIdx(i)).property<Vector>("coordinates") );
+    }
+
+    return coords;
+}
+
+/** Assert that the molecules in 'system' have the same coordinates
+    as those in 'ref' */
+static void assert_same_coordinates(const System &system, const System &ref)
+{
+    const Molecules mols = ref.molecules();
+
+    for (Molecules::const_iterator it = mols.constBegin(); it != mols.constEnd(); ++it)
+    {
+        const QVector<Vector> coords = atomCoordinates( system[it.key()].molecule() );
+        const QVector<Vector> ref_coords = atomCoordinates( it->molecule() );
+
+        assert_equal( coords.count(), ref_coords.count(), CODELOC );
+
+        for (int i=0; i<coords.count(); ++i)
+        {
+            assert_nearly_equal( Vector::distance(coords[i], ref_coords[i]), 0.0,
+                                 1e-9, CODELOC );
+        }
+    }
+}
+
+void test_updatecoordinates(bool verbose)
+{
+    RanGenerator rand(1357);
+
+    //all molecules are in 'all', the even molecules are also in 'even'
+    //and the first molecule is in 'first'
+    MoleculeGroup all("all");
+    MoleculeGroup even("even");
+    MoleculeGroup first("first");
+
+    for (int i=0; i<nmols; ++i)
+    {
+        Molecule mol = createMolecule( 1 + (i % 5), Vector(3*i, 0, 0), rand );
+
+        all.add(mol);
+
+        if (i % 2 == 0)
+            even.add(mol);
+
+        if (i == 0)
+            first.add(mol);
+    }
+
+    System system;
+    system.add(all);
+    system.add(even);
+    system.add(first);
+
+    //move the odd molecules and some of the even molecules (but not the
+    //first), in an order that is different to the molecule numbers
+    QVector<MolNum> molnums;
+
+    for (int i=nmols-1; i>0; --i)
+    {
+        if (i % 2 == 1 or i % 4 == 0)
+            molnums.append( all.molNumAt(i) );
+    }
+
+    int nmoved_even = 0;
+
+    foreach (MolNum molnum, molnums)
+    {
+        if (even.contains(molnum))
+            nmoved_even += 1;
+    }
+
+    //calculate the new coordinates by moving each molecule, and one of its
+    //atoms, using Mover, updating the reference system one molecule at a time
+    System ref = system;
+
+    QVector<double> x, y, z;
+
+    foreach (MolNum molnum, molnums)
+    {
+        Molecule mol = system[molnum].molecule();
+
+        mol = mol.move().translate( rand.vectorOnSphere(2.0) ).commit();
+        mol = mol.atom(AtomIdx(0)).move().translate( rand.vectorOnSphere(0.1) )
+                                         .commit().molecule();
+
+        ref.update(mol);
+
+        foreach (const Vector &coords, atomCoordinates(mol))
+        {
+            x.append(coords.x());
+            y.append(coords.y());
+            z.append(coords.z());
+        }
+    }
+
+    const MGName all_name("all"), even_name("even"), first_name("first");
+
+    const quint64 all_version = system[all_name].majorVersion();
+    const quint64 even_version = system[even_name].majorVersion();
+    const quint64 first_version = system[first_name].majorVersion();
+
+    //the reference was updated once per molecule
+    assert_equal( ref[all_name].majorVersion(), all_version + molnums.count(), CODELOC );
+    assert_equal( ref[even_name].majorVersion(), even_version + nmoved_even, CODELOC );
+
+    //the bulk update must give the same coordinates, but only update
+    //each molecule group once
+    System bulk = system;
+    bulk.updateCoordinates(molnums, x, y, z);
+
+    if (verbose)
+        qDebug() << "Updated" << molnums.count() << "molecules," << x.count() << "atoms";
+
+    assert_same_coordinates(bulk, ref);
+
+    assert_equal( bulk[all_name].majorVersion(), all_version + 1, CODELOC );
+    assert_equal( bulk[even_name].majorVersion(), even_version + 1, CODELOC );
+    assert_equal( bulk[first_name].majorVersion(), first_version, CODELOC );
+
+    //an empty update does nothing
+    System unchanged = system;
+    unchanged.updateCoordinates( QVector<MolNum>(), QVector<double>(),
+                                 QVector<double>(), QVector<double>() );
+
+    assert_equal( unchanged[all_name].majorVersion(), all_version, CODELOC );
+
+    //the number of coordinates must match the number of atoms
+    QVector<double> short_x = x;
+    short_x.removeLast();
+
+    assert_throws( [&](){ System s = system;
+                          s.updateCoordinates(molnums, short_x, short_x, short_x); },
+                   SireError::incompatible_error(), CODELOC );
+
+    assert_throws( [&](){ System s = system; s.updateCoordinates(molnums, x, y, short_x); },
+                   SireError::incompatible_error(), CODELOC );
+
+    //the molecules must exist, and have coordinates
+    assert_throws( [&](){ System s = system; s.updateCoordinates(
+                                QVector<MolNum>(1, MolNum::getUniqueNumber()),
+                                x.mid(0,1), y.mid(0,1), z.mid(0,1)); },
+                   SireMol::missing_molecule(), CODELOC );
+
+    PropertyMap map;
+    map.set("coordinates", "not_coordinates");
+
+    assert_throws( [&](){ System s = system; s.updateCoordinates(molnums, x, y, z, map); },
+                   SireBase::missing_property(), CODELOC );
+
+    //and the coordinates must be AtomCoords
+    {
+        System s = system;
+
+        foreach (MolNum molnum, molnums)
+        {
+            s.update( s[molnum].molecule().edit()
+                               .setProperty("not_coordinates", StringProperty("x"))
+                               .commit() );
+        }
+
+        assert_throws( [&](){ s.updateCoordinates(molnums, x, y, z, map); },
+                       SireError::invalid_cast(), CODELOC );
+    }
+
+    //update from a packed arena of coordinates, which is in CutGroup
+    //rather than AtomIdx order
+    System packed_system = system;
+    PackedCoords packed = packed_system.packCoordinates();
+
+    const quint64 packed_version = packed_system[all_name].majorVersion();
+    const quint64 packed_first_version = packed_system[first_name].majorVersion();
+
+    QVector<Vector> new_coords(packed.nCoords());
+    const Vector *old_coords = packed.constCoordsData();
+
+    for (int i=0; i<packed.nCoords(); ++i)
+    {
+        new_coords[i] = old_coords[i] + Vector(1.0, -2.0, 0.5);
+    }
+
+    assert_throws( [&](){ packed.setCoordinates(new_coords.mid(1)); },
+                   SireError::incompatible_error(), CODELOC );
+
+    packed.setCoordinates(new_coords);
+
+    assert_equal( packed.nCoords(), new_coords.count(), CODELOC );
+
+    for (int i=0; i<packed.nCoords(); ++i)
+    {
+        assert_equal( Vector::distance(packed.constCoordsData()[i], new_coords[i]),
+                      0.0, CODELOC );
+    }
+
+    packed_system.updateCoordinates(packed);
+
+    assert_equal( packed_system[all_name].majorVersion(), packed_version + 1, CODELOC );
+    assert_equal( packed_system[first_name].majorVersion(), packed_first_version + 1,
+                  CODELOC );
+
+    foreach (MolNum molnum, packed.molNums())
+    {
+        const Molecule mol = packed_system[molnum].molecule();
+        const Molecule old_mol = system[molnum].molecule();
+
+        const CoordGroupArray &coords = mol.property("coordinates")
+                                           .asA<AtomCoords>().array();
+
+        //the molecule uses the arena for its coordinates
+        assert_true( coords.constCoordsData() ==
+                     packed.coordinates(molnum).constCoordsData(), CODELOC );
+
+        const QVector<Vector> moved = atomCoordinates(mol);
+        const QVector<Vector> original = atomCoordinates(old_mol);
+
+        for (int i=0; i<moved.count(); ++i)
+        {
+            assert_nearly_equal( Vector::distance(moved[i],
+                                                  original[i] + Vector(1.0, -2.0, 0.5)),
+                                 0.0, 1e-9, CODELOC );
+        }
+    }
+}
+
+SIRE_UNITTEST( test_updatecoordinates )
@@ -307,6 +307,12 @@ BoxPatching::BoxPatching(const Space &space, Length size, const Vector &center)
                 "space (%1) is not a cartesian space.")
                     .arg(space.toString()), CODELOC );
 
+    if (space.isPeriodic() and not space.isA<PeriodicBox>())
+        throw SireError::incompatible_error( QObject::tr(
+                "BoxPatching is only compatible with orthorhombic periodic spaces "
+                "(PeriodicBox). The passed space (%1) is not supported.")
+                    .arg(space.toString()), CODELOC );
+
     if (space.isPeriodic())
     {
         //need a virtual function call here - as at the moment it
@@ -0,0 +1,1051 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2007  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#include <QVarLengthArray>
+
+#include <limits>
+#include <cmath>
+
+#include "triclinicbox.h"
+#include "coordgroup.h"
+
+#include "SireMaths/rangenerator.h"
+
+#include "SireError/errors.h"
+#include "SireStream/datastream.h"
+
+using namespace SireVol;
+using namespace SireBase;
+using namespace SireMaths;
+using namespace SireStream;
+
+using boost::tuple;
+
+static const RegisterMetaType<TriclinicBox> r_tribox;
+
+/** Serialise to a binary datastream */
+QDataStream SIREVOL_EXPORT &operator<<(QDataStream &ds, const TriclinicBox &box)
+{
+    writeHeader(ds, r_tribox, 1)
+               << box.v0 << box.v1 << box.v2
+               << static_cast<const Cartesian&>(box);
+
+               //no need to store anything else as it can be regenerated
+
+    return ds;
+}
+
+/** Deserialise from a binary datastream */
+QDataStream SIREVOL_EXPORT &operator>>(QDataStream &ds, TriclinicBox &box)
+{
+    VersionID v = readHeader(ds, r_tribox);
+    
+    if (v == 1)
+    {
+        Vector v0, v1, v2;
+    
+        ds >> v0 >> v1 >> v2 >> static_cast<Cartesian&>(box);
+        
+        box.setVectors(v0, v1, v2);
+    }
+    else
+        throw version_error(v, "1", r_tribox, CODELOC);
+
+    return ds;
+}
+
+/** This is the maximum length of a lattice vector (so that .volume() doesn't overflow) */
+static const double max_vectorlength( std::pow(0.9 * std::numeric_limits<double>::max(),
+                                               1.0/3.0) );
+
+/** Return the (unnormalised) cross product of v0 and v1 - note that 
+    Vector::cross returns a unit vector, so cannot be used here */
+static Vector crossProduct(const Vector &v0, const Vector &v1)
+{
+    return Vector( v0.y()*v1.z() - v0.z()*v1.y(),
+                   v0.z()*v1.x() - v0.x()*v1.z(),
+                   v0.x()*v1.y() - v0.y()*v1.x() );
+}
+
+/** Set the three lattice vectors of the unit cell */
+void TriclinicBox::setVectors(const Vector &vec0, const Vector &vec1, const Vector &vec2)
+{
+    if (vec0.length() > max_vectorlength or vec1.length() > max_vectorlength or
+        vec2.length() > max_vectorlength)
+    {
+        throw SireError::invalid_arg( QObject::tr(
+            "Cannot create a triclinic box with lattice vectors %1, %2 and %3 as "
+            "at least one vector is longer than the maximum allowed length (%4).")
+                .arg(vec0.toString(), vec1.toString(), vec2.toString())
+                .arg(max_vectorlength), CODELOC );
+    }
+
+    const Vector c12 = crossProduct(vec1, vec2);
+    const Vector c20 = crossProduct(vec2, vec0);
+    const Vector c01 = crossProduct(vec0, vec1);
+
+    const double vol = Vector::dot(vec0, c12);
+
+    if (std::abs(vol) < std::numeric_limits<double>::epsilon())
+    {
+        throw SireError::invalid_arg( QObject::tr(
+            "Cannot create a triclinic box with lattice vectors %1, %2 and %3 as "
+            "these vectors do not span a three-dimensional volume.")
+                .arg(vec0.toString(), vec1.toString(), vec2.toString()), CODELOC );
+    }
+
+    v0 = vec0;
+    v1 = vec1;
+    v2 = vec2;
+
+    const double invvol = 1.0 / vol;
+
+    r0 = invvol * c12;
+    r1 = invvol * c20;
+    r2 = invvol * c01;
+
+    //the distance between opposite faces of the cell along each 
+    //reduced axis is the inverse of the length of the reciprocal vector
+    const double max_rlength = qMax( r0.length(), qMax(r1.length(), r2.length()) );
+    
+    inscribed2 = SireMaths::pow_2( 0.5 / max_rlength );
+}
+
+/** Construct a default TriclinicBox volume (maximum volume) */
+TriclinicBox::TriclinicBox() : ConcreteProperty<TriclinicBox,Cartesian>()
+{
+    //set this to be a ridiculously large box
+    this->setVectors( Vector(max_vectorlength, 0, 0),
+                      Vector(0, max_vectorlength, 0),
+                      Vector(0, 0, max_vectorlength) );
+}
+
+/** Construct a TriclinicBox with the passed three lattice vectors */
+TriclinicBox::TriclinicBox(const Vector &vec0, const Vector &vec1, const Vector &vec2)
+             : ConcreteProperty<TriclinicBox,Cartesian>()
+{
+    this->setVectors(vec0, vec1, vec2);
+}
+
+/** Copy constructor */
+TriclinicBox::TriclinicBox(const TriclinicBox &other)
+             : ConcreteProperty<TriclinicBox,Cartesian>(other),
+               v0(other.v0), v1(other.v1), v2(other.v2),
+               r0(other.r0), r1(other.r1), r2(other.r2),
+               inscribed2(other.inscribed2)
+{}
+
+/** Destructor */
+TriclinicBox::~TriclinicBox()
+{}
+
+/** Copy assignment operator */
+TriclinicBox& TriclinicBox::operator=(const TriclinicBox &other)
+{
+    if (this != &other)
+    {
+        v0 = other.v0;
+        v1 = other.v1;
+        v2 = other.v2;
+        r0 = other.r0;
+        r1 = other.r1;
+        r2 = other.r2;
+        inscribed2 = other.inscribed2;
+        Cartesian::operator=(other);
+    }
+    
+    return *this;
+}
+
+/** Comparison operator */
+bool TriclinicBox::operator==(const TriclinicBox &other) const
+{
+    return v0 == other.v0 and v1 == other.v1 and v2 == other.v2;
+}
+
+/** Comparison operator */
+bool TriclinicBox::operator!=(const TriclinicBox &other) const
+{
+    return not TriclinicBox::operator==(other);
+}
+
+/** Return a cubic box with sides of length 'length' */
+TriclinicBox TriclinicBox::cubic(double length)
+{
+    return TriclinicBox( Vector(length, 0, 0),
+                         Vector(0, length, 0),
+                         Vector(0, 0, length) );
+}
+
+/** Return a truncated octahedral box where the distance between
+    each periodic image is 'distance'. This has about 77% of the
+    volume of a cubic box with the same image distance */
+TriclinicBox TriclinicBox::truncatedOctahedron(double d)
+{
+    return TriclinicBox( Vector(d, 0, 0),
+                         Vector(d/3.0, 2.0*std::sqrt(2.0)*d/3.0, 0),
+                         Vector(-d/3.0, std::sqrt(2.0)*d/3.0, std::sqrt(6.0)*d/3.0) );
+}
+
+/** Return a rhombic dodecahedral box (with a square xy-plane) where
+    the distance between each periodic image is 'distance'. This
+    has about 71% of the volume of a cubic box with the same image distance */
+TriclinicBox TriclinicBox::rhombicDodecahedron(double d)
+{
+    return TriclinicBox( Vector(d, 0, 0),
+                         Vector(0, d, 0),
+                         Vector(0.5*d, 0.5*d, 0.5*std::sqrt(2.0)*d) );
+}
+
+/** A triclinic box is periodic! */
+bool TriclinicBox::isPeriodic() const
+{
+    return true;
+}
+
+/** A triclinic box is cartesian */
+bool TriclinicBox::isCartesian() const
+{
+    return true;
+}
+
+/** Return the first lattice vector */
+const Vector& TriclinicBox::vector0() const
+{
+    return v0;
+}
+
+/** Return the second lattice vector */
+const Vector& TriclinicBox::vector1() const
+{
+    return v1;
+}
+
+/** Return the third lattice vector */
+const Vector& TriclinicBox::vector2() const
+{
+    return v2;
+}
+
+/** Return the reduced (fractional) coordinates of 'point', i.e. 
+    the coefficients of the lattice vectors that sum to 'point' */
+Vector TriclinicBox::toReduced(const Vector &point) const
+{
+    return Vector( Vector::dot(r0, point),
+                   Vector::dot(r1, point),
+                   Vector::dot(r2, point) );
+}
+
+/** Return the cartesian coordinates of the reduced coordinates 'reduced' */
+Vector TriclinicBox::fromReduced(const Vector &reduced) const
+{
+    return reduced.x()*v0 + reduced.y()*v1 + reduced.z()*v2;
+}
+
+/** Return the radius of the largest sphere that can be inscribed in the
+    unit cell. Any separation vector that is shorter than this is
+    guaranteed to be the minimum image */
+double TriclinicBox::inscribedRadius() const
+{
+    return std::sqrt(inscribed2);
+}
+
+/** Return a string representation of this space */
+QString TriclinicBox::toString() const
+{
+    return QObject::tr("TriclinicBox( %1, %2, %3 )")
+                .arg(v0.toString(), v1.toString(), v2.toString());
+}
+
+/** Return the minimum image of the separation vector 'delta' */
+Vector TriclinicBox::minimumImage(const Vector &delta) const
+{
+    Vector d = delta - std::floor(Vector::dot(r0,delta) + 0.5) * v0
+                     - std::floor(Vector::dot(r1,delta) + 0.5) * v1
+                     - std::floor(Vector::dot(r2,delta) + 0.5) * v2;
+
+    double best2 = d.length2();
+
+    if (best2 <= inscribed2)
+        return d;
+
+    //the rounded vector may not be the shortest for a skewed cell,
+    //so check all of the neighbouring lattice translations
+    Vector best = d;
+
+    for (int i=-1; i<=1; ++i)
+    {
+        for (int j=-1; j<=1; ++j)
+        {
+            for (int k=-1; k<=1; ++k)
+            {
+                const Vector t = d + double(i)*v0 + double(j)*v1 + double(k)*v2;
+                const double t2 = t.length2();
+                
+                if (t2 < best2)
+                {
+                    best = t;
+                    best2 = t2;
+                }
+            }
+        }
+    }
+    
+    return best;
+}
+
+/** Calculate the minimum image separation vectors from 'point' to each
+    of the 'npoints' points in 'points', placing the results into 'deltas'.
+    The first loop performs the reduced coordinate wrapping without any
+    branches so that it can be vectorised by the compiler. Only those
+    (rare) vectors that lie outside the inscribed sphere are then
+    corrected by searching the neighbouring lattice translations */
+void TriclinicBox::minimumImages(const Vector &point, const Vector *points,
+                                 int npoints, Vector *deltas) const
+{
+    const double px = point.x();
+    const double py = point.y();
+    const double pz = point.z();
+
+    for (int j=0; j<npoints; ++j)
+    {
+        const double dx = points[j].x() - px;
+        const double dy = points[j].y() - py;
+        const double dz = points[j].z() - pz;
+        
+        const double s0 = std::floor( r0.x()*dx + r0.y()*dy + r0.z()*dz + 0.5 );
+        const double s1 = std::floor( r1.x()*dx + r1.y()*dy + r1.z()*dz + 0.5 );
+        const double s2 = std::floor( r2.x()*dx + r2.y()*dy + r2.z()*dz + 0.5 );
+        
+        deltas[j] = Vector( dx - s0*v0.x() - s1*v1.x() - s2*v2.x(),
+                            dy - s0*v0.y() - s1*v1.y() - s2*v2.y(),
+                            dz - s0*v0.z() - s1*v1.z() - s2*v2.z() );
+    }
+    
+    for (int j=0; j<npoints; ++j)
+    {
+        if (deltas[j].length2() > inscribed2)
+            deltas[j] = this->minimumImage(deltas[j]);
+    }
+}
+
+/** Calculate the delta that needs to be added to 'v0' so that
+    it is the closest periodic image to 'v1' */
+Vector TriclinicBox::wrapDelta(const Vector &p0, const Vector &p1) const
+{
+    const Vector delta = p1 - p0;
+    return delta - this->minimumImage(delta);
+}
+
+/** Return all of the lattice translations 't' for which the 
+    vector 'delta + t' is no longer than 'dist' */
+QVector<Vector> TriclinicBox::translationsWithin(const Vector &delta, double dist) const
+{
+    QVector<Vector> translations;
+
+    const Vector s = this->toReduced(delta);
+    
+    //the range of each reduced coordinate covered by a sphere of
+    //radius 'dist' is 'dist' multiplied by the length of the reciprocal vector
+    const Vector extent = dist * Vector(r0.length(), r1.length(), r2.length());
+    
+    const int mini = int( std::ceil(-s.x() - extent.x()) );
+    const int maxi = int( std::floor(-s.x() + extent.x()) );
+    const int minj = int( std::ceil(-s.y() - extent.y()) );
+    const int maxj = int( std::floor(-s.y() + extent.y()) );
+    const int mink = int( std::ceil(-s.z() - extent.z()) );
+    const int maxk = int( std::floor(-s.z() + extent.z()) );
+    
+    const double dist2 = dist * dist;
+    
+    for (int i=mini; i<=maxi; ++i)
+    {
+        for (int j=minj; j<=maxj; ++j)
+        {
+            for (int k=mink; k<=maxk; ++k)
+            {
+                const Vector t = double(i)*v0 + double(j)*v1 + double(k)*v2;
+                
+                if ( (delta+t).length2() <= dist2 )
+                    translations.append(t);
+            }
+        }
+    }
+    
+    return translations;
+}
+
+/** Return the volume of the central box of this space.  */
+SireUnits::Dimension::Volume TriclinicBox::volume() const
+{
+    return SireUnits::Dimension::Volume( std::abs(
+                            Vector::dot(v0, crossProduct(v1,v2)) ) );
+}
+
+/** Return a copy of this space with the volume of set to 'volume'
+    - this will scale the space uniformly, keeping the center at
+    the same location, to achieve this volume */
+SpacePtr TriclinicBox::setVolume(SireUnits::Dimension::Volume vol) const
+{
+    double old_volume = this->volume();
+    double new_volume = vol;
+
+    if (new_volume < 0)
+        throw SireError::invalid_arg( QObject::tr(
+            "You cannot set the volume of a triclinic box to a negative value! (%1)")
+                .arg(new_volume), CODELOC );
+
+    if (old_volume == new_volume)
+        return *this;
+
+    double scl = std::pow( new_volume / old_volume, 1.0/3.0 );
+
+    return TriclinicBox( scl * v0, scl * v1, scl * v2 );
+}
+
+/** Calculate the distance between two points */
+double TriclinicBox::calcDist(const Vector &point0, const Vector &point1) const
+{
+    return this->minimumImage(point1 - point0).length();
+}
+
+/** Calculate the distance squared between two points */
+double TriclinicBox::calcDist2(const Vector &point0, const Vector &point1) const
+{
+    return this->minimumImage(point1 - point0).length2();
+}
+
+/** Populate the matrix 'mat' with the distances between all of the
+    atoms of the two CoordGroups. Return the shortest distance between the two
+    CoordGroups. Each distance uses the minimum image of that pair of atoms */
+double TriclinicBox::calcDist(const CoordGroup &group0, const CoordGroup &group1,
+                              DistMatrix &mat) const
+{
+    double mindist(std::numeric_limits<double>::max());
+
+    const int n0 = group0.count();
+    const int n1 = group1.count();
+
+    //redimension the matrix to hold all of the pairs
+    mat.redimension(n0, n1);
+
+    //get raw pointers to the arrays - this provides more efficient access
+    const Vector *array0 = group0.constData();
+    const Vector *array1 = group1.constData();
+
+    QVarLengthArray<Vector,128> deltas(n1);
+
+    for (int i=0; i<n0; ++i)
+    {
+        this->minimumImages(array0[i], array1, n1, deltas.data());
+        mat.setOuterIndex(i);
+
+        for (int j=0; j<n1; ++j)
+        {
+            const double dist = deltas[j].length();
+            mindist = qMin(mindist, dist);
+            mat[j] = dist;
+        }
+    }
+
+    //return the minimum distance
+    return mindist;
+}
+
+/** Populate the matrix 'mat' with the distances between all of the
+    atoms of the passed CoordGroup to the passed point. Return the shortest 
+    distance. */
+double TriclinicBox::calcDist(const CoordGroup &group, const Vector &point,
+                              DistMatrix &mat) const
+{
+    double mindist(std::numeric_limits<double>::max());
+
+    const int n = group.count();
+
+    //redimension the matrix to hold all of the pairs
+    mat.redimension(1, n);
+
+    QVarLengthArray<Vector,128> deltas(n);
+    this->minimumImages(point, group.constData(), n, deltas.data());
+
+    mat.setOuterIndex(0);
+
+    for (int j=0; j<n; ++j)
+    {
+        const double dist = deltas[j].length();
+        mindist = qMin(mindist, dist);
+        mat[j] = dist;
+    }
+
+    //return the minimum distance
+    return mindist;
+}
+
+/** Populate the matrix 'mat' with the distances^2 between all of the
+    atoms of the passed CoordGroup to the passed point. Return the shortest 
+    distance. */
+double TriclinicBox::calcDist2(const CoordGroup &group, const Vector &point,
+                               DistMatrix &mat) const
+{
+    double mindist2(std::numeric_limits<double>::max());
+
+    const int n = group.count();
+
+    //redimension the matrix to hold all of the pairs
+    mat.redimension(1, n);
+
+    QVarLengthArray<Vector,128> deltas(n);
+    this->minimumImages(point, group.constData(), n, deltas.data());
+
+    mat.setOuterIndex(0);
+
+    for (int j=0; j<n; ++j)
+    {
+        const double dist2 = deltas[j].length2();
+        mindist2 = qMin(mindist2, dist2);
+        mat[j] = dist2;
+    }
+
+    //return the minimum distance
+    return sqrt(mindist2);
+}
+
+/** Populate the matrix 'mat' with the distances^2 between all of the
+    atoms of the two CoordGroups. Return the shortest distance between the two
+    CoordGroups. */
+double TriclinicBox::calcDist2(const CoordGroup &group0, const CoordGroup &group1,
+                               DistMatrix &mat) const
+{
+    double mindist2(std::numeric_limits<double>::max());
+
+    const int n0 = group0.count();
+    const int n1 = group1.count();
+
+    //redimension the matrix to hold all of the pairs
+    mat.redimension(n0, n1);
+
+    //get raw pointers to the arrays - this provides more efficient access
+    const Vector *array0 = group0.constData();
+    const Vector *array1 = group1.constData();
+
+    QVarLengthArray<Vector,128> deltas(n1);
+
+    for (int i=0; i<n0; ++i)
+    {
+        this->minimumImages(array0[i], array1, n1, deltas.data());
+        mat.setOuterIndex(i);
+
+        for (int j=0; j<n1; ++j)
+        {
+            const double dist2 = deltas[j].length2();
+            mindist2 = qMin(mindist2, dist2);
+            mat[j] = dist2;
+        }
+    }
+
+    //return the minimum distance
+    return sqrt(mindist2);
+}
+
+/** Populate the matrix 'mat' with the inverse distances between all of the
+    atoms of the two CoordGroups. Return the shortest distance between the two CoordGroups. */
+double TriclinicBox::calcInvDist(const CoordGroup &group0, const CoordGroup &group1,
+                                 DistMatrix &mat) const
+{
+    double maxinvdist(0);
+
+    const int n0 = group0.count();
+    const int n1 = group1.count();
+
+    //redimension the matrix to hold all of the pairs
+    mat.redimension(n0, n1);
+
+    //get raw pointers to the arrays - this provides more efficient access
+    const Vector *array0 = group0.constData();
+    const Vector *array1 = group1.constData();
+
+    QVarLengthArray<Vector,128> deltas(n1);
+
+    for (int i=0; i<n0; ++i)
+    {
+        this->minimumImages(array0[i], array1, n1, deltas.data());
+        mat.setOuterIndex(i);
+
+        for (int j=0; j<n1; ++j)
+        {
+            const double invdist = 1.0 / deltas[j].length();
+            maxinvdist = qMax(maxinvdist, invdist);
+            mat[j] = invdist;
+        }
+    }
+
+    //return the shortest distance
+    return 1.0 / maxinvdist;
+}
+
+/** Populate the matrix 'mat' with the inverse distances^2 between all of the
+    atoms of the two CoordGroups. Return the shortest distance between the two CoordGroups. */
+double TriclinicBox::calcInvDist2(const CoordGroup &group0, const CoordGroup &group1,
+                                  DistMatrix &mat) const
+{
+    double maxinvdist2(0);
+
+    const int n0 = group0.count();
+    const int n1 = group1.count();
+
+    //redimension the matrix to hold all of the pairs
+    mat.redimension(n0, n1);
+
+    //get raw pointers to the arrays - this provides more efficient access
+    const Vector *array0 = group0.constData();
+    const Vector *array1 = group1.constData();
+
+    QVarLengthArray<Vector,128> deltas(n1);
+
+    for (int i=0; i<n0; ++i)
+    {
+        this->minimumImages(array0[i], array1, n1, deltas.data());
+        mat.setOuterIndex(i);
+
+        for (int j=0; j<n1; ++j)
+        {
+            const double invdist2 = 1.0 / deltas[j].length2();
+            maxinvdist2 = qMax(maxinvdist2, invdist2);
+            mat[j] = invdist2;
+        }
+    }
+
+    //return the shortest distance
+    return 1.0 / sqrt(maxinvdist2);
+}
+
+/** Calculate the distance vector between two points */
+DistVector TriclinicBox::calcDistVector(const Vector &point0, 
+                                        const Vector &point1) const
+{
+    return this->minimumImage(point1 - point0);
+}
+
+/** Populate the matrix 'distmat' between all the points of the two CoordGroups
+    'group1' and 'group2' - the returned matrix has the vectors pointing
+    from each point in 'group1' to each point in 'group2'. This returns
+    the shortest distance between two points in the group */
+double TriclinicBox::calcDistVectors(const CoordGroup &group0, const CoordGroup &group1,
+                                     DistVectorMatrix &mat) const
+{
+    double mindist(std::numeric_limits<double>::max());
+
+    const int n0 = group0.count();
+    const int n1 = group1.count();
+
+    //redimension the matrix to hold all of the pairs
+    mat.redimension(n0, n1);
+
+    //get raw pointers to the arrays - this provides more efficient access
+    const Vector *array0 = group0.constData();
+    const Vector *array1 = group1.constData();
+
+    QVarLengthArray<Vector,128> deltas(n1);
+
+    for (int i=0; i<n0; ++i)
+    {
+        this->minimumImages(array0[i], array1, n1, deltas.data());
+        mat.setOuterIndex(i);
+
+        for (int j=0; j<n1; ++j)
+        {
+            mat[j] = deltas[j];
+            mindist = qMin(mat[j].length(), mindist);
+        }
+    }
+
+    //return the minimum distance
+    return mindist;
+}
+
+/** Populate the matrix 'distmat' between all the points passed CoordGroup
+    to the point 'point' - the returned matrix has the vectors pointing
+    from the point to each point in 'group'. This returns
+    the shortest distance. */
+double TriclinicBox::calcDistVectors(const CoordGroup &group, const Vector &point,
+                                     DistVectorMatrix &mat) const
+{
+    double mindist(std::numeric_limits<double>::max());
+
+    const int n = group.count();
+
+    //redimension the matrix to hold all of the pairs
+    mat.redimension(1, n);
+
+    QVarLengthArray<Vector,128> deltas(n);
+    this->minimumImages(point, group.constData(), n, deltas.data());
+
+    mat.setOuterIndex(0);
+
+    for (int j=0; j<n; ++j)
+    {
+        mat[j] = deltas[j];
+        mindist = qMin(mat[j].length(), mindist);
+    }
+
+    //return the minimum distance
+    return mindist;
+}
+
+/** Calculate the angle between the passed three points. This should return
+    the acute angle between the points, which should lie between 0 and 180 degrees */
+Angle TriclinicBox::calcAngle(const Vector &point0, const Vector &point1,
+                              const Vector &point2) const
+{
+    Vector p0 = this->getMinimumImage(point0, point1);
+    Vector p2 = this->getMinimumImage(point2, point1);
+
+    return Vector::angle(p0, point1, p2);
+}
+
+/** Calculate the torsion angle between the passed four points. This should
+    return the torsion angle measured clockwise when looking down the 
+    torsion from point0-point1-point2-point3. This will lie between 0 and 360 
+    degrees */
+Angle TriclinicBox::calcDihedral(const Vector &point0, const Vector &point1,
+                                 const Vector &point2, const Vector &point3) const
+{
+    Vector p0 = this->getMinimumImage(point0, point1);
+    Vector p2 = this->getMinimumImage(point2, point1);
+    Vector p3 = this->getMinimumImage(point3, point1);
+
+    return Vector::dihedral(p0, point1, p2, p3);
+}
+
+/** Return whether or not two groups enclosed by the AABoxes 'aabox0' and 
+    'aabox1' are definitely beyond the cutoff distance 'dist' */
+bool TriclinicBox::beyond(double dist, const AABox &aabox0, const AABox &aabox1) const
+{
+    return this->minimumImage(aabox1.center() - aabox0.center()).length2() >
+                      SireMaths::pow_2(dist + aabox0.radius() + aabox1.radius());
+}
+
+/** Return whether or not these two groups are definitely beyond the cutoff distance. */
+bool TriclinicBox::beyond(double dist, const CoordGroup &group0,
+                          const CoordGroup &group1) const
+{
+    return TriclinicBox::beyond(dist, group0.aaBox(), group1.aaBox());
+}
+
+/** Return the distance between the axis-aligned boxes 'box0' and 'box1',
+    where 'delta' is the vector between the centers of the boxes */
+static double boxDistance(const Vector &delta, const AABox &box0, const AABox &box1)
+{
+    Vector d( std::abs(delta.x()), std::abs(delta.y()), std::abs(delta.z()) );
+    
+    d -= box0.halfExtents();
+    d -= box1.halfExtents();
+    
+    return d.max( Vector(0) ).length();
+}
+
+/** Return the minimum distance between the two boxes. This
+    searches all of the periodic images of 'box1' that could be
+    closer to 'box0' than the minimum image of its center */
+double TriclinicBox::minimumDistance(const AABox &box0, const AABox &box1) const
+{
+    const Vector delta = box1.center() - box0.center();
+    const Vector mindelta = this->minimumImage(delta);
+
+    double mindist = boxDistance(mindelta, box0, box1);
+    
+    if (mindist == 0)
+        return 0;
+    
+    const QVector<Vector> translations = this->translationsWithin(delta,
+                          mindelta.length() + box0.radius() + box1.radius());
+    
+    foreach (const Vector &t, translations)
+    {
+        mindist = qMin( mindist, boxDistance(delta + t, box0, box1) );
+    }
+    
+    return mindist;
+}
+
+/** Return the lattice translations that must be applied to 'box1' 
+    to give all of the periodic images of 'box1' that are within 'dist'
+    of 'box0'. This is used to calculate the interactions between 
+    groups of atoms in a triclinic box using vacuum kernels on
+    translated copies of the atoms */
+QVector<Vector> TriclinicBox::getImageTranslations(const AABox &box0, const AABox &box1,
+                                                   double dist) const
+{
+    const Vector delta = box1.center() - box0.center();
+
+    QVector<Vector> translations = this->translationsWithin(delta,
+                                        dist + box0.radius() + box1.radius());
+
+    QMutableVectorIterator<Vector> it(translations);
+    
+    while (it.hasNext())
+    {
+        if ( boxDistance(delta + it.next(), box0, box1) > dist )
+            it.remove();
+    }
+    
+    return translations;
+}
+
+/** Return the minimum distance between the points in 'group0' and 'group1'.
+    This uses the minimum image of each pair of points */
+double TriclinicBox::minimumDistance(const CoordGroup &group0,
+                                     const CoordGroup &group1) const
+{
+    double mindist2(std::numeric_limits<double>::max());
+
+    const int n0 = group0.count();
+    const int n1 = group1.count();
+
+    //get raw pointers to the arrays - this provides more efficient access
+    const Vector *array0 = group0.constData();
+    const Vector *array1 = group1.constData();
+
+    QVarLengthArray<Vector,128> deltas(n1);
+
+    for (int i=0; i<n0; ++i)
+    {
+        this->minimumImages(array0[i], array1, n1, deltas.data());
+
+        for (int j=0; j<n1; ++j)
+        {
+            mindist2 = qMin(deltas[j].length2(), mindist2);
+        }
+    }
+
+    //return the minimum distance
+    return sqrt(mindist2);
+}
+
+/** Return the closest periodic copy of 'group' to the point 'point',
+    according to the minimum image convention. The effect of this is
+    to move 'group' into the box which is now centered on 'point' */
+CoordGroup TriclinicBox::getMinimumImage(const CoordGroup &group,
+                                         const Vector &point) const
+{
+    Vector wrapdelta = wrapDelta(group.aaBox().center(), point);
+
+    if (wrapdelta.isZero())
+    {
+        //already got the minimum image
+        return group;
+    }
+    else
+    {
+        CoordGroupEditor editor = group.edit();
+        editor.translate(wrapdelta);
+
+        return editor.commit();
+    }
+}
+
+/** Return the closest periodic copy of each group in 'groups' to the
+    point 'point', according to the minimum image convention.
+    The effect of this is to move each 'group' into the box which is
+    now centered on 'point'. If 'translate_as_one' is true,
+    then this treats all groups as being part of one larger 
+    group, and so it translates it together. This is useful
+    to get the minimum image of a molecule as a whole, rather
+    than breaking the molecule across a box boundary */
+CoordGroupArray TriclinicBox::getMinimumImage(const CoordGroupArray &groups,
+                                              const Vector &point,
+                                              bool translate_as_one) const
+{
+    if (translate_as_one or groups.nCoordGroups() == 1)
+    {
+        Vector wrapdelta = wrapDelta(groups.aaBox().center(), point);
+        
+        if (wrapdelta.isZero())
+        {
+            return groups;
+        }
+        else
+        {
+            CoordGroupArray wrapped_groups( groups );
+            wrapped_groups.translate(wrapdelta);
+            
+            return wrapped_groups;
+        }
+    }
+    else
+    {
+        const int ncg = groups.count();
+        const CoordGroup *group_array = groups.constData();
+
+        QVector<CoordGroup> moved_groups(ncg);
+        CoordGroup *moved_array = moved_groups.data();
+        
+        bool moved_any = false;
+
+        for (int i=0; i<ncg; ++i)
+        {
+            moved_array[i] = this->getMinimumImage(group_array[i], point);
+            
+            if (not moved_any)
+                moved_any = (moved_array[i] != group_array[i]);
+        }
+
+        if (moved_any)
+            return CoordGroupArray(moved_groups);
+        else
+            //all of the CoordGroups are in the box - just return the original array
+            return groups;
+    }
+}
+
+/** Return the copy of the box which is the closest minimum image
+    to 'center' */
+AABox TriclinicBox::getMinimumImage(const AABox &aabox, const Vector &center) const
+{
+    Vector wrapdelta = wrapDelta(aabox.center(), center);
+    
+    if (wrapdelta.isZero())
+        return aabox;
+    else
+    {
+        AABox ret(aabox);
+        ret.translate(wrapdelta);
+        
+        return ret;
+    }
+}
+
+/** Return the copy of the point 'point' which is the closest minimum image
+    to 'center' */    
+Vector TriclinicBox::getMinimumImage(const Vector &point, const Vector &center) const
+{
+    return point + wrapDelta(point, center);
+}
+
+/** Return all periodic images of 'point' with respect to 'center' within
+    'dist' distance of 'center' */
+QVector<Vector> TriclinicBox::getImagesWithin(const Vector &point, const Vector &center,
+                                              double dist) const
+{
+    QVector<Vector> points;
+
+    const Vector delta = point - center;
+
+    foreach (const Vector &t, this->translationsWithin(delta, dist))
+    {
+        const Vector p_image = point + t;
+        
+        if ( Vector::distance(center, p_image) < dist )
+            points.append(p_image);
+    }
+    
+    return points;
+}
+
+/** Return a list of copies of CoordGroup 'group' that are within
+    'distance' of the CoordGroup 'center', translating 'group' so that
+    it has the right coordinates to be around 'center'. Note that multiple
+    copies of 'group' may be returned if there are multiple periodic 
+    replicas of 'group' within 'dist' of 'center'. The copies of 'group' 
+    are returned together with the minimum distance between that 
+    periodic replica and 'center'.
+
+    If there are no periodic replicas of 'group' that are within
+    'dist' of 'center', then an empty list is returned. */
+QList< tuple<double,CoordGroup> >
+TriclinicBox::getCopiesWithin(const CoordGroup &group, const CoordGroup &center,
+                              double dist) const
+{
+    if (dist > max_vectorlength)
+        throw SireError::invalid_arg( QObject::tr(
+            "You cannot use a distance (%1) that is greater than the "
+            "maximum box length (%2).")
+                .arg(dist).arg(max_vectorlength), CODELOC );
+
+    QList< tuple<double,CoordGroup> > neargroups;
+
+    //are there any copies within range?
+    if (this->beyond(dist,group,center))
+        //nope - there are no copies that are sufficiently close
+        return neargroups;
+
+    const AABox &centerbox = center.aaBox();
+    const AABox &groupbox = group.aaBox();
+
+    const QVector<Vector> translations = this->translationsWithin(
+                                 groupbox.center() - centerbox.center(),
+                                 centerbox.radius() + groupbox.radius() + dist );
+
+    foreach (const Vector &t, translations)
+    {
+        CoordGroupEditor editor = group.edit();
+        editor.translate(t);
+        CoordGroup periodic_replica = editor.commit();
+
+        //calculate the minimum distance... (using the cartesian space)
+        double mindist = Cartesian::minimumDistance(periodic_replica, center);
+
+        if (mindist <= dist)
+        {
+            neargroups.append( tuple<double,CoordGroup>(mindist,periodic_replica) );
+        }
+    }
+
+    return neargroups;
+}
+
+/** Return a random point within the box (placing the center of the box
+    is at the center 'center') */
+Vector TriclinicBox::getRandomPoint(const Vector &center, 
+                                    const RanGenerator &generator) const
+{
+    return this->fromReduced( Vector( generator.rand(-0.5, 0.5),
+                                      generator.rand(-0.5, 0.5),
+                                      generator.rand(-0.5, 0.5) ) )
+        
+               + center;
+}
+
+/** Return the center of the box that contains the point 'p' assuming
+    that the center for the central box is located at the origin */
+Vector TriclinicBox::getBoxCenter(const Vector &p) const
+{
+    return wrapDelta( Vector(0,0,0), p );
+}
+
+/** Return the center of the box that contains the point 'p' assuming
+    that the center for the central box is located at 'center' */
+Vector TriclinicBox::getBoxCenter(const Vector &p, const Vector &center) const
+{
+    return center + wrapDelta( center, p );
+}
+
+const char* TriclinicBox::typeName()
+{
+    return QMetaType::typeName( qMetaTypeId<TriclinicBox>() );
+}
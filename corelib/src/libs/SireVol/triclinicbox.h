@@ -0,0 +1,217 @@
+/********************************************\
+  *
+  *  Sire - Molecular Simulation Framework
+  *
+  *  Copyright (C) 2006  Christopher Woods
+  *
+  *  This program is free software; you can redistribute it and/or modify
+  *  it under the terms of the GNU General Public License as published by
+  *  the Free Software Foundation; either version 2 of the License, or
+  *  (at your option) any later version.
+  *
+  *  This program is distributed in the hope that it will be useful,
+  *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *  GNU General Public License for more details.
+  *
+  *  You should have received a copy of the GNU General Public License
+  *  along with this program; if not, write to the Free Software
+  *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+  *
+  *  For full details of the license please see the COPYING file
+  *  that should have come with this distribution.
+  *
+  *  You can contact the authors via the developer's mailing list
+  *  at http://siremol.org
+  *
+\*********************************************/
+
+#ifndef SIREVOL_TRICLINICBOX_H
+#define SIREVOL_TRICLINICBOX_H
+
+#include "cartesian.h"
+
+#include "SireMaths/vector.h"
+
+SIRE_BEGIN_HEADER
+
+namespace SireVol
+{
+class TriclinicBox;
+}
+
+QDataStream& operator<<(QDataStream&, const SireVol::TriclinicBox&);
+QDataStream& operator>>(QDataStream&, SireVol::TriclinicBox&);
+
+namespace SireVol
+{
+
+using SireMaths::Vector;
+
+/**
+A TriclinicBox is a volume that represents periodic boundary conditions
+using a general (triclinic) unit cell, described by three lattice vectors.
+This allows the use of the more compact unit cells, such as the 
+truncated octahedron and the rhombic dodecahedron, which need
+fewer solvent molecules than a PeriodicBox to solvate a solute
+to the same depth.
+
+The minimum image is found by converting the separation vector
+into reduced (fractional) coordinates, rounding these to the nearest
+integer, and converting back to cartesian coordinates. This is
+performed for whole arrays of points at a time. The result is
+exact if it lies within the sphere inscribed in the unit cell,
+otherwise the neighbouring lattice translations are checked as well.
+The lattice vectors should be in reduced form (e.g. as
+created by the static functions or as written by GROMACS),
+so that this search can find the true minimum image.
+
+@author Christopher Woods
+*/
+class SIREVOL_EXPORT TriclinicBox 
+        : public SireBase::ConcreteProperty<TriclinicBox,Cartesian>
+{
+
+friend QDataStream& ::operator<<(QDataStream&, const TriclinicBox&);
+friend QDataStream& ::operator>>(QDataStream&, TriclinicBox&);
+
+public:
+    TriclinicBox();
+    TriclinicBox(const Vector &v0, const Vector &v1, const Vector &v2);
+
+    TriclinicBox(const TriclinicBox &other);
+
+    ~TriclinicBox();
+
+    TriclinicBox& operator=(const TriclinicBox &other);
+    
+    bool operator==(const TriclinicBox &other) const;
+    bool operator!=(const TriclinicBox &other) const;
+
+    static TriclinicBox cubic(double length);
+    static TriclinicBox truncatedOctahedron(double distance);
+    static TriclinicBox rhombicDodecahedron(double distance);
+
+    bool isPeriodic() const;
+    bool isCartesian() const;
+
+    QString toString() const;
+
+    SireUnits::Dimension::Volume volume() const;
+    SpacePtr setVolume(SireUnits::Dimension::Volume volume) const;
+
+    void setVectors(const Vector &v0, const Vector &v1, const Vector &v2);
+
+    const Vector& vector0() const;
+    const Vector& vector1() const;
+    const Vector& vector2() const;
+
+    Vector toReduced(const Vector &point) const;
+    Vector fromReduced(const Vector &reduced) const;
+
+    double inscribedRadius() const;
+
+    static const char* typeName();
+
+    double calcDist(const Vector &point0, const Vector &point1) const;
+    double calcDist2(const Vector &point0, const Vector &point1) const;
+
+    double calcDist(const CoordGroup &group1, const CoordGroup &group2,
+                    DistMatrix &distmat) const;
+
+    double calcDist(const CoordGroup &group, const Vector &point,
+                    DistMatrix &mat) const;
+
+    double calcDist2(const CoordGroup &group, const Vector &point,
+                     DistMatrix &mat) const;
+
+    double calcDist2(const CoordGroup &group1, const CoordGroup &group2,
+                     DistMatrix &distmat) const;
+
+    double calcInvDist(const CoordGroup &group1, const CoordGroup &group2,
+                       DistMatrix &distmat) const;
+
+    double calcInvDist2(const CoordGroup &group1, const CoordGroup &group2,
+                        DistMatrix &distmat) const;
+
+    DistVector calcDistVector(const Vector &point0, const Vector &point1) const;
+    
+    double calcDistVectors(const CoordGroup &group1, const CoordGroup &group2,
+                           DistVectorMatrix &distmat) const;
+
+    double calcDistVectors(const CoordGroup &group, const Vector &point,
+                           DistVectorMatrix &distmat) const;
+
+    SireUnits::Dimension::Angle calcAngle(const Vector &point0,
+                                          const Vector &point1,
+                                          const Vector &point2) const;
+
+    SireUnits::Dimension::Angle calcDihedral(const Vector &point0,
+                                             const Vector &point1,
+                                             const Vector &point2,
+                                             const Vector &point3) const;
+
+    bool beyond(double dist, const AABox &aabox0, const AABox &aabox1) const;
+
+    bool beyond(double dist, const CoordGroup &group0,
+                const CoordGroup &group1) const;
+
+    double minimumDistance(const CoordGroup &group0, const CoordGroup &group1) const;
+
+    double minimumDistance(const AABox &box0, const AABox &box1) const;
+
+    QVector<Vector> getImageTranslations(const AABox &box0, const AABox &box1,
+                                         double dist) const;
+
+    Vector getRandomPoint(const Vector &center, const RanGenerator &generator) const;
+
+    Vector getBoxCenter(const Vector &p) const;
+    Vector getBoxCenter(const Vector &p, const Vector &center) const;
+
+    CoordGroup getMinimumImage(const CoordGroup &group, const Vector &center) const;
+
+    CoordGroupArray getMinimumImage(const CoordGroupArray &groups,
+                                    const Vector &center,
+                                    bool translate_as_one=false) const;
+
+    AABox getMinimumImage(const AABox &aabox, const Vector &center) const;
+    
+    Vector getMinimumImage(const Vector &point, const Vector &center) const;
+
+    QVector<Vector> getImagesWithin(const Vector &point, const Vector &center, double dist) const;
+
+    QList< boost::tuple<double,CoordGroup> >
+               getCopiesWithin(const CoordGroup &group,
+                               const CoordGroup &center, double dist) const;
+
+protected:
+    Vector wrapDelta(const Vector &v0, const Vector &v1) const;
+
+    Vector minimumImage(const Vector &delta) const;
+
+    void minimumImages(const Vector &point, const Vector *points,
+                       int npoints, Vector *deltas) const;
+
+    QVector<Vector> translationsWithin(const Vector &delta, double dist) const;
+
+    /** The three lattice vectors of the unit cell */
+    Vector v0, v1, v2;
+
+    /** The three reciprocal lattice vectors, used to convert
+        from cartesian to reduced coordinates */
+    Vector r0, r1, r2;
+
+    /** The square of the radius of the sphere inscribed in the 
+        unit cell (any vector shorter than this is a minimum image) */
+    double inscribed2;
+};
+
+}
+
+Q_DECLARE_METATYPE(SireVol::TriclinicBox)
+
+SIRE_EXPOSE_CLASS( SireVol::TriclinicBox )
+
+SIRE_END_HEADER
+
+#endif
@@ -0,0 +1,386 @@
+// This file has been generated by Py++.
+
+// (C) Christopher Woods, GPL >= 2 License
+
+#include "boost/python.hpp"
+#include "MBAR.pypp.hpp"
+
+namespace bp = boost::python;
+
+#include "SireError/errors.h"
+
+#include "SireMaths/maths.h"
+
+#include "SireMaths/nmatrix.h"
+
+#include "SireMaths/nvector.h"
+
+#include "SireMaths/rangenerator.h"
+
+#include "SireStream/shareddatastream.h"
+
+#include "SireUnits/temperature.h"
+
+#include "SireUnits/units.h"
+
+#include "mbar.h"
+
+#include "tbb/blocked_range.h"
+
+#include "tbb/parallel_for.h"
+
+#include <QVarLengthArray>
+
+#include <cmath>
+
+#include <limits>
+
+#include "mbar.h"
+
+SireAnalysis::MBAR __copy__(const SireAnalysis::MBAR &other){ return SireAnalysis::MBAR(other); }
+
+#include "Qt/qdatastream.hpp"
+
+#include "Helpers/str.hpp"
+
+void register_MBAR_class(){
+
+    { //::SireAnalysis::MBAR
+        typedef bp::class_< SireAnalysis::MBAR, bp::bases< SireBase::Property > > MBAR_exposer_t;
+        MBAR_exposer_t MBAR_exposer = MBAR_exposer_t( "MBAR", "This class implements the Multistate Bennett Acceptance Ratio (MBAR)\nestimator of the free energies of a set of K states (lambda values).\n\nEach sample is added together with the index of the state from which\nit was drawn, and the energy of that sample evaluated at every one\nof the K states (i.e. one column of the u_kn matrix). The free\nenergies are found by solving the MBAR self-consistent equations using\na Newton-Raphson solver (with all sums evaluated using log-sum-exp,\nand falling back to a self-consistent iteration if a Newton step does\nnot reduce the gradient). The sums over samples are parallelised.\n\nSamples can be added at any time, and re-solving starts from the\nprevious free energies, so this can be used to check the convergence\nof a simulation on-the-fly. Errors are estimated by bootstrapping\nthe samples (with the bootstrap replicas solved in parallel).\n\nAuthor: Christopher Woods\n", bp::init< >("Construct an empty MBAR estimator") );
+        bp::scope MBAR_scope( MBAR_exposer );
+        MBAR_exposer.def( bp::init< QList< double > const &, SireUnits::Dimension::Temperature const & >(( bp::arg("lambda_values"), bp::arg("temperature") ), "Construct an MBAR estimator for the states with the passed lambda values,\nfor samples collected at the passed temperature. Add samples\nusing the \"add\" function") );
+        MBAR_exposer.def( bp::init< QList< double > const &, QVector< QVector< double > > const &, QVector< qint64 > const &, SireUnits::Dimension::Temperature const & >(( bp::arg("lambda_values"), bp::arg("energies"), bp::arg("nsamples"), bp::arg("temperature") ), "Construct an MBAR estimator for the states with the passed lambda values,\ncollected at the passed temperature, using the passed matrix of energies.\nenergies[k][n] is the energy (in kcal mol-1) of sample n evaluated\nat state k. The samples are ordered by the state from which they\nwere drawn, with nsamples[k] samples drawn from state k\nThrow: SireError::invalid_arg\n") );
+        MBAR_exposer.def( bp::init< SireAnalysis::MBAR const & >(( bp::arg("other") ), "Copy constructor") );
+        { //::SireAnalysis::MBAR::add
+        
+            typedef void ( ::SireAnalysis::MBAR::*add_function_type)( int,::QVector< double > const & ) ;
+            add_function_type add_function_value( &::SireAnalysis::MBAR::add );
+            
+            MBAR_exposer.def( 
+                "add"
+                , add_function_value
+                , ( bp::arg("state"), bp::arg("energies") )
+                , "Add a single sample that was drawn from state state, where energies\ncontains the energy (in kcal mol-1) of the sample evaluated at each state\nThrow: SireError::invalid_index\nThrow: SireError::incompatible_error\n" );
+        
+        }
+        { //::SireAnalysis::MBAR::add
+        
+            typedef void ( ::SireAnalysis::MBAR::*add_function_type)( ::QVector< QVector< double > > const &,::QVector< qint64 > const & ) ;
+            add_function_type add_function_value( &::SireAnalysis::MBAR::add );
+            
+            MBAR_exposer.def( 
+                "add"
+                , add_function_value
+                , ( bp::arg("energies"), bp::arg("nsamples") )
+                , "Add the passed matrix of energies, where energies[k][n] is the energy\n(in kcal mol-1) of sample n evaluated at state k. The samples are\nordered by the state from which they were drawn, with nsamples[k]\nsamples drawn from state k\nThrow: SireError::incompatible_error\n" );
+        
+        }
+        { //::SireAnalysis::MBAR::bootstrap
+        
+            typedef void ( ::SireAnalysis::MBAR::*bootstrap_function_type)( int ) ;
+            bootstrap_function_type bootstrap_function_value( &::SireAnalysis::MBAR::bootstrap );
+            
+            MBAR_exposer.def( 
+                "bootstrap"
+                , bootstrap_function_value
+                , ( bp::arg("nbootstrap") )
+                , "Estimate the errors on the free energies using nbootstrap bootstrap\nreplicas, each of which is solved in parallel" );
+        
+        }
+        { //::SireAnalysis::MBAR::bootstrap
+        
+            typedef void ( ::SireAnalysis::MBAR::*bootstrap_function_type)( int,::quint32 ) ;
+            bootstrap_function_type bootstrap_function_value( &::SireAnalysis::MBAR::bootstrap );
+            
+            MBAR_exposer.def( 
+                "bootstrap"
+                , bootstrap_function_value
+                , ( bp::arg("nbootstrap"), bp::arg("seed") )
+                , "Estimate the errors on the free energies using nbootstrap bootstrap\nreplicas, generated using the passed random number seed (so that\nthe errors are reproducible). The replicas are solved in parallel" );
+        
+        }
+        { //::SireAnalysis::MBAR::clear
+        
+            typedef void ( ::SireAnalysis::MBAR::*clear_function_type)(  ) ;
+            clear_function_type clear_function_value( &::SireAnalysis::MBAR::clear );
+            
+            MBAR_exposer.def( 
+                "clear"
+                , clear_function_value
+                , "Clear all of the samples (keeping the lambda values and temperature)" );
+        
+        }
+        { //::SireAnalysis::MBAR::errors
+        
+            typedef ::QVector< double > ( ::SireAnalysis::MBAR::*errors_function_type)(  ) const;
+            errors_function_type errors_function_value( &::SireAnalysis::MBAR::errors );
+            
+            MBAR_exposer.def( 
+                "errors"
+                , errors_function_value
+                , "Return the bootstrap errors (in kcal mol-1) on the free energies. These\nare zero unless \"bootstrap\" has been called" );
+        
+        }
+        { //::SireAnalysis::MBAR::freeEnergies
+        
+            typedef ::QVector< double > ( ::SireAnalysis::MBAR::*freeEnergies_function_type)(  ) const;
+            freeEnergies_function_type freeEnergies_function_value( &::SireAnalysis::MBAR::freeEnergies );
+            
+            MBAR_exposer.def( 
+                "freeEnergies"
+                , freeEnergies_function_value
+                , "Return the free energies (in kcal mol-1) of each state, relative to\nthe first state. This solves the MBAR equations if needed" );
+        
+        }
+        { //::SireAnalysis::MBAR::isConverged
+        
+            typedef bool ( ::SireAnalysis::MBAR::*isConverged_function_type)(  ) const;
+            isConverged_function_type isConverged_function_value( &::SireAnalysis::MBAR::isConverged );
+            
+            MBAR_exposer.def( 
+                "isConverged"
+                , isConverged_function_value
+                , "Return whether or not the last solve converged" );
+        
+        }
+        { //::SireAnalysis::MBAR::isEmpty
+        
+            typedef bool ( ::SireAnalysis::MBAR::*isEmpty_function_type)(  ) const;
+            isEmpty_function_type isEmpty_function_value( &::SireAnalysis::MBAR::isEmpty );
+            
+            MBAR_exposer.def( 
+                "isEmpty"
+                , isEmpty_function_value
+                , "Return whether or not this estimator is empty (contains no samples)" );
+        
+        }
+        { //::SireAnalysis::MBAR::isSolved
+        
+            typedef bool ( ::SireAnalysis::MBAR::*isSolved_function_type)(  ) const;
+            isSolved_function_type isSolved_function_value( &::SireAnalysis::MBAR::isSolved );
+            
+            MBAR_exposer.def( 
+                "isSolved"
+                , isSolved_function_value
+                , "Return whether or not the free energies are up to date with the samples" );
+        
+        }
+        { //::SireAnalysis::MBAR::lambdaValues
+        
+            typedef ::QList< double > ( ::SireAnalysis::MBAR::*lambdaValues_function_type)(  ) const;
+            lambdaValues_function_type lambdaValues_function_value( &::SireAnalysis::MBAR::lambdaValues );
+            
+            MBAR_exposer.def( 
+                "lambdaValues"
+                , lambdaValues_function_value
+                , "Return the lambda values of each of the states" );
+        
+        }
+        { //::SireAnalysis::MBAR::maxIterations
+        
+            typedef int ( ::SireAnalysis::MBAR::*maxIterations_function_type)(  ) const;
+            maxIterations_function_type maxIterations_function_value( &::SireAnalysis::MBAR::maxIterations );
+            
+            MBAR_exposer.def( 
+                "maxIterations"
+                , maxIterations_function_value
+                , "Return the maximum number of iterations of the solver" );
+        
+        }
+        { //::SireAnalysis::MBAR::nBootstraps
+        
+            typedef int ( ::SireAnalysis::MBAR::*nBootstraps_function_type)(  ) const;
+            nBootstraps_function_type nBootstraps_function_value( &::SireAnalysis::MBAR::nBootstraps );
+            
+            MBAR_exposer.def( 
+                "nBootstraps"
+                , nBootstraps_function_value
+                , "Return the number of bootstrap replicas used to calculate the errors" );
+        
+        }
+        { //::SireAnalysis::MBAR::nIterations
+        
+            typedef int ( ::SireAnalysis::MBAR::*nIterations_function_type)(  ) const;
+            nIterations_function_type nIterations_function_value( &::SireAnalysis::MBAR::nIterations );
+            
+            MBAR_exposer.def( 
+                "nIterations"
+                , nIterations_function_value
+                , "Return the number of iterations used in the last solve" );
+        
+        }
+        { //::SireAnalysis::MBAR::nSamples
+        
+            typedef ::qint64 ( ::SireAnalysis::MBAR::*nSamples_function_type)(  ) const;
+            nSamples_function_type nSamples_function_value( &::SireAnalysis::MBAR::nSamples );
+            
+            MBAR_exposer.def( 
+                "nSamples"
+                , nSamples_function_value
+                , "Return the total number of samples" );
+        
+        }
+        { //::SireAnalysis::MBAR::nSamples
+        
+            typedef ::qint64 ( ::SireAnalysis::MBAR::*nSamples_function_type)( int ) const;
+            nSamples_function_type nSamples_function_value( &::SireAnalysis::MBAR::nSamples );
+            
+            MBAR_exposer.def( 
+                "nSamples"
+                , nSamples_function_value
+                , ( bp::arg("state") )
+                , "Return the number of samples drawn from state state" );
+        
+        }
+        { //::SireAnalysis::MBAR::nStates
+        
+            typedef int ( ::SireAnalysis::MBAR::*nStates_function_type)(  ) const;
+            nStates_function_type nStates_function_value( &::SireAnalysis::MBAR::nStates );
+            
+            MBAR_exposer.def( 
+                "nStates"
+                , nStates_function_value
+                , "Return the number of states" );
+        
+        }
+        MBAR_exposer.def( bp::self != bp::self );
+        { //::SireAnalysis::MBAR::operator=
+        
+            typedef ::SireAnalysis::MBAR & ( ::SireAnalysis::MBAR::*assign_function_type)( ::SireAnalysis::MBAR const & ) ;
+            assign_function_type assign_function_value( &::SireAnalysis::MBAR::operator= );
+            
+            MBAR_exposer.def( 
+                "assign"
+                , assign_function_value
+                , ( bp::arg("other") )
+                , bp::return_self< >()
+                , "" );
+        
+        }
+        MBAR_exposer.def( bp::self == bp::self );
+        { //::SireAnalysis::MBAR::pmf
+        
+            typedef ::SireAnalysis::PMF ( ::SireAnalysis::MBAR::*pmf_function_type)(  ) const;
+            pmf_function_type pmf_function_value( &::SireAnalysis::MBAR::pmf );
+            
+            MBAR_exposer.def( 
+                "pmf"
+                , pmf_function_value
+                , "Return the PMF of the free energy as a function of lambda" );
+        
+        }
+        { //::SireAnalysis::MBAR::reducedFreeEnergies
+        
+            typedef ::QVector< double > ( ::SireAnalysis::MBAR::*reducedFreeEnergies_function_type)(  ) const;
+            reducedFreeEnergies_function_type reducedFreeEnergies_function_value( &::SireAnalysis::MBAR::reducedFreeEnergies );
+            
+            MBAR_exposer.def( 
+                "reducedFreeEnergies"
+                , reducedFreeEnergies_function_value
+                , "Return the reduced (dimensionless) free energies of each state, relative to\nthe first state. Note that these are from the last call to \"solve\", so\nwill be out of date if samples have been added since" );
+        
+        }
+        { //::SireAnalysis::MBAR::setMaxIterations
+        
+            typedef void ( ::SireAnalysis::MBAR::*setMaxIterations_function_type)( int ) ;
+            setMaxIterations_function_type setMaxIterations_function_value( &::SireAnalysis::MBAR::setMaxIterations );
+            
+            MBAR_exposer.def( 
+                "setMaxIterations"
+                , setMaxIterations_function_value
+                , ( bp::arg("maxiter") )
+                , "Set the maximum number of iterations of the solver" );
+        
+        }
+        { //::SireAnalysis::MBAR::setTolerance
+        
+            typedef void ( ::SireAnalysis::MBAR::*setTolerance_function_type)( double ) ;
+            setTolerance_function_type setTolerance_function_value( &::SireAnalysis::MBAR::setTolerance );
+            
+            MBAR_exposer.def( 
+                "setTolerance"
+                , setTolerance_function_value
+                , ( bp::arg("tolerance") )
+                , "Set the tolerance used to decide that the solver has converged. This is\nthe maximum allowed value of |sum_n W_nk - N_k| / N_k for any state" );
+        
+        }
+        { //::SireAnalysis::MBAR::solve
+        
+            typedef void ( ::SireAnalysis::MBAR::*solve_function_type)(  ) ;
+            solve_function_type solve_function_value( &::SireAnalysis::MBAR::solve );
+            
+            MBAR_exposer.def( 
+                "solve"
+                , solve_function_value
+                , "Solve the MBAR equations for the current set of samples. This starts\nfrom the free energies of the last solve, so is fast if only\na few samples have been added since" );
+        
+        }
+        { //::SireAnalysis::MBAR::temperature
+        
+            typedef ::SireUnits::Dimension::Temperature ( ::SireAnalysis::MBAR::*temperature_function_type)(  ) const;
+            temperature_function_type temperature_function_value( &::SireAnalysis::MBAR::temperature );
+            
+            MBAR_exposer.def( 
+                "temperature"
+                , temperature_function_value
+                , "Return the temperature at which the samples were collected" );
+        
+        }
+        { //::SireAnalysis::MBAR::toString
+        
+            typedef ::QString ( ::SireAnalysis::MBAR::*toString_function_type)(  ) const;
+            toString_function_type toString_function_value( &::SireAnalysis::MBAR::toString );
+            
+            MBAR_exposer.def( 
+                "toString"
+                , toString_function_value
+                , "" );
+        
+        }
+        { //::SireAnalysis::MBAR::tolerance
+        
+            typedef double ( ::SireAnalysis::MBAR::*tolerance_function_type)(  ) const;
+            tolerance_function_type tolerance_function_value( &::SireAnalysis::MBAR::tolerance );
+            
+            MBAR_exposer.def( 
+                "tolerance"
+                , tolerance_function_value
+                , "Return the tolerance used to decide that the solver has converged" );
+        
+        }
+        { //::SireAnalysis::MBAR::typeName
+        
+            typedef char const * ( *typeName_function_type )(  );
+            typeName_function_type typeName_function_value( &::SireAnalysis::MBAR::typeName );
+            
+            MBAR_exposer.def( 
+                "typeName"
+                , typeName_function_value
+                , "" );
+        
+        }
+        { //::SireAnalysis::MBAR::what
+        
+            typedef char const * ( ::SireAnalysis::MBAR::*what_function_type)(  ) const;
+            what_function_type what_function_value( &::SireAnalysis::MBAR::what );
+            
+            MBAR_exposer.def( 
+                "what"
+                , what_function_value
+                , "" );
+        
+        }
+        MBAR_exposer.staticmethod( "typeName" );
+        MBAR_exposer.def( "__copy__", &__copy__);
+        MBAR_exposer.def( "__deepcopy__", &__copy__);
+        MBAR_exposer.def( "clone", &__copy__);
+        MBAR_exposer.def( "__rlshift__", &__rlshift__QDataStream< ::SireAnalysis::MBAR >,
+                            bp::return_internal_reference<1, bp::with_custodian_and_ward<1,2> >() );
+        MBAR_exposer.def( "__rrshift__", &__rrshift__QDataStream< ::SireAnalysis::MBAR >,
+                            bp::return_internal_reference<1, bp::with_custodian_and_ward<1,2> >() );
+        MBAR_exposer.def( "__str__", &__str__< ::SireAnalysis::MBAR > );
+        MBAR_exposer.def( "__repr__", &__str__< ::SireAnalysis::MBAR > );
+    }
+
+}
@@ -7,6 +7,7 @@
 #include "ticomponents.h"
 #include "ti.h"
 #include "fep.h"
+#include "mbar.h"
 
 #include "Helpers/objectregistry.hpp"
 
@@ -24,6 +25,7 @@ void register_SireAnalysis_objects()
     ObjectRegistry::registerConverterFor< SireAnalysis::FEPDeltas >();
     ObjectRegistry::registerConverterFor< SireAnalysis::DataPoint >();
     ObjectRegistry::registerConverterFor< SireAnalysis::PMF >();
+    ObjectRegistry::registerConverterFor< SireAnalysis::MBAR >();
 
 }
 
@@ -19,6 +19,8 @@
 
 #include "Gradients.pypp.hpp"
 
+#include "MBAR.pypp.hpp"
+
 #include "PMF.pypp.hpp"
 
 #include "TI.pypp.hpp"
@@ -52,6 +54,8 @@ BOOST_PYTHON_MODULE(_Analysis){
 
     register_Gradients_class();
 
+    register_MBAR_class();
+
     register_PMF_class();
 
     register_TI_class();
@@ -5,6 +5,7 @@
 
 #include "bennetts.h"
 #include "fep.h"
+#include "mbar.h"
 #include "ti.h"
 #include "ticomponents.h"
 
@@ -0,0 +1,212 @@
+// This file has been generated by Py++.
+
+// (C) Christopher Woods, GPL >= 2 License
+
+#include "boost/python.hpp"
+#include "CompiledExpression.pypp.hpp"
+
+namespace bp = boost::python;
+
+#include "SireError/errors.h"
+
+#include "SireStream/datastream.h"
+
+#include "SireStream/shareddatastream.h"
+
+#include "expression.h"
+
+#include "values.h"
+
+#include <QVarLengthArray>
+
+#include <cmath>
+
+#include "compiledexpression.h"
+
+SireCAS::CompiledExpression __copy__(const SireCAS::CompiledExpression &other){ return SireCAS::CompiledExpression(other); }
+
+#include "Qt/qdatastream.hpp"
+
+#include "Helpers/str.hpp"
+
+void register_CompiledExpression_class(){
+
+    { //::SireCAS::CompiledExpression
+        typedef bp::class_< SireCAS::CompiledExpression > CompiledExpression_exposer_t;
+        CompiledExpression_exposer_t CompiledExpression_exposer = CompiledExpression_exposer_t( "CompiledExpression", "\nThis class holds an Expression that has been compiled into a\nflat, register-based bytecode, so that it can be evaluated many\ntimes (e.g. once for every bond in a large protein) without walking\nthe expression tree or looking up the values of symbols in a Values\nhash.\n\nThe expression is compiled against an ordered list of input symbols.\nThe values of these symbols are passed as a plain array of doubles\nfor a single evaluation, or as one array per symbol when evaluating\nthe expression over a batch of points (structure-of-arrays).\n\nExpressions that match a common closed form are compiled to a\nspecialised kernel rather than to bytecode. These are;\n\nHARMONIC : k (a x + b)^2, e.g. k (r - r0)^2\nFOURIER  : c + sum_i k_i cos( n_i x + d_i ), e.g. Amber torsions\n\nAny part of an expression that cannot be compiled (e.g. a Function)\nis evaluated via Expression::evaluate, so the compiled expression\nalways gives the same result as the original\n\nAuthor: Christopher Woods\n", bp::init< >("Null constructor") );
+        bp::scope CompiledExpression_scope( CompiledExpression_exposer );
+        bp::enum_< SireCAS::CompiledExpression::Kernel>("Kernel")
+            .value("CONSTANT", SireCAS::CompiledExpression::CONSTANT)
+            .value("HARMONIC", SireCAS::CompiledExpression::HARMONIC)
+            .value("FOURIER", SireCAS::CompiledExpression::FOURIER)
+            .value("BYTECODE", SireCAS::CompiledExpression::BYTECODE)
+            .export_values()
+            ;
+        CompiledExpression_exposer.def( bp::init< SireCAS::Expression const &, SireCAS::Symbol const & >(( bp::arg("expression"), bp::arg("input") ), "Compile the expression expression, which is a function of the single input input") );
+        CompiledExpression_exposer.def( bp::init< SireCAS::Expression const &, QList< SireCAS::Symbol > const & >(( bp::arg("expression"), bp::arg("inputs") ), "Compile the expression expression, which is a function of the inputs inputs (in the order in which their values will be passed)") );
+        CompiledExpression_exposer.def( bp::init< SireCAS::CompiledExpression const & >(( bp::arg("other") ), "Copy constructor") );
+        { //::SireCAS::CompiledExpression::evaluate
+        
+            typedef double ( ::SireCAS::CompiledExpression::*evaluate_function_type)( double ) const;
+            evaluate_function_type evaluate_function_value( &::SireCAS::CompiledExpression::evaluate );
+            
+            CompiledExpression_exposer.def( 
+                "evaluate"
+                , evaluate_function_value
+                , ( bp::arg("x") )
+                , "Evaluate the compiled expression of a single input for the value x" );
+        
+        }
+        { //::SireCAS::CompiledExpression::evaluate
+        
+            typedef double ( ::SireCAS::CompiledExpression::*evaluate_function_type)( ::SireCAS::Values const & ) const;
+            evaluate_function_type evaluate_function_value( &::SireCAS::CompiledExpression::evaluate );
+            
+            CompiledExpression_exposer.def( 
+                "evaluate"
+                , evaluate_function_value
+                , ( bp::arg("values") )
+                , "Evaluate the compiled expression using the values in values" );
+        
+        }
+        { //::SireCAS::CompiledExpression::evaluate
+        
+            typedef ::QVector< double > ( ::SireCAS::CompiledExpression::*evaluate_function_type)( ::QVector< QVector< double > > const & ) const;
+            evaluate_function_type evaluate_function_value( &::SireCAS::CompiledExpression::evaluate );
+            
+            CompiledExpression_exposer.def( 
+                "evaluate"
+                , evaluate_function_value
+                , ( bp::arg("inputs") )
+                , "Evaluate the compiled expression for a batch of points. inputs\nholds one array of values for each input symbol, and each array\nmust be the same size\nThrow: SireError::incompatible_error\n" );
+        
+        }
+        { //::SireCAS::CompiledExpression::expression
+        
+            typedef ::SireCAS::Expression const & ( ::SireCAS::CompiledExpression::*expression_function_type)(  ) const;
+            expression_function_type expression_function_value( &::SireCAS::CompiledExpression::expression );
+            
+            CompiledExpression_exposer.def( 
+                "expression"
+                , expression_function_value
+                , bp::return_value_policy< bp::copy_const_reference >()
+                , "Return the expression that was compiled" );
+        
+        }
+        { //::SireCAS::CompiledExpression::inputs
+        
+            typedef ::QList< SireCAS::Symbol > const & ( ::SireCAS::CompiledExpression::*inputs_function_type)(  ) const;
+            inputs_function_type inputs_function_value( &::SireCAS::CompiledExpression::inputs );
+            
+            CompiledExpression_exposer.def( 
+                "inputs"
+                , inputs_function_value
+                , bp::return_value_policy< bp::copy_const_reference >()
+                , "Return the input symbols, in the order in which their values\nmust be passed to evaluate" );
+        
+        }
+        { //::SireCAS::CompiledExpression::kernel
+        
+            typedef ::SireCAS::CompiledExpression::Kernel ( ::SireCAS::CompiledExpression::*kernel_function_type)(  ) const;
+            kernel_function_type kernel_function_value( &::SireCAS::CompiledExpression::kernel );
+            
+            CompiledExpression_exposer.def( 
+                "kernel"
+                , kernel_function_value
+                , "Return the kernel used to evaluate this expression" );
+        
+        }
+        { //::SireCAS::CompiledExpression::nInputs
+        
+            typedef int ( ::SireCAS::CompiledExpression::*nInputs_function_type)(  ) const;
+            nInputs_function_type nInputs_function_value( &::SireCAS::CompiledExpression::nInputs );
+            
+            CompiledExpression_exposer.def( 
+                "nInputs"
+                , nInputs_function_value
+                , "Return the number of input symbols" );
+        
+        }
+        { //::SireCAS::CompiledExpression::nInstructions
+        
+            typedef int ( ::SireCAS::CompiledExpression::*nInstructions_function_type)(  ) const;
+            nInstructions_function_type nInstructions_function_value( &::SireCAS::CompiledExpression::nInstructions );
+            
+            CompiledExpression_exposer.def( 
+                "nInstructions"
+                , nInstructions_function_value
+                , "Return the number of bytecode instructions (zero if\nthis is evaluated using a closed-form kernel)" );
+        
+        }
+        CompiledExpression_exposer.def( bp::self != bp::self );
+        { //::SireCAS::CompiledExpression::operator=
+        
+            typedef ::SireCAS::CompiledExpression & ( ::SireCAS::CompiledExpression::*assign_function_type)( ::SireCAS::CompiledExpression const & ) ;
+            assign_function_type assign_function_value( &::SireCAS::CompiledExpression::operator= );
+            
+            CompiledExpression_exposer.def( 
+                "assign"
+                , assign_function_value
+                , ( bp::arg("other") )
+                , bp::return_self< >()
+                , "" );
+        
+        }
+        CompiledExpression_exposer.def( bp::self == bp::self );
+        { //::SireCAS::CompiledExpression::parameters
+        
+            typedef ::QVector< double > ( ::SireCAS::CompiledExpression::*parameters_function_type)(  ) const;
+            parameters_function_type parameters_function_value( &::SireCAS::CompiledExpression::parameters );
+            
+            CompiledExpression_exposer.def( 
+                "parameters"
+                , parameters_function_value
+                , "Return the parameters of the closed-form kernel. These are the\nvalue for CONSTANT, (k, a, b) for HARMONIC and (c, k_0, n_0, d_0,\nk_1, n_1, d_1...) for FOURIER. The constants used by the\nbytecode are returned for BYTECODE" );
+        
+        }
+        { //::SireCAS::CompiledExpression::toString
+        
+            typedef ::QString ( ::SireCAS::CompiledExpression::*toString_function_type)(  ) const;
+            toString_function_type toString_function_value( &::SireCAS::CompiledExpression::toString );
+            
+            CompiledExpression_exposer.def( 
+                "toString"
+                , toString_function_value
+                , "Return a string representation of the compiled expression" );
+        
+        }
+        { //::SireCAS::CompiledExpression::typeName
+        
+            typedef char const * ( *typeName_function_type )(  );
+            typeName_function_type typeName_function_value( &::SireCAS::CompiledExpression::typeName );
+            
+            CompiledExpression_exposer.def( 
+                "typeName"
+                , typeName_function_value
+                , "" );
+        
+        }
+        { //::SireCAS::CompiledExpression::what
+        
+            typedef char const * ( ::SireCAS::CompiledExpression::*what_function_type)(  ) const;
+            what_function_type what_function_value( &::SireCAS::CompiledExpression::what );
+            
+            CompiledExpression_exposer.def( 
+                "what"
+                , what_function_value
+                , "" );
+        
+        }
+        CompiledExpression_exposer.staticmethod( "typeName" );
+        CompiledExpression_exposer.def( "__copy__", &__copy__);
+        CompiledExpression_exposer.def( "__deepcopy__", &__copy__);
+        CompiledExpression_exposer.def( "clone", &__copy__);
+        CompiledExpression_exposer.def( "__rlshift__", &__rlshift__QDataStream< ::SireCAS::CompiledExpression >,
+                            bp::return_internal_reference<1, bp::with_custodian_and_ward<1,2> >() );
+        CompiledExpression_exposer.def( "__rrshift__", &__rrshift__QDataStream< ::SireCAS::CompiledExpression >,
+                            bp::return_internal_reference<1, bp::with_custodian_and_ward<1,2> >() );
+        CompiledExpression_exposer.def( "__str__", &__str__< ::SireCAS::CompiledExpression > );
+        CompiledExpression_exposer.def( "__repr__", &__str__< ::SireCAS::CompiledExpression > );
+    }
+
+}
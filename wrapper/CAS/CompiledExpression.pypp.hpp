@@ -0,0 +1,10 @@
+// This file has been generated by Py++.
+
+// (C) Christopher Woods, GPL >= 2 License
+
+#ifndef CompiledExpression_hpp__pyplusplus_wrapper
+#define CompiledExpression_hpp__pyplusplus_wrapper
+
+void register_CompiledExpression_class();
+
+#endif//CompiledExpression_hpp__pyplusplus_wrapper
@@ -37,6 +37,8 @@
 
 #include "ArcTanh.pypp.hpp"
 
+#include "CompiledExpression.pypp.hpp"
+
 #include "ComplexPower.pypp.hpp"
 
 #include "ComplexValues.pypp.hpp"
@@ -234,6 +236,8 @@ BOOST_PYTHON_MODULE(_CAS){
 
     register_Expression_class();
 
+    register_CompiledExpression_class();
+
     register_ExpressionBase_class();
 
     register_ExpressionProperty_class();
@@ -4,6 +4,7 @@
 #ifdef GCCXML_PARSE
 
 #include "abs.h"
+#include "compiledexpression.h"
 #include "complexvalues.h"
 #include "conditional.h"
 #include "constant.h"
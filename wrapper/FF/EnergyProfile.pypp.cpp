@@ -0,0 +1,285 @@
+// This file has been generated by Py++.
+
+// (C) Christopher Woods, GPL >= 2 License
+
+#include "boost/python.hpp"
+#include "EnergyProfile.pypp.hpp"
+
+namespace bp = boost::python;
+
+#include "SireBase/countflops.h"
+
+#include "SireStream/datastream.h"
+
+#include "ff.h"
+
+#include <QDebug>
+
+#include <QMutex>
+
+#include <QThreadStorage>
+
+#include <algorithm>
+
+#include "energyprofiler.h"
+
+#include "energyprofiler.h"
+
+SireFF::EnergyProfile __copy__(const SireFF::EnergyProfile &other){ return SireFF::EnergyProfile(other); }
+
+#include "Qt/qdatastream.hpp"
+
+#include "Helpers/str.hpp"
+
+void register_EnergyProfile_class(){
+
+    { //::SireFF::EnergyProfile
+        typedef bp::class_< SireFF::EnergyProfile > EnergyProfile_exposer_t;
+        EnergyProfile_exposer_t EnergyProfile_exposer = EnergyProfile_exposer_t( "EnergyProfile", "This is a snapshot of the energy-evaluation profile collected\nby the EnergyProfiler. It records, for each forcefield (identified\nby name), the number of energy recalculations, how many of these\nwere performed from scratch or using only the change in energy,\nthe wall time spent recalculating, the number of box pairs\nevaluated and the number of flops counted.\n\nAuthor: Christopher Woods\n", bp::init< >("Constructor") );
+        bp::scope EnergyProfile_scope( EnergyProfile_exposer );
+        EnergyProfile_exposer.def( bp::init< SireFF::EnergyProfile const & >(( bp::arg("other") ), "Copy constructor") );
+        { //::SireFF::EnergyProfile::averageTime
+        
+            typedef double ( ::SireFF::EnergyProfile::*averageTime_function_type)( ::QString const & ) const;
+            averageTime_function_type averageTime_function_value( &::SireFF::EnergyProfile::averageTime );
+            
+            EnergyProfile_exposer.def( 
+                "averageTime"
+                , averageTime_function_value
+                , ( bp::arg("ffname") )
+                , "Return the average time (in milliseconds) per recalculation of\nthe energy of the forcefield called ffname" );
+        
+        }
+        { //::SireFF::EnergyProfile::forceFieldType
+        
+            typedef ::QString ( ::SireFF::EnergyProfile::*forceFieldType_function_type)( ::QString const & ) const;
+            forceFieldType_function_type forceFieldType_function_value( &::SireFF::EnergyProfile::forceFieldType );
+            
+            EnergyProfile_exposer.def( 
+                "forceFieldType"
+                , forceFieldType_function_value
+                , ( bp::arg("ffname") )
+                , "Return the type of the forcefield called ffname" );
+        
+        }
+        { //::SireFF::EnergyProfile::forceFields
+        
+            typedef ::QStringList ( ::SireFF::EnergyProfile::*forceFields_function_type)(  ) const;
+            forceFields_function_type forceFields_function_value( &::SireFF::EnergyProfile::forceFields );
+            
+            EnergyProfile_exposer.def( 
+                "forceFields"
+                , forceFields_function_value
+                , "Return the names of all of the forcefields in this profile,\nsorted so that the most expensive forcefield is first" );
+        
+        }
+        { //::SireFF::EnergyProfile::isEmpty
+        
+            typedef bool ( ::SireFF::EnergyProfile::*isEmpty_function_type)(  ) const;
+            isEmpty_function_type isEmpty_function_value( &::SireFF::EnergyProfile::isEmpty );
+            
+            EnergyProfile_exposer.def( 
+                "isEmpty"
+                , isEmpty_function_value
+                , "Return whether or not this profile is empty (nothing has been recorded)" );
+        
+        }
+        { //::SireFF::EnergyProfile::nDeltaCalculations
+        
+            typedef ::qint64 ( ::SireFF::EnergyProfile::*nDeltaCalculations_function_type)(  ) const;
+            nDeltaCalculations_function_type nDeltaCalculations_function_value( &::SireFF::EnergyProfile::nDeltaCalculations );
+            
+            EnergyProfile_exposer.def( 
+                "nDeltaCalculations"
+                , nDeltaCalculations_function_value
+                , "Return the total number of recalculations that used only the\nchange in energy" );
+        
+        }
+        { //::SireFF::EnergyProfile::nDeltaCalculations
+        
+            typedef ::qint64 ( ::SireFF::EnergyProfile::*nDeltaCalculations_function_type)( ::QString const & ) const;
+            nDeltaCalculations_function_type nDeltaCalculations_function_value( &::SireFF::EnergyProfile::nDeltaCalculations );
+            
+            EnergyProfile_exposer.def( 
+                "nDeltaCalculations"
+                , nDeltaCalculations_function_value
+                , ( bp::arg("ffname") )
+                , "Return the number of recalculations of the forcefield called ffname\nthat used only the change in energy" );
+        
+        }
+        { //::SireFF::EnergyProfile::nEvaluations
+        
+            typedef ::qint64 ( ::SireFF::EnergyProfile::*nEvaluations_function_type)(  ) const;
+            nEvaluations_function_type nEvaluations_function_value( &::SireFF::EnergyProfile::nEvaluations );
+            
+            EnergyProfile_exposer.def( 
+                "nEvaluations"
+                , nEvaluations_function_value
+                , "Return the total number of energy recalculations" );
+        
+        }
+        { //::SireFF::EnergyProfile::nEvaluations
+        
+            typedef ::qint64 ( ::SireFF::EnergyProfile::*nEvaluations_function_type)( ::QString const & ) const;
+            nEvaluations_function_type nEvaluations_function_value( &::SireFF::EnergyProfile::nEvaluations );
+            
+            EnergyProfile_exposer.def( 
+                "nEvaluations"
+                , nEvaluations_function_value
+                , ( bp::arg("ffname") )
+                , "Return the number of energy recalculations of the forcefield called ffname" );
+        
+        }
+        { //::SireFF::EnergyProfile::nFlops
+        
+            typedef ::qint64 ( ::SireFF::EnergyProfile::*nFlops_function_type)(  ) const;
+            nFlops_function_type nFlops_function_value( &::SireFF::EnergyProfile::nFlops );
+            
+            EnergyProfile_exposer.def( 
+                "nFlops"
+                , nFlops_function_value
+                , "Return the total number of flops counted. This is only non-zero\nif Sire was compiled with SIRE_TIME_ROUTINES" );
+        
+        }
+        { //::SireFF::EnergyProfile::nFlops
+        
+            typedef ::qint64 ( ::SireFF::EnergyProfile::*nFlops_function_type)( ::QString const & ) const;
+            nFlops_function_type nFlops_function_value( &::SireFF::EnergyProfile::nFlops );
+            
+            EnergyProfile_exposer.def( 
+                "nFlops"
+                , nFlops_function_value
+                , ( bp::arg("ffname") )
+                , "Return the number of flops counted during recalculations of the\nforcefield called ffname" );
+        
+        }
+        { //::SireFF::EnergyProfile::nFullCalculations
+        
+            typedef ::qint64 ( ::SireFF::EnergyProfile::*nFullCalculations_function_type)(  ) const;
+            nFullCalculations_function_type nFullCalculations_function_value( &::SireFF::EnergyProfile::nFullCalculations );
+            
+            EnergyProfile_exposer.def( 
+                "nFullCalculations"
+                , nFullCalculations_function_value
+                , "Return the total number of recalculations that were performed from scratch" );
+        
+        }
+        { //::SireFF::EnergyProfile::nFullCalculations
+        
+            typedef ::qint64 ( ::SireFF::EnergyProfile::*nFullCalculations_function_type)( ::QString const & ) const;
+            nFullCalculations_function_type nFullCalculations_function_value( &::SireFF::EnergyProfile::nFullCalculations );
+            
+            EnergyProfile_exposer.def( 
+                "nFullCalculations"
+                , nFullCalculations_function_value
+                , ( bp::arg("ffname") )
+                , "Return the number of recalculations of the forcefield called ffname\nthat were performed from scratch" );
+        
+        }
+        { //::SireFF::EnergyProfile::nPairs
+        
+            typedef ::qint64 ( ::SireFF::EnergyProfile::*nPairs_function_type)(  ) const;
+            nPairs_function_type nPairs_function_value( &::SireFF::EnergyProfile::nPairs );
+            
+            EnergyProfile_exposer.def( 
+                "nPairs"
+                , nPairs_function_value
+                , "Return the total number of box (or cluster) pairs that were evaluated" );
+        
+        }
+        { //::SireFF::EnergyProfile::nPairs
+        
+            typedef ::qint64 ( ::SireFF::EnergyProfile::*nPairs_function_type)( ::QString const & ) const;
+            nPairs_function_type nPairs_function_value( &::SireFF::EnergyProfile::nPairs );
+            
+            EnergyProfile_exposer.def( 
+                "nPairs"
+                , nPairs_function_value
+                , ( bp::arg("ffname") )
+                , "Return the number of box (or cluster) pairs that were evaluated\nby the forcefield called ffname" );
+        
+        }
+        EnergyProfile_exposer.def( bp::self != bp::self );
+        { //::SireFF::EnergyProfile::operator=
+        
+            typedef ::SireFF::EnergyProfile & ( ::SireFF::EnergyProfile::*assign_function_type)( ::SireFF::EnergyProfile const & ) ;
+            assign_function_type assign_function_value( &::SireFF::EnergyProfile::operator= );
+            
+            EnergyProfile_exposer.def( 
+                "assign"
+                , assign_function_value
+                , ( bp::arg("other") )
+                , bp::return_self< >()
+                , "" );
+        
+        }
+        EnergyProfile_exposer.def( bp::self == bp::self );
+        { //::SireFF::EnergyProfile::toString
+        
+            typedef ::QString ( ::SireFF::EnergyProfile::*toString_function_type)(  ) const;
+            toString_function_type toString_function_value( &::SireFF::EnergyProfile::toString );
+            
+            EnergyProfile_exposer.def( 
+                "toString"
+                , toString_function_value
+                , "Return a table summarising this profile, with the most expensive\nforcefield listed first" );
+        
+        }
+        { //::SireFF::EnergyProfile::totalTime
+        
+            typedef double ( ::SireFF::EnergyProfile::*totalTime_function_type)(  ) const;
+            totalTime_function_type totalTime_function_value( &::SireFF::EnergyProfile::totalTime );
+            
+            EnergyProfile_exposer.def( 
+                "totalTime"
+                , totalTime_function_value
+                , "Return the total time (in milliseconds) spent recalculating energies" );
+        
+        }
+        { //::SireFF::EnergyProfile::totalTime
+        
+            typedef double ( ::SireFF::EnergyProfile::*totalTime_function_type)( ::QString const & ) const;
+            totalTime_function_type totalTime_function_value( &::SireFF::EnergyProfile::totalTime );
+            
+            EnergyProfile_exposer.def( 
+                "totalTime"
+                , totalTime_function_value
+                , ( bp::arg("ffname") )
+                , "Return the total time (in milliseconds) spent recalculating the\nenergy of the forcefield called ffname" );
+        
+        }
+        { //::SireFF::EnergyProfile::typeName
+        
+            typedef char const * ( *typeName_function_type )(  );
+            typeName_function_type typeName_function_value( &::SireFF::EnergyProfile::typeName );
+            
+            EnergyProfile_exposer.def( 
+                "typeName"
+                , typeName_function_value
+                , "" );
+        
+        }
+        { //::SireFF::EnergyProfile::what
+        
+            typedef char const * ( ::SireFF::EnergyProfile::*what_function_type)(  ) const;
+            what_function_type what_function_value( &::SireFF::EnergyProfile::what );
+            
+            EnergyProfile_exposer.def( 
+                "what"
+                , what_function_value
+                , "" );
+        
+        }
+        EnergyProfile_exposer.staticmethod( "typeName" );
+        EnergyProfile_exposer.def( "__copy__", &__copy__);
+        EnergyProfile_exposer.def( "__deepcopy__", &__copy__);
+        EnergyProfile_exposer.def( "clone", &__copy__);
+        EnergyProfile_exposer.def( "__rlshift__", &__rlshift__QDataStream< ::SireFF::EnergyProfile >,
+                            bp::return_internal_reference<1, bp::with_custodian_and_ward<1,2> >() );
+        EnergyProfile_exposer.def( "__rrshift__", &__rrshift__QDataStream< ::SireFF::EnergyProfile >,
+                            bp::return_internal_reference<1, bp::with_custodian_and_ward<1,2> >() );
+        EnergyProfile_exposer.def( "__str__", &__str__< ::SireFF::EnergyProfile > );
+        EnergyProfile_exposer.def( "__repr__", &__str__< ::SireFF::EnergyProfile > );
+    }
+
+}
@@ -0,0 +1,10 @@
+// This file has been generated by Py++.
+
+// (C) Christopher Woods, GPL >= 2 License
+
+#ifndef EnergyProfile_hpp__pyplusplus_wrapper
+#define EnergyProfile_hpp__pyplusplus_wrapper
+
+void register_EnergyProfile_class();
+
+#endif//EnergyProfile_hpp__pyplusplus_wrapper
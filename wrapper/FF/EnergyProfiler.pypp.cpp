@@ -0,0 +1,158 @@
+// This file has been generated by Py++.
+
+// (C) Christopher Woods, GPL >= 2 License
+
+#include "boost/python.hpp"
+#include "EnergyProfiler.pypp.hpp"
+
+namespace bp = boost::python;
+
+#include "SireBase/countflops.h"
+
+#include "SireStream/datastream.h"
+
+#include "ff.h"
+
+#include <QDebug>
+
+#include <QMutex>
+
+#include <QThreadStorage>
+
+#include <algorithm>
+
+#include "energyprofiler.h"
+
+#include "energyprofiler.h"
+
+void register_EnergyProfiler_class(){
+
+    { //::SireFF::EnergyProfiler
+        typedef bp::class_< SireFF::EnergyProfiler > EnergyProfiler_exposer_t;
+        EnergyProfiler_exposer_t EnergyProfiler_exposer = EnergyProfiler_exposer_t( "EnergyProfiler", "This is the opt-in profiler for forcefield energy evaluations.\nProfiling is switched off by default, in which case it costs only\na single flag check per energy recalculation. Once enabled, every\ncall to FF::recalculateEnergy (via FF::energy or FF::energies, and\nso also via ForceFields and System) is timed and attributed to the\nforcefield by name.\n\nForcefields can also report whether each recalculation was done\nfrom scratch or using only the change in energy (recordFullCalculation\nand recordDeltaCalculation), and the CLJ calculators report the number\nof box pairs evaluated (addPairs). These are attributed to the\nforcefield whose energy is currently being recalculated on the\ncalling thread. If Sire was compiled with SIRE_TIME_ROUTINES then\nthe flops counted by SireBase::CountFlops are also recorded.\n\nThe collected data is returned as an EnergyProfile via report(),\nand can be written to the log (qDebug) every 'n' recalculations\nusing setLogInterval.\n\nAuthor: Christopher Woods\n", bp::init< >("") );
+        bp::scope EnergyProfiler_scope( EnergyProfiler_exposer );
+        { //::SireFF::EnergyProfiler::addPairs
+        
+            typedef void ( *addPairs_function_type )( ::qint64 );
+            addPairs_function_type addPairs_function_value( &::SireFF::EnergyProfiler::addPairs );
+            
+            EnergyProfiler_exposer.def( 
+                "addPairs"
+                , addPairs_function_value
+                , ( bp::arg("npairs") )
+                , "Record that npairs box (or cluster) pairs were evaluated by\nthe forcefield whose energy is being recalculated on this thread" );
+        
+        }
+        { //::SireFF::EnergyProfiler::disable
+        
+            typedef void ( *disable_function_type )(  );
+            disable_function_type disable_function_value( &::SireFF::EnergyProfiler::disable );
+            
+            EnergyProfiler_exposer.def( 
+                "disable"
+                , disable_function_value
+                , "Switch off energy profiling. The data collected so far is retained\nuntil reset() is called" );
+        
+        }
+        { //::SireFF::EnergyProfiler::enable
+        
+            typedef void ( *enable_function_type )(  );
+            enable_function_type enable_function_value( &::SireFF::EnergyProfiler::enable );
+            
+            EnergyProfiler_exposer.def( 
+                "enable"
+                , enable_function_value
+                , "Switch on energy profiling" );
+        
+        }
+        { //::SireFF::EnergyProfiler::isEnabled
+        
+            typedef bool ( *isEnabled_function_type )(  );
+            isEnabled_function_type isEnabled_function_value( &::SireFF::EnergyProfiler::isEnabled );
+            
+            EnergyProfiler_exposer.def( 
+                "isEnabled"
+                , isEnabled_function_value
+                , "Return whether or not energy profiling is enabled" );
+        
+        }
+        { //::SireFF::EnergyProfiler::logInterval
+        
+            typedef int ( *logInterval_function_type )(  );
+            logInterval_function_type logInterval_function_value( &::SireFF::EnergyProfiler::logInterval );
+            
+            EnergyProfiler_exposer.def( 
+                "logInterval"
+                , logInterval_function_value
+                , "Return the number of recalculations between writing the profile\nto the log. This is zero if logging is switched off" );
+        
+        }
+        { //::SireFF::EnergyProfiler::recordDeltaCalculation
+        
+            typedef void ( *recordDeltaCalculation_function_type )(  );
+            recordDeltaCalculation_function_type recordDeltaCalculation_function_value( &::SireFF::EnergyProfiler::recordDeltaCalculation );
+            
+            EnergyProfiler_exposer.def( 
+                "recordDeltaCalculation"
+                , recordDeltaCalculation_function_value
+                , "Record that the forcefield whose energy is being recalculated\non this thread has calculated its energy using only the change\nin energy" );
+        
+        }
+        { //::SireFF::EnergyProfiler::recordFullCalculation
+        
+            typedef void ( *recordFullCalculation_function_type )(  );
+            recordFullCalculation_function_type recordFullCalculation_function_value( &::SireFF::EnergyProfiler::recordFullCalculation );
+            
+            EnergyProfiler_exposer.def( 
+                "recordFullCalculation"
+                , recordFullCalculation_function_value
+                , "Record that the forcefield whose energy is being recalculated\non this thread has recalculated its energy from scratch" );
+        
+        }
+        { //::SireFF::EnergyProfiler::report
+        
+            typedef ::SireFF::EnergyProfile ( *report_function_type )(  );
+            report_function_type report_function_value( &::SireFF::EnergyProfiler::report );
+            
+            EnergyProfiler_exposer.def( 
+                "report"
+                , report_function_value
+                , "Return a snapshot of the profiling data collected so far" );
+        
+        }
+        { //::SireFF::EnergyProfiler::reset
+        
+            typedef void ( *reset_function_type )(  );
+            reset_function_type reset_function_value( &::SireFF::EnergyProfiler::reset );
+            
+            EnergyProfiler_exposer.def( 
+                "reset"
+                , reset_function_value
+                , "Clear all of the profiling data collected so far" );
+        
+        }
+        { //::SireFF::EnergyProfiler::setLogInterval
+        
+            typedef void ( *setLogInterval_function_type )( int );
+            setLogInterval_function_type setLogInterval_function_value( &::SireFF::EnergyProfiler::setLogInterval );
+            
+            EnergyProfiler_exposer.def( 
+                "setLogInterval"
+                , setLogInterval_function_value
+                , ( bp::arg("n") )
+                , "Set the number of recalculations between writing the profile to\nthe log (via qDebug). Set this to zero (the default) to switch\noff logging" );
+        
+        }
+        EnergyProfiler_exposer.staticmethod( "addPairs" );
+        EnergyProfiler_exposer.staticmethod( "disable" );
+        EnergyProfiler_exposer.staticmethod( "enable" );
+        EnergyProfiler_exposer.staticmethod( "isEnabled" );
+        EnergyProfiler_exposer.staticmethod( "logInterval" );
+        EnergyProfiler_exposer.staticmethod( "recordDeltaCalculation" );
+        EnergyProfiler_exposer.staticmethod( "recordFullCalculation" );
+        EnergyProfiler_exposer.staticmethod( "report" );
+        EnergyProfiler_exposer.staticmethod( "reset" );
+        EnergyProfiler_exposer.staticmethod( "setLogInterval" );
+    }
+
+}
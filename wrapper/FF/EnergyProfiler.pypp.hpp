@@ -0,0 +1,10 @@
+// This file has been generated by Py++.
+
+// (C) Christopher Woods, GPL >= 2 License
+
+#ifndef EnergyProfiler_hpp__pyplusplus_wrapper
+#define EnergyProfiler_hpp__pyplusplus_wrapper
+
+void register_EnergyProfiler_class();
+
+#endif//EnergyProfiler_hpp__pyplusplus_wrapper
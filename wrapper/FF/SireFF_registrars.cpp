@@ -19,6 +19,7 @@
 #include "patch.h"
 #include "forcefields.h"
 #include "fieldtable.h"
+#include "energyprofiler.h"
 
 #include "Helpers/objectregistry.hpp"
 
@@ -57,6 +58,7 @@ void register_SireFF_objects()
     ObjectRegistry::registerConverterFor< SireFF::FieldTable >();
     ObjectRegistry::registerConverterFor< SireFF::GridFieldTable >();
     ObjectRegistry::registerConverterFor< SireFF::MolFieldTable >();
+    ObjectRegistry::registerConverterFor< SireFF::EnergyProfile >();
 
 }
 
@@ -15,6 +15,10 @@
 
 #include "CenterOfMass.pypp.hpp"
 
+#include "EnergyProfile.pypp.hpp"
+
+#include "EnergyProfiler.pypp.hpp"
+
 #include "EnergyTable.pypp.hpp"
 
 #include "FF.pypp.hpp"
@@ -108,6 +112,10 @@ BOOST_PYTHON_MODULE(_FF){
 
     register_CenterOfMass_class();
 
+    register_EnergyProfile_class();
+
+    register_EnergyProfiler_class();
+
     register_EnergyTable_class();
 
     register_FF_class();
@@ -0,0 +1,296 @@
+// This file has been generated by Py++.
+
+// (C) Christopher Woods, GPL >= 2 License
+
+#include "boost/python.hpp"
+#include "AmberTrajectoryReader.pypp.hpp"
+
+namespace bp = boost::python;
+
+#include "SireBase/getinstalldir.h"
+
+#include "SireError/errors.h"
+
+#include "SireIO/ambertrajectory.h"
+
+#include "SireIO/errors.h"
+
+#include "ambertrajectory.h"
+
+#include "Helpers/str.hpp"
+
+void register_AmberTrajectoryReader_class(){
+
+    { //::SireIO::AmberTrajectoryReader
+        typedef bp::class_< SireIO::AmberTrajectoryReader, boost::noncopyable > AmberTrajectoryReader_exposer_t;
+        AmberTrajectoryReader_exposer_t AmberTrajectoryReader_exposer = AmberTrajectoryReader_exposer_t( "AmberTrajectoryReader", "This class provides a streaming reader for Amber-format binary\n(NetCDF) trajectory files. Unlike AmberRst, which reads the whole\ntrajectory into memory, this reads the data one frame (or a batch\nof frames) at a time, so that the memory used is independent of\nthe length of the trajectory. This can also be used to follow\na trajectory that is still being written (see refresh()).\n\nAmber restart files (which have no frame dimension) are treated\nas trajectories containing a single frame.\n\nCoordinates are returned in angstroms, times in picoseconds,\nforces in amu angstroms per picosecond squared, and velocities\nin amber units (angstroms per 1/20.455 picoseconds), as for AmberRst.\n\nThe file format is described here;\n\nhttp://ambermd.org/netcdf/nctraj.xhtml\n\nAuthor: Christopher Woods\n", bp::init< QString const & >(( bp::arg("filename") ), "Open the Amber NetCDF trajectory (or restart) file filename for reading") );
+        bp::scope AmberTrajectoryReader_scope( AmberTrajectoryReader_exposer );
+        { //::SireIO::AmberTrajectoryReader::boxAngles
+        
+            typedef ::SireMaths::Vector ( ::SireIO::AmberTrajectoryReader::*boxAngles_function_type)( int ) const;
+            boxAngles_function_type boxAngles_function_value( &::SireIO::AmberTrajectoryReader::boxAngles );
+            
+            AmberTrajectoryReader_exposer.def( 
+                "boxAngles"
+                , boxAngles_function_value
+                , ( bp::arg("frame") )
+                , "Return the angles of the periodic box (in degrees) in frame frame" );
+        
+        }
+        { //::SireIO::AmberTrajectoryReader::boxDimensions
+        
+            typedef ::SireMaths::Vector ( ::SireIO::AmberTrajectoryReader::*boxDimensions_function_type)( int ) const;
+            boxDimensions_function_type boxDimensions_function_value( &::SireIO::AmberTrajectoryReader::boxDimensions );
+            
+            AmberTrajectoryReader_exposer.def( 
+                "boxDimensions"
+                , boxDimensions_function_value
+                , ( bp::arg("frame") )
+                , "Return the dimensions of the periodic box (in angstroms) in frame frame" );
+        
+        }
+        { //::SireIO::AmberTrajectoryReader::coordinates
+        
+            typedef ::QVector< SireMaths::Vector > ( ::SireIO::AmberTrajectoryReader::*coordinates_function_type)( int ) const;
+            coordinates_function_type coordinates_function_value( &::SireIO::AmberTrajectoryReader::coordinates );
+            
+            AmberTrajectoryReader_exposer.def( 
+                "coordinates"
+                , coordinates_function_value
+                , ( bp::arg("frame") )
+                , "Return the coordinates (in angstroms) of the atoms in frame frame" );
+        
+        }
+        { //::SireIO::AmberTrajectoryReader::coordinates
+        
+            typedef ::QVector< QVector< SireMaths::Vector > > ( ::SireIO::AmberTrajectoryReader::*coordinates_function_type)( int,int ) const;
+            coordinates_function_type coordinates_function_value( &::SireIO::AmberTrajectoryReader::coordinates );
+            
+            AmberTrajectoryReader_exposer.def( 
+                "coordinates"
+                , coordinates_function_value
+                , ( bp::arg("start"), bp::arg("count") )
+                , "Return the coordinates of the count frames starting from frame start.\nOnly these frames are read from the file" );
+        
+        }
+        { //::SireIO::AmberTrajectoryReader::filename
+        
+            typedef ::QString ( ::SireIO::AmberTrajectoryReader::*filename_function_type)(  ) const;
+            filename_function_type filename_function_value( &::SireIO::AmberTrajectoryReader::filename );
+            
+            AmberTrajectoryReader_exposer.def( 
+                "filename"
+                , filename_function_value
+                , "Return the name of the file being read" );
+        
+        }
+        { //::SireIO::AmberTrajectoryReader::forces
+        
+            typedef ::QVector< SireMaths::Vector > ( ::SireIO::AmberTrajectoryReader::*forces_function_type)( int ) const;
+            forces_function_type forces_function_value( &::SireIO::AmberTrajectoryReader::forces );
+            
+            AmberTrajectoryReader_exposer.def( 
+                "forces"
+                , forces_function_value
+                , ( bp::arg("frame") )
+                , "Return the forces on the atoms in frame frame" );
+        
+        }
+        { //::SireIO::AmberTrajectoryReader::forces
+        
+            typedef ::QVector< QVector< SireMaths::Vector > > ( ::SireIO::AmberTrajectoryReader::*forces_function_type)( int,int ) const;
+            forces_function_type forces_function_value( &::SireIO::AmberTrajectoryReader::forces );
+            
+            AmberTrajectoryReader_exposer.def( 
+                "forces"
+                , forces_function_value
+                , ( bp::arg("start"), bp::arg("count") )
+                , "Return the forces of the count frames starting from frame start" );
+        
+        }
+        { //::SireIO::AmberTrajectoryReader::hasBox
+        
+            typedef bool ( ::SireIO::AmberTrajectoryReader::*hasBox_function_type)(  ) const;
+            hasBox_function_type hasBox_function_value( &::SireIO::AmberTrajectoryReader::hasBox );
+            
+            AmberTrajectoryReader_exposer.def( 
+                "hasBox"
+                , hasBox_function_value
+                , "Return whether or not the trajectory contains periodic box information" );
+        
+        }
+        { //::SireIO::AmberTrajectoryReader::hasCoordinates
+        
+            typedef bool ( ::SireIO::AmberTrajectoryReader::*hasCoordinates_function_type)(  ) const;
+            hasCoordinates_function_type hasCoordinates_function_value( &::SireIO::AmberTrajectoryReader::hasCoordinates );
+            
+            AmberTrajectoryReader_exposer.def( 
+                "hasCoordinates"
+                , hasCoordinates_function_value
+                , "Return whether or not the trajectory contains coordinates" );
+        
+        }
+        { //::SireIO::AmberTrajectoryReader::hasForces
+        
+            typedef bool ( ::SireIO::AmberTrajectoryReader::*hasForces_function_type)(  ) const;
+            hasForces_function_type hasForces_function_value( &::SireIO::AmberTrajectoryReader::hasForces );
+            
+            AmberTrajectoryReader_exposer.def( 
+                "hasForces"
+                , hasForces_function_value
+                , "Return whether or not the trajectory contains forces" );
+        
+        }
+        { //::SireIO::AmberTrajectoryReader::hasTime
+        
+            typedef bool ( ::SireIO::AmberTrajectoryReader::*hasTime_function_type)(  ) const;
+            hasTime_function_type hasTime_function_value( &::SireIO::AmberTrajectoryReader::hasTime );
+            
+            AmberTrajectoryReader_exposer.def( 
+                "hasTime"
+                , hasTime_function_value
+                , "Return whether or not the trajectory contains the simulation time" );
+        
+        }
+        { //::SireIO::AmberTrajectoryReader::hasVelocities
+        
+            typedef bool ( ::SireIO::AmberTrajectoryReader::*hasVelocities_function_type)(  ) const;
+            hasVelocities_function_type hasVelocities_function_value( &::SireIO::AmberTrajectoryReader::hasVelocities );
+            
+            AmberTrajectoryReader_exposer.def( 
+                "hasVelocities"
+                , hasVelocities_function_value
+                , "Return whether or not the trajectory contains velocities" );
+        
+        }
+        { //::SireIO::AmberTrajectoryReader::nAtoms
+        
+            typedef int ( ::SireIO::AmberTrajectoryReader::*nAtoms_function_type)(  ) const;
+            nAtoms_function_type nAtoms_function_value( &::SireIO::AmberTrajectoryReader::nAtoms );
+            
+            AmberTrajectoryReader_exposer.def( 
+                "nAtoms"
+                , nAtoms_function_value
+                , "Return the number of atoms in each frame" );
+        
+        }
+        { //::SireIO::AmberTrajectoryReader::nFrames
+        
+            typedef int ( ::SireIO::AmberTrajectoryReader::*nFrames_function_type)(  ) const;
+            nFrames_function_type nFrames_function_value( &::SireIO::AmberTrajectoryReader::nFrames );
+            
+            AmberTrajectoryReader_exposer.def( 
+                "nFrames"
+                , nFrames_function_value
+                , "Return the number of frames that can be read" );
+        
+        }
+        { //::SireIO::AmberTrajectoryReader::refresh
+        
+            typedef int ( ::SireIO::AmberTrajectoryReader::*refresh_function_type)(  ) ;
+            refresh_function_type refresh_function_value( &::SireIO::AmberTrajectoryReader::refresh );
+            
+            AmberTrajectoryReader_exposer.def( 
+                "refresh"
+                , refresh_function_value
+                , "Refresh the reader so that it can see any frames that have been\nappended to the file since it was opened (e.g. to follow a\ntrajectory that is being written by a running simulation).\nThis returns the new number of frames" );
+        
+        }
+        { //::SireIO::AmberTrajectoryReader::time
+        
+            typedef double ( ::SireIO::AmberTrajectoryReader::*time_function_type)( int ) const;
+            time_function_type time_function_value( &::SireIO::AmberTrajectoryReader::time );
+            
+            AmberTrajectoryReader_exposer.def( 
+                "time"
+                , time_function_value
+                , ( bp::arg("frame") )
+                , "Return the time (in picoseconds) of frame frame" );
+        
+        }
+        { //::SireIO::AmberTrajectoryReader::times
+        
+            typedef ::QVector< double > ( ::SireIO::AmberTrajectoryReader::*times_function_type)( int,int ) const;
+            times_function_type times_function_value( &::SireIO::AmberTrajectoryReader::times );
+            
+            AmberTrajectoryReader_exposer.def( 
+                "times"
+                , times_function_value
+                , ( bp::arg("start"), bp::arg("count") )
+                , "Return the times of the count frames starting from frame start" );
+        
+        }
+        { //::SireIO::AmberTrajectoryReader::title
+        
+            typedef ::QString ( ::SireIO::AmberTrajectoryReader::*title_function_type)(  ) const;
+            title_function_type title_function_value( &::SireIO::AmberTrajectoryReader::title );
+            
+            AmberTrajectoryReader_exposer.def( 
+                "title"
+                , title_function_value
+                , "Return the title of the trajectory" );
+        
+        }
+        { //::SireIO::AmberTrajectoryReader::toString
+        
+            typedef ::QString ( ::SireIO::AmberTrajectoryReader::*toString_function_type)(  ) const;
+            toString_function_type toString_function_value( &::SireIO::AmberTrajectoryReader::toString );
+            
+            AmberTrajectoryReader_exposer.def( 
+                "toString"
+                , toString_function_value
+                , "" );
+        
+        }
+        { //::SireIO::AmberTrajectoryReader::typeName
+        
+            typedef char const * ( *typeName_function_type )(  );
+            typeName_function_type typeName_function_value( &::SireIO::AmberTrajectoryReader::typeName );
+            
+            AmberTrajectoryReader_exposer.def( 
+                "typeName"
+                , typeName_function_value
+                , "" );
+        
+        }
+        { //::SireIO::AmberTrajectoryReader::velocities
+        
+            typedef ::QVector< SireMaths::Vector > ( ::SireIO::AmberTrajectoryReader::*velocities_function_type)( int ) const;
+            velocities_function_type velocities_function_value( &::SireIO::AmberTrajectoryReader::velocities );
+            
+            AmberTrajectoryReader_exposer.def( 
+                "velocities"
+                , velocities_function_value
+                , ( bp::arg("frame") )
+                , "Return the velocities (in amber units) of the atoms in frame frame" );
+        
+        }
+        { //::SireIO::AmberTrajectoryReader::velocities
+        
+            typedef ::QVector< QVector< SireMaths::Vector > > ( ::SireIO::AmberTrajectoryReader::*velocities_function_type)( int,int ) const;
+            velocities_function_type velocities_function_value( &::SireIO::AmberTrajectoryReader::velocities );
+            
+            AmberTrajectoryReader_exposer.def( 
+                "velocities"
+                , velocities_function_value
+                , ( bp::arg("start"), bp::arg("count") )
+                , "Return the velocities of the count frames starting from frame start" );
+        
+        }
+        { //::SireIO::AmberTrajectoryReader::what
+        
+            typedef char const * ( ::SireIO::AmberTrajectoryReader::*what_function_type)(  ) const;
+            what_function_type what_function_value( &::SireIO::AmberTrajectoryReader::what );
+            
+            AmberTrajectoryReader_exposer.def( 
+                "what"
+                , what_function_value
+                , "" );
+        
+        }
+        AmberTrajectoryReader_exposer.staticmethod( "typeName" );
+        AmberTrajectoryReader_exposer.def( "__str__", &__str__< ::SireIO::AmberTrajectoryReader > );
+        AmberTrajectoryReader_exposer.def( "__repr__", &__str__< ::SireIO::AmberTrajectoryReader > );
+    }
+
+}
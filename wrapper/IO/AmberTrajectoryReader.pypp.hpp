@@ -0,0 +1,10 @@
+// This file has been generated by Py++.
+
+// (C) Christopher Woods, GPL >= 2 License
+
+#ifndef AmberTrajectoryReader_hpp__pyplusplus_wrapper
+#define AmberTrajectoryReader_hpp__pyplusplus_wrapper
+
+void register_AmberTrajectoryReader_class();
+
+#endif//AmberTrajectoryReader_hpp__pyplusplus_wrapper
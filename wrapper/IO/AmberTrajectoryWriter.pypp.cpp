@@ -0,0 +1,169 @@
+// This file has been generated by Py++.
+
+// (C) Christopher Woods, GPL >= 2 License
+
+#include "boost/python.hpp"
+#include "AmberTrajectoryWriter.pypp.hpp"
+
+namespace bp = boost::python;
+
+#include "SireBase/getinstalldir.h"
+
+#include "SireError/errors.h"
+
+#include "SireIO/ambertrajectory.h"
+
+#include "SireIO/errors.h"
+
+#include "ambertrajectory.h"
+
+#include "Helpers/str.hpp"
+
+void register_AmberTrajectoryWriter_class(){
+
+    { //::SireIO::AmberTrajectoryWriter
+        typedef bp::class_< SireIO::AmberTrajectoryWriter, boost::noncopyable > AmberTrajectoryWriter_exposer_t;
+        AmberTrajectoryWriter_exposer_t AmberTrajectoryWriter_exposer = AmberTrajectoryWriter_exposer_t( "AmberTrajectoryWriter", "This class provides a streaming writer for Amber-format binary\n(NetCDF) trajectory files. Frames are appended to the file one\nat a time as they are generated, so the trajectory never needs\nto be held in memory, and a partially-written trajectory is\nalways a valid file that can be read (e.g. by AmberTrajectoryReader\nor by other Amber-compatible tools).\n\nUnits are the same as for AmberTrajectoryReader.\n\nAuthor: Christopher Woods\n", bp::init< QString const & >(( bp::arg("filename") ), "Open the existing Amber NetCDF trajectory filename so that new frames\ncan be appended to it. The trajectory must have been created with\nan unlimited frame dimension (as done by this class)") );
+        AmberTrajectoryWriter_exposer.def( bp::init< QString const &, int, bp::optional< bool, bool, bool, QString const &, bool > >(( bp::arg("filename"), bp::arg("natoms"), bp::arg("write_velocities")=(bool)(false), bp::arg("write_forces")=(bool)(false), bp::arg("write_box")=(bool)(false), bp::arg("title")=::QString( ), bp::arg("overwrite_file")=(bool)(true) ), "Create a new Amber NetCDF trajectory file called filename that will\nhold frames of natoms atoms. Velocities, forces and the periodic\nbox will be written as well as the coordinates if write_velocities,\nwrite_forces and write_box are true. The trajectory will have\nthe passed title, and an existing file will only be overwritten\nif overwrite_file is true") );
+        bp::scope AmberTrajectoryWriter_scope( AmberTrajectoryWriter_exposer );
+        { //::SireIO::AmberTrajectoryWriter::append
+        
+            typedef void ( ::SireIO::AmberTrajectoryWriter::*append_function_type)( double,::QVector< SireMaths::Vector > const & ) ;
+            append_function_type append_function_value( &::SireIO::AmberTrajectoryWriter::append );
+            
+            AmberTrajectoryWriter_exposer.def( 
+                "append"
+                , append_function_value
+                , ( bp::arg("time"), bp::arg("coordinates") )
+                , "Append a frame at time time (in picoseconds) with the passed coordinates\n(in angstroms) to the trajectory. This can only be used if the trajectory\ndoesnt also contain velocities, forces or a periodic box" );
+        
+        }
+        { //::SireIO::AmberTrajectoryWriter::append
+        
+            typedef void ( ::SireIO::AmberTrajectoryWriter::*append_function_type)( double,::QVector< SireMaths::Vector > const &,::SireMaths::Vector const &,::SireMaths::Vector const & ) ;
+            append_function_type append_function_value( &::SireIO::AmberTrajectoryWriter::append );
+            
+            AmberTrajectoryWriter_exposer.def( 
+                "append"
+                , append_function_value
+                , ( bp::arg("time"), bp::arg("coordinates"), bp::arg("box_dimensions"), bp::arg("box_angles") )
+                , "Append a frame at time time with the passed coordinates and periodic box\ndimensions (in angstroms) and angles (in degrees) to the trajectory" );
+        
+        }
+        { //::SireIO::AmberTrajectoryWriter::append
+        
+            typedef void ( ::SireIO::AmberTrajectoryWriter::*append_function_type)( double,::QVector< SireMaths::Vector > const &,::QVector< SireMaths::Vector > const &,::QVector< SireMaths::Vector > const &,::SireMaths::Vector const &,::SireMaths::Vector const & ) ;
+            append_function_type append_function_value( &::SireIO::AmberTrajectoryWriter::append );
+            
+            AmberTrajectoryWriter_exposer.def( 
+                "append"
+                , append_function_value
+                , ( bp::arg("time"), bp::arg("coordinates"), bp::arg("velocities"), bp::arg("forces"), bp::arg("box_dimensions"), bp::arg("box_angles") )
+                , "Append a frame at time time with the passed coordinates, velocities\n(in amber units), forces and periodic box to the trajectory. The velocities,\nforces and box are ignored if they are not written to this trajectory.\nThe frame is written straight to the file, so it is not held in memory" );
+        
+        }
+        { //::SireIO::AmberTrajectoryWriter::close
+        
+            typedef void ( ::SireIO::AmberTrajectoryWriter::*close_function_type)(  ) ;
+            close_function_type close_function_value( &::SireIO::AmberTrajectoryWriter::close );
+            
+            AmberTrajectoryWriter_exposer.def( 
+                "close"
+                , close_function_value
+                , "Close the trajectory. No more frames can be written after this" );
+        
+        }
+        { //::SireIO::AmberTrajectoryWriter::filename
+        
+            typedef ::QString ( ::SireIO::AmberTrajectoryWriter::*filename_function_type)(  ) const;
+            filename_function_type filename_function_value( &::SireIO::AmberTrajectoryWriter::filename );
+            
+            AmberTrajectoryWriter_exposer.def( 
+                "filename"
+                , filename_function_value
+                , "Return the name of the file being written" );
+        
+        }
+        { //::SireIO::AmberTrajectoryWriter::flush
+        
+            typedef void ( ::SireIO::AmberTrajectoryWriter::*flush_function_type)(  ) ;
+            flush_function_type flush_function_value( &::SireIO::AmberTrajectoryWriter::flush );
+            
+            AmberTrajectoryWriter_exposer.def( 
+                "flush"
+                , flush_function_value
+                , "Flush all of the frames written so far to disk, so that they can be\nread by other programs while the trajectory is still being written" );
+        
+        }
+        { //::SireIO::AmberTrajectoryWriter::isOpen
+        
+            typedef bool ( ::SireIO::AmberTrajectoryWriter::*isOpen_function_type)(  ) const;
+            isOpen_function_type isOpen_function_value( &::SireIO::AmberTrajectoryWriter::isOpen );
+            
+            AmberTrajectoryWriter_exposer.def( 
+                "isOpen"
+                , isOpen_function_value
+                , "Return whether or not the file is still open for writing" );
+        
+        }
+        { //::SireIO::AmberTrajectoryWriter::nAtoms
+        
+            typedef int ( ::SireIO::AmberTrajectoryWriter::*nAtoms_function_type)(  ) const;
+            nAtoms_function_type nAtoms_function_value( &::SireIO::AmberTrajectoryWriter::nAtoms );
+            
+            AmberTrajectoryWriter_exposer.def( 
+                "nAtoms"
+                , nAtoms_function_value
+                , "Return the number of atoms in each frame" );
+        
+        }
+        { //::SireIO::AmberTrajectoryWriter::nFrames
+        
+            typedef int ( ::SireIO::AmberTrajectoryWriter::*nFrames_function_type)(  ) const;
+            nFrames_function_type nFrames_function_value( &::SireIO::AmberTrajectoryWriter::nFrames );
+            
+            AmberTrajectoryWriter_exposer.def( 
+                "nFrames"
+                , nFrames_function_value
+                , "Return the number of frames written so far" );
+        
+        }
+        { //::SireIO::AmberTrajectoryWriter::toString
+        
+            typedef ::QString ( ::SireIO::AmberTrajectoryWriter::*toString_function_type)(  ) const;
+            toString_function_type toString_function_value( &::SireIO::AmberTrajectoryWriter::toString );
+            
+            AmberTrajectoryWriter_exposer.def( 
+                "toString"
+                , toString_function_value
+                , "" );
+        
+        }
+        { //::SireIO::AmberTrajectoryWriter::typeName
+        
+            typedef char const * ( *typeName_function_type )(  );
+            typeName_function_type typeName_function_value( &::SireIO::AmberTrajectoryWriter::typeName );
+            
+            AmberTrajectoryWriter_exposer.def( 
+                "typeName"
+                , typeName_function_value
+                , "" );
+        
+        }
+        { //::SireIO::AmberTrajectoryWriter::what
+        
+            typedef char const * ( ::SireIO::AmberTrajectoryWriter::*what_function_type)(  ) const;
+            what_function_type what_function_value( &::SireIO::AmberTrajectoryWriter::what );
+            
+            AmberTrajectoryWriter_exposer.def( 
+                "what"
+                , what_function_value
+                , "" );
+        
+        }
+        AmberTrajectoryWriter_exposer.staticmethod( "typeName" );
+        AmberTrajectoryWriter_exposer.def( "__str__", &__str__< ::SireIO::AmberTrajectoryWriter > );
+        AmberTrajectoryWriter_exposer.def( "__repr__", &__str__< ::SireIO::AmberTrajectoryWriter > );
+    }
+
+}
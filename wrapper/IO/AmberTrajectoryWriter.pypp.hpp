@@ -0,0 +1,10 @@
+// This file has been generated by Py++.
+
+// (C) Christopher Woods, GPL >= 2 License
+
+#ifndef AmberTrajectoryWriter_hpp__pyplusplus_wrapper
+#define AmberTrajectoryWriter_hpp__pyplusplus_wrapper
+
+void register_AmberTrajectoryWriter_class();
+
+#endif//AmberTrajectoryWriter_hpp__pyplusplus_wrapper
@@ -0,0 +1,181 @@
+// This file has been generated by Py++.
+
+// (C) Christopher Woods, GPL >= 2 License
+
+#include "boost/python.hpp"
+#include "CompressedTrajectoryReader.pypp.hpp"
+
+namespace bp = boost::python;
+
+#include "SireError/errors.h"
+
+#include "SireIO/compressedtrajectory.h"
+
+#include "SireIO/errors.h"
+
+#include "SireStream/datastream.h"
+
+#include "compressedtrajectory.h"
+
+#include "Helpers/str.hpp"
+
+void register_CompressedTrajectoryReader_class(){
+
+    { //::SireIO::CompressedTrajectoryReader
+        typedef bp::class_< SireIO::CompressedTrajectoryReader, boost::noncopyable > CompressedTrajectoryReader_exposer_t;
+        CompressedTrajectoryReader_exposer_t CompressedTrajectoryReader_exposer = CompressedTrajectoryReader_exposer_t( "CompressedTrajectoryReader", "This class reads trajectories written by CompressedTrajectoryWriter.\nAn index of the frames is built when the file is opened, so that\nindividual frames can be read in any order without reading the\nrest of the file.\n\nAuthor: Christopher Woods\n", bp::init< QString const & >(( bp::arg("filename") ), "Open the compressed trajectory filename for reading") );
+        bp::scope CompressedTrajectoryReader_scope( CompressedTrajectoryReader_exposer );
+        { //::SireIO::CompressedTrajectoryReader::boxAngles
+        
+            typedef ::SireMaths::Vector ( ::SireIO::CompressedTrajectoryReader::*boxAngles_function_type)( int ) const;
+            boxAngles_function_type boxAngles_function_value( &::SireIO::CompressedTrajectoryReader::boxAngles );
+            
+            CompressedTrajectoryReader_exposer.def( 
+                "boxAngles"
+                , boxAngles_function_value
+                , ( bp::arg("frame") )
+                , "Return the angles of the periodic box (in degrees) of frame frame.\nThis returns a zero vector if the frame has no periodic box" );
+        
+        }
+        { //::SireIO::CompressedTrajectoryReader::boxDimensions
+        
+            typedef ::SireMaths::Vector ( ::SireIO::CompressedTrajectoryReader::*boxDimensions_function_type)( int ) const;
+            boxDimensions_function_type boxDimensions_function_value( &::SireIO::CompressedTrajectoryReader::boxDimensions );
+            
+            CompressedTrajectoryReader_exposer.def( 
+                "boxDimensions"
+                , boxDimensions_function_value
+                , ( bp::arg("frame") )
+                , "Return the dimensions of the periodic box (in angstroms) of frame frame.\nThis returns a zero vector if the frame has no periodic box" );
+        
+        }
+        { //::SireIO::CompressedTrajectoryReader::coordinates
+        
+            typedef ::QVector< SireMaths::Vector > ( ::SireIO::CompressedTrajectoryReader::*coordinates_function_type)( int ) const;
+            coordinates_function_type coordinates_function_value( &::SireIO::CompressedTrajectoryReader::coordinates );
+            
+            CompressedTrajectoryReader_exposer.def( 
+                "coordinates"
+                , coordinates_function_value
+                , ( bp::arg("frame") )
+                , "Return the coordinates (in angstroms) of the atoms in frame frame" );
+        
+        }
+        { //::SireIO::CompressedTrajectoryReader::filename
+        
+            typedef ::QString ( ::SireIO::CompressedTrajectoryReader::*filename_function_type)(  ) const;
+            filename_function_type filename_function_value( &::SireIO::CompressedTrajectoryReader::filename );
+            
+            CompressedTrajectoryReader_exposer.def( 
+                "filename"
+                , filename_function_value
+                , "Return the name of the file being read" );
+        
+        }
+        { //::SireIO::CompressedTrajectoryReader::hasBox
+        
+            typedef bool ( ::SireIO::CompressedTrajectoryReader::*hasBox_function_type)( int ) const;
+            hasBox_function_type hasBox_function_value( &::SireIO::CompressedTrajectoryReader::hasBox );
+            
+            CompressedTrajectoryReader_exposer.def( 
+                "hasBox"
+                , hasBox_function_value
+                , ( bp::arg("frame") )
+                , "Return whether or not frame frame has a periodic box" );
+        
+        }
+        { //::SireIO::CompressedTrajectoryReader::nAtoms
+        
+            typedef int ( ::SireIO::CompressedTrajectoryReader::*nAtoms_function_type)(  ) const;
+            nAtoms_function_type nAtoms_function_value( &::SireIO::CompressedTrajectoryReader::nAtoms );
+            
+            CompressedTrajectoryReader_exposer.def( 
+                "nAtoms"
+                , nAtoms_function_value
+                , "Return the number of atoms in each frame" );
+        
+        }
+        { //::SireIO::CompressedTrajectoryReader::nFrames
+        
+            typedef int ( ::SireIO::CompressedTrajectoryReader::*nFrames_function_type)(  ) const;
+            nFrames_function_type nFrames_function_value( &::SireIO::CompressedTrajectoryReader::nFrames );
+            
+            CompressedTrajectoryReader_exposer.def( 
+                "nFrames"
+                , nFrames_function_value
+                , "Return the number of frames that can be read" );
+        
+        }
+        { //::SireIO::CompressedTrajectoryReader::precision
+        
+            typedef double ( ::SireIO::CompressedTrajectoryReader::*precision_function_type)(  ) const;
+            precision_function_type precision_function_value( &::SireIO::CompressedTrajectoryReader::precision );
+            
+            CompressedTrajectoryReader_exposer.def( 
+                "precision"
+                , precision_function_value
+                , "Return the precision (in angstroms) to which the coordinates were stored" );
+        
+        }
+        { //::SireIO::CompressedTrajectoryReader::refresh
+        
+            typedef int ( ::SireIO::CompressedTrajectoryReader::*refresh_function_type)(  ) ;
+            refresh_function_type refresh_function_value( &::SireIO::CompressedTrajectoryReader::refresh );
+            
+            CompressedTrajectoryReader_exposer.def( 
+                "refresh"
+                , refresh_function_value
+                , "Refresh the reader so that it can see any frames that have been\nappended to the file since it was opened. This returns the new\nnumber of frames" );
+        
+        }
+        { //::SireIO::CompressedTrajectoryReader::time
+        
+            typedef double ( ::SireIO::CompressedTrajectoryReader::*time_function_type)( int ) const;
+            time_function_type time_function_value( &::SireIO::CompressedTrajectoryReader::time );
+            
+            CompressedTrajectoryReader_exposer.def( 
+                "time"
+                , time_function_value
+                , ( bp::arg("frame") )
+                , "Return the time (in picoseconds) of frame frame" );
+        
+        }
+        { //::SireIO::CompressedTrajectoryReader::toString
+        
+            typedef ::QString ( ::SireIO::CompressedTrajectoryReader::*toString_function_type)(  ) const;
+            toString_function_type toString_function_value( &::SireIO::CompressedTrajectoryReader::toString );
+            
+            CompressedTrajectoryReader_exposer.def( 
+                "toString"
+                , toString_function_value
+                , "" );
+        
+        }
+        { //::SireIO::CompressedTrajectoryReader::typeName
+        
+            typedef char const * ( *typeName_function_type )(  );
+            typeName_function_type typeName_function_value( &::SireIO::CompressedTrajectoryReader::typeName );
+            
+            CompressedTrajectoryReader_exposer.def( 
+                "typeName"
+                , typeName_function_value
+                , "" );
+        
+        }
+        { //::SireIO::CompressedTrajectoryReader::what
+        
+            typedef char const * ( ::SireIO::CompressedTrajectoryReader::*what_function_type)(  ) const;
+            what_function_type what_function_value( &::SireIO::CompressedTrajectoryReader::what );
+            
+            CompressedTrajectoryReader_exposer.def( 
+                "what"
+                , what_function_value
+                , "" );
+        
+        }
+        CompressedTrajectoryReader_exposer.staticmethod( "typeName" );
+        CompressedTrajectoryReader_exposer.def( "__str__", &__str__< ::SireIO::CompressedTrajectoryReader > );
+        CompressedTrajectoryReader_exposer.def( "__repr__", &__str__< ::SireIO::CompressedTrajectoryReader > );
+    }
+
+}
@@ -0,0 +1,10 @@
+// This file has been generated by Py++.
+
+// (C) Christopher Woods, GPL >= 2 License
+
+#ifndef CompressedTrajectoryReader_hpp__pyplusplus_wrapper
+#define CompressedTrajectoryReader_hpp__pyplusplus_wrapper
+
+void register_CompressedTrajectoryReader_class();
+
+#endif//CompressedTrajectoryReader_hpp__pyplusplus_wrapper
@@ -0,0 +1,168 @@
+// This file has been generated by Py++.
+
+// (C) Christopher Woods, GPL >= 2 License
+
+#include "boost/python.hpp"
+#include "CompressedTrajectoryWriter.pypp.hpp"
+
+namespace bp = boost::python;
+
+#include "SireError/errors.h"
+
+#include "SireIO/compressedtrajectory.h"
+
+#include "SireIO/errors.h"
+
+#include "SireStream/datastream.h"
+
+#include "compressedtrajectory.h"
+
+#include "Helpers/str.hpp"
+
+void register_CompressedTrajectoryWriter_class(){
+
+    { //::SireIO::CompressedTrajectoryWriter
+        typedef bp::class_< SireIO::CompressedTrajectoryWriter, boost::noncopyable > CompressedTrajectoryWriter_exposer_t;
+        CompressedTrajectoryWriter_exposer_t CompressedTrajectoryWriter_exposer = CompressedTrajectoryWriter_exposer_t( "CompressedTrajectoryWriter", "This class writes trajectories using a lossy, fixed-precision\ncompressed binary format, in the same spirit as the GROMACS XTC format.\n\nCoordinates are rounded to a fixed precision (by default 0.01 angstroms),\nconverted to integers, and each atom is stored as the (small) difference\nfrom the previous atom. These differences are packed into variable-length\nintegers and then compressed, so that a typical frame takes about a tenth\nof the space of the equivalent uncompressed binary frame, and much less\nthan a text (e.g. PDB) frame.\n\nEach frame is stored as an independent, size-prefixed record, so frames\ncan be appended to an existing trajectory, and a partially-written\ntrajectory can still be read. Only coordinates, times and the periodic\nbox (dimensions and angles) are stored.\n\nRead the trajectory using CompressedTrajectoryReader.\n\nAuthor: Christopher Woods\n", bp::init< QString const & >(( bp::arg("filename") ), "Open the existing compressed trajectory filename so that new frames\ncan be appended to it. Any incomplete frame at the end of the file\n(e.g. from a run that was killed while writing) is removed") );
+        CompressedTrajectoryWriter_exposer.def( bp::init< QString const &, int, bp::optional< double, bool > >(( bp::arg("filename"), bp::arg("natoms"), bp::arg("precision")=0.01, bp::arg("overwrite_file")=(bool)(true) ), "Create a new compressed trajectory called filename that will hold\nframes of natoms atoms, with coordinates stored to the passed\nprecision (in angstroms). An existing file will only be overwritten\nif overwrite_file is true") );
+        bp::scope CompressedTrajectoryWriter_scope( CompressedTrajectoryWriter_exposer );
+        { //::SireIO::CompressedTrajectoryWriter::append
+        
+            typedef void ( ::SireIO::CompressedTrajectoryWriter::*append_function_type)( double,::QVector< SireMaths::Vector > const & ) ;
+            append_function_type append_function_value( &::SireIO::CompressedTrajectoryWriter::append );
+            
+            CompressedTrajectoryWriter_exposer.def( 
+                "append"
+                , append_function_value
+                , ( bp::arg("time"), bp::arg("coordinates") )
+                , "Append a frame at time time (in picoseconds) with the passed\ncoordinates (in angstroms) to the trajectory" );
+        
+        }
+        { //::SireIO::CompressedTrajectoryWriter::append
+        
+            typedef void ( ::SireIO::CompressedTrajectoryWriter::*append_function_type)( double,::QVector< SireMaths::Vector > const &,::SireMaths::Vector const &,::SireMaths::Vector const & ) ;
+            append_function_type append_function_value( &::SireIO::CompressedTrajectoryWriter::append );
+            
+            CompressedTrajectoryWriter_exposer.def( 
+                "append"
+                , append_function_value
+                , ( bp::arg("time"), bp::arg("coordinates"), bp::arg("box_dimensions"), bp::arg("box_angles") )
+                , "Append a frame at time time with the passed coordinates and periodic\nbox dimensions (in angstroms) and angles (in degrees) to the trajectory" );
+        
+        }
+        { //::SireIO::CompressedTrajectoryWriter::close
+        
+            typedef void ( ::SireIO::CompressedTrajectoryWriter::*close_function_type)(  ) ;
+            close_function_type close_function_value( &::SireIO::CompressedTrajectoryWriter::close );
+            
+            CompressedTrajectoryWriter_exposer.def( 
+                "close"
+                , close_function_value
+                , "Close the trajectory. No more frames can be written after this" );
+        
+        }
+        { //::SireIO::CompressedTrajectoryWriter::filename
+        
+            typedef ::QString ( ::SireIO::CompressedTrajectoryWriter::*filename_function_type)(  ) const;
+            filename_function_type filename_function_value( &::SireIO::CompressedTrajectoryWriter::filename );
+            
+            CompressedTrajectoryWriter_exposer.def( 
+                "filename"
+                , filename_function_value
+                , "Return the name of the file being written" );
+        
+        }
+        { //::SireIO::CompressedTrajectoryWriter::flush
+        
+            typedef void ( ::SireIO::CompressedTrajectoryWriter::*flush_function_type)(  ) ;
+            flush_function_type flush_function_value( &::SireIO::CompressedTrajectoryWriter::flush );
+            
+            CompressedTrajectoryWriter_exposer.def( 
+                "flush"
+                , flush_function_value
+                , "Flush all of the frames written so far to disk" );
+        
+        }
+        { //::SireIO::CompressedTrajectoryWriter::isOpen
+        
+            typedef bool ( ::SireIO::CompressedTrajectoryWriter::*isOpen_function_type)(  ) const;
+            isOpen_function_type isOpen_function_value( &::SireIO::CompressedTrajectoryWriter::isOpen );
+            
+            CompressedTrajectoryWriter_exposer.def( 
+                "isOpen"
+                , isOpen_function_value
+                , "Return whether or not the file is still open for writing" );
+        
+        }
+        { //::SireIO::CompressedTrajectoryWriter::nAtoms
+        
+            typedef int ( ::SireIO::CompressedTrajectoryWriter::*nAtoms_function_type)(  ) const;
+            nAtoms_function_type nAtoms_function_value( &::SireIO::CompressedTrajectoryWriter::nAtoms );
+            
+            CompressedTrajectoryWriter_exposer.def( 
+                "nAtoms"
+                , nAtoms_function_value
+                , "Return the number of atoms in each frame" );
+        
+        }
+        { //::SireIO::CompressedTrajectoryWriter::nFrames
+        
+            typedef int ( ::SireIO::CompressedTrajectoryWriter::*nFrames_function_type)(  ) const;
+            nFrames_function_type nFrames_function_value( &::SireIO::CompressedTrajectoryWriter::nFrames );
+            
+            CompressedTrajectoryWriter_exposer.def( 
+                "nFrames"
+                , nFrames_function_value
+                , "Return the number of frames in the trajectory" );
+        
+        }
+        { //::SireIO::CompressedTrajectoryWriter::precision
+        
+            typedef double ( ::SireIO::CompressedTrajectoryWriter::*precision_function_type)(  ) const;
+            precision_function_type precision_function_value( &::SireIO::CompressedTrajectoryWriter::precision );
+            
+            CompressedTrajectoryWriter_exposer.def( 
+                "precision"
+                , precision_function_value
+                , "Return the precision (in angstroms) to which coordinates are stored" );
+        
+        }
+        { //::SireIO::CompressedTrajectoryWriter::toString
+        
+            typedef ::QString ( ::SireIO::CompressedTrajectoryWriter::*toString_function_type)(  ) const;
+            toString_function_type toString_function_value( &::SireIO::CompressedTrajectoryWriter::toString );
+            
+            CompressedTrajectoryWriter_exposer.def( 
+                "toString"
+                , toString_function_value
+                , "" );
+        
+        }
+        { //::SireIO::CompressedTrajectoryWriter::typeName
+        
+            typedef char const * ( *typeName_function_type )(  );
+            typeName_function_type typeName_function_value( &::SireIO::CompressedTrajectoryWriter::typeName );
+            
+            CompressedTrajectoryWriter_exposer.def( 
+                "typeName"
+                , typeName_function_value
+                , "" );
+        
+        }
+        { //::SireIO::CompressedTrajectoryWriter::what
+        
+            typedef char const * ( ::SireIO::CompressedTrajectoryWriter::*what_function_type)(  ) const;
+            what_function_type what_function_value( &::SireIO::CompressedTrajectoryWriter::what );
+            
+            CompressedTrajectoryWriter_exposer.def( 
+                "what"
+                , what_function_value
+                , "" );
+        
+        }
+        CompressedTrajectoryWriter_exposer.staticmethod( "typeName" );
+        CompressedTrajectoryWriter_exposer.def( "__str__", &__str__< ::SireIO::CompressedTrajectoryWriter > );
+        CompressedTrajectoryWriter_exposer.def( "__repr__", &__str__< ::SireIO::CompressedTrajectoryWriter > );
+    }
+
+}
@@ -0,0 +1,10 @@
+// This file has been generated by Py++.
+
+// (C) Christopher Woods, GPL >= 2 License
+
+#ifndef CompressedTrajectoryWriter_hpp__pyplusplus_wrapper
+#define CompressedTrajectoryWriter_hpp__pyplusplus_wrapper
+
+void register_CompressedTrajectoryWriter_class();
+
+#endif//CompressedTrajectoryWriter_hpp__pyplusplus_wrapper
@@ -43,6 +43,8 @@
 #include "SireIO/moleculeparser.h"
 #include "SireIO/grotop.h"
 
+#include "SireMaths/vector.h"
+
 using namespace SireIO;
 
 using boost::python::register_tuple;
@@ -53,4 +55,6 @@ void register_SireIO_containers()
 
     register_list< QVector<GroMolType> >();
     register_list< QVector<GroAtom> >();
+
+    register_list< QVector< QVector<SireMaths::Vector> > >();
 }
@@ -0,0 +1,200 @@
+// This file has been generated by Py++.
+
+// (C) Christopher Woods, GPL >= 2 License
+
+#include "boost/python.hpp"
+#include "TextFileView.pypp.hpp"
+
+namespace bp = boost::python;
+
+#include "SireBase/parallel.h"
+
+#include "SireError/errors.h"
+
+#include "textfileview.h"
+
+SireIO::TextFileView __copy__(const SireIO::TextFileView &other){ return SireIO::TextFileView(other); }
+
+#include "Helpers/str.hpp"
+
+#include "Helpers/len.hpp"
+
+void register_TextFileView_class(){
+
+    { //::SireIO::TextFileView
+        typedef bp::class_< SireIO::TextFileView > TextFileView_exposer_t;
+        TextFileView_exposer_t TextFileView_exposer = TextFileView_exposer_t( "TextFileView", "This class provides a read-only, line-indexed view of the bytes of\na text file. The file is memory-mapped (so it is not copied into\nmemory), and the positions of all of the line breaks are found\nusing a parallel scan. Individual lines can then be accessed either\nas raw bytes (without any copying or conversion) or as QStrings,\nwhich are only created for the lines that are requested.\n\nLines are split on \"\\n\", \"\\r\\n\" or a lone \"\\r\", and the line\nbreaks are not included in the lines. This matches QTextStream::readLine\nfor files with \"\\n\" or \"\\r\\n\" line endings, while also splitting\nfiles that use \"\\r\" (which QTextStream would read as a single line).\n\nMoleculeParser::readTextFile uses this class to read files, but\nstill converts every line to a QString, as the parsers hold their\nlines as QStrings. None of the parsers yet read directly from\na TextFileView.\n\nCopies of a TextFileView share the same mapped file.\n\nAuthor: Christopher Woods\n", bp::init< >("Null constructor") );
+        bp::scope TextFileView_scope( TextFileView_exposer );
+        TextFileView_exposer.def( bp::init< QString const &, bp::optional< bool > >(( bp::arg("filename"), bp::arg("run_parallel")=(bool)(true) ), "Construct a view of the text file filename. The file is memory-mapped\nand the line breaks are found in parallel if run_parallel is true") );
+        TextFileView_exposer.def( bp::init< SireIO::TextFileView const & >(( bp::arg("other") ), "Copy constructor") );
+        { //::SireIO::TextFileView::count
+        
+            typedef int ( ::SireIO::TextFileView::*count_function_type)(  ) const;
+            count_function_type count_function_value( &::SireIO::TextFileView::count );
+            
+            TextFileView_exposer.def( 
+                "count"
+                , count_function_value
+                , "Return the number of lines in the file" );
+        
+        }
+        { //::SireIO::TextFileView::filename
+        
+            typedef ::QString ( ::SireIO::TextFileView::*filename_function_type)(  ) const;
+            filename_function_type filename_function_value( &::SireIO::TextFileView::filename );
+            
+            TextFileView_exposer.def( 
+                "filename"
+                , filename_function_value
+                , "Return the name of the file being viewed" );
+        
+        }
+        { //::SireIO::TextFileView::isEmpty
+        
+            typedef bool ( ::SireIO::TextFileView::*isEmpty_function_type)(  ) const;
+            isEmpty_function_type isEmpty_function_value( &::SireIO::TextFileView::isEmpty );
+            
+            TextFileView_exposer.def( 
+                "isEmpty"
+                , isEmpty_function_value
+                , "Return whether or not there are no lines in the view" );
+        
+        }
+        { //::SireIO::TextFileView::line
+        
+            typedef ::QString ( ::SireIO::TextFileView::*line_function_type)( int ) const;
+            line_function_type line_function_value( &::SireIO::TextFileView::line );
+            
+            TextFileView_exposer.def( 
+                "line"
+                , line_function_value
+                , ( bp::arg("i") )
+                , "Return the ith line, converted from UTF-8 into a QString" );
+        
+        }
+        { //::SireIO::TextFileView::lineLength
+        
+            typedef int ( ::SireIO::TextFileView::*lineLength_function_type)( int ) const;
+            lineLength_function_type lineLength_function_value( &::SireIO::TextFileView::lineLength );
+            
+            TextFileView_exposer.def( 
+                "lineLength"
+                , lineLength_function_value
+                , ( bp::arg("i") )
+                , "Return the number of bytes in the ith line (excluding the line break)" );
+        
+        }
+        { //::SireIO::TextFileView::lineStartsWith
+        
+            typedef bool ( ::SireIO::TextFileView::*lineStartsWith_function_type)( int,char const * ) const;
+            lineStartsWith_function_type lineStartsWith_function_value( &::SireIO::TextFileView::lineStartsWith );
+            
+            TextFileView_exposer.def( 
+                "lineStartsWith"
+                , lineStartsWith_function_value
+                , ( bp::arg("i"), bp::arg("prefix") )
+                , "Return whether or not the ith line starts with prefix. This\ndoesnt create a QString for the line, so can be used to quickly\nskip uninteresting lines" );
+        
+        }
+        { //::SireIO::TextFileView::nLines
+        
+            typedef int ( ::SireIO::TextFileView::*nLines_function_type)(  ) const;
+            nLines_function_type nLines_function_value( &::SireIO::TextFileView::nLines );
+            
+            TextFileView_exposer.def( 
+                "nLines"
+                , nLines_function_value
+                , "Return the number of lines in the file" );
+        
+        }
+        { //::SireIO::TextFileView::operator=
+        
+            typedef ::SireIO::TextFileView & ( ::SireIO::TextFileView::*assign_function_type)( ::SireIO::TextFileView const & ) ;
+            assign_function_type assign_function_value( &::SireIO::TextFileView::operator= );
+            
+            TextFileView_exposer.def( 
+                "assign"
+                , assign_function_value
+                , ( bp::arg("other") )
+                , bp::return_self< >()
+                , "" );
+        
+        }
+        { //::SireIO::TextFileView::operator[]
+        
+            typedef ::QString ( ::SireIO::TextFileView::*__getitem___function_type)( int ) const;
+            __getitem___function_type __getitem___function_value( &::SireIO::TextFileView::operator[] );
+            
+            TextFileView_exposer.def( 
+                "__getitem__"
+                , __getitem___function_value
+                , ( bp::arg("i") )
+                , "Return the ith line, converted from UTF-8 into a QString" );
+        
+        }
+        { //::SireIO::TextFileView::size
+        
+            typedef ::qint64 ( ::SireIO::TextFileView::*size_function_type)(  ) const;
+            size_function_type size_function_value( &::SireIO::TextFileView::size );
+            
+            TextFileView_exposer.def( 
+                "size"
+                , size_function_value
+                , "Return the number of bytes in the file" );
+        
+        }
+        { //::SireIO::TextFileView::toLines
+        
+            typedef ::QVector< QString > ( ::SireIO::TextFileView::*toLines_function_type)( bool ) const;
+            toLines_function_type toLines_function_value( &::SireIO::TextFileView::toLines );
+            
+            TextFileView_exposer.def( 
+                "toLines"
+                , toLines_function_value
+                , ( bp::arg("run_parallel")=(bool)(true) )
+                , "Return all of the lines as QStrings. The lines are converted in parallel\nif run_parallel is true" );
+        
+        }
+        { //::SireIO::TextFileView::toString
+        
+            typedef ::QString ( ::SireIO::TextFileView::*toString_function_type)(  ) const;
+            toString_function_type toString_function_value( &::SireIO::TextFileView::toString );
+            
+            TextFileView_exposer.def( 
+                "toString"
+                , toString_function_value
+                , "" );
+        
+        }
+        { //::SireIO::TextFileView::typeName
+        
+            typedef char const * ( *typeName_function_type )(  );
+            typeName_function_type typeName_function_value( &::SireIO::TextFileView::typeName );
+            
+            TextFileView_exposer.def( 
+                "typeName"
+                , typeName_function_value
+                , "" );
+        
+        }
+        { //::SireIO::TextFileView::what
+        
+            typedef char const * ( ::SireIO::TextFileView::*what_function_type)(  ) const;
+            what_function_type what_function_value( &::SireIO::TextFileView::what );
+            
+            TextFileView_exposer.def( 
+                "what"
+                , what_function_value
+                , "" );
+        
+        }
+        TextFileView_exposer.staticmethod( "typeName" );
+        TextFileView_exposer.def( "__copy__", &__copy__);
+        TextFileView_exposer.def( "__deepcopy__", &__copy__);
+        TextFileView_exposer.def( "clone", &__copy__);
+        TextFileView_exposer.def( "__str__", &__str__< ::SireIO::TextFileView > );
+        TextFileView_exposer.def( "__repr__", &__str__< ::SireIO::TextFileView > );
+        TextFileView_exposer.def( "__len__", &__len_count< ::SireIO::TextFileView > );
+    }
+
+}
@@ -0,0 +1,10 @@
+// This file has been generated by Py++.
+
+// (C) Christopher Woods, GPL >= 2 License
+
+#ifndef TextFileView_hpp__pyplusplus_wrapper
+#define TextFileView_hpp__pyplusplus_wrapper
+
+void register_TextFileView_class();
+
+#endif//TextFileView_hpp__pyplusplus_wrapper
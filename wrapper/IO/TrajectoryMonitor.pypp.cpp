@@ -62,6 +62,17 @@ void register_TrajectoryMonitor_class(){
                 , clearStatistics_function_value
                 , "Clear all statistics - this will clear all frames of the trajectory" );
         
+        }
+        { //::SireIO::TrajectoryMonitor::flush
+        
+            typedef void ( ::SireIO::TrajectoryMonitor::*flush_function_type)(  ) const;
+            flush_function_type flush_function_value( &::SireIO::TrajectoryMonitor::flush );
+            
+            TrajectoryMonitor_exposer.def( 
+                "flush"
+                , flush_function_value
+                , "Wait until all of the frames streamed to the binary trajectory file have\nbeen written, and flush the file to disk" );
+        
         }
         { //::SireIO::TrajectoryMonitor::monitor
         
@@ -74,6 +85,17 @@ void register_TrajectoryMonitor_class(){
                 , ( bp::arg("system") )
                 , "Monitor the system, writing an additional frame of the trajectory\nto this monitor" );
         
+        }
+        { //::SireIO::TrajectoryMonitor::nFrames
+        
+            typedef int ( ::SireIO::TrajectoryMonitor::*nFrames_function_type)(  ) const;
+            nFrames_function_type nFrames_function_value( &::SireIO::TrajectoryMonitor::nFrames );
+            
+            TrajectoryMonitor_exposer.def( 
+                "nFrames"
+                , nFrames_function_value
+                , "Return the number of frames that have been monitored. For a binary\ntrajectory file this is the number of frames written by this monitor\n(including those still waiting to be written)" );
+        
         }
         TrajectoryMonitor_exposer.def( bp::self != bp::self );
         { //::SireIO::TrajectoryMonitor::operator=
@@ -101,6 +123,40 @@ void register_TrajectoryMonitor_class(){
                 , ( bp::arg("tempdir") )
                 , "Set the temporary directory used to store the trajectory as it\nis being monitored during the simulation" );
         
+        }
+        { //::SireIO::TrajectoryMonitor::setTrajectoryFile
+        
+            typedef void ( ::SireIO::TrajectoryMonitor::*setTrajectoryFile_function_type)( ::QString const &,::QString const &,double ) ;
+            setTrajectoryFile_function_type setTrajectoryFile_function_value( &::SireIO::TrajectoryMonitor::setTrajectoryFile );
+            
+            TrajectoryMonitor_exposer.def( 
+                "setTrajectoryFile"
+                , setTrajectoryFile_function_value
+                , ( bp::arg("filename"), bp::arg("format")="netcdf", bp::arg("precision")=0.01 )
+                , "Stream the trajectory directly into the binary trajectory file filename,\nrather than writing each frame using the IOBase writer. The format is\neither \"netcdf\" (Amber NetCDF trajectory) or \"compressed\" (lossy compressed\ntrajectory, storing coordinates to precision angstroms, which can be\nread using CompressedTrajectoryReader). The frames are written by a\nbackground thread. This starts a new file (overwriting any existing file).\nPass an empty filename to go back to writing frames using the IOBase writer.\nA monitor that is restored from a checkpoint appends to this file, sharing\na single writer between all copies. The file is not truncated on restore,\nso any frames written after the checkpoint was saved remain in the file,\nbefore the frames of the restarted run" );
+        
+        }
+        { //::SireIO::TrajectoryMonitor::trajectoryFile
+        
+            typedef ::QString ( ::SireIO::TrajectoryMonitor::*trajectoryFile_function_type)(  ) const;
+            trajectoryFile_function_type trajectoryFile_function_value( &::SireIO::TrajectoryMonitor::trajectoryFile );
+            
+            TrajectoryMonitor_exposer.def( 
+                "trajectoryFile"
+                , trajectoryFile_function_value
+                , "Return the name of the binary trajectory file to which frames are streamed.\nThis is empty if frames are written using the IOBase writer" );
+        
+        }
+        { //::SireIO::TrajectoryMonitor::trajectoryFormat
+        
+            typedef ::QString ( ::SireIO::TrajectoryMonitor::*trajectoryFormat_function_type)(  ) const;
+            trajectoryFormat_function_type trajectoryFormat_function_value( &::SireIO::TrajectoryMonitor::trajectoryFormat );
+            
+            TrajectoryMonitor_exposer.def( 
+                "trajectoryFormat"
+                , trajectoryFormat_function_value
+                , "Return the format of the binary trajectory file" );
+        
         }
         { //::SireIO::TrajectoryMonitor::typeName
         
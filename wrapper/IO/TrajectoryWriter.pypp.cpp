@@ -0,0 +1,192 @@
+// This file has been generated by Py++.
+
+// (C) Christopher Woods, GPL >= 2 License
+
+#include "boost/python.hpp"
+#include "TrajectoryWriter.pypp.hpp"
+
+namespace bp = boost::python;
+
+#include "SireError/errors.h"
+
+#include "SireIO/ambertrajectory.h"
+
+#include "SireIO/compressedtrajectory.h"
+
+#include "SireIO/trajectorywriter.h"
+
+#include <QDebug>
+
+#include "trajectorywriter.h"
+
+#include "Helpers/str.hpp"
+
+void register_TrajectoryWriter_class(){
+
+    { //::SireIO::TrajectoryWriter
+        typedef bp::class_< SireIO::TrajectoryWriter, boost::noncopyable > TrajectoryWriter_exposer_t;
+        TrajectoryWriter_exposer_t TrajectoryWriter_exposer = TrajectoryWriter_exposer_t( "TrajectoryWriter", "This class writes a binary trajectory file asynchronously, using\na background thread. Frames are copied into a queue and the call\nreturns immediately, so the simulation thread never waits for\nthe disk. At most maxPending() frames are queued; if the disk\ncannot keep up then appending a new frame waits until space is\navailable, so that memory use stays bounded.\n\nTwo formats are supported;\n\n\"netcdf\" - Amber NetCDF trajectory (written using AmberTrajectoryWriter)\n\"compressed\" - lossy, fixed-precision compressed trajectory\n(written using CompressedTrajectoryWriter)\n\nThe file is created when the first frame is written, as this provides\nthe number of atoms and whether or not there is a periodic box.\n\nAny error raised while writing in the background is reported by the\nnext call to append, flush or close.\n\nAuthor: Christopher Woods\n", bp::init< QString const &, bp::optional< QString const &, double, bool, int > >(( bp::arg("filename"), bp::arg("format")="netcdf", bp::arg("precision")=0.01, bp::arg("append_to_file")=(bool)(false), bp::arg("max_pending")=(int)(32) ), "Construct a writer that will write the trajectory to the file filename\nusing the passed format (either \"netcdf\" or \"compressed\"). The precision\n(in angstroms) is used for the coordinates of compressed trajectories.\nIf append_to_file is true, then frames are appended to an existing\ntrajectory (if it exists), otherwise any existing file is overwritten.\nAt most max_pending frames will be held in memory waiting to be\nwritten. This starts the background thread used to write the frames") );
+        bp::scope TrajectoryWriter_scope( TrajectoryWriter_exposer );
+        { //::SireIO::TrajectoryWriter::append
+        
+            typedef void ( ::SireIO::TrajectoryWriter::*append_function_type)( double,::QVector< SireMaths::Vector > const & ) ;
+            append_function_type append_function_value( &::SireIO::TrajectoryWriter::append );
+            
+            TrajectoryWriter_exposer.def( 
+                "append"
+                , append_function_value
+                , ( bp::arg("time"), bp::arg("coordinates") )
+                , "Queue a frame at time time (in picoseconds) with the passed\ncoordinates (in angstroms) to be written. This returns immediately" );
+        
+        }
+        { //::SireIO::TrajectoryWriter::append
+        
+            typedef void ( ::SireIO::TrajectoryWriter::*append_function_type)( double,::QVector< SireMaths::Vector > const &,::SireMaths::Vector const &,::SireMaths::Vector const & ) ;
+            append_function_type append_function_value( &::SireIO::TrajectoryWriter::append );
+            
+            TrajectoryWriter_exposer.def( 
+                "append"
+                , append_function_value
+                , ( bp::arg("time"), bp::arg("coordinates"), bp::arg("box_dimensions"), bp::arg("box_angles") )
+                , "Queue a frame at time time with the passed coordinates and periodic\nbox dimensions (in angstroms) and angles (in degrees) to be written.\nThis returns immediately" );
+        
+        }
+        { //::SireIO::TrajectoryWriter::close
+        
+            typedef void ( ::SireIO::TrajectoryWriter::*close_function_type)(  ) ;
+            close_function_type close_function_value( &::SireIO::TrajectoryWriter::close );
+            
+            TrajectoryWriter_exposer.def( 
+                "close"
+                , close_function_value
+                , "Wait until all of the queued frames have been written, and then\nclose the file. No more frames can be written after this" );
+        
+        }
+        { //::SireIO::TrajectoryWriter::filename
+        
+            typedef ::QString ( ::SireIO::TrajectoryWriter::*filename_function_type)(  ) const;
+            filename_function_type filename_function_value( &::SireIO::TrajectoryWriter::filename );
+            
+            TrajectoryWriter_exposer.def( 
+                "filename"
+                , filename_function_value
+                , "Return the name of the file being written" );
+        
+        }
+        { //::SireIO::TrajectoryWriter::flush
+        
+            typedef void ( ::SireIO::TrajectoryWriter::*flush_function_type)(  ) ;
+            flush_function_type flush_function_value( &::SireIO::TrajectoryWriter::flush );
+            
+            TrajectoryWriter_exposer.def( 
+                "flush"
+                , flush_function_value
+                , "Wait until all of the queued frames have been written, and then\nflush the file to disk, so that it can be read by other programs" );
+        
+        }
+        { //::SireIO::TrajectoryWriter::format
+        
+            typedef ::QString ( ::SireIO::TrajectoryWriter::*format_function_type)(  ) const;
+            format_function_type format_function_value( &::SireIO::TrajectoryWriter::format );
+            
+            TrajectoryWriter_exposer.def( 
+                "format"
+                , format_function_value
+                , "Return the format of the file being written" );
+        
+        }
+        { //::SireIO::TrajectoryWriter::maxPending
+        
+            typedef int ( ::SireIO::TrajectoryWriter::*maxPending_function_type)(  ) const;
+            maxPending_function_type maxPending_function_value( &::SireIO::TrajectoryWriter::maxPending );
+            
+            TrajectoryWriter_exposer.def( 
+                "maxPending"
+                , maxPending_function_value
+                , "Return the maximum number of frames that can be waiting to be written" );
+        
+        }
+        { //::SireIO::TrajectoryWriter::nFrames
+        
+            typedef int ( ::SireIO::TrajectoryWriter::*nFrames_function_type)(  ) const;
+            nFrames_function_type nFrames_function_value( &::SireIO::TrajectoryWriter::nFrames );
+            
+            TrajectoryWriter_exposer.def( 
+                "nFrames"
+                , nFrames_function_value
+                , "Return the number of frames that have been written to the file" );
+        
+        }
+        { //::SireIO::TrajectoryWriter::nPending
+        
+            typedef int ( ::SireIO::TrajectoryWriter::*nPending_function_type)(  ) const;
+            nPending_function_type nPending_function_value( &::SireIO::TrajectoryWriter::nPending );
+            
+            TrajectoryWriter_exposer.def( 
+                "nPending"
+                , nPending_function_value
+                , "Return the number of frames that are waiting to be written" );
+        
+        }
+        { //::SireIO::TrajectoryWriter::precision
+        
+            typedef double ( ::SireIO::TrajectoryWriter::*precision_function_type)(  ) const;
+            precision_function_type precision_function_value( &::SireIO::TrajectoryWriter::precision );
+            
+            TrajectoryWriter_exposer.def( 
+                "precision"
+                , precision_function_value
+                , "Return the precision (in angstroms) of the coordinates written\nto compressed trajectories" );
+        
+        }
+        { //::SireIO::TrajectoryWriter::supportedFormats
+        
+            typedef ::QStringList ( *supportedFormats_function_type )(  );
+            supportedFormats_function_type supportedFormats_function_value( &::SireIO::TrajectoryWriter::supportedFormats );
+            
+            TrajectoryWriter_exposer.def( 
+                "supportedFormats"
+                , supportedFormats_function_value
+                , "Return the formats that can be written" );
+        
+        }
+        { //::SireIO::TrajectoryWriter::toString
+        
+            typedef ::QString ( ::SireIO::TrajectoryWriter::*toString_function_type)(  ) const;
+            toString_function_type toString_function_value( &::SireIO::TrajectoryWriter::toString );
+            
+            TrajectoryWriter_exposer.def( 
+                "toString"
+                , toString_function_value
+                , "" );
+        
+        }
+        { //::SireIO::TrajectoryWriter::typeName
+        
+            typedef char const * ( *typeName_function_type )(  );
+            typeName_function_type typeName_function_value( &::SireIO::TrajectoryWriter::typeName );
+            
+            TrajectoryWriter_exposer.def( 
+                "typeName"
+                , typeName_function_value
+                , "" );
+        
+        }
+        { //::SireIO::TrajectoryWriter::what
+        
+            typedef char const * ( ::SireIO::TrajectoryWriter::*what_function_type)(  ) const;
+            what_function_type what_function_value( &::SireIO::TrajectoryWriter::what );
+            
+            TrajectoryWriter_exposer.def( 
+                "what"
+                , what_function_value
+                , "" );
+        
+        }
+        TrajectoryWriter_exposer.staticmethod( "supportedFormats" );
+        TrajectoryWriter_exposer.staticmethod( "typeName" );
+        TrajectoryWriter_exposer.def( "__str__", &__str__< ::SireIO::TrajectoryWriter > );
+        TrajectoryWriter_exposer.def( "__repr__", &__str__< ::SireIO::TrajectoryWriter > );
+    }
+
+}
@@ -13,8 +13,16 @@
 
 #include "AmberRst7.pypp.hpp"
 
+#include "AmberTrajectoryReader.pypp.hpp"
+
+#include "AmberTrajectoryWriter.pypp.hpp"
+
 #include "CharmmPSF.pypp.hpp"
 
+#include "CompressedTrajectoryReader.pypp.hpp"
+
+#include "CompressedTrajectoryWriter.pypp.hpp"
+
 #include "Cube.pypp.hpp"
 
 #include "FlexibilityLibrary.pypp.hpp"
@@ -59,12 +67,16 @@
 
 #include "Supplementary.pypp.hpp"
 
+#include "TextFileView.pypp.hpp"
+
 #include "Tinker.pypp.hpp"
 
 #include "TinkerParameters.pypp.hpp"
 
 #include "TrajectoryMonitor.pypp.hpp"
 
+#include "TrajectoryWriter.pypp.hpp"
+
 #include "ZmatrixMaker.pypp.hpp"
 
 namespace bp = boost::python;
@@ -80,8 +92,16 @@ BOOST_PYTHON_MODULE(_IO){
 
     register_SireIO_containers();
 
+    register_AmberTrajectoryReader_class();
+
+    register_AmberTrajectoryWriter_class();
+
     register_Amber_class();
 
+    register_CompressedTrajectoryReader_class();
+
+    register_CompressedTrajectoryWriter_class();
+
     register_MoleculeParser_class();
 
     register_AmberPrm_class();
@@ -134,6 +154,8 @@ BOOST_PYTHON_MODULE(_IO){
 
     register_Supplementary_class();
 
+    register_TextFileView_class();
+
     register_Tinker_class();
 
     register_TinkerParameters_class();
@@ -142,6 +164,8 @@ BOOST_PYTHON_MODULE(_IO){
 
     register_SireIO_properties();
 
+    register_TrajectoryWriter_class();
+
     register_ZmatrixMaker_class();
 }
 
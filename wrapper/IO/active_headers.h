@@ -7,7 +7,9 @@
 #include "amberprm.h"
 #include "amberrst.h"
 #include "amberrst7.h"
+#include "ambertrajectory.h"
 #include "charmmpsf.h"
+#include "compressedtrajectory.h"
 #include "cube.h"
 #include "flexibilitylibrary.h"
 #include "gro87.h"
@@ -20,8 +22,10 @@
 #include "perturbationslibrary.h"
 #include "protoms.h"
 #include "supplementary.h"
+#include "textfileview.h"
 #include "tinker.h"
 #include "trajectorymonitor.h"
+#include "trajectorywriter.h"
 #include "zmatrixmaker.h"
 
 #endif
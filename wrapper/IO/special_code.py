@@ -0,0 +1,17 @@
+###############################################
+#
+# This file contains special code to help
+# with the wrapping of SireIO classes
+#
+#
+
+from pyplusplus.module_builder import call_policies
+
+def fix_TextFileView(c):
+   #these return pointers into (or shallow copies of) the mapped
+   #file, which are not null-terminated and which would outlive it
+   c.decls( "constData" ).exclude()
+   c.decls( "lineData" ).exclude()
+   c.decls( "lineBytes" ).exclude()
+
+special_code = { "SireIO::TextFileView" : fix_TextFileView }
@@ -553,6 +553,30 @@ void register_CLJAtoms_class(){
                 , toString_function_value
                 , "" );
         
+        }
+        { //::SireMM::CLJAtoms::translate
+        
+            typedef ::SireMM::CLJAtoms ( ::SireMM::CLJAtoms::*translate_function_type)( ::SireMaths::Vector const & ) const;
+            translate_function_type translate_function_value( &::SireMM::CLJAtoms::translate );
+            
+            CLJAtoms_exposer.def( 
+                "translate"
+                , translate_function_value
+                , ( bp::arg("delta") )
+                , "Return a copy of these CLJAtoms where all of the atoms have been\ntranslated by delta. This is used to create the periodic images\nof atoms in spaces whose minimum image cannot be calculated within\nthe CLJ kernels (e.g. SireVol::TriclinicBox)" );
+        
+        }
+        { //::SireMM::CLJAtoms::translate
+        
+            typedef void ( ::SireMM::CLJAtoms::*translate_function_type)( ::SireMaths::Vector const &,::SireMM::CLJAtoms & ) const;
+            translate_function_type translate_function_value( &::SireMM::CLJAtoms::translate );
+            
+            CLJAtoms_exposer.def( 
+                "translate"
+                , translate_function_value
+                , ( bp::arg("delta"), bp::arg("translated") )
+                , "Place into translated a copy of these CLJAtoms where all of the\natoms have been translated by delta. The coordinate arrays of\ntranslated are reused, so passing the same scratch CLJAtoms for\neach periodic image avoids allocating a new copy per image" );
+        
         }
         { //::SireMM::CLJAtoms::typeName
         
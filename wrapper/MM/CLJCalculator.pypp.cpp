@@ -109,6 +109,42 @@ void register_CLJCalculator_class(){
                 , ( bp::arg("funcs"), bp::arg("atoms0"), bp::arg("boxes1") )
                 , "Calculate the energy between all of the atoms in the passed atoms0 and atoms1\nusing the passed array of CLJFunctions, returning the energies as\na tuple of arrays of the coulomb and LJ energy (coulomb,lj)" );
         
+        }
+        { //::SireMM::CLJCalculator::calculate
+        
+            typedef ::boost::tuples::tuple< double, double, boost::tuples::null_type, boost::tuples::null_type, boost::tuples::null_type, boost::tuples::null_type, boost::tuples::null_type, boost::tuples::null_type, boost::tuples::null_type, boost::tuples::null_type > ( ::SireMM::CLJCalculator::*calculate_function_type)( ::SireMM::CLJFunction const &,::SireMM::CLJAtoms const &,::SireMM::CLJNeighbourList & ) const;
+            calculate_function_type calculate_function_value( &::SireMM::CLJCalculator::calculate );
+            
+            CLJCalculator_exposer.def( 
+                "calculate"
+                , calculate_function_value
+                , ( bp::arg("func"), bp::arg("atoms"), bp::arg("neighbours") )
+                , "Calculate the energy between all of the atoms in atoms using the passed\nCLJFunction, using the passed Verlet neighbour list to find the pairs\nof atoms to evaluate. The neighbour list is updated (and rebuilt only\nif any atom has moved by more than half its skin), so should be\nkept and passed again on the next call. This returns\nthe coulomb and LJ energy as a tuple (coulomb,lj)" );
+        
+        }
+        { //::SireMM::CLJCalculator::calculateForces
+        
+            typedef ::SireMM::CLJForces ( ::SireMM::CLJCalculator::*calculateForces_function_type)( ::SireMM::CLJFunction const &,::SireMM::CLJAtoms const & ) const;
+            calculateForces_function_type calculateForces_function_value( &::SireMM::CLJCalculator::calculateForces );
+            
+            CLJCalculator_exposer.def( 
+                "calculateForces"
+                , calculateForces_function_value
+                , ( bp::arg("func"), bp::arg("atoms") )
+                , "Calculate the forces between all of the atoms in atoms using the\npassed CLJFunction. The atoms are divided into boxes so that the\nforces can be calculated in parallel. The forces are returned in\nthe same order as the atoms in atoms\nThrow: SireError::unsupported\n" );
+        
+        }
+        { //::SireMM::CLJCalculator::calculateForces
+        
+            typedef ::QVector< SireMM::CLJForces > ( ::SireMM::CLJCalculator::*calculateForces_function_type)( ::SireMM::CLJFunction const &,::SireMM::CLJBoxes const & ) const;
+            calculateForces_function_type calculateForces_function_value( &::SireMM::CLJCalculator::calculateForces );
+            
+            CLJCalculator_exposer.def( 
+                "calculateForces"
+                , calculateForces_function_value
+                , ( bp::arg("func"), bp::arg("boxes") )
+                , "Calculate the forces between all of the atoms in the passed CLJBoxes\nusing the passed CLJFunction. This returns one set of forces for\neach occupied box, in the same order as CLJBoxes::occupiedBoxes().\nUse the CLJForces(boxes, forces, indicies) constructor to gather\nthese back into the order of the original atoms. The forces are\ncalculated in parallel over the boxes\nThrow: SireError::unsupported\n" );
+        
         }
         CLJCalculator_exposer.def( bp::self != bp::self );
         { //::SireMM::CLJCalculator::operator=
@@ -0,0 +1,341 @@
+// This file has been generated by Py++.
+
+// (C) Christopher Woods, GPL >= 2 License
+
+#include "boost/python.hpp"
+#include "CLJEwald.pypp.hpp"
+
+namespace bp = boost::python;
+
+#include "SireError/errors.h"
+
+#include "SireMaths/constants.h"
+
+#include "SireMaths/multiint.h"
+
+#include "SireStream/datastream.h"
+
+#include "SireStream/shareddatastream.h"
+
+#include "cljboxes.h"
+
+#include "cljewald.h"
+
+#include "cljewald.h"
+
+SireMM::CLJEwald __copy__(const SireMM::CLJEwald &other){ return SireMM::CLJEwald(other); }
+
+#include "Qt/qdatastream.hpp"
+
+#include "Helpers/str.hpp"
+
+void register_CLJEwald_class(){
+
+    { //::SireMM::CLJEwald
+        typedef bp::class_< SireMM::CLJEwald > CLJEwald_exposer_t;
+        CLJEwald_exposer_t CLJEwald_exposer = CLJEwald_exposer_t( "CLJEwald", "This class calculates the reciprocal space part of a standard Ewald sum,\ncaching the structure factor S(k) = sum_i q_i exp(i k.r_i) of every\nk-vector. This makes it well suited to Monte Carlo moves that change\nonly one or a few molecules, as the change in the reciprocal space energy\ncan be calculated in O(N_moved x N_k) by adding the contributions of\nonly the moved atoms (using the old and new coordinates held in a CLJDelta)\ninto the cached structure factors. The loop over k-vectors is vectorised\nusing MultiFloat.\n\nThe Ewald screening parameter and the periodic box are taken from a\nCLJSPMEFunction, whose pair functions calculate the matching real space\nenergy. The long-range energy returned by this class is the sum of the\nreciprocal space, self and excluded-pair energies, and so can be used\nin place of CLJSPMEMesh when the number of k-vectors is small.\n\nAs for CLJSPMEMesh, calculateDelta must be followed by either accept\nor revert.\n\nAuthor: Christopher Woods\n", bp::init< >("Constructor") );
+        bp::scope CLJEwald_scope( CLJEwald_exposer );
+        CLJEwald_exposer.def( bp::init< SireMM::CLJSPMEFunction const & >(( bp::arg("function") ), "Construct to use the passed function to define the Ewald sum. The\nnumber of k-vectors is chosen automatically from the Ewald precision") );
+        CLJEwald_exposer.def( bp::init< SireMM::CLJSPMEFunction const &, ::qint32 >(( bp::arg("function"), bp::arg("kmax") ), "Construct to use the passed function to define the Ewald sum, using\nk-vectors with integer components up to kmax along each dimension") );
+        CLJEwald_exposer.def( bp::init< SireMM::CLJSPMEFunction const &, SireMM::CLJAtoms const & >(( bp::arg("function"), bp::arg("atoms") ), "Construct the Ewald sum for the passed atoms using the passed function\nThrow: SireError::incompatible_error\n") );
+        CLJEwald_exposer.def( bp::init< SireMM::CLJSPMEFunction const &, SireMM::CLJBoxes const & >(( bp::arg("function"), bp::arg("atoms") ), "Construct the Ewald sum for the passed atoms using the passed function\nThrow: SireError::incompatible_error\n") );
+        CLJEwald_exposer.def( bp::init< SireMM::CLJEwald const & >(( bp::arg("other") ), "Copy constructor") );
+        { //::SireMM::CLJEwald::accept
+        
+            typedef void ( ::SireMM::CLJEwald::*accept_function_type)(  ) ;
+            accept_function_type accept_function_value( &::SireMM::CLJEwald::accept );
+            
+            CLJEwald_exposer.def( 
+                "accept"
+                , accept_function_value
+                , "Accept the pending change, adding it into the cached structure factors" );
+        
+        }
+        { //::SireMM::CLJEwald::calculateDelta
+        
+            typedef double ( ::SireMM::CLJEwald::*calculateDelta_function_type)( ::SireMM::CLJAtoms const &,::SireMM::CLJAtoms const & ) ;
+            calculateDelta_function_type calculateDelta_function_value( &::SireMM::CLJEwald::calculateDelta );
+            
+            CLJEwald_exposer.def( 
+                "calculateDelta"
+                , calculateDelta_function_value
+                , ( bp::arg("old_atoms"), bp::arg("new_atoms") )
+                , "Calculate the change in the long-range energy caused by changing\nthe atoms in old_atoms into the atoms in new_atoms. Only the\nchanged atoms are visited, so this scales as O(N_changed x N_k).\nThe change is held as pending until accept or revert are called.\nCalling this function while a change is pending will replace that change.\nThrow: SireError::invalid_state\n" );
+        
+        }
+        { //::SireMM::CLJEwald::calculateDelta
+        
+            typedef double ( ::SireMM::CLJEwald::*calculateDelta_function_type)( ::SireMM::CLJDelta const & ) ;
+            calculateDelta_function_type calculateDelta_function_value( &::SireMM::CLJEwald::calculateDelta );
+            
+            CLJEwald_exposer.def( 
+                "calculateDelta"
+                , calculateDelta_function_value
+                , ( bp::arg("delta") )
+                , "Calculate the change in the long-range energy caused by the passed delta.\nThe change is held as pending until accept or revert are called.\nThrow: SireError::invalid_state\n" );
+        
+        }
+        { //::SireMM::CLJEwald::calculateDelta
+        
+            typedef double ( ::SireMM::CLJEwald::*calculateDelta_function_type)( ::QVector< SireMM::CLJDelta > const & ) ;
+            calculateDelta_function_type calculateDelta_function_value( &::SireMM::CLJEwald::calculateDelta );
+            
+            CLJEwald_exposer.def( 
+                "calculateDelta"
+                , calculateDelta_function_value
+                , ( bp::arg("deltas") )
+                , "Calculate the change in the long-range energy caused by the passed deltas\n(e.g. from a move that changes several molecules at once). The change is\nheld as pending until accept or revert are called.\nThrow: SireError::invalid_state\n" );
+        
+        }
+        { //::SireMM::CLJEwald::correctionEnergy
+        
+            typedef double ( ::SireMM::CLJEwald::*correctionEnergy_function_type)(  ) const;
+            correctionEnergy_function_type correctionEnergy_function_value( &::SireMM::CLJEwald::correctionEnergy );
+            
+            CLJEwald_exposer.def( 
+                "correctionEnergy"
+                , correctionEnergy_function_value
+                , "Return the sum of the self and exclusion energies of the atoms" );
+        
+        }
+        { //::SireMM::CLJEwald::energy
+        
+            typedef double ( ::SireMM::CLJEwald::*energy_function_type)(  ) const;
+            energy_function_type energy_function_value( &::SireMM::CLJEwald::energy );
+            
+            CLJEwald_exposer.def( 
+                "energy"
+                , energy_function_value
+                , "Return the long-range energy (reciprocal space, self and exclusion)\nof the atoms. This does not include any pending change" );
+        
+        }
+        { //::SireMM::CLJEwald::function
+        
+            typedef ::SireMM::CLJSPMEFunction const & ( ::SireMM::CLJEwald::*function_function_type)(  ) const;
+            function_function_type function_function_value( &::SireMM::CLJEwald::function );
+            
+            CLJEwald_exposer.def( 
+                "function"
+                , function_function_value
+                , bp::return_value_policy<bp::clone_const_reference>()
+                , "Return the function used to define the Ewald sum" );
+        
+        }
+        { //::SireMM::CLJEwald::imaginaryStructureFactors
+        
+            typedef ::QVector< double > ( ::SireMM::CLJEwald::*imaginaryStructureFactors_function_type)(  ) const;
+            imaginaryStructureFactors_function_type imaginaryStructureFactors_function_value( &::SireMM::CLJEwald::imaginaryStructureFactors );
+            
+            CLJEwald_exposer.def( 
+                "imaginaryStructureFactors"
+                , imaginaryStructureFactors_function_value
+                , "Return the imaginary parts of the cached structure factors, one for\neach of the nKVectors() k-vectors" );
+        
+        }
+        { //::SireMM::CLJEwald::isEmpty
+        
+            typedef bool ( ::SireMM::CLJEwald::*isEmpty_function_type)(  ) const;
+            isEmpty_function_type isEmpty_function_value( &::SireMM::CLJEwald::isEmpty );
+            
+            CLJEwald_exposer.def( 
+                "isEmpty"
+                , isEmpty_function_value
+                , "Return whether or not this Ewald sum is empty (no atoms have been set)" );
+        
+        }
+        { //::SireMM::CLJEwald::kMax
+        
+            typedef ::qint32 ( ::SireMM::CLJEwald::*kMax_function_type)(  ) const;
+            kMax_function_type kMax_function_value( &::SireMM::CLJEwald::kMax );
+            
+            CLJEwald_exposer.def( 
+                "kMax"
+                , kMax_function_value
+                , "Return the maximum k-vector index along each dimension. This\nis zero if the k-vectors are chosen automatically" );
+        
+        }
+        { //::SireMM::CLJEwald::nAccepted
+        
+            typedef ::qint32 ( ::SireMM::CLJEwald::*nAccepted_function_type)(  ) const;
+            nAccepted_function_type nAccepted_function_value( &::SireMM::CLJEwald::nAccepted );
+            
+            CLJEwald_exposer.def( 
+                "nAccepted"
+                , nAccepted_function_value
+                , "Return the number of changes that have been accepted since the\nstructure factors were last built from scratch by setAtoms" );
+        
+        }
+        { //::SireMM::CLJEwald::nKVectors
+        
+            typedef int ( ::SireMM::CLJEwald::*nKVectors_function_type)(  ) const;
+            nKVectors_function_type nKVectors_function_value( &::SireMM::CLJEwald::nKVectors );
+            
+            CLJEwald_exposer.def( 
+                "nKVectors"
+                , nKVectors_function_value
+                , "Return the number of k-vectors in the (half) reciprocal space sum" );
+        
+        }
+        { //::SireMM::CLJEwald::needsAccepting
+        
+            typedef bool ( ::SireMM::CLJEwald::*needsAccepting_function_type)(  ) const;
+            needsAccepting_function_type needsAccepting_function_value( &::SireMM::CLJEwald::needsAccepting );
+            
+            CLJEwald_exposer.def( 
+                "needsAccepting"
+                , needsAccepting_function_value
+                , "Return whether or not there is a pending change that needs to be\naccepted or reverted" );
+        
+        }
+        { //::SireMM::CLJEwald::needsRefresh
+        
+            typedef bool ( ::SireMM::CLJEwald::*needsRefresh_function_type)(  ) const;
+            needsRefresh_function_type needsRefresh_function_value( &::SireMM::CLJEwald::needsRefresh );
+            
+            CLJEwald_exposer.def( 
+                "needsRefresh"
+                , needsRefresh_function_value
+                , "Return whether or not enough changes have been accepted that the\nstructure factors should be rebuilt from scratch, by passing the\ncurrent atoms to setAtoms. This limits the drift of the cached\nstructure factors caused by the single precision contributions\nof the moved atoms" );
+        
+        }
+        { //::SireMM::CLJEwald::realStructureFactors
+        
+            typedef ::QVector< double > ( ::SireMM::CLJEwald::*realStructureFactors_function_type)(  ) const;
+            realStructureFactors_function_type realStructureFactors_function_value( &::SireMM::CLJEwald::realStructureFactors );
+            
+            CLJEwald_exposer.def( 
+                "realStructureFactors"
+                , realStructureFactors_function_value
+                , "Return the real parts of the cached structure factors, one for\neach of the nKVectors() k-vectors" );
+        
+        }
+        CLJEwald_exposer.def( bp::self != bp::self );
+        { //::SireMM::CLJEwald::operator=
+        
+            typedef ::SireMM::CLJEwald & ( ::SireMM::CLJEwald::*assign_function_type)( ::SireMM::CLJEwald const & ) ;
+            assign_function_type assign_function_value( &::SireMM::CLJEwald::operator= );
+            
+            CLJEwald_exposer.def( 
+                "assign"
+                , assign_function_value
+                , ( bp::arg("other") )
+                , bp::return_self< >()
+                , "" );
+        
+        }
+        CLJEwald_exposer.def( bp::self == bp::self );
+        { //::SireMM::CLJEwald::reciprocalEnergy
+        
+            typedef double ( ::SireMM::CLJEwald::*reciprocalEnergy_function_type)(  ) const;
+            reciprocalEnergy_function_type reciprocalEnergy_function_value( &::SireMM::CLJEwald::reciprocalEnergy );
+            
+            CLJEwald_exposer.def( 
+                "reciprocalEnergy"
+                , reciprocalEnergy_function_value
+                , "Return the reciprocal space energy of the atoms" );
+        
+        }
+        { //::SireMM::CLJEwald::refreshInterval
+        
+            typedef ::qint32 ( ::SireMM::CLJEwald::*refreshInterval_function_type)(  ) const;
+            refreshInterval_function_type refreshInterval_function_value( &::SireMM::CLJEwald::refreshInterval );
+            
+            CLJEwald_exposer.def( 
+                "refreshInterval"
+                , refreshInterval_function_value
+                , "Return the number of accepted changes after which needsRefresh\nwill return true" );
+        
+        }
+        { //::SireMM::CLJEwald::revert
+        
+            typedef void ( ::SireMM::CLJEwald::*revert_function_type)(  ) ;
+            revert_function_type revert_function_value( &::SireMM::CLJEwald::revert );
+            
+            CLJEwald_exposer.def( 
+                "revert"
+                , revert_function_value
+                , "Revert (discard) the pending change" );
+        
+        }
+        { //::SireMM::CLJEwald::setAtoms
+        
+            typedef void ( ::SireMM::CLJEwald::*setAtoms_function_type)( ::SireMM::CLJAtoms const & ) ;
+            setAtoms_function_type setAtoms_function_value( &::SireMM::CLJEwald::setAtoms );
+            
+            CLJEwald_exposer.def( 
+                "setAtoms"
+                , setAtoms_function_value
+                , ( bp::arg("atoms") )
+                , "Recalculate the structure factors from scratch for the passed atoms.\nThis discards any pending change\nThrow: SireError::incompatible_error\n" );
+        
+        }
+        { //::SireMM::CLJEwald::setAtoms
+        
+            typedef void ( ::SireMM::CLJEwald::*setAtoms_function_type)( ::SireMM::CLJBoxes const & ) ;
+            setAtoms_function_type setAtoms_function_value( &::SireMM::CLJEwald::setAtoms );
+            
+            CLJEwald_exposer.def( 
+                "setAtoms"
+                , setAtoms_function_value
+                , ( bp::arg("atoms") )
+                , "Recalculate the structure factors from scratch for the passed atoms.\nThis discards any pending change\nThrow: SireError::incompatible_error\n" );
+        
+        }
+        { //::SireMM::CLJEwald::setRefreshInterval
+        
+            typedef void ( ::SireMM::CLJEwald::*setRefreshInterval_function_type)( ::qint32 ) ;
+            setRefreshInterval_function_type setRefreshInterval_function_value( &::SireMM::CLJEwald::setRefreshInterval );
+            
+            CLJEwald_exposer.def( 
+                "setRefreshInterval"
+                , setRefreshInterval_function_value
+                , ( bp::arg("interval") )
+                , "Set the number of accepted changes after which needsRefresh will\nreturn true\nThrow: SireError::invalid_arg\n" );
+        
+        }
+        { //::SireMM::CLJEwald::toString
+        
+            typedef ::QString ( ::SireMM::CLJEwald::*toString_function_type)(  ) const;
+            toString_function_type toString_function_value( &::SireMM::CLJEwald::toString );
+            
+            CLJEwald_exposer.def( 
+                "toString"
+                , toString_function_value
+                , "" );
+        
+        }
+        { //::SireMM::CLJEwald::typeName
+        
+            typedef char const * ( *typeName_function_type )(  );
+            typeName_function_type typeName_function_value( &::SireMM::CLJEwald::typeName );
+            
+            CLJEwald_exposer.def( 
+                "typeName"
+                , typeName_function_value
+                , "" );
+        
+        }
+        { //::SireMM::CLJEwald::what
+        
+            typedef char const * ( ::SireMM::CLJEwald::*what_function_type)(  ) const;
+            what_function_type what_function_value( &::SireMM::CLJEwald::what );
+            
+            CLJEwald_exposer.def( 
+                "what"
+                , what_function_value
+                , "" );
+        
+        }
+        CLJEwald_exposer.staticmethod( "typeName" );
+        CLJEwald_exposer.def( "__copy__", &__copy__);
+        CLJEwald_exposer.def( "__deepcopy__", &__copy__);
+        CLJEwald_exposer.def( "clone", &__copy__);
+        CLJEwald_exposer.def( "__rlshift__", &__rlshift__QDataStream< ::SireMM::CLJEwald >,
+                            bp::return_internal_reference<1, bp::with_custodian_and_ward<1,2> >() );
+        CLJEwald_exposer.def( "__rrshift__", &__rrshift__QDataStream< ::SireMM::CLJEwald >,
+                            bp::return_internal_reference<1, bp::with_custodian_and_ward<1,2> >() );
+        CLJEwald_exposer.def( "__str__", &__str__< ::SireMM::CLJEwald > );
+        CLJEwald_exposer.def( "__repr__", &__str__< ::SireMM::CLJEwald > );
+    }
+
+}
@@ -0,0 +1,10 @@
+// This file has been generated by Py++.
+
+// (C) Christopher Woods, GPL >= 2 License
+
+#ifndef CLJEwald_hpp__pyplusplus_wrapper
+#define CLJEwald_hpp__pyplusplus_wrapper
+
+void register_CLJEwald_class();
+
+#endif//CLJEwald_hpp__pyplusplus_wrapper
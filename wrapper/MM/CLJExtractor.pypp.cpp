@@ -79,6 +79,17 @@ void register_CLJExtractor_class(){
                 , ( bp::arg("new_selection"), bp::arg("boxes"), bp::arg("workspace") )
                 , "Add the extra atoms in new_selection to the molecule" );
         
+        }
+        { //::SireMM::CLJExtractor::boxIndicies
+        
+            typedef ::QVector< SireMM::CLJBoxIndex > ( ::SireMM::CLJExtractor::*boxIndicies_function_type)(  ) const;
+            boxIndicies_function_type boxIndicies_function_value( &::SireMM::CLJExtractor::boxIndicies );
+            
+            CLJExtractor_exposer.def( 
+                "boxIndicies"
+                , boxIndicies_function_value
+                , "Return the indicies of the atoms of this molecule in the CLJBoxes, in the\norder in which the atoms were extracted. Atoms that were not added to\nthe boxes are skipped" );
+        
         }
         { //::SireMM::CLJExtractor::changed
         
@@ -0,0 +1,332 @@
+// This file has been generated by Py++.
+
+// (C) Christopher Woods, GPL >= 2 License
+
+#include "boost/python.hpp"
+#include "CLJForces.pypp.hpp"
+
+namespace bp = boost::python;
+
+#include <QHash>
+
+#include "cljforces.h"
+
+#include "cljboxes.h"
+
+#include "atomljs.h"
+
+#include "SireMol/atomcharges.h"
+
+#include "SireMol/moleculegroup.h"
+
+#include "SireMol/molecule.h"
+
+#include "SireMol/moleculeinfodata.h"
+
+#include "SireMol/partialmolecule.h"
+
+#include "SireMol/selector.hpp"
+
+#include "SireMol/atom.h"
+
+#include "SireMol/molidx.h"
+
+#include "SireID/index.h"
+
+#include "SireFF/forcetable.h"
+
+#include "SireError/errors.h"
+
+#include "SireStream/datastream.h"
+
+#include "SireStream/shareddatastream.h"
+
+#include "cljforces.h"
+
+SireMM::CLJForces __copy__(const SireMM::CLJForces &other){ return SireMM::CLJForces(other); }
+
+#include "Qt/qdatastream.hpp"
+
+#include "Helpers/str.hpp"
+
+#include "Helpers/len.hpp"
+
+void register_CLJForces_class(){
+
+    { //::SireMM::CLJForces
+        typedef bp::class_< SireMM::CLJForces > CLJForces_exposer_t;
+        CLJForces_exposer_t CLJForces_exposer = CLJForces_exposer_t( "CLJForces", "This class holds vectorised arrays of the forces on a set of\nCLJAtoms. The forces are held in the same (padded) order\nas the atoms in the CLJAtoms, so that they can be accumulated\ndirectly by the vectorised force kernels of the CLJFunctions.\n\nThe forces can be added into a ForceTable (or MolForceTable) as long\nas the CLJAtoms were created from the same molecule(s) that\nare passed to addTo\n\nAuthor: Christopher Woods\n", bp::init< >("Null constructor") );
+        bp::scope CLJForces_scope( CLJForces_exposer );
+        CLJForces_exposer.def( bp::init< int >(( bp::arg("natoms") ), "Construct space for the (zero) forces on natoms atoms. Note that\nthe number of atoms will be padded to a multiple of MultiFloat::count()") );
+        CLJForces_exposer.def( bp::init< SireMM::CLJAtoms const & >(( bp::arg("atoms") ), "Construct space for the (zero) forces on the passed atoms") );
+        CLJForces_exposer.def( bp::init< QVector< SireMaths::Vector > const & >(( bp::arg("forces") ), "Construct from the passed array of forces") );
+        CLJForces_exposer.def( bp::init< SireMM::CLJBoxes const &, QVector< SireMM::CLJForces > const &, QVector< SireMM::CLJBoxIndex > const & >(( bp::arg("boxes"), bp::arg("box_forces"), bp::arg("atoms") ), "Construct by gathering the forces on the atoms in the passed CLJBoxes\nat the indicies atoms (e.g. as returned from CLJBoxes::add). The forces\nin box_forces must be in the same order as the occupied boxes in boxes,\nas returned from CLJFunction::force or CLJCalculator::calculateForces. The\nforces are returned in the same order as the indicies in atoms\nThrow: SireError::incompatible_error\n") );
+        CLJForces_exposer.def( bp::init< SireMM::CLJForces const & >(( bp::arg("other") ), "Copy constructor") );
+        { //::SireMM::CLJForces::addTo
+        
+            typedef void ( ::SireMM::CLJForces::*addTo_function_type)( ::SireFF::MolForceTable &,::SireMol::MoleculeView const &,::SireBase::PropertyMap const & ) const;
+            addTo_function_type addTo_function_value( &::SireMM::CLJForces::addTo );
+            
+            CLJForces_exposer.def( 
+                "addTo"
+                , addTo_function_value
+                , ( bp::arg("forcetable"), bp::arg("molecule"), bp::arg("map")=SireBase::PropertyMap() )
+                , "Add these forces onto the forces in forcetable for the atoms in\nmolecule. These forces must have been calculated for CLJAtoms that\nwere constructed from molecule using the same property map\nThrow: SireError::incompatible_error\n" );
+        
+        }
+        { //::SireMM::CLJForces::addTo
+        
+            typedef void ( ::SireMM::CLJForces::*addTo_function_type)( ::SireFF::MolForceTable &,::SireMol::MoleculeView const &,double,::SireBase::PropertyMap const & ) const;
+            addTo_function_type addTo_function_value( &::SireMM::CLJForces::addTo );
+            
+            CLJForces_exposer.def( 
+                "addTo"
+                , addTo_function_value
+                , ( bp::arg("forcetable"), bp::arg("molecule"), bp::arg("scale_force"), bp::arg("map")=SireBase::PropertyMap() )
+                , "Add these forces, multiplied by scale_force, onto the forces in\nforcetable for the atoms in molecule. These forces must have been\ncalculated for CLJAtoms that were constructed from molecule using\nthe same property map\nThrow: SireError::incompatible_error\n" );
+        
+        }
+        { //::SireMM::CLJForces::addTo
+        
+            typedef void ( ::SireMM::CLJForces::*addTo_function_type)( ::SireFF::ForceTable &,::SireMol::MoleculeGroup const &,::SireBase::PropertyMap const & ) const;
+            addTo_function_type addTo_function_value( &::SireMM::CLJForces::addTo );
+            
+            CLJForces_exposer.def( 
+                "addTo"
+                , addTo_function_value
+                , ( bp::arg("forcetable"), bp::arg("molecules"), bp::arg("map")=SireBase::PropertyMap() )
+                , "Add these forces onto the forces in forcetable for the molecules in\nmolecules. These forces must have been calculated for CLJAtoms that\nwere constructed from molecules using the same property map. Only\nmolecules that are in the forcetable have their forces added\nThrow: SireError::incompatible_error\n" );
+        
+        }
+        { //::SireMM::CLJForces::addTo
+        
+            typedef void ( ::SireMM::CLJForces::*addTo_function_type)( ::SireFF::ForceTable &,::SireMol::MoleculeGroup const &,double,::SireBase::PropertyMap const & ) const;
+            addTo_function_type addTo_function_value( &::SireMM::CLJForces::addTo );
+            
+            CLJForces_exposer.def( 
+                "addTo"
+                , addTo_function_value
+                , ( bp::arg("forcetable"), bp::arg("molecules"), bp::arg("scale_force"), bp::arg("map")=SireBase::PropertyMap() )
+                , "Add these forces, multiplied by scale_force, onto the forces in forcetable\nfor the molecules in molecules. These forces must have been calculated\nfor CLJAtoms that were constructed from molecules using the\nsame property map. Only molecules that are in the forcetable\nhave their forces added\nThrow: SireError::incompatible_error\n" );
+        
+        }
+        { //::SireMM::CLJForces::assertCompatible
+        
+            typedef void ( ::SireMM::CLJForces::*assertCompatible_function_type)( ::SireMM::CLJAtoms const & ) const;
+            assertCompatible_function_type assertCompatible_function_value( &::SireMM::CLJForces::assertCompatible );
+            
+            CLJForces_exposer.def( 
+                "assertCompatible"
+                , assertCompatible_function_value
+                , ( bp::arg("atoms") )
+                , "Assert that these forces can hold the forces on the passed atoms\nThrow: SireError::incompatible_error\n" );
+        
+        }
+        { //::SireMM::CLJForces::at
+        
+            typedef ::SireMaths::Vector ( ::SireMM::CLJForces::*at_function_type)( int ) const;
+            at_function_type at_function_value( &::SireMM::CLJForces::at );
+            
+            CLJForces_exposer.def( 
+                "at"
+                , at_function_value
+                , ( bp::arg("i") )
+                , "Return the force on the ith atom\nThrow: SireError::invalid_index\n" );
+        
+        }
+        { //::SireMM::CLJForces::count
+        
+            typedef int ( ::SireMM::CLJForces::*count_function_type)(  ) const;
+            count_function_type count_function_value( &::SireMM::CLJForces::count );
+            
+            CLJForces_exposer.def( 
+                "count"
+                , count_function_value
+                , "Return the number of forces. Note that this is padded to\na multiple of MultiFloat::count()" );
+        
+        }
+        { //::SireMM::CLJForces::forces
+        
+            typedef ::QVector< SireMaths::Vector > ( ::SireMM::CLJForces::*forces_function_type)(  ) const;
+            forces_function_type forces_function_value( &::SireMM::CLJForces::forces );
+            
+            CLJForces_exposer.def( 
+                "forces"
+                , forces_function_value
+                , "Return all of the forces as an array of vectors (including\nthe forces on any padding atoms)" );
+        
+        }
+        { //::SireMM::CLJForces::getitem
+        
+            typedef ::SireMaths::Vector ( ::SireMM::CLJForces::*getitem_function_type)( int ) const;
+            getitem_function_type getitem_function_value( &::SireMM::CLJForces::getitem );
+            
+            CLJForces_exposer.def( 
+                "getitem"
+                , getitem_function_value
+                , ( bp::arg("i") )
+                , "Return the force on the ith atom\nThrow: SireError::invalid_index\n" );
+        
+        }
+        { //::SireMM::CLJForces::isCompatible
+        
+            typedef bool ( ::SireMM::CLJForces::*isCompatible_function_type)( ::SireMM::CLJAtoms const & ) const;
+            isCompatible_function_type isCompatible_function_value( &::SireMM::CLJForces::isCompatible );
+            
+            CLJForces_exposer.def( 
+                "isCompatible"
+                , isCompatible_function_value
+                , ( bp::arg("atoms") )
+                , "Return whether or not these forces can hold the forces\non the passed atoms" );
+        
+        }
+        { //::SireMM::CLJForces::isEmpty
+        
+            typedef bool ( ::SireMM::CLJForces::*isEmpty_function_type)(  ) const;
+            isEmpty_function_type isEmpty_function_value( &::SireMM::CLJForces::isEmpty );
+            
+            CLJForces_exposer.def( 
+                "isEmpty"
+                , isEmpty_function_value
+                , "Return whether or not this is empty" );
+        
+        }
+        CLJForces_exposer.def( bp::self != bp::self );
+        CLJForces_exposer.def( bp::self * bp::other< double >() );
+        CLJForces_exposer.def( bp::self *= bp::other< double >() );
+        CLJForces_exposer.def( bp::self + bp::self );
+        CLJForces_exposer.def( bp::self += bp::self );
+        CLJForces_exposer.def( bp::self - bp::self );
+        CLJForces_exposer.def( bp::self -= bp::self );
+        { //::SireMM::CLJForces::operator=
+        
+            typedef ::SireMM::CLJForces & ( ::SireMM::CLJForces::*assign_function_type)( ::SireMM::CLJForces const & ) ;
+            assign_function_type assign_function_value( &::SireMM::CLJForces::operator= );
+            
+            CLJForces_exposer.def( 
+                "assign"
+                , assign_function_value
+                , ( bp::arg("other") )
+                , bp::return_self< >()
+                , "" );
+        
+        }
+        CLJForces_exposer.def( bp::self == bp::self );
+        { //::SireMM::CLJForces::operator[]
+        
+            typedef ::SireMaths::Vector ( ::SireMM::CLJForces::*__getitem___function_type)( int ) const;
+            __getitem___function_type __getitem___function_value( &::SireMM::CLJForces::operator[] );
+            
+            CLJForces_exposer.def( 
+                "__getitem__"
+                , __getitem___function_value
+                , ( bp::arg("i") )
+                , "" );
+        
+        }
+        { //::SireMM::CLJForces::size
+        
+            typedef int ( ::SireMM::CLJForces::*size_function_type)(  ) const;
+            size_function_type size_function_value( &::SireMM::CLJForces::size );
+            
+            CLJForces_exposer.def( 
+                "size"
+                , size_function_value
+                , "Return the number of forces. Note that this is padded to\na multiple of MultiFloat::count()" );
+        
+        }
+        { //::SireMM::CLJForces::toString
+        
+            typedef ::QString ( ::SireMM::CLJForces::*toString_function_type)(  ) const;
+            toString_function_type toString_function_value( &::SireMM::CLJForces::toString );
+            
+            CLJForces_exposer.def( 
+                "toString"
+                , toString_function_value
+                , "" );
+        
+        }
+        { //::SireMM::CLJForces::typeName
+        
+            typedef char const * ( *typeName_function_type )(  );
+            typeName_function_type typeName_function_value( &::SireMM::CLJForces::typeName );
+            
+            CLJForces_exposer.def( 
+                "typeName"
+                , typeName_function_value
+                , "" );
+        
+        }
+        { //::SireMM::CLJForces::what
+        
+            typedef char const * ( ::SireMM::CLJForces::*what_function_type)(  ) const;
+            what_function_type what_function_value( &::SireMM::CLJForces::what );
+            
+            CLJForces_exposer.def( 
+                "what"
+                , what_function_value
+                , "" );
+        
+        }
+        { //::SireMM::CLJForces::x
+        
+            typedef ::QVector< SireMaths::MultiFloat > const & ( ::SireMM::CLJForces::*x_function_type)(  ) const;
+            x_function_type x_function_value( &::SireMM::CLJForces::x );
+            
+            CLJForces_exposer.def( 
+                "x"
+                , x_function_value
+                , bp::return_value_policy< bp::copy_const_reference >()
+                , "" );
+        
+        }
+        { //::SireMM::CLJForces::y
+        
+            typedef ::QVector< SireMaths::MultiFloat > const & ( ::SireMM::CLJForces::*y_function_type)(  ) const;
+            y_function_type y_function_value( &::SireMM::CLJForces::y );
+            
+            CLJForces_exposer.def( 
+                "y"
+                , y_function_value
+                , bp::return_value_policy< bp::copy_const_reference >()
+                , "" );
+        
+        }
+        { //::SireMM::CLJForces::z
+        
+            typedef ::QVector< SireMaths::MultiFloat > const & ( ::SireMM::CLJForces::*z_function_type)(  ) const;
+            z_function_type z_function_value( &::SireMM::CLJForces::z );
+            
+            CLJForces_exposer.def( 
+                "z"
+                , z_function_value
+                , bp::return_value_policy< bp::copy_const_reference >()
+                , "" );
+        
+        }
+        { //::SireMM::CLJForces::zero
+        
+            typedef void ( ::SireMM::CLJForces::*zero_function_type)(  ) ;
+            zero_function_type zero_function_value( &::SireMM::CLJForces::zero );
+            
+            CLJForces_exposer.def( 
+                "zero"
+                , zero_function_value
+                , "Set all of the forces to zero" );
+        
+        }
+        CLJForces_exposer.staticmethod( "typeName" );
+        CLJForces_exposer.def( "__copy__", &__copy__);
+        CLJForces_exposer.def( "__deepcopy__", &__copy__);
+        CLJForces_exposer.def( "clone", &__copy__);
+        CLJForces_exposer.def( "__rlshift__", &__rlshift__QDataStream< ::SireMM::CLJForces >,
+                            bp::return_internal_reference<1, bp::with_custodian_and_ward<1,2> >() );
+        CLJForces_exposer.def( "__rrshift__", &__rrshift__QDataStream< ::SireMM::CLJForces >,
+                            bp::return_internal_reference<1, bp::with_custodian_and_ward<1,2> >() );
+        CLJForces_exposer.def( "__str__", &__str__< ::SireMM::CLJForces > );
+        CLJForces_exposer.def( "__repr__", &__str__< ::SireMM::CLJForces > );
+        CLJForces_exposer.def( "__len__", &__len_size< ::SireMM::CLJForces > );
+        CLJForces_exposer.def( "__getitem__", &::SireMM::CLJForces::getitem );
+    }
+
+}
@@ -0,0 +1,10 @@
+// This file has been generated by Py++.
+
+// (C) Christopher Woods, GPL >= 2 License
+
+#ifndef CLJForces_hpp__pyplusplus_wrapper
+#define CLJForces_hpp__pyplusplus_wrapper
+
+void register_CLJForces_class();
+
+#endif//CLJForces_hpp__pyplusplus_wrapper
@@ -218,6 +218,66 @@ void register_CLJFunction_class(){
                 , coulombCutoff_function_value
                 , "Return the coulomb cutoff if this function uses one" );
         
+        }
+        { //::SireMM::CLJFunction::force
+        
+            typedef ::SireMM::CLJForces ( ::SireMM::CLJFunction::*force_function_type)( ::SireMM::CLJAtoms const & ) const;
+            force_function_type force_function_value( &::SireMM::CLJFunction::force );
+            
+            CLJFunction_exposer.def( 
+                "force"
+                , force_function_value
+                , ( bp::arg("atoms") )
+                , "Return the forces between all of the atoms in atoms\nThrow: SireError::unsupported\n" );
+        
+        }
+        { //::SireMM::CLJFunction::force
+        
+            typedef void ( ::SireMM::CLJFunction::*force_function_type)( ::SireMM::CLJAtoms const &,::SireMM::CLJForces & ) const;
+            force_function_type force_function_value( &::SireMM::CLJFunction::force );
+            
+            CLJFunction_exposer.def( 
+                "force"
+                , force_function_value
+                , ( bp::arg("atoms"), bp::arg("forces") )
+                , "Calculate the forces between all of the atoms in atoms, adding them\nonto forces. If forces is empty then it is resized to hold the\nforces on atoms. The forces are in units of kcal mol-1 A-1\nThrow: SireError::unsupported\nThrow: SireError::incompatible_error\n" );
+        
+        }
+        { //::SireMM::CLJFunction::force
+        
+            typedef void ( ::SireMM::CLJFunction::*force_function_type)( ::SireMM::CLJAtoms const &,::SireMM::CLJAtoms const &,::SireMM::CLJForces & ) const;
+            force_function_type force_function_value( &::SireMM::CLJFunction::force );
+            
+            CLJFunction_exposer.def( 
+                "force"
+                , force_function_value
+                , ( bp::arg("atoms0"), bp::arg("atoms1"), bp::arg("forces0") )
+                , "Calculate the forces on the atoms in atoms0 caused by the atoms\nin atoms1, adding them onto forces0. If forces0 is empty then\nit is resized to hold the forces on atoms0\nThrow: SireError::unsupported\nThrow: SireError::incompatible_error\n" );
+        
+        }
+        { //::SireMM::CLJFunction::force
+        
+            typedef void ( ::SireMM::CLJFunction::*force_function_type)( ::SireMM::CLJAtoms const &,::SireMM::CLJAtoms const &,::SireMM::CLJForces &,::SireMM::CLJForces & ) const;
+            force_function_type force_function_value( &::SireMM::CLJFunction::force );
+            
+            CLJFunction_exposer.def( 
+                "force"
+                , force_function_value
+                , ( bp::arg("atoms0"), bp::arg("atoms1"), bp::arg("forces0"), bp::arg("forces1") )
+                , "Calculate the forces between the atoms in atoms0 and atoms1, adding\nthe forces on atoms0 onto forces0 and the forces on atoms1 onto forces1.\nEmpty force arrays are resized to hold the forces on the atoms\nThrow: SireError::unsupported\nThrow: SireError::incompatible_error\n" );
+        
+        }
+        { //::SireMM::CLJFunction::force
+        
+            typedef void ( ::SireMM::CLJFunction::*force_function_type)( ::SireMM::CLJBoxes const &,::QVector< SireMM::CLJForces > & ) const;
+            force_function_type force_function_value( &::SireMM::CLJFunction::force );
+            
+            CLJFunction_exposer.def( 
+                "force"
+                , force_function_value
+                , ( bp::arg("atoms"), bp::arg("forces") )
+                , "Calculate the forces between all of the atoms in atoms, adding\nthem onto forces. There is one set of forces per occupied box,\nin the same order as CLJBoxes::occupiedBoxes(). Use\nCLJCalculator::calculateForces to perform this calculation\nin parallel\nThrow: SireError::unsupported\nThrow: SireError::incompatible_error\n" );
+        
         }
         { //::SireMM::CLJFunction::hasCutoff
         
@@ -585,6 +645,17 @@ void register_CLJFunction_class(){
                 , bp::return_value_policy<bp::clone_const_reference>()
                 , "Return the space represented by the function" );
         
+        }
+        { //::SireMM::CLJFunction::supportsForceCalculation
+        
+            typedef bool ( ::SireMM::CLJFunction::*supportsForceCalculation_function_type)(  ) const;
+            supportsForceCalculation_function_type supportsForceCalculation_function_value( &::SireMM::CLJFunction::supportsForceCalculation );
+            
+            CLJFunction_exposer.def( 
+                "supportsForceCalculation"
+                , supportsForceCalculation_function_value
+                , "Return whether or not this function supports the calculation of forces" );
+        
         }
         { //::SireMM::CLJFunction::supportsGridCalculation
         
@@ -81,6 +81,29 @@ void register_CLJGroup_class(){
                 , ( bp::arg("molgroup"), bp::arg("map")=SireBase::PropertyMap() )
                 , "Add all of the passed molecules to this group" );
         
+        }
+        { //::SireMM::CLJGroup::addForces
+        
+            typedef void ( ::SireMM::CLJGroup::*addForces_function_type)( ::SireFF::ForceTable &,::SireMM::CLJForces const &,double ) const;
+            addForces_function_type addForces_function_value( &::SireMM::CLJGroup::addForces );
+            
+            CLJGroup_exposer.def( 
+                "addForces"
+                , addForces_function_value
+                , ( bp::arg("forcetable"), bp::arg("forces"), bp::arg("scale_force")=1 )
+                , "Add the passed forces, multiplied by scale_force, onto the forces\nin forcetable. The forces must have been calculated for the atoms\nreturned by atoms(). Only molecules that are in the forcetable\nhave their forces added\nThrow: SireError::incompatible_error\n" );
+        
+        }
+        { //::SireMM::CLJGroup::atoms
+        
+            typedef ::SireMM::CLJAtoms ( ::SireMM::CLJGroup::*atoms_function_type)(  ) const;
+            atoms_function_type atoms_function_value( &::SireMM::CLJGroup::atoms );
+            
+            CLJGroup_exposer.def( 
+                "atoms"
+                , atoms_function_value
+                , "Return all of the atoms in this group. The molecules are returned in\norder of molecule number, with the atoms of each molecule in the order\nin which they were extracted. Unlike cljBoxes().atoms(), this order does\nnot change as the molecules are moved, so these atoms can be used\nwith a CLJNeighbourList" );
+        
         }
         { //::SireMM::CLJGroup::boxLength
         
@@ -0,0 +1,105 @@
+// This file has been generated by Py++.
+
+// (C) Christopher Woods, GPL >= 2 License
+
+#include "boost/python.hpp"
+#include "CLJKernels.pypp.hpp"
+
+namespace bp = boost::python;
+
+#include "SireBase/cpuid.h"
+
+#include "SireError/errors.h"
+
+#include "SireMaths/multidouble.h"
+
+#include "SireMaths/multifloat.h"
+
+#include "SireMaths/multiint.h"
+
+#include "cljkernels.h"
+
+#include "cljkernels.h"
+
+void register_CLJKernels_class(){
+
+    { //::SireMM::CLJKernels
+        typedef bp::class_< SireMM::CLJKernels > CLJKernels_exposer_t;
+        CLJKernels_exposer_t CLJKernels_exposer = CLJKernels_exposer_t( "CLJKernels", "This class provides the runtime-dispatched versions of the hot\ncoulomb and LJ kernels used by CLJShiftFunction and CLJRFFunction.\n\nMultiFloat chooses its vector instruction set (SSE, AVX or AVX-512)\nwhen Sire is compiled, so a single binary can only use the instruction\nset of the oldest processor it must run on. The kernels in this class\nare compiled several times, each targetting a different instruction\nset (AVX2+FMA and AVX-512F). By default the CLJFunctions use their\nnormal MultiFloat kernels. The dispatched kernels are only used\nif they are selected using setInstructionSet (passing auto\nchooses the best version supported by the processor, as reported\nby SireBase::CPUID).\n\nThe coulomb energy is calculated using the general form\nq0 q1 ( 1/r + a r + b r^2 - c ), which gives shifted\nelectrostatics (a = 1/Rc^2, b = 0, c = 2/Rc) and reaction field\n(a = 0, b = k_rf, c = c_rf).\n\nAuthor: Christopher Woods\n", bp::init< >("") );
+        bp::scope CLJKernels_scope( CLJKernels_exposer );
+        { //::SireMM::CLJKernels::availableInstructionSets
+        
+            typedef ::QStringList ( *availableInstructionSets_function_type )(  );
+            availableInstructionSets_function_type availableInstructionSets_function_value( &::SireMM::CLJKernels::availableInstructionSets );
+            
+            CLJKernels_exposer.def( 
+                "availableInstructionSets"
+                , availableInstructionSets_function_value
+                , "Return the names of all instruction sets that can be used on this\nprocessor. \"compiled\" is always available" );
+        
+        }
+        { //::SireMM::CLJKernels::compiledInstructionSet
+        
+            typedef ::QString ( *compiledInstructionSet_function_type )(  );
+            compiledInstructionSet_function_type compiledInstructionSet_function_value( &::SireMM::CLJKernels::compiledInstructionSet );
+            
+            CLJKernels_exposer.def( 
+                "compiledInstructionSet"
+                , compiledInstructionSet_function_value
+                , "Return the name of the vector instruction set used by MultiFloat,\nwhich was chosen when Sire was compiled" );
+        
+        }
+        { //::SireMM::CLJKernels::instructionSet
+        
+            typedef ::QString ( *instructionSet_function_type )(  );
+            instructionSet_function_type instructionSet_function_value( &::SireMM::CLJKernels::instructionSet );
+            
+            CLJKernels_exposer.def( 
+                "instructionSet"
+                , instructionSet_function_value
+                , "Return the name of the instruction set that is used for the\nCLJ kernels. This is \"compiled\" if the MultiFloat kernels chosen\nwhen Sire was compiled are used" );
+        
+        }
+        { //::SireMM::CLJKernels::isDispatched
+        
+            typedef bool ( *isDispatched_function_type )(  );
+            isDispatched_function_type isDispatched_function_value( &::SireMM::CLJKernels::isDispatched );
+            
+            CLJKernels_exposer.def( 
+                "isDispatched"
+                , isDispatched_function_value
+                , "Return whether or not the CLJ kernels are dispatched to one of the\ninstruction-set specific kernels (rather than the compiled MultiFloat kernels)" );
+        
+        }
+        { //::SireMM::CLJKernels::resetInstructionSet
+        
+            typedef void ( *resetInstructionSet_function_type )(  );
+            resetInstructionSet_function_type resetInstructionSet_function_value( &::SireMM::CLJKernels::resetInstructionSet );
+            
+            CLJKernels_exposer.def( 
+                "resetInstructionSet"
+                , resetInstructionSet_function_value
+                , "Reset the instruction set so that the compiled MultiFloat kernels\nare used (this is the default)" );
+        
+        }
+        { //::SireMM::CLJKernels::setInstructionSet
+        
+            typedef void ( *setInstructionSet_function_type )( ::QString const & );
+            setInstructionSet_function_type setInstructionSet_function_value( &::SireMM::CLJKernels::setInstructionSet );
+            
+            CLJKernels_exposer.def( 
+                "setInstructionSet"
+                , setInstructionSet_function_value
+                , ( bp::arg("isa") )
+                , "Override the instruction set used for the CLJ kernels. This must be\none of the values returned by availableInstructionSets, or \"auto\"\nto choose the best instruction set supported by this processor\n(which is only a dispatched kernel if it is better than the\ncompiled MultiFloat kernels)\nThrow: SireError::unsupported\n" );
+        
+        }
+        CLJKernels_exposer.staticmethod( "availableInstructionSets" );
+        CLJKernels_exposer.staticmethod( "compiledInstructionSet" );
+        CLJKernels_exposer.staticmethod( "instructionSet" );
+        CLJKernels_exposer.staticmethod( "isDispatched" );
+        CLJKernels_exposer.staticmethod( "resetInstructionSet" );
+        CLJKernels_exposer.staticmethod( "setInstructionSet" );
+    }
+
+}
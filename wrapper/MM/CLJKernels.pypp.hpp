@@ -0,0 +1,10 @@
+// This file has been generated by Py++.
+
+// (C) Christopher Woods, GPL >= 2 License
+
+#ifndef CLJKernels_hpp__pyplusplus_wrapper
+#define CLJKernels_hpp__pyplusplus_wrapper
+
+void register_CLJKernels_class();
+
+#endif//CLJKernels_hpp__pyplusplus_wrapper
@@ -0,0 +1,276 @@
+// This file has been generated by Py++.
+
+// (C) Christopher Woods, GPL >= 2 License
+
+#include "boost/python.hpp"
+#include "CLJNeighbourList.pypp.hpp"
+
+namespace bp = boost::python;
+
+#include "SireError/errors.h"
+
+#include "SireMaths/multifloat.h"
+
+#include "SireMaths/multiint.h"
+
+#include "SireStream/datastream.h"
+
+#include "SireUnits/units.h"
+
+#include "SireVol/aabox.h"
+
+#include "SireVol/periodicbox.h"
+
+#include "SireVol/space.h"
+
+#include "cljatoms.h"
+
+#include "cljneighbourlist.h"
+
+#include "tbb/blocked_range.h"
+
+#include "tbb/parallel_for.h"
+
+#include <algorithm>
+
+#include <limits>
+
+#include "cljneighbourlist.h"
+
+SireMM::CLJNeighbourList __copy__(const SireMM::CLJNeighbourList &other){ return SireMM::CLJNeighbourList(other); }
+
+#include "Qt/qdatastream.hpp"
+
+#include "Helpers/str.hpp"
+
+void register_CLJNeighbourList_class(){
+
+    { //::SireMM::CLJNeighbourList
+        typedef bp::class_< SireMM::CLJNeighbourList > CLJNeighbourList_exposer_t;
+        CLJNeighbourList_exposer_t CLJNeighbourList_exposer = CLJNeighbourList_exposer_t( "CLJNeighbourList", "This class holds a Verlet cluster-pair neighbour list for a set\nof CLJAtoms. Each cluster is one MultiFloat vector of atoms\n(i.e. MultiFloat::count() atoms), so that a cluster pair maps\ndirectly onto the vectorised CLJ kernels.\n\nThe list contains every pair of clusters whose bounding spheres\nare closer than the cutoff of the CLJFunction plus a skin. The\nlist only needs to be rebuilt when an atom has moved by more than\nhalf of the skin since the list was built, so for MD-like workloads\nthe pair search is only performed every few steps, and far fewer\nout-of-cutoff pairs are evaluated than when looping over all\natoms in neighbouring CLJBoxes.\n\nThe pairs of clusters are found by binning the clusters into\ncells that are at least as wide as the cutoff plus skin (plus the\ndiameter of the largest cluster), so that only clusters in\nneighbouring cells are compared.\n\nThe list relies on the atoms being in the same order each time\n(as is the case for CLJGroup::atoms). Use it via\nCLJCalculator::calculate, or switch on InterFF::setUseNeighbourList.\n\nAuthor: Christopher Woods\n", bp::init< >("Constructor") );
+        bp::scope CLJNeighbourList_scope( CLJNeighbourList_exposer );
+        CLJNeighbourList_exposer.def( bp::init< SireUnits::Dimension::Length >(( bp::arg("skin") ), "Construct a list that uses the passed skin") );
+        CLJNeighbourList_exposer.def( bp::init< SireMM::CLJNeighbourList const & >(( bp::arg("other") ), "Copy constructor") );
+        { //::SireMM::CLJNeighbourList::clear
+        
+            typedef void ( ::SireMM::CLJNeighbourList::*clear_function_type)(  ) ;
+            clear_function_type clear_function_value( &::SireMM::CLJNeighbourList::clear );
+            
+            CLJNeighbourList_exposer.def( 
+                "clear"
+                , clear_function_value
+                , "Clear the list, so that it will be rebuilt when next used" );
+        
+        }
+        { //::SireMM::CLJNeighbourList::cluster
+        
+            typedef ::SireMM::CLJAtoms ( ::SireMM::CLJNeighbourList::*cluster_function_type)( ::SireMM::CLJAtoms const &,int ) const;
+            cluster_function_type cluster_function_value( &::SireMM::CLJNeighbourList::cluster );
+            
+            CLJNeighbourList_exposer.def( 
+                "cluster"
+                , cluster_function_value
+                , ( bp::arg("atoms"), bp::arg("i") )
+                , "Return the atoms in the ith cluster of atoms\nThrow: SireError::invalid_index\n" );
+        
+        }
+        { //::SireMM::CLJNeighbourList::getCluster
+        
+            typedef void ( ::SireMM::CLJNeighbourList::*getCluster_function_type)( ::SireMM::CLJAtoms const &,int,::SireMM::CLJAtoms & ) const;
+            getCluster_function_type getCluster_function_value( &::SireMM::CLJNeighbourList::getCluster );
+            
+            CLJNeighbourList_exposer.def( 
+                "getCluster"
+                , getCluster_function_value
+                , ( bp::arg("atoms"), bp::arg("i"), bp::arg("cluster") )
+                , "Copy the atoms in the ith cluster of atoms into cluster. This reuses\nthe memory already allocated in cluster, so should be used with the\nsame scratch cluster for each cluster in turn\nThrow: SireError::invalid_index\n" );
+        
+        }
+        { //::SireMM::CLJNeighbourList::getNeighbours
+        
+            typedef void ( ::SireMM::CLJNeighbourList::*getNeighbours_function_type)( ::SireMM::CLJAtoms const &,int,::SireMM::CLJAtoms & ) const;
+            getNeighbours_function_type getNeighbours_function_value( &::SireMM::CLJNeighbourList::getNeighbours );
+            
+            CLJNeighbourList_exposer.def( 
+                "getNeighbours"
+                , getNeighbours_function_value
+                , ( bp::arg("atoms"), bp::arg("i"), bp::arg("neighbours") )
+                , "Copy all of the atoms in the neighbouring clusters of the ith cluster\nof atoms into neighbours. Only the neighbours with a higher cluster\nindex than i are copied, so that each pair of clusters is only seen\nonce. This reuses the memory already allocated in neighbours, so\nshould be used with the same scratch neighbours for each cluster in turn\nThrow: SireError::invalid_index\n" );
+        
+        }
+        { //::SireMM::CLJNeighbourList::isEmpty
+        
+            typedef bool ( ::SireMM::CLJNeighbourList::*isEmpty_function_type)(  ) const;
+            isEmpty_function_type isEmpty_function_value( &::SireMM::CLJNeighbourList::isEmpty );
+            
+            CLJNeighbourList_exposer.def( 
+                "isEmpty"
+                , isEmpty_function_value
+                , "Return whether or not this list is empty (has not been built)" );
+        
+        }
+        { //::SireMM::CLJNeighbourList::nClusterPairs
+        
+            typedef int ( ::SireMM::CLJNeighbourList::*nClusterPairs_function_type)(  ) const;
+            nClusterPairs_function_type nClusterPairs_function_value( &::SireMM::CLJNeighbourList::nClusterPairs );
+            
+            CLJNeighbourList_exposer.def( 
+                "nClusterPairs"
+                , nClusterPairs_function_value
+                , "Return the number of pairs of (different) clusters in the list" );
+        
+        }
+        { //::SireMM::CLJNeighbourList::nClusters
+        
+            typedef int ( ::SireMM::CLJNeighbourList::*nClusters_function_type)(  ) const;
+            nClusters_function_type nClusters_function_value( &::SireMM::CLJNeighbourList::nClusters );
+            
+            CLJNeighbourList_exposer.def( 
+                "nClusters"
+                , nClusters_function_value
+                , "Return the number of clusters in the list" );
+        
+        }
+        { //::SireMM::CLJNeighbourList::nRebuilds
+        
+            typedef int ( ::SireMM::CLJNeighbourList::*nRebuilds_function_type)(  ) const;
+            nRebuilds_function_type nRebuilds_function_value( &::SireMM::CLJNeighbourList::nRebuilds );
+            
+            CLJNeighbourList_exposer.def( 
+                "nRebuilds"
+                , nRebuilds_function_value
+                , "Return the number of times that this list has been rebuilt" );
+        
+        }
+        { //::SireMM::CLJNeighbourList::needsRebuild
+        
+            typedef bool ( ::SireMM::CLJNeighbourList::*needsRebuild_function_type)( ::SireMM::CLJFunction const &,::SireMM::CLJAtoms const & ) const;
+            needsRebuild_function_type needsRebuild_function_value( &::SireMM::CLJNeighbourList::needsRebuild );
+            
+            CLJNeighbourList_exposer.def( 
+                "needsRebuild"
+                , needsRebuild_function_value
+                , ( bp::arg("func"), bp::arg("atoms") )
+                , "Return whether or not the list needs to be rebuilt for the passed\nfunction and atoms. This is true if the list is empty, the number\nof atoms, the cutoff or the space has changed, or if any atom has moved by\nmore than half the skin since the list was built" );
+        
+        }
+        { //::SireMM::CLJNeighbourList::neighbours
+        
+            typedef ::SireMM::CLJAtoms ( ::SireMM::CLJNeighbourList::*neighbours_function_type)( ::SireMM::CLJAtoms const &,int ) const;
+            neighbours_function_type neighbours_function_value( &::SireMM::CLJNeighbourList::neighbours );
+            
+            CLJNeighbourList_exposer.def( 
+                "neighbours"
+                , neighbours_function_value
+                , ( bp::arg("atoms"), bp::arg("i") )
+                , "Return all of the atoms in the neighbouring clusters of the ith\ncluster of atoms, gathered together into a single CLJAtoms.\nOnly the neighbours with a higher cluster index than i are\nreturned, so that each pair of clusters is only seen once\nThrow: SireError::invalid_index\n" );
+        
+        }
+        CLJNeighbourList_exposer.def( bp::self != bp::self );
+        { //::SireMM::CLJNeighbourList::operator=
+        
+            typedef ::SireMM::CLJNeighbourList & ( ::SireMM::CLJNeighbourList::*assign_function_type)( ::SireMM::CLJNeighbourList const & ) ;
+            assign_function_type assign_function_value( &::SireMM::CLJNeighbourList::operator= );
+            
+            CLJNeighbourList_exposer.def( 
+                "assign"
+                , assign_function_value
+                , ( bp::arg("other") )
+                , bp::return_self< >()
+                , "" );
+        
+        }
+        CLJNeighbourList_exposer.def( bp::self == bp::self );
+        { //::SireMM::CLJNeighbourList::rebuild
+        
+            typedef void ( ::SireMM::CLJNeighbourList::*rebuild_function_type)( ::SireMM::CLJFunction const &,::SireMM::CLJAtoms const & ) ;
+            rebuild_function_type rebuild_function_value( &::SireMM::CLJNeighbourList::rebuild );
+            
+            CLJNeighbourList_exposer.def( 
+                "rebuild"
+                , rebuild_function_value
+                , ( bp::arg("func"), bp::arg("atoms") )
+                , "Rebuild the list for the passed function and atoms" );
+        
+        }
+        { //::SireMM::CLJNeighbourList::setSkin
+        
+            typedef void ( ::SireMM::CLJNeighbourList::*setSkin_function_type)( ::SireUnits::Dimension::Length ) ;
+            setSkin_function_type setSkin_function_value( &::SireMM::CLJNeighbourList::setSkin );
+            
+            CLJNeighbourList_exposer.def( 
+                "setSkin"
+                , setSkin_function_value
+                , ( bp::arg("skin") )
+                , "Set the size of the skin that is added onto the cutoff. A larger\nskin means that the list is rebuilt less often, but that more\nout-of-cutoff pairs are evaluated. This clears the list" );
+        
+        }
+        { //::SireMM::CLJNeighbourList::skin
+        
+            typedef ::SireUnits::Dimension::Length ( ::SireMM::CLJNeighbourList::*skin_function_type)(  ) const;
+            skin_function_type skin_function_value( &::SireMM::CLJNeighbourList::skin );
+            
+            CLJNeighbourList_exposer.def( 
+                "skin"
+                , skin_function_value
+                , "Return the size of the skin that is added onto the cutoff" );
+        
+        }
+        { //::SireMM::CLJNeighbourList::toString
+        
+            typedef ::QString ( ::SireMM::CLJNeighbourList::*toString_function_type)(  ) const;
+            toString_function_type toString_function_value( &::SireMM::CLJNeighbourList::toString );
+            
+            CLJNeighbourList_exposer.def( 
+                "toString"
+                , toString_function_value
+                , "" );
+        
+        }
+        { //::SireMM::CLJNeighbourList::typeName
+        
+            typedef char const * ( *typeName_function_type )(  );
+            typeName_function_type typeName_function_value( &::SireMM::CLJNeighbourList::typeName );
+            
+            CLJNeighbourList_exposer.def( 
+                "typeName"
+                , typeName_function_value
+                , "" );
+        
+        }
+        { //::SireMM::CLJNeighbourList::update
+        
+            typedef bool ( ::SireMM::CLJNeighbourList::*update_function_type)( ::SireMM::CLJFunction const &,::SireMM::CLJAtoms const & ) ;
+            update_function_type update_function_value( &::SireMM::CLJNeighbourList::update );
+            
+            CLJNeighbourList_exposer.def( 
+                "update"
+                , update_function_value
+                , ( bp::arg("func"), bp::arg("atoms") )
+                , "Update the list for the passed function and atoms, rebuilding it\nonly if needed. This returns whether or not the list was rebuilt" );
+        
+        }
+        { //::SireMM::CLJNeighbourList::what
+        
+            typedef char const * ( ::SireMM::CLJNeighbourList::*what_function_type)(  ) const;
+            what_function_type what_function_value( &::SireMM::CLJNeighbourList::what );
+            
+            CLJNeighbourList_exposer.def( 
+                "what"
+                , what_function_value
+                , "" );
+        
+        }
+        CLJNeighbourList_exposer.staticmethod( "typeName" );
+        CLJNeighbourList_exposer.def( "__copy__", &__copy__);
+        CLJNeighbourList_exposer.def( "__deepcopy__", &__copy__);
+        CLJNeighbourList_exposer.def( "clone", &__copy__);
+        CLJNeighbourList_exposer.def( "__rlshift__", &__rlshift__QDataStream< ::SireMM::CLJNeighbourList >,
+                            bp::return_internal_reference<1, bp::with_custodian_and_ward<1,2> >() );
+        CLJNeighbourList_exposer.def( "__rrshift__", &__rrshift__QDataStream< ::SireMM::CLJNeighbourList >,
+                            bp::return_internal_reference<1, bp::with_custodian_and_ward<1,2> >() );
+        CLJNeighbourList_exposer.def( "__str__", &__str__< ::SireMM::CLJNeighbourList > );
+        CLJNeighbourList_exposer.def( "__repr__", &__str__< ::SireMM::CLJNeighbourList > );
+    }
+
+}
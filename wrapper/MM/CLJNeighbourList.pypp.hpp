@@ -0,0 +1,10 @@
+// This file has been generated by Py++.
+
+// (C) Christopher Woods, GPL >= 2 License
+
+#ifndef CLJNeighbourList_hpp__pyplusplus_wrapper
+#define CLJNeighbourList_hpp__pyplusplus_wrapper
+
+void register_CLJNeighbourList_class();
+
+#endif//CLJNeighbourList_hpp__pyplusplus_wrapper
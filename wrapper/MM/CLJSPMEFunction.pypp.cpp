@@ -0,0 +1,374 @@
+// This file has been generated by Py++.
+
+// (C) Christopher Woods, GPL >= 2 License
+
+#include "boost/python.hpp"
+#include "CLJSPMEFunction.pypp.hpp"
+
+namespace bp = boost::python;
+
+#include "SireBase/lengthproperty.h"
+
+#include "SireBase/numberproperty.h"
+
+#include "SireError/errors.h"
+
+#include "SireMaths/multidouble.h"
+
+#include "SireMaths/multifloat.h"
+
+#include "SireMaths/multiint.h"
+
+#include "SireStream/datastream.h"
+
+#include "SireStream/shareddatastream.h"
+
+#include "SireUnits/units.h"
+
+#include "SireVol/periodicbox.h"
+
+#include "cljboxes.h"
+
+#include "cljspmefunction.h"
+
+#include "detail/spmefft.h"
+
+#include <QHash>
+
+#include <QVarLengthArray>
+
+#include <complex>
+
+#include <vector>
+
+#include "cljspmefunction.h"
+
+SireMM::CLJSPMEFunction __copy__(const SireMM::CLJSPMEFunction &other){ return SireMM::CLJSPMEFunction(other); }
+
+#include "Qt/qdatastream.hpp"
+
+#include "Helpers/str.hpp"
+
+void register_CLJSPMEFunction_class(){
+
+    { //::SireMM::CLJSPMEFunction
+        typedef bp::class_< SireMM::CLJSPMEFunction, bp::bases< SireMM::CLJCutoffFunction, SireMM::CLJFunction, SireBase::Property > > CLJSPMEFunction_exposer_t;
+        CLJSPMEFunction_exposer_t CLJSPMEFunction_exposer = CLJSPMEFunction_exposer_t( "CLJSPMEFunction", "This CLJFunction calculates the intermolecular coulomb and LJ energy of the passed\nCLJAtoms using smooth particle mesh Ewald (SPME) electrostatics, as described\nin Essmann et al., J. Chem. Phys., 103, 8577, 1995\n\nThe pair functions (used by CLJBoxes and CLJCalculator) evaluate only the\nreal-space part of the Ewald sum, i.e. the erfc-screened coulomb energy\nplus the cutoff LJ energy. The long-range part of the electrostatic\nenergy cannot be decomposed into pairs of boxes, so is calculated\nseparately via longRangeEnergy. This sums the reciprocal space energy\n(calculated by spreading the charges onto a mesh using cardinal B-splines\nand transforming the mesh using a parallel 3D FFT), the self energy, and the\ncorrection for the excluded pairs of atoms that have the same ID.\nUse CLJSPMEMesh to hold the transformed mesh between Monte Carlo\nmoves, so that the reciprocal space energy can be updated incrementally.\n\nSPME requires periodic boundary conditions, so the long-range energy\ncan only be calculated if this function uses a PeriodicBox space.\n\nAuthor: Christopher Woods\n", bp::init< >("Constructor") );
+        bp::scope CLJSPMEFunction_scope( CLJSPMEFunction_exposer );
+        CLJSPMEFunction_exposer.def( bp::init< SireUnits::Dimension::Length >(( bp::arg("cutoff") ), "") );
+        CLJSPMEFunction_exposer.def( bp::init< SireUnits::Dimension::Length, SireUnits::Dimension::Length >(( bp::arg("coul_cutoff"), bp::arg("lj_cutoff") ), "") );
+        CLJSPMEFunction_exposer.def( bp::init< SireVol::Space const &, SireUnits::Dimension::Length >(( bp::arg("space"), bp::arg("cutoff") ), "") );
+        CLJSPMEFunction_exposer.def( bp::init< SireVol::Space const &, SireUnits::Dimension::Length, SireUnits::Dimension::Length >(( bp::arg("space"), bp::arg("coul_cutoff"), bp::arg("lj_cutoff") ), "") );
+        CLJSPMEFunction_exposer.def( bp::init< SireUnits::Dimension::Length, SireMM::CLJFunction::COMBINING_RULES >(( bp::arg("cutoff"), bp::arg("combining_rules") ), "") );
+        CLJSPMEFunction_exposer.def( bp::init< SireUnits::Dimension::Length, SireUnits::Dimension::Length, SireMM::CLJFunction::COMBINING_RULES >(( bp::arg("coul_cutoff"), bp::arg("lj_cutoff"), bp::arg("combining_rules") ), "") );
+        CLJSPMEFunction_exposer.def( bp::init< SireVol::Space const &, SireMM::CLJFunction::COMBINING_RULES >(( bp::arg("space"), bp::arg("combining_rules") ), "") );
+        CLJSPMEFunction_exposer.def( bp::init< SireVol::Space const &, SireUnits::Dimension::Length, SireMM::CLJFunction::COMBINING_RULES >(( bp::arg("space"), bp::arg("cutoff"), bp::arg("combining_rules") ), "") );
+        CLJSPMEFunction_exposer.def( bp::init< SireVol::Space const &, SireUnits::Dimension::Length, SireUnits::Dimension::Length, SireMM::CLJFunction::COMBINING_RULES >(( bp::arg("space"), bp::arg("coul_cutoff"), bp::arg("lj_cutoff"), bp::arg("combining_rules") ), "") );
+        CLJSPMEFunction_exposer.def( bp::init< SireMM::CLJSPMEFunction const & >(( bp::arg("other") ), "Copy constructor") );
+        { //::SireMM::CLJSPMEFunction::beta
+        
+            typedef double ( ::SireMM::CLJSPMEFunction::*beta_function_type)(  ) const;
+            beta_function_type beta_function_value( &::SireMM::CLJSPMEFunction::beta );
+            
+            CLJSPMEFunction_exposer.def( 
+                "beta"
+                , beta_function_value
+                , "Return the Ewald screening parameter (beta), calculated from\nthe Ewald precision and the coulomb cutoff" );
+        
+        }
+        { //::SireMM::CLJSPMEFunction::containsProperty
+        
+            typedef bool ( ::SireMM::CLJSPMEFunction::*containsProperty_function_type)( ::QString const & ) const;
+            containsProperty_function_type containsProperty_function_value( &::SireMM::CLJSPMEFunction::containsProperty );
+            
+            CLJSPMEFunction_exposer.def( 
+                "containsProperty"
+                , containsProperty_function_value
+                , ( bp::arg("name") )
+                , "Return whether or not the passed property exists" );
+        
+        }
+        { //::SireMM::CLJSPMEFunction::defaultSPMEFunction
+        
+            typedef ::SireMM::CLJFunctionPtr ( *defaultSPMEFunction_function_type )(  );
+            defaultSPMEFunction_function_type defaultSPMEFunction_function_value( &::SireMM::CLJSPMEFunction::defaultSPMEFunction );
+            
+            CLJSPMEFunction_exposer.def( 
+                "defaultSPMEFunction"
+                , defaultSPMEFunction_function_value
+                , "Return the default SPME function" );
+        
+        }
+        { //::SireMM::CLJSPMEFunction::ewaldPrecision
+        
+            typedef double ( ::SireMM::CLJSPMEFunction::*ewaldPrecision_function_type)(  ) const;
+            ewaldPrecision_function_type ewaldPrecision_function_value( &::SireMM::CLJSPMEFunction::ewaldPrecision );
+            
+            CLJSPMEFunction_exposer.def( 
+                "ewaldPrecision"
+                , ewaldPrecision_function_value
+                , "Return the relative precision of the Ewald sum" );
+        
+        }
+        { //::SireMM::CLJSPMEFunction::exclusionEnergy
+        
+            typedef double ( ::SireMM::CLJSPMEFunction::*exclusionEnergy_function_type)( ::SireMM::CLJAtoms const & ) const;
+            exclusionEnergy_function_type exclusionEnergy_function_value( &::SireMM::CLJSPMEFunction::exclusionEnergy );
+            
+            CLJSPMEFunction_exposer.def( 
+                "exclusionEnergy"
+                , exclusionEnergy_function_value
+                , ( bp::arg("atoms") )
+                , "Return the correction to the reciprocal space energy that removes\nthe interactions between pairs of atoms that have the same ID\n(and so are excluded from the intermolecular energy)\nThrow: SireError::incompatible_error\n" );
+        
+        }
+        { //::SireMM::CLJSPMEFunction::exclusionEnergy
+        
+            typedef double ( ::SireMM::CLJSPMEFunction::*exclusionEnergy_function_type)( ::SireMM::CLJBoxes const & ) const;
+            exclusionEnergy_function_type exclusionEnergy_function_value( &::SireMM::CLJSPMEFunction::exclusionEnergy );
+            
+            CLJSPMEFunction_exposer.def( 
+                "exclusionEnergy"
+                , exclusionEnergy_function_value
+                , ( bp::arg("atoms") )
+                , "Return the correction to the reciprocal space energy that removes\nthe interactions between pairs of atoms that have the same ID\n(and so are excluded from the intermolecular energy)\nThrow: SireError::incompatible_error\n" );
+        
+        }
+        { //::SireMM::CLJSPMEFunction::gridSpacing
+        
+            typedef ::SireUnits::Dimension::Length ( ::SireMM::CLJSPMEFunction::*gridSpacing_function_type)(  ) const;
+            gridSpacing_function_type gridSpacing_function_value( &::SireMM::CLJSPMEFunction::gridSpacing );
+            
+            CLJSPMEFunction_exposer.def( 
+                "gridSpacing"
+                , gridSpacing_function_value
+                , "Return the maximum spacing between points on the reciprocal space mesh" );
+        
+        }
+        { //::SireMM::CLJSPMEFunction::longRangeEnergy
+        
+            typedef double ( ::SireMM::CLJSPMEFunction::*longRangeEnergy_function_type)( ::SireMM::CLJAtoms const & ) const;
+            longRangeEnergy_function_type longRangeEnergy_function_value( &::SireMM::CLJSPMEFunction::longRangeEnergy );
+            
+            CLJSPMEFunction_exposer.def( 
+                "longRangeEnergy"
+                , longRangeEnergy_function_value
+                , ( bp::arg("atoms") )
+                , "Return the long-range part of the coulomb energy of the passed atoms\n(the reciprocal space, self and exclusion energies)\nThrow: SireError::incompatible_error\n" );
+        
+        }
+        { //::SireMM::CLJSPMEFunction::longRangeEnergy
+        
+            typedef double ( ::SireMM::CLJSPMEFunction::*longRangeEnergy_function_type)( ::SireMM::CLJBoxes const & ) const;
+            longRangeEnergy_function_type longRangeEnergy_function_value( &::SireMM::CLJSPMEFunction::longRangeEnergy );
+            
+            CLJSPMEFunction_exposer.def( 
+                "longRangeEnergy"
+                , longRangeEnergy_function_value
+                , ( bp::arg("atoms") )
+                , "Return the long-range part of the coulomb energy of the passed atoms\n(the reciprocal space, self and exclusion energies)\nThrow: SireError::incompatible_error\n" );
+        
+        }
+        { //::SireMM::CLJSPMEFunction::meshDimensions
+        
+            typedef ::QVector< int > ( ::SireMM::CLJSPMEFunction::*meshDimensions_function_type)(  ) const;
+            meshDimensions_function_type meshDimensions_function_value( &::SireMM::CLJSPMEFunction::meshDimensions );
+            
+            CLJSPMEFunction_exposer.def( 
+                "meshDimensions"
+                , meshDimensions_function_value
+                , "Return the number of points along each dimension of the reciprocal\nspace mesh for the current periodic box\nThrow: SireError::incompatible_error\n" );
+        
+        }
+        CLJSPMEFunction_exposer.def( bp::self != bp::self );
+        { //::SireMM::CLJSPMEFunction::operator=
+        
+            typedef ::SireMM::CLJSPMEFunction & ( ::SireMM::CLJSPMEFunction::*assign_function_type)( ::SireMM::CLJSPMEFunction const & ) ;
+            assign_function_type assign_function_value( &::SireMM::CLJSPMEFunction::operator= );
+            
+            CLJSPMEFunction_exposer.def( 
+                "assign"
+                , assign_function_value
+                , ( bp::arg("other") )
+                , bp::return_self< >()
+                , "" );
+        
+        }
+        CLJSPMEFunction_exposer.def( bp::self == bp::self );
+        { //::SireMM::CLJSPMEFunction::properties
+        
+            typedef ::SireBase::Properties ( ::SireMM::CLJSPMEFunction::*properties_function_type)(  ) const;
+            properties_function_type properties_function_value( &::SireMM::CLJSPMEFunction::properties );
+            
+            CLJSPMEFunction_exposer.def( 
+                "properties"
+                , properties_function_value
+                , "Return the properties that can be set in this function" );
+        
+        }
+        { //::SireMM::CLJSPMEFunction::property
+        
+            typedef ::SireBase::PropertyPtr ( ::SireMM::CLJSPMEFunction::*property_function_type)( ::QString const & ) const;
+            property_function_type property_function_value( &::SireMM::CLJSPMEFunction::property );
+            
+            CLJSPMEFunction_exposer.def( 
+                "property"
+                , property_function_value
+                , ( bp::arg("name") )
+                , "Return the value of the property with passed name" );
+        
+        }
+        { //::SireMM::CLJSPMEFunction::reciprocalEnergy
+        
+            typedef double ( ::SireMM::CLJSPMEFunction::*reciprocalEnergy_function_type)( ::SireMM::CLJAtoms const & ) const;
+            reciprocalEnergy_function_type reciprocalEnergy_function_value( &::SireMM::CLJSPMEFunction::reciprocalEnergy );
+            
+            CLJSPMEFunction_exposer.def( 
+                "reciprocalEnergy"
+                , reciprocalEnergy_function_value
+                , ( bp::arg("atoms") )
+                , "Return the reciprocal space energy of the passed atoms\nThrow: SireError::incompatible_error\n" );
+        
+        }
+        { //::SireMM::CLJSPMEFunction::reciprocalEnergy
+        
+            typedef double ( ::SireMM::CLJSPMEFunction::*reciprocalEnergy_function_type)( ::SireMM::CLJBoxes const & ) const;
+            reciprocalEnergy_function_type reciprocalEnergy_function_value( &::SireMM::CLJSPMEFunction::reciprocalEnergy );
+            
+            CLJSPMEFunction_exposer.def( 
+                "reciprocalEnergy"
+                , reciprocalEnergy_function_value
+                , ( bp::arg("atoms") )
+                , "Return the reciprocal space energy of the passed atoms\nThrow: SireError::incompatible_error\n" );
+        
+        }
+        { //::SireMM::CLJSPMEFunction::selfEnergy
+        
+            typedef double ( ::SireMM::CLJSPMEFunction::*selfEnergy_function_type)( ::SireMM::CLJAtoms const & ) const;
+            selfEnergy_function_type selfEnergy_function_value( &::SireMM::CLJSPMEFunction::selfEnergy );
+            
+            CLJSPMEFunction_exposer.def( 
+                "selfEnergy"
+                , selfEnergy_function_value
+                , ( bp::arg("atoms") )
+                , "Return the Ewald self energy of the passed atoms" );
+        
+        }
+        { //::SireMM::CLJSPMEFunction::selfEnergy
+        
+            typedef double ( ::SireMM::CLJSPMEFunction::*selfEnergy_function_type)( ::SireMM::CLJBoxes const & ) const;
+            selfEnergy_function_type selfEnergy_function_value( &::SireMM::CLJSPMEFunction::selfEnergy );
+            
+            CLJSPMEFunction_exposer.def( 
+                "selfEnergy"
+                , selfEnergy_function_value
+                , ( bp::arg("atoms") )
+                , "Return the Ewald self energy of the passed atoms" );
+        
+        }
+        { //::SireMM::CLJSPMEFunction::setEwaldPrecision
+        
+            typedef void ( ::SireMM::CLJSPMEFunction::*setEwaldPrecision_function_type)( double ) ;
+            setEwaldPrecision_function_type setEwaldPrecision_function_value( &::SireMM::CLJSPMEFunction::setEwaldPrecision );
+            
+            CLJSPMEFunction_exposer.def( 
+                "setEwaldPrecision"
+                , setEwaldPrecision_function_value
+                , ( bp::arg("precision") )
+                , "Set the relative precision of the Ewald sum" );
+        
+        }
+        { //::SireMM::CLJSPMEFunction::setGridSpacing
+        
+            typedef void ( ::SireMM::CLJSPMEFunction::*setGridSpacing_function_type)( ::SireUnits::Dimension::Length ) ;
+            setGridSpacing_function_type setGridSpacing_function_value( &::SireMM::CLJSPMEFunction::setGridSpacing );
+            
+            CLJSPMEFunction_exposer.def( 
+                "setGridSpacing"
+                , setGridSpacing_function_value
+                , ( bp::arg("spacing") )
+                , "Set the maximum spacing between points on the reciprocal space mesh" );
+        
+        }
+        { //::SireMM::CLJSPMEFunction::setProperty
+        
+            typedef ::SireMM::CLJFunctionPtr ( ::SireMM::CLJSPMEFunction::*setProperty_function_type)( ::QString const &,::SireBase::Property const & ) const;
+            setProperty_function_type setProperty_function_value( &::SireMM::CLJSPMEFunction::setProperty );
+            
+            CLJSPMEFunction_exposer.def( 
+                "setProperty"
+                , setProperty_function_value
+                , ( bp::arg("name"), bp::arg("value") )
+                , "Set the property with passed name to value" );
+        
+        }
+        { //::SireMM::CLJSPMEFunction::setSplineOrder
+        
+            typedef void ( ::SireMM::CLJSPMEFunction::*setSplineOrder_function_type)( int ) ;
+            setSplineOrder_function_type setSplineOrder_function_value( &::SireMM::CLJSPMEFunction::setSplineOrder );
+            
+            CLJSPMEFunction_exposer.def( 
+                "setSplineOrder"
+                , setSplineOrder_function_value
+                , ( bp::arg("order") )
+                , "Set the order of the B-splines used to spread the charges onto the mesh" );
+        
+        }
+        { //::SireMM::CLJSPMEFunction::splineOrder
+        
+            typedef int ( ::SireMM::CLJSPMEFunction::*splineOrder_function_type)(  ) const;
+            splineOrder_function_type splineOrder_function_value( &::SireMM::CLJSPMEFunction::splineOrder );
+            
+            CLJSPMEFunction_exposer.def( 
+                "splineOrder"
+                , splineOrder_function_value
+                , "Return the order of the B-splines used to spread the charges onto the mesh" );
+        
+        }
+        { //::SireMM::CLJSPMEFunction::toString
+        
+            typedef ::QString ( ::SireMM::CLJSPMEFunction::*toString_function_type)(  ) const;
+            toString_function_type toString_function_value( &::SireMM::CLJSPMEFunction::toString );
+            
+            CLJSPMEFunction_exposer.def( 
+                "toString"
+                , toString_function_value
+                , "" );
+        
+        }
+        { //::SireMM::CLJSPMEFunction::typeName
+        
+            typedef char const * ( *typeName_function_type )(  );
+            typeName_function_type typeName_function_value( &::SireMM::CLJSPMEFunction::typeName );
+            
+            CLJSPMEFunction_exposer.def( 
+                "typeName"
+                , typeName_function_value
+                , "" );
+        
+        }
+        { //::SireMM::CLJSPMEFunction::what
+        
+            typedef char const * ( ::SireMM::CLJSPMEFunction::*what_function_type)(  ) const;
+            what_function_type what_function_value( &::SireMM::CLJSPMEFunction::what );
+            
+            CLJSPMEFunction_exposer.def( 
+                "what"
+                , what_function_value
+                , "" );
+        
+        }
+        CLJSPMEFunction_exposer.staticmethod( "defaultSPMEFunction" );
+        CLJSPMEFunction_exposer.staticmethod( "typeName" );
+        CLJSPMEFunction_exposer.def( "__copy__", &__copy__);
+        CLJSPMEFunction_exposer.def( "__deepcopy__", &__copy__);
+        CLJSPMEFunction_exposer.def( "clone", &__copy__);
+        CLJSPMEFunction_exposer.def( "__rlshift__", &__rlshift__QDataStream< ::SireMM::CLJSPMEFunction >,
+                            bp::return_internal_reference<1, bp::with_custodian_and_ward<1,2> >() );
+        CLJSPMEFunction_exposer.def( "__rrshift__", &__rrshift__QDataStream< ::SireMM::CLJSPMEFunction >,
+                            bp::return_internal_reference<1, bp::with_custodian_and_ward<1,2> >() );
+        CLJSPMEFunction_exposer.def( "__str__", &__str__< ::SireMM::CLJSPMEFunction > );
+        CLJSPMEFunction_exposer.def( "__repr__", &__str__< ::SireMM::CLJSPMEFunction > );
+    }
+
+}
@@ -0,0 +1,10 @@
+// This file has been generated by Py++.
+
+// (C) Christopher Woods, GPL >= 2 License
+
+#ifndef CLJSPMEFunction_hpp__pyplusplus_wrapper
+#define CLJSPMEFunction_hpp__pyplusplus_wrapper
+
+void register_CLJSPMEFunction_class();
+
+#endif//CLJSPMEFunction_hpp__pyplusplus_wrapper
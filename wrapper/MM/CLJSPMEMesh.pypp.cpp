@@ -0,0 +1,269 @@
+// This file has been generated by Py++.
+
+// (C) Christopher Woods, GPL >= 2 License
+
+#include "boost/python.hpp"
+#include "CLJSPMEMesh.pypp.hpp"
+
+namespace bp = boost::python;
+
+#include "SireBase/lengthproperty.h"
+
+#include "SireBase/numberproperty.h"
+
+#include "SireError/errors.h"
+
+#include "SireMaths/multidouble.h"
+
+#include "SireMaths/multifloat.h"
+
+#include "SireMaths/multiint.h"
+
+#include "SireStream/datastream.h"
+
+#include "SireStream/shareddatastream.h"
+
+#include "SireUnits/units.h"
+
+#include "SireVol/periodicbox.h"
+
+#include "cljboxes.h"
+
+#include "cljspmefunction.h"
+
+#include "detail/spmefft.h"
+
+#include <QHash>
+
+#include <QVarLengthArray>
+
+#include <complex>
+
+#include <vector>
+
+#include "cljspmefunction.h"
+
+SireMM::CLJSPMEMesh __copy__(const SireMM::CLJSPMEMesh &other){ return SireMM::CLJSPMEMesh(other); }
+
+#include "Qt/qdatastream.hpp"
+
+#include "Helpers/str.hpp"
+
+void register_CLJSPMEMesh_class(){
+
+    { //::SireMM::CLJSPMEMesh
+        typedef bp::class_< SireMM::CLJSPMEMesh > CLJSPMEMesh_exposer_t;
+        CLJSPMEMesh_exposer_t CLJSPMEMesh_exposer = CLJSPMEMesh_exposer_t( "CLJSPMEMesh", "This class holds the Fourier-transformed charge mesh of a periodic\nsystem, as calculated using a CLJSPMEFunction. This allows the\nreciprocal space energy to be updated incrementally during Monte Carlo\nmoves. Only the charges of the atoms that have moved are spread onto\na difference mesh, whose transform is combined with the cached transform\nof the whole system to give the change in reciprocal space energy.\n\nThe change in energy caused by a move is calculated using calculateDelta.\nThis must then be followed by either accept (which adds the change\ninto the cached mesh) or revert (which discards it). The mesh keeps\na copy of the charged atoms of each ID, so that the correction for the\nexcluded pairs of atoms is updated correctly even if the old and new\natoms only contain part of a molecule.\n\nAuthor: Christopher Woods\n", bp::init< >("Constructor") );
+        bp::scope CLJSPMEMesh_scope( CLJSPMEMesh_exposer );
+        CLJSPMEMesh_exposer.def( bp::init< SireMM::CLJSPMEFunction const &, SireMM::CLJAtoms const & >(( bp::arg("function"), bp::arg("atoms") ), "Construct the mesh for the passed atoms using the passed function\nThrow: SireError::incompatible_error\n") );
+        CLJSPMEMesh_exposer.def( bp::init< SireMM::CLJSPMEFunction const &, SireMM::CLJBoxes const & >(( bp::arg("function"), bp::arg("atoms") ), "Construct the mesh for the passed atoms using the passed function\nThrow: SireError::incompatible_error\n") );
+        CLJSPMEMesh_exposer.def( bp::init< SireMM::CLJSPMEMesh const & >(( bp::arg("other") ), "Copy constructor") );
+        { //::SireMM::CLJSPMEMesh::accept
+        
+            typedef void ( ::SireMM::CLJSPMEMesh::*accept_function_type)(  ) ;
+            accept_function_type accept_function_value( &::SireMM::CLJSPMEMesh::accept );
+            
+            CLJSPMEMesh_exposer.def( 
+                "accept"
+                , accept_function_value
+                , "Accept the pending change, adding it into the cached mesh" );
+        
+        }
+        { //::SireMM::CLJSPMEMesh::calculateDelta
+        
+            typedef double ( ::SireMM::CLJSPMEMesh::*calculateDelta_function_type)( ::SireMM::CLJAtoms const &,::SireMM::CLJAtoms const & ) ;
+            calculateDelta_function_type calculateDelta_function_value( &::SireMM::CLJSPMEMesh::calculateDelta );
+            
+            CLJSPMEMesh_exposer.def( 
+                "calculateDelta"
+                , calculateDelta_function_value
+                , ( bp::arg("old_atoms"), bp::arg("new_atoms") )
+                , "Calculate the change in the long-range energy caused by changing\nthe atoms in old_atoms into the atoms in new_atoms. The change\nis held as pending until accept or revert are called. Calling this\nfunction while a change is pending will replace that change.\nThe old and new atoms need only contain the atoms that have\nchanged, not all of the atoms of the changed molecules.\nThrow: SireError::invalid_state\n" );
+        
+        }
+        { //::SireMM::CLJSPMEMesh::calculateDelta
+        
+            typedef double ( ::SireMM::CLJSPMEMesh::*calculateDelta_function_type)( ::SireMM::CLJDelta const & ) ;
+            calculateDelta_function_type calculateDelta_function_value( &::SireMM::CLJSPMEMesh::calculateDelta );
+            
+            CLJSPMEMesh_exposer.def( 
+                "calculateDelta"
+                , calculateDelta_function_value
+                , ( bp::arg("delta") )
+                , "Calculate the change in the long-range energy caused by the passed delta.\nThe change is held as pending until accept or revert are called.\nThrow: SireError::invalid_state\n" );
+        
+        }
+        { //::SireMM::CLJSPMEMesh::correctionEnergy
+        
+            typedef double ( ::SireMM::CLJSPMEMesh::*correctionEnergy_function_type)(  ) const;
+            correctionEnergy_function_type correctionEnergy_function_value( &::SireMM::CLJSPMEMesh::correctionEnergy );
+            
+            CLJSPMEMesh_exposer.def( 
+                "correctionEnergy"
+                , correctionEnergy_function_value
+                , "Return the sum of the self and exclusion energies of the atoms in the mesh" );
+        
+        }
+        { //::SireMM::CLJSPMEMesh::energy
+        
+            typedef double ( ::SireMM::CLJSPMEMesh::*energy_function_type)(  ) const;
+            energy_function_type energy_function_value( &::SireMM::CLJSPMEMesh::energy );
+            
+            CLJSPMEMesh_exposer.def( 
+                "energy"
+                , energy_function_value
+                , "Return the long-range energy (reciprocal space, self and exclusion)\nof the atoms in the mesh. This does not include any pending change" );
+        
+        }
+        { //::SireMM::CLJSPMEMesh::function
+        
+            typedef ::SireMM::CLJSPMEFunction const & ( ::SireMM::CLJSPMEMesh::*function_function_type)(  ) const;
+            function_function_type function_function_value( &::SireMM::CLJSPMEMesh::function );
+            
+            CLJSPMEMesh_exposer.def( 
+                "function"
+                , function_function_value
+                , bp::return_value_policy<bp::clone_const_reference>()
+                , "Return the function used to define the Ewald sum" );
+        
+        }
+        { //::SireMM::CLJSPMEMesh::isEmpty
+        
+            typedef bool ( ::SireMM::CLJSPMEMesh::*isEmpty_function_type)(  ) const;
+            isEmpty_function_type isEmpty_function_value( &::SireMM::CLJSPMEMesh::isEmpty );
+            
+            CLJSPMEMesh_exposer.def( 
+                "isEmpty"
+                , isEmpty_function_value
+                , "Return whether or not this mesh is empty" );
+        
+        }
+        { //::SireMM::CLJSPMEMesh::meshDimensions
+        
+            typedef ::QVector< int > ( ::SireMM::CLJSPMEMesh::*meshDimensions_function_type)(  ) const;
+            meshDimensions_function_type meshDimensions_function_value( &::SireMM::CLJSPMEMesh::meshDimensions );
+            
+            CLJSPMEMesh_exposer.def( 
+                "meshDimensions"
+                , meshDimensions_function_value
+                , "Return the number of points along each dimension of the mesh" );
+        
+        }
+        { //::SireMM::CLJSPMEMesh::needsAccepting
+        
+            typedef bool ( ::SireMM::CLJSPMEMesh::*needsAccepting_function_type)(  ) const;
+            needsAccepting_function_type needsAccepting_function_value( &::SireMM::CLJSPMEMesh::needsAccepting );
+            
+            CLJSPMEMesh_exposer.def( 
+                "needsAccepting"
+                , needsAccepting_function_value
+                , "Return whether or not there is a pending change that needs to be\naccepted or reverted" );
+        
+        }
+        CLJSPMEMesh_exposer.def( bp::self != bp::self );
+        { //::SireMM::CLJSPMEMesh::operator=
+        
+            typedef ::SireMM::CLJSPMEMesh & ( ::SireMM::CLJSPMEMesh::*assign_function_type)( ::SireMM::CLJSPMEMesh const & ) ;
+            assign_function_type assign_function_value( &::SireMM::CLJSPMEMesh::operator= );
+            
+            CLJSPMEMesh_exposer.def( 
+                "assign"
+                , assign_function_value
+                , ( bp::arg("other") )
+                , bp::return_self< >()
+                , "" );
+        
+        }
+        CLJSPMEMesh_exposer.def( bp::self == bp::self );
+        { //::SireMM::CLJSPMEMesh::reciprocalEnergy
+        
+            typedef double ( ::SireMM::CLJSPMEMesh::*reciprocalEnergy_function_type)(  ) const;
+            reciprocalEnergy_function_type reciprocalEnergy_function_value( &::SireMM::CLJSPMEMesh::reciprocalEnergy );
+            
+            CLJSPMEMesh_exposer.def( 
+                "reciprocalEnergy"
+                , reciprocalEnergy_function_value
+                , "Return the reciprocal space energy of the atoms in the mesh" );
+        
+        }
+        { //::SireMM::CLJSPMEMesh::revert
+        
+            typedef void ( ::SireMM::CLJSPMEMesh::*revert_function_type)(  ) ;
+            revert_function_type revert_function_value( &::SireMM::CLJSPMEMesh::revert );
+            
+            CLJSPMEMesh_exposer.def( 
+                "revert"
+                , revert_function_value
+                , "Revert (discard) the pending change" );
+        
+        }
+        { //::SireMM::CLJSPMEMesh::setAtoms
+        
+            typedef void ( ::SireMM::CLJSPMEMesh::*setAtoms_function_type)( ::SireMM::CLJAtoms const & ) ;
+            setAtoms_function_type setAtoms_function_value( &::SireMM::CLJSPMEMesh::setAtoms );
+            
+            CLJSPMEMesh_exposer.def( 
+                "setAtoms"
+                , setAtoms_function_value
+                , ( bp::arg("atoms") )
+                , "Recalculate the mesh from scratch for the passed atoms. This discards\nany pending change\nThrow: SireError::incompatible_error\n" );
+        
+        }
+        { //::SireMM::CLJSPMEMesh::setAtoms
+        
+            typedef void ( ::SireMM::CLJSPMEMesh::*setAtoms_function_type)( ::SireMM::CLJBoxes const & ) ;
+            setAtoms_function_type setAtoms_function_value( &::SireMM::CLJSPMEMesh::setAtoms );
+            
+            CLJSPMEMesh_exposer.def( 
+                "setAtoms"
+                , setAtoms_function_value
+                , ( bp::arg("atoms") )
+                , "Recalculate the mesh from scratch for the passed atoms. This discards\nany pending change\nThrow: SireError::incompatible_error\n" );
+        
+        }
+        { //::SireMM::CLJSPMEMesh::toString
+        
+            typedef ::QString ( ::SireMM::CLJSPMEMesh::*toString_function_type)(  ) const;
+            toString_function_type toString_function_value( &::SireMM::CLJSPMEMesh::toString );
+            
+            CLJSPMEMesh_exposer.def( 
+                "toString"
+                , toString_function_value
+                , "" );
+        
+        }
+        { //::SireMM::CLJSPMEMesh::typeName
+        
+            typedef char const * ( *typeName_function_type )(  );
+            typeName_function_type typeName_function_value( &::SireMM::CLJSPMEMesh::typeName );
+            
+            CLJSPMEMesh_exposer.def( 
+                "typeName"
+                , typeName_function_value
+                , "" );
+        
+        }
+        { //::SireMM::CLJSPMEMesh::what
+        
+            typedef char const * ( ::SireMM::CLJSPMEMesh::*what_function_type)(  ) const;
+            what_function_type what_function_value( &::SireMM::CLJSPMEMesh::what );
+            
+            CLJSPMEMesh_exposer.def( 
+                "what"
+                , what_function_value
+                , "" );
+        
+        }
+        CLJSPMEMesh_exposer.staticmethod( "typeName" );
+        CLJSPMEMesh_exposer.def( "__copy__", &__copy__);
+        CLJSPMEMesh_exposer.def( "__deepcopy__", &__copy__);
+        CLJSPMEMesh_exposer.def( "clone", &__copy__);
+        CLJSPMEMesh_exposer.def( "__rlshift__", &__rlshift__QDataStream< ::SireMM::CLJSPMEMesh >,
+                            bp::return_internal_reference<1, bp::with_custodian_and_ward<1,2> >() );
+        CLJSPMEMesh_exposer.def( "__rrshift__", &__rrshift__QDataStream< ::SireMM::CLJSPMEMesh >,
+                            bp::return_internal_reference<1, bp::with_custodian_and_ward<1,2> >() );
+        CLJSPMEMesh_exposer.def( "__str__", &__str__< ::SireMM::CLJSPMEMesh > );
+        CLJSPMEMesh_exposer.def( "__repr__", &__str__< ::SireMM::CLJSPMEMesh > );
+    }
+
+}
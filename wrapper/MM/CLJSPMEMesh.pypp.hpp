@@ -0,0 +1,10 @@
+// This file has been generated by Py++.
+
+// (C) Christopher Woods, GPL >= 2 License
+
+#ifndef CLJSPMEMesh_hpp__pyplusplus_wrapper
+#define CLJSPMEMesh_hpp__pyplusplus_wrapper
+
+void register_CLJSPMEMesh_class();
+
+#endif//CLJSPMEMesh_hpp__pyplusplus_wrapper
@@ -0,0 +1,113 @@
+// This file has been generated by Py++.
+
+// (C) Christopher Woods, GPL >= 2 License
+
+#include "boost/python.hpp"
+#include "GridCache.pypp.hpp"
+
+namespace bp = boost::python;
+
+#include <QCryptographicHash>
+
+#include <QDebug>
+
+#include <QDir>
+
+#include <QFile>
+
+#include <QFileInfo>
+
+#include <QMutex>
+
+#include <QSaveFile>
+
+#include <cstring>
+
+#include "gridcache.h"
+
+#include "gridcache.h"
+
+void register_GridCache_class(){
+
+    { //::SireMM::GridCache
+        typedef bp::class_< SireMM::GridCache > GridCache_exposer_t;
+        GridCache_exposer_t GridCache_exposer = GridCache_exposer_t( "GridCache", "This class provides a persistent, on-disk cache of the potential\ngrids built by CLJGrid and GridFF2. Building a grid for a large set\nof fixed atoms (e.g. a protein) is expensive, and the same grid is\noften rebuilt by many processes (e.g. when screening many ligands\nagainst the same receptor). The grids are stored in a cache directory,\nkeyed by a hash of everything used to build them (the coordinates and\nparameters of the atoms, the settings of the energy function and the\ndimensions of the grid), so that a grid only needs to be built once.\n\nEach grid is written to its own binary file, with a small header\nfollowed by the raw grid values, so that it can be memory-mapped\nwhen it is read back in. Files are written atomically, so the cache\ncan be shared between processes that are running at the same time.\n\nThe cache is disabled by default. It is enabled by setting the\ncache directory, either using GridCache::setCacheDirectory, or\nvia the SIRE_GRID_CACHE environment variable.\n\nAuthor: Christopher Woods\n", bp::init< >("") );
+        bp::scope GridCache_scope( GridCache_exposer );
+        { //::SireMM::GridCache::cacheDirectory
+        
+            typedef ::QString ( *cacheDirectory_function_type )(  );
+            cacheDirectory_function_type cacheDirectory_function_value( &::SireMM::GridCache::cacheDirectory );
+            
+            GridCache_exposer.def( 
+                "cacheDirectory"
+                , cacheDirectory_function_value
+                , "Return the directory used to hold the cached grids. This is\nempty if the cache is disabled" );
+        
+        }
+        { //::SireMM::GridCache::clear
+        
+            typedef void ( *clear_function_type )(  );
+            clear_function_type clear_function_value( &::SireMM::GridCache::clear );
+            
+            GridCache_exposer.def( 
+                "clear"
+                , clear_function_value
+                , "Remove all of the grids from the cache" );
+        
+        }
+        { //::SireMM::GridCache::contains
+        
+            typedef bool ( *contains_function_type )( ::QString const & );
+            contains_function_type contains_function_value( &::SireMM::GridCache::contains );
+            
+            GridCache_exposer.def( 
+                "contains"
+                , contains_function_value
+                , ( bp::arg("key") )
+                , "Return whether or not the cache contains a grid with the passed key" );
+        
+        }
+        { //::SireMM::GridCache::createKey
+        
+            typedef ::QString ( *createKey_function_type )( ::QByteArray const & );
+            createKey_function_type createKey_function_value( &::SireMM::GridCache::createKey );
+            
+            GridCache_exposer.def( 
+                "createKey"
+                , createKey_function_value
+                , ( bp::arg("data") )
+                , "Create the key for a grid from the passed data. The data\nshould contain everything that was used to build the grid" );
+        
+        }
+        { //::SireMM::GridCache::isEnabled
+        
+            typedef bool ( *isEnabled_function_type )(  );
+            isEnabled_function_type isEnabled_function_value( &::SireMM::GridCache::isEnabled );
+            
+            GridCache_exposer.def( 
+                "isEnabled"
+                , isEnabled_function_value
+                , "Return whether or not the grid cache is enabled" );
+        
+        }
+        { //::SireMM::GridCache::setCacheDirectory
+        
+            typedef void ( *setCacheDirectory_function_type )( ::QString const & );
+            setCacheDirectory_function_type setCacheDirectory_function_value( &::SireMM::GridCache::setCacheDirectory );
+            
+            GridCache_exposer.def( 
+                "setCacheDirectory"
+                , setCacheDirectory_function_value
+                , ( bp::arg("directory") )
+                , "Set the directory used to hold the cached grids. Pass an empty\nstring to disable the cache" );
+        
+        }
+        GridCache_exposer.staticmethod( "cacheDirectory" );
+        GridCache_exposer.staticmethod( "clear" );
+        GridCache_exposer.staticmethod( "contains" );
+        GridCache_exposer.staticmethod( "createKey" );
+        GridCache_exposer.staticmethod( "isEnabled" );
+        GridCache_exposer.staticmethod( "setCacheDirectory" );
+    }
+
+}
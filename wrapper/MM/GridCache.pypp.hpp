@@ -0,0 +1,10 @@
+// This file has been generated by Py++.
+
+// (C) Christopher Woods, GPL >= 2 License
+
+#ifndef GridCache_hpp__pyplusplus_wrapper
+#define GridCache_hpp__pyplusplus_wrapper
+
+void register_GridCache_class();
+
+#endif//GridCache_hpp__pyplusplus_wrapper
@@ -146,6 +146,17 @@ void register_GridFF2_class(){
                 , mustNowRecalculateFromScratch_function_value
                 , "Ensure that the next energy evaluation is from scratch" );
         
+        }
+        { //::SireMM::GridFF2::nLJGrids
+        
+            typedef int ( ::SireMM::GridFF2::*nLJGrids_function_type)(  ) const;
+            nLJGrids_function_type nLJGrids_function_value( &::SireMM::GridFF2::nLJGrids );
+            
+            GridFF2_exposer.def( 
+                "nLJGrids"
+                , nLJGrids_function_value
+                , "Return the number of LJ grids (one for each distinct LJ parameter\nof the atoms in group 1). This is zero if LJ grids are not used,\nor if the grids have not yet been built" );
+        
         }
         GridFF2_exposer.def( bp::self != bp::self );
         { //::SireMM::GridFF2::operator=
@@ -233,6 +244,18 @@ void register_GridFF2_class(){
                 , ( bp::arg("on") )
                 , "Turn on or off use of the force shifted potential" );
         
+        }
+        { //::SireMM::GridFF2::setUseLJGrids
+        
+            typedef bool ( ::SireMM::GridFF2::*setUseLJGrids_function_type)( bool ) ;
+            setUseLJGrids_function_type setUseLJGrids_function_value( &::SireMM::GridFF2::setUseLJGrids );
+            
+            GridFF2_exposer.def( 
+                "setUseLJGrids"
+                , setUseLJGrids_function_value
+                , ( bp::arg("on") )
+                , "Turn on or off the use of grids for the LJ energy. If this is on,\nthen a grid of LJ potentials is built for each distinct LJ parameter\nused by the atoms in group 1, and the coulomb and LJ energies\nof group 1 molecules are calculated only by interpolating from\nthe grids. This means that the cost of moving a group 1 molecule\ndepends only on its number of atoms, rather than on the number of\nfixed atoms close to the grid. As the LJ potential is very steep,\nthis should be used with a small grid spacing, and ideally with\ntricubic interpolation" );
+        
         }
         { //::SireMM::GridFF2::setUseReactionField
         
@@ -245,6 +268,18 @@ void register_GridFF2_class(){
                 , ( bp::arg("on") )
                 , "Turn on or off the use of the reaction field" );
         
+        }
+        { //::SireMM::GridFF2::setUseTricubicInterpolation
+        
+            typedef bool ( ::SireMM::GridFF2::*setUseTricubicInterpolation_function_type)( bool ) ;
+            setUseTricubicInterpolation_function_type setUseTricubicInterpolation_function_value( &::SireMM::GridFF2::setUseTricubicInterpolation );
+            
+            GridFF2_exposer.def( 
+                "setUseTricubicInterpolation"
+                , setUseTricubicInterpolation_function_value
+                , ( bp::arg("on") )
+                , "Turn on or off the use of tricubic interpolation of the grids.\nThis is more accurate than the default trilinear interpolation,\nbut needs 64 rather than 8 grid points for each atom" );
+        
         }
         { //::SireMM::GridFF2::spacing
         
@@ -267,6 +302,28 @@ void register_GridFF2_class(){
                 , typeName_function_value
                 , "" );
         
+        }
+        { //::SireMM::GridFF2::usesLJGrids
+        
+            typedef bool ( ::SireMM::GridFF2::*usesLJGrids_function_type)(  ) const;
+            usesLJGrids_function_type usesLJGrids_function_value( &::SireMM::GridFF2::usesLJGrids );
+            
+            GridFF2_exposer.def( 
+                "usesLJGrids"
+                , usesLJGrids_function_value
+                , "Return whether or not grids are used for the LJ energy" );
+        
+        }
+        { //::SireMM::GridFF2::usesTricubicInterpolation
+        
+            typedef bool ( ::SireMM::GridFF2::*usesTricubicInterpolation_function_type)(  ) const;
+            usesTricubicInterpolation_function_type usesTricubicInterpolation_function_value( &::SireMM::GridFF2::usesTricubicInterpolation );
+            
+            GridFF2_exposer.def( 
+                "usesTricubicInterpolation"
+                , usesTricubicInterpolation_function_value
+                , "Return whether or not tricubic interpolation is used to\ninterpolate the grids" );
+        
         }
         { //::SireMM::GridFF2::what
         
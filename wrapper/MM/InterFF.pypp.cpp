@@ -61,7 +61,7 @@ SireMM::InterFF __copy__(const SireMM::InterFF &other){ return SireMM::InterFF(o
 void register_InterFF_class(){
 
     { //::SireMM::InterFF
-        typedef bp::class_< SireMM::InterFF, bp::bases< SireFF::G1FF, SireFF::FF, SireMol::MolGroupsBase, SireBase::Property > > InterFF_exposer_t;
+        typedef bp::class_< SireMM::InterFF, bp::bases< SireFF::FF3D, SireFF::G1FF, SireFF::FF, SireMol::MolGroupsBase, SireBase::Property > > InterFF_exposer_t;
         InterFF_exposer_t InterFF_exposer = InterFF_exposer_t( "InterFF", "This is a forcefield that calculates the intermolecular coulomb\nand Lennard Jones (LJ) energy of all contained molecule views.\nIt also calculates the interactions with any fixed atoms added\nto this forcefield\n\nAuthor: Christopher Woods\n", bp::init< >("Constructor") );
         bp::scope InterFF_scope( InterFF_exposer );
         InterFF_exposer.def( bp::init< QString const & >(( bp::arg("name") ), "Construct, specifying the name of the forcefield") );
@@ -194,6 +194,17 @@ void register_InterFF_class(){
                 , disableGrid_function_value
                 , "Turn off use of the grid" );
         
+        }
+        { //::SireMM::InterFF::disableNeighbourList
+        
+            typedef void ( ::SireMM::InterFF::*disableNeighbourList_function_type)(  ) ;
+            disableNeighbourList_function_type disableNeighbourList_function_value( &::SireMM::InterFF::disableNeighbourList );
+            
+            InterFF_exposer.def( 
+                "disableNeighbourList"
+                , disableNeighbourList_function_value
+                , "Turn off the use of Verlet neighbour lists to calculate the energy.\nThis is off by default" );
+        
         }
         { //::SireMM::InterFF::disableParallelCalculation
         
@@ -227,6 +238,17 @@ void register_InterFF_class(){
                 , enableGrid_function_value
                 , "Turn on the use of the grid" );
         
+        }
+        { //::SireMM::InterFF::enableNeighbourList
+        
+            typedef void ( ::SireMM::InterFF::*enableNeighbourList_function_type)(  ) ;
+            enableNeighbourList_function_type enableNeighbourList_function_value( &::SireMM::InterFF::enableNeighbourList );
+            
+            InterFF_exposer.def( 
+                "enableNeighbourList"
+                , enableNeighbourList_function_value
+                , "Turn on the use of Verlet neighbour lists to calculate the energy" );
+        
         }
         { //::SireMM::InterFF::enableParallelCalculation
         
@@ -249,6 +271,101 @@ void register_InterFF_class(){
                 , enableReproducibleCalculation_function_value
                 , "Turn on an energy summing algorithm that guarantees the same energy\nregardless of whether a single core or multicore calculation is being\nperformed (i.e. rounding errors in both cases will be identical)" );
         
+        }
+        { //::SireMM::InterFF::energy
+        
+            typedef ::SireUnits::Dimension::MolarEnergy ( ::SireMM::InterFF::*energy_function_type)(  ) ;
+            energy_function_type energy_function_value( &::SireMM::InterFF::energy );
+            
+            InterFF_exposer.def( 
+                "energy"
+                , energy_function_value
+                , "Return the total energy of this forcefield" );
+        
+        }
+        { //::SireMM::InterFF::energy
+        
+            typedef ::SireUnits::Dimension::MolarEnergy ( ::SireMM::InterFF::*energy_function_type)( ::SireCAS::Symbol const & ) ;
+            energy_function_type energy_function_value( &::SireMM::InterFF::energy );
+            
+            InterFF_exposer.def( 
+                "energy"
+                , energy_function_value
+                , ( bp::arg("component") )
+                , "Return the energy of the component component of this forcefield" );
+        
+        }
+        { //::SireMM::InterFF::energy
+        
+            typedef void ( ::SireMM::InterFF::*energy_function_type)( ::SireFF::EnergyTable &,double ) ;
+            energy_function_type energy_function_value( &::SireMM::InterFF::energy );
+            
+            InterFF_exposer.def( 
+                "energy"
+                , energy_function_value
+                , ( bp::arg("energytable"), bp::arg("scale_energy")=1 )
+                , "Calculate the energies of molecules in the passed energy table\ncaused by this forcefield. This is not yet supported" );
+        
+        }
+        { //::SireMM::InterFF::energy
+        
+            typedef void ( ::SireMM::InterFF::*energy_function_type)( ::SireFF::EnergyTable &,::SireCAS::Symbol const &,double ) ;
+            energy_function_type energy_function_value( &::SireMM::InterFF::energy );
+            
+            InterFF_exposer.def( 
+                "energy"
+                , energy_function_value
+                , ( bp::arg("energytable"), bp::arg("symbol"), bp::arg("scale_energy")=1 )
+                , "Calculate the energies of molecules in the passed energy table\ncaused by the component symbol. This is not yet supported" );
+        
+        }
+        { //::SireMM::InterFF::field
+        
+            typedef void ( ::SireMM::InterFF::*field_function_type)( ::SireFF::FieldTable &,double ) ;
+            field_function_type field_function_value( &::SireMM::InterFF::field );
+            
+            InterFF_exposer.def( 
+                "field"
+                , field_function_value
+                , ( bp::arg("fieldtable"), bp::arg("scale_field")=1 )
+                , "" );
+        
+        }
+        { //::SireMM::InterFF::field
+        
+            typedef void ( ::SireMM::InterFF::*field_function_type)( ::SireFF::FieldTable &,::SireCAS::Symbol const &,double ) ;
+            field_function_type field_function_value( &::SireMM::InterFF::field );
+            
+            InterFF_exposer.def( 
+                "field"
+                , field_function_value
+                , ( bp::arg("fieldtable"), bp::arg("component"), bp::arg("scale_field")=1 )
+                , "" );
+        
+        }
+        { //::SireMM::InterFF::field
+        
+            typedef void ( ::SireMM::InterFF::*field_function_type)( ::SireFF::FieldTable &,::SireFF::Probe const &,double ) ;
+            field_function_type field_function_value( &::SireMM::InterFF::field );
+            
+            InterFF_exposer.def( 
+                "field"
+                , field_function_value
+                , ( bp::arg("fieldtable"), bp::arg("probe"), bp::arg("scale_field")=1 )
+                , "" );
+        
+        }
+        { //::SireMM::InterFF::field
+        
+            typedef void ( ::SireMM::InterFF::*field_function_type)( ::SireFF::FieldTable &,::SireCAS::Symbol const &,::SireFF::Probe const &,double ) ;
+            field_function_type field_function_value( &::SireMM::InterFF::field );
+            
+            InterFF_exposer.def( 
+                "field"
+                , field_function_value
+                , ( bp::arg("fieldtable"), bp::arg("component"), bp::arg("probe"), bp::arg("scale_field")=1 )
+                , "" );
+        
         }
         { //::SireMM::InterFF::fixedOnly
         
@@ -260,6 +377,30 @@ void register_InterFF_class(){
                 , fixedOnly_function_value
                 , "Return whether or not only the energy between the mobile and fixed\natoms is being calculated" );
         
+        }
+        { //::SireMM::InterFF::force
+        
+            typedef void ( ::SireMM::InterFF::*force_function_type)( ::SireFF::ForceTable &,double ) ;
+            force_function_type force_function_value( &::SireMM::InterFF::force );
+            
+            InterFF_exposer.def( 
+                "force"
+                , force_function_value
+                , ( bp::arg("forcetable"), bp::arg("scale_force")=1 )
+                , "Calculate the forces acting on the molecules in the passed force table\ncaused by this forcefield, and add them onto the forces already\nin the force table (optionally scaled by scale_force)\nThrow: SireError::unsupported\n" );
+        
+        }
+        { //::SireMM::InterFF::force
+        
+            typedef void ( ::SireMM::InterFF::*force_function_type)( ::SireFF::ForceTable &,::SireCAS::Symbol const &,double ) ;
+            force_function_type force_function_value( &::SireMM::InterFF::force );
+            
+            InterFF_exposer.def( 
+                "force"
+                , force_function_value
+                , ( bp::arg("forcetable"), bp::arg("symbol"), bp::arg("scale_force")=1 )
+                , "Calculate the forces acting on the molecules in the passed force table\ncaused by the component of this forcefield represented by symbol,\nand add them onto the forces already in the force table (optionally\nscaled by scale_force). Forces can only be calculated for the\ntotal energy of each CLJFunction. The interactions with the fixed atoms are\ncalculated explicitly, even if a grid is used for the energy\nThrow: SireError::unsupported\nThrow: SireFF::missing_component\n" );
+        
         }
         { //::SireMM::InterFF::grid
         
@@ -326,6 +467,65 @@ void register_InterFF_class(){
                 , needsAccepting_function_value
                 , "Return whether or not this forcefield is using a temporary workspace that\nneeds to be accepted" );
         
+        }
+        { //::SireMM::InterFF::neighbourListSkin
+        
+            typedef ::SireUnits::Dimension::Length ( ::SireMM::InterFF::*neighbourListSkin_function_type)(  ) const;
+            neighbourListSkin_function_type neighbourListSkin_function_value( &::SireMM::InterFF::neighbourListSkin );
+            
+            InterFF_exposer.def( 
+                "neighbourListSkin"
+                , neighbourListSkin_function_value
+                , "Return the skin added onto the cutoff when building the neighbour lists" );
+        
+        }
+        { //::SireMM::InterFF::potential
+        
+            typedef void ( ::SireMM::InterFF::*potential_function_type)( ::SireFF::PotentialTable &,double ) ;
+            potential_function_type potential_function_value( &::SireMM::InterFF::potential );
+            
+            InterFF_exposer.def( 
+                "potential"
+                , potential_function_value
+                , ( bp::arg("potentialtable"), bp::arg("scale_potential")=1 )
+                , "" );
+        
+        }
+        { //::SireMM::InterFF::potential
+        
+            typedef void ( ::SireMM::InterFF::*potential_function_type)( ::SireFF::PotentialTable &,::SireCAS::Symbol const &,double ) ;
+            potential_function_type potential_function_value( &::SireMM::InterFF::potential );
+            
+            InterFF_exposer.def( 
+                "potential"
+                , potential_function_value
+                , ( bp::arg("potentialtable"), bp::arg("component"), bp::arg("scale_potential")=1 )
+                , "" );
+        
+        }
+        { //::SireMM::InterFF::potential
+        
+            typedef void ( ::SireMM::InterFF::*potential_function_type)( ::SireFF::PotentialTable &,::SireFF::Probe const &,double ) ;
+            potential_function_type potential_function_value( &::SireMM::InterFF::potential );
+            
+            InterFF_exposer.def( 
+                "potential"
+                , potential_function_value
+                , ( bp::arg("potentialtable"), bp::arg("probe"), bp::arg("scale_potential")=1 )
+                , "" );
+        
+        }
+        { //::SireMM::InterFF::potential
+        
+            typedef void ( ::SireMM::InterFF::*potential_function_type)( ::SireFF::PotentialTable &,::SireCAS::Symbol const &,::SireFF::Probe const &,double ) ;
+            potential_function_type potential_function_value( &::SireMM::InterFF::potential );
+            
+            InterFF_exposer.def( 
+                "potential"
+                , potential_function_value
+                , ( bp::arg("potentialtable"), bp::arg("component"), bp::arg("probe"), bp::arg("scale_potential")=1 )
+                , "" );
+        
         }
         InterFF_exposer.def( bp::self != bp::self );
         { //::SireMM::InterFF::operator=
@@ -485,6 +685,18 @@ void register_InterFF_class(){
                 , ( bp::arg("spacing") )
                 , "Set the spacing between grid points" );
         
+        }
+        { //::SireMM::InterFF::setNeighbourListSkin
+        
+            typedef void ( ::SireMM::InterFF::*setNeighbourListSkin_function_type)( ::SireUnits::Dimension::Length ) ;
+            setNeighbourListSkin_function_type setNeighbourListSkin_function_value( &::SireMM::InterFF::setNeighbourListSkin );
+            
+            InterFF_exposer.def( 
+                "setNeighbourListSkin"
+                , setNeighbourListSkin_function_value
+                , ( bp::arg("skin") )
+                , "Set the skin added onto the cutoff when building the neighbour lists" );
+        
         }
         { //::SireMM::InterFF::setProperty
         
@@ -509,6 +721,18 @@ void register_InterFF_class(){
                 , ( bp::arg("on") )
                 , "Set whether or not a grid is used to optimise energy calculations with the fixed atoms" );
         
+        }
+        { //::SireMM::InterFF::setUseNeighbourList
+        
+            typedef void ( ::SireMM::InterFF::*setUseNeighbourList_function_type)( bool ) ;
+            setUseNeighbourList_function_type setUseNeighbourList_function_value( &::SireMM::InterFF::setUseNeighbourList );
+            
+            InterFF_exposer.def( 
+                "setUseNeighbourList"
+                , setUseNeighbourList_function_value
+                , ( bp::arg("on") )
+                , "Switch on or off the use of Verlet neighbour lists (CLJNeighbourList)\nwhen the energy is calculated from scratch. The neighbour lists are only\nrebuilt when an atom has moved by more than half of the skin, so this\nis quicker for molecular dynamics, where every molecule moves by a\nsmall amount each step. When this is on, the energy is recalculated\nfrom scratch whenever more than half of the molecules have changed" );
+        
         }
         { //::SireMM::InterFF::setUseParallelCalculation
         
@@ -555,6 +779,17 @@ void register_InterFF_class(){
                 , usesGrid_function_value
                 , "Return whether or not the grid is used" );
         
+        }
+        { //::SireMM::InterFF::usesNeighbourList
+        
+            typedef bool ( ::SireMM::InterFF::*usesNeighbourList_function_type)(  ) const;
+            usesNeighbourList_function_type usesNeighbourList_function_value( &::SireMM::InterFF::usesNeighbourList );
+            
+            InterFF_exposer.def( 
+                "usesNeighbourList"
+                , usesNeighbourList_function_value
+                , "Return whether or not Verlet neighbour lists are used to calculate the energy" );
+        
         }
         { //::SireMM::InterFF::usesParallelCalculation
         
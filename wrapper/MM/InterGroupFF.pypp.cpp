@@ -59,7 +59,7 @@ SireMM::InterGroupFF __copy__(const SireMM::InterGroupFF &other){ return SireMM:
 void register_InterGroupFF_class(){
 
     { //::SireMM::InterGroupFF
-        typedef bp::class_< SireMM::InterGroupFF, bp::bases< SireFF::G2FF, SireFF::FF, SireMol::MolGroupsBase, SireBase::Property > > InterGroupFF_exposer_t;
+        typedef bp::class_< SireMM::InterGroupFF, bp::bases< SireFF::FF3D, SireFF::G2FF, SireFF::FF, SireMol::MolGroupsBase, SireBase::Property > > InterGroupFF_exposer_t;
         InterGroupFF_exposer_t InterGroupFF_exposer = InterGroupFF_exposer_t( "InterGroupFF", "This is a forcefield that calculates the intermolecular coulomb\nand Lennard Jones (LJ) energy between all molecules in group 0\nand all molecules in group 1.\n\nIt also calculates the interactions between all molecules in group 0\nwith any fixed atoms added to this forcefield\n\nAuthor: Christopher Woods\n", bp::init< >("Constructor") );
         bp::scope InterGroupFF_scope( InterGroupFF_exposer );
         InterGroupFF_exposer.def( bp::init< QString const & >(( bp::arg("name") ), "Construct, specifying the name of the forcefield") );
@@ -247,6 +247,101 @@ void register_InterGroupFF_class(){
                 , enableReproducibleCalculation_function_value
                 , "Turn on an energy summing algorithm that guarantees the same energy\nregardless of whether a single core or multicore calculation is being\nperformed (i.e. rounding errors in both cases will be identical)" );
         
+        }
+        { //::SireMM::InterGroupFF::energy
+        
+            typedef ::SireUnits::Dimension::MolarEnergy ( ::SireMM::InterGroupFF::*energy_function_type)(  ) ;
+            energy_function_type energy_function_value( &::SireMM::InterGroupFF::energy );
+            
+            InterGroupFF_exposer.def( 
+                "energy"
+                , energy_function_value
+                , "Return the total energy of this forcefield" );
+        
+        }
+        { //::SireMM::InterGroupFF::energy
+        
+            typedef ::SireUnits::Dimension::MolarEnergy ( ::SireMM::InterGroupFF::*energy_function_type)( ::SireCAS::Symbol const & ) ;
+            energy_function_type energy_function_value( &::SireMM::InterGroupFF::energy );
+            
+            InterGroupFF_exposer.def( 
+                "energy"
+                , energy_function_value
+                , ( bp::arg("component") )
+                , "Return the energy of the component component of this forcefield" );
+        
+        }
+        { //::SireMM::InterGroupFF::energy
+        
+            typedef void ( ::SireMM::InterGroupFF::*energy_function_type)( ::SireFF::EnergyTable &,double ) ;
+            energy_function_type energy_function_value( &::SireMM::InterGroupFF::energy );
+            
+            InterGroupFF_exposer.def( 
+                "energy"
+                , energy_function_value
+                , ( bp::arg("energytable"), bp::arg("scale_energy")=1 )
+                , "Calculate the energies of molecules in the passed energy table\ncaused by this forcefield. This is not yet supported" );
+        
+        }
+        { //::SireMM::InterGroupFF::energy
+        
+            typedef void ( ::SireMM::InterGroupFF::*energy_function_type)( ::SireFF::EnergyTable &,::SireCAS::Symbol const &,double ) ;
+            energy_function_type energy_function_value( &::SireMM::InterGroupFF::energy );
+            
+            InterGroupFF_exposer.def( 
+                "energy"
+                , energy_function_value
+                , ( bp::arg("energytable"), bp::arg("symbol"), bp::arg("scale_energy")=1 )
+                , "Calculate the energies of molecules in the passed energy table\ncaused by the component symbol. This is not yet supported" );
+        
+        }
+        { //::SireMM::InterGroupFF::field
+        
+            typedef void ( ::SireMM::InterGroupFF::*field_function_type)( ::SireFF::FieldTable &,double ) ;
+            field_function_type field_function_value( &::SireMM::InterGroupFF::field );
+            
+            InterGroupFF_exposer.def( 
+                "field"
+                , field_function_value
+                , ( bp::arg("fieldtable"), bp::arg("scale_field")=1 )
+                , "" );
+        
+        }
+        { //::SireMM::InterGroupFF::field
+        
+            typedef void ( ::SireMM::InterGroupFF::*field_function_type)( ::SireFF::FieldTable &,::SireCAS::Symbol const &,double ) ;
+            field_function_type field_function_value( &::SireMM::InterGroupFF::field );
+            
+            InterGroupFF_exposer.def( 
+                "field"
+                , field_function_value
+                , ( bp::arg("fieldtable"), bp::arg("component"), bp::arg("scale_field")=1 )
+                , "" );
+        
+        }
+        { //::SireMM::InterGroupFF::field
+        
+            typedef void ( ::SireMM::InterGroupFF::*field_function_type)( ::SireFF::FieldTable &,::SireFF::Probe const &,double ) ;
+            field_function_type field_function_value( &::SireMM::InterGroupFF::field );
+            
+            InterGroupFF_exposer.def( 
+                "field"
+                , field_function_value
+                , ( bp::arg("fieldtable"), bp::arg("probe"), bp::arg("scale_field")=1 )
+                , "" );
+        
+        }
+        { //::SireMM::InterGroupFF::field
+        
+            typedef void ( ::SireMM::InterGroupFF::*field_function_type)( ::SireFF::FieldTable &,::SireCAS::Symbol const &,::SireFF::Probe const &,double ) ;
+            field_function_type field_function_value( &::SireMM::InterGroupFF::field );
+            
+            InterGroupFF_exposer.def( 
+                "field"
+                , field_function_value
+                , ( bp::arg("fieldtable"), bp::arg("component"), bp::arg("probe"), bp::arg("scale_field")=1 )
+                , "" );
+        
         }
         { //::SireMM::InterGroupFF::fixedOnly
         
@@ -258,6 +353,30 @@ void register_InterGroupFF_class(){
                 , fixedOnly_function_value
                 , "Return whether or not only the energy between the mobile and fixed\natoms is being calculated" );
         
+        }
+        { //::SireMM::InterGroupFF::force
+        
+            typedef void ( ::SireMM::InterGroupFF::*force_function_type)( ::SireFF::ForceTable &,double ) ;
+            force_function_type force_function_value( &::SireMM::InterGroupFF::force );
+            
+            InterGroupFF_exposer.def( 
+                "force"
+                , force_function_value
+                , ( bp::arg("forcetable"), bp::arg("scale_force")=1 )
+                , "Calculate the forces acting on the molecules in the passed force table\ncaused by this forcefield, and add them onto the forces already\nin the force table (optionally scaled by scale_force)\nThrow: SireError::unsupported\n" );
+        
+        }
+        { //::SireMM::InterGroupFF::force
+        
+            typedef void ( ::SireMM::InterGroupFF::*force_function_type)( ::SireFF::ForceTable &,::SireCAS::Symbol const &,double ) ;
+            force_function_type force_function_value( &::SireMM::InterGroupFF::force );
+            
+            InterGroupFF_exposer.def( 
+                "force"
+                , force_function_value
+                , ( bp::arg("forcetable"), bp::arg("symbol"), bp::arg("scale_force")=1 )
+                , "Calculate the forces acting on the molecules in the passed force table\ncaused by the component of this forcefield represented by symbol,\nand add them onto the forces already in the force table (optionally\nscaled by scale_force). Forces can only be calculated for the\ntotal energy of each CLJFunction. The interactions between group 0 and\nthe fixed atoms are calculated explicitly, even if a grid is used\nfor the energy\nThrow: SireError::unsupported\nThrow: SireFF::missing_component\n" );
+        
         }
         { //::SireMM::InterGroupFF::grid
         
@@ -324,6 +443,54 @@ void register_InterGroupFF_class(){
                 , needsAccepting_function_value
                 , "Return whether or not this forcefield is using a temporary workspace that\nneeds to be accepted" );
         
+        }
+        { //::SireMM::InterGroupFF::potential
+        
+            typedef void ( ::SireMM::InterGroupFF::*potential_function_type)( ::SireFF::PotentialTable &,double ) ;
+            potential_function_type potential_function_value( &::SireMM::InterGroupFF::potential );
+            
+            InterGroupFF_exposer.def( 
+                "potential"
+                , potential_function_value
+                , ( bp::arg("potentialtable"), bp::arg("scale_potential")=1 )
+                , "" );
+        
+        }
+        { //::SireMM::InterGroupFF::potential
+        
+            typedef void ( ::SireMM::InterGroupFF::*potential_function_type)( ::SireFF::PotentialTable &,::SireCAS::Symbol const &,double ) ;
+            potential_function_type potential_function_value( &::SireMM::InterGroupFF::potential );
+            
+            InterGroupFF_exposer.def( 
+                "potential"
+                , potential_function_value
+                , ( bp::arg("potentialtable"), bp::arg("component"), bp::arg("scale_potential")=1 )
+                , "" );
+        
+        }
+        { //::SireMM::InterGroupFF::potential
+        
+            typedef void ( ::SireMM::InterGroupFF::*potential_function_type)( ::SireFF::PotentialTable &,::SireFF::Probe const &,double ) ;
+            potential_function_type potential_function_value( &::SireMM::InterGroupFF::potential );
+            
+            InterGroupFF_exposer.def( 
+                "potential"
+                , potential_function_value
+                , ( bp::arg("potentialtable"), bp::arg("probe"), bp::arg("scale_potential")=1 )
+                , "" );
+        
+        }
+        { //::SireMM::InterGroupFF::potential
+        
+            typedef void ( ::SireMM::InterGroupFF::*potential_function_type)( ::SireFF::PotentialTable &,::SireCAS::Symbol const &,::SireFF::Probe const &,double ) ;
+            potential_function_type potential_function_value( &::SireMM::InterGroupFF::potential );
+            
+            InterGroupFF_exposer.def( 
+                "potential"
+                , potential_function_value
+                , ( bp::arg("potentialtable"), bp::arg("component"), bp::arg("probe"), bp::arg("scale_potential")=1 )
+                , "" );
+        
         }
         InterGroupFF_exposer.def( bp::self != bp::self );
         { //::SireMM::InterGroupFF::operator=
@@ -53,6 +53,8 @@
 #include "SireMM/gromacsparams.h"
 
 #include "SireMM/cljboxes.h"
+#include "SireMM/cljdelta.h"
+#include "SireMM/cljforces.h"
 
 #include "SireBase/packedarray2d.hpp"
 
@@ -75,6 +77,10 @@ void register_SireMM_containers()
     register_list< QVector<CLJBox> >();
     register_list< QVector<CLJBoxIndex> >();
 
+    register_list< QVector<CLJDelta> >();
+
+    register_list< QVector<CLJForces> >();
+
     register_list< QList<GromacsBond> >();
     register_list< QList<GromacsAngle> >();
     register_list< QList<GromacsDihedral> >();
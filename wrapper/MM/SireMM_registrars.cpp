@@ -55,6 +55,10 @@
 #include "cljcomponent.h"
 #include "restraintcomponent.h"
 #include "cljcalculator.h"
+#include "cljspmefunction.h"
+#include "cljewald.h"
+#include "cljneighbourlist.h"
+#include "cljforces.h"
 
 #include "Helpers/objectregistry.hpp"
 
@@ -186,5 +190,10 @@ void register_SireMM_objects()
     ObjectRegistry::registerConverterFor< SireMM::CLJComponent >();
     ObjectRegistry::registerConverterFor< SireMM::RestraintComponent >();
     ObjectRegistry::registerConverterFor< SireMM::CLJCalculator >();
+    ObjectRegistry::registerConverterFor< SireMM::CLJSPMEFunction >();
+    ObjectRegistry::registerConverterFor< SireMM::CLJSPMEMesh >();
+    ObjectRegistry::registerConverterFor< SireMM::CLJEwald >();
+    ObjectRegistry::registerConverterFor< SireMM::CLJNeighbourList >();
+    ObjectRegistry::registerConverterFor< SireMM::CLJForces >();
 }
 
@@ -75,8 +75,12 @@
 
 #include "CLJDelta.pypp.hpp"
 
+#include "CLJEwald.pypp.hpp"
+
 #include "CLJExtractor.pypp.hpp"
 
+#include "CLJForces.pypp.hpp"
+
 #include "CLJFunction.pypp.hpp"
 
 #include "CLJGrid.pypp.hpp"
@@ -89,8 +93,12 @@
 
 #include "CLJIntraShiftFunction.pypp.hpp"
 
+#include "CLJKernels.pypp.hpp"
+
 #include "CLJNBPairs.pypp.hpp"
 
+#include "CLJNeighbourList.pypp.hpp"
+
 #include "CLJParameterNames.pypp.hpp"
 
 #include "CLJParameterNames3D.pypp.hpp"
@@ -107,6 +115,10 @@
 
 #include "CLJRFFunction.pypp.hpp"
 
+#include "CLJSPMEFunction.pypp.hpp"
+
+#include "CLJSPMEMesh.pypp.hpp"
+
 #include "CLJScaleFactor.pypp.hpp"
 
 #include "CLJShiftFunction.pypp.hpp"
@@ -159,6 +171,8 @@
 
 #include "FourAtomPerturbation.pypp.hpp"
 
+#include "GridCache.pypp.hpp"
+
 #include "GridFF.pypp.hpp"
 
 #include "GridFF2.pypp.hpp"
@@ -382,6 +396,8 @@ BOOST_PYTHON_MODULE(_MM){
 
     register_CLJPotentialInterface_InterCLJPotential__class();
 
+    register_GridCache_class();
+
     register_InterGroupCLJFFBase_class();
 
     register_InterGroupCLJFF_class();
@@ -548,10 +564,16 @@ BOOST_PYTHON_MODULE(_MM){
 
     register_CLJExtractor_class();
 
+    register_CLJForces_class();
+
     register_CLJGrid_class();
 
     register_CLJGroup_class();
 
+    register_CLJKernels_class();
+
+    register_CLJNeighbourList_class();
+
     register_CLJIntraFunction_class();
 
     register_CLJIntraRFFunction_class();
@@ -572,6 +594,12 @@ BOOST_PYTHON_MODULE(_MM){
 
     register_CLJRFFunction_class();
 
+    register_CLJSPMEFunction_class();
+
+    register_CLJSPMEMesh_class();
+
+    register_CLJEwald_class();
+
     register_CLJShiftFunction_class();
 
     register_CLJSoftFunction_class();
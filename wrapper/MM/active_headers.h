@@ -13,21 +13,27 @@
 #include "cljcalculator.h"
 #include "cljcomponent.h"
 #include "cljdelta.h"
+#include "cljewald.h"
 #include "cljextractor.h"
+#include "cljforces.h"
 #include "cljfunction.h"
 #include "cljgrid.h"
 #include "cljgroup.h"
+#include "cljkernels.h"
 #include "cljnbpairs.h"
+#include "cljneighbourlist.h"
 #include "cljparam.h"
 #include "cljpotential.h"
 #include "cljprobe.h"
 #include "cljrffunction.h"
 #include "cljshiftfunction.h"
+#include "cljspmefunction.h"
 #include "cljworkspace.h"
 #include "coulombpotential.h"
 #include "dihedralrestraint.h"
 #include "distancerestraint.h"
 #include "fouratomfunctions.h"
+#include "gridcache.h"
 #include "gridff.h"
 #include "gridff2.h"
 #include "gromacsparams.h"
@@ -49,7 +49,7 @@ void register_RanGenerator_class(){
         bp::scope RanGenerator_scope( RanGenerator_exposer );
         RanGenerator_exposer.def( bp::init< quint32 >(( bp::arg("seed") ), "Create a generator seeded with seed") );
         RanGenerator_exposer.def( bp::init< QVector< unsigned int > const & >(( bp::arg("seed") ), "Create a generator seeded with seed") );
-        RanGenerator_exposer.def( bp::init< SireMaths::RanGenerator const & >(( bp::arg("other") ), "Copy constructor - this takes an explicitly shared\ncopy of other (this is to prevent repeat random numbers\nfrom being generated by implicit copies)") );
+        RanGenerator_exposer.def( bp::init< SireMaths::RanGenerator const & >(( bp::arg("other") ), "Copy constructor - this takes an explicitly shared\ncopy of other (this is to prevent repeat random numbers\nfrom being generated by implicit copies), unless other is\na substream, in which case this takes an independent copy") );
         { //::SireMaths::RanGenerator::detach
         
             typedef void ( ::SireMaths::RanGenerator::*detach_function_type)(  ) ;
@@ -60,6 +60,17 @@ void register_RanGenerator_class(){
                 , detach_function_value
                 , "Detach from shared storage" );
         
+        }
+        { //::SireMaths::RanGenerator::getSeed
+        
+            typedef ::QVector< unsigned int > ( ::SireMaths::RanGenerator::*getSeed_function_type)(  ) const;
+            getSeed_function_type getSeed_function_value( &::SireMaths::RanGenerator::getSeed );
+            
+            RanGenerator_exposer.def( 
+                "getSeed"
+                , getSeed_function_value
+                , "Return the seed used to seed this generator. Note that a generator\nwhose state was loaded via setState will use the start of that\nstate as its seed" );
+        
         }
         { //::SireMaths::RanGenerator::getState
         
@@ -83,6 +94,17 @@ void register_RanGenerator_class(){
                 , bp::return_value_policy< bp::copy_const_reference >()
                 , "Return a reference to the global random number generator\n(shared between all threads)" );
         
+        }
+        { //::SireMaths::RanGenerator::isThreadSafe
+        
+            typedef bool ( ::SireMaths::RanGenerator::*isThreadSafe_function_type)(  ) const;
+            isThreadSafe_function_type isThreadSafe_function_value( &::SireMaths::RanGenerator::isThreadSafe );
+            
+            RanGenerator_exposer.def( 
+                "isThreadSafe"
+                , isThreadSafe_function_value
+                , "Return whether or not this generator is thread-safe (i.e. it\ncan be used simultaneously by several threads). All generators\nare thread-safe except for substreams" );
+        
         }
         { //::SireMaths::RanGenerator::lock
         
@@ -293,7 +315,7 @@ void register_RanGenerator_class(){
                 "nvectorOnSphere"
                 , nvectorOnSphere_function_value
                 , ( bp::arg("result"), bp::arg("radius") )
-                , "Fill the passed array with random vectors on a sphere with radius radius" );
+                , "Fill the passed array with random vectors on a sphere with radius radius.\nThis generates all of the uniform random numbers in one go (so the\ngenerator is only locked once), and then converts them using\nArchimedes projection (the height is uniform on [-radius,radius] and\nthe angle is uniform on [0,2pi)). Unlike rejection sampling, this uses\nexactly two random numbers per vector, and the conversion is a simple\nloop over arrays, which the compiler can vectorise" );
         
         }
         { //::SireMaths::RanGenerator::nvectorOnSphere
@@ -614,6 +636,18 @@ void register_RanGenerator_class(){
                 , ( bp::arg("state") )
                 , "Load the state into this generator - the state must have\nbeen produced by the getState() function above.\nThis will detach this copy from shared storage.\nThrow: SireError::incompatible_error\n" );
         
+        }
+        { //::SireMaths::RanGenerator::substream
+        
+            typedef ::SireMaths::RanGenerator ( ::SireMaths::RanGenerator::*substream_function_type)( ::quint32 ) const;
+            substream_function_type substream_function_value( &::SireMaths::RanGenerator::substream );
+            
+            RanGenerator_exposer.def( 
+                "substream"
+                , substream_function_value
+                , ( bp::arg("index") )
+                , "Return a new generator for the substream with index index.\nEach substream is seeded from the seed of this generator\ncombined with index, so the substreams are independent of\none another and of this generator, and are reproducible\n(the same seed and index always give the same stream). This\nis used to give each thread or replica its own generator.\n\nSubstreams are not thread-safe, i.e. they do not lock on\neach random number, so must only be used by one thread at a time.\nFor this reason, copies of a substream are not shared - each copy\nis an independent generator that starts from the state of the\nsubstream when it was copied\n" );
+        
         }
         { //::SireMaths::RanGenerator::typeName
         
@@ -24,6 +24,7 @@
 #include "axisset.h"
 #include "triangle.h"
 #include "vector.h"
+#include "streamingfreeenergyaverage.h"
 
 #include "Helpers/objectregistry.hpp"
 
@@ -40,6 +41,7 @@ void register_SireMaths_objects()
     ObjectRegistry::registerConverterFor< SireMaths::Sphere >();
     ObjectRegistry::registerConverterFor< SireMaths::FreeEnergyAverage >();
     ObjectRegistry::registerConverterFor< SireMaths::BennettsFreeEnergyAverage >();
+    ObjectRegistry::registerConverterFor< SireMaths::StreamingFreeEnergyAverage >();
     ObjectRegistry::registerConverterFor< SireMaths::Line >();
     ObjectRegistry::registerConverterFor< SireMaths::Histogram >();
     ObjectRegistry::registerConverterFor< SireMaths::Matrix >();
@@ -0,0 +1,278 @@
+// This file has been generated by Py++.
+
+// (C) Christopher Woods, GPL >= 2 License
+
+#include "boost/python.hpp"
+#include "StreamingFreeEnergyAverage.pypp.hpp"
+
+namespace bp = boost::python;
+
+#include "SireError/errors.h"
+
+#include "SireMaths/maths.h"
+
+#include "SireStream/datastream.h"
+
+#include "SireStream/shareddatastream.h"
+
+#include "SireUnits/units.h"
+
+#include <cmath>
+
+#include "streamingfreeenergyaverage.h"
+
+SireMaths::StreamingFreeEnergyAverage __copy__(const SireMaths::StreamingFreeEnergyAverage &other){ return SireMaths::StreamingFreeEnergyAverage(other); }
+
+#include "Qt/qdatastream.hpp"
+
+#include "Helpers/str.hpp"
+
+void register_StreamingFreeEnergyAverage_class(){
+
+    { //::SireMaths::StreamingFreeEnergyAverage
+        typedef bp::class_< SireMaths::StreamingFreeEnergyAverage, bp::bases< SireMaths::Accumulator, SireBase::Property > > StreamingFreeEnergyAverage_exposer_t;
+        StreamingFreeEnergyAverage_exposer_t StreamingFreeEnergyAverage_exposer = StreamingFreeEnergyAverage_exposer_t( "StreamingFreeEnergyAverage", "This class is used to accumulate a free energy average using a fixed\namount of memory, no matter how many samples are collected. Unlike\nFreeEnergyAverage, it does not record a histogram of the energies.\nInstead it accumulates;\n\n(1) a running log-sum-exp of -beta dU (and of -2 beta dU), from which\nthe FEP free energy, and its relative variance, are calculated\nwithout overflow;\n\n(2) the mean and variance of dU using Welford's algorithm, from which\nthe Taylor expansion estimate is calculated;\n\n(3) the sums of block averages for block sizes of 1, 2, 4, 8 ... samples\n(Flyvbjerg-Petersen blocking), from which the statistical inefficiency,\nand thus the standard error on the free energy, is calculated;\n\n(4) a coarse-grained time series of at most 128 segment averages,\nwhich is used to detect the number of samples at the start of\nthe simulation that should be discarded as equilibration.\n\nAverages from different replicas can be cheaply combined using\noperator+=. Note that the coarse-grained time series (and so the\nequilibration detection) is that of the left-hand average, as\nthe time series of independent replicas cannot be joined.\n\nAuthor: Christopher Woods\n", bp::init< >("Constructor - this defaults to accumulating the average\nat room temperature (25 C)") );
+        bp::scope StreamingFreeEnergyAverage_scope( StreamingFreeEnergyAverage_exposer );
+        StreamingFreeEnergyAverage_exposer.def( bp::init< bool >(( bp::arg("forwards_free_energy") ), "Constructor - this defaults to accumulating the average\nat room temperature (25 C), specifying whether or not this is\na forwards or backwards free energy") );
+        StreamingFreeEnergyAverage_exposer.def( bp::init< SireUnits::Dimension::Temperature const &, bp::optional< bool > >(( bp::arg("temperature"), bp::arg("forwards_free_energy")=(bool)(true) ), "Constructor - accumulate the average at the passed temperature,\nspecifying whether or not this is a forwards or backwards free energy") );
+        StreamingFreeEnergyAverage_exposer.def( bp::init< SireMaths::StreamingFreeEnergyAverage const & >(( bp::arg("other") ), "Copy constructor") );
+        { //::SireMaths::StreamingFreeEnergyAverage::accumulate
+        
+            typedef void ( ::SireMaths::StreamingFreeEnergyAverage::*accumulate_function_type)( double ) ;
+            accumulate_function_type accumulate_function_value( &::SireMaths::StreamingFreeEnergyAverage::accumulate );
+            
+            StreamingFreeEnergyAverage_exposer.def( 
+                "accumulate"
+                , accumulate_function_value
+                , ( bp::arg("value") )
+                , "Accumulate the energy difference value (in kcal mol-1) onto the average" );
+        
+        }
+        { //::SireMaths::StreamingFreeEnergyAverage::average
+        
+            typedef double ( ::SireMaths::StreamingFreeEnergyAverage::*average_function_type)(  ) const;
+            average_function_type average_function_value( &::SireMaths::StreamingFreeEnergyAverage::average );
+            
+            StreamingFreeEnergyAverage_exposer.def( 
+                "average"
+                , average_function_value
+                , "Return the average energy difference" );
+        
+        }
+        { //::SireMaths::StreamingFreeEnergyAverage::clear
+        
+            typedef void ( ::SireMaths::StreamingFreeEnergyAverage::*clear_function_type)(  ) ;
+            clear_function_type clear_function_value( &::SireMaths::StreamingFreeEnergyAverage::clear );
+            
+            StreamingFreeEnergyAverage_exposer.def( 
+                "clear"
+                , clear_function_value
+                , "Completely clear the statistics in this accumulator" );
+        
+        }
+        { //::SireMaths::StreamingFreeEnergyAverage::equilibrationSamples
+        
+            typedef ::qint64 ( ::SireMaths::StreamingFreeEnergyAverage::*equilibrationSamples_function_type)(  ) const;
+            equilibrationSamples_function_type equilibrationSamples_function_value( &::SireMaths::StreamingFreeEnergyAverage::equilibrationSamples );
+            
+            StreamingFreeEnergyAverage_exposer.def( 
+                "equilibrationSamples"
+                , equilibrationSamples_function_value
+                , "Return the number of samples at the start of the simulation that should\nbe discarded as equilibration. This chooses the start point that\nmaximises the number of effective (uncorrelated) samples in the rest\nof the simulation (the method of Chodera, J. Chem. Theory Comput. 2016),\nusing the coarse-grained time series, so the result is a multiple\nof the current segment width" );
+        
+        }
+        { //::SireMaths::StreamingFreeEnergyAverage::fepFreeEnergy
+        
+            typedef double ( ::SireMaths::StreamingFreeEnergyAverage::*fepFreeEnergy_function_type)(  ) const;
+            fepFreeEnergy_function_type fepFreeEnergy_function_value( &::SireMaths::StreamingFreeEnergyAverage::fepFreeEnergy );
+            
+            StreamingFreeEnergyAverage_exposer.def( 
+                "fepFreeEnergy"
+                , fepFreeEnergy_function_value
+                , "Return the FEP free energy, -kT ln < exp(-beta dU) >. Note that if this\nis a backwards free energy, then this will return the negative (so that\nit is easy to combine backwards and forwards values)" );
+        
+        }
+        { //::SireMaths::StreamingFreeEnergyAverage::isBackwardsFreeEnergy
+        
+            typedef bool ( ::SireMaths::StreamingFreeEnergyAverage::*isBackwardsFreeEnergy_function_type)(  ) const;
+            isBackwardsFreeEnergy_function_type isBackwardsFreeEnergy_function_value( &::SireMaths::StreamingFreeEnergyAverage::isBackwardsFreeEnergy );
+            
+            StreamingFreeEnergyAverage_exposer.def( 
+                "isBackwardsFreeEnergy"
+                , isBackwardsFreeEnergy_function_value
+                , "Return whether or not this is a backwards free energy" );
+        
+        }
+        { //::SireMaths::StreamingFreeEnergyAverage::isConverged
+        
+            typedef bool ( ::SireMaths::StreamingFreeEnergyAverage::*isConverged_function_type)( ::SireUnits::Dimension::MolarEnergy const & ) const;
+            isConverged_function_type isConverged_function_value( &::SireMaths::StreamingFreeEnergyAverage::isConverged );
+            
+            StreamingFreeEnergyAverage_exposer.def( 
+                "isConverged"
+                , isConverged_function_value
+                , ( bp::arg("error") )
+                , "Return whether or not the free energy has converged, i.e. that its\nstandard error is less than error" );
+        
+        }
+        { //::SireMaths::StreamingFreeEnergyAverage::isForwardsFreeEnergy
+        
+            typedef bool ( ::SireMaths::StreamingFreeEnergyAverage::*isForwardsFreeEnergy_function_type)(  ) const;
+            isForwardsFreeEnergy_function_type isForwardsFreeEnergy_function_value( &::SireMaths::StreamingFreeEnergyAverage::isForwardsFreeEnergy );
+            
+            StreamingFreeEnergyAverage_exposer.def( 
+                "isForwardsFreeEnergy"
+                , isForwardsFreeEnergy_function_value
+                , "Return whether or not this is a forwards free energy" );
+        
+        }
+        { //::SireMaths::StreamingFreeEnergyAverage::maximum
+        
+            typedef double ( ::SireMaths::StreamingFreeEnergyAverage::*maximum_function_type)(  ) const;
+            maximum_function_type maximum_function_value( &::SireMaths::StreamingFreeEnergyAverage::maximum );
+            
+            StreamingFreeEnergyAverage_exposer.def( 
+                "maximum"
+                , maximum_function_value
+                , "Return the largest energy difference" );
+        
+        }
+        { //::SireMaths::StreamingFreeEnergyAverage::minimum
+        
+            typedef double ( ::SireMaths::StreamingFreeEnergyAverage::*minimum_function_type)(  ) const;
+            minimum_function_type minimum_function_value( &::SireMaths::StreamingFreeEnergyAverage::minimum );
+            
+            StreamingFreeEnergyAverage_exposer.def( 
+                "minimum"
+                , minimum_function_value
+                , "Return the smallest energy difference" );
+        
+        }
+        { //::SireMaths::StreamingFreeEnergyAverage::nEffectiveSamples
+        
+            typedef double ( ::SireMaths::StreamingFreeEnergyAverage::*nEffectiveSamples_function_type)(  ) const;
+            nEffectiveSamples_function_type nEffectiveSamples_function_value( &::SireMaths::StreamingFreeEnergyAverage::nEffectiveSamples );
+            
+            StreamingFreeEnergyAverage_exposer.def( 
+                "nEffectiveSamples"
+                , nEffectiveSamples_function_value
+                , "Return the effective number of independent samples" );
+        
+        }
+        StreamingFreeEnergyAverage_exposer.def( bp::self != bp::self );
+        StreamingFreeEnergyAverage_exposer.def( bp::self + bp::self );
+        { //::SireMaths::StreamingFreeEnergyAverage::operator=
+        
+            typedef ::SireMaths::StreamingFreeEnergyAverage & ( ::SireMaths::StreamingFreeEnergyAverage::*assign_function_type)( ::SireMaths::StreamingFreeEnergyAverage const & ) ;
+            assign_function_type assign_function_value( &::SireMaths::StreamingFreeEnergyAverage::operator= );
+            
+            StreamingFreeEnergyAverage_exposer.def( 
+                "assign"
+                , assign_function_value
+                , ( bp::arg("other") )
+                , bp::return_self< >()
+                , "" );
+        
+        }
+        StreamingFreeEnergyAverage_exposer.def( bp::self == bp::self );
+        { //::SireMaths::StreamingFreeEnergyAverage::standardDeviation
+        
+            typedef double ( ::SireMaths::StreamingFreeEnergyAverage::*standardDeviation_function_type)(  ) const;
+            standardDeviation_function_type standardDeviation_function_value( &::SireMaths::StreamingFreeEnergyAverage::standardDeviation );
+            
+            StreamingFreeEnergyAverage_exposer.def( 
+                "standardDeviation"
+                , standardDeviation_function_value
+                , "Return the standard deviation of the energy difference" );
+        
+        }
+        { //::SireMaths::StreamingFreeEnergyAverage::standardError
+        
+            typedef double ( ::SireMaths::StreamingFreeEnergyAverage::*standardError_function_type)(  ) const;
+            standardError_function_type standardError_function_value( &::SireMaths::StreamingFreeEnergyAverage::standardError );
+            
+            StreamingFreeEnergyAverage_exposer.def( 
+                "standardError"
+                , standardError_function_value
+                , "Return the standard error on the FEP free energy (in kcal mol-1). This\nis calculated from the relative variance of exp(-beta dU), corrected\nfor the correlation between samples using the statistical inefficiency" );
+        
+        }
+        { //::SireMaths::StreamingFreeEnergyAverage::statisticalInefficiency
+        
+            typedef double ( ::SireMaths::StreamingFreeEnergyAverage::*statisticalInefficiency_function_type)(  ) const;
+            statisticalInefficiency_function_type statisticalInefficiency_function_value( &::SireMaths::StreamingFreeEnergyAverage::statisticalInefficiency );
+            
+            StreamingFreeEnergyAverage_exposer.def( 
+                "statisticalInefficiency"
+                , statisticalInefficiency_function_value
+                , "Return the statistical inefficiency of the energy differences, estimated\nusing block averaging. This is the number of correlated samples that are\nequivalent to one independent sample (so is 1 for uncorrelated data).\nThe largest estimate from any level of blocking with enough blocks is\nreturned, which approximates the plateau of the blocking curve" );
+        
+        }
+        { //::SireMaths::StreamingFreeEnergyAverage::taylorExpansion
+        
+            typedef double ( ::SireMaths::StreamingFreeEnergyAverage::*taylorExpansion_function_type)(  ) const;
+            taylorExpansion_function_type taylorExpansion_function_value( &::SireMaths::StreamingFreeEnergyAverage::taylorExpansion );
+            
+            StreamingFreeEnergyAverage_exposer.def( 
+                "taylorExpansion"
+                , taylorExpansion_function_value
+                , "Return the second order Taylor (cumulant) expansion estimate of the\nfree energy, < dU > - beta/2 var(dU)" );
+        
+        }
+        { //::SireMaths::StreamingFreeEnergyAverage::temperature
+        
+            typedef ::SireUnits::Dimension::Temperature ( ::SireMaths::StreamingFreeEnergyAverage::*temperature_function_type)(  ) const;
+            temperature_function_type temperature_function_value( &::SireMaths::StreamingFreeEnergyAverage::temperature );
+            
+            StreamingFreeEnergyAverage_exposer.def( 
+                "temperature"
+                , temperature_function_value
+                , "Return the temperature at which the free energy average is accumulated" );
+        
+        }
+        { //::SireMaths::StreamingFreeEnergyAverage::toString
+        
+            typedef ::QString ( ::SireMaths::StreamingFreeEnergyAverage::*toString_function_type)(  ) const;
+            toString_function_type toString_function_value( &::SireMaths::StreamingFreeEnergyAverage::toString );
+            
+            StreamingFreeEnergyAverage_exposer.def( 
+                "toString"
+                , toString_function_value
+                , "" );
+        
+        }
+        { //::SireMaths::StreamingFreeEnergyAverage::typeName
+        
+            typedef char const * ( *typeName_function_type )(  );
+            typeName_function_type typeName_function_value( &::SireMaths::StreamingFreeEnergyAverage::typeName );
+            
+            StreamingFreeEnergyAverage_exposer.def( 
+                "typeName"
+                , typeName_function_value
+                , "" );
+        
+        }
+        { //::SireMaths::StreamingFreeEnergyAverage::variance
+        
+            typedef double ( ::SireMaths::StreamingFreeEnergyAverage::*variance_function_type)(  ) const;
+            variance_function_type variance_function_value( &::SireMaths::StreamingFreeEnergyAverage::variance );
+            
+            StreamingFreeEnergyAverage_exposer.def( 
+                "variance"
+                , variance_function_value
+                , "Return the variance of the energy difference" );
+        
+        }
+        StreamingFreeEnergyAverage_exposer.staticmethod( "typeName" );
+        StreamingFreeEnergyAverage_exposer.def( "__copy__", &__copy__);
+        StreamingFreeEnergyAverage_exposer.def( "__deepcopy__", &__copy__);
+        StreamingFreeEnergyAverage_exposer.def( "clone", &__copy__);
+        StreamingFreeEnergyAverage_exposer.def( "__rlshift__", &__rlshift__QDataStream< ::SireMaths::StreamingFreeEnergyAverage >,
+                            bp::return_internal_reference<1, bp::with_custodian_and_ward<1,2> >() );
+        StreamingFreeEnergyAverage_exposer.def( "__rrshift__", &__rrshift__QDataStream< ::SireMaths::StreamingFreeEnergyAverage >,
+                            bp::return_internal_reference<1, bp::with_custodian_and_ward<1,2> >() );
+        StreamingFreeEnergyAverage_exposer.def( "__str__", &__str__< ::SireMaths::StreamingFreeEnergyAverage > );
+        StreamingFreeEnergyAverage_exposer.def( "__repr__", &__str__< ::SireMaths::StreamingFreeEnergyAverage > );
+    }
+
+}
@@ -0,0 +1,10 @@
+// This file has been generated by Py++.
+
+// (C) Christopher Woods, GPL >= 2 License
+
+#ifndef StreamingFreeEnergyAverage_hpp__pyplusplus_wrapper
+#define StreamingFreeEnergyAverage_hpp__pyplusplus_wrapper
+
+void register_StreamingFreeEnergyAverage_class();
+
+#endif//StreamingFreeEnergyAverage_hpp__pyplusplus_wrapper
@@ -77,6 +77,8 @@
 
 #include "Sphere.pypp.hpp"
 
+#include "StreamingFreeEnergyAverage.pypp.hpp"
+
 #include "Torsion.pypp.hpp"
 
 #include "Transform.pypp.hpp"
@@ -142,6 +144,8 @@ BOOST_PYTHON_MODULE(_Maths){
 
     register_BennettsFreeEnergyAverage_class();
 
+    register_StreamingFreeEnergyAverage_class();
+
     register_Complex_class();
 
     register_DistVector_class();
@@ -620,7 +620,19 @@ void register_free_functions(){
     
     }
 
-    { //::SireMaths::wrap
+    { //::SireMaths::solve_sparse_linear_assignment
+    
+        typedef ::QVector< int > ( *solve_sparse_linear_assignment_function_type )( ::QVector< QVector< int > > const &,::QVector< QVector< double > > const &,double );
+        solve_sparse_linear_assignment_function_type solve_sparse_linear_assignment_function_value( &::SireMaths::solve_sparse_linear_assignment );
+        
+        bp::def( 
+            "solve_sparse_linear_assignment"
+            , solve_sparse_linear_assignment_function_value
+            , ( bp::arg("columns"), bp::arg("costs"), bp::arg("epsilon")=0 )
+            , "Solve the sparse linear assignment problem from scratch, returning\nthe column assigned to each row. This returns an empty vector if\nthere is no complete assignment that uses only the candidate columns.\nSee the warm-startable version of this function for details" );
+    
+    }
+
     
         typedef ::SireBase::PropertyPtr ( *wrap_function_type )( ::SireMaths::Vector const & );
         wrap_function_type wrap_function_value( &::SireMaths::wrap );
@@ -61,7 +61,13 @@ def fix_Multi(c):
    c.add_declaration_code("#include \"multivector.h\"")
    c.add_declaration_code("#include \"multiquaternion.h\"")
 
+def fix_RanGenerator(c):
+   #the thread-local generator must only be used by its own thread,
+   #so it must not be handed to Python, where it could be shared
+   c.decls( "threadLocal" ).exclude()
+
 special_code = { "SireBase::Array2D<SireBase::PropPtr<SireMaths::Accumulator> >" : fix_Array2D,
+                 "SireMaths::RanGenerator" : fix_RanGenerator,
                  "SireMaths::MultiFloat" : fix_Multi,
                  "SireMaths::MultiFixed" : fix_Multi,
                  "SireMaths::MultiDouble" : fix_Multi,
@@ -0,0 +1,254 @@
+// This file has been generated by Py++.
+
+// (C) Christopher Woods, GPL >= 2 License
+
+#include "boost/python.hpp"
+#include "PackedCoords.pypp.hpp"
+
+namespace bp = boost::python;
+
+#include "SireMol/errors.h"
+
+#include "SireStream/datastream.h"
+
+#include "SireStream/shareddatastream.h"
+
+#include "atomcoords.h"
+
+#include "moleculedata.h"
+
+#include "molecules.h"
+
+#include <QDebug>
+
+#include "packedcoords.h"
+
+SireMol::PackedCoords __copy__(const SireMol::PackedCoords &other){ return SireMol::PackedCoords(other); }
+
+#include "Qt/qdatastream.hpp"
+
+#include "Helpers/str.hpp"
+
+void register_PackedCoords_class(){
+
+    { //::SireMol::PackedCoords
+        typedef bp::class_< SireMol::PackedCoords > PackedCoords_exposer_t;
+        PackedCoords_exposer_t PackedCoords_exposer = PackedCoords_exposer_t( "PackedCoords", "This class holds the coordinates of lots of molecules packed\ntogether into a single, contiguous block of memory (an arena),\nin order of increasing molecule number. This provides a\nview of the coordinates of a whole system that can be iterated\nover without going through each molecule in turn, e.g.\n\nconst Vector *coords = packed.constCoordsData();\n\nfor (int i=0; i<packed.nCoords(); ++i)\n{\n...use coords[i]\n}\n\nThe coordinates of each molecule are implicitly shared with\nthe arena, so the molecules returned by PackedCoords::pack\nuse the arena for their coordinates (rather than their own\nseparate arrays), and so cost no extra memory. A molecule\nonly takes its own copy of its coordinates when it is moved,\nat which point this view will no longer reflect that molecule.\n\nAuthor: Christopher Woods\n", bp::init< >("Constructor") );
+        bp::scope PackedCoords_scope( PackedCoords_exposer );
+        PackedCoords_exposer.def( bp::init< SireMol::Molecules const &, bp::optional< SireBase::PropertyMap const & > >(( bp::arg("molecules"), bp::arg("map")=SireBase::PropertyMap() ), "Construct an arena that holds the coordinates of all of the\npassed molecules (using the passed property map to find the\ncoordinates property). Molecules that dont have any coordinates\nare not included") );
+        PackedCoords_exposer.def( bp::init< SireMol::PackedCoords const & >(( bp::arg("other") ), "Copy constructor") );
+        { //::SireMol::PackedCoords::assertContains
+        
+            typedef void ( ::SireMol::PackedCoords::*assertContains_function_type)( ::SireMol::MolNum ) const;
+            assertContains_function_type assertContains_function_value( &::SireMol::PackedCoords::assertContains );
+            
+            PackedCoords_exposer.def( 
+                "assertContains"
+                , assertContains_function_value
+                , ( bp::arg("molnum") )
+                , "Assert that the arena contains the molecule with number molnum\nThrow: SireMol::missing_molecule\n" );
+        
+        }
+        { //::SireMol::PackedCoords::contains
+        
+            typedef bool ( ::SireMol::PackedCoords::*contains_function_type)( ::SireMol::MolNum ) const;
+            contains_function_type contains_function_value( &::SireMol::PackedCoords::contains );
+            
+            PackedCoords_exposer.def( 
+                "contains"
+                , contains_function_value
+                , ( bp::arg("molnum") )
+                , "Return whether or not the arena contains the molecule with number molnum" );
+        
+        }
+        { //::SireMol::PackedCoords::coordinates
+        
+            typedef ::SireVol::CoordGroupArrayArray const & ( ::SireMol::PackedCoords::*coordinates_function_type)(  ) const;
+            coordinates_function_type coordinates_function_value( &::SireMol::PackedCoords::coordinates );
+            
+            PackedCoords_exposer.def( 
+                "coordinates"
+                , coordinates_function_value
+                , bp::return_value_policy< bp::copy_const_reference >()
+                , "Return the arena holding the coordinates of all of the molecules.\nThe ith CoordGroupArray holds the coordinates of the ith molecule" );
+        
+        }
+        { //::SireMol::PackedCoords::coordinates
+        
+            typedef ::SireVol::CoordGroupArray const & ( ::SireMol::PackedCoords::*coordinates_function_type)( ::SireMol::MolNum ) const;
+            coordinates_function_type coordinates_function_value( &::SireMol::PackedCoords::coordinates );
+            
+            PackedCoords_exposer.def( 
+                "coordinates"
+                , coordinates_function_value
+                , ( bp::arg("molnum") )
+                , bp::return_value_policy< bp::copy_const_reference >()
+                , "Return the coordinates of the molecule with number molnum\nThrow: SireMol::missing_molecule\n" );
+        
+        }
+        { //::SireMol::PackedCoords::coordinatesProperty
+        
+            typedef ::SireBase::PropertyName const & ( ::SireMol::PackedCoords::*coordinatesProperty_function_type)(  ) const;
+            coordinatesProperty_function_type coordinatesProperty_function_value( &::SireMol::PackedCoords::coordinatesProperty );
+            
+            PackedCoords_exposer.def( 
+                "coordinatesProperty"
+                , coordinatesProperty_function_value
+                , bp::return_value_policy< bp::copy_const_reference >()
+                , "Return the property used to find the coordinates of the molecules" );
+        
+        }
+        { //::SireMol::PackedCoords::indexOf
+        
+            typedef int ( ::SireMol::PackedCoords::*indexOf_function_type)( ::SireMol::MolNum ) const;
+            indexOf_function_type indexOf_function_value( &::SireMol::PackedCoords::indexOf );
+            
+            PackedCoords_exposer.def( 
+                "indexOf"
+                , indexOf_function_value
+                , ( bp::arg("molnum") )
+                , "Return the index of the molecule with number molnum in the arena\nThrow: SireMol::missing_molecule\n" );
+        
+        }
+        { //::SireMol::PackedCoords::isEmpty
+        
+            typedef bool ( ::SireMol::PackedCoords::*isEmpty_function_type)(  ) const;
+            isEmpty_function_type isEmpty_function_value( &::SireMol::PackedCoords::isEmpty );
+            
+            PackedCoords_exposer.def( 
+                "isEmpty"
+                , isEmpty_function_value
+                , "Return whether or not this arena is empty" );
+        
+        }
+        { //::SireMol::PackedCoords::molNums
+        
+            typedef ::QVector< SireMol::MolNum > const & ( ::SireMol::PackedCoords::*molNums_function_type)(  ) const;
+            molNums_function_type molNums_function_value( &::SireMol::PackedCoords::molNums );
+            
+            PackedCoords_exposer.def( 
+                "molNums"
+                , molNums_function_value
+                , bp::return_value_policy< bp::copy_const_reference >()
+                , "Return the numbers of the molecules in the arena, in the order\nin which their coordinates are packed" );
+        
+        }
+        { //::SireMol::PackedCoords::nCoords
+        
+            typedef int ( ::SireMol::PackedCoords::*nCoords_function_type)(  ) const;
+            nCoords_function_type nCoords_function_value( &::SireMol::PackedCoords::nCoords );
+            
+            PackedCoords_exposer.def( 
+                "nCoords"
+                , nCoords_function_value
+                , "Return the total number of coordinates in the arena" );
+        
+        }
+        { //::SireMol::PackedCoords::nMolecules
+        
+            typedef int ( ::SireMol::PackedCoords::*nMolecules_function_type)(  ) const;
+            nMolecules_function_type nMolecules_function_value( &::SireMol::PackedCoords::nMolecules );
+            
+            PackedCoords_exposer.def( 
+                "nMolecules"
+                , nMolecules_function_value
+                , "Return the number of molecules in the arena" );
+        
+        }
+        { //::SireMol::PackedCoords::offset
+        
+            typedef int ( ::SireMol::PackedCoords::*offset_function_type)( ::SireMol::MolNum ) const;
+            offset_function_type offset_function_value( &::SireMol::PackedCoords::offset );
+            
+            PackedCoords_exposer.def( 
+                "offset"
+                , offset_function_value
+                , ( bp::arg("molnum") )
+                , "Return the index of the first coordinate of the molecule with\nnumber molnum in the arena, i.e. the coordinates of this molecule\nare at constCoordsData() + offset(molnum)\nThrow: SireMol::missing_molecule\n" );
+        
+        }
+        PackedCoords_exposer.def( bp::self != bp::self );
+        { //::SireMol::PackedCoords::operator=
+        
+            typedef ::SireMol::PackedCoords & ( ::SireMol::PackedCoords::*assign_function_type)( ::SireMol::PackedCoords const & ) ;
+            assign_function_type assign_function_value( &::SireMol::PackedCoords::operator= );
+            
+            PackedCoords_exposer.def( 
+                "assign"
+                , assign_function_value
+                , ( bp::arg("other") )
+                , bp::return_self< >()
+                , "" );
+        
+        }
+        PackedCoords_exposer.def( bp::self == bp::self );
+        { //::SireMol::PackedCoords::pack
+        
+            typedef ::SireMol::Molecules ( ::SireMol::PackedCoords::*pack_function_type)( ::SireMol::Molecules const & ) const;
+            pack_function_type pack_function_value( &::SireMol::PackedCoords::pack );
+            
+            PackedCoords_exposer.def( 
+                "pack"
+                , pack_function_value
+                , ( bp::arg("molecules") )
+                , "Return a copy of molecules in which each molecule that is in this\narena uses the arena to hold its coordinates. This reduces the memory\nused by the molecules, as well as placing their coordinates next to\neach other in memory. Only molecules whose coordinates are unchanged\nsince the arena was created are updated" );
+        
+        }
+        { //::SireMol::PackedCoords::setCoordinates
+        
+            typedef void ( ::SireMol::PackedCoords::*setCoordinates_function_type)( ::QVector< SireMaths::Vector > const & ) ;
+            setCoordinates_function_type setCoordinates_function_value( &::SireMol::PackedCoords::setCoordinates );
+            
+            PackedCoords_exposer.def( 
+                "setCoordinates"
+                , setCoordinates_function_value
+                , ( bp::arg("coordinates") )
+                , "Replace the coordinates in the arena with coordinates, which must\nhold nCoords() coordinates in the same order as constCoordsData()\n(molecules in order, then CutGroups, then atoms). The layout of the\narena is unchanged. Note that molecules that were packed into the old\narena keep using the old coordinates - use System::updateCoordinates\nto copy these coordinates into a system\nThrow: SireError::incompatible_error\n" );
+        
+        }
+        { //::SireMol::PackedCoords::toString
+        
+            typedef ::QString ( ::SireMol::PackedCoords::*toString_function_type)(  ) const;
+            toString_function_type toString_function_value( &::SireMol::PackedCoords::toString );
+            
+            PackedCoords_exposer.def( 
+                "toString"
+                , toString_function_value
+                , "" );
+        
+        }
+        { //::SireMol::PackedCoords::typeName
+        
+            typedef char const * ( *typeName_function_type )(  );
+            typeName_function_type typeName_function_value( &::SireMol::PackedCoords::typeName );
+            
+            PackedCoords_exposer.def( 
+                "typeName"
+                , typeName_function_value
+                , "" );
+        
+        }
+        { //::SireMol::PackedCoords::what
+        
+            typedef char const * ( ::SireMol::PackedCoords::*what_function_type)(  ) const;
+            what_function_type what_function_value( &::SireMol::PackedCoords::what );
+            
+            PackedCoords_exposer.def( 
+                "what"
+                , what_function_value
+                , "" );
+        
+        }
+        PackedCoords_exposer.staticmethod( "typeName" );
+        PackedCoords_exposer.def( "__copy__", &__copy__);
+        PackedCoords_exposer.def( "__deepcopy__", &__copy__);
+        PackedCoords_exposer.def( "clone", &__copy__);
+        PackedCoords_exposer.def( "__rlshift__", &__rlshift__QDataStream< ::SireMol::PackedCoords >,
+                            bp::return_internal_reference<1, bp::with_custodian_and_ward<1,2> >() );
+        PackedCoords_exposer.def( "__rrshift__", &__rrshift__QDataStream< ::SireMol::PackedCoords >,
+                            bp::return_internal_reference<1, bp::with_custodian_and_ward<1,2> >() );
+        PackedCoords_exposer.def( "__str__", &__str__< ::SireMol::PackedCoords > );
+        PackedCoords_exposer.def( "__repr__", &__str__< ::SireMol::PackedCoords > );
+    }
+
+}
@@ -0,0 +1,10 @@
+// This file has been generated by Py++.
+
+// (C) Christopher Woods, GPL >= 2 License
+
+#ifndef PackedCoords_hpp__pyplusplus_wrapper
+#define PackedCoords_hpp__pyplusplus_wrapper
+
+void register_PackedCoords_class();
+
+#endif//PackedCoords_hpp__pyplusplus_wrapper
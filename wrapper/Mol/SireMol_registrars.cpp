@@ -103,6 +103,7 @@
 #include "residue.h"
 #include "atommasses.h"
 #include "atom.h"
+#include "packedcoords.h"
 
 #include "Helpers/objectregistry.hpp"
 
@@ -323,6 +324,7 @@ void register_SireMol_objects()
     ObjectRegistry::registerConverterFor< SireMol::Mover<SireMol::Atom> >();
     ObjectRegistry::registerConverterFor< SireMol::Selector<SireMol::Atom> >();
     ObjectRegistry::registerConverterFor< SireMol::Mover< SireMol::Selector<SireMol::Atom> > >();
+    ObjectRegistry::registerConverterFor< SireMol::PackedCoords >();
 
 }
 
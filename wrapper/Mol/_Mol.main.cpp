@@ -363,6 +363,8 @@
 
 #include "NullPerturbation.pypp.hpp"
 
+#include "PackedCoords.pypp.hpp"
+
 #include "PartialMolecule.pypp.hpp"
 
 #include "Perturbation.pypp.hpp"
@@ -526,6 +528,8 @@ BOOST_PYTHON_MODULE(_Mol){
 
     register_IDAndSet_MolID__class();
 
+    register_PackedCoords_class();
+
     register_ResID_class();
 
     register_IDAndSet_ResID__class();
@@ -36,7 +36,7 @@ void register_CloseMols_class(){
 
     { //::SireSystem::CloseMols
         typedef bp::class_< SireSystem::CloseMols > CloseMols_exposer_t;
-        CloseMols_exposer_t CloseMols_exposer = CloseMols_exposer_t( "CloseMols", "This class is used to maintain a list of the closest molecules\nto a specified point\n\nAuthor: Christopher Woods\n", bp::init< >("Constructor") );
+        CloseMols_exposer_t CloseMols_exposer = CloseMols_exposer_t( "CloseMols", "This class is used to maintain a list of the closest molecules\nto a specified point\n\nThe vector from the point to the center of each molecule is cached\nand binned into a cell list (laid out on a SireVol::GridInfo around\nthe point). Updates that provide a hint of which molecules have\nchanged only recalculate and rebin those molecules, and the closest\nmolecules are then found by searching outwards through the cells\nfrom the point, rather than by rescanning every molecule in the group.\n\nAuthor: Christopher Woods\n", bp::init< >("Constructor") );
         bp::scope CloseMols_scope( CloseMols_exposer );
         CloseMols_exposer.def( bp::init< SireFF::PointRef const &, SireMol::MoleculeGroup const &, bp::optional< int, SireBase::PropertyMap const & > >(( bp::arg("point"), bp::arg("molgroup"), bp::arg("nclosest")=(int)(1), bp::arg("map")=SireBase::PropertyMap() ), "Construct to find the nclosest molecules from the molecule group\nmolgroup to the point point") );
         CloseMols_exposer.def( bp::init< SireFF::PointRef const &, SireMol::MoleculeGroup const &, SireVol::Space const &, bp::optional< int, SireBase::PropertyMap const & > >(( bp::arg("point"), bp::arg("molgroup"), bp::arg("space"), bp::arg("nclosest")=(int)(1), bp::arg("map")=SireBase::PropertyMap() ), "Construct to find the nclosest molecules from the molecule group\nmolgroup to the point point, using the space space to calculate\nthe distances between the molecules and the point") );
@@ -52,6 +52,29 @@ void register_CloseMols_class(){
                 , bp::return_value_policy< bp::copy_const_reference >()
                 , "Return the set of close molecules, together with the\ndistances from the molecule to the point" );
         
+        }
+        { //::SireSystem::CloseMols::closestMolecules
+        
+            typedef ::QList< SireMol::MolNum > ( ::SireSystem::CloseMols::*closestMolecules_function_type)(  ) const;
+            closestMolecules_function_type closestMolecules_function_value( &::SireSystem::CloseMols::closestMolecules );
+            
+            CloseMols_exposer.def( 
+                "closestMolecules"
+                , closestMolecules_function_value
+                , "Return the numbers of the close molecules, sorted in order\nof increasing distance from the point" );
+        
+        }
+        { //::SireSystem::CloseMols::closestMolecules
+        
+            typedef ::QList< SireMol::MolNum > ( ::SireSystem::CloseMols::*closestMolecules_function_type)( int ) const;
+            closestMolecules_function_type closestMolecules_function_value( &::SireSystem::CloseMols::closestMolecules );
+            
+            CloseMols_exposer.def( 
+                "closestMolecules"
+                , closestMolecules_function_value
+                , ( bp::arg("n") )
+                , "Return the numbers of the n molecules in the group that are closest\nto the point, sorted in order of increasing distance. n can be\nlarger than nClosest(), as the molecules are found by searching\nthrough the cells around the point" );
+        
         }
         { //::SireSystem::CloseMols::isClose
         
@@ -1263,6 +1263,18 @@ void register_System_class(){
                 , bp::return_value_policy< bp::copy_const_reference >()
                 , "" );
         
+        }
+        { //::SireSystem::System::packCoordinates
+        
+            typedef ::SireMol::PackedCoords ( ::SireSystem::System::*packCoordinates_function_type)( ::SireBase::PropertyMap const & ) ;
+            packCoordinates_function_type packCoordinates_function_value( &::SireSystem::System::packCoordinates );
+            
+            System_exposer.def( 
+                "packCoordinates"
+                , packCoordinates_function_value
+                , ( bp::arg("map")=SireBase::PropertyMap() )
+                , "Pack the coordinates of all of the molecules in this system into\na single, contiguous arena, and update the molecules so that they\nhold their coordinates in that arena (so that no extra memory is used).\nThis returns the PackedCoords view of the arena, which can be used\nfor fast passes over all of the coordinates in the system. Note that\nthis updates the molecules, so the forcefields will see them as\nhaving changed" );
+        
         }
         System_exposer.def( bp::self != bp::self );
         { //::SireSystem::System::operator=
@@ -2089,6 +2101,30 @@ void register_System_class(){
                 , ( bp::arg("molgroup"), bp::arg("auto_commit")=(bool)(true) )
                 , "Update this system so that it uses the same version of the molecules\npresent in the molecule group molgroup\nThrow: SireBase::missing_property\nThrow: SireError::invalid_cast\nThrow: SireError::incompatible_error\n" );
         
+        }
+        { //::SireSystem::System::updateCoordinates
+        
+            typedef void ( ::SireSystem::System::*updateCoordinates_function_type)( ::QVector< SireMol::MolNum > const &,::QVector< double > const &,::QVector< double > const &,::QVector< double > const &,::SireBase::PropertyMap const &,bool ) ;
+            updateCoordinates_function_type updateCoordinates_function_value( &::SireSystem::System::updateCoordinates );
+            
+            System_exposer.def( 
+                "updateCoordinates"
+                , updateCoordinates_function_value
+                , ( bp::arg("molnums"), bp::arg("x"), bp::arg("y"), bp::arg("z"), bp::arg("map")=SireBase::PropertyMap(), bp::arg("auto_commit")=(bool)(true) )
+                , "Update the coordinates of the molecules whose numbers are in molnums\nfrom the passed flat (structure of arrays) coordinates. x, y and\nz hold the x, y and z coordinates (in angstroms) of each atom of\neach molecule, with the atoms of each molecule in AtomIdx order, and\nthe molecules in the order in molnums. Each must hold one value for\nevery atom in the molecules.\nThis is much quicker than moving each molecule in turn, as the\nnew versions of the molecules are created in parallel, and are\nthen updated in the system in a single pass (so that each\nmolecule group is only given a single new version). This is\ndesigned to copy coordinates back from an integrator or an\nexternal MD engine.\nThrow: SireMol::missing_molecule\nThrow: SireBase::missing_property\nThrow: SireError::invalid_cast\nThrow: SireError::incompatible_error\n" );
+        
+        }
+        { //::SireSystem::System::updateCoordinates
+        
+            typedef void ( ::SireSystem::System::*updateCoordinates_function_type)( ::SireMol::PackedCoords const &,bool ) ;
+            updateCoordinates_function_type updateCoordinates_function_value( &::SireSystem::System::updateCoordinates );
+            
+            System_exposer.def( 
+                "updateCoordinates"
+                , updateCoordinates_function_value
+                , ( bp::arg("coords"), bp::arg("auto_commit")=(bool)(true) )
+                , "Update the coordinates of all of the molecules in the arena coords\nso that they are equal to those in the arena (e.g. after they have\nbeen set using PackedCoords::setCoordinates). The molecules\nshare their coordinates with the arena, so no extra memory is used.\nAll of the molecules are updated in a single pass, so each\nmolecule group is only given a single new version.\nThrow: SireMol::missing_molecule\nThrow: SireBase::missing_property\nThrow: SireError::invalid_cast\nThrow: SireError::incompatible_error\n" );
+        
         }
         { //::SireSystem::System::userProperties
         
@@ -12,6 +12,7 @@
 #include "gridinfo.h"
 #include "combinedspace.h"
 #include "cartesian.h"
+#include "triclinicbox.h"
 
 #include "Helpers/objectregistry.hpp"
 
@@ -33,6 +34,7 @@ void register_SireVol_objects()
     ObjectRegistry::registerConverterFor< SireVol::GridInfo >();
     ObjectRegistry::registerConverterFor< SireVol::CombinedSpace >();
     ObjectRegistry::registerConverterFor< SireVol::Cartesian >();
+    ObjectRegistry::registerConverterFor< SireVol::TriclinicBox >();
 
 }
 
@@ -0,0 +1,582 @@
+// This file has been generated by Py++.
+
+// (C) Christopher Woods, GPL >= 2 License
+
+#include "boost/python.hpp"
+#include "TriclinicBox.pypp.hpp"
+
+namespace bp = boost::python;
+
+#include "SireError/errors.h"
+
+#include "SireMaths/rangenerator.h"
+
+#include "SireStream/datastream.h"
+
+#include "coordgroup.h"
+
+#include "triclinicbox.h"
+
+#include <QVarLengthArray>
+
+#include <cmath>
+
+#include <limits>
+
+#include "triclinicbox.h"
+
+SireVol::TriclinicBox __copy__(const SireVol::TriclinicBox &other){ return SireVol::TriclinicBox(other); }
+
+#include "Qt/qdatastream.hpp"
+
+#include "Helpers/str.hpp"
+
+void register_TriclinicBox_class(){
+
+    { //::SireVol::TriclinicBox
+        typedef bp::class_< SireVol::TriclinicBox, bp::bases< SireVol::Cartesian, SireVol::Space, SireBase::Property > > TriclinicBox_exposer_t;
+        TriclinicBox_exposer_t TriclinicBox_exposer = TriclinicBox_exposer_t( "TriclinicBox", "\nA TriclinicBox is a volume that represents periodic boundary conditions\nusing a general (triclinic) unit cell, described by three lattice vectors.\nThis allows the use of the more compact unit cells, such as the\ntruncated octahedron and the rhombic dodecahedron, which need\nfewer solvent molecules than a PeriodicBox to solvate a solute\nto the same depth.\n\nThe minimum image is found by converting the separation vector\ninto reduced (fractional) coordinates, rounding these to the nearest\ninteger, and converting back to cartesian coordinates. This is\nperformed for whole arrays of points at a time. The result is\nexact if it lies within the sphere inscribed in the unit cell,\notherwise the neighbouring lattice translations are checked as well.\nThe lattice vectors should be in reduced form (e.g. as\ncreated by the static functions or as written by GROMACS),\nso that this search can find the true minimum image.\n\nAuthor: Christopher Woods\n", bp::init< >("Construct a default TriclinicBox volume (maximum volume)") );
+        bp::scope TriclinicBox_scope( TriclinicBox_exposer );
+        TriclinicBox_exposer.def( bp::init< SireMaths::Vector const &, SireMaths::Vector const &, SireMaths::Vector const & >(( bp::arg("v0"), bp::arg("v1"), bp::arg("v2") ), "Construct a TriclinicBox with the passed three lattice vectors") );
+        TriclinicBox_exposer.def( bp::init< SireVol::TriclinicBox const & >(( bp::arg("other") ), "Copy constructor") );
+        { //::SireVol::TriclinicBox::beyond
+        
+            typedef bool ( ::SireVol::TriclinicBox::*beyond_function_type)( double,::SireVol::AABox const &,::SireVol::AABox const & ) const;
+            beyond_function_type beyond_function_value( &::SireVol::TriclinicBox::beyond );
+            
+            TriclinicBox_exposer.def( 
+                "beyond"
+                , beyond_function_value
+                , ( bp::arg("dist"), bp::arg("aabox0"), bp::arg("aabox1") )
+                , "Return whether or not two groups enclosed by the AABoxes aabox0 and\naabox1 are definitely beyond the cutoff distance dist" );
+        
+        }
+        { //::SireVol::TriclinicBox::beyond
+        
+            typedef bool ( ::SireVol::TriclinicBox::*beyond_function_type)( double,::SireVol::CoordGroup const &,::SireVol::CoordGroup const & ) const;
+            beyond_function_type beyond_function_value( &::SireVol::TriclinicBox::beyond );
+            
+            TriclinicBox_exposer.def( 
+                "beyond"
+                , beyond_function_value
+                , ( bp::arg("dist"), bp::arg("group0"), bp::arg("group1") )
+                , "Return whether or not these two groups are definitely beyond the cutoff distance." );
+        
+        }
+        { //::SireVol::TriclinicBox::calcAngle
+        
+            typedef ::SireUnits::Dimension::Angle ( ::SireVol::TriclinicBox::*calcAngle_function_type)( ::SireMaths::Vector const &,::SireMaths::Vector const &,::SireMaths::Vector const & ) const;
+            calcAngle_function_type calcAngle_function_value( &::SireVol::TriclinicBox::calcAngle );
+            
+            TriclinicBox_exposer.def( 
+                "calcAngle"
+                , calcAngle_function_value
+                , ( bp::arg("point0"), bp::arg("point1"), bp::arg("point2") )
+                , "Calculate the angle between the passed three points. This should return\nthe acute angle between the points, which should lie between 0 and 180 degrees" );
+        
+        }
+        { //::SireVol::TriclinicBox::calcDihedral
+        
+            typedef ::SireUnits::Dimension::Angle ( ::SireVol::TriclinicBox::*calcDihedral_function_type)( ::SireMaths::Vector const &,::SireMaths::Vector const &,::SireMaths::Vector const &,::SireMaths::Vector const & ) const;
+            calcDihedral_function_type calcDihedral_function_value( &::SireVol::TriclinicBox::calcDihedral );
+            
+            TriclinicBox_exposer.def( 
+                "calcDihedral"
+                , calcDihedral_function_value
+                , ( bp::arg("point0"), bp::arg("point1"), bp::arg("point2"), bp::arg("point3") )
+                , "Calculate the torsion angle between the passed four points. This should\nreturn the torsion angle measured clockwise when looking down the\ntorsion from point0-point1-point2-point3. This will lie between 0 and 360\ndegrees" );
+        
+        }
+        { //::SireVol::TriclinicBox::calcDist
+        
+            typedef double ( ::SireVol::TriclinicBox::*calcDist_function_type)( ::SireMaths::Vector const &,::SireMaths::Vector const & ) const;
+            calcDist_function_type calcDist_function_value( &::SireVol::TriclinicBox::calcDist );
+            
+            TriclinicBox_exposer.def( 
+                "calcDist"
+                , calcDist_function_value
+                , ( bp::arg("point0"), bp::arg("point1") )
+                , "Calculate the distance between two points" );
+        
+        }
+        { //::SireVol::TriclinicBox::calcDist
+        
+            typedef double ( ::SireVol::TriclinicBox::*calcDist_function_type)( ::SireVol::CoordGroup const &,::SireVol::CoordGroup const &,::SireVol::DistMatrix & ) const;
+            calcDist_function_type calcDist_function_value( &::SireVol::TriclinicBox::calcDist );
+            
+            TriclinicBox_exposer.def( 
+                "calcDist"
+                , calcDist_function_value
+                , ( bp::arg("group1"), bp::arg("group2"), bp::arg("distmat") )
+                , "Populate the matrix mat with the distances between all of the\natoms of the two CoordGroups. Return the shortest distance between the two\nCoordGroups. Each distance uses the minimum image of that pair of atoms" );
+        
+        }
+        { //::SireVol::TriclinicBox::calcDist
+        
+            typedef double ( ::SireVol::TriclinicBox::*calcDist_function_type)( ::SireVol::CoordGroup const &,::SireMaths::Vector const &,::SireVol::DistMatrix & ) const;
+            calcDist_function_type calcDist_function_value( &::SireVol::TriclinicBox::calcDist );
+            
+            TriclinicBox_exposer.def( 
+                "calcDist"
+                , calcDist_function_value
+                , ( bp::arg("group"), bp::arg("point"), bp::arg("mat") )
+                , "Populate the matrix mat with the distances between all of the\natoms of the passed CoordGroup to the passed point. Return the shortest\ndistance." );
+        
+        }
+        { //::SireVol::TriclinicBox::calcDist2
+        
+            typedef double ( ::SireVol::TriclinicBox::*calcDist2_function_type)( ::SireMaths::Vector const &,::SireMaths::Vector const & ) const;
+            calcDist2_function_type calcDist2_function_value( &::SireVol::TriclinicBox::calcDist2 );
+            
+            TriclinicBox_exposer.def( 
+                "calcDist2"
+                , calcDist2_function_value
+                , ( bp::arg("point0"), bp::arg("point1") )
+                , "Calculate the distance squared between two points" );
+        
+        }
+        { //::SireVol::TriclinicBox::calcDist2
+        
+            typedef double ( ::SireVol::TriclinicBox::*calcDist2_function_type)( ::SireVol::CoordGroup const &,::SireMaths::Vector const &,::SireVol::DistMatrix & ) const;
+            calcDist2_function_type calcDist2_function_value( &::SireVol::TriclinicBox::calcDist2 );
+            
+            TriclinicBox_exposer.def( 
+                "calcDist2"
+                , calcDist2_function_value
+                , ( bp::arg("group"), bp::arg("point"), bp::arg("mat") )
+                , "Populate the matrix mat with the distances^2 between all of the\natoms of the passed CoordGroup to the passed point. Return the shortest\ndistance." );
+        
+        }
+        { //::SireVol::TriclinicBox::calcDist2
+        
+            typedef double ( ::SireVol::TriclinicBox::*calcDist2_function_type)( ::SireVol::CoordGroup const &,::SireVol::CoordGroup const &,::SireVol::DistMatrix & ) const;
+            calcDist2_function_type calcDist2_function_value( &::SireVol::TriclinicBox::calcDist2 );
+            
+            TriclinicBox_exposer.def( 
+                "calcDist2"
+                , calcDist2_function_value
+                , ( bp::arg("group1"), bp::arg("group2"), bp::arg("distmat") )
+                , "Populate the matrix mat with the distances^2 between all of the\natoms of the two CoordGroups. Return the shortest distance between the two\nCoordGroups." );
+        
+        }
+        { //::SireVol::TriclinicBox::calcDistVector
+        
+            typedef ::SireMaths::DistVector ( ::SireVol::TriclinicBox::*calcDistVector_function_type)( ::SireMaths::Vector const &,::SireMaths::Vector const & ) const;
+            calcDistVector_function_type calcDistVector_function_value( &::SireVol::TriclinicBox::calcDistVector );
+            
+            TriclinicBox_exposer.def( 
+                "calcDistVector"
+                , calcDistVector_function_value
+                , ( bp::arg("point0"), bp::arg("point1") )
+                , "Calculate the distance vector between two points" );
+        
+        }
+        { //::SireVol::TriclinicBox::calcDistVectors
+        
+            typedef double ( ::SireVol::TriclinicBox::*calcDistVectors_function_type)( ::SireVol::CoordGroup const &,::SireVol::CoordGroup const &,::SireVol::DistVectorMatrix & ) const;
+            calcDistVectors_function_type calcDistVectors_function_value( &::SireVol::TriclinicBox::calcDistVectors );
+            
+            TriclinicBox_exposer.def( 
+                "calcDistVectors"
+                , calcDistVectors_function_value
+                , ( bp::arg("group1"), bp::arg("group2"), bp::arg("distmat") )
+                , "Populate the matrix distmat between all the points of the two CoordGroups\ngroup1 and group2 - the returned matrix has the vectors pointing\nfrom each point in group1 to each point in group2. This returns\nthe shortest distance between two points in the group" );
+        
+        }
+        { //::SireVol::TriclinicBox::calcDistVectors
+        
+            typedef double ( ::SireVol::TriclinicBox::*calcDistVectors_function_type)( ::SireVol::CoordGroup const &,::SireMaths::Vector const &,::SireVol::DistVectorMatrix & ) const;
+            calcDistVectors_function_type calcDistVectors_function_value( &::SireVol::TriclinicBox::calcDistVectors );
+            
+            TriclinicBox_exposer.def( 
+                "calcDistVectors"
+                , calcDistVectors_function_value
+                , ( bp::arg("group"), bp::arg("point"), bp::arg("distmat") )
+                , "Populate the matrix distmat between all the points passed CoordGroup\nto the point point - the returned matrix has the vectors pointing\nfrom the point to each point in group. This returns\nthe shortest distance." );
+        
+        }
+        { //::SireVol::TriclinicBox::calcInvDist
+        
+            typedef double ( ::SireVol::TriclinicBox::*calcInvDist_function_type)( ::SireVol::CoordGroup const &,::SireVol::CoordGroup const &,::SireVol::DistMatrix & ) const;
+            calcInvDist_function_type calcInvDist_function_value( &::SireVol::TriclinicBox::calcInvDist );
+            
+            TriclinicBox_exposer.def( 
+                "calcInvDist"
+                , calcInvDist_function_value
+                , ( bp::arg("group1"), bp::arg("group2"), bp::arg("distmat") )
+                , "Populate the matrix mat with the inverse distances between all of the\natoms of the two CoordGroups. Return the shortest distance between the two CoordGroups." );
+        
+        }
+        { //::SireVol::TriclinicBox::calcInvDist2
+        
+            typedef double ( ::SireVol::TriclinicBox::*calcInvDist2_function_type)( ::SireVol::CoordGroup const &,::SireVol::CoordGroup const &,::SireVol::DistMatrix & ) const;
+            calcInvDist2_function_type calcInvDist2_function_value( &::SireVol::TriclinicBox::calcInvDist2 );
+            
+            TriclinicBox_exposer.def( 
+                "calcInvDist2"
+                , calcInvDist2_function_value
+                , ( bp::arg("group1"), bp::arg("group2"), bp::arg("distmat") )
+                , "Populate the matrix mat with the inverse distances^2 between all of the\natoms of the two CoordGroups. Return the shortest distance between the two CoordGroups." );
+        
+        }
+        { //::SireVol::TriclinicBox::cubic
+        
+            typedef ::SireVol::TriclinicBox ( *cubic_function_type )( double );
+            cubic_function_type cubic_function_value( &::SireVol::TriclinicBox::cubic );
+            
+            TriclinicBox_exposer.def( 
+                "cubic"
+                , cubic_function_value
+                , ( bp::arg("length") )
+                , "Return a cubic box with sides of length length" );
+        
+        }
+        { //::SireVol::TriclinicBox::fromReduced
+        
+            typedef ::SireMaths::Vector ( ::SireVol::TriclinicBox::*fromReduced_function_type)( ::SireMaths::Vector const & ) const;
+            fromReduced_function_type fromReduced_function_value( &::SireVol::TriclinicBox::fromReduced );
+            
+            TriclinicBox_exposer.def( 
+                "fromReduced"
+                , fromReduced_function_value
+                , ( bp::arg("reduced") )
+                , "Return the cartesian coordinates of the reduced coordinates reduced" );
+        
+        }
+        { //::SireVol::TriclinicBox::getBoxCenter
+        
+            typedef ::SireMaths::Vector ( ::SireVol::TriclinicBox::*getBoxCenter_function_type)( ::SireMaths::Vector const & ) const;
+            getBoxCenter_function_type getBoxCenter_function_value( &::SireVol::TriclinicBox::getBoxCenter );
+            
+            TriclinicBox_exposer.def( 
+                "getBoxCenter"
+                , getBoxCenter_function_value
+                , ( bp::arg("p") )
+                , "Return the center of the box that contains the point p assuming\nthat the center for the central box is located at the origin" );
+        
+        }
+        { //::SireVol::TriclinicBox::getBoxCenter
+        
+            typedef ::SireMaths::Vector ( ::SireVol::TriclinicBox::*getBoxCenter_function_type)( ::SireMaths::Vector const &,::SireMaths::Vector const & ) const;
+            getBoxCenter_function_type getBoxCenter_function_value( &::SireVol::TriclinicBox::getBoxCenter );
+            
+            TriclinicBox_exposer.def( 
+                "getBoxCenter"
+                , getBoxCenter_function_value
+                , ( bp::arg("p"), bp::arg("center") )
+                , "Return the center of the box that contains the point p assuming\nthat the center for the central box is located at center" );
+        
+        }
+        { //::SireVol::TriclinicBox::getCopiesWithin
+        
+            typedef ::QList< boost::tuples::tuple< double, SireVol::CoordGroup, boost::tuples::null_type, boost::tuples::null_type, boost::tuples::null_type, boost::tuples::null_type, boost::tuples::null_type, boost::tuples::null_type, boost::tuples::null_type, boost::tuples::null_type > > ( ::SireVol::TriclinicBox::*getCopiesWithin_function_type)( ::SireVol::CoordGroup const &,::SireVol::CoordGroup const &,double ) const;
+            getCopiesWithin_function_type getCopiesWithin_function_value( &::SireVol::TriclinicBox::getCopiesWithin );
+            
+            TriclinicBox_exposer.def( 
+                "getCopiesWithin"
+                , getCopiesWithin_function_value
+                , ( bp::arg("group"), bp::arg("center"), bp::arg("dist") )
+                , "Return a list of copies of CoordGroup group that are within\ndistance of the CoordGroup center, translating group so that\nit has the right coordinates to be around center. Note that multiple\ncopies of group may be returned if there are multiple periodic\nreplicas of group within dist of center. The copies of group\nare returned together with the minimum distance between that\nperiodic replica and center.\nIf there are no periodic replicas of group that are within\ndist of center, then an empty list is returned." );
+        
+        }
+        { //::SireVol::TriclinicBox::getImageTranslations
+        
+            typedef ::QVector< SireMaths::Vector > ( ::SireVol::TriclinicBox::*getImageTranslations_function_type)( ::SireVol::AABox const &,::SireVol::AABox const &,double ) const;
+            getImageTranslations_function_type getImageTranslations_function_value( &::SireVol::TriclinicBox::getImageTranslations );
+            
+            TriclinicBox_exposer.def( 
+                "getImageTranslations"
+                , getImageTranslations_function_value
+                , ( bp::arg("box0"), bp::arg("box1"), bp::arg("dist") )
+                , "Return the lattice translations that must be applied to box1\nto give all of the periodic images of box1 that are within dist\nof box0. This is used to calculate the interactions between\ngroups of atoms in a triclinic box using vacuum kernels on\ntranslated copies of the atoms" );
+        
+        }
+        { //::SireVol::TriclinicBox::getImagesWithin
+        
+            typedef ::QVector< SireMaths::Vector > ( ::SireVol::TriclinicBox::*getImagesWithin_function_type)( ::SireMaths::Vector const &,::SireMaths::Vector const &,double ) const;
+            getImagesWithin_function_type getImagesWithin_function_value( &::SireVol::TriclinicBox::getImagesWithin );
+            
+            TriclinicBox_exposer.def( 
+                "getImagesWithin"
+                , getImagesWithin_function_value
+                , ( bp::arg("point"), bp::arg("center"), bp::arg("dist") )
+                , "Return all periodic images of point with respect to center within\ndist distance of center" );
+        
+        }
+        { //::SireVol::TriclinicBox::getMinimumImage
+        
+            typedef ::SireVol::CoordGroup ( ::SireVol::TriclinicBox::*getMinimumImage_function_type)( ::SireVol::CoordGroup const &,::SireMaths::Vector const & ) const;
+            getMinimumImage_function_type getMinimumImage_function_value( &::SireVol::TriclinicBox::getMinimumImage );
+            
+            TriclinicBox_exposer.def( 
+                "getMinimumImage"
+                , getMinimumImage_function_value
+                , ( bp::arg("group"), bp::arg("center") )
+                , "Return the closest periodic copy of group to the point point,\naccording to the minimum image convention. The effect of this is\nto move group into the box which is now centered on point" );
+        
+        }
+        { //::SireVol::TriclinicBox::getMinimumImage
+        
+            typedef ::SireVol::CoordGroupArray ( ::SireVol::TriclinicBox::*getMinimumImage_function_type)( ::SireVol::CoordGroupArray const &,::SireMaths::Vector const &,bool ) const;
+            getMinimumImage_function_type getMinimumImage_function_value( &::SireVol::TriclinicBox::getMinimumImage );
+            
+            TriclinicBox_exposer.def( 
+                "getMinimumImage"
+                , getMinimumImage_function_value
+                , ( bp::arg("groups"), bp::arg("center"), bp::arg("translate_as_one")=(bool)(false) )
+                , "Return the closest periodic copy of each group in groups to the\npoint point, according to the minimum image convention.\nThe effect of this is to move each group into the box which is\nnow centered on point. If translate_as_one is true,\nthen this treats all groups as being part of one larger\ngroup, and so it translates it together. This is useful\nto get the minimum image of a molecule as a whole, rather\nthan breaking the molecule across a box boundary" );
+        
+        }
+        { //::SireVol::TriclinicBox::getMinimumImage
+        
+            typedef ::SireVol::AABox ( ::SireVol::TriclinicBox::*getMinimumImage_function_type)( ::SireVol::AABox const &,::SireMaths::Vector const & ) const;
+            getMinimumImage_function_type getMinimumImage_function_value( &::SireVol::TriclinicBox::getMinimumImage );
+            
+            TriclinicBox_exposer.def( 
+                "getMinimumImage"
+                , getMinimumImage_function_value
+                , ( bp::arg("aabox"), bp::arg("center") )
+                , "Return the copy of the box which is the closest minimum image\nto center" );
+        
+        }
+        { //::SireVol::TriclinicBox::getMinimumImage
+        
+            typedef ::SireMaths::Vector ( ::SireVol::TriclinicBox::*getMinimumImage_function_type)( ::SireMaths::Vector const &,::SireMaths::Vector const & ) const;
+            getMinimumImage_function_type getMinimumImage_function_value( &::SireVol::TriclinicBox::getMinimumImage );
+            
+            TriclinicBox_exposer.def( 
+                "getMinimumImage"
+                , getMinimumImage_function_value
+                , ( bp::arg("point"), bp::arg("center") )
+                , "Return the copy of the point point which is the closest minimum image\nto center" );
+        
+        }
+        { //::SireVol::TriclinicBox::getRandomPoint
+        
+            typedef ::SireMaths::Vector ( ::SireVol::TriclinicBox::*getRandomPoint_function_type)( ::SireMaths::Vector const &,::SireMaths::RanGenerator const & ) const;
+            getRandomPoint_function_type getRandomPoint_function_value( &::SireVol::TriclinicBox::getRandomPoint );
+            
+            TriclinicBox_exposer.def( 
+                "getRandomPoint"
+                , getRandomPoint_function_value
+                , ( bp::arg("center"), bp::arg("generator") )
+                , "Return a random point within the box (placing the center of the box\nis at the center center)" );
+        
+        }
+        { //::SireVol::TriclinicBox::inscribedRadius
+        
+            typedef double ( ::SireVol::TriclinicBox::*inscribedRadius_function_type)(  ) const;
+            inscribedRadius_function_type inscribedRadius_function_value( &::SireVol::TriclinicBox::inscribedRadius );
+            
+            TriclinicBox_exposer.def( 
+                "inscribedRadius"
+                , inscribedRadius_function_value
+                , "Return the radius of the largest sphere that can be inscribed in the\nunit cell. Any separation vector that is shorter than this is\nguaranteed to be the minimum image" );
+        
+        }
+        { //::SireVol::TriclinicBox::isCartesian
+        
+            typedef bool ( ::SireVol::TriclinicBox::*isCartesian_function_type)(  ) const;
+            isCartesian_function_type isCartesian_function_value( &::SireVol::TriclinicBox::isCartesian );
+            
+            TriclinicBox_exposer.def( 
+                "isCartesian"
+                , isCartesian_function_value
+                , "A triclinic box is cartesian" );
+        
+        }
+        { //::SireVol::TriclinicBox::isPeriodic
+        
+            typedef bool ( ::SireVol::TriclinicBox::*isPeriodic_function_type)(  ) const;
+            isPeriodic_function_type isPeriodic_function_value( &::SireVol::TriclinicBox::isPeriodic );
+            
+            TriclinicBox_exposer.def( 
+                "isPeriodic"
+                , isPeriodic_function_value
+                , "A triclinic box is periodic!" );
+        
+        }
+        { //::SireVol::TriclinicBox::minimumDistance
+        
+            typedef double ( ::SireVol::TriclinicBox::*minimumDistance_function_type)( ::SireVol::CoordGroup const &,::SireVol::CoordGroup const & ) const;
+            minimumDistance_function_type minimumDistance_function_value( &::SireVol::TriclinicBox::minimumDistance );
+            
+            TriclinicBox_exposer.def( 
+                "minimumDistance"
+                , minimumDistance_function_value
+                , ( bp::arg("group0"), bp::arg("group1") )
+                , "Return the minimum distance between the points in group0 and group1.\nThis uses the minimum image of each pair of points" );
+        
+        }
+        { //::SireVol::TriclinicBox::minimumDistance
+        
+            typedef double ( ::SireVol::TriclinicBox::*minimumDistance_function_type)( ::SireVol::AABox const &,::SireVol::AABox const & ) const;
+            minimumDistance_function_type minimumDistance_function_value( &::SireVol::TriclinicBox::minimumDistance );
+            
+            TriclinicBox_exposer.def( 
+                "minimumDistance"
+                , minimumDistance_function_value
+                , ( bp::arg("box0"), bp::arg("box1") )
+                , "Return the distance between the axis-aligned boxes box0 and box1,\nwhere delta is the vector between the centers of the boxes */\nstatic double boxDistance(const Vector &delta, const AABox &box0, const AABox &box1)\n{\nVector d( std::abs(delta.x()), std::abs(delta.y()), std::abs(delta.z()) );\nd -= box0.halfExtents();\nd -= box1.halfExtents();\nreturn d.max( Vector(0) ).length();\n}\n/** Return the minimum distance between the two boxes. This\nsearches all of the periodic images of box1 that could be\ncloser to box0 than the minimum image of its center" );
+        
+        }
+        TriclinicBox_exposer.def( bp::self != bp::self );
+        { //::SireVol::TriclinicBox::operator=
+        
+            typedef ::SireVol::TriclinicBox & ( ::SireVol::TriclinicBox::*assign_function_type)( ::SireVol::TriclinicBox const & ) ;
+            assign_function_type assign_function_value( &::SireVol::TriclinicBox::operator= );
+            
+            TriclinicBox_exposer.def( 
+                "assign"
+                , assign_function_value
+                , ( bp::arg("other") )
+                , bp::return_self< >()
+                , "" );
+        
+        }
+        TriclinicBox_exposer.def( bp::self == bp::self );
+        { //::SireVol::TriclinicBox::rhombicDodecahedron
+        
+            typedef ::SireVol::TriclinicBox ( *rhombicDodecahedron_function_type )( double );
+            rhombicDodecahedron_function_type rhombicDodecahedron_function_value( &::SireVol::TriclinicBox::rhombicDodecahedron );
+            
+            TriclinicBox_exposer.def( 
+                "rhombicDodecahedron"
+                , rhombicDodecahedron_function_value
+                , ( bp::arg("distance") )
+                , "Return a rhombic dodecahedral box (with a square xy-plane) where\nthe distance between each periodic image is distance. This\nhas about 71% of the volume of a cubic box with the same image distance" );
+        
+        }
+        { //::SireVol::TriclinicBox::setVectors
+        
+            typedef void ( ::SireVol::TriclinicBox::*setVectors_function_type)( ::SireMaths::Vector const &,::SireMaths::Vector const &,::SireMaths::Vector const & ) ;
+            setVectors_function_type setVectors_function_value( &::SireVol::TriclinicBox::setVectors );
+            
+            TriclinicBox_exposer.def( 
+                "setVectors"
+                , setVectors_function_value
+                , ( bp::arg("v0"), bp::arg("v1"), bp::arg("v2") )
+                , "Set the three lattice vectors of the unit cell" );
+        
+        }
+        { //::SireVol::TriclinicBox::setVolume
+        
+            typedef ::SireVol::SpacePtr ( ::SireVol::TriclinicBox::*setVolume_function_type)( ::SireUnits::Dimension::Volume ) const;
+            setVolume_function_type setVolume_function_value( &::SireVol::TriclinicBox::setVolume );
+            
+            TriclinicBox_exposer.def( 
+                "setVolume"
+                , setVolume_function_value
+                , ( bp::arg("volume") )
+                , "Return a copy of this space with the volume of set to volume\n- this will scale the space uniformly, keeping the center at\nthe same location, to achieve this volume" );
+        
+        }
+        { //::SireVol::TriclinicBox::toReduced
+        
+            typedef ::SireMaths::Vector ( ::SireVol::TriclinicBox::*toReduced_function_type)( ::SireMaths::Vector const & ) const;
+            toReduced_function_type toReduced_function_value( &::SireVol::TriclinicBox::toReduced );
+            
+            TriclinicBox_exposer.def( 
+                "toReduced"
+                , toReduced_function_value
+                , ( bp::arg("point") )
+                , "Return the reduced (fractional) coordinates of point, i.e.\nthe coefficients of the lattice vectors that sum to point" );
+        
+        }
+        { //::SireVol::TriclinicBox::toString
+        
+            typedef ::QString ( ::SireVol::TriclinicBox::*toString_function_type)(  ) const;
+            toString_function_type toString_function_value( &::SireVol::TriclinicBox::toString );
+            
+            TriclinicBox_exposer.def( 
+                "toString"
+                , toString_function_value
+                , "Return a string representation of this space" );
+        
+        }
+        { //::SireVol::TriclinicBox::truncatedOctahedron
+        
+            typedef ::SireVol::TriclinicBox ( *truncatedOctahedron_function_type )( double );
+            truncatedOctahedron_function_type truncatedOctahedron_function_value( &::SireVol::TriclinicBox::truncatedOctahedron );
+            
+            TriclinicBox_exposer.def( 
+                "truncatedOctahedron"
+                , truncatedOctahedron_function_value
+                , ( bp::arg("distance") )
+                , "Return a truncated octahedral box where the distance between\neach periodic image is distance. This has about 77% of the\nvolume of a cubic box with the same image distance" );
+        
+        }
+        { //::SireVol::TriclinicBox::typeName
+        
+            typedef char const * ( *typeName_function_type )(  );
+            typeName_function_type typeName_function_value( &::SireVol::TriclinicBox::typeName );
+            
+            TriclinicBox_exposer.def( 
+                "typeName"
+                , typeName_function_value
+                , "" );
+        
+        }
+        { //::SireVol::TriclinicBox::vector0
+        
+            typedef ::SireMaths::Vector const & ( ::SireVol::TriclinicBox::*vector0_function_type)(  ) const;
+            vector0_function_type vector0_function_value( &::SireVol::TriclinicBox::vector0 );
+            
+            TriclinicBox_exposer.def( 
+                "vector0"
+                , vector0_function_value
+                , bp::return_value_policy< bp::copy_const_reference >()
+                , "Return the first lattice vector" );
+        
+        }
+        { //::SireVol::TriclinicBox::vector1
+        
+            typedef ::SireMaths::Vector const & ( ::SireVol::TriclinicBox::*vector1_function_type)(  ) const;
+            vector1_function_type vector1_function_value( &::SireVol::TriclinicBox::vector1 );
+            
+            TriclinicBox_exposer.def( 
+                "vector1"
+                , vector1_function_value
+                , bp::return_value_policy< bp::copy_const_reference >()
+                , "Return the second lattice vector" );
+        
+        }
+        { //::SireVol::TriclinicBox::vector2
+        
+            typedef ::SireMaths::Vector const & ( ::SireVol::TriclinicBox::*vector2_function_type)(  ) const;
+            vector2_function_type vector2_function_value( &::SireVol::TriclinicBox::vector2 );
+            
+            TriclinicBox_exposer.def( 
+                "vector2"
+                , vector2_function_value
+                , bp::return_value_policy< bp::copy_const_reference >()
+                , "Return the third lattice vector" );
+        
+        }
+        { //::SireVol::TriclinicBox::volume
+        
+            typedef ::SireUnits::Dimension::Volume ( ::SireVol::TriclinicBox::*volume_function_type)(  ) const;
+            volume_function_type volume_function_value( &::SireVol::TriclinicBox::volume );
+            
+            TriclinicBox_exposer.def( 
+                "volume"
+                , volume_function_value
+                , "Return the volume of the central box of this space." );
+        
+        }
+        TriclinicBox_exposer.staticmethod( "cubic" );
+        TriclinicBox_exposer.staticmethod( "rhombicDodecahedron" );
+        TriclinicBox_exposer.staticmethod( "truncatedOctahedron" );
+        TriclinicBox_exposer.staticmethod( "typeName" );
+        TriclinicBox_exposer.def( "__copy__", &__copy__);
+        TriclinicBox_exposer.def( "__deepcopy__", &__copy__);
+        TriclinicBox_exposer.def( "clone", &__copy__);
+        TriclinicBox_exposer.def( "__rlshift__", &__rlshift__QDataStream< ::SireVol::TriclinicBox >,
+                            bp::return_internal_reference<1, bp::with_custodian_and_ward<1,2> >() );
+        TriclinicBox_exposer.def( "__rrshift__", &__rrshift__QDataStream< ::SireVol::TriclinicBox >,
+                            bp::return_internal_reference<1, bp::with_custodian_and_ward<1,2> >() );
+        TriclinicBox_exposer.def( "__str__", &__str__< ::SireVol::TriclinicBox > );
+        TriclinicBox_exposer.def( "__repr__", &__str__< ::SireVol::TriclinicBox > );
+    }
+
+}
@@ -45,6 +45,8 @@
 
 #include "Space.pypp.hpp"
 
+#include "TriclinicBox.pypp.hpp"
+
 namespace bp = boost::python;
 
 #include "SireVol_containers.h"
@@ -100,6 +102,8 @@ BOOST_PYTHON_MODULE(_Vol){
 
     register_PeriodicBox_class();
 
+    register_TriclinicBox_class();
+
     register_SireVol_properties();
 
     bp::implicitly_convertible< QVector<SireMaths::Vector>, SireVol::CoordGroup >();